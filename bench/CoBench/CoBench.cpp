@@ -0,0 +1,369 @@
+#include <bench/AllocCounter.hpp>
+#include <sharpen/AsyncMutex.hpp>
+#include <sharpen/AsyncOps.hpp>
+#include <sharpen/AwaitableFuture.hpp>
+#include <sharpen/EventEngine.hpp>
+#include <sharpen/EventLoop.hpp>
+#include <sharpen/Fiber.hpp>
+#include <sharpen/MpscQueue.hpp>
+#include <simplebench/BenchRunner.hpp>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+static constexpr std::size_t switchCount{1000 * 1000};
+
+static constexpr std::size_t launchCount{100 * 1000};
+
+static constexpr std::size_t pingPongCount{100 * 1000};
+
+static constexpr std::size_t mutexFiberCount{16};
+
+static constexpr std::size_t mutexLockCount{10 * 1000};
+
+static constexpr std::size_t futureCount{1000 * 1000};
+
+static constexpr std::size_t queueProducerCount{4};
+
+static constexpr std::size_t queueCount{1000 * 1000};
+
+static constexpr std::size_t fiberStackSize{64 * 1024};
+
+// two fibers switch to each other on a plain thread
+class FiberSwitchBench : public simplebench::ITypenamedBench<FiberSwitchBench> {
+private:
+    using Self = FiberSwitchBench;
+
+    static void SwitchBack(sharpen::Fiber *main) {
+        for (std::size_t i = 0; i != switchCount; ++i) {
+            main->Switch();
+        }
+    }
+
+    static void Measure(double *seconds) {
+        sharpen::FiberPtr main{sharpen::Fiber::GetCurrentFiber()};
+        sharpen::FiberPtr fiber{
+            sharpen::Fiber::MakeFiber(fiberStackSize, &Self::SwitchBack, main.get())};
+        simplebench::Stopwatch watch;
+        fiber->Switch(main.get());
+        for (std::size_t i = 0; i != switchCount; ++i) {
+            fiber->Switch();
+        }
+        *seconds = watch.GetSeconds();
+    }
+
+public:
+    FiberSwitchBench() noexcept = default;
+
+    ~FiberSwitchBench() noexcept = default;
+
+    inline const Self &Const() const noexcept {
+        return *this;
+    }
+
+    inline virtual simplebench::BenchResult Run() noexcept {
+        double seconds{0};
+        std::thread worker{&Self::Measure, &seconds};
+        worker.join();
+        // switches in both directions
+        return this->Done(2 * (switchCount + 1), seconds);
+    }
+};
+
+// launch fibers from a fiber and wait for all of them
+class LaunchBench : public simplebench::ITypenamedBench<LaunchBench> {
+private:
+    using Self = LaunchBench;
+
+    static void Finish(std::atomic_size_t *counter, sharpen::AwaitableFuture<void> *future) {
+        if (counter->fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            future->Complete();
+        }
+    }
+
+public:
+    LaunchBench() noexcept = default;
+
+    ~LaunchBench() noexcept = default;
+
+    inline const Self &Const() const noexcept {
+        return *this;
+    }
+
+    inline virtual simplebench::BenchResult Run() noexcept {
+        std::atomic_size_t counter{launchCount};
+        sharpen::AwaitableFuture<void> future;
+        simplebench::Stopwatch watch;
+        for (std::size_t i = 0; i != launchCount; ++i) {
+            sharpen::Launch(&Self::Finish, &counter, &future);
+        }
+        future.Await();
+        simplebench::BenchResult result{this->Done(launchCount, watch.GetSeconds())};
+        result.AddMetric("loops", static_cast<double>(sharpen::GetLocalLoopGroup().GetLoopCount()));
+        return result;
+    }
+};
+
+// bounce a task between two event loops with RunInLoopSoon
+class RunInLoopPingPongBench : public simplebench::ITypenamedBench<RunInLoopPingPongBench> {
+private:
+    using Self = RunInLoopPingPongBench;
+
+    struct PingPong {
+        sharpen::EventLoop *loops_[2];
+        std::size_t remaining_;
+        sharpen::AwaitableFuture<void> *future_;
+    };
+
+    class Bounce {
+    private:
+        PingPong *state_;
+        std::size_t side_;
+
+    public:
+        Bounce(PingPong *state, std::size_t side) noexcept
+            : state_(state)
+            , side_(side) {
+        }
+
+        inline void operator()() {
+            // only one task is in flight
+            this->state_->remaining_ -= 1;
+            if (!this->state_->remaining_) {
+                this->state_->future_->Complete();
+                return;
+            }
+            std::size_t next{1 - this->side_};
+            this->state_->loops_[next]->RunInLoopSoon(Bounce{this->state_, next});
+        }
+    };
+
+public:
+    RunInLoopPingPongBench() noexcept = default;
+
+    ~RunInLoopPingPongBench() noexcept = default;
+
+    inline const Self &Const() const noexcept {
+        return *this;
+    }
+
+    inline virtual simplebench::BenchResult Run() noexcept {
+        sharpen::IEventLoopGroup &loopGroup{sharpen::GetLocalLoopGroup()};
+        std::size_t other{0};
+        if (loopGroup.GetLoopCount() > 1) {
+            other = 1;
+        }
+        sharpen::AwaitableFuture<void> future;
+        PingPong state;
+        state.loops_[0] = &loopGroup.GetLoop(0);
+        state.loops_[1] = &loopGroup.GetLoop(other);
+        state.remaining_ = pingPongCount;
+        state.future_ = &future;
+        simplebench::Stopwatch watch;
+        state.loops_[0]->RunInLoopSoon(Bounce{&state, 0});
+        future.Await();
+        simplebench::BenchResult result{this->Done(pingPongCount, watch.GetSeconds())};
+        result.AddMetric("cross_thread", static_cast<double>(other));
+        return result;
+    }
+};
+
+// fibers on every loop fight for one AsyncMutex
+class AsyncMutexBench : public simplebench::ITypenamedBench<AsyncMutexBench> {
+private:
+    using Self = AsyncMutexBench;
+
+    static void Contend(sharpen::AsyncMutex *lock, std::size_t *counter) {
+        for (std::size_t i = 0; i != mutexLockCount; ++i) {
+            std::unique_lock<sharpen::AsyncMutex> guard{*lock};
+            *counter += 1;
+        }
+    }
+
+public:
+    AsyncMutexBench() noexcept = default;
+
+    ~AsyncMutexBench() noexcept = default;
+
+    inline const Self &Const() const noexcept {
+        return *this;
+    }
+
+    inline virtual simplebench::BenchResult Run() noexcept {
+        sharpen::AsyncMutex lock;
+        std::size_t counter{0};
+        std::vector<sharpen::AwaitableFuturePtr<void>> fibers;
+        fibers.reserve(mutexFiberCount);
+        simplebench::Stopwatch watch;
+        for (std::size_t i = 0; i != mutexFiberCount; ++i) {
+            fibers.emplace_back(sharpen::Async(&Self::Contend, &lock, &counter));
+        }
+        for (auto begin = fibers.begin(), end = fibers.end(); begin != end; ++begin) {
+            (*begin)->Await();
+        }
+        double seconds{watch.GetSeconds()};
+        if (counter != mutexFiberCount * mutexLockCount) {
+            return this->Fail("lost updates under AsyncMutex");
+        }
+        return this->Done(counter, seconds);
+    }
+};
+
+// complete and await a future on the same fiber
+class FutureCompleteBench : public simplebench::ITypenamedBench<FutureCompleteBench> {
+private:
+    using Self = FutureCompleteBench;
+
+public:
+    FutureCompleteBench() noexcept = default;
+
+    ~FutureCompleteBench() noexcept = default;
+
+    inline const Self &Const() const noexcept {
+        return *this;
+    }
+
+    inline virtual simplebench::BenchResult Run() noexcept {
+        std::size_t sum{0};
+        std::size_t allocs{GetAllocCount()};
+        simplebench::Stopwatch watch;
+        for (std::size_t i = 0; i != futureCount; ++i) {
+            sharpen::AwaitableFuture<std::size_t> future;
+            future.Complete(i);
+            sum += future.Await();
+        }
+        double seconds{watch.GetSeconds()};
+        allocs = GetAllocCount() - allocs;
+        if (sum != futureCount * (futureCount - 1) / 2) {
+            return this->Fail("wrong future values");
+        }
+        simplebench::BenchResult result{this->Done(futureCount, seconds)};
+        result.AddMetric("allocs_per_op",
+                         static_cast<double>(allocs) / static_cast<double>(futureCount));
+        return result;
+    }
+};
+
+// complete a future with a small callback
+class FutureCallbackBench : public simplebench::ITypenamedBench<FutureCallbackBench> {
+private:
+    using Self = FutureCallbackBench;
+
+    class Accumulate {
+    private:
+        std::size_t *sum_;
+
+    public:
+        explicit Accumulate(std::size_t *sum) noexcept
+            : sum_(sum) {
+        }
+
+        inline void operator()(sharpen::Future<std::size_t> &future) {
+            *this->sum_ += future.Get();
+        }
+    };
+
+public:
+    FutureCallbackBench() noexcept = default;
+
+    ~FutureCallbackBench() noexcept = default;
+
+    inline const Self &Const() const noexcept {
+        return *this;
+    }
+
+    inline virtual simplebench::BenchResult Run() noexcept {
+        std::size_t sum{0};
+        std::size_t allocs{GetAllocCount()};
+        simplebench::Stopwatch watch;
+        for (std::size_t i = 0; i != futureCount; ++i) {
+            sharpen::Future<std::size_t> future;
+            future.SetCallback(Accumulate{&sum});
+            future.Complete(i);
+        }
+        double seconds{watch.GetSeconds()};
+        allocs = GetAllocCount() - allocs;
+        if (sum != futureCount * (futureCount - 1) / 2) {
+            return this->Fail("wrong future values");
+        }
+        simplebench::BenchResult result{this->Done(futureCount, seconds)};
+        result.AddMetric("allocs_per_op",
+                         static_cast<double>(allocs) / static_cast<double>(futureCount));
+        return result;
+    }
+};
+
+// several producer threads and one consumer thread
+class MpscQueueBench : public simplebench::ITypenamedBench<MpscQueueBench> {
+private:
+    using Self = MpscQueueBench;
+
+    static void Produce(sharpen::MpscQueue<std::size_t> *queue) {
+        for (std::size_t i = 0; i != queueCount / queueProducerCount; ++i) {
+            queue->Push(i);
+        }
+    }
+
+public:
+    MpscQueueBench() noexcept = default;
+
+    ~MpscQueueBench() noexcept = default;
+
+    inline const Self &Const() const noexcept {
+        return *this;
+    }
+
+    inline virtual simplebench::BenchResult Run() noexcept {
+        sharpen::MpscQueue<std::size_t> queue{256};
+        std::size_t total{queueCount / queueProducerCount * queueProducerCount};
+        std::vector<std::thread> producers;
+        producers.reserve(queueProducerCount);
+        simplebench::Stopwatch watch;
+        for (std::size_t i = 0; i != queueProducerCount; ++i) {
+            producers.emplace_back(&Self::Produce, &queue);
+        }
+        std::size_t count{0};
+        std::size_t value{0};
+        while (count != total) {
+            if (queue.TryPop(value)) {
+                count += 1;
+            } else {
+                std::this_thread::yield();
+            }
+        }
+        double seconds{watch.GetSeconds()};
+        for (auto begin = producers.begin(), end = producers.end(); begin != end; ++begin) {
+            begin->join();
+        }
+        simplebench::BenchResult result{this->Done(total, seconds)};
+        result.AddMetric("producers", static_cast<double>(queueProducerCount));
+        return result;
+    }
+};
+
+static int Entry(int argc, char const *argv[]) {
+    simplebench::BenchRunner runner{"CoBench", argc, argv};
+    runner.AddContext("loops", std::to_string(sharpen::GetLocalLoopGroup().GetLoopCount()));
+    runner.Register<FiberSwitchBench>();
+    runner.Register<LaunchBench>();
+    runner.Register<RunInLoopPingPongBench>();
+    runner.Register<AsyncMutexBench>();
+    runner.Register<FutureCompleteBench>();
+    runner.Register<FutureCallbackBench>();
+    runner.Register<MpscQueueBench>();
+    return runner.Run();
+}
+
+// --threads=N selects the number of event loops
+int main(int argc, char const *argv[]) {
+    std::size_t threads{
+        simplebench::GetOption(argc, argv, "threads", std::thread::hardware_concurrency())};
+    // at least two loops to measure cross-thread wakeups
+    if (threads < 2) {
+        threads = 2;
+    }
+    sharpen::EventEngine &engine{sharpen::EventEngine::SetupEngine(threads)};
+    return engine.StartupWithCode(&Entry, argc, argv);
+}
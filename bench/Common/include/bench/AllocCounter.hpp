@@ -0,0 +1,11 @@
+#pragma once
+#ifndef _ALLOCCOUNTER_HPP
+#define _ALLOCCOUNTER_HPP
+
+#include <cstddef>
+
+// the number of global operator new calls in this process
+// linking the bench common library replaces operator new to count them
+extern std::size_t GetAllocCount() noexcept;
+
+#endif
@@ -0,0 +1,57 @@
+#include <bench/AllocCounter.hpp>
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+static std::atomic_size_t allocCount{0};
+
+std::size_t GetAllocCount() noexcept {
+    return allocCount.load(std::memory_order_relaxed);
+}
+
+void *operator new(std::size_t size) {
+    allocCount.fetch_add(1, std::memory_order_relaxed);
+    void *p{std::malloc(size ? size : 1)};
+    if (!p) {
+        throw std::bad_alloc{};
+    }
+    return p;
+}
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept {
+    allocCount.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc(size ? size : 1);
+}
+
+void *operator new[](std::size_t size) {
+    return ::operator new(size);
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &tag) noexcept {
+    return ::operator new(size, tag);
+}
+
+void operator delete(void *p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete(void *p, const std::nothrow_t &) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void *p) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void *p, std::size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void *p, const std::nothrow_t &) noexcept {
+    std::free(p);
+}
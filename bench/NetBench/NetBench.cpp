@@ -0,0 +1,629 @@
+#include <sharpen/AsyncOps.hpp>
+#include <sharpen/AwaitableFuture.hpp>
+#include <sharpen/DnsResolver.hpp>
+#include <sharpen/EventEngine.hpp>
+#include <sharpen/FileOps.hpp>
+#include <sharpen/GenericMail.hpp>
+#include <sharpen/GenericMailParserFactory.hpp>
+#include <sharpen/IHostPipelineStep.hpp>
+#include <sharpen/INetStreamChannel.hpp>
+#include <sharpen/IpEndPoint.hpp>
+#include <sharpen/IpTcpStreamFactory.hpp>
+#include <sharpen/SimpleHostPipeline.hpp>
+#include <sharpen/SingleWorkerGroup.hpp>
+#include <sharpen/TcpHost.hpp>
+#include <sharpen/TcpPoster.hpp>
+#include <simplebench/BenchRunner.hpp>
+#include <atomic>
+#include <cassert>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <string>
+#include <thread>
+#include <vector>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+static const std::uint32_t magicNumber{0x2333};
+
+static constexpr std::uint16_t echoPort{12801};
+
+static constexpr std::size_t echoCount{10 * 1000};
+
+static constexpr std::size_t echoContentSize{64};
+
+static constexpr std::size_t connectFiberCount{8};
+
+static constexpr std::size_t connectCount{128};
+
+static constexpr std::size_t idleSocketCount{1000};
+
+static constexpr std::size_t cachedLookupCount{1000 * 1000};
+
+static constexpr std::size_t uncachedLookupCount{2000};
+
+static constexpr std::uint16_t sendFilePort{12802};
+
+static const char *sendFileName{"./netbench_sendfile.tmp"};
+
+// 64MB
+static constexpr std::size_t sendFileSize{64 * 1024 * 1024};
+
+static constexpr std::size_t sendFileCount{16};
+
+// writes every mail back to the sender
+class EchoStep
+    : public sharpen::IHostPipelineStep
+    , public sharpen::Noncopyable {
+private:
+    using Self = EchoStep;
+
+    sharpen::GenericMailParserFactory factory_;
+
+public:
+    EchoStep()
+        : factory_(magicNumber, (std::numeric_limits<std::uint32_t>::max)()) {
+    }
+
+    virtual ~EchoStep() noexcept = default;
+
+    inline const Self &Const() const noexcept {
+        return *this;
+    }
+
+    virtual sharpen::HostPipelineResult Consume(sharpen::INetStreamChannel &channel,
+                                                const std::atomic_bool &active) noexcept override {
+        (void)active;
+        std::unique_ptr<sharpen::IMailParser> parser{this->factory_.Produce()};
+        sharpen::ByteBuffer buf{4096};
+        try {
+            std::size_t size{channel.ReadAsync(buf)};
+            while (size != 0) {
+                parser->Parse(buf.GetSlice(0, size));
+                while (parser->Completed()) {
+                    sharpen::Mail mail{parser->PopCompletedMail()};
+                    // one syscall, otherwise nagle delays the content
+                    sharpen::ByteSlice slices[2]{mail.Header().GetSlice(),
+                                                 mail.Content().GetSlice()};
+                    channel.WriteVectorFixedAsync(slices, mail.Content().Empty() ? 1 : 2);
+                }
+                size = channel.ReadAsync(buf);
+            }
+        } catch (const std::exception &ignore) {
+            (void)ignore;
+        }
+        return sharpen::HostPipelineResult::Broken;
+    }
+};
+
+static std::unique_ptr<sharpen::IHostPipeline> ConfigEchoPipeline() {
+    std::unique_ptr<sharpen::IHostPipeline> pipe{new (std::nothrow) sharpen::SimpleHostPipeline{}};
+    if (!pipe) {
+        throw std::bad_alloc{};
+    }
+    pipe->Register<EchoStep>();
+    return pipe;
+}
+
+static sharpen::IpEndPoint GetEchoEndPoint() {
+    sharpen::IpEndPoint endPoint;
+    endPoint.SetAddrByString("127.0.0.1");
+    endPoint.SetPort(echoPort);
+    return endPoint;
+}
+
+// a tcp host shared by all network benchmarks
+class EchoServer {
+private:
+    using Self = EchoServer;
+
+    std::unique_ptr<sharpen::TcpHost> host_;
+    sharpen::SingleWorkerGroup worker_;
+
+public:
+    EchoServer()
+        : host_(nullptr)
+        , worker_() {
+        sharpen::IpTcpStreamFactory streamFactory{GetEchoEndPoint()};
+        // one acceptor per event loop
+        sharpen::TcpStreamOption option;
+        option.EnableReuseAddressInNix();
+        option.EnableReusePort();
+        this->host_.reset(new (std::nothrow) sharpen::TcpHost{streamFactory, option});
+        if (!this->host_) {
+            throw std::bad_alloc{};
+        }
+        this->host_->ConfiguratePipeline(&ConfigEchoPipeline);
+        this->worker_.Submit(&sharpen::IHost::Run, this->host_.get());
+    }
+
+    ~EchoServer() noexcept {
+        this->host_->Stop();
+        this->worker_.Stop();
+        this->worker_.Join();
+    }
+
+    inline std::size_t GetAcceptorCount() const noexcept {
+        return this->host_->GetAcceptorCount();
+    }
+};
+
+static std::unique_ptr<sharpen::TcpPoster> OpenEchoPoster() {
+    std::unique_ptr<sharpen::IEndPoint> remote{new (std::nothrow)
+                                                   sharpen::IpEndPoint{GetEchoEndPoint()}};
+    if (!remote) {
+        throw std::bad_alloc{};
+    }
+    sharpen::IpEndPoint local{0, 0};
+    std::shared_ptr<sharpen::ITcpSteamFactory> factory{
+        std::make_shared<sharpen::IpTcpStreamFactory>(sharpen::GetLocalLoopGroup(), local)};
+    std::unique_ptr<sharpen::TcpPoster> poster{
+        new (std::nothrow) sharpen::TcpPoster{std::move(remote), std::move(factory)}};
+    if (!poster) {
+        throw std::bad_alloc{};
+    }
+    sharpen::GenericMailParserFactory parserFactory{magicNumber};
+    poster->Open(parserFactory.Produce());
+    return poster;
+}
+
+static sharpen::Mail MakeEchoMail() {
+    sharpen::GenericMail mail{magicNumber};
+    sharpen::ByteBuffer content{echoContentSize};
+    mail.SetContent(std::move(content));
+    return mail.ReleaseMail();
+}
+
+// return the number of echoed mails
+static std::size_t PostEchoMails(sharpen::TcpPoster &poster, std::size_t count) {
+    sharpen::Mail mail{MakeEchoMail()};
+    for (std::size_t i = 0; i != count; ++i) {
+        sharpen::Mail response{poster.Post(mail)};
+        if (response.Content().GetSize() != echoContentSize) {
+            return i;
+        }
+    }
+    return count;
+}
+
+// synchronous request/response over one connection
+class TcpEchoBench : public simplebench::ITypenamedBench<TcpEchoBench> {
+private:
+    using Self = TcpEchoBench;
+
+public:
+    TcpEchoBench() noexcept = default;
+
+    ~TcpEchoBench() noexcept = default;
+
+    inline const Self &Const() const noexcept {
+        return *this;
+    }
+
+    inline virtual simplebench::BenchResult Run() noexcept {
+        try {
+            std::unique_ptr<sharpen::TcpPoster> poster{OpenEchoPoster()};
+            simplebench::Stopwatch watch;
+            std::size_t count{PostEchoMails(*poster, echoCount)};
+            double seconds{watch.GetSeconds()};
+            poster->Close();
+            if (count != echoCount) {
+                return this->Fail("echo server dropped a mail");
+            }
+            return this->Done(count, seconds);
+        } catch (const std::exception &error) {
+            return this->Fail(error.what());
+        }
+    }
+};
+
+// many fibers connect and disconnect at the same time
+class ConnectStormBench : public simplebench::ITypenamedBench<ConnectStormBench> {
+private:
+    using Self = ConnectStormBench;
+
+    const EchoServer *server_;
+
+    static void Connect(std::atomic_size_t *succeeded) {
+        sharpen::IpTcpStreamFactory factory{sharpen::GetLocalLoopGroup(), sharpen::IpEndPoint{0, 0}};
+        sharpen::IpEndPoint remote{GetEchoEndPoint()};
+        for (std::size_t i = 0; i != connectCount; ++i) {
+            try {
+                sharpen::NetStreamChannelPtr channel{factory.Produce(sharpen::TcpStreamOption{})};
+                channel->ConnectAsync(remote);
+                succeeded->fetch_add(1, std::memory_order_relaxed);
+                channel->Close();
+            } catch (const std::exception &ignore) {
+                (void)ignore;
+            }
+        }
+    }
+
+public:
+    explicit ConnectStormBench(const EchoServer *server) noexcept
+        : server_(server) {
+    }
+
+    ~ConnectStormBench() noexcept = default;
+
+    inline const Self &Const() const noexcept {
+        return *this;
+    }
+
+    inline virtual simplebench::BenchResult Run() noexcept {
+        std::atomic_size_t succeeded{0};
+        std::vector<sharpen::AwaitableFuturePtr<void>> fibers;
+        fibers.reserve(connectFiberCount);
+        simplebench::Stopwatch watch;
+        for (std::size_t i = 0; i != connectFiberCount; ++i) {
+            fibers.emplace_back(sharpen::Async(&Self::Connect, &succeeded));
+        }
+        for (auto begin = fibers.begin(), end = fibers.end(); begin != end; ++begin) {
+            (*begin)->Await();
+        }
+        double seconds{watch.GetSeconds()};
+        if (succeeded != connectFiberCount * connectCount) {
+            return this->Fail("some connections were refused");
+        }
+        simplebench::BenchResult result{this->Done(succeeded, seconds)};
+        result.AddMetric("acceptors", static_cast<double>(this->server_->GetAcceptorCount()));
+        return result;
+    }
+};
+
+// echo latency while the selector watches many idle sockets
+class IdleSocketsEchoBench : public simplebench::ITypenamedBench<IdleSocketsEchoBench> {
+private:
+    using Self = IdleSocketsEchoBench;
+
+public:
+    IdleSocketsEchoBench() noexcept = default;
+
+    ~IdleSocketsEchoBench() noexcept = default;
+
+    inline const Self &Const() const noexcept {
+        return *this;
+    }
+
+    inline virtual simplebench::BenchResult Run() noexcept {
+        try {
+            sharpen::IpTcpStreamFactory factory{sharpen::GetLocalLoopGroup(),
+                                                sharpen::IpEndPoint{0, 0}};
+            sharpen::IpEndPoint remote{GetEchoEndPoint()};
+            std::vector<sharpen::NetStreamChannelPtr> idles;
+            idles.reserve(idleSocketCount);
+            for (std::size_t i = 0; i != idleSocketCount; ++i) {
+                sharpen::NetStreamChannelPtr channel{factory.Produce(sharpen::TcpStreamOption{})};
+                channel->ConnectAsync(remote);
+                idles.emplace_back(std::move(channel));
+            }
+            std::unique_ptr<sharpen::TcpPoster> poster{OpenEchoPoster()};
+            simplebench::Stopwatch watch;
+            std::size_t count{PostEchoMails(*poster, echoCount)};
+            double seconds{watch.GetSeconds()};
+            poster->Close();
+            for (auto begin = idles.begin(), end = idles.end(); begin != end; ++begin) {
+                (*begin)->Close();
+            }
+            if (count != echoCount) {
+                return this->Fail("echo server dropped a mail");
+            }
+            simplebench::BenchResult result{this->Done(count, seconds)};
+            result.AddMetric("idle_sockets", static_cast<double>(idleSocketCount));
+            return result;
+        } catch (const std::exception &error) {
+            return this->Fail(error.what());
+        }
+    }
+};
+
+static void RemoveSendFile() {
+    if (sharpen::ExistFile(sendFileName)) {
+        sharpen::RemoveFile(sendFileName);
+    }
+}
+
+static sharpen::FileChannelPtr CreateSendFile() {
+    RemoveSendFile();
+    sharpen::FileChannelPtr file{sharpen::OpenFileChannel(
+        sendFileName, sharpen::FileAccessMethod::All, sharpen::FileOpenMethod::CreateNew)};
+    file->Register(sharpen::GetLocalLoopGroup());
+    std::vector<char> content(1024 * 1024);
+    for (std::size_t i = 0; i != content.size(); ++i) {
+        content[i] = static_cast<char>(i % 251);
+    }
+    for (std::size_t offset = 0; offset != sendFileSize; offset += content.size()) {
+        file->WriteFixedAsync(content.data(), content.size(), offset);
+    }
+    return file;
+}
+
+// file bytes sent by SendFileAsync() over one loopback connection
+class SendFileBench : public simplebench::ITypenamedBench<SendFileBench> {
+private:
+    using Self = SendFileBench;
+
+    // return the number of received bytes
+    static std::size_t Drain(sharpen::NetStreamChannelPtr conn, std::size_t size) {
+        std::vector<char> buf(256 * 1024);
+        std::size_t received{0};
+        while (received != size) {
+            std::size_t sz{conn->ReadAsync(buf.data(), buf.size())};
+            if (!sz) {
+                break;
+            }
+            received += sz;
+        }
+        return received;
+    }
+
+public:
+    SendFileBench() noexcept = default;
+
+    ~SendFileBench() noexcept = default;
+
+    inline const Self &Const() const noexcept {
+        return *this;
+    }
+
+    inline virtual simplebench::BenchResult Run() noexcept {
+        try {
+            sharpen::FileChannelPtr file{CreateSendFile()};
+            sharpen::IpEndPoint endPoint;
+            endPoint.SetAddrByString("127.0.0.1");
+            endPoint.SetPort(sendFilePort);
+            sharpen::NetStreamChannelPtr server{
+                sharpen::OpenTcpChannel(sharpen::AddressFamily::Ip)};
+            server->ReuseAddressInNix();
+            server->Bind(endPoint);
+            server->Register(sharpen::GetLocalLoopGroup());
+            server->Listen(65535);
+            sharpen::NetStreamChannelPtr client{
+                sharpen::OpenTcpChannel(sharpen::AddressFamily::Ip)};
+            client->Bind(sharpen::IpEndPoint{0, 0});
+            client->Register(sharpen::GetLocalLoopGroup());
+            auto connecting{
+                sharpen::Async([client, &endPoint]() { client->ConnectAsync(endPoint); })};
+            sharpen::NetStreamChannelPtr conn{server->AcceptAsync()};
+            conn->Register(sharpen::GetLocalLoopGroup());
+            connecting->Await();
+            std::size_t total{sendFileSize * sendFileCount};
+            simplebench::Stopwatch watch;
+            auto receiving{sharpen::Async(&Self::Drain, conn, total)};
+            std::size_t sent{0};
+            for (std::size_t i = 0; i != sendFileCount; ++i) {
+                sent += client->SendFileAsync(file, sendFileSize, 0);
+            }
+            std::size_t received{receiving->Await()};
+            double seconds{watch.GetSeconds()};
+            client->Close();
+            conn->Close();
+            server->Close();
+            file->Close();
+            RemoveSendFile();
+            if (sent != total || received != total) {
+                return this->Fail("file was not sent completely");
+            }
+            simplebench::BenchResult result{this->Done(sendFileCount, seconds)};
+            result.AddMetric("mb_per_sec",
+                             static_cast<double>(total) / seconds / (1024 * 1024));
+            return result;
+        } catch (const std::exception &error) {
+            RemoveSendFile();
+            return this->Fail(error.what());
+        }
+    }
+};
+
+// answers every A query with 127.0.0.1
+class StubDnsServer {
+private:
+    using Self = StubDnsServer;
+
+    int fd_;
+    std::uint16_t port_;
+    std::atomic_bool stop_;
+    std::thread worker_;
+
+    static void Append16(std::string &buf, std::uint16_t val) {
+        buf.push_back(static_cast<char>(val >> 8));
+        buf.push_back(static_cast<char>(val & 0xff));
+    }
+
+    static void Append32(std::string &buf, std::uint32_t val) {
+        Append16(buf, static_cast<std::uint16_t>(val >> 16));
+        Append16(buf, static_cast<std::uint16_t>(val & 0xffff));
+    }
+
+    void Serve() {
+        char buf[512];
+        while (!this->stop_) {
+            sockaddr_in from;
+            socklen_t fromLen{sizeof(from)};
+            ssize_t size{::recvfrom(
+                this->fd_, buf, sizeof(buf), 0, reinterpret_cast<sockaddr *>(&from), &fromLen)};
+            if (size < 12) {
+                continue;
+            }
+            // skip the question
+            std::size_t offset{12};
+            while (offset < static_cast<std::size_t>(size) && buf[offset]) {
+                offset += static_cast<unsigned char>(buf[offset]) + 1;
+            }
+            offset += 5;
+            if (offset > static_cast<std::size_t>(size)) {
+                continue;
+            }
+            std::string reply{buf, offset};
+            Append16(reply, 0xc00c);
+            Append16(reply, 1);
+            Append16(reply, 1);
+            Append32(reply, 3600);
+            Append16(reply, 4);
+            Append32(reply, 0x7f000001);
+            reply[2] = static_cast<char>(0x81);
+            reply[3] = static_cast<char>(0x80);
+            reply[6] = 0;
+            reply[7] = 1;
+            ::sendto(this->fd_,
+                     reply.data(),
+                     reply.size(),
+                     0,
+                     reinterpret_cast<sockaddr *>(&from),
+                     fromLen);
+        }
+    }
+
+public:
+    StubDnsServer()
+        : fd_(-1)
+        , port_(0)
+        , stop_(false)
+        , worker_() {
+        this->fd_ = ::socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+        assert(this->fd_ != -1);
+        sockaddr_in addr;
+        std::memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = ::htonl(INADDR_LOOPBACK);
+        addr.sin_port = 0;
+        int r{::bind(this->fd_, reinterpret_cast<sockaddr *>(&addr), sizeof(addr))};
+        assert(r == 0);
+        socklen_t len{sizeof(addr)};
+        r = ::getsockname(this->fd_, reinterpret_cast<sockaddr *>(&addr), &len);
+        assert(r == 0);
+        (void)r;
+        this->port_ = ::ntohs(addr.sin_port);
+        // wake up periodically to check the stop flag
+        timeval timeout;
+        timeout.tv_sec = 0;
+        timeout.tv_usec = 100 * 1000;
+        ::setsockopt(this->fd_, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        this->worker_ = std::thread{&Self::Serve, this};
+    }
+
+    ~StubDnsServer() noexcept {
+        this->stop_ = true;
+        this->worker_.join();
+        ::close(this->fd_);
+    }
+
+    inline sharpen::IpEndPoint GetEndPoint() const noexcept {
+        sharpen::IpEndPoint ep;
+        ep.SetAddrByString("127.0.0.1");
+        ep.SetPort(this->port_);
+        return ep;
+    }
+};
+
+// lookups served from the resolver cache
+class DnsCachedLookupBench : public simplebench::ITypenamedBench<DnsCachedLookupBench> {
+private:
+    using Self = DnsCachedLookupBench;
+
+    const StubDnsServer *server_;
+
+public:
+    explicit DnsCachedLookupBench(const StubDnsServer *server) noexcept
+        : server_(server) {
+    }
+
+    ~DnsCachedLookupBench() noexcept = default;
+
+    inline const Self &Const() const noexcept {
+        return *this;
+    }
+
+    inline virtual simplebench::BenchResult Run() noexcept {
+        try {
+            sharpen::DnsResolver resolver{sharpen::GetLocalLoopGroup(),
+                                          this->server_->GetEndPoint()};
+            std::vector<sharpen::DnsResolveResult> results;
+            resolver.ResolveName("bench.test", sharpen::AddressFamily::Ip, std::back_inserter(results));
+            simplebench::Stopwatch watch;
+            for (std::size_t i = 0; i != cachedLookupCount; ++i) {
+                results.clear();
+                resolver.ResolveName(
+                    "bench.test", sharpen::AddressFamily::Ip, std::back_inserter(results));
+            }
+            double seconds{watch.GetSeconds()};
+            if (results.size() != 1) {
+                return this->Fail("should resolve one address");
+            }
+            return this->Done(cachedLookupCount, seconds);
+        } catch (const std::exception &error) {
+            return this->Fail(error.what());
+        }
+    }
+};
+
+// every lookup is a round trip to the name server
+class DnsUncachedLookupBench : public simplebench::ITypenamedBench<DnsUncachedLookupBench> {
+private:
+    using Self = DnsUncachedLookupBench;
+
+    const StubDnsServer *server_;
+
+public:
+    explicit DnsUncachedLookupBench(const StubDnsServer *server) noexcept
+        : server_(server) {
+    }
+
+    ~DnsUncachedLookupBench() noexcept = default;
+
+    inline const Self &Const() const noexcept {
+        return *this;
+    }
+
+    inline virtual simplebench::BenchResult Run() noexcept {
+        try {
+            sharpen::DnsResolver resolver{sharpen::GetLocalLoopGroup(),
+                                          this->server_->GetEndPoint()};
+            std::vector<sharpen::DnsResolveResult> results;
+            simplebench::Stopwatch watch;
+            for (std::size_t i = 0; i != uncachedLookupCount; ++i) {
+                resolver.ClearCache();
+                results.clear();
+                resolver.ResolveName(
+                    "bench.test", sharpen::AddressFamily::Ip, std::back_inserter(results));
+            }
+            double seconds{watch.GetSeconds()};
+            if (results.size() != 1) {
+                return this->Fail("should resolve one address");
+            }
+            return this->Done(uncachedLookupCount, seconds);
+        } catch (const std::exception &error) {
+            return this->Fail(error.what());
+        }
+    }
+};
+
+static int Entry(int argc, char const *argv[]) {
+    sharpen::StartupNetSupport();
+    EchoServer echoServer;
+    StubDnsServer dnsServer;
+    simplebench::BenchRunner runner{"NetBench", argc, argv};
+    runner.AddContext("loops", std::to_string(sharpen::GetLocalLoopGroup().GetLoopCount()));
+    runner.Register<TcpEchoBench>();
+    runner.Register<ConnectStormBench>(&echoServer);
+    runner.Register<IdleSocketsEchoBench>();
+    runner.Register<SendFileBench>();
+    runner.Register<DnsCachedLookupBench>(&dnsServer);
+    runner.Register<DnsUncachedLookupBench>(&dnsServer);
+    return runner.Run();
+}
+
+// --threads=N selects the number of event loops
+int main(int argc, char const *argv[]) {
+    std::size_t threads{
+        simplebench::GetOption(argc, argv, "threads", std::thread::hardware_concurrency())};
+    if (!threads) {
+        threads = 1;
+    }
+    sharpen::EventEngine &engine{sharpen::EventEngine::SetupEngine(threads)};
+    return engine.StartupWithCode(&Entry, argc, argv);
+}
@@ -0,0 +1,502 @@
+#include <common/RaftTool.hpp>
+#include <sharpen/AsyncOps.hpp>
+#include <sharpen/EventEngine.hpp>
+#include <sharpen/FileOps.hpp>
+#include <sharpen/FileRaftSnapshotController.hpp>
+#include <sharpen/IConsensus.hpp>
+#include <sharpen/INetStreamChannel.hpp>
+#include <sharpen/RaftConsensus.hpp>
+#include <sharpen/TcpHost.hpp>
+#include <sharpen/TimerOps.hpp>
+#include <sharpen/YieldOps.hpp>
+#include <simplebench/BenchRunner.hpp>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+static const std::uint32_t magicNumber{0x2333};
+
+static const char *snapshotName{"./raftsnapshot"};
+
+// the raft tests use 10801-10803
+static const std::uint16_t beginPort{11801};
+
+static const std::uint16_t endPort{11803};
+
+static constexpr std::size_t batchSize{20};
+
+static constexpr std::size_t pipelineLength{2};
+
+static constexpr std::size_t clientCount{10};
+
+static constexpr std::size_t entrySize{1024};
+
+// a few election timeouts of the raft tests
+static constexpr std::size_t readLease{100};
+
+static constexpr std::size_t snapshotSize{64 * 1024 * 1024};
+
+static constexpr std::size_t snapshotPipelineLength{4};
+
+static std::shared_ptr<sharpen::IConsensus> CreateBasicRaft(std::uint16_t port) {
+    sharpen::RaftOption raftOpt;
+    raftOpt.SetBatchSize(batchSize);
+    raftOpt.SetLearner(false);
+    raftOpt.SetPrevote(false);
+    raftOpt.EnableLeaseAwareness();
+    auto raft{CreateRaft(port, magicNumber, nullptr, nullptr, raftOpt, false)};
+    raft->ConfiguratePeers(
+        &ConfigPeers, port, beginPort, endPort, &raft->GetReceiver(), magicNumber, false);
+    return raft;
+}
+
+static std::shared_ptr<sharpen::IConsensus> CreateReadLeaseRaft(std::uint16_t port) {
+    sharpen::RaftOption raftOpt;
+    raftOpt.SetBatchSize(batchSize);
+    raftOpt.SetLearner(false);
+    raftOpt.SetPrevote(false);
+    raftOpt.SetReadLease(std::chrono::milliseconds{readLease});
+    raftOpt.EnableLeaseAwareness();
+    auto raft{CreateRaft(port, magicNumber, nullptr, nullptr, raftOpt, false)};
+    raft->ConfiguratePeers(
+        &ConfigPeers, port, beginPort, endPort, &raft->GetReceiver(), magicNumber, false);
+    return raft;
+}
+
+static std::shared_ptr<sharpen::IConsensus> CreatePipelinedReplicationRaft(std::uint16_t port) {
+    sharpen::RaftOption raftOpt;
+    raftOpt.SetBatchSize(batchSize);
+    raftOpt.SetLearner(false);
+    raftOpt.SetPrevote(false);
+    raftOpt.SetPipelineLength(pipelineLength);
+    raftOpt.EnablePipelinedReplication();
+    raftOpt.EnableLeaseAwareness();
+    auto raft{CreateRaft(port, magicNumber, nullptr, nullptr, raftOpt, true)};
+    raft->ConfiguratePeers(
+        &ConfigPeers, port, beginPort, endPort, &raft->GetReceiver(), magicNumber, true);
+    return raft;
+}
+
+struct RaftCluster {
+    std::vector<std::shared_ptr<sharpen::IConsensus>> rafts_;
+    std::vector<std::unique_ptr<sharpen::IHost>> hosts_;
+    std::vector<sharpen::AwaitableFuturePtr<void>> process_;
+};
+
+// 3-node cluster on loopback, returns the leader
+static sharpen::IConsensus *StartCluster(
+    RaftCluster &cluster, std::shared_ptr<sharpen::IConsensus> (*createRaft)(std::uint16_t)) {
+    cluster.rafts_.reserve(3);
+    cluster.hosts_.reserve(3);
+    cluster.process_.reserve(3);
+    for (std::uint16_t i = beginPort; i != endPort + 1; ++i) {
+        auto raft{createRaft(i)};
+        cluster.rafts_.emplace_back(raft);
+        auto host{CreateRaftHost(i, raft, magicNumber)};
+        cluster.hosts_.emplace_back(std::move(host));
+    }
+    for (auto begin = cluster.hosts_.begin(), end = cluster.hosts_.end(); begin != end; ++begin) {
+        sharpen::IHost *host{begin->get()};
+        auto future{sharpen::Async([host]() { host->Run(); })};
+        cluster.process_.emplace_back(std::move(future));
+    }
+    auto primary{cluster.rafts_[0].get()};
+    primary->Advance();
+    primary->WaitNextConsensus();
+    return primary;
+}
+
+static void StopCluster(RaftCluster &cluster) {
+    for (auto begin = cluster.rafts_.begin(), end = cluster.rafts_.end(); begin != end; ++begin) {
+        auto raft{begin->get()};
+        raft->ReleasePeers();
+    }
+    for (auto begin = cluster.hosts_.begin(), end = cluster.hosts_.end(); begin != end; ++begin) {
+        auto host{begin->get()};
+        host->Stop();
+    }
+    for (auto begin = cluster.process_.begin(), end = cluster.process_.end(); begin != end;
+         ++begin) {
+        auto future{begin->get()};
+        future->WaitAsync();
+    }
+    cluster.rafts_.clear();
+    for (std::uint16_t i = beginPort; i != endPort + 1; ++i) {
+        RemoveLogStorage(i);
+        RemoveStatusMap(i);
+    }
+}
+
+// committed entries per second of a 3-node cluster on loopback
+static simplebench::BenchResult MeasureCommit(
+    std::shared_ptr<sharpen::IConsensus> (*createRaft)(std::uint16_t),
+    std::chrono::seconds duration) {
+    RaftCluster cluster;
+    auto primary{StartCluster(cluster, createRaft)};
+    std::uint64_t beginIndex{primary->GetCommitIndex()};
+    sharpen::Future<bool> timerFuture;
+    sharpen::TimerPtr timer{sharpen::MakeTimer()};
+    simplebench::Stopwatch watch;
+    timer->WaitAsync(timerFuture, duration);
+    std::vector<sharpen::AwaitableFuturePtr<void>> clients;
+    clients.reserve(clientCount);
+    std::size_t rounds{0};
+    for (std::size_t i = 0; i != clientCount; ++i) {
+        clients.emplace_back(sharpen::Async([&timerFuture, primary]() {
+            while (timerFuture.IsPending()) {
+                sharpen::LogBatch batch;
+                sharpen::ByteBuffer log{entrySize};
+                batch.Append(std::move(log));
+                primary->Write(batch);
+            }
+        }));
+    }
+    auto advancer{sharpen::Async([&timerFuture, primary, &rounds]() {
+        while (timerFuture.IsPending()) {
+            primary->Advance();
+            primary->WaitNextConsensus();
+            rounds += 1;
+        }
+    })};
+    for (auto begin = clients.begin(), end = clients.end(); begin != end; ++begin) {
+        begin->get()->Await();
+    }
+    advancer->Await();
+    double seconds{watch.GetSeconds()};
+    std::size_t committed{static_cast<std::size_t>(primary->GetCommitIndex() - beginIndex)};
+    StopCluster(cluster);
+    if (!committed) {
+        return simplebench::BenchResult{"no entry was committed"};
+    }
+    simplebench::BenchResult result{committed, seconds};
+    result.AddMetric("rounds", static_cast<double>(rounds));
+    if (rounds) {
+        result.AddMetric("entries_per_round",
+                         static_cast<double>(committed) / static_cast<double>(rounds));
+    }
+    result.AddMetric("mb_per_sec",
+                     static_cast<double>(committed * entrySize) / seconds / (1024 * 1024));
+    return result;
+}
+
+// a read pushes a no-op entry and waits until it was applied
+static bool WriteBasedRead(sharpen::IConsensus *primary, const sharpen::Future<bool> &timerFuture) {
+    sharpen::LogBatch batch;
+    sharpen::ByteBuffer log{1};
+    batch.Append(std::move(log));
+    sharpen::WriteLogsResult written{primary->Write(batch)};
+    if (!written.GetStatus()) {
+        return false;
+    }
+    while (primary->GetLastAppliedIndex() < written.GetLastIndex()) {
+        if (!timerFuture.IsPending()) {
+            return false;
+        }
+        sharpen::YieldCycle();
+    }
+    return true;
+}
+
+static bool IndexBasedRead(sharpen::IConsensus *primary, const sharpen::Future<bool> &timerFuture) {
+    (void)timerFuture;
+    return primary->ReadIndex().Exist();
+}
+
+// linearizable reads per second of a 3-node cluster on loopback
+static simplebench::BenchResult MeasureRead(
+    std::shared_ptr<sharpen::IConsensus> (*createRaft)(std::uint16_t),
+    bool (*read)(sharpen::IConsensus *, const sharpen::Future<bool> &),
+    std::chrono::seconds duration) {
+    RaftCluster cluster;
+    auto primary{StartCluster(cluster, createRaft)};
+    sharpen::Future<bool> timerFuture;
+    sharpen::TimerPtr timer{sharpen::MakeTimer()};
+    simplebench::Stopwatch watch;
+    timer->WaitAsync(timerFuture, duration);
+    std::vector<sharpen::AwaitableFuturePtr<std::size_t>> clients;
+    clients.reserve(clientCount);
+    std::size_t rounds{0};
+    for (std::size_t i = 0; i != clientCount; ++i) {
+        clients.emplace_back(sharpen::Async([&timerFuture, primary, read]() {
+            std::size_t reads{0};
+            while (timerFuture.IsPending() && read(primary, timerFuture)) {
+                reads += 1;
+            }
+            return reads;
+        }));
+    }
+    // the application applies every committed entry
+    auto advancer{sharpen::Async([&timerFuture, primary, &rounds]() {
+        while (timerFuture.IsPending()) {
+            primary->Advance();
+            primary->WaitNextConsensus();
+            primary->StoreLastAppliedIndex(primary->GetCommitIndex());
+            rounds += 1;
+        }
+    })};
+    std::size_t reads{0};
+    for (auto begin = clients.begin(), end = clients.end(); begin != end; ++begin) {
+        reads += begin->get()->Await();
+    }
+    advancer->Await();
+    double seconds{watch.GetSeconds()};
+    StopCluster(cluster);
+    if (!reads) {
+        return simplebench::BenchResult{"no read was completed"};
+    }
+    simplebench::BenchResult result{reads, seconds};
+    result.AddMetric("rounds", static_cast<double>(rounds));
+    return result;
+}
+
+static std::shared_ptr<sharpen::IConsensus> CreateSnapshotRaft(std::uint16_t port) {
+    std::unique_ptr<sharpen::FileRaftSnapshotController> ctrl{
+        new (std::nothrow) sharpen::FileRaftSnapshotController{
+            sharpen::GetLocalLoopGroup(), GetSnapshotName(snapshotName, port)}};
+    if (!ctrl) {
+        throw std::bad_alloc{};
+    }
+    // the leader has compacted its logs into a snapshot of snapshotSize bytes
+    if (port == beginPort) {
+        CommitSnapshot(*ctrl, GenerateData(snapshotSize));
+    }
+    sharpen::RaftOption raftOpt;
+    raftOpt.SetLearner(false);
+    raftOpt.SetPrevote(false);
+    raftOpt.SetPipelineLength(snapshotPipelineLength);
+    auto raft{CreateRaft(port, magicNumber, std::move(ctrl), nullptr, raftOpt, true)};
+    raft->ConfiguratePeers(
+        &ConfigPeers, port, beginPort, endPort, &raft->GetReceiver(), magicNumber, true);
+    return raft;
+}
+
+// snapshot bytes installed per second by the followers of a 3-node cluster on loopback
+static simplebench::BenchResult MeasureSnapshotTransfer(std::chrono::seconds duration) {
+    for (std::uint16_t i = beginPort; i != endPort + 1; ++i) {
+        RemoveSnapshot(snapshotName, i);
+    }
+    RaftCluster cluster;
+    auto primary{StartCluster(cluster, &CreateSnapshotRaft)};
+    sharpen::Future<bool> timerFuture;
+    sharpen::TimerPtr timer{sharpen::MakeTimer()};
+    simplebench::Stopwatch watch;
+    timer->WaitAsync(timerFuture, duration);
+    // chunks are streamed between rounds
+    // a round could not be confirmed while the pipelines of followers are full
+    std::size_t rounds{0};
+    bool installed{false};
+    while (!installed && timerFuture.IsPending()) {
+        primary->Advance();
+        sharpen::Delay(std::chrono::milliseconds{10});
+        rounds += 1;
+        installed = true;
+        for (auto begin = cluster.rafts_.begin() + 1, end = cluster.rafts_.end(); begin != end;
+             ++begin) {
+            if ((*begin)->GetCommitIndex() < snapshotIndex) {
+                installed = false;
+            }
+        }
+    }
+    double seconds{watch.GetSeconds()};
+    std::size_t followers{cluster.rafts_.size() - 1};
+    timer->Cancel();
+    StopCluster(cluster);
+    for (std::uint16_t i = beginPort; i != endPort + 1; ++i) {
+        RemoveSnapshot(snapshotName, i);
+    }
+    if (!installed) {
+        return simplebench::BenchResult{"snapshot was not installed"};
+    }
+    simplebench::BenchResult result{followers, seconds};
+    result.AddMetric("rounds", static_cast<double>(rounds));
+    result.AddMetric("mb_per_sec",
+                     static_cast<double>(followers * snapshotSize) / seconds / (1024 * 1024));
+    return result;
+}
+
+class BasicCommitBench : public simplebench::ITypenamedBench<BasicCommitBench> {
+private:
+    using Self = BasicCommitBench;
+
+    std::chrono::seconds duration_;
+
+public:
+    explicit BasicCommitBench(std::chrono::seconds duration) noexcept
+        : duration_(duration) {
+    }
+
+    ~BasicCommitBench() noexcept = default;
+
+    inline const Self &Const() const noexcept {
+        return *this;
+    }
+
+    inline virtual simplebench::BenchResult Run() noexcept {
+        try {
+            return MeasureCommit(&CreateBasicRaft, this->duration_);
+        } catch (const std::exception &error) {
+            return this->Fail(error.what());
+        }
+    }
+};
+
+class PipelinedReplicationCommitBench
+    : public simplebench::ITypenamedBench<PipelinedReplicationCommitBench> {
+private:
+    using Self = PipelinedReplicationCommitBench;
+
+    std::chrono::seconds duration_;
+
+public:
+    explicit PipelinedReplicationCommitBench(std::chrono::seconds duration) noexcept
+        : duration_(duration) {
+    }
+
+    ~PipelinedReplicationCommitBench() noexcept = default;
+
+    inline const Self &Const() const noexcept {
+        return *this;
+    }
+
+    inline virtual simplebench::BenchResult Run() noexcept {
+        try {
+            return MeasureCommit(&CreatePipelinedReplicationRaft, this->duration_);
+        } catch (const std::exception &error) {
+            return this->Fail(error.what());
+        }
+    }
+};
+
+class WriteBasedReadBench : public simplebench::ITypenamedBench<WriteBasedReadBench> {
+private:
+    using Self = WriteBasedReadBench;
+
+    std::chrono::seconds duration_;
+
+public:
+    explicit WriteBasedReadBench(std::chrono::seconds duration) noexcept
+        : duration_(duration) {
+    }
+
+    ~WriteBasedReadBench() noexcept = default;
+
+    inline const Self &Const() const noexcept {
+        return *this;
+    }
+
+    inline virtual simplebench::BenchResult Run() noexcept {
+        try {
+            return MeasureRead(&CreateBasicRaft, &WriteBasedRead, this->duration_);
+        } catch (const std::exception &error) {
+            return this->Fail(error.what());
+        }
+    }
+};
+
+class ReadIndexBench : public simplebench::ITypenamedBench<ReadIndexBench> {
+private:
+    using Self = ReadIndexBench;
+
+    std::chrono::seconds duration_;
+
+public:
+    explicit ReadIndexBench(std::chrono::seconds duration) noexcept
+        : duration_(duration) {
+    }
+
+    ~ReadIndexBench() noexcept = default;
+
+    inline const Self &Const() const noexcept {
+        return *this;
+    }
+
+    inline virtual simplebench::BenchResult Run() noexcept {
+        try {
+            return MeasureRead(&CreateBasicRaft, &IndexBasedRead, this->duration_);
+        } catch (const std::exception &error) {
+            return this->Fail(error.what());
+        }
+    }
+};
+
+class LeaseReadBench : public simplebench::ITypenamedBench<LeaseReadBench> {
+private:
+    using Self = LeaseReadBench;
+
+    std::chrono::seconds duration_;
+
+public:
+    explicit LeaseReadBench(std::chrono::seconds duration) noexcept
+        : duration_(duration) {
+    }
+
+    ~LeaseReadBench() noexcept = default;
+
+    inline const Self &Const() const noexcept {
+        return *this;
+    }
+
+    inline virtual simplebench::BenchResult Run() noexcept {
+        try {
+            return MeasureRead(&CreateReadLeaseRaft, &IndexBasedRead, this->duration_);
+        } catch (const std::exception &error) {
+            return this->Fail(error.what());
+        }
+    }
+};
+
+class SnapshotTransferBench : public simplebench::ITypenamedBench<SnapshotTransferBench> {
+private:
+    using Self = SnapshotTransferBench;
+
+    std::chrono::seconds duration_;
+
+public:
+    explicit SnapshotTransferBench(std::chrono::seconds duration) noexcept
+        : duration_(duration) {
+    }
+
+    ~SnapshotTransferBench() noexcept = default;
+
+    inline const Self &Const() const noexcept {
+        return *this;
+    }
+
+    // the duration bounds the transfer
+    inline virtual simplebench::BenchResult Run() noexcept {
+        try {
+            return MeasureSnapshotTransfer(this->duration_);
+        } catch (const std::exception &error) {
+            return this->Fail(error.what());
+        }
+    }
+};
+
+// --seconds=N selects how long each run writes
+static int Entry(int argc, char const *argv[]) {
+    sharpen::StartupNetSupport();
+    std::chrono::seconds duration{simplebench::GetOption(argc, argv, "seconds", 3)};
+    simplebench::BenchRunner runner{"RaftBench", argc, argv};
+    runner.AddContext("entry_size", std::to_string(entrySize));
+    runner.AddContext("clients", std::to_string(clientCount));
+    runner.Register<BasicCommitBench>(duration);
+    runner.Register<PipelinedReplicationCommitBench>(duration);
+    runner.Register<WriteBasedReadBench>(duration);
+    runner.Register<ReadIndexBench>(duration);
+    runner.Register<LeaseReadBench>(duration);
+    runner.Register<SnapshotTransferBench>(duration);
+    return runner.Run();
+}
+
+// --threads=N selects the number of event loops
+int main(int argc, char const *argv[]) {
+    std::size_t threads{
+        simplebench::GetOption(argc, argv, "threads", std::thread::hardware_concurrency())};
+    if (!threads) {
+        threads = 1;
+    }
+    sharpen::EventEngine &engine{sharpen::EventEngine::SetupEngine(threads)};
+    return engine.StartupWithCode(&Entry, argc, argv);
+}
@@ -0,0 +1,448 @@
+#include <sharpen/AsyncOps.hpp>
+#include <sharpen/AwaitableFuture.hpp>
+#include <sharpen/BufferOps.hpp>
+#include <sharpen/Directory.hpp>
+#include <sharpen/EventEngine.hpp>
+#include <sharpen/FileOps.hpp>
+#include <sharpen/IFileChannel.hpp>
+#include <sharpen/SegmentLogStorage.hpp>
+#include <sharpen/WalLogStorage.hpp>
+#include <simplebench/BenchRunner.hpp>
+#include <thread>
+#include <vector>
+
+static const char *walName = "./benchWalLog";
+
+static const char *segmentDirName = "./benchSegmentLog";
+
+static const char *fileName = "./benchFile";
+
+static constexpr std::size_t entrySize{128};
+
+static constexpr std::size_t appendCount{2000};
+
+static constexpr std::size_t writerCount{64};
+
+static constexpr std::size_t writerAppendCount{32};
+
+static constexpr std::size_t reopenCount{20 * 1000};
+
+static constexpr std::size_t segmentSize{1024 * 1024};
+
+static constexpr std::size_t blockSize{4096};
+
+static constexpr std::size_t blockCount{10 * 1000};
+
+static constexpr std::size_t checksumBufferSize{64 * 1024 * 1024};
+
+static sharpen::ByteBuffer MakeEntry() {
+    sharpen::ByteBuffer entry{entrySize};
+    for (std::size_t i = 0; i != entry.GetSize(); ++i) {
+        entry[i] = static_cast<char>(i);
+    }
+    return entry;
+}
+
+static sharpen::ILogStorage *OpenWal() {
+    sharpen::ILogStorage *log{new (std::nothrow) sharpen::WalLogStorage{walName}};
+    if (!log) {
+        throw std::bad_alloc{};
+    }
+    return log;
+}
+
+static void RemoveWal() {
+    if (sharpen::ExistFile(walName)) {
+        sharpen::RemoveFile(walName);
+    }
+}
+
+static sharpen::ILogStorage *OpenSegment() {
+    sharpen::ILogStorage *log{new (std::nothrow) sharpen::SegmentLogStorage{
+        sharpen::GetLocalLoopGroup(), segmentDirName, segmentSize}};
+    if (!log) {
+        throw std::bad_alloc{};
+    }
+    return log;
+}
+
+static void RemoveSegment() {
+    if (sharpen::ExistDirectory(segmentDirName)) {
+        sharpen::Directory dir{segmentDirName};
+        dir.RemoveAll();
+    }
+}
+
+static void RemoveBenchFile() {
+    if (sharpen::ExistFile(fileName)) {
+        sharpen::RemoveFile(fileName);
+    }
+}
+
+// one durable write per entry
+static simplebench::BenchResult MeasureAppend(sharpen::ILogStorage *(*open)(),
+                                              void (*remove)()) {
+    try {
+        remove();
+        std::unique_ptr<sharpen::ILogStorage> log{open()};
+        sharpen::ByteBuffer entry{MakeEntry()};
+        simplebench::Stopwatch watch;
+        for (std::size_t i = 0; i != appendCount; ++i) {
+            log->Write(i + 1, entry);
+        }
+        double seconds{watch.GetSeconds()};
+        log.reset();
+        remove();
+        simplebench::BenchResult result{appendCount, seconds};
+        result.AddMetric("mb_per_sec",
+                         static_cast<double>(appendCount * entrySize) / seconds / (1024 * 1024));
+        return result;
+    } catch (const std::exception &error) {
+        remove();
+        return simplebench::BenchResult{error.what()};
+    }
+}
+
+// time to open a log that already holds many entries
+static simplebench::BenchResult MeasureReopen(sharpen::ILogStorage *(*open)(), void (*remove)()) {
+    try {
+        remove();
+        std::unique_ptr<sharpen::ILogStorage> log{open()};
+        sharpen::ByteBuffer entry{MakeEntry()};
+        sharpen::LogEntries entries;
+        for (std::size_t i = 0; i != reopenCount; ++i) {
+            entries.Push(entry);
+        }
+        log->WriteBatch(1, std::move(entries));
+        log.reset();
+        simplebench::Stopwatch watch;
+        log.reset(open());
+        std::uint64_t lastIndex{log->GetLastIndex()};
+        double seconds{watch.GetSeconds()};
+        log.reset();
+        remove();
+        if (lastIndex != reopenCount) {
+            return simplebench::BenchResult{"lost entries after reopen"};
+        }
+        return simplebench::BenchResult{reopenCount, seconds};
+    } catch (const std::exception &error) {
+        remove();
+        return simplebench::BenchResult{error.what()};
+    }
+}
+
+class WalAppendBench : public simplebench::ITypenamedBench<WalAppendBench> {
+private:
+    using Self = WalAppendBench;
+
+public:
+    WalAppendBench() noexcept = default;
+
+    ~WalAppendBench() noexcept = default;
+
+    inline const Self &Const() const noexcept {
+        return *this;
+    }
+
+    inline virtual simplebench::BenchResult Run() noexcept {
+        return MeasureAppend(&OpenWal, &RemoveWal);
+    }
+};
+
+class SegmentAppendBench : public simplebench::ITypenamedBench<SegmentAppendBench> {
+private:
+    using Self = SegmentAppendBench;
+
+public:
+    SegmentAppendBench() noexcept = default;
+
+    ~SegmentAppendBench() noexcept = default;
+
+    inline const Self &Const() const noexcept {
+        return *this;
+    }
+
+    inline virtual simplebench::BenchResult Run() noexcept {
+        return MeasureAppend(&OpenSegment, &RemoveSegment);
+    }
+};
+
+class WalReopenBench : public simplebench::ITypenamedBench<WalReopenBench> {
+private:
+    using Self = WalReopenBench;
+
+public:
+    WalReopenBench() noexcept = default;
+
+    ~WalReopenBench() noexcept = default;
+
+    inline const Self &Const() const noexcept {
+        return *this;
+    }
+
+    inline virtual simplebench::BenchResult Run() noexcept {
+        return MeasureReopen(&OpenWal, &RemoveWal);
+    }
+};
+
+class SegmentReopenBench : public simplebench::ITypenamedBench<SegmentReopenBench> {
+private:
+    using Self = SegmentReopenBench;
+
+public:
+    SegmentReopenBench() noexcept = default;
+
+    ~SegmentReopenBench() noexcept = default;
+
+    inline const Self &Const() const noexcept {
+        return *this;
+    }
+
+    inline virtual simplebench::BenchResult Run() noexcept {
+        return MeasureReopen(&OpenSegment, &RemoveSegment);
+    }
+};
+
+// concurrent writers share fdatasync() calls
+class WalGroupCommitBench : public simplebench::ITypenamedBench<WalGroupCommitBench> {
+private:
+    using Self = WalGroupCommitBench;
+
+    static void Append(sharpen::WalLogStorage *log, std::size_t writer) {
+        sharpen::ByteBuffer entry{MakeEntry()};
+        for (std::size_t i = 0; i != writerAppendCount; ++i) {
+            // writers never overlap each other
+            log->Write(i * writerCount + writer + 1, entry);
+        }
+    }
+
+public:
+    WalGroupCommitBench() noexcept = default;
+
+    ~WalGroupCommitBench() noexcept = default;
+
+    inline const Self &Const() const noexcept {
+        return *this;
+    }
+
+    inline virtual simplebench::BenchResult Run() noexcept {
+        try {
+            RemoveWal();
+            std::unique_ptr<sharpen::WalLogStorage> log{new (std::nothrow)
+                                                            sharpen::WalLogStorage{walName}};
+            if (!log) {
+                return this->Fail("failed to alloc memory");
+            }
+            log->SetGroupCommit(1024 * 1024, std::chrono::milliseconds{1});
+            std::vector<sharpen::AwaitableFuturePtr<void>> writers;
+            writers.reserve(writerCount);
+            simplebench::Stopwatch watch;
+            for (std::size_t i = 0; i != writerCount; ++i) {
+                writers.emplace_back(sharpen::Async(&Self::Append, log.get(), i));
+            }
+            for (auto begin = writers.begin(), end = writers.end(); begin != end; ++begin) {
+                (*begin)->Await();
+            }
+            double seconds{watch.GetSeconds()};
+            double syncs{static_cast<double>(log->GetSyncCount())};
+            log.reset();
+            RemoveWal();
+            std::size_t count{writerCount * writerAppendCount};
+            simplebench::BenchResult result{this->Done(count, seconds)};
+            result.AddMetric("fsyncs_per_sec", syncs / seconds);
+            if (syncs > 0) {
+                result.AddMetric("entries_per_fsync", static_cast<double>(count) / syncs);
+            }
+            return result;
+        } catch (const std::exception &error) {
+            RemoveWal();
+            return this->Fail(error.what());
+        }
+    }
+};
+
+static simplebench::BenchResult MeasureFileWrite(bool registered) {
+    try {
+        RemoveBenchFile();
+        sharpen::FileChannelPtr channel{sharpen::OpenFileChannel(
+            fileName, sharpen::FileAccessMethod::All, sharpen::FileOpenMethod::CreateNew)};
+        channel->Register(sharpen::GetLocalLoopGroup());
+        bool enabled{false};
+        if (registered) {
+            enabled = channel->EnableRegisteredIo();
+        }
+        std::vector<char> block(blockSize, 'x');
+        simplebench::Stopwatch watch;
+        for (std::size_t i = 0; i != blockCount; ++i) {
+            channel->WriteAsync(block.data(), block.size(), i * blockSize);
+        }
+        double seconds{watch.GetSeconds()};
+        channel->Close();
+        RemoveBenchFile();
+        simplebench::BenchResult result{blockCount, seconds};
+        result.AddMetric("mb_per_sec",
+                         static_cast<double>(blockCount * blockSize) / seconds / (1024 * 1024));
+        result.AddMetric("registered", enabled ? 1 : 0);
+        return result;
+    } catch (const std::exception &error) {
+        RemoveBenchFile();
+        return simplebench::BenchResult{error.what()};
+    }
+}
+
+class FileWriteBench : public simplebench::ITypenamedBench<FileWriteBench> {
+private:
+    using Self = FileWriteBench;
+
+public:
+    FileWriteBench() noexcept = default;
+
+    ~FileWriteBench() noexcept = default;
+
+    inline const Self &Const() const noexcept {
+        return *this;
+    }
+
+    inline virtual simplebench::BenchResult Run() noexcept {
+        return MeasureFileWrite(false);
+    }
+};
+
+// falls back to normal io if io_uring is not available
+class RegisteredFileWriteBench : public simplebench::ITypenamedBench<RegisteredFileWriteBench> {
+private:
+    using Self = RegisteredFileWriteBench;
+
+public:
+    RegisteredFileWriteBench() noexcept = default;
+
+    ~RegisteredFileWriteBench() noexcept = default;
+
+    inline const Self &Const() const noexcept {
+        return *this;
+    }
+
+    inline virtual simplebench::BenchResult Run() noexcept {
+        return MeasureFileWrite(true);
+    }
+};
+
+// keeps the checksum loops from being optimized away
+static volatile std::uint32_t checksumSink{0};
+
+// checksum a large buffer in 64KB blocks
+template<std::uint32_t (*_Checksum)(const char *, std::size_t) noexcept>
+static simplebench::BenchResult MeasureChecksum(const std::vector<char> &buffer) {
+    constexpr std::size_t checksumBlockSize{64 * 1024};
+    std::uint32_t sum{0};
+    simplebench::Stopwatch watch;
+    for (std::size_t i = 0; i != buffer.size() / checksumBlockSize; ++i) {
+        sum ^= _Checksum(buffer.data() + i * checksumBlockSize, checksumBlockSize);
+    }
+    double seconds{watch.GetSeconds()};
+    simplebench::BenchResult result{buffer.size() / checksumBlockSize, seconds};
+    result.AddMetric("gb_per_sec",
+                     static_cast<double>(buffer.size()) / seconds / (1024 * 1024 * 1024));
+    checksumSink = sum;
+    return result;
+}
+
+static std::vector<char> MakeChecksumBuffer() {
+    std::vector<char> buffer(checksumBufferSize);
+    for (std::size_t i = 0; i != buffer.size(); ++i) {
+        buffer[i] = static_cast<char>(i * 131 + (i >> 8));
+    }
+    return buffer;
+}
+
+class Crc32Bench : public simplebench::ITypenamedBench<Crc32Bench> {
+private:
+    using Self = Crc32Bench;
+
+    std::vector<char> buffer_;
+
+public:
+    Crc32Bench()
+        : buffer_(MakeChecksumBuffer()) {
+    }
+
+    ~Crc32Bench() noexcept = default;
+
+    inline const Self &Const() const noexcept {
+        return *this;
+    }
+
+    inline virtual simplebench::BenchResult Run() noexcept {
+        return MeasureChecksum<&sharpen::Crc32>(this->buffer_);
+    }
+};
+
+class Crc32cBench : public simplebench::ITypenamedBench<Crc32cBench> {
+private:
+    using Self = Crc32cBench;
+
+    std::vector<char> buffer_;
+
+public:
+    Crc32cBench()
+        : buffer_(MakeChecksumBuffer()) {
+    }
+
+    ~Crc32cBench() noexcept = default;
+
+    inline const Self &Const() const noexcept {
+        return *this;
+    }
+
+    inline virtual simplebench::BenchResult Run() noexcept {
+        return MeasureChecksum<&sharpen::Crc32c>(this->buffer_);
+    }
+};
+
+class Adler32Bench : public simplebench::ITypenamedBench<Adler32Bench> {
+private:
+    using Self = Adler32Bench;
+
+    std::vector<char> buffer_;
+
+public:
+    Adler32Bench()
+        : buffer_(MakeChecksumBuffer()) {
+    }
+
+    ~Adler32Bench() noexcept = default;
+
+    inline const Self &Const() const noexcept {
+        return *this;
+    }
+
+    inline virtual simplebench::BenchResult Run() noexcept {
+        return MeasureChecksum<&sharpen::Adler32>(this->buffer_);
+    }
+};
+
+static int Entry(int argc, char const *argv[]) {
+    simplebench::BenchRunner runner{"StorageBench", argc, argv};
+    runner.Register<WalAppendBench>();
+    runner.Register<SegmentAppendBench>();
+    runner.Register<WalGroupCommitBench>();
+    runner.Register<WalReopenBench>();
+    runner.Register<SegmentReopenBench>();
+    runner.Register<FileWriteBench>();
+    runner.Register<RegisteredFileWriteBench>();
+    runner.Register<Crc32Bench>();
+    runner.Register<Crc32cBench>();
+    runner.Register<Adler32Bench>();
+    return runner.Run();
+}
+
+// --threads=N selects the number of event loops
+int main(int argc, char const *argv[]) {
+    std::size_t threads{
+        simplebench::GetOption(argc, argv, "threads", std::thread::hardware_concurrency())};
+    if (!threads) {
+        threads = 1;
+    }
+    sharpen::EventEngine &engine{sharpen::EventEngine::SetupEngine(threads)};
+    return engine.StartupWithCode(&Entry, argc, argv);
+}
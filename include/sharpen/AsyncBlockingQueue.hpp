@@ -3,7 +3,9 @@
 #define _SHARPEN_ASYNCBLOCKINGQUEUE_HPP
 
 #include "AsyncSemaphore.hpp"
+#include "SpinLock.hpp"
 #include <deque>
+#include <mutex>
 
 namespace sharpen {
     template<typename _T>
@@ -6,8 +6,10 @@
 #include "ITimer.hpp"
 #include "Noncopyable.hpp"
 #include "Nonmovable.hpp"
+#include "SpinLock.hpp"
 #include <cassert>
 #include <chrono>
+#include <mutex>
 #include <utility>
 #include <vector>
 
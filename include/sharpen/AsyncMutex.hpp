@@ -4,6 +4,8 @@
 
 #include "AwaitableFuture.hpp"
 #include "IAsyncLockable.hpp"
+#include "SpinLock.hpp"
+#include <mutex>
 #include <vector>
 
 namespace sharpen {
@@ -29,6 +29,20 @@ namespace sharpen {
         scheduler->LaunchSpecial(stackSize, std::forward<_Fn>(fn), std::forward<_Args>(args)...);
     }
 
+    template<typename _Fn,
+             typename... _Args,
+             typename _Check = sharpen::EnableIf<
+                 sharpen::IsCompletedBindableReturned<void, _Fn, _Args...>::Value>>
+    inline void LaunchWithStack(sharpen::StackAllocMethod method,
+                                std::size_t stackSize,
+                                _Fn &&fn,
+                                _Args &&...args) {
+        sharpen::IFiberScheduler *scheduler{sharpen::GetLocalSchedulerPtr()};
+        assert(scheduler != nullptr);
+        scheduler->LaunchWithStack(
+            method, stackSize, std::forward<_Fn>(fn), std::forward<_Args>(args)...);
+    }
+
     template<typename _Fn,
              typename... _Args,
              typename _Result = decltype(std::declval<_Fn>()(std::declval<_Args>()...))>
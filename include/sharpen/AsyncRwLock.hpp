@@ -3,6 +3,7 @@
 #define _SHARPEN_ASYNCREADWRITELOCK_HPP
 
 #include "AwaitableFuture.hpp"
+#include "SpinLock.hpp"
 #include <mutex>
 #include <vector>
 
@@ -4,8 +4,10 @@
 
 #include "AwaitableFuture.hpp"
 #include "IAsyncLockable.hpp"
+#include "SpinLock.hpp"
 #include <cstddef>
 #include <cstdint>
+#include <mutex>
 #include <vector>
 
 namespace sharpen {
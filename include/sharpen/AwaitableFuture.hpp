@@ -22,16 +22,21 @@ namespace sharpen {
             scheduler->Schedule(std::move(fiber));
         }
 
+        // small enough to be stored in std::function without allocation
+        struct NotifyCallback {
+            Self *future_;
+
+            inline void operator()() noexcept {
+                this->future_->NotifyIfCompleted();
+            }
+        };
+
         void NotifyIfCompleted() noexcept {
-            sharpen::FiberPtr fiber{nullptr};
-            {
-                std::unique_lock<sharpen::SpinLock> lock(this->GetCompleteLock());
-                if (this->IsPending()) {
-                    this->awaiter_ = std::move(this->pendingFiber_);
-                    return;
-                }
-                fiber = std::move(this->pendingFiber_);
+            this->awaiter_ = std::move(this->pendingFiber_);
+            if (this->AddWaiter(sharpen::FutureAwaiterFlag)) {
+                return;
             }
+            sharpen::FiberPtr fiber{std::move(this->awaiter_)};
             this->ScheduleFiber(std::move(fiber));
         }
 
@@ -63,17 +68,9 @@ namespace sharpen {
                 this->Wait();
             } else {
                 // this thread is a processer
-                bool pending{false};
-                {
-                    std::unique_lock<sharpen::SpinLock> lock{this->GetCompleteLock()};
-                    pending = this->IsPending();
-                    if (pending) {
-                        this->pendingFiber_ = std::move(current);
-                    }
-                }
-                if (pending) {
-                    scheduler->SetSwitchCallback(
-                        std::bind(&sharpen::AwaitableFuture<_Result>::NotifyIfCompleted, this));
+                if (this->IsPending()) {
+                    this->pendingFiber_ = std::move(current);
+                    scheduler->SetSwitchCallback(NotifyCallback{this});
                     scheduler->SwitchToProcesserFiber();
                 }
             }
@@ -86,15 +83,13 @@ namespace sharpen {
 
     protected:
         inline virtual void ExecuteCallback(sharpen::FutureState state) override {
-            typename MyBase::Callback cb;
+            sharpen::FutureStateWord waiters{this->SetState(state)};
             sharpen::FiberPtr fiber{nullptr};
-            {
-                std::unique_lock<sharpen::SpinLock> lock{this->GetCompleteLock()};
-                std::swap(cb, this->GetCallback());
-                std::swap(fiber, this->awaiter_);
-                this->SetState(state);
+            if (waiters & sharpen::FutureAwaiterFlag) {
+                fiber = std::move(this->awaiter_);
             }
-            if (cb) {
+            if (waiters & sharpen::FutureCallbackFlag) {
+                typename MyBase::Callback cb{std::move(this->GetCallback())};
                 cb(*this);
             }
             if (fiber) {
@@ -25,9 +25,16 @@ namespace sharpen {
         std::size_t pipelineLength_;
         std::vector<sharpen::Mail> sharedMails_;
         std::unordered_map<sharpen::ActorId, std::unique_ptr<sharpen::IRemoteActor>> actors_;
+        // rounds that an actor could be skipped because its pipeline is full
+        // 0 means cancel it immediately
+        std::size_t stallLimit_;
+        std::unordered_map<sharpen::ActorId, std::size_t> stalls_;
 
         sharpen::Mail *GetNextSharedMail() noexcept;
 
+        // return false if we should skip the actor in this round
+        bool CheckPipeline(const sharpen::ActorId &id, sharpen::IRemoteActor &actor) noexcept;
+
     public:
         template<
             typename _Iterator,
@@ -48,7 +55,9 @@ namespace sharpen {
             , index_(0)
             , pipelineLength_(pipeline)
             , sharedMails_()
-            , actors_() {
+            , actors_()
+            , stallLimit_(0)
+            , stalls_() {
             this->lock_.reset(new (std::nothrow) Lock{});
             if (!this->lock_) {
                 throw std::bad_alloc{};
@@ -81,8 +90,11 @@ namespace sharpen {
                 this->pipelineLength_ = other.pipelineLength_;
                 this->sharedMails_ = std::move(other.sharedMails_);
                 this->actors_ = std::move(other.actors_);
+                this->stallLimit_ = other.stallLimit_;
+                this->stalls_ = std::move(other.stalls_);
                 other.index_ = 0;
                 other.pipelineLength_ = 0;
+                other.stallLimit_ = 0;
             }
             return *this;
         }
@@ -93,12 +105,32 @@ namespace sharpen {
             return *this;
         }
 
+        // shared mails are reused after pipeline length rounds
+        // so actors with full pipeline are always canceled
         void Broadcast(sharpen::Mail mail);
 
+        // actors with full pipeline are skipped
+        // until they have been stalled more than stall limit rounds
         void Broadcast(const sharpen::IMailProvider &provider);
 
+        // post a mail to one actor
+        // return false if the actor does not exist
+        bool Post(const sharpen::ActorId &id, sharpen::Mail mail);
+
+        // return true if the pipeline of the actor is not full
+        bool Writable(const sharpen::ActorId &id) const noexcept;
+
         bool Completed() const noexcept;
 
+        // return true if the pipeline of any actor is full
+        bool Saturated() const noexcept;
+
+        inline std::size_t GetStallLimit() const noexcept {
+            return this->stallLimit_;
+        }
+
+        void SetStallLimit(std::size_t limit) noexcept;
+
         void Cancel() noexcept;
 
         void Close() noexcept;
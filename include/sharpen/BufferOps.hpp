@@ -20,6 +20,14 @@ namespace sharpen {
     // CRC32
     extern std::uint32_t Crc32(const char *data, std::size_t size) noexcept;
 
+    // CRC32C (Castagnoli)
+    // use the crc32 instruction if the cpu supports it
+    extern std::uint32_t Crc32c(const char *data, std::size_t size) noexcept;
+
+    // extend the CRC32C of the previous data
+    // Crc32c(Crc32c(a), b) == Crc32c(a + b)
+    extern std::uint32_t Crc32c(std::uint32_t crc, const char *data, std::size_t size) noexcept;
+
     // Adler32
     extern std::uint32_t Adler32(const char *data, std::size_t size) noexcept;
 
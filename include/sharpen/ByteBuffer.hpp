@@ -180,6 +180,10 @@ namespace sharpen {
             return sharpen::Crc32(this->Data(),this->GetSize());
         }
 
+        inline std::uint32_t Crc32c() const noexcept {
+            return sharpen::Crc32c(this->Data(), this->GetSize());
+        }
+
         inline sharpen::ByteBuffer Base64Encode() const {
             sharpen::ByteBuffer buf{sharpen::ComputeBase64EncodeSize(this->GetSize())};
             bool success =
@@ -133,6 +133,10 @@ namespace sharpen {
             return sharpen::Crc32(this->Data(),this->GetSize());
         }
 
+        inline std::uint32_t Crc32c() const noexcept {
+            return sharpen::Crc32c(this->Data(), this->GetSize());
+        }
+
         inline ConstIterator Begin() const noexcept {
             return ConstIterator{this->Data()};
         }
@@ -0,0 +1,190 @@
+#pragma once
+#ifndef _SHARPEN_DNSRESOLVER_HPP
+#define _SHARPEN_DNSRESOLVER_HPP
+
+#include "Dns.hpp"
+#include "IEventLoopGroup.hpp"
+#include "IpEndPoint.hpp"
+#include "Ipv6EndPoint.hpp"
+#include "Noncopyable.hpp"
+#include "Nonmovable.hpp"
+#include "SpinLock.hpp"
+#include "TimerPool.hpp"
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace sharpen {
+    // asynchronous stub resolver
+    // sends A/AAAA queries over udp from the calling fiber
+    // and caches answers (and negative answers) until their ttl expires
+    class DnsResolver
+        : public sharpen::Noncopyable
+        , public sharpen::Nonmovable {
+    private:
+        using Self = sharpen::DnsResolver;
+        using Clock = std::chrono::steady_clock;
+
+        struct Record {
+            sharpen::AddressFamily af_;
+            char addr_[sizeof(in6_addr)];
+        };
+
+        struct CacheEntry {
+            // 0 if the entry is positive
+            sharpen::ErrorCode error_;
+            std::vector<Record> records_;
+            std::string canonname_;
+            Clock::time_point deadline_;
+        };
+
+        struct CacheShard {
+            sharpen::SpinLock lock_;
+            std::map<std::string, CacheEntry> entries_;
+        };
+
+        static constexpr std::size_t shardCount_{16};
+        static constexpr std::size_t maxShardEntries_{1024};
+        static constexpr std::size_t maxMessageSize_{512};
+        static constexpr std::uint16_t typeA_{1};
+        static constexpr std::uint16_t typeAaaa_{28};
+        static constexpr std::uint16_t typeCname_{5};
+        static constexpr std::uint16_t typeSoa_{6};
+
+        sharpen::IEventLoopGroup *loopGroup_;
+        sharpen::TimerPool timerPool_;
+        sharpen::IpEndPoint nameserver_;
+        std::chrono::milliseconds timeout_;
+        std::size_t retryCount_;
+        std::chrono::seconds negativeTtl_;
+        std::chrono::seconds maxTtl_;
+        std::atomic<std::uint16_t> nextId_;
+        CacheShard shards_[shardCount_];
+
+        static std::string MakeKey(const char *name, std::uint16_t type);
+
+        CacheShard &GetShard(const std::string &key) noexcept;
+
+        bool LookupCache(const std::string &key, CacheEntry &entry);
+
+        void StoreCache(const std::string &key, CacheEntry entry);
+
+        static std::size_t BuildQuery(const char *name,
+                                      std::uint16_t id,
+                                      std::uint16_t type,
+                                      char *buf,
+                                      std::size_t size);
+
+        // return false if the message is not a reply to the query
+        bool ParseReply(const char *buf,
+                        std::size_t size,
+                        std::uint16_t id,
+                        std::uint16_t type,
+                        CacheEntry &entry) const;
+
+        CacheEntry Query(const char *name, std::uint16_t type);
+
+        CacheEntry Lookup(const char *name, std::uint16_t type);
+
+        static sharpen::DnsResolveResult ConvertRecordToResolveResult(
+            const Record &record, const std::string &canonname);
+
+        static bool TryParseLiteral(const char *name, Record &record) noexcept;
+
+    public:
+        DnsResolver(sharpen::IEventLoopGroup &loopGroup, const sharpen::IpEndPoint &nameserver);
+
+        ~DnsResolver() noexcept = default;
+
+        inline const Self &Const() const noexcept {
+            return *this;
+        }
+
+        // the time to wait for each attempt
+        inline void SetTimeout(std::chrono::milliseconds timeout) noexcept {
+            this->timeout_ = timeout;
+        }
+
+        // the number of attempts after the first one
+        inline void SetRetryCount(std::size_t retryCount) noexcept {
+            this->retryCount_ = retryCount;
+        }
+
+        // used when a negative answer carries no soa record
+        inline void SetNegativeTtl(std::chrono::seconds ttl) noexcept {
+            this->negativeTtl_ = ttl;
+        }
+
+        inline void SetMaxTtl(std::chrono::seconds ttl) noexcept {
+            this->maxTtl_ = ttl;
+        }
+
+        void ClearCache() noexcept;
+
+        std::size_t GetCacheSize() noexcept;
+
+        template<typename _InsertIterator,
+                 typename _Check = decltype(*std::declval<_InsertIterator &>()++ =
+                                                std::declval<sharpen::DnsResolveResult &&>())>
+        inline void ResolveName(const char *name,
+                                sharpen::AddressFamily af,
+                                _InsertIterator inserter) {
+            assert(name);
+            Record literal;
+            if (Self::TryParseLiteral(name, literal)) {
+                if (literal.af_ != af) {
+                    sharpen::ThrowSystemError(sharpen::ErrorNetdbNoData);
+                }
+                *inserter++ = Self::ConvertRecordToResolveResult(literal, std::string{});
+                return;
+            }
+            std::uint16_t type{typeAaaa_};
+            if (af == sharpen::AddressFamily::Ip) {
+                type = typeA_;
+            }
+            CacheEntry entry{this->Lookup(name, type)};
+            if (entry.error_) {
+                sharpen::ThrowSystemError(entry.error_);
+            }
+            for (auto begin = entry.records_.begin(), end = entry.records_.end(); begin != end;
+                 ++begin) {
+                *inserter++ = Self::ConvertRecordToResolveResult(*begin, entry.canonname_);
+            }
+        }
+
+        // resolve both ipv4 and ipv6 addresses
+        // fail only if neither of them exists
+        template<typename _InsertIterator,
+                 typename _Check = decltype(*std::declval<_InsertIterator &>()++ =
+                                                std::declval<sharpen::DnsResolveResult &&>())>
+        inline void ResolveName(const char *name, _InsertIterator inserter) {
+            assert(name);
+            Record literal;
+            if (Self::TryParseLiteral(name, literal)) {
+                *inserter++ = Self::ConvertRecordToResolveResult(literal, std::string{});
+                return;
+            }
+            CacheEntry ipv4{this->Lookup(name, typeA_)};
+            CacheEntry ipv6{this->Lookup(name, typeAaaa_)};
+            if (ipv4.error_ && ipv6.error_) {
+                // prefer the more specific error
+                sharpen::ThrowSystemError(ipv4.error_ == sharpen::ErrorNetdbNoData ? ipv6.error_
+                                                                                   : ipv4.error_);
+            }
+            for (auto begin = ipv4.records_.begin(), end = ipv4.records_.end(); begin != end;
+                 ++begin) {
+                *inserter++ = Self::ConvertRecordToResolveResult(*begin, ipv4.canonname_);
+            }
+            for (auto begin = ipv6.records_.begin(), end = ipv6.records_.end(); begin != end;
+                 ++begin) {
+                *inserter++ = Self::ConvertRecordToResolveResult(*begin, ipv6.canonname_);
+            }
+        }
+    };
+}   // namespace sharpen
+
+#endif
@@ -6,7 +6,9 @@
 #include "IFiberScheduler.hpp"
 #include "IWorkerGroup.hpp"
 #include "NoexceptInvoke.hpp"   // IWYU pragma: keep
+#include "SpinLock.hpp"
 #include <functional>
+#include <mutex>
 #include <vector>
 
 namespace sharpen {
@@ -8,17 +8,25 @@
 
 #include "IChannel.hpp"
 #include "IoEvent.hpp"
+#include <atomic>
+#include <cstdint>
 
 namespace sharpen {
     struct EpollEventStruct {
-        using WeakChannelPtr = std::weak_ptr<sharpen::IChannel>;
         using EpollEvent = ::epoll_event;
 
-        EpollEventStruct() = default;
+        EpollEventStruct() noexcept
+            : generation_(0)
+            , epollEvent_()
+            , ioEvent_()
+            , internalEventfd_(0) {
+        }
 
         ~EpollEventStruct() noexcept = default;
 
-        WeakChannelPtr channel_;
+        // bumped every time the handle is registered
+        // events of the previous owner are dropped
+        std::atomic<std::uint32_t> generation_;
 
         EpollEvent epollEvent_;
 
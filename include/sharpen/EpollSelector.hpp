@@ -12,11 +12,20 @@
 #include "ISelector.hpp"
 #include "IoUringQueue.hpp"
 #include "IoUringStruct.hpp"
+#include "NetTypeDef.hpp"
 #include "Nonmovable.hpp"
 #include "SpinLock.hpp"
-#include <map>
+#include <atomic>
+#include <memory>
 #include <vector>
 
+#ifdef SHARPEN_HAS_IOURING
+// depth of io_uring used by selectors
+#ifndef SHARPEN_IOURING_DEPTH
+#define SHARPEN_IOURING_DEPTH 64
+#endif
+#endif
+
 namespace sharpen {
     class EpollSelector
         : public sharpen::ISelector
@@ -24,34 +33,63 @@ namespace sharpen {
         , public sharpen::Nonmovable {
     private:
         using Event = sharpen::EpollEventStruct;
-        using Map = std::map<sharpen::FileHandle, Event>;
         using EventBuf = std::vector<sharpen::Epoll::Event>;
         using Self = sharpen::EpollSelector;
 
+        // events are stored in pages indexed by handle
+        // pages are never moved or freed before the selector
+        static constexpr std::size_t pageBits_{10};
+        static constexpr std::size_t pageSize_{static_cast<std::size_t>(1) << pageBits_};
+        // used if the hard limit of RLIMIT_NOFILE is unlimited
+        static constexpr std::size_t maxHandles_{static_cast<std::size_t>(1) << 24};
+
         static constexpr std::size_t minEventBufLength_{8};
-        static constexpr std::size_t maxEventBufLength_{512};
+        // shrink the buffer after it was mostly idle for these rounds
+        static constexpr std::size_t shrinkRounds_{64};
 #ifdef SHARPEN_HAS_IOURING
         static constexpr std::size_t minCqesLength_{8};
         static constexpr std::size_t maxCqesLength_{512};
 #endif
         sharpen::Epoll epoll_;
         sharpen::EventFd eventfd_;
-        Map map_;
+        std::unique_ptr<std::atomic<Event *>[]> pages_;
+        std::size_t pageCount_;
+        // the max handle + 1 that has been registered
+        std::atomic_size_t handleBound_;
         EventBuf eventBuf_;
+        std::size_t idleRounds_;
         sharpen::SpinLock lock_;
 #ifdef SHARPEN_HAS_IOURING
         std::unique_ptr<sharpen::IoUringQueue> ring_;
         std::vector<struct io_uring_cqe> cqes_;
 #endif
+        sharpen::NetIoMethod netIoMethod_;
 
         static bool CheckChannel(sharpen::ChannelPtr channel) noexcept;
 
+        static std::size_t GetMaxHandles() noexcept;
+
+        // return nullptr if the page of handle doesn't exist
+        Event *FindEvent(sharpen::FileHandle handle) const noexcept;
+
+        // must be called with lock_
+        Event &GetEvent(sharpen::FileHandle handle);
+
+        void ResizeEventBuf(std::size_t count);
+
         void RegisterInternalEventFd(int fd, char internalVal);
 
     public:
         EpollSelector();
 
-        ~EpollSelector() noexcept = default;
+        explicit EpollSelector(sharpen::NetIoMethod netIoMethod);
+
+        // ringDepth and sqPoll are ignored if io_uring is not supported
+        EpollSelector(std::uint32_t ringDepth, bool sqPoll);
+
+        EpollSelector(std::uint32_t ringDepth, bool sqPoll, sharpen::NetIoMethod netIoMethod);
+
+        ~EpollSelector() noexcept;
 
         virtual void Select(EventVector &events) override;
 
@@ -62,6 +100,11 @@ namespace sharpen {
 #ifdef SHARPEN_HAS_IOURING
         sharpen::IoUringQueue *GetIoUring() const noexcept;
 #endif
+
+        // return Readiness if io_uring is unavailable
+        inline sharpen::NetIoMethod GetNetIoMethod() const noexcept {
+            return this->netIoMethod_;
+        }
     };
 }   // namespace sharpen
 
@@ -2,12 +2,15 @@
 #ifndef _SHARPEN_EVENTENGINE_HPP
 #define _SHARPEN_EVENTENGINE_HPP
 
+#include <atomic>
 #include <mutex>
 
 #include "EventLoopThread.hpp"
 #include "IEventLoopGroup.hpp"
 #include "IFiberScheduler.hpp"
 #include "ISelector.hpp"
+#include "NetTypeDef.hpp"
+#include "WorkStealingQueue.hpp"
 
 namespace sharpen {
     class EventEngine
@@ -18,23 +21,62 @@ namespace sharpen {
         using Self = sharpen::EventEngine;
         using SelfPtr = std::unique_ptr<Self>;
         using SwitchCallback = std::function<void()>;
+        using FiberQueue = sharpen::WorkStealingQueue<sharpen::Fiber>;
+
+        // run queue of a loop
+        struct LoopQueue {
+            explicit LoopQueue(std::size_t capacity);
+
+            FiberQueue fibers_;
+            // the loop found no work and may be blocked in select
+            std::atomic_bool idle_;
+        };
+
+        using LoopQueues = std::vector<std::unique_ptr<LoopQueue>>;
+
+        static constexpr std::size_t fiberQueueCapacity_{4096};
+
+        // max number of fibers executed by one loop iteration
+        static constexpr std::size_t fiberBatchSize_{64};
 
         static SelfPtr engine_;
         static std::once_flag flag_;
 
         Workers workers_;
-        std::size_t pos_;
+        std::atomic_size_t pos_;
         std::unique_ptr<sharpen::EventLoop> mainLoop_;
         std::vector<sharpen::EventLoop *> loops_;
+        LoopQueues queues_;
+        std::atomic_size_t idleCount_;
 
         static thread_local SwitchCallback switchCb_;
 
+        static thread_local sharpen::EventLoop *cachedLoop_;
+
+        static thread_local std::size_t cachedIndex_;
+
+        // return loops_.size() if current thread is not a loop of this engine
+        std::size_t GetLocalIndex() const noexcept;
+
+        void InjectFiber(sharpen::FiberPtr &&fiber);
+
+        // wake an idle loop to steal fibers from loop of index
+        void WakeIdleLoop(std::size_t index) noexcept;
+
+        bool RunLocalFibers(std::size_t index);
+
+        bool StealFibers(std::size_t index);
+
+        void ReleaseQueuedFibers() noexcept;
+
         static void ProcessFiber(sharpen::FiberPtr fiber);
 
         EventEngine();
 
         explicit EventEngine(std::size_t workerCount);
 
+        EventEngine(std::size_t workerCount, sharpen::NetIoMethod netIoMethod);
+
         static void CallSwitchCallback();
 
         void ProcessStartup(std::function<void()> fn);
@@ -54,8 +96,13 @@ namespace sharpen {
 
         static Self &SetupEngine(std::size_t workerCount);
 
+        // netIoMethod selects how posix stream sockets are driven
+        static Self &SetupEngine(std::size_t workerCount, sharpen::NetIoMethod netIoMethod);
+
         static Self &SetupSingleThreadEngine();
 
+        static Self &SetupSingleThreadEngine(sharpen::NetIoMethod netIoMethod);
+
         virtual void Stop() noexcept override;
 
         virtual sharpen::EventLoop &RoundRobinLoop() noexcept override;
@@ -68,6 +115,8 @@ namespace sharpen {
 
         virtual void Run() override;
 
+        virtual bool ExecuteLoopWork(sharpen::EventLoop &loop) override;
+
         template<typename _Fn,
                  typename... _Args,
                  typename _Check = sharpen::EnableIf<
@@ -96,6 +145,11 @@ namespace sharpen {
             return this->loops_.size();
         }
 
+        inline virtual sharpen::EventLoop &GetLoop(std::size_t index) noexcept override {
+            assert(index < this->loops_.size());
+            return *this->loops_[index];
+        }
+
         inline virtual std::size_t GetParallelCount() const noexcept override {
             return this->GetLoopCount();
         }
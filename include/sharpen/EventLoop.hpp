@@ -2,13 +2,16 @@
 #ifndef _SHARPEN_IEVENTLOOP_HPP
 #define _SHARPEN_IEVENTLOOP_HPP
 
+#include "ByteBuffer.hpp"
 #include "Fiber.hpp"
 #include "ISelector.hpp"
+#include "InlineFunction.hpp"
 #include "IoEvent.hpp"
+#include "MpscQueue.hpp"
 #include "Noncopyable.hpp"
 #include "Nonmovable.hpp"
 #include "SpinLock.hpp"
-#include <functional>
+#include <atomic>
 #include <memory>
 #include <mutex>
 #include <vector>
@@ -18,39 +21,56 @@ namespace sharpen {
 
     class IEventLoopGroup;
 
+    class TimerWheel;
+
     class EventLoop
         : public sharpen::Noncopyable
         , public sharpen::Nonmovable {
+    public:
+        // large enough for binding a fiber and a few arguments
+        static constexpr std::size_t taskSize{48};
+
+        using Task = sharpen::InlineFunction<void(), taskSize>;
+
     private:
-        using Task = std::function<void()>;
         using Lock = sharpen::SpinLock;
-        using TaskVector = std::vector<Task>;
         using SelectorPtr = std::shared_ptr<sharpen::ISelector>;
         using EventVector = std::vector<sharpen::IoEvent *>;
         using WeakChannelPtr = std::weak_ptr<sharpen::IChannel>;
 
         SelectorPtr selector_;
-        TaskVector tasks_;
-        TaskVector pendingTasks_;
-        bool exectingTask_;
+        sharpen::MpscQueue<Task> tasks_;
+        // true if the loop has been notified to execute tasks
+        std::atomic_bool exectingTask_;
         Lock lock_;
         std::atomic_bool running_;
         std::atomic_size_t works_;
         sharpen::IEventLoopGroup *loopGroup_;
+        // created when the first timer is made
+        std::shared_ptr<sharpen::TimerWheel> timerWheel_;
+        // only be used by the thread of loop
+        std::vector<sharpen::ByteBuffer> receiveBuffers_;
 
         // one loop per thread
         thread_local static EventLoop *localLoop_;
 
         thread_local static sharpen::FiberPtr localFiber_;
 
-        static constexpr std::size_t reservedTaskSize_{32};
+        static constexpr std::size_t reservedTaskSize_{256};
+
+        // tasks executed before the loop polls events again
+        static constexpr std::size_t maxTasksPerLoop_{1024};
 
         static constexpr std::size_t reservedEventBufSize_{128};
 
+        static constexpr std::size_t maxReceiveBuffers_{16};
+
         // execute pending tasks
         void ExecuteTask();
 
     public:
+        static constexpr std::size_t receiveBufferSize{4096};
+
         // create event loop with a selector and an uniqued task list
         explicit EventLoop(SelectorPtr selector);
 
@@ -101,6 +121,18 @@ namespace sharpen {
         }
 
         static sharpen::IEventLoopGroup *GetCurrentLoopGroup() noexcept;
+
+        // get timer wheel of this loop
+        // return nullptr if the platform doesn't support it
+        std::shared_ptr<sharpen::TimerWheel> GetTimerWheel();
+
+        // get a receive buffer from the pool of this loop
+        // must be called in the thread of loop
+        sharpen::ByteBuffer AcquireReceiveBuffer();
+
+        // give back a receive buffer to the pool of this loop
+        // must be called in the thread of loop
+        void ReleaseReceiveBuffer(sharpen::ByteBuffer buffer) noexcept;
     };
 
     extern sharpen::IEventLoopGroup *GetLocalLoopGroupPtr() noexcept;
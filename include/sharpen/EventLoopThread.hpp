@@ -18,8 +18,13 @@ namespace sharpen {
     public:
         explicit EventLoopThread(sharpen::SelectorPtr selector);
 
+        // the thread is not started if start is false
+        EventLoopThread(sharpen::SelectorPtr selector, bool start);
+
         ~EventLoopThread() noexcept;
 
+        void Start();
+
         void Join();
 
         void Detach();
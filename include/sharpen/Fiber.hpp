@@ -39,6 +39,7 @@ namespace sharpen {
         , public sharpen::Nonmovable
         , public std::enable_shared_from_this<sharpen::Fiber> {
     private:
+        using Self = sharpen::Fiber;
         using Handle = fcontext_t;
         using Task = std::function<void()>;
         using Callback = sharpen::Fiber *;
@@ -67,6 +68,10 @@ namespace sharpen {
         // id
         std::uint64_t id_;
 
+        // keep the fiber alive
+        // when it is only referenced by a raw pointer
+        sharpen::FiberPtr pinned_;
+
         thread_local static FiberPtr currentFiber_;
 
         static std::atomic_uint64_t idAllocator_;
@@ -107,8 +112,23 @@ namespace sharpen {
                  typename _Check = sharpen::EnableIf<
                      sharpen::IsCompletedBindableReturned<void, _Fn, _Args...>::Value>>
         static sharpen::FiberPtr MakeFiber(std::size_t stackSize, _Fn &&fn, _Args &&...args) {
+            return Self::MakeFiberWithStack(sharpen::StackAllocMethod::Heap,
+                                            stackSize,
+                                            std::forward<_Fn>(fn),
+                                            std::forward<_Args>(args)...);
+        }
+
+        template<typename _Fn,
+                 typename... _Args,
+                 typename _Check = sharpen::EnableIf<
+                     sharpen::IsCompletedBindableReturned<void, _Fn, _Args...>::Value>>
+        static sharpen::FiberPtr MakeFiberWithStack(sharpen::StackAllocMethod method,
+                                                    std::size_t stackSize,
+                                                    _Fn &&fn,
+                                                    _Args &&...args) {
             sharpen::FiberPtr fiber = std::make_shared<sharpen::Fiber>();
-            fiber->stack_ = sharpen::MemoryStack(nullptr, stackSize);
+            // the stack will be allocated when the fiber is switched first time
+            fiber->stack_ = sharpen::MemoryStack(nullptr, stackSize, method);
             fiber->task_ =
                 std::move(std::bind(std::forward<_Fn>(fn), std::forward<_Args>(args)...));
             return fiber;
@@ -123,6 +143,12 @@ namespace sharpen {
         }
 
         static sharpen::FiberLocalStorage &GetLocalStorage() noexcept;
+
+        // transfer the ownership of fiber to a raw pointer
+        static sharpen::Fiber *Pin(sharpen::FiberPtr fiber) noexcept;
+
+        // take back the ownership from a raw pointer returned by Pin()
+        static sharpen::FiberPtr Unpin(sharpen::Fiber *fiber) noexcept;
     };
 
     extern sharpen::IFiberScheduler *GetLocalSchedulerPtr() noexcept;
@@ -0,0 +1,61 @@
+#pragma once
+#ifndef _SHARPEN_FILERAFTSNAPSHOTCHUNK_HPP
+#define _SHARPEN_FILERAFTSNAPSHOTCHUNK_HPP
+
+#include "IFileChannel.hpp"
+#include "IRaftSnapshotChunk.hpp"
+
+namespace sharpen {
+    // reads a chunk of snapshot file by positional read
+    // so that chunks of a file could be sent to many followers
+    class FileRaftSnapshotChunk : public sharpen::IRaftSnapshotChunk {
+    private:
+        using Self = sharpen::FileRaftSnapshotChunk;
+
+        sharpen::FileChannelPtr channel_;
+        std::uint64_t offset_;
+        std::uint64_t size_;
+        std::size_t chunkSize_;
+
+    public:
+        FileRaftSnapshotChunk(sharpen::FileChannelPtr channel, std::size_t chunkSize);
+
+        FileRaftSnapshotChunk(const Self &other) = default;
+
+        FileRaftSnapshotChunk(Self &&other) noexcept;
+
+        inline Self &operator=(const Self &other) {
+            if (this != std::addressof(other)) {
+                Self tmp{other};
+                std::swap(tmp, *this);
+            }
+            return *this;
+        }
+
+        Self &operator=(Self &&other) noexcept;
+
+        virtual ~FileRaftSnapshotChunk() noexcept = default;
+
+        inline const Self &Const() const noexcept {
+            return *this;
+        }
+
+        virtual void Forward() override;
+
+        virtual sharpen::ByteBuffer GenerateChunkData() const override;
+
+        virtual bool Forwardable() const override;
+
+        virtual std::uint64_t GetOffset() const noexcept override;
+
+        inline std::uint64_t GetSize() const noexcept {
+            return this->size_;
+        }
+
+        inline std::size_t GetChunkSize() const noexcept {
+            return this->chunkSize_;
+        }
+    };
+}   // namespace sharpen
+
+#endif
\ No newline at end of file
@@ -0,0 +1,98 @@
+#pragma once
+#ifndef _SHARPEN_FILERAFTSNAPSHOTCONTROLLER_HPP
+#define _SHARPEN_FILERAFTSNAPSHOTCONTROLLER_HPP
+
+#include "IEventLoopGroup.hpp"
+#include "IFileChannel.hpp"   // IWYU pragma: keep
+#include "IRaftSnapshotController.hpp"
+#include "Noncopyable.hpp"
+#include <string>
+
+namespace sharpen {
+    // stores the snapshot in a file
+    // and its metadata in ${name}.meta
+    // chunks are installed to ${name}.tmp
+    // and the file replaces the snapshot after its checksum is verified
+    // a snapshot which does not match its metadata is discarded by Load()
+    class FileRaftSnapshotController
+        : public sharpen::IRaftSnapshotController
+        , public sharpen::Noncopyable {
+    private:
+        using Self = sharpen::FileRaftSnapshotController;
+
+        static constexpr std::size_t defaultChunkSize_{1 * 1024 * 1024};
+
+        // preallocate extents of temp file by this step
+        static constexpr std::size_t allocationSize_{64 * 1024 * 1024};
+
+        std::string name_;
+        std::string metaName_;
+        std::string tempName_;
+        sharpen::IEventLoopGroup *loopGroup_;
+        std::size_t chunkSize_;
+        sharpen::Optional<sharpen::RaftSnapshotMetadata> metadata_;
+        sharpen::FileChannelPtr installer_;
+        std::uint64_t expectedOffset_;
+        std::uint64_t allocatedSize_;
+        // rolling CRC32C of installed chunks
+        std::uint32_t checksum_;
+
+        void Load();
+
+        sharpen::RaftSnapshotMetadata LoadMetadata(const char *name) const;
+
+        // write the metadata to ${name}.meta.tmp
+        // then replace the snapshot and the metadata
+        void SaveMetadata(const sharpen::RaftSnapshotMetadata &metadata,
+                          const char *snapshotName);
+
+        sharpen::FileChannelPtr OpenTemp();
+
+        std::uint32_t ComputeChecksum(const char *name) const;
+
+        virtual void NviWrite(std::uint64_t offset, sharpen::ByteSlice snapshotChunk) override;
+
+        virtual void NviInstall(sharpen::RaftSnapshotMetadata metadata) override;
+
+        virtual void NviReset() override;
+
+    public:
+        explicit FileRaftSnapshotController(std::string name);
+
+        FileRaftSnapshotController(sharpen::IEventLoopGroup &loopGroup, std::string name);
+
+        FileRaftSnapshotController(sharpen::IEventLoopGroup &loopGroup,
+                                   std::string name,
+                                   std::size_t chunkSize);
+
+        FileRaftSnapshotController(Self &&other) noexcept;
+
+        Self &operator=(Self &&other) noexcept;
+
+        virtual ~FileRaftSnapshotController() noexcept;
+
+        inline const Self &Const() const noexcept {
+            return *this;
+        }
+
+        inline std::size_t GetChunkSize() const noexcept {
+            return this->chunkSize_;
+        }
+
+        inline const std::string &GetName() const noexcept {
+            return this->name_;
+        }
+
+        // replace the snapshot by a file which was written by the state machine
+        // the checksum of metadata is computed from the file
+        void Commit(const char *snapshotName, sharpen::RaftSnapshotMetadata metadata);
+
+        virtual sharpen::RaftSnapshot GetSnapshot() const override;
+
+        virtual sharpen::Optional<sharpen::RaftSnapshotMetadata> GetLastMetadata() const override;
+
+        virtual std::uint64_t GetExpectedOffset() const noexcept override;
+    };
+}   // namespace sharpen
+
+#endif
\ No newline at end of file
@@ -2,13 +2,13 @@
 #ifndef _SHARPEN_FUTURE_HPP
 #define _SHARPEN_FUTURE_HPP
 
+#include "InlineFunction.hpp"
+#include "Noncopyable.hpp"
 #include "Optional.hpp"
-#include "SpinLock.hpp"
-#include <condition_variable>
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <exception>
-#include <functional>
 #include <memory>
 #include <new>
 #include <stdexcept>
@@ -22,40 +22,53 @@ namespace sharpen {
         Error
     };
 
+    // the state word of future
+    // the low bits hold a sharpen::FutureState
+    // the high bits mark the waiters of a pending future
+    using FutureStateWord = std::uint32_t;
+
+    constexpr sharpen::FutureStateWord FutureStateMask{3};
+
+    constexpr sharpen::FutureStateWord FutureCallbackFlag{4};
+
+    constexpr sharpen::FutureStateWord FutureAwaiterFlag{8};
+
+    // the size of inline callback slot
+    constexpr std::size_t FutureCallbackSize{48};
+
     template<typename _Value>
     class Future : public sharpen::Noncopyable {
     private:
         using Self = Future<_Value>;
 
     protected:
-        using Callback = std::function<void(Self &)>;
+        using Callback = sharpen::InlineFunction<void(Self &), sharpen::FutureCallbackSize>;
 
     private:
-        std::unique_ptr<sharpen::SpinLock> lock_;
         sharpen::Optional<_Value> value_;
         Callback callback_;
-        std::atomic<FutureState> state_;
+        std::atomic<sharpen::FutureStateWord> state_;
         std::exception_ptr error_;
 
+        inline sharpen::FutureState GetState() const noexcept {
+            sharpen::FutureStateWord word{this->state_.load(std::memory_order::memory_order_acquire)};
+            return static_cast<sharpen::FutureState>(word & sharpen::FutureStateMask);
+        }
+
     public:
         Future()
-            : lock_(new (std::nothrow) sharpen::SpinLock())
-            , value_(sharpen::EmptyOpt)
+            : value_(sharpen::EmptyOpt)
             , callback_()
-            , state_(sharpen::FutureState::Pending)
+            , state_(static_cast<sharpen::FutureStateWord>(sharpen::FutureState::Pending))
             , error_() {
-            if (!this->lock_) {
-                throw std::bad_alloc();
-            }
         }
 
         Future(Self &&other) noexcept
-            : lock_(std::move(other.lock_))
-            , value_(std::move(other.value_))
+            : value_(std::move(other.value_))
             , callback_(std::move(other.callback_))
             , state_(other.state_.load(std::memory_order::memory_order_relaxed))
             , error_(std::move(other.error_)) {
-            other.state_.store(sharpen::FutureState::Pending,
+            other.state_.store(static_cast<sharpen::FutureStateWord>(sharpen::FutureState::Pending),
                                std::memory_order::memory_order_relaxed);
         }
 
@@ -63,26 +76,23 @@ namespace sharpen {
 
         inline Self &operator=(Self &&other) noexcept {
             if (this != std::addressof(other)) {
-                this->lock_ = std::move(other.lock_);
                 this->value_ = std::move(other.value_);
                 this->callback_ = std::move(other.callback_);
-                // this->state_ = std::move(other.state_);
-                sharpen::FutureState state{
+                sharpen::FutureStateWord state{
                     other.state_.load(std::memory_order::memory_order_relaxed)};
                 this->state_.store(state, std::memory_order::memory_order_relaxed);
                 this->error_ = std::move(other.error_);
-                other.state_.store(sharpen::FutureState::Pending,
-                                   std::memory_order::memory_order_relaxed);
+                other.state_.store(
+                    static_cast<sharpen::FutureStateWord>(sharpen::FutureState::Pending),
+                    std::memory_order::memory_order_relaxed);
             }
             return *this;
         }
 
         template<typename... _Args, typename = decltype(_Value{std::declval<_Args>()...})>
         void Complete(_Args &&...args) {
-            {
-                std::unique_lock<sharpen::SpinLock> lock{*this->lock_};
-                this->value_.Construct(std::forward<_Args>(args)...);
-            }
+            // only the completer touches the value before the state is published
+            this->value_.Construct(std::forward<_Args>(args)...);
             this->ExecuteCallback(sharpen::FutureState::Completed);
         }
 
@@ -91,10 +101,7 @@ namespace sharpen {
         }
 
         inline void Fail(std::exception_ptr err) {
-            {
-                std::unique_lock<sharpen::SpinLock> lock{*this->lock_};
-                this->error_ = std::move(err);
-            }
+            this->error_ = std::move(err);
             this->ExecuteCallback(sharpen::FutureState::Error);
         }
 
@@ -106,8 +113,7 @@ namespace sharpen {
 
         inline _Value &Get() {
             this->Wait();
-            if (this->state_.load(std::memory_order::memory_order_relaxed) ==
-                sharpen::FutureState::Completed) {
+            if (this->GetState() == sharpen::FutureState::Completed) {
                 return this->value_.Get();
             }
             // rethrow exception
@@ -116,8 +122,7 @@ namespace sharpen {
 
         inline const _Value &Get() const {
             this->Wait();
-            if (this->state_.load(std::memory_order::memory_order_relaxed) ==
-                sharpen::FutureState::Completed) {
+            if (this->GetState() == sharpen::FutureState::Completed) {
                 return this->value_.Get();
             }
             // rethrow exception
@@ -125,71 +130,72 @@ namespace sharpen {
         }
 
         inline bool CompletedOrError() const noexcept {
-            sharpen::FutureState state{this->state_.load(std::memory_order::memory_order_acquire)};
-            return state != sharpen::FutureState::Pending;
+            return this->GetState() != sharpen::FutureState::Pending;
         }
 
         inline bool IsPending() const noexcept {
-            sharpen::FutureState state{this->state_.load(std::memory_order::memory_order_acquire)};
-            return state == sharpen::FutureState::Pending;
+            return this->GetState() == sharpen::FutureState::Pending;
         }
 
         inline bool IsError() const noexcept {
-            sharpen::FutureState state{this->state_.load(std::memory_order::memory_order_acquire)};
-            return state == sharpen::FutureState::Error;
+            return this->GetState() == sharpen::FutureState::Error;
         }
 
         inline bool IsCompleted() const noexcept {
-            sharpen::FutureState state{this->state_.load(std::memory_order::memory_order_acquire)};
-            return state == sharpen::FutureState::Completed;
+            return this->GetState() == sharpen::FutureState::Completed;
         }
 
+        // a future has at most one callback
         inline void SetCallback(Callback &&callback) noexcept {
-            {
-                std::unique_lock<sharpen::SpinLock> lock{*this->lock_};
-                if (this->IsPending()) {
-                    this->callback_ = std::move(callback);
-                    return;
-                }
+            if (!callback) {
+                return;
             }
-            if (callback) {
-                callback(*this);
+            this->callback_ = std::move(callback);
+            if (!this->AddWaiter(sharpen::FutureCallbackFlag)) {
+                Callback cb{std::move(this->callback_)};
+                cb(*this);
             }
         }
 
-        inline sharpen::SpinLock &GetCompleteLock() const noexcept {
-            return *this->lock_;
-        }
-
+        // must not be called concurrently with Complete() or Fail()
         inline void Reset() noexcept {
-            std::unique_lock<sharpen::SpinLock> lock{*this->lock_};
-            this->ResetWithoutLock();
-        }
-
-    protected:
-        virtual void ResetWithoutLock() noexcept {
             this->value_.Reset();
             this->error_ = std::exception_ptr{};
-            this->state_.store(sharpen::FutureState::Pending,
-                               std::memory_order::memory_order_release);
+            // keep the waiters
+            this->state_.fetch_and(~sharpen::FutureStateMask,
+                                   std::memory_order::memory_order_release);
         }
 
+    protected:
         inline Callback &GetCallback() noexcept {
             return this->callback_;
         }
 
-        inline void SetState(sharpen::FutureState state) noexcept {
-            this->state_.store(state, std::memory_order::memory_order_release);
+        // returns false if the future has been completed
+        inline bool AddWaiter(sharpen::FutureStateWord flag) noexcept {
+            sharpen::FutureStateWord word{this->state_.load(std::memory_order::memory_order_acquire)};
+            do {
+                if (word & sharpen::FutureStateMask) {
+                    return false;
+                }
+            } while (!this->state_.compare_exchange_weak(word,
+                                                         word | flag,
+                                                         std::memory_order::memory_order_acq_rel,
+                                                         std::memory_order::memory_order_acquire));
+            return true;
+        }
+
+        // returns the waiters of the future
+        inline sharpen::FutureStateWord SetState(sharpen::FutureState state) noexcept {
+            sharpen::FutureStateWord word{this->state_.exchange(
+                static_cast<sharpen::FutureStateWord>(state), std::memory_order::memory_order_acq_rel)};
+            return word & ~sharpen::FutureStateMask;
         }
 
         virtual void ExecuteCallback(sharpen::FutureState state) {
-            Callback cb;
-            {
-                std::unique_lock<sharpen::SpinLock> lock{this->GetCompleteLock()};
-                std::swap(cb, this->GetCallback());
-                this->SetState(state);
-            }
-            if (cb) {
+            sharpen::FutureStateWord waiters{this->SetState(state)};
+            if (waiters & sharpen::FutureCallbackFlag) {
+                Callback cb{std::move(this->callback_)};
                 cb(*this);
             }
         }
@@ -201,31 +207,30 @@ namespace sharpen {
         using Self = Future<void>;
 
     protected:
-        using Callback = std::function<void(Self &)>;
+        using Callback = sharpen::InlineFunction<void(Self &), sharpen::FutureCallbackSize>;
 
     private:
-        std::unique_ptr<sharpen::SpinLock> lock_;
         Callback callback_;
-        std::atomic<FutureState> state_;
+        std::atomic<sharpen::FutureStateWord> state_;
         std::exception_ptr error_;
 
+        inline sharpen::FutureState GetState() const noexcept {
+            sharpen::FutureStateWord word{this->state_.load(std::memory_order::memory_order_acquire)};
+            return static_cast<sharpen::FutureState>(word & sharpen::FutureStateMask);
+        }
+
     public:
         Future()
-            : lock_(new (std::nothrow) sharpen::SpinLock())
-            , callback_()
-            , state_(sharpen::FutureState::Pending)
+            : callback_()
+            , state_(static_cast<sharpen::FutureStateWord>(sharpen::FutureState::Pending))
             , error_() {
-            if (!this->lock_) {
-                throw std::bad_alloc();
-            }
         }
 
         Future(Self &&other) noexcept
-            : lock_(std::move(other.lock_))
-            , callback_(std::move(other.callback_))
+            : callback_(std::move(other.callback_))
             , state_(other.state_.load(std::memory_order::memory_order_relaxed))
             , error_(std::move(other.error_)) {
-            other.state_.store(sharpen::FutureState::Pending,
+            other.state_.store(static_cast<sharpen::FutureStateWord>(sharpen::FutureState::Pending),
                                std::memory_order::memory_order_relaxed);
         }
 
@@ -234,14 +239,14 @@ namespace sharpen {
 
         inline Self &operator=(Self &&other) noexcept {
             if (this != std::addressof(other)) {
-                this->lock_ = std::move(other.lock_);
                 this->callback_ = std::move(other.callback_);
-                sharpen::FutureState state{
+                sharpen::FutureStateWord state{
                     other.state_.load(std::memory_order::memory_order_relaxed)};
                 this->state_.store(state, std::memory_order::memory_order_relaxed);
                 this->error_ = std::move(other.error_);
-                other.state_.store(sharpen::FutureState::Pending,
-                                   std::memory_order::memory_order_relaxed);
+                other.state_.store(
+                    static_cast<sharpen::FutureStateWord>(sharpen::FutureState::Pending),
+                    std::memory_order::memory_order_relaxed);
             }
             return *this;
         }
@@ -255,10 +260,7 @@ namespace sharpen {
         }
 
         inline void Fail(std::exception_ptr err) {
-            {
-                std::unique_lock<sharpen::SpinLock> lock{*this->lock_};
-                this->error_ = std::move(err);
-            }
+            this->error_ = std::move(err);
             this->ExecuteCallback(sharpen::FutureState::Error);
         }
 
@@ -270,8 +272,7 @@ namespace sharpen {
 
         inline void Get() const {
             this->Wait();
-            if (this->state_.load(std::memory_order::memory_order_relaxed) ==
-                sharpen::FutureState::Completed) {
+            if (this->GetState() == sharpen::FutureState::Completed) {
                 return;
             }
             // rethrow exception
@@ -279,71 +280,71 @@ namespace sharpen {
         }
 
         inline bool CompletedOrError() const noexcept {
-            sharpen::FutureState state{this->state_.load(std::memory_order::memory_order_acquire)};
-            return state != sharpen::FutureState::Pending;
+            return this->GetState() != sharpen::FutureState::Pending;
         }
 
         inline bool IsPending() const noexcept {
-            sharpen::FutureState state{this->state_.load(std::memory_order::memory_order_acquire)};
-            return state == sharpen::FutureState::Pending;
+            return this->GetState() == sharpen::FutureState::Pending;
         }
 
         inline bool IsError() const noexcept {
-            sharpen::FutureState state{this->state_.load(std::memory_order::memory_order_acquire)};
-            return state == sharpen::FutureState::Error;
+            return this->GetState() == sharpen::FutureState::Error;
         }
 
         inline bool IsCompleted() const noexcept {
-            sharpen::FutureState state{this->state_.load(std::memory_order::memory_order_acquire)};
-            return state == sharpen::FutureState::Completed;
+            return this->GetState() == sharpen::FutureState::Completed;
         }
 
+        // a future has at most one callback
         void SetCallback(Callback &&callback) {
             if (!callback) {
                 return;
             }
-            {
-                std::unique_lock<sharpen::SpinLock> lock(*this->lock_);
-                if (this->IsPending()) {
-                    this->callback_ = std::move(callback);
-                    return;
-                }
+            this->callback_ = std::move(callback);
+            if (!this->AddWaiter(sharpen::FutureCallbackFlag)) {
+                Callback cb{std::move(this->callback_)};
+                cb(*this);
             }
-            callback(*this);
         }
 
-        sharpen::SpinLock &GetCompleteLock() {
-            return *this->lock_;
-        }
-
-        void Reset() {
-            std::unique_lock<sharpen::SpinLock> lock(*this->lock_);
-            this->ResetWithoutLock();
-        }
-
-    protected:
-        virtual void ResetWithoutLock() {
+        // must not be called concurrently with Complete() or Fail()
+        void Reset() noexcept {
             this->error_ = std::exception_ptr{};
-            this->state_.store(sharpen::FutureState::Pending,
-                               std::memory_order::memory_order_release);
+            // keep the waiters
+            this->state_.fetch_and(~sharpen::FutureStateMask,
+                                   std::memory_order::memory_order_release);
         }
 
+    protected:
         inline Callback &GetCallback() noexcept {
             return this->callback_;
         }
 
-        inline void SetState(sharpen::FutureState state) noexcept {
-            this->state_.store(state, std::memory_order::memory_order_release);
+        // returns false if the future has been completed
+        inline bool AddWaiter(sharpen::FutureStateWord flag) noexcept {
+            sharpen::FutureStateWord word{this->state_.load(std::memory_order::memory_order_acquire)};
+            do {
+                if (word & sharpen::FutureStateMask) {
+                    return false;
+                }
+            } while (!this->state_.compare_exchange_weak(word,
+                                                         word | flag,
+                                                         std::memory_order::memory_order_acq_rel,
+                                                         std::memory_order::memory_order_acquire));
+            return true;
+        }
+
+        // returns the waiters of the future
+        inline sharpen::FutureStateWord SetState(sharpen::FutureState state) noexcept {
+            sharpen::FutureStateWord word{this->state_.exchange(
+                static_cast<sharpen::FutureStateWord>(state), std::memory_order::memory_order_acq_rel)};
+            return word & ~sharpen::FutureStateMask;
         }
 
         inline virtual void ExecuteCallback(sharpen::FutureState state) {
-            Callback cb;
-            {
-                std::unique_lock<sharpen::SpinLock> lock{this->GetCompleteLock()};
-                std::swap(cb, this->GetCallback());
-                this->SetState(state);
-            }
-            if (cb) {
+            sharpen::FutureStateWord waiters{this->SetState(state)};
+            if (waiters & sharpen::FutureCallbackFlag) {
+                Callback cb{std::move(this->callback_)};
                 cb(*this);
             }
         }
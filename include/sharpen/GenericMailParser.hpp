@@ -26,10 +26,18 @@ namespace sharpen {
 
         ParseStatus GetStatus() const noexcept;
 
+        void PrepareContent();
+
+        void CompleteMail();
+
         virtual sharpen::Mail NviPopCompletedMail() noexcept override;
 
         virtual void NviParse(sharpen::ByteSlice slice) override;
 
+        virtual char *NviGetDirectBuffer(std::size_t &size) noexcept override;
+
+        virtual void NviCommitDirectBuffer(std::size_t size) override;
+
     public:
         constexpr static std::uint32_t minMaxContentSize{4*1024};
 
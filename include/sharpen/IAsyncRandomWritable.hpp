@@ -3,6 +3,7 @@
 #define _SHARPEN_IASYNCRANDOMWRITABLE_HPP
 
 #include "ByteBuffer.hpp"
+#include "ByteSlice.hpp"
 #include "Future.hpp"
 #include <cstddef>
 #include <cstdint>
@@ -40,6 +41,23 @@ namespace sharpen {
 
         std::size_t WriteAsync(const sharpen::ByteBuffer &buf, std::uint64_t offset);
 
+        // gather write
+        // slices and their buffers should be valid until the future is completed
+        // it may write less bytes than the total size of slices
+        // the default implementation writes the first non-empty slice only
+        virtual void WriteVectorAsync(const sharpen::ByteSlice *slices,
+                                      std::size_t count,
+                                      std::uint64_t offset,
+                                      sharpen::Future<std::size_t> &future);
+
+        std::size_t WriteVectorAsync(const sharpen::ByteSlice *slices,
+                                     std::size_t count,
+                                     std::uint64_t offset);
+
+        std::size_t WriteVectorFixedAsync(const sharpen::ByteSlice *slices,
+                                          std::size_t count,
+                                          std::uint64_t offset);
+
         inline std::size_t WriteFixedAsync(const char *buf, std::size_t bufSize,std::uint64_t offset) {
             std::size_t off{0};
             while (off != bufSize) {
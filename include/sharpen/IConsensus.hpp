@@ -39,6 +39,10 @@ namespace sharpen {
 
         virtual std::uint64_t NviGetLastAppliedIndex() const noexcept = 0;
 
+        // completes with the read index once it was applied
+        // or empty if we are not the leader
+        virtual void NviReadIndex(sharpen::Future<sharpen::Optional<std::uint64_t>> &future) = 0;
+
         virtual sharpen::Optional<sharpen::ConsensusPeersConfiguration>
         NviGetPeersConfiguration() const = 0;
 
@@ -152,6 +156,18 @@ namespace sharpen {
             return this->NviGetLastAppliedIndex();
         }
 
+        // linearizable read
+        // state machine could be read after the future completed with a value
+        inline void ReadIndex(sharpen::Future<sharpen::Optional<std::uint64_t>> &future) {
+            this->NviReadIndex(future);
+        }
+
+        inline sharpen::Optional<std::uint64_t> ReadIndex() {
+            sharpen::AwaitableFuture<sharpen::Optional<std::uint64_t>> future;
+            this->NviReadIndex(future);
+            return future.Await();
+        }
+
         inline sharpen::Optional<sharpen::ConsensusPeersConfiguration> GetPeersConfiguration() const {
             return this->NviGetPeersConfiguration();
         }
@@ -31,9 +31,19 @@ namespace sharpen {
 
         virtual std::size_t GetLoopCount() const noexcept = 0;
 
+        // index should < GetLoopCount()
+        virtual sharpen::EventLoop &GetLoop(std::size_t index) noexcept = 0;
+
         virtual void Run() = 0;
 
         virtual void Stop() noexcept = 0;
+
+        // invoked by the loop after executing pending tasks
+        // return true if the loop has more work and should not block
+        inline virtual bool ExecuteLoopWork(sharpen::EventLoop &loop) {
+            (void)loop;
+            return false;
+        }
     };
 }   // namespace sharpen
 
@@ -14,6 +14,9 @@
 #define SHARPEN_FIBER_STACK_SIZE 64 * 1024
 #endif
 
+// define SHARPEN_FIBER_HEAP_STACK
+// to allocate fiber stacks by calloc() by default
+
 namespace sharpen {
     class IFiberScheduler
         : public sharpen::Noncopyable
@@ -21,6 +24,14 @@ namespace sharpen {
     private:
         constexpr static std::size_t defaultFiberStackSize_{SHARPEN_FIBER_STACK_SIZE};
 
+#ifdef SHARPEN_FIBER_HEAP_STACK
+        constexpr static sharpen::StackAllocMethod defaultStackAllocMethod_{
+            sharpen::StackAllocMethod::Heap};
+#else
+        constexpr static sharpen::StackAllocMethod defaultStackAllocMethod_{
+            sharpen::StackAllocMethod::Pooled};
+#endif
+
         virtual void NviSchedule(sharpen::FiberPtr &&fiber) = 0;
 
         virtual void NviScheduleSoon(sharpen::FiberPtr &&fiber) = 0;
@@ -54,8 +65,25 @@ namespace sharpen {
                  typename _Check = sharpen::EnableIf<
                      sharpen::IsCompletedBindableReturned<void, _Fn, _Args...>::Value>>
         void LaunchSpecial(std::size_t stackSize, _Fn &&fn, _Args &&...args) {
-            sharpen::FiberPtr fiber = sharpen::Fiber::MakeFiber(
-                stackSize, std::forward<_Fn>(fn), std::forward<_Args>(args)...);
+            this->LaunchWithStack(defaultStackAllocMethod_,
+                                  stackSize,
+                                  std::forward<_Fn>(fn),
+                                  std::forward<_Args>(args)...);
+        }
+
+        template<typename _Fn,
+                 typename... _Args,
+                 typename _Check = sharpen::EnableIf<
+                     sharpen::IsCompletedBindableReturned<void, _Fn, _Args...>::Value>>
+        // launch a fiber with the specified stack size and allocation method
+        // Heap allocates a zeroed stack by calloc()
+        // Pooled reuses guarded stacks from the free lists of the running thread
+        void LaunchWithStack(sharpen::StackAllocMethod method,
+                             std::size_t stackSize,
+                             _Fn &&fn,
+                             _Args &&...args) {
+            sharpen::FiberPtr fiber = sharpen::Fiber::MakeFiberWithStack(
+                method, stackSize, std::forward<_Fn>(fn), std::forward<_Args>(args)...);
             fiber->SetScheduler(this);
             this->Schedule(std::move(fiber));
         }
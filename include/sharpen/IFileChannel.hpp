@@ -56,6 +56,14 @@ namespace sharpen {
 
         void FlushAsync();
 
+        // flush file data and the metadata which is needed to read it
+        // fall back to FlushAsync() by default
+        inline virtual void FlushDataAsync(sharpen::Future<void> &future) {
+            this->FlushAsync(future);
+        }
+
+        void FlushDataAsync();
+
         virtual void AllocateAsync(sharpen::Future<std::size_t> &future,std::uint64_t offset, std::size_t size) = 0;
 
         std::size_t AllocateAsync(std::uint64_t offset, std::size_t size);
@@ -66,6 +74,13 @@ namespace sharpen {
 
         virtual std::size_t GetPath(SHARPEN_OUT char *path,std::size_t size) const = 0;
 
+        // use registered file and buffers of io_uring
+        // should be called after Register()
+        // return false if it is not supported
+        inline virtual bool EnableRegisteredIo() {
+            return false;
+        }
+
         void Remove();
     };
 
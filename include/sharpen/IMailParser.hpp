@@ -17,6 +17,17 @@ namespace sharpen {
 
         virtual void NviParse(sharpen::ByteSlice slice) = 0;
 
+        // parsers don't support direct buffer by default
+        inline virtual char *NviGetDirectBuffer(std::size_t &size) noexcept {
+            size = 0;
+            return nullptr;
+        }
+
+        inline virtual void NviCommitDirectBuffer(std::size_t size) {
+            (void)size;
+            assert(!size);
+        }
+
     public:
         IMailParser() noexcept = default;
 
@@ -67,6 +78,21 @@ namespace sharpen {
         }
 
         virtual bool Completed() const noexcept = 0;
+
+        // get a buffer that the following bytes of current mail
+        // could be read into directly, without copying
+        // the size of buffer is the remaining size of current mail
+        // return nullptr if parser doesn't support it or is not ready
+        inline char *GetDirectBuffer(std::size_t &size) noexcept {
+            return this->NviGetDirectBuffer(size);
+        }
+
+        // notify parser that size bytes have been read into direct buffer
+        inline void CommitDirectBuffer(std::size_t size) {
+            if (size) {
+                this->NviCommitDirectBuffer(size);
+            }
+        }
     };
 }   // namespace sharpen
 
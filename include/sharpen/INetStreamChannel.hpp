@@ -84,6 +84,9 @@ namespace sharpen {
 
         void ReuseAddressInNix();
 
+        // throw ErrorOperationNotSupport if SO_REUSEPORT is not supported
+        void SetReusePort(bool val);
+
         int GetErrorCode() const noexcept;
 
         virtual void PollReadAsync(sharpen::Future<void> &future) = 0;
@@ -169,6 +172,10 @@ namespace sharpen {
 
     extern sharpen::NetStreamChannelPtr OpenTcpChannel(sharpen::AddressFamily af);
 
+    // a connected udp socket behaves like a stream of datagrams
+    // each read returns at most one datagram
+    extern sharpen::NetStreamChannelPtr OpenUdpChannel(sharpen::AddressFamily af);
+
     extern void StartupNetSupport();
 
     extern void CleanupNetSupport();
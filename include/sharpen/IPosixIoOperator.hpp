@@ -6,6 +6,7 @@
 
 #ifdef SHARPEN_IS_NIX
 
+#include "ByteSlice.hpp"
 #include "FileTypeDef.hpp"
 #include "Noncopyable.hpp"
 #include "Nonmovable.hpp"
@@ -14,6 +15,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <functional>
+#include <memory>
 #include <vector>
 
 namespace sharpen {
@@ -56,8 +58,17 @@ namespace sharpen {
         virtual void NviExecute(sharpen::FileHandle handle, bool &executed, bool &blocking) = 0;
 
     private:
+        // a group of buffers which shares one callback
+        struct VectorTask {
+            std::size_t remaining_;
+            std::size_t size_;
+            Callback cb_;
+        };
+
         std::size_t mark_;
 
+        static void CompleteVectorTask(std::shared_ptr<VectorTask> task, ssize_t size);
+
     public:
         IPosixIoOperator();
 
@@ -65,8 +76,21 @@ namespace sharpen {
 
         void AddPendingTask(char *buf, std::size_t size, Callback cb);
 
+        // cb is invoked once with the total size
+        // or with the written size if an error occurs after some buffers were written
+        void AddPendingTasks(const iovec *bufs, std::size_t count, Callback cb);
+
+        // empty slices are skipped
+        // the count and the total size are limited by IOV_MAX and MaxIoSize
+        static void ConvertSlices(const sharpen::ByteSlice *slices,
+                                  std::size_t count,
+                                  std::vector<iovec> &bufs);
+
         void Execute(sharpen::FileHandle handle, bool &executed, bool &blocking);
 
+        // return true if some tasks have not been completed
+        bool HasPendingTask() const;
+
         static bool IsBlockingError(sharpen::ErrorCode code);
 
         void CancelAllIo(sharpen::ErrorCode err) noexcept;
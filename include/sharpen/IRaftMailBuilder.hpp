@@ -5,6 +5,10 @@
 #include "Mail.hpp"
 #include "RaftHeartbeatRequest.hpp"
 #include "RaftHeartbeatResponse.hpp"
+#include "RaftLearnLogsRequest.hpp"
+#include "RaftLearnLogsResponse.hpp"
+#include "RaftLearnSnapshotRequest.hpp"
+#include "RaftLearnSnapshotResponse.hpp"
 #include "RaftPrevoteRequest.hpp"
 #include "RaftPrevoteResponse.hpp"
 #include "RaftSnapshotRequest.hpp"
@@ -58,6 +62,18 @@ namespace sharpen {
 
         virtual sharpen::Mail BuildSnapshotResponse(
             const sharpen::RaftSnapshotResponse &response) const = 0;
+
+        virtual sharpen::Mail BuildLearnLogsRequest(
+            const sharpen::RaftLearnLogsRequest &request) const = 0;
+
+        virtual sharpen::Mail BuildLearnLogsResponse(
+            const sharpen::RaftLearnLogsResponse &response) const = 0;
+
+        virtual sharpen::Mail BuildLearnSnapshotRequest(
+            const sharpen::RaftLearnSnapshotRequest &request) const = 0;
+
+        virtual sharpen::Mail BuildLearnSnapshotResponse(
+            const sharpen::RaftLearnSnapshotResponse &response) const = 0;
     };
 }   // namespace sharpen
 
@@ -6,6 +6,10 @@
 #include "Mail.hpp"
 #include "RaftHeartbeatRequest.hpp"
 #include "RaftHeartbeatResponse.hpp"
+#include "RaftLearnLogsRequest.hpp"
+#include "RaftLearnLogsResponse.hpp"
+#include "RaftLearnSnapshotRequest.hpp"
+#include "RaftLearnSnapshotResponse.hpp"
 #include "RaftMailType.hpp"
 #include "RaftPrevoteRequest.hpp"
 #include "RaftPrevoteResponse.hpp"
@@ -49,6 +53,18 @@ namespace sharpen {
         virtual sharpen::Optional<sharpen::RaftSnapshotResponse> NviExtractSnapshotResponse(
             const sharpen::Mail &mail) const noexcept = 0;
 
+        virtual sharpen::Optional<sharpen::RaftLearnLogsRequest> NviExtractLearnLogsRequest(
+            const sharpen::Mail &mail) const noexcept = 0;
+
+        virtual sharpen::Optional<sharpen::RaftLearnLogsResponse> NviExtractLearnLogsResponse(
+            const sharpen::Mail &mail) const noexcept = 0;
+
+        virtual sharpen::Optional<sharpen::RaftLearnSnapshotRequest> NviExtractLearnSnapshotRequest(
+            const sharpen::Mail &mail) const noexcept = 0;
+
+        virtual sharpen::Optional<sharpen::RaftLearnSnapshotResponse>
+        NviExtractLearnSnapshotResponse(const sharpen::Mail &mail) const noexcept = 0;
+
     public:
         IRaftMailExtractor() noexcept = default;
 
@@ -143,6 +159,38 @@ namespace sharpen {
             }
             return this->NviExtractSnapshotResponse(mail);
         }
+
+        inline sharpen::Optional<sharpen::RaftLearnLogsRequest> ExtractLearnLogsRequest(
+            const sharpen::Mail &mail) const noexcept {
+            if (!this->IsRaftMail(mail)) {
+                return sharpen::EmptyOpt;
+            }
+            return this->NviExtractLearnLogsRequest(mail);
+        }
+
+        inline sharpen::Optional<sharpen::RaftLearnLogsResponse> ExtractLearnLogsResponse(
+            const sharpen::Mail &mail) const noexcept {
+            if (!this->IsRaftMail(mail)) {
+                return sharpen::EmptyOpt;
+            }
+            return this->NviExtractLearnLogsResponse(mail);
+        }
+
+        inline sharpen::Optional<sharpen::RaftLearnSnapshotRequest> ExtractLearnSnapshotRequest(
+            const sharpen::Mail &mail) const noexcept {
+            if (!this->IsRaftMail(mail)) {
+                return sharpen::EmptyOpt;
+            }
+            return this->NviExtractLearnSnapshotRequest(mail);
+        }
+
+        inline sharpen::Optional<sharpen::RaftLearnSnapshotResponse> ExtractLearnSnapshotResponse(
+            const sharpen::Mail &mail) const noexcept {
+            if (!this->IsRaftMail(mail)) {
+                return sharpen::EmptyOpt;
+            }
+            return this->NviExtractLearnSnapshotResponse(mail);
+        }
     };
 }   // namespace sharpen
 
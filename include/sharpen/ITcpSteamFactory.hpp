@@ -13,6 +13,9 @@ namespace sharpen {
     protected:
         virtual sharpen::NetStreamChannelPtr NviProduce(sharpen::TcpStreamOption option) = 0;
 
+        virtual sharpen::NetStreamChannelPtr NviProduce(sharpen::TcpStreamOption option,
+                                                        sharpen::EventLoop &loop) = 0;
+
     public:
         ITcpSteamFactory() noexcept = default;
 
@@ -34,6 +37,12 @@ namespace sharpen {
             return this->NviProduce(option);
         }
 
+        // the channel is registered to the loop
+        inline sharpen::NetStreamChannelPtr Produce(sharpen::TcpStreamOption option,
+                                                    sharpen::EventLoop &loop) {
+            return this->NviProduce(option, loop);
+        }
+
         virtual sharpen::IEventLoopGroup &GetLoopGroup() const noexcept = 0;
     };
 }   // namespace sharpen
@@ -0,0 +1,191 @@
+#pragma once
+#ifndef _SHARPEN_INLINEFUNCTION_HPP
+#define _SHARPEN_INLINEFUNCTION_HPP
+
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace sharpen {
+
+    template<typename _Fn, std::size_t _Size>
+    class InlineFunction;
+
+    // a move-only function with a fixed-size small buffer
+    // functors larger than _Size fall back to the heap
+    template<typename _Ret, typename... _Args, std::size_t _Size>
+    class InlineFunction<_Ret(_Args...), _Size> {
+    private:
+        using Self = sharpen::InlineFunction<_Ret(_Args...), _Size>;
+        using Storage = typename std::aligned_storage<_Size, alignof(std::max_align_t)>::type;
+
+        struct Operations {
+            _Ret (*invoke_)(void *, _Args &&...);
+            // move-construct dst from src and destroy src
+            void (*move_)(void *, void *);
+            void (*destroy_)(void *);
+        };
+
+        template<typename _Fn>
+        struct InlineOperations {
+            static _Ret Invoke(void *p, _Args &&...args) {
+                return (*static_cast<_Fn *>(p))(std::forward<_Args>(args)...);
+            }
+
+            static void Move(void *dst, void *src) noexcept {
+                _Fn *fn{static_cast<_Fn *>(src)};
+                new (dst) _Fn(std::move(*fn));
+                fn->~_Fn();
+            }
+
+            static void Destroy(void *p) noexcept {
+                static_cast<_Fn *>(p)->~_Fn();
+            }
+
+            inline static const Operations *GetOperations() noexcept {
+                static const Operations ops{&Invoke, &Move, &Destroy};
+                return &ops;
+            }
+        };
+
+        template<typename _Fn>
+        struct HeapOperations {
+            static _Ret Invoke(void *p, _Args &&...args) {
+                return (**static_cast<_Fn **>(p))(std::forward<_Args>(args)...);
+            }
+
+            static void Move(void *dst, void *src) noexcept {
+                _Fn **fn{static_cast<_Fn **>(src)};
+                new (dst)(_Fn *)(*fn);
+                *fn = nullptr;
+            }
+
+            static void Destroy(void *p) noexcept {
+                delete *static_cast<_Fn **>(p);
+            }
+
+            inline static const Operations *GetOperations() noexcept {
+                static const Operations ops{&Invoke, &Move, &Destroy};
+                return &ops;
+            }
+        };
+
+        template<typename _Fn>
+        using IsInline =
+            std::integral_constant<bool,
+                                   sizeof(_Fn) <= _Size &&
+                                       alignof(_Fn) <= alignof(std::max_align_t) &&
+                                       std::is_nothrow_move_constructible<_Fn>::value>;
+
+        Storage storage_;
+        const Operations *ops_;
+
+        template<typename _Fn>
+        inline void Construct(_Fn &&fn, std::true_type) {
+            using Fn = typename std::decay<_Fn>::type;
+            new (&this->storage_) Fn(std::forward<_Fn>(fn));
+            this->ops_ = InlineOperations<Fn>::GetOperations();
+        }
+
+        template<typename _Fn>
+        inline void Construct(_Fn &&fn, std::false_type) {
+            using Fn = typename std::decay<_Fn>::type;
+            Fn *p{new (std::nothrow) Fn(std::forward<_Fn>(fn))};
+            if (!p) {
+                throw std::bad_alloc{};
+            }
+            new (&this->storage_)(Fn *)(p);
+            this->ops_ = HeapOperations<Fn>::GetOperations();
+        }
+
+        template<typename _Fn>
+        inline static auto IsNull(const _Fn &fn, int) noexcept -> decltype(fn == nullptr) {
+            return fn == nullptr;
+        }
+
+        template<typename _Fn>
+        inline static bool IsNull(const _Fn &, ...) noexcept {
+            return false;
+        }
+
+    public:
+        InlineFunction() noexcept
+            : storage_()
+            , ops_(nullptr) {
+        }
+
+        InlineFunction(std::nullptr_t) noexcept
+            : Self() {
+        }
+
+        template<typename _Fn,
+                 typename _Check = typename std::enable_if<
+                     !std::is_same<typename std::decay<_Fn>::type, Self>::value>::type,
+                 typename = decltype(static_cast<_Ret>(std::declval<typename std::decay<_Fn>::type &>()(
+                     std::declval<_Args>()...)))>
+        InlineFunction(_Fn &&fn)
+            : Self() {
+            using Fn = typename std::decay<_Fn>::type;
+            if (Self::IsNull(fn, 0)) {
+                return;
+            }
+            this->Construct(std::forward<_Fn>(fn), IsInline<Fn>{});
+        }
+
+        InlineFunction(Self &&other) noexcept
+            : Self() {
+            if (other.ops_) {
+                other.ops_->move_(&this->storage_, &other.storage_);
+                this->ops_ = other.ops_;
+                other.ops_ = nullptr;
+            }
+        }
+
+        InlineFunction(const Self &other) = delete;
+
+        inline Self &operator=(Self &&other) noexcept {
+            if (this != std::addressof(other)) {
+                this->Reset();
+                if (other.ops_) {
+                    other.ops_->move_(&this->storage_, &other.storage_);
+                    this->ops_ = other.ops_;
+                    other.ops_ = nullptr;
+                }
+            }
+            return *this;
+        }
+
+        Self &operator=(const Self &other) = delete;
+
+        ~InlineFunction() noexcept {
+            this->Reset();
+        }
+
+        inline void Reset() noexcept {
+            if (this->ops_) {
+                this->ops_->destroy_(&this->storage_);
+                this->ops_ = nullptr;
+            }
+        }
+
+        inline explicit operator bool() const noexcept {
+            return this->ops_ != nullptr;
+        }
+
+        inline _Ret operator()(_Args... args) {
+            assert(this->ops_);
+            return this->ops_->invoke_(&this->storage_, std::forward<_Args>(args)...);
+        }
+
+        inline void Swap(Self &other) noexcept {
+            Self tmp{std::move(other)};
+            other = std::move(*this);
+            *this = std::move(tmp);
+        }
+    };
+}   // namespace sharpen
+
+#endif
@@ -18,6 +18,7 @@
 #include "Nonmovable.hpp"
 #include "SystemError.hpp"
 #include <linux/io_uring.h>
+#include <sys/uio.h>
 #include <unistd.h>
 #include <atomic>
 #include <cstddef>
@@ -101,6 +102,8 @@ namespace sharpen {
         std::size_t cringSize_;
         std::size_t cringNumber_;
         std::size_t requestNumber_;
+        std::uint32_t setupFlags_;
+        std::uint32_t features_;
 
     public:
         IoUring(std::uint32_t entries,
@@ -115,19 +118,20 @@ namespace sharpen {
 
         bool GetFromCring(struct io_uring_cqe *cqe);
 
-        void Enter(unsigned int to_submit,
-                   unsigned int min_complete,
-                   unsigned int flags,
-                   sigset_t *sig);
+        // return the number of sqes consumed by kernel
+        int Enter(unsigned int to_submit,
+                  unsigned int min_complete,
+                  unsigned int flags,
+                  sigset_t *sig);
 
-        void Enter(unsigned int to_submit,
-                   unsigned int min_complete,
-                   unsigned int flags,
-                   void *arg,
-                   size_t argsz);
+        int Enter(unsigned int to_submit,
+                  unsigned int min_complete,
+                  unsigned int flags,
+                  void *arg,
+                  size_t argsz);
 
-        inline void Enter(unsigned int to_submit, unsigned int min_complete, unsigned int flags) {
-            this->Enter(to_submit, min_complete, flags, nullptr);
+        inline int Enter(unsigned int to_submit, unsigned int min_complete, unsigned int flags) {
+            return this->Enter(to_submit, min_complete, flags, nullptr);
         }
 
         inline void Wait(unsigned int min_complete) {
@@ -138,11 +142,45 @@ namespace sharpen {
             this->Enter(0, min_complete, IORING_ENTER_GETEVENTS, sig);
         }
 
+        // return true if sring has a free entry
         bool Requestable() const;
 
+        // sq thread is sleeping and must be woken up by io_uring_enter
+        bool NeedWakeup() const noexcept;
+
+        bool HasCompletions() const noexcept;
+
+        // cqes overflowed from cring are kept by kernel
+        // until io_uring_enter is called with IORING_ENTER_GETEVENTS
+        bool CqOverflow() const noexcept;
+
+        inline void FlushOverflow() {
+            this->Enter(0, 0, IORING_ENTER_GETEVENTS);
+        }
+
+        inline bool IsSqPoll() const noexcept {
+            return this->setupFlags_ & IORING_SETUP_SQPOLL;
+        }
+
         void RegisterEventFd(const sharpen::EventFd &eventFd);
 
         void UnregisterEventFd();
+
+        // -1 means an empty slot
+        void RegisterFiles(const int *fds, unsigned int count);
+
+        void UpdateFiles(unsigned int offset, const int *fds, unsigned int count);
+
+        void RegisterBuffers(const struct iovec *bufs, unsigned int count);
+
+        void UnregisterBuffers();
+
+        // entries should be a power of 2
+        void RegisterBufRing(struct io_uring_buf_ring *ring,
+                             unsigned int entries,
+                             std::uint16_t group);
+
+        void UnregisterBufRing(std::uint16_t group);
     };
 }   // namespace sharpen
 
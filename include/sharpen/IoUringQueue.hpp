@@ -6,10 +6,13 @@
 
 #ifdef SHARPEN_HAS_IOURING
 
+#include "SpinLock.hpp"
 #include <deque>
 #include <vector>
 
 namespace sharpen {
+    struct IoUringStruct;
+
     class IoUringQueue {
     private:
         using Self = sharpen::IoUringQueue;
@@ -18,22 +21,100 @@ namespace sharpen {
         using CompletionQueue = std::vector<Cqe>;
         using SubmitQueue = std::deque<Sqe>;
 
-        static constexpr std::size_t queueLength_{64};
-
         static constexpr std::size_t reservedCqSize_{32};
 
+        // idle time of sq thread in milliseconds
+        static constexpr std::uint32_t sqThreadIdle_{1000};
+
+        // registered resources
+        static constexpr std::size_t maxCachedStructs_{256};
+        static constexpr std::size_t fixedFileCount_{64};
+        static constexpr std::size_t fixedBufferCount_{16};
+        static constexpr std::size_t fixedBufferSize_{64 * 1024};
+
+        // provided buffers of multishot recv
+        // the count should be a power of 2
+        static constexpr std::size_t recvBufferCount_{64};
+        static constexpr std::size_t recvBufferSize_{16 * 1024};
+        static constexpr std::uint16_t recvBufferGroup_{0};
+
+        enum class FixedStatus {
+            Uninitialized,
+            Enabled,
+            Unsupported
+        };
+
+        // how provided buffers are given to kernel
+        enum class RecvBufferMode {
+            Ring,
+            // IORING_OP_PROVIDE_BUFFERS
+            // used if buffer rings are registered but never selected
+            Provide,
+            Unsupported
+        };
+
         sharpen::EventFd eventFd_;
         sharpen::IoUring ring_;
         CompletionQueue compQueue_;
         SubmitQueue subQueue_;
-
+        // sqes in sring which have not been passed to io_uring_enter
+        std::size_t unflushed_;
+        // loop thread only
+        std::vector<sharpen::IoUringStruct *> structs_;
+        // registered files and buffers
+        // initialized when the first channel enables fixed io
+        FixedStatus fixedStatus_;
+        sharpen::SpinLock fixedLock_;
+        std::vector<int> fixedFiles_;
+        char *fixedBuffers_;
+        // loop thread only
+        std::vector<int> freeBuffers_;
+        // provided buffers
+        // initialized when the first channel uses multishot requests
+        FixedStatus recvStatus_;
+        sharpen::SpinLock recvLock_;
+        struct io_uring_buf_ring *recvRing_;
+        char *recvBuffers_;
+        std::uint16_t recvTail_;
+        // released buffers of Provide mode
+        // they are given back to kernel by Flush()
+        std::vector<std::uint16_t> releasedBuffers_;
+        // loop thread only
+        std::vector<std::uint16_t> providingBuffers_;
+        // cleared if the kernel rejects multishot recv
+        bool multishotRecv_;
+
+        bool InitFixedResources() noexcept;
+
+        bool InitRecvBuffers() noexcept;
+
+        // caller should hold recvLock_
+        void PushRecvBuffer(std::uint16_t bid) noexcept;
+
+        // submit released buffers of Provide mode
+        void ProvideRecvBuffers();
+
+        static RecvBufferMode TestRecvBufferMode() noexcept;
+
+        static RecvBufferMode GetRecvBufferMode() noexcept;
+
+        // move pending sqes to sring
         void Submit();
 
+        static bool TestSqPoll() noexcept;
+
+        static std::uint32_t GetSetupFlags(bool sqPoll) noexcept;
+
     public:
+        static constexpr std::uint32_t defaultQueueLength_{64};
+
         IoUringQueue();
 
         explicit IoUringQueue(bool blockEventFd);
 
+        // fall back to a normal ring if sq polling is not permitted
+        IoUringQueue(bool blockEventFd, std::uint32_t queueLength, bool sqPoll);
+
         ~IoUringQueue() noexcept;
 
         sharpen::EventFd &EventFd() noexcept {
@@ -44,9 +125,75 @@ namespace sharpen {
             return this->eventFd_;
         }
 
+        // the request is not submitted to kernel until Flush() is called
         void SubmitIoRequest(const Sqe &sqe);
 
+        // submit all queued sqes with a single io_uring_enter
+        void Flush();
+
+        // sqes left in sring when the kernel is busy
+        inline std::size_t GetUnflushedCount() const noexcept {
+            return this->unflushed_;
+        }
+
+        inline bool HasCompletions() const noexcept {
+            return !this->compQueue_.empty() || this->ring_.HasCompletions() ||
+                   this->ring_.CqOverflow();
+        }
+
+        inline bool IsSqPoll() const noexcept {
+            return this->ring_.IsSqPoll();
+        }
+
         std::size_t GetCompletionStatus(Cqe *cqes, std::size_t size);
+
+        // loop thread only
+        // reuse structs released by FreeStruct()
+        sharpen::IoUringStruct *AllocStruct() noexcept;
+
+        void FreeStruct(sharpen::IoUringStruct *st) noexcept;
+
+        // any thread
+        // return the index of registered file
+        // or -1 if the file table is full or not supported
+        int RegisterFile(sharpen::FileHandle handle) noexcept;
+
+        void UnregisterFile(int index) noexcept;
+
+        // loop thread only
+        // return nullptr if size is too large or no buffer is free
+        char *AllocFixedBuffer(std::size_t size, int &index) noexcept;
+
+        void FreeFixedBuffer(int index) noexcept;
+
+        char *GetFixedBuffer(int index) const noexcept;
+
+        // loop thread only
+        // multishot accept and recv require provided buffers
+        // return false if the kernel doesn't support buffer rings
+        bool SupportMultishot() noexcept;
+
+        inline bool SupportMultishotRecv() noexcept {
+            return this->multishotRecv_ && this->SupportMultishot();
+        }
+
+        inline void DisableMultishotRecv() noexcept {
+            this->multishotRecv_ = false;
+        }
+
+        inline std::uint16_t GetRecvBufferGroup() const noexcept {
+            return recvBufferGroup_;
+        }
+
+        char *GetRecvBuffer(std::uint16_t bid) const noexcept;
+
+        // any thread
+        // give the buffer back to kernel
+        void ReleaseRecvBuffer(std::uint16_t bid) noexcept;
+
+        // release the buffer or connection of a result
+        // whose channel has been released
+        void DropMultishotResult(const sharpen::IoUringStruct &st, const Cqe &cqe) noexcept;
     };
 
     extern bool TestIoUring() noexcept;
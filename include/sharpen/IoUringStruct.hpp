@@ -8,6 +8,7 @@
 
 #include "IoEvent.hpp"
 #include <sys/uio.h>
+#include <vector>
 
 namespace sharpen {
     struct IoUringStruct {
@@ -16,6 +17,18 @@ namespace sharpen {
         std::size_t length_;
         iovec vec_;
         sharpen::ChannelPtr channel_;
+        // index of registered buffer
+        // -1 if the request doesn't use registered buffer
+        int bufIndex_;
+        // buffers of vectored io
+        std::vector<iovec> vecs_;
+        // a multishot request completes many times
+        // its cqes of a round are reported by one event
+        bool multishot_;
+        std::vector<struct io_uring_cqe> results_;
+        // the channel of multishot request has been released
+        // the selector drops its results
+        bool orphan_;
     };
 }   // namespace sharpen
 #endif
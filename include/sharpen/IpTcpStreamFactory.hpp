@@ -16,6 +16,9 @@ namespace sharpen {
 
         virtual sharpen::NetStreamChannelPtr NviProduce(sharpen::TcpStreamOption opt) override;
 
+        virtual sharpen::NetStreamChannelPtr NviProduce(sharpen::TcpStreamOption opt,
+                                                        sharpen::EventLoop &loop) override;
+
     public:
         explicit IpTcpStreamFactory(const sharpen::IpEndPoint &endpoint);
 
@@ -15,6 +15,9 @@ namespace sharpen {
 
         virtual sharpen::NetStreamChannelPtr NviProduce(sharpen::TcpStreamOption opt) override;
 
+        virtual sharpen::NetStreamChannelPtr NviProduce(sharpen::TcpStreamOption opt,
+                                                        sharpen::EventLoop &loop) override;
+
     public:
         explicit Ipv6TcpStreamFactory(const sharpen::Ipv6EndPoint &endpoint);
 
@@ -0,0 +1,138 @@
+#pragma once
+#ifndef _SHARPEN_LOGSEGMENT_HPP
+#define _SHARPEN_LOGSEGMENT_HPP
+
+#include "ByteBuffer.hpp"
+#include "ByteSlice.hpp"
+#include "FileMemory.hpp"
+#include "IEventLoopGroup.hpp"
+#include "IFileChannel.hpp"
+#include "Noncopyable.hpp"
+#include "Nonmovable.hpp"
+#include "Optional.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace sharpen {
+    // a segment file of SegmentLogStorage
+    // entries of a segment have continuous indexes
+    // record:
+    // crc32 of rest (4 bytes) | body size (4 bytes) | tag (1 byte) | index (8 bytes) | entry
+    // the file is mapped with capacity bytes and read through the mapping
+    class LogSegment
+        : public sharpen::Noncopyable
+        , public sharpen::Nonmovable {
+    private:
+        using Self = sharpen::LogSegment;
+
+        // remember the offset of every sparseInterval_ entries
+        static constexpr std::size_t sparseInterval_{32};
+
+        std::string name_;
+        // nullptr if the segment has been sealed
+        sharpen::FileChannelPtr channel_;
+        std::unique_ptr<sharpen::FileMemory> memory_;
+        std::size_t capacity_;
+        std::uint64_t size_;
+        std::uint64_t beginIndex_;
+        std::uint64_t count_;
+        std::vector<std::uint64_t> sparse_;
+
+        const char *Data() const noexcept;
+
+        // return 0 if the record is torn or corrupted
+        std::size_t CheckRecord(std::uint64_t offset, std::uint64_t limit, bool verify) const
+            noexcept;
+
+        void IndexEntry(std::uint64_t offset);
+
+        std::uint64_t GetOffset(std::uint64_t index) const noexcept;
+
+    public:
+        static constexpr std::size_t headerSize_{17};
+
+        static constexpr std::uint8_t entryTag_{0};
+
+        // entries before the index have been dropped
+        static constexpr std::uint8_t dropTag_{1};
+
+        LogSegment(std::string name,
+                   sharpen::FileChannelPtr channel,
+                   std::uint64_t beginIndex,
+                   std::size_t capacity);
+
+        ~LogSegment() noexcept = default;
+
+        inline const Self &Const() const noexcept {
+            return *this;
+        }
+
+        static std::size_t ComputeRecordSize(std::size_t entrySize) noexcept;
+
+        // buf should have ComputeRecordSize(entry.GetSize()) bytes
+        static void WriteRecord(char *buf,
+                                std::uint8_t tag,
+                                std::uint64_t index,
+                                sharpen::ByteSlice entry) noexcept;
+
+        // scan records and truncate the tail since the first bad record
+        // checksums are verified only if verify is true
+        // return false if the file has been truncated
+        bool Load(bool verify, std::uint64_t &dropIndex);
+
+        // buf should contain complete records
+        void Append(const char *buf, std::size_t size);
+
+        void Flush();
+
+        sharpen::Optional<sharpen::ByteBuffer> Lookup(std::uint64_t index) const;
+
+        // remove entries >= index
+        // the segment should not be sealed
+        void TruncateFrom(std::uint64_t index);
+
+        // reopen a sealed segment
+        void Unseal(sharpen::IEventLoopGroup &loopGroup);
+
+        // close the file
+        // the mapping is still readable
+        void Seal() noexcept;
+
+        // close and delete the file
+        void Remove() noexcept;
+
+        inline bool Sealed() const noexcept {
+            return !this->channel_;
+        }
+
+        inline bool Writable(std::size_t size) const noexcept {
+            return this->size_ + size <= this->capacity_;
+        }
+
+        inline std::uint64_t GetBeginIndex() const noexcept {
+            return this->beginIndex_;
+        }
+
+        // index of next entry
+        inline std::uint64_t GetEndIndex() const noexcept {
+            return this->beginIndex_ + this->count_;
+        }
+
+        inline std::uint64_t GetCount() const noexcept {
+            return this->count_;
+        }
+
+        inline bool Empty() const noexcept {
+            return !this->count_;
+        }
+
+        inline std::uint64_t GetSize() const noexcept {
+            return this->size_;
+        }
+    };
+}   // namespace sharpen
+
+#endif
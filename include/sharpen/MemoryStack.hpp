@@ -9,12 +9,20 @@
 #include <cstring>
 
 namespace sharpen {
+    enum class StackAllocMethod {
+        // calloc a zeroed stack for every fiber
+        Heap,
+        // reuse mmap stacks with a guard page from thread local free lists
+        Pooled
+    };
+
     class MemoryStack : public sharpen::Noncopyable {
     private:
         using Self = sharpen::MemoryStack;
 
         void *mem_;
         std::size_t size_;
+        sharpen::StackAllocMethod method_;
 
         inline static void *Alloc(std::size_t size) noexcept {
             return std::calloc(size, sizeof(char));
@@ -29,12 +37,18 @@ namespace sharpen {
 
         MemoryStack(void *mem, std::size_t size) noexcept;
 
+        MemoryStack(void *mem, std::size_t size, sharpen::StackAllocMethod method) noexcept;
+
         MemoryStack(Self &&other) noexcept;
 
         ~MemoryStack() noexcept;
 
         static sharpen::MemoryStack AllocStack(std::size_t size);
 
+        // pooled stacks are rounded up to a power of two pages
+        // and the memory is not zeroed
+        static sharpen::MemoryStack AllocStack(std::size_t size, sharpen::StackAllocMethod method);
+
         void *Top() const noexcept;
 
         inline void *Bottom() const noexcept {
@@ -45,6 +59,10 @@ namespace sharpen {
             return this->size_;
         }
 
+        inline sharpen::StackAllocMethod GetAllocMethod() const noexcept {
+            return this->method_;
+        }
+
         void Release() noexcept;
 
         Self &operator=(Self &&other) noexcept;
@@ -69,4 +87,4 @@ namespace sharpen {
     };
 }   // namespace sharpen
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,80 @@
+#pragma once
+#ifndef _SHARPEN_MEMORYSTACKPOOL_HPP
+#define _SHARPEN_MEMORYSTACKPOOL_HPP
+
+#include "Noncopyable.hpp"
+#include "Nonmovable.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace sharpen {
+    // thread local cache of fiber stacks
+    // every stack is mapped with a PROT_NONE guard page below the bottom
+    // pages are committed by the kernel when they are touched
+    class MemoryStackPool
+        : public sharpen::Noncopyable
+        , public sharpen::Nonmovable {
+    private:
+        using Self = sharpen::MemoryStackPool;
+        using FreeList = std::vector<void *>;
+
+        enum class PoolState : std::uint8_t {
+            Uninitialized,
+            Alive,
+            Destroyed
+        };
+
+        static constexpr std::size_t pageSize_{4096};
+
+        // size classes are 16kb,32kb,...,1mb
+        static constexpr std::size_t minClassPages_{4};
+        static constexpr std::size_t classCount_{7};
+
+        // max bytes cached by one size class
+        static constexpr std::size_t maxCachedBytes_{4 * 1024 * 1024};
+        static constexpr std::size_t minCachedStacks_{4};
+
+        thread_local static PoolState state_;
+
+        FreeList freeLists_[classCount_];
+
+        static std::size_t GetClassSize(std::size_t index) noexcept;
+
+        static std::size_t GetMaxCachedStacks(std::size_t index) noexcept;
+
+        // return classCount_ if size is too large to be cached
+        static std::size_t GetClassIndex(std::size_t size) noexcept;
+
+        static void *MapStack(std::size_t size) noexcept;
+
+        static void UnmapStack(void *mem, std::size_t size) noexcept;
+
+        MemoryStackPool();
+
+    public:
+        ~MemoryStackPool() noexcept;
+
+        // round size up to the size of stack which will be allocated
+        static std::size_t RoundStackSize(std::size_t size) noexcept;
+
+        // size should be rounded by RoundStackSize()
+        void *Alloc(std::size_t size) noexcept;
+
+        void Free(void *mem, std::size_t size) noexcept;
+
+        void Clear() noexcept;
+
+        std::size_t GetCachedCount() const noexcept;
+
+        static sharpen::MemoryStackPool &GetLocalPool();
+
+        // map a new stack if the pool of current thread has been destroyed
+        static void *AllocFromLocalPool(std::size_t size);
+
+        // free a stack without initializing the pool of current thread
+        static void FreeToLocalPool(void *mem, std::size_t size) noexcept;
+    };
+}   // namespace sharpen
+
+#endif
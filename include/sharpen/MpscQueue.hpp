@@ -0,0 +1,198 @@
+#pragma once
+#ifndef _SHARPEN_MPSCQUEUE_HPP
+#define _SHARPEN_MPSCQUEUE_HPP
+
+#include "Noncopyable.hpp"
+#include "Nonmovable.hpp"
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace sharpen {
+    // intrusive unbounded multi-producer single-consumer queue (Vyukov)
+    // items are stored in nodes taken from a preallocated pool
+    // the queue falls back to the heap when the pool runs out
+    template<typename _T>
+    class MpscQueue
+        : public sharpen::Noncopyable
+        , public sharpen::Nonmovable {
+    private:
+        using Self = sharpen::MpscQueue<_T>;
+        using Storage = typename std::aligned_storage<sizeof(_T), alignof(_T)>::type;
+
+        struct Node {
+            std::atomic<Node *> next_;
+            // the next free node (index + 1)
+            std::atomic<std::uint32_t> nextFree_;
+            Storage value_;
+
+            Node() noexcept
+                : next_(nullptr)
+                , nextFree_(0)
+                , value_() {
+            }
+
+            inline _T &Value() noexcept {
+                return *reinterpret_cast<_T *>(&this->value_);
+            }
+        };
+
+        static constexpr std::size_t cacheLineSize_{64};
+
+        // consumer side
+        Node *head_;
+        char pad_[cacheLineSize_ - sizeof(Node *)];
+        // producer side
+        std::atomic<Node *> tail_;
+        // tag (high 32 bits) and index + 1 (low 32 bits) of the first free node
+        std::atomic<std::uint64_t> free_;
+        Node stub_;
+        std::unique_ptr<Node[]> pool_;
+        std::uint32_t poolSize_;
+
+        inline static std::uint32_t GetIndex(std::uint64_t word) noexcept {
+            return static_cast<std::uint32_t>(word);
+        }
+
+        inline static std::uint64_t MakeFreeWord(std::uint64_t word, std::uint32_t index) noexcept {
+            // bump the tag to avoid ABA
+            return (((word >> 32) + 1) << 32) | index;
+        }
+
+        inline bool IsPooled(const Node *node) const noexcept {
+            return node >= this->pool_.get() && node < this->pool_.get() + this->poolSize_;
+        }
+
+        Node *AllocateNode() {
+            std::uint64_t word{this->free_.load(std::memory_order_acquire)};
+            while (Self::GetIndex(word)) {
+                Node *node{this->pool_.get() + Self::GetIndex(word) - 1};
+                std::uint32_t next{node->nextFree_.load(std::memory_order_relaxed)};
+                if (this->free_.compare_exchange_weak(word,
+                                                      Self::MakeFreeWord(word, next),
+                                                      std::memory_order_acquire,
+                                                      std::memory_order_acquire)) {
+                    return node;
+                }
+            }
+            Node *node{new (std::nothrow) Node{}};
+            if (!node) {
+                throw std::bad_alloc{};
+            }
+            return node;
+        }
+
+        void FreeNode(Node *node) noexcept {
+            if (!this->IsPooled(node)) {
+                delete node;
+                return;
+            }
+            std::uint32_t index{static_cast<std::uint32_t>(node - this->pool_.get()) + 1};
+            std::uint64_t word{this->free_.load(std::memory_order_relaxed)};
+            do {
+                node->nextFree_.store(Self::GetIndex(word), std::memory_order_relaxed);
+            } while (!this->free_.compare_exchange_weak(word,
+                                                        Self::MakeFreeWord(word, index),
+                                                        std::memory_order_release,
+                                                        std::memory_order_relaxed));
+        }
+
+        inline void PushNode(Node *node) noexcept {
+            node->next_.store(nullptr, std::memory_order_relaxed);
+            Node *prev{this->tail_.exchange(node, std::memory_order_acq_rel)};
+            // the consumer cannot see the node until it has been linked
+            prev->next_.store(node, std::memory_order_release);
+        }
+
+        Node *PopNode() noexcept {
+            Node *head{this->head_};
+            Node *next{head->next_.load(std::memory_order_acquire)};
+            if (head == &this->stub_) {
+                if (!next) {
+                    return nullptr;
+                }
+                this->head_ = next;
+                head = next;
+                next = next->next_.load(std::memory_order_acquire);
+            }
+            if (next) {
+                this->head_ = next;
+                return head;
+            }
+            if (head != this->tail_.load(std::memory_order_acquire)) {
+                // a producer is linking a node
+                return nullptr;
+            }
+            this->PushNode(&this->stub_);
+            next = head->next_.load(std::memory_order_acquire);
+            if (next) {
+                this->head_ = next;
+                return head;
+            }
+            return nullptr;
+        }
+
+    public:
+        explicit MpscQueue(std::size_t poolSize)
+            : head_(nullptr)
+            , pad_()
+            , tail_(nullptr)
+            , free_(0)
+            , stub_()
+            , pool_(nullptr)
+            , poolSize_(static_cast<std::uint32_t>(poolSize)) {
+            assert(poolSize <= UINT32_MAX - 1);
+            this->head_ = &this->stub_;
+            this->tail_.store(&this->stub_, std::memory_order_relaxed);
+            if (poolSize) {
+                this->pool_.reset(new (std::nothrow) Node[poolSize]);
+                if (!this->pool_) {
+                    throw std::bad_alloc{};
+                }
+                for (std::uint32_t i = 0; i != this->poolSize_; ++i) {
+                    this->FreeNode(this->pool_.get() + i);
+                }
+            }
+        }
+
+        ~MpscQueue() noexcept {
+            _T value;
+            while (this->TryPop(value)) {
+            }
+        }
+
+        // thread-safe
+        template<typename... _Args>
+        inline void Push(_Args &&...args) {
+            Node *node{this->AllocateNode()};
+            try {
+                new (&node->value_) _T(std::forward<_Args>(args)...);
+            } catch (...) {
+                this->FreeNode(node);
+                throw;
+            }
+            this->PushNode(node);
+        }
+
+        // consumer only
+        // return false if the queue is empty
+        // or the next item is still being pushed
+        inline bool TryPop(_T &value) noexcept {
+            Node *node{this->PopNode()};
+            if (!node) {
+                return false;
+            }
+            value = std::move(node->Value());
+            node->Value().~_T();
+            this->FreeNode(node);
+            return true;
+        }
+    };
+}   // namespace sharpen
+
+#endif
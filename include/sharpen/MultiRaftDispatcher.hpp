@@ -0,0 +1,106 @@
+#pragma once
+#ifndef _SHARPEN_MULTIRAFTDISPATCHER_HPP
+#define _SHARPEN_MULTIRAFTDISPATCHER_HPP
+
+#include "IConsensus.hpp"
+#include "IFiberScheduler.hpp"
+#include "IWorkerGroup.hpp"
+#include "Noncopyable.hpp"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace sharpen {
+    // routes requests of multi-raft mails to the raft groups of this node
+    // batch requests are split and answered by a batch response
+    // groups are sharded across workers by raft number
+    // so that requests of a group are answered in order
+    // and requests of different groups are answered concurrently
+    class MultiRaftDispatcher : public sharpen::Noncopyable {
+    private:
+        using Self = sharpen::MultiRaftDispatcher;
+        using GroupMap = std::unordered_map<std::uint32_t, std::shared_ptr<sharpen::IConsensus>>;
+        using Callback = std::function<void(sharpen::Mail)>;
+
+        struct BatchState {
+            std::uint32_t sequence_;
+            std::vector<sharpen::Mail> mails_;
+            std::atomic_size_t remain_;
+            Callback cb_;
+        };
+
+        std::uint32_t magic_;
+        GroupMap groups_;
+        std::vector<std::unique_ptr<sharpen::IWorkerGroup>> shards_;
+
+        sharpen::Mail DoGenerateResponse(sharpen::Mail request);
+
+        sharpen::IWorkerGroup &GetShard(std::uint32_t raftNumber) noexcept;
+
+        sharpen::Mail DoRespond(std::uint32_t raftNumber, sharpen::Mail request);
+
+        void DoDispatch(std::uint32_t raftNumber, sharpen::Mail request, Callback cb) noexcept;
+
+        void DoDispatchBatch(std::shared_ptr<BatchState> state,
+                             std::size_t index,
+                             std::uint32_t raftNumber) noexcept;
+
+        void CompleteBatch(BatchState &state, std::size_t count) noexcept;
+
+        bool DispatchBatch(sharpen::Mail request, Callback cb);
+
+    public:
+        explicit MultiRaftDispatcher(std::uint32_t magic);
+
+        MultiRaftDispatcher(sharpen::IFiberScheduler &scheduler,
+                            std::uint32_t magic,
+                            std::size_t shardCount);
+
+        MultiRaftDispatcher(Self &&other) noexcept = default;
+
+        Self &operator=(Self &&other) noexcept = default;
+
+        ~MultiRaftDispatcher() noexcept = default;
+
+        inline const Self &Const() const noexcept {
+            return *this;
+        }
+
+        inline std::uint32_t GetMagic() const noexcept {
+            return this->magic_;
+        }
+
+        inline std::size_t GetSize() const noexcept {
+            return this->groups_.size();
+        }
+
+        // groups must not be registered or removed
+        // while the dispatcher is generating responses
+        void Register(std::uint32_t raftNumber, std::shared_ptr<sharpen::IConsensus> raft);
+
+        void Remove(std::uint32_t raftNumber) noexcept;
+
+        sharpen::IConsensus *Lookup(std::uint32_t raftNumber) const noexcept;
+
+        // returns an empty mail if the request could not be routed
+        sharpen::Mail GenerateResponse(sharpen::Mail request);
+
+        inline std::size_t GetShardCount() const noexcept {
+            return this->shards_.size();
+        }
+
+        // answers the request on the shard of its group
+        // the callback is called by the shard
+        // a request of a single group is answered by a response of the group
+        // or by a placeholder that carries the raft number
+        // a batch request is answered by a batch response with the same sequence
+        // returns false if the request is not a multi-raft request
+        // and the callback will not be called
+        bool GenerateResponseAsync(sharpen::Mail request, Callback cb);
+    };
+}   // namespace sharpen
+
+#endif
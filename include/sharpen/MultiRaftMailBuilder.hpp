@@ -67,6 +67,32 @@ namespace sharpen {
 
         virtual sharpen::Mail BuildSnapshotResponse(
             const sharpen::RaftSnapshotResponse &response) const override;
+
+        virtual sharpen::Mail BuildLearnLogsRequest(
+            const sharpen::RaftLearnLogsRequest &request) const override;
+
+        virtual sharpen::Mail BuildLearnLogsResponse(
+            const sharpen::RaftLearnLogsResponse &response) const override;
+
+        virtual sharpen::Mail BuildLearnSnapshotRequest(
+            const sharpen::RaftLearnSnapshotRequest &request) const override;
+
+        virtual sharpen::Mail BuildLearnSnapshotResponse(
+            const sharpen::RaftLearnSnapshotResponse &response) const override;
+
+        // packs the mails of multiple groups into one mail
+        // the raft number of the batch is the sequence of the batch
+        // a batch response carries the sequence of its request
+        // empty mails are packed as header-only mails with an empty form
+        static sharpen::Mail BuildBatch(std::uint32_t magic,
+                                        sharpen::RaftMailType type,
+                                        std::uint32_t sequence,
+                                        const sharpen::Mail *const *mails,
+                                        std::size_t size);
+
+        // an empty response of a group
+        // it carries the raft number so that the requester could correlate it
+        static sharpen::Mail BuildPlaceholder(std::uint32_t magic, std::uint32_t raftNumber);
     };
 }   // namespace sharpen
 
@@ -6,6 +6,7 @@
 #include "RaftMailType.hpp"
 #include <cstddef>
 #include <cstdint>
+#include <vector>
 
 namespace sharpen {
     class MultiRaftMailExtractor : public sharpen::IRaftMailExtractor {
@@ -46,6 +47,18 @@ namespace sharpen {
         virtual sharpen::Optional<sharpen::RaftSnapshotResponse> NviExtractSnapshotResponse(
             const sharpen::Mail &mail) const noexcept override;
 
+        virtual sharpen::Optional<sharpen::RaftLearnLogsRequest> NviExtractLearnLogsRequest(
+            const sharpen::Mail &mail) const noexcept override;
+
+        virtual sharpen::Optional<sharpen::RaftLearnLogsResponse> NviExtractLearnLogsResponse(
+            const sharpen::Mail &mail) const noexcept override;
+
+        virtual sharpen::Optional<sharpen::RaftLearnSnapshotRequest> NviExtractLearnSnapshotRequest(
+            const sharpen::Mail &mail) const noexcept override;
+
+        virtual sharpen::Optional<sharpen::RaftLearnSnapshotResponse>
+        NviExtractLearnSnapshotResponse(const sharpen::Mail &mail) const noexcept override;
+
     public:
         MultiRaftMailExtractor(std::uint32_t magic, std::uint32_t raftNumber) noexcept;
 
@@ -68,6 +81,32 @@ namespace sharpen {
         inline const Self &Const() const noexcept {
             return *this;
         }
+
+        inline static bool IsBatchType(sharpen::RaftMailType type) noexcept {
+            return type == sharpen::RaftMailType::BatchRequest ||
+                   type == sharpen::RaftMailType::BatchResponse;
+        }
+
+        // returns the raft number of a mail that belongs to a single group
+        static sharpen::Optional<std::uint32_t> LookupRaftNumber(
+            std::uint32_t magic, const sharpen::Mail &mail) noexcept;
+
+        // returns the raft number of a mail built by MultiRaftMailBuilder::BuildPlaceholder
+        static sharpen::Optional<std::uint32_t> LookupPlaceholder(
+            std::uint32_t magic, const sharpen::Mail &mail) noexcept;
+
+        static bool IsBatchMail(std::uint32_t magic,
+                                sharpen::RaftMailType type,
+                                const sharpen::Mail &mail) noexcept;
+
+        // returns the sequence of a batch mail
+        static sharpen::Optional<std::uint32_t> LookupBatchSequence(
+            std::uint32_t magic, sharpen::RaftMailType type, const sharpen::Mail &mail) noexcept;
+
+        // unpacks a mail built by MultiRaftMailBuilder::BuildBatch
+        // returns empty if the batch is corrupted
+        static sharpen::Optional<std::vector<sharpen::Mail>> ExtractBatch(
+            std::uint32_t magic, sharpen::RaftMailType type, const sharpen::Mail &mail);
     };
 }   // namespace sharpen
 
@@ -0,0 +1,74 @@
+#pragma once
+#ifndef _SHARPEN_MULTIRAFTSTEP_HPP
+#define _SHARPEN_MULTIRAFTSTEP_HPP
+
+#include "AsyncMutex.hpp"
+#include "AsyncSemaphore.hpp"
+#include "IHostPipelineStep.hpp"
+#include "IMailParser.hpp"
+#include "IMailParserFactory.hpp"
+#include "MultiRaftDispatcher.hpp"
+#include <atomic>
+#include <memory>
+
+namespace sharpen {
+    // serves the multi-raft mails of a connection
+    // requests are answered by the shards of the dispatcher concurrently
+    // and responses are written back in completion order
+    // a response of a group is correlated by its raft number
+    // because requests of a group are answered in order
+    // a batch response is correlated by the sequence of the batch
+    class MultiRaftStep : public sharpen::IHostPipelineStep {
+    private:
+        using Self = sharpen::MultiRaftStep;
+
+        // the number of requests a connection could have in flight
+        static constexpr std::size_t defaultWindowSize_{64};
+
+        struct ChannelState {
+            ChannelState(sharpen::INetStreamChannel &channel, std::size_t windowSize);
+
+            sharpen::INetStreamChannel *channel_;
+            sharpen::AsyncMutex writeLock_;
+            sharpen::AsyncSemaphore window_;
+            std::atomic_bool broken_;
+        };
+
+        std::unique_ptr<sharpen::IMailParserFactory> factory_;
+        std::shared_ptr<sharpen::MultiRaftDispatcher> dispatcher_;
+        std::size_t windowSize_;
+
+        static std::size_t DoRead(sharpen::INetStreamChannel &channel,
+                                  sharpen::IMailParser &parser,
+                                  sharpen::ByteBuffer &buffer) noexcept;
+
+        static void WriteResponse(ChannelState *state, sharpen::Mail response) noexcept;
+
+        bool Dispatch(ChannelState &state, sharpen::IMailParser &parser) noexcept;
+
+    public:
+        explicit MultiRaftStep(std::shared_ptr<sharpen::MultiRaftDispatcher> dispatcher) noexcept;
+
+        MultiRaftStep(std::shared_ptr<sharpen::MultiRaftDispatcher> dispatcher,
+                      std::size_t windowSize) noexcept;
+
+        MultiRaftStep(Self &&other) noexcept = default;
+
+        Self &operator=(Self &&other) noexcept = default;
+
+        virtual ~MultiRaftStep() noexcept = default;
+
+        inline const Self &Const() const noexcept {
+            return *this;
+        }
+
+        inline std::size_t GetWindowSize() const noexcept {
+            return this->windowSize_;
+        }
+
+        virtual sharpen::HostPipelineResult Consume(
+            sharpen::INetStreamChannel &channel, const std::atomic_bool &active) noexcept override;
+    };
+}   // namespace sharpen
+
+#endif
\ No newline at end of file
@@ -0,0 +1,83 @@
+#pragma once
+#ifndef _SHARPEN_MULTIPLEXEDACTOR_HPP
+#define _SHARPEN_MULTIPLEXEDACTOR_HPP
+
+#include "Future.hpp"
+#include "IMailReceiver.hpp"
+#include "IRemoteActor.hpp"
+#include "Noncopyable.hpp"
+#include "Nonmovable.hpp"
+#include "SpinLock.hpp"
+#include "TcpMultiplexer.hpp"
+
+namespace sharpen {
+    // an actor of one raft group
+    // posts mails through a connection shared with other groups
+    class MultiplexedActor
+        : public sharpen::IRemoteActor
+        , public sharpen::Noncopyable
+        , public sharpen::Nonmovable {
+    private:
+        using Self = sharpen::MultiplexedActor;
+
+        // shared with the callbacks of in-flight mails
+        // the multiplexer may call them after the actor has been destroyed
+        struct State {
+            sharpen::SpinLock lock_;
+            // null if the actor has been destroyed
+            sharpen::IMailReceiver *receiver_;
+            sharpen::ActorId id_;
+            std::atomic_size_t ackCount_;
+            // responses of older generations are not acked
+            std::size_t generation_;
+            // callbacks which are calling the receiver
+            std::size_t receiving_;
+            // completed by the last receiving callback after detaching
+            sharpen::Future<void> *detached_;
+        };
+
+        std::atomic_size_t postCount_;
+        std::shared_ptr<State> state_;
+        std::shared_ptr<sharpen::TcpMultiplexer> multiplexer_;
+
+        inline virtual sharpen::ActorId NviGetId() const noexcept override {
+            assert(this->multiplexer_);
+            return this->multiplexer_->GetId();
+        }
+
+        virtual void NviPost(sharpen::Mail mail) override;
+
+        virtual void NviPostShared(const sharpen::Mail &mail) override;
+
+        static void DoReceive(const std::shared_ptr<State> &state,
+                              std::size_t generation,
+                              sharpen::Mail response) noexcept;
+
+    public:
+        MultiplexedActor(sharpen::IMailReceiver &receiver,
+                         std::shared_ptr<sharpen::TcpMultiplexer> multiplexer);
+
+        virtual ~MultiplexedActor() noexcept;
+
+        inline const Self &Const() const noexcept {
+            return *this;
+        }
+
+        virtual sharpen::RemoteActorStatus GetStatus() const noexcept override;
+
+        // in-flight mails are detached instead of closing the shared connection
+        // so that other groups are not affected
+        virtual void Cancel() noexcept override;
+
+        // the owner of the multiplexer closes the shared connection
+        virtual void Close() noexcept override;
+
+        virtual std::size_t GetPipelineCount() const noexcept override;
+
+        virtual void Drain() noexcept override;
+
+        virtual bool SupportPipeline() const noexcept override;
+    };
+}   // namespace sharpen
+
+#endif
@@ -0,0 +1,54 @@
+#pragma once
+#ifndef _SHARPEN_MULTIPLEXEDACTORBUILDER_HPP
+#define _SHARPEN_MULTIPLEXEDACTORBUILDER_HPP
+
+#include "IMailReceiver.hpp"
+#include "IRemoteActor.hpp"
+#include "IRemoteActorBuilder.hpp"
+#include "TcpMultiplexer.hpp"
+#include <stdexcept>
+
+namespace sharpen {
+    // builds actors which share the connection of the multiplexer
+    class MultiplexedActorBuilder : public sharpen::IRemoteActorBuilder {
+    private:
+        using Self = sharpen::MultiplexedActorBuilder;
+
+        std::shared_ptr<sharpen::TcpMultiplexer> multiplexer_;
+        sharpen::IMailReceiver *receiver_;
+
+        void EnsureConfiguration() const;
+
+        virtual std::unique_ptr<sharpen::IRemoteActor> NviBuild() const override;
+
+        virtual std::shared_ptr<sharpen::IRemoteActor> NviBuildShared() const override;
+
+    public:
+        explicit MultiplexedActorBuilder(
+            std::shared_ptr<sharpen::TcpMultiplexer> multiplexer) noexcept;
+
+        MultiplexedActorBuilder(const Self &other) = default;
+
+        MultiplexedActorBuilder(Self &&other) noexcept;
+
+        inline Self &operator=(const Self &other) {
+            if (this != std::addressof(other)) {
+                Self tmp{other};
+                std::swap(tmp, *this);
+            }
+            return *this;
+        }
+
+        Self &operator=(Self &&other) noexcept;
+
+        virtual ~MultiplexedActorBuilder() noexcept = default;
+
+        inline const Self &Const() const noexcept {
+            return *this;
+        }
+
+        void PrepareReceiver(sharpen::IMailReceiver &receiver) noexcept;
+    };
+}   // namespace sharpen
+
+#endif
@@ -18,6 +18,15 @@ namespace sharpen {
         Tcp,
         Udp
     };
+
+    // how stream sockets are driven on posix
+    // windows always uses iocp
+    enum class NetIoMethod {
+        // edge-triggered epoll and readv/writev
+        Readiness,
+        // io_uring requests, fall back to Readiness if io_uring is unavailable
+        Completion
+    };
 }   // namespace sharpen
 
 #endif
\ No newline at end of file
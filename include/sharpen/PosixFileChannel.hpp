@@ -10,6 +10,8 @@
 
 #include "IFileChannel.hpp"
 #include "IoUringQueue.hpp"
+#include <sys/uio.h>
+#include <vector>
 
 #ifdef SHARPEN_HAS_IOURING
 #include "IoUringStruct.hpp"
@@ -51,6 +53,14 @@ namespace sharpen {
                      std::uint64_t offset,
                      sharpen::Future<std::size_t> *future);
 
+        void NormalWriteVector(const std::vector<iovec> &bufs,
+                               std::uint64_t offset,
+                               sharpen::Future<std::size_t> *future);
+
+        void DoWriteVector(std::vector<iovec> &bufs,
+                           std::uint64_t offset,
+                           sharpen::Future<std::size_t> *future);
+
         void DoAllocate(std::uint64_t offset,
                         std::size_t size,
                         sharpen::Future<std::size_t> *future);
@@ -67,19 +77,26 @@ namespace sharpen {
 
         sharpen::IoUringStruct *InitStruct(sharpen::Future<void> *future);
 
+        void SetFileOfSqe(struct io_uring_sqe &sqe) const noexcept;
+
+        void CloseRegistered(sharpen::FileHandle handle) noexcept;
+
         sharpen::IoUringQueue *queue_;
+        // index of registered file
+        // -1 if the channel doesn't use registered io
+        int fixedFile_;
 #endif
 
-        void NormalFlush(sharpen::Future<void> *future);
+        void NormalFlush(sharpen::Future<void> *future, bool dataOnly);
 
-        void DoFlush(sharpen::Future<void> *future);
+        void DoFlush(sharpen::Future<void> *future, bool dataOnly);
 
         bool syncWrite_;
 
     public:
         explicit PosixFileChannel(sharpen::FileHandle handle, bool syncWrite);
 
-        virtual ~PosixFileChannel() noexcept = default;
+        virtual ~PosixFileChannel() noexcept;
 
         virtual void WriteAsync(const char *buf,
                                 std::size_t bufSize,
@@ -91,6 +108,14 @@ namespace sharpen {
                                 std::uint64_t offset,
                                 sharpen::Future<std::size_t> &future) override;
 
+        using MyBase::WriteVectorAsync;
+
+        // write all buffers by one pwritev()
+        virtual void WriteVectorAsync(const sharpen::ByteSlice *slices,
+                                      std::size_t count,
+                                      std::uint64_t offset,
+                                      sharpen::Future<std::size_t> &future) override;
+
         virtual void ReadAsync(char *buf,
                                std::size_t bufSize,
                                std::uint64_t offset,
@@ -117,6 +142,8 @@ namespace sharpen {
 
         virtual void FlushAsync(sharpen::Future<void> &future) override;
 
+        virtual void FlushDataAsync(sharpen::Future<void> &future) override;
+
         virtual void AllocateAsync(sharpen::Future<std::size_t> &future,
                                    std::uint64_t offset,
                                    std::size_t size) override;
@@ -126,6 +153,10 @@ namespace sharpen {
                                      std::size_t size) override;
 
         virtual std::size_t GetPath(SHARPEN_OUT char *path, std::size_t size) const override;
+
+        // writes and reads which fit in a registered buffer use
+        // IORING_OP_WRITE_FIXED and IORING_OP_READ_FIXED
+        virtual bool EnableRegisteredIo() override;
     };
 
 }   // namespace sharpen
@@ -10,6 +10,9 @@ namespace sharpen {
     class PosixIoWriter : public sharpen::IPosixIoOperator {
     private:
         using Mybase = sharpen::IPosixIoOperator;
+        using Self = sharpen::PosixIoWriter;
+
+        static void CompletePartialTask(Callback cb, std::size_t written, ssize_t size);
 
     protected:
         virtual void NviExecute(sharpen::FileHandle handle,
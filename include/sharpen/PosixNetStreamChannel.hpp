@@ -9,10 +9,15 @@
 #define SHARPEN_HAS_POSIXSOCKET
 
 #include "INetStreamChannel.hpp"
+#include "IoUringStruct.hpp"
 #include "PosixIoReader.hpp"
 #include "PosixIoWriter.hpp"
+#include "SpinLock.hpp"
+#include <sys/socket.h>
 #include <sys/uio.h>
 #include <atomic>
+#include <deque>
+#include <memory>
 #include <vector>
 
 namespace sharpen {
@@ -49,6 +54,183 @@ namespace sharpen {
         ConnectCallback connectCb_;
         Callbacks pollReadCbs_;
         Callbacks pollWriteCbs_;
+#ifdef SHARPEN_IS_LINUX
+        // a sendfile() or a write which is issued after it
+        // writes wait for previous sendfiles to keep the order of stream
+        struct SendFileTask {
+            // -1 if it is a write
+            sharpen::FileHandle file_;
+            std::uint64_t offset_;
+            std::size_t size_;
+            std::size_t written_;
+            // use splice() if the file doesn't support sendfile()
+            bool splice_;
+            std::vector<iovec> bufs_;
+            Callback cb_;
+        };
+
+        using SendFileTasks = std::deque<SendFileTask>;
+
+        // readiness mode only
+        SendFileTasks sendFiles_;
+
+        // return the size of sent bytes, 0 if reach the end of file
+        // or -1 if fail to send
+        ssize_t SendFile(SendFileTask &task) noexcept;
+
+        // invoke the callback with the sent size if some bytes were sent
+        static void CompleteSendFile(SendFileTask &task, ssize_t size);
+
+        // send the first task of sendFiles_
+        // return false if the socket is blocking
+        bool DoSendFile();
+
+        void TrySendFile(sharpen::FileHandle handle,
+                         std::uint64_t offset,
+                         std::size_t size,
+                         Callback cb);
+
+        // queue a write after previous sendfiles
+        void DeferWrite(std::vector<iovec> bufs, Callback cb);
+#endif
+#ifdef SHARPEN_HAS_IOURING
+        // completion mode
+        // the request holds the channel until its cqe arrives
+        struct UringRequest : public sharpen::IoUringStruct {
+            Callback cb_;
+            // address of connect
+            std::unique_ptr<struct sockaddr_storage> addr_;
+            // message of vectored write
+            struct msghdr msg_;
+        };
+
+        // data received by multishot recv
+        struct UringChunk {
+            std::uint16_t bid_;
+            std::size_t size_;
+            std::size_t offset_;
+        };
+
+        struct UringTask {
+            char *buf_;
+            std::size_t bufSize_;
+            Callback cb_;
+            // buffers of vectored write
+            std::vector<iovec> vecs_;
+            // file of sendfile()
+            std::shared_ptr<SendFileTask> file_;
+        };
+
+        using UringTasks = std::deque<UringTask>;
+        using UringRequests = std::vector<UringRequest *>;
+        using UringChunks = std::deque<UringChunk>;
+        using AcceptCallbacks = std::deque<AcceptCallback>;
+        using AcceptedHandles = std::deque<sharpen::FileHandle>;
+
+        // provided buffers a channel could hold
+        // before its multishot recv is stopped
+        static constexpr std::size_t maxUringChunks_{4};
+        // connections a listener could hold
+        // before its multishot accept is stopped
+        static constexpr std::size_t maxAcceptedHandles_{16};
+
+        // nullptr if the channel uses readiness mode
+        sharpen::IoUringQueue *queue_;
+        // only one read and one write are submitted at a time
+        // to keep the order of stream
+        UringTasks uringReads_;
+        UringTasks uringWrites_;
+        bool uringReading_;
+        bool uringWriting_;
+        // submitted requests
+        UringRequests uringRequests_;
+        // multishot requests
+        // nullptr if they are not submitted
+        // they don't hold the channel
+        // and are released by loop if the channel is released
+        sharpen::IoUringStruct *recvRequest_;
+        sharpen::IoUringStruct *acceptRequest_;
+        bool recvCanceled_;
+        bool acceptCanceled_;
+        // received data which has not been read
+        UringChunks uringChunks_;
+        // the peer closed the stream or multishot recv failed
+        bool recvEnd_;
+        sharpen::ErrorCode recvError_;
+        // provided buffers were exhausted
+        // the next read uses the buffer of caller
+        bool recvNoBuffer_;
+        AcceptCallbacks uringAccepts_;
+        // accepted connections which have not been taken
+        AcceptedHandles acceptedHandles_;
+
+        // invoke callback with ENOMEM and return nullptr if fail to allocate
+        UringRequest *MakeUringRequest(Callback cb, std::uint32_t eventType);
+
+        // invoke callback with ENOMEM and return false if fail to submit
+        bool SubmitUringRequest(UringRequest *request, struct io_uring_sqe &sqe) noexcept;
+
+        void SubmitUringRead();
+
+        void SubmitUringWrite();
+
+        void UringRead(char *buf, std::size_t bufSize, Callback cb);
+
+        void UringWrite(const char *buf, std::size_t bufSize, Callback cb);
+
+        void UringWriteVector(std::vector<iovec> &bufs, Callback cb);
+
+        void UringSendFile(std::shared_ptr<SendFileTask> task);
+
+        // return true if the task was completed
+        // or false if the task is waiting for the socket to be writable
+        bool SubmitUringSendFile(std::shared_ptr<SendFileTask> task);
+
+        void ContinueUringSendFile(std::shared_ptr<SendFileTask> task, ssize_t size);
+
+        void UringAccept(AcceptCallback cb);
+
+        void UringConnect(const sharpen::IEndPoint &endPoint, ConnectCallback cb);
+
+        void UringPoll(std::uint32_t events, Callback cb);
+
+        void ArmUringRecv();
+
+        void ArmUringAccept();
+
+        // complete reads with received data
+        void DeliverUringChunks();
+
+        void AbortUringReads(ssize_t size);
+
+        void AbortUringAccepts(ssize_t size);
+
+        // return nullptr if fail to allocate
+        sharpen::IoUringStruct *MakeMultishotRequest(std::uint32_t eventType);
+
+        void HandleUringRecv(sharpen::IoUringStruct *request);
+
+        void HandleUringAccept(sharpen::IoUringStruct *request);
+
+        void HandleUringEvent(sharpen::IoEvent *event);
+
+        // return false if fail to submit
+        static bool CancelUringRequest(sharpen::IoUringQueue *queue,
+                                       sharpen::IoUringStruct *request) noexcept;
+
+        // invoked by loop after the channel is released
+        static void ReleaseUringOrphan(sharpen::IoUringQueue *queue,
+                                       sharpen::IoUringStruct *request) noexcept;
+
+        void CancelUringRequests(sharpen::ErrorCode err) noexcept;
+
+        // give back buffers and connections which have not been taken
+        void ReleaseUringResources() noexcept;
+
+        static void InvokeAcceptCallback(AcceptCallback cb, ssize_t size);
+
+        static void InvokeConnectCallback(ConnectCallback cb, ssize_t size);
+#endif
 
         sharpen::FileHandle DoAccept();
 
@@ -74,6 +256,8 @@ namespace sharpen {
 
         void TryWrite(const char *buf, std::size_t bufSize, Callback cb);
 
+        void TryWriteVector(std::vector<iovec> &bufs, Callback cb);
+
         void TryAccept(AcceptCallback cb);
 
         void TryConnect(const sharpen::IEndPoint &endPoint, ConnectCallback cb);
@@ -88,6 +272,8 @@ namespace sharpen {
                           std::size_t bufSize,
                           sharpen::Future<std::size_t> *future);
 
+        void RequestWriteVector(std::vector<iovec> bufs, sharpen::Future<std::size_t> *future);
+
         void RequestSendFile(sharpen::FileHandle handle,
                              std::uint64_t offset,
                              std::size_t size,
@@ -108,11 +294,13 @@ namespace sharpen {
                                        sharpen::Future<std::size_t> *future,
                                        ssize_t size) noexcept;
 
+#ifndef SHARPEN_IS_LINUX
         static void CompleteSendFileCallback(sharpen::EventLoop *loop,
                                              sharpen::Future<std::size_t> *future,
                                              void *mem,
                                              std::size_t memLen,
                                              ssize_t size) noexcept;
+#endif
 
         static void CompleteAcceptCallback(sharpen::EventLoop *loop,
                                            sharpen::Future<sharpen::NetStreamChannelPtr> *future,
@@ -143,6 +331,13 @@ namespace sharpen {
                                 std::size_t bufferOffset,
                                 sharpen::Future<std::size_t> &future) override;
 
+        using Mybase::WriteVectorAsync;
+
+        // write all buffers by one writev() or sendmsg()
+        virtual void WriteVectorAsync(const sharpen::ByteSlice *slices,
+                                      std::size_t count,
+                                      sharpen::Future<std::size_t> &future) override;
+
         virtual void ReadAsync(char *buf,
                                std::size_t bufSize,
                                sharpen::Future<std::size_t> &future) override;
@@ -153,6 +348,13 @@ namespace sharpen {
 
         virtual void OnEvent(sharpen::IoEvent *event) override;
 
+        using Mybase::Register;
+
+        // use io_uring if the selector of loop selects NetIoMethod::Completion
+        virtual void Register(sharpen::EventLoop &loop) override;
+
+        // use sendfile() on linux
+        // or splice() if the file doesn't support it
         virtual void SendFileAsync(sharpen::FileChannelPtr file,
                                    std::uint64_t size,
                                    std::uint64_t offset,
@@ -22,10 +22,12 @@
 #include "RaftPrevoteRecord.hpp"
 #include "RaftRole.hpp"
 #include "RaftVoteRecord.hpp"
+#include <chrono>
 #include <initializer_list>
 #include <map>
 #include <queue>
 #include <set>
+#include <vector>
 
 
 namespace sharpen {
@@ -36,6 +38,16 @@ namespace sharpen {
         , public sharpen::Nonmovable {
     private:
         using Self = sharpen::RaftConsensus;
+        using ReadFuture = sharpen::Future<sharpen::Optional<std::uint64_t>>;
+        using ReadRecord = std::pair<std::uint64_t, ReadFuture *>;
+
+        // rounds that a follower with full pipeline could be skipped
+        // before its in-flight mails are canceled
+        constexpr static std::size_t pipelineStallLimit_{16};
+
+        // rounds that a learner waits for the response of its source
+        // before pulling from the next peer
+        constexpr static std::size_t learnTimeoutRounds_{4};
 
         // scheduler
         sharpen::IFiberScheduler *scheduler_;
@@ -74,6 +86,15 @@ namespace sharpen {
         std::atomic_uint64_t advancedCount_;
         std::atomic_uint64_t reachAdvancedCount_;
 
+        // reads
+        // waiting for a round that begins after them
+        std::vector<ReadRecord> pendingReads_;
+        // waiting for current round
+        std::vector<ReadRecord> confirmingReads_;
+        // confirmed, waiting for apply
+        std::multimap<std::uint64_t, ReadFuture *> applyingReads_;
+        std::chrono::steady_clock::time_point readLeaseDeadline_;
+
         // mail builder
         std::unique_ptr<sharpen::IRaftMailBuilder> mailBuilder_;
         // mail extractor
@@ -88,6 +109,14 @@ namespace sharpen {
 
         // learners
         std::set<sharpen::ActorId> learners_;
+        // the peer that the learner pulls logs and snapshot from
+        sharpen::Optional<sharpen::ActorId> learnSource_;
+        // the last index of the snapshot being learned
+        std::uint64_t learnSnapshotIndex_;
+        // a request to the source is in flight
+        bool learnPending_;
+        // rounds since the pending request was sent
+        std::size_t learnWaits_;
         // config change
         std::atomic_bool changeable_;
         std::set<sharpen::ActorId> newPeersVotes_;
@@ -172,13 +201,53 @@ namespace sharpen {
                                  const sharpen::ActorId &actorId);
 
         // snapshot
+        // return false if the chunk is not continuous or the snapshot is corrupted
+        bool InstallSnapshotChunk(const sharpen::RaftSnapshotMetadata &metadata,
+                                  std::uint64_t offset,
+                                  const sharpen::ByteBuffer &data,
+                                  bool last);
+
         sharpen::Mail OnSnapshotRequest(const sharpen::RaftSnapshotRequest &request);
 
         void OnSnapshotResponse(const sharpen::RaftSnapshotResponse &response,
                                 const sharpen::ActorId &actorId);
 
+        void StreamSnapshot(const sharpen::ActorId &actorId);
+
+        // learn
+        // learners pull committed logs and snapshot from followers
+        // so that the leader only replicates new entries
+        void NextLearnSource();
+
+        void RaiseLearning();
+
+        void RequestLearnLogs(const sharpen::ActorId &actorId);
+
+        void RequestLearnSnapshot(const sharpen::ActorId &actorId);
+
+        sharpen::Mail OnLearnLogsRequest(const sharpen::RaftLearnLogsRequest &request);
+
+        void OnLearnLogsResponse(const sharpen::RaftLearnLogsResponse &response,
+                                 const sharpen::ActorId &actorId);
+
+        sharpen::Mail OnLearnSnapshotRequest(const sharpen::RaftLearnSnapshotRequest &request);
+
+        void OnLearnSnapshotResponse(const sharpen::RaftLearnSnapshotResponse &response,
+                                     const sharpen::ActorId &actorId);
+
         void NotifyWaiter(sharpen::Future<sharpen::ConsensusResult> *future) noexcept;
 
+        // read
+        void OnReadRoundConfirmed();
+
+        void CompleteAppliedReads() noexcept;
+
+        void FailReads() noexcept;
+
+        void DoReadIndex(ReadFuture *future);
+
+        virtual void NviReadIndex(ReadFuture &future) override;
+
         virtual void NviWaitNextConsensus(
             sharpen::Future<sharpen::ConsensusResult> &future) override;
 
@@ -31,6 +31,8 @@ namespace sharpen {
 
         static constexpr std::size_t minEntiresSize_{4*1024};
 
+        static constexpr std::uint64_t noneRound_{0};
+
         sharpen::ActorId id_;
         const sharpen::IRaftMailBuilder *builder_;
         const sharpen::ILogStorage *logs_;
@@ -40,6 +42,9 @@ namespace sharpen {
         std::size_t batchSize_;
         // max length of each entires
         std::size_t entiresSize_;
+        // max count of entries which have been sent but not acknowledged
+        // 0 means unlimited
+        std::size_t inflightWindow_;
         mutable std::map<sharpen::ActorId, sharpen::RaftReplicatedState> states_;
         std::uint64_t term_;
         std::uint64_t round_;
@@ -48,7 +53,8 @@ namespace sharpen {
         sharpen::RaftReplicatedState *LookupMutableState(
             const sharpen::ActorId &actorId) const noexcept;
 
-        sharpen::Mail ProvideSnapshotRequest(sharpen::RaftReplicatedState *state) const;
+        sharpen::Mail ProvideSnapshotRequest(sharpen::RaftReplicatedState *state,
+                                             std::uint64_t round) const;
 
         void ReComputeCommitIndex() noexcept;
 
@@ -88,6 +94,12 @@ namespace sharpen {
 
         void SetCommitIndex(std::uint64_t index) noexcept;
 
+        inline std::size_t GetInflightWindow() const noexcept {
+            return this->inflightWindow_;
+        }
+
+        void SetInflightWindow(std::size_t window) noexcept;
+
         virtual sharpen::Mail Provide(const sharpen::ActorId &actorId) const;
 
         void Register(const sharpen::ActorId &actorId);
@@ -104,6 +116,15 @@ namespace sharpen {
 
         sharpen::Optional<std::uint64_t> GetSynchronizedIndex() const noexcept;
 
+        bool IsTransferringSnapshot(const sharpen::ActorId &actorId) const noexcept;
+
+        // provide the next snapshot chunk without waiting for next round
+        // return an empty mail if the actor is not transferring snapshot
+        sharpen::Mail ProvideSnapshotChunk(const sharpen::ActorId &actorId) const;
+
+        // resend the chunks from the offset expected by the actor
+        void BackwardSnapshot(const sharpen::ActorId &actorId, std::uint64_t offset);
+
         void PrepareTerm(std::uint64_t term) noexcept;
 
         void PrepareRound(std::uint64_t round) noexcept;
@@ -0,0 +1,77 @@
+#pragma once
+#ifndef _SHARPEN_RAFTLEARNLOGSREQUEST_HPP
+#define _SHARPEN_RAFTLEARNLOGSREQUEST_HPP
+
+#include "BinarySerializable.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace sharpen {
+    // sent by a learner to a follower
+    // asks for the committed logs begin with begin index
+    class RaftLearnLogsRequest
+        : public sharpen::BinarySerializable<sharpen::RaftLearnLogsRequest> {
+    private:
+        using Self = sharpen::RaftLearnLogsRequest;
+
+        std::uint64_t term_;
+        std::uint64_t beginIndex_;
+        std::uint64_t batchSize_;
+
+    public:
+        RaftLearnLogsRequest() noexcept;
+
+        RaftLearnLogsRequest(const Self &other) noexcept = default;
+
+        RaftLearnLogsRequest(Self &&other) noexcept;
+
+        inline Self &operator=(const Self &other) noexcept {
+            if (this != std::addressof(other)) {
+                Self tmp{other};
+                std::swap(tmp, *this);
+            }
+            return *this;
+        }
+
+        Self &operator=(Self &&other) noexcept;
+
+        ~RaftLearnLogsRequest() noexcept = default;
+
+        inline const Self &Const() const noexcept {
+            return *this;
+        }
+
+        inline std::uint64_t GetTerm() const noexcept {
+            return this->term_;
+        }
+
+        inline void SetTerm(std::uint64_t term) noexcept {
+            this->term_ = term;
+        }
+
+        inline std::uint64_t GetBeginIndex() const noexcept {
+            return this->beginIndex_;
+        }
+
+        inline void SetBeginIndex(std::uint64_t index) noexcept {
+            this->beginIndex_ = index;
+        }
+
+        inline std::uint64_t GetBatchSize() const noexcept {
+            return this->batchSize_;
+        }
+
+        inline void SetBatchSize(std::uint64_t batchSize) noexcept {
+            this->batchSize_ = batchSize;
+        }
+
+        std::size_t ComputeSize() const noexcept;
+
+        std::size_t LoadFrom(const char *data, std::size_t size);
+
+        std::size_t UnsafeStoreTo(char *data) const noexcept;
+    };
+}   // namespace sharpen
+
+#endif
\ No newline at end of file
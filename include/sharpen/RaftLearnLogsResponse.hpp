@@ -0,0 +1,107 @@
+#pragma once
+#ifndef _SHARPEN_RAFTLEARNLOGSRESPONSE_HPP
+#define _SHARPEN_RAFTLEARNLOGSRESPONSE_HPP
+
+#include "BinarySerializable.hpp"
+#include "LogEntries.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace sharpen {
+    class RaftLearnLogsResponse
+        : public sharpen::BinarySerializable<sharpen::RaftLearnLogsResponse> {
+    private:
+        using Self = sharpen::RaftLearnLogsResponse;
+
+        // false if the peer refuses to serve learners
+        bool status_;
+        std::uint64_t term_;
+        std::uint64_t beginIndex_;
+        std::uint64_t commitIndex_;
+        // the last index of the snapshot of the peer
+        // the learner pulls the snapshot if begin index has been compacted
+        std::uint64_t snapshotIndex_;
+        // committed entries begin with begin index
+        sharpen::LogEntries entries_;
+
+    public:
+        RaftLearnLogsResponse() noexcept;
+
+        RaftLearnLogsResponse(const Self &other) = default;
+
+        RaftLearnLogsResponse(Self &&other) noexcept;
+
+        inline Self &operator=(const Self &other) {
+            if (this != std::addressof(other)) {
+                Self tmp{other};
+                std::swap(tmp, *this);
+            }
+            return *this;
+        }
+
+        Self &operator=(Self &&other) noexcept;
+
+        ~RaftLearnLogsResponse() noexcept = default;
+
+        inline const Self &Const() const noexcept {
+            return *this;
+        }
+
+        inline bool GetStatus() const noexcept {
+            return this->status_;
+        }
+
+        inline void SetStatus(bool status) noexcept {
+            this->status_ = status;
+        }
+
+        inline std::uint64_t GetTerm() const noexcept {
+            return this->term_;
+        }
+
+        inline void SetTerm(std::uint64_t term) noexcept {
+            this->term_ = term;
+        }
+
+        inline std::uint64_t GetBeginIndex() const noexcept {
+            return this->beginIndex_;
+        }
+
+        inline void SetBeginIndex(std::uint64_t index) noexcept {
+            this->beginIndex_ = index;
+        }
+
+        inline std::uint64_t GetCommitIndex() const noexcept {
+            return this->commitIndex_;
+        }
+
+        inline void SetCommitIndex(std::uint64_t index) noexcept {
+            this->commitIndex_ = index;
+        }
+
+        inline std::uint64_t GetSnapshotIndex() const noexcept {
+            return this->snapshotIndex_;
+        }
+
+        inline void SetSnapshotIndex(std::uint64_t index) noexcept {
+            this->snapshotIndex_ = index;
+        }
+
+        inline sharpen::LogEntries &Entries() noexcept {
+            return this->entries_;
+        }
+
+        inline const sharpen::LogEntries &Entries() const noexcept {
+            return this->entries_;
+        }
+
+        std::size_t ComputeSize() const noexcept;
+
+        std::size_t LoadFrom(const char *data, std::size_t size);
+
+        std::size_t UnsafeStoreTo(char *data) const noexcept;
+    };
+}   // namespace sharpen
+
+#endif
\ No newline at end of file
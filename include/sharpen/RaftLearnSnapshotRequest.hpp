@@ -0,0 +1,79 @@
+#pragma once
+#ifndef _SHARPEN_RAFTLEARNSNAPSHOTREQUEST_HPP
+#define _SHARPEN_RAFTLEARNSNAPSHOTREQUEST_HPP
+
+#include "BinarySerializable.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace sharpen {
+    // sent by a learner to a follower
+    // asks for the chunk of snapshot begin with offset
+    class RaftLearnSnapshotRequest
+        : public sharpen::BinarySerializable<sharpen::RaftLearnSnapshotRequest> {
+    private:
+        using Self = sharpen::RaftLearnSnapshotRequest;
+
+        std::uint64_t term_;
+        // the last index of the snapshot being learned
+        // the follower restarts from offset 0 if its snapshot has changed
+        std::uint64_t lastIndex_;
+        std::uint64_t offset_;
+
+    public:
+        RaftLearnSnapshotRequest() noexcept;
+
+        RaftLearnSnapshotRequest(const Self &other) noexcept = default;
+
+        RaftLearnSnapshotRequest(Self &&other) noexcept;
+
+        inline Self &operator=(const Self &other) noexcept {
+            if (this != std::addressof(other)) {
+                Self tmp{other};
+                std::swap(tmp, *this);
+            }
+            return *this;
+        }
+
+        Self &operator=(Self &&other) noexcept;
+
+        ~RaftLearnSnapshotRequest() noexcept = default;
+
+        inline const Self &Const() const noexcept {
+            return *this;
+        }
+
+        inline std::uint64_t GetTerm() const noexcept {
+            return this->term_;
+        }
+
+        inline void SetTerm(std::uint64_t term) noexcept {
+            this->term_ = term;
+        }
+
+        inline std::uint64_t GetLastIndex() const noexcept {
+            return this->lastIndex_;
+        }
+
+        inline void SetLastIndex(std::uint64_t index) noexcept {
+            this->lastIndex_ = index;
+        }
+
+        inline std::uint64_t GetOffset() const noexcept {
+            return this->offset_;
+        }
+
+        inline void SetOffset(std::uint64_t offset) noexcept {
+            this->offset_ = offset;
+        }
+
+        std::size_t ComputeSize() const noexcept;
+
+        std::size_t LoadFrom(const char *data, std::size_t size);
+
+        std::size_t UnsafeStoreTo(char *data) const noexcept;
+    };
+}   // namespace sharpen
+
+#endif
\ No newline at end of file
@@ -0,0 +1,106 @@
+#pragma once
+#ifndef _SHARPEN_RAFTLEARNSNAPSHOTRESPONSE_HPP
+#define _SHARPEN_RAFTLEARNSNAPSHOTRESPONSE_HPP
+
+#include "BinarySerializable.hpp"
+#include "ByteBuffer.hpp"
+#include "RaftSnapshotMetadata.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace sharpen {
+    class RaftLearnSnapshotResponse
+        : public sharpen::BinarySerializable<sharpen::RaftLearnSnapshotResponse> {
+    private:
+        using Self = sharpen::RaftLearnSnapshotResponse;
+
+        // false if the peer refuses to serve learners
+        // or it does not have a snapshot
+        bool status_;
+        std::uint64_t term_;
+        std::uint64_t offset_;
+        bool last_;
+        sharpen::RaftSnapshotMetadata metadata_;
+        sharpen::ByteBuffer data_;
+
+    public:
+        RaftLearnSnapshotResponse() noexcept;
+
+        RaftLearnSnapshotResponse(const Self &other) = default;
+
+        RaftLearnSnapshotResponse(Self &&other) noexcept;
+
+        inline Self &operator=(const Self &other) {
+            if (this != std::addressof(other)) {
+                Self tmp{other};
+                std::swap(tmp, *this);
+            }
+            return *this;
+        }
+
+        Self &operator=(Self &&other) noexcept;
+
+        ~RaftLearnSnapshotResponse() noexcept = default;
+
+        inline const Self &Const() const noexcept {
+            return *this;
+        }
+
+        inline bool GetStatus() const noexcept {
+            return this->status_;
+        }
+
+        inline void SetStatus(bool status) noexcept {
+            this->status_ = status;
+        }
+
+        inline std::uint64_t GetTerm() const noexcept {
+            return this->term_;
+        }
+
+        inline void SetTerm(std::uint64_t term) noexcept {
+            this->term_ = term;
+        }
+
+        inline std::uint64_t GetOffset() const noexcept {
+            return this->offset_;
+        }
+
+        inline void SetOffset(std::uint64_t offset) noexcept {
+            this->offset_ = offset;
+        }
+
+        inline bool IsLast() const noexcept {
+            return this->last_;
+        }
+
+        inline void SetLast(bool last) noexcept {
+            this->last_ = last;
+        }
+
+        inline sharpen::RaftSnapshotMetadata &Metadata() noexcept {
+            return this->metadata_;
+        }
+
+        inline const sharpen::RaftSnapshotMetadata &Metadata() const noexcept {
+            return this->metadata_;
+        }
+
+        inline sharpen::ByteBuffer &Data() noexcept {
+            return this->data_;
+        }
+
+        inline const sharpen::ByteBuffer &Data() const noexcept {
+            return this->data_;
+        }
+
+        std::size_t ComputeSize() const noexcept;
+
+        std::size_t LoadFrom(const char *data, std::size_t size);
+
+        std::size_t UnsafeStoreTo(char *data) const noexcept;
+    };
+}   // namespace sharpen
+
+#endif
\ No newline at end of file
@@ -2,6 +2,7 @@
 #ifndef _SHARPEN_RAFTLEASESTATUS_HPP
 #define _SHARPEN_RAFTLEASESTATUS_HPP
 
+#include <chrono>
 #include <cstdint>
 #include <utility>
 #include <cstddef>
@@ -13,6 +14,8 @@ namespace sharpen {
 
         std::uint64_t leaseRound_;
         std::size_t ackCount_;
+        // when the heartbeats of current round were sent
+        std::chrono::steady_clock::time_point roundBegin_;
     public:
         RaftLeaseStatus() noexcept;
 
@@ -43,6 +46,8 @@ namespace sharpen {
         void OnAck() noexcept;
 
         std::size_t GetAckCount() const noexcept;
+
+        std::chrono::steady_clock::time_point GetRoundBegin() const noexcept;
     };
 }   // namespace sharpen
 
@@ -3,6 +3,7 @@
 #define _SHARPEN_RAFTLOGACCESSER_HPP
 
 #include "IRaftLogAccesser.hpp"
+#include "RaftLogChecksum.hpp" // IWYU pragma: export
 #include "RaftLogHeader.hpp" // IWYU pragma: export
 
 namespace sharpen {
@@ -11,6 +12,9 @@ namespace sharpen {
         using Self = sharpen::RaftLogAccesser;
 
         std::uint32_t magic_;
+        sharpen::RaftLogChecksum checksum_;
+
+        std::uint32_t ComputeChecksum(sharpen::ByteSlice bytes) const noexcept;
 
         virtual std::uint64_t NviGetTerm(sharpen::ByteSlice logEntry) const noexcept override;
 
@@ -22,6 +26,8 @@ namespace sharpen {
     public:
         RaftLogAccesser(std::uint32_t magic) noexcept;
 
+        RaftLogAccesser(std::uint32_t magic, sharpen::RaftLogChecksum checksum) noexcept;
+
         RaftLogAccesser(const Self &other) noexcept = default;
 
         RaftLogAccesser(Self &&other) noexcept;
@@ -41,6 +47,10 @@ namespace sharpen {
         inline const Self &Const() const noexcept {
             return *this;
         }
+
+        inline sharpen::RaftLogChecksum GetChecksumType() const noexcept {
+            return this->checksum_;
+        }
     };
 }   // namespace sharpen
 
@@ -0,0 +1,15 @@
+#pragma once
+#ifndef _SHARPEN_RAFTLOGCHECKSUM_HPP
+#define _SHARPEN_RAFTLOGCHECKSUM_HPP
+
+namespace sharpen {
+    // checksum of raft log entries
+    // all members of a raft group must use the same one
+    enum class RaftLogChecksum {
+        Crc32,
+        // hardware accelerated on most cpus
+        Crc32c
+    };
+}   // namespace sharpen
+
+#endif
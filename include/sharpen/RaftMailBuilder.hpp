@@ -64,6 +64,18 @@ namespace sharpen {
 
         virtual sharpen::Mail BuildSnapshotResponse(
             const sharpen::RaftSnapshotResponse &response) const override;
+
+        virtual sharpen::Mail BuildLearnLogsRequest(
+            const sharpen::RaftLearnLogsRequest &request) const override;
+
+        virtual sharpen::Mail BuildLearnLogsResponse(
+            const sharpen::RaftLearnLogsResponse &response) const override;
+
+        virtual sharpen::Mail BuildLearnSnapshotRequest(
+            const sharpen::RaftLearnSnapshotRequest &request) const override;
+
+        virtual sharpen::Mail BuildLearnSnapshotResponse(
+            const sharpen::RaftLearnSnapshotResponse &response) const override;
     };
 }   // namespace sharpen
 
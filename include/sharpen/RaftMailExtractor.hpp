@@ -43,6 +43,18 @@ namespace sharpen {
         virtual sharpen::Optional<sharpen::RaftSnapshotResponse> NviExtractSnapshotResponse(
             const sharpen::Mail &mail) const noexcept override;
 
+        virtual sharpen::Optional<sharpen::RaftLearnLogsRequest> NviExtractLearnLogsRequest(
+            const sharpen::Mail &mail) const noexcept override;
+
+        virtual sharpen::Optional<sharpen::RaftLearnLogsResponse> NviExtractLearnLogsResponse(
+            const sharpen::Mail &mail) const noexcept override;
+
+        virtual sharpen::Optional<sharpen::RaftLearnSnapshotRequest> NviExtractLearnSnapshotRequest(
+            const sharpen::Mail &mail) const noexcept override;
+
+        virtual sharpen::Optional<sharpen::RaftLearnSnapshotResponse>
+        NviExtractLearnSnapshotResponse(const sharpen::Mail &mail) const noexcept override;
+
     public:
         explicit RaftMailExtractor(std::uint32_t magic) noexcept;
 
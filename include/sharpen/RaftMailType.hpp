@@ -16,8 +16,16 @@ namespace sharpen {
         InstallSnapshotResponse = 6,
         PrevoteRequest = 7,
         PrevoteResponse = 8,
+        // mails of multiple groups
+        BatchRequest = 9,
+        BatchResponse = 10,
+        // mails between learners and followers
+        LearnLogsRequest = 11,
+        LearnLogsResponse = 12,
+        LearnSnapshotRequest = 13,
+        LearnSnapshotResponse = 14,
         // use by boundary
-        MaxValue = 9
+        MaxValue = 15
     };
 
     constexpr inline static bool IsValiedRaftMailType(std::uint32_t type) noexcept {
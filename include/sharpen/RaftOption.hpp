@@ -2,6 +2,7 @@
 #ifndef _SHARPEN_RAFTOPTION_HPP
 #define _SHARPEN_RAFTOPTION_HPP
 
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <utility>
@@ -25,6 +26,8 @@ namespace sharpen {
         std::uint32_t pipelineLength_;
         bool enableSingle_;
         bool enableLeaseAwareness_;
+        bool enablePipelinedReplication_;
+        std::chrono::milliseconds readLease_;
 
     public:
         RaftOption() noexcept;
@@ -116,6 +119,39 @@ namespace sharpen {
         inline void DisableLeaseAwareness() noexcept {
             this->SetLeaseAwareness(false);
         }
+
+        // don't cancel in-flight mails when the pipeline is full
+        // followers are limited by in-flight window instead
+        inline bool IsEnablePipelinedReplication() const noexcept {
+            return this->enablePipelinedReplication_;
+        }
+
+        inline void SetPipelinedReplication(bool pipelined) noexcept {
+            this->enablePipelinedReplication_ = pipelined;
+        }
+
+        inline void EnablePipelinedReplication() noexcept {
+            this->SetPipelinedReplication(true);
+        }
+
+        inline void DisablePipelinedReplication() noexcept {
+            this->SetPipelinedReplication(false);
+        }
+
+        // serve ReadIndex without a heartbeat round while the lease is valid
+        // must be shorter than the minimal election timeout of followers
+        // zero disables lease reads
+        inline std::chrono::milliseconds GetReadLease() const noexcept {
+            return this->readLease_;
+        }
+
+        inline void SetReadLease(std::chrono::milliseconds lease) noexcept {
+            this->readLease_ = lease;
+        }
+
+        inline bool IsEnableReadLease() const noexcept {
+            return this->readLease_.count() != 0;
+        }
     };
 }   // namespace sharpen
 
@@ -58,6 +58,9 @@ namespace sharpen {
         sharpen::IRaftSnapshotChunk *LookupSnapshot() noexcept;
 
         sharpen::Optional<sharpen::RaftSnapshotMetadata> LookupSnapshotMetadata() const noexcept;
+
+        // lookup the term of the last snapshot which has been sent
+        sharpen::Optional<std::uint64_t> LookupSnapshotTerm(std::uint64_t index) const noexcept;
     };
 }   // namespace sharpen
 
@@ -15,6 +15,8 @@ namespace sharpen {
 
         std::uint64_t lastIndex_;
         std::uint64_t lastTerm_;
+        // CRC32C of the snapshot data
+        std::uint32_t checksum_;
         sharpen::ConsensusPeersConfiguration peers_;
 
     public:
@@ -48,6 +50,14 @@ namespace sharpen {
             this->lastTerm_ = term;
         }
 
+        inline std::uint32_t GetChecksum() const noexcept {
+            return this->checksum_;
+        }
+
+        inline void SetChecksum(std::uint32_t checksum) noexcept {
+            this->checksum_ = checksum;
+        }
+
         inline sharpen::ConsensusPeersConfiguration &Peers() noexcept {
             return this->peers_;
         }
@@ -16,6 +16,8 @@ namespace sharpen {
         std::uint64_t term_;
         std::uint64_t peersEpoch_;
         std::uint64_t leaseRound_;
+        // the offset of next chunk expected by the follower
+        std::uint64_t offset_;
 
     public:
         RaftSnapshotResponse() noexcept;
@@ -60,6 +62,14 @@ namespace sharpen {
             this->leaseRound_ = leaseRound;
         }
 
+        inline std::uint64_t GetOffset() const noexcept {
+            return this->offset_;
+        }
+
+        inline void SetOffset(std::uint64_t offset) noexcept {
+            this->offset_ = offset;
+        }
+
         inline std::uint64_t GetPeersEpoch() const noexcept {
             return this->peersEpoch_;
         }
@@ -0,0 +1,102 @@
+#pragma once
+#ifndef _SHARPEN_SEGMENTLOGSTORAGE_HPP
+#define _SHARPEN_SEGMENTLOGSTORAGE_HPP
+
+#include "AsyncRwLock.hpp"
+#include "ILogStorage.hpp"
+#include "LogEntries.hpp"
+#include "LogSegment.hpp"
+#include <map>
+#include <memory>
+#include <string>
+
+namespace sharpen {
+    // log storage with fixed size segment files in a directory
+    // entries are not cached in memory
+    // only the last segment is opened for writing
+    // DropUntil() deletes whole segments
+    class SegmentLogStorage
+        : public sharpen::ILogStorage
+        , public sharpen::Noncopyable {
+    private:
+        using Self = sharpen::SegmentLogStorage;
+        using SegmentPtr = std::unique_ptr<sharpen::LogSegment>;
+        using Segments = std::map<std::uint64_t, SegmentPtr>;
+
+        // 64MB
+        constexpr static std::size_t defaultSegmentSize_{64 * 1024 * 1024};
+
+        // 4MB
+        constexpr static std::size_t maxPendingSize_{4 * 1024 * 1024};
+
+        std::string name_;
+        sharpen::IEventLoopGroup *loopGroup_;
+        std::unique_ptr<sharpen::AsyncRwLock> lock_;
+        std::size_t segmentSize_;
+        Segments segments_;
+        std::uint64_t lastIndex_;
+        // entries before it have been dropped
+        std::uint64_t dropIndex_;
+
+        std::string GetSegmentName(std::uint64_t beginIndex) const;
+
+        void Load();
+
+        sharpen::LogSegment &GetActiveSegment() noexcept;
+
+        void RollSegment(std::uint64_t beginIndex, std::size_t recordSize);
+
+        void RemoveSegment(Segments::iterator ite) noexcept;
+
+        void ComputeLastIndex() noexcept;
+
+        sharpen::Optional<sharpen::ByteBuffer> DoLookup(std::uint64_t index) const;
+
+        // return the count of entries which exist already
+        std::size_t SkipExisted(std::uint64_t beginIndex,
+                                const sharpen::ByteSlice *entries,
+                                std::size_t count);
+
+        void Append(std::uint64_t beginIndex, const sharpen::ByteSlice *entries, std::size_t count);
+
+        void DoTruncateFrom(std::uint64_t index);
+
+        void WriteDropRecord();
+
+        virtual sharpen::Optional<sharpen::ByteBuffer> NviLookup(
+            std::uint64_t index) const override;
+
+        virtual void NviWrite(std::uint64_t index, sharpen::ByteSlice log) override;
+
+        virtual void NviDropUntil(std::uint64_t index) noexcept override;
+
+        virtual void NviTruncateFrom(std::uint64_t index) override;
+
+        virtual void NviWriteBatch(std::uint64_t beginIndex, sharpen::LogEntries entries) override;
+
+    public:
+        explicit SegmentLogStorage(std::string name);
+
+        SegmentLogStorage(sharpen::IEventLoopGroup &loopGroup, std::string name);
+
+        SegmentLogStorage(sharpen::IEventLoopGroup &loopGroup,
+                          std::string name,
+                          std::size_t segmentSize);
+
+        SegmentLogStorage(Self &&other) noexcept;
+
+        Self &operator=(Self &&other) noexcept;
+
+        virtual ~SegmentLogStorage() noexcept = default;
+
+        inline const Self &Const() const noexcept {
+            return *this;
+        }
+
+        virtual std::uint64_t GetLastIndex() const override;
+
+        std::size_t GetSegmentCount() const;
+    };
+}   // namespace sharpen
+
+#endif
@@ -3,9 +3,12 @@
 #define _SHARPEN_SELECTOROPS_HPP
 
 #include "ISelector.hpp"
+#include "NetTypeDef.hpp"
 
 namespace sharpen {
     sharpen::SelectorPtr MakeDefaultSelector();
+
+    sharpen::SelectorPtr MakeDefaultSelector(sharpen::NetIoMethod netIoMethod);
 }
 
 #endif
\ No newline at end of file
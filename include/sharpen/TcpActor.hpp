@@ -10,6 +10,7 @@
 #include "IWorkerGroup.hpp"
 #include "Noncopyable.hpp"
 #include "Nonmovable.hpp"
+#include "SpinLock.hpp"
 #include <cassert>
 
 namespace sharpen {
@@ -24,13 +25,21 @@ namespace sharpen {
         std::atomic_size_t postCount_;
         std::atomic_size_t ackCount_;
         std::shared_ptr<sharpen::IMailParserFactory> parserFactory_;
-        std::function<void(sharpen::Mail)> pipelineCb_;
+        bool pipeline_;
         std::unique_ptr<sharpen::IRemotePoster> poster_;
         std::unique_ptr<sharpen::IWorkerGroup> postWorker_;
+        // guards the generation of pipelined mails
+        sharpen::SpinLock lock_;
+        // Cancel() detaches the pipelined mails of older generations
+        std::size_t generation_;
+        // pipelined mails which have been written by post worker
+        std::atomic_size_t sentCount_;
 
-        void DoPostShared(const sharpen::Mail *mail) noexcept;
+        void DoPostFailed(std::size_t generation) noexcept;
 
-        void DoPost(sharpen::Mail mail) noexcept;
+        void DoPostShared(const sharpen::Mail *mail, std::size_t generation) noexcept;
+
+        void DoPost(sharpen::Mail mail, std::size_t generation) noexcept;
 
         inline virtual sharpen::ActorId NviGetId() const noexcept override {
             assert(this->poster_);
@@ -43,6 +52,14 @@ namespace sharpen {
 
         void DoReceive(sharpen::Mail mail) noexcept;
 
+        void DoPipelineReceive(std::size_t generation, sharpen::Mail mail) noexcept;
+
+        std::size_t CountPipelinedPost() noexcept;
+
+        void UncountPipelinedPost(std::size_t generation) noexcept;
+
+        void CancelPipeline() noexcept;
+
     public:
         TcpActor(sharpen::IFiberScheduler &scheduler,
                  sharpen::IMailReceiver &receiver,
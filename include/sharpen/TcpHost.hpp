@@ -5,6 +5,7 @@
 #include "AsyncBarrier.hpp"
 #include "IHost.hpp"
 #include "ITcpSteamFactory.hpp"
+#include <vector>
 
 namespace sharpen {
     class TcpHost
@@ -18,7 +19,9 @@ namespace sharpen {
         sharpen::IEventLoopGroup *loopGroup_;
         std::atomic_bool token_;
         std::unique_ptr<sharpen::IHostPipeline> pipeline_;
-        sharpen::NetStreamChannelPtr acceptor_;
+        // one acceptor for each event loop if SO_REUSEPORT is enabled
+        // otherwise only one acceptor
+        std::vector<sharpen::NetStreamChannelPtr> acceptors_;
 
         virtual void NviSetPipeline(
             std::unique_ptr<sharpen::IHostPipeline> pipeline) noexcept override;
@@ -26,11 +29,25 @@ namespace sharpen {
         void ConsumeChannel(sharpen::NetStreamChannelPtr channel,
                             std::atomic_size_t *counter) noexcept;
 
+        static sharpen::TcpStreamOption GetDefaultOption() noexcept;
+
+        void Accept(sharpen::INetStreamChannel *acceptor, std::atomic_size_t *counter);
+
+        void DoAccept(sharpen::INetStreamChannel *acceptor,
+                      std::atomic_size_t *counter,
+                      sharpen::Future<void> *future) noexcept;
+
     public:
         explicit TcpHost(sharpen::ITcpSteamFactory &factory);
 
         TcpHost(sharpen::IFiberScheduler &scheduler, sharpen::ITcpSteamFactory &factory);
 
+        TcpHost(sharpen::ITcpSteamFactory &factory, const sharpen::TcpStreamOption &option);
+
+        TcpHost(sharpen::IFiberScheduler &scheduler,
+                sharpen::ITcpSteamFactory &factory,
+                const sharpen::TcpStreamOption &option);
+
         virtual ~TcpHost() noexcept;
 
         inline const Self &Const() const noexcept {
@@ -40,6 +57,10 @@ namespace sharpen {
         virtual void Run() override;
 
         virtual void Stop() noexcept override;
+
+        inline std::size_t GetAcceptorCount() const noexcept {
+            return this->acceptors_.size();
+        }
     };
 }   // namespace sharpen
 
@@ -0,0 +1,148 @@
+#pragma once
+#ifndef _SHARPEN_TCPMULTIPLEXER_HPP
+#define _SHARPEN_TCPMULTIPLEXER_HPP
+
+#include "IFiberScheduler.hpp"
+#include "IMailParserFactory.hpp"
+#include "IRemotePoster.hpp"
+#include "IWorkerGroup.hpp"
+#include "Noncopyable.hpp"
+#include "Nonmovable.hpp"
+#include "SpinLock.hpp"
+#include <atomic>
+#include <cassert>
+#include <deque>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace sharpen {
+    // a tcp connection to one peer shared by many raft groups
+    // mails queued while the connection is busy are coalesced into one batch mail
+    // the peer may answer mails out of order
+    // responses are correlated by raft number, mails of a group are answered in order
+    // and batch responses are correlated by the sequence of the batch
+    class TcpMultiplexer
+        : public sharpen::Noncopyable
+        , public sharpen::Nonmovable {
+    private:
+        using Self = sharpen::TcpMultiplexer;
+        using Callback = std::function<void(sharpen::Mail)>;
+
+        // limits the content size of a batch mail
+        static constexpr std::size_t maxBatchSize_{1024 * 1024};
+
+        struct PendingMail {
+            sharpen::Mail mail_;
+            Callback cb_;
+        };
+
+        class BatchCallback {
+        private:
+            std::uint32_t magic_;
+            std::vector<Callback> cbs_;
+
+            void Fail() noexcept;
+
+        public:
+            BatchCallback(std::uint32_t magic, std::vector<Callback> cbs) noexcept;
+
+            BatchCallback(const BatchCallback &other) = default;
+
+            BatchCallback(BatchCallback &&other) noexcept = default;
+
+            ~BatchCallback() noexcept = default;
+
+            void operator()(sharpen::Mail response) noexcept;
+        };
+
+        // a mail waiting for its response
+        struct Waiter {
+            // the connection the mail was posted by
+            std::size_t epoch_;
+            Callback cb_;
+        };
+
+        using GroupWaiters = std::unordered_map<std::uint32_t, std::deque<Waiter>>;
+        using BatchWaiters = std::unordered_map<std::uint32_t, Waiter>;
+
+        std::uint32_t magic_;
+        std::shared_ptr<sharpen::IMailParserFactory> parserFactory_;
+        std::unique_ptr<sharpen::IRemotePoster> poster_;
+        std::unique_ptr<sharpen::IWorkerGroup> postWorker_;
+        sharpen::SpinLock lock_;
+        std::vector<PendingMail> pending_;
+        // true if a flush has been submitted to the worker
+        bool flushing_;
+        std::atomic_size_t batchCount_;
+        // protects the waiters
+        sharpen::SpinLock waiterLock_;
+        // increased when the connection is reopened
+        std::size_t epoch_;
+        std::uint32_t sequence_;
+        GroupWaiters groupWaiters_;
+        BatchWaiters batchWaiters_;
+
+        static std::size_t GetMailSize(const PendingMail &pending) noexcept;
+
+        void Enqueue(PendingMail pending);
+
+        bool EnsureOpened() noexcept;
+
+        void DoPost(const sharpen::Mail &mail, std::size_t epoch) noexcept;
+
+        void DoPostSingle(PendingMail &mail) noexcept;
+
+        void OnResponse(std::size_t epoch, sharpen::Mail response) noexcept;
+
+        bool TakeWaiter(std::size_t epoch, const sharpen::Mail &response, Callback &cb) noexcept;
+
+        void FailWaiters(std::size_t epoch) noexcept;
+
+        void DoPostRange(std::vector<PendingMail> &mails,
+                         std::size_t begin,
+                         std::size_t end) noexcept;
+
+        void DoFlush() noexcept;
+
+    public:
+        TcpMultiplexer(sharpen::IFiberScheduler &scheduler,
+                       std::uint32_t magic,
+                       std::shared_ptr<sharpen::IMailParserFactory> parserFactory,
+                       std::unique_ptr<sharpen::IRemotePoster> poster);
+
+        ~TcpMultiplexer() noexcept;
+
+        inline const Self &Const() const noexcept {
+            return *this;
+        }
+
+        // the callback receives an empty mail if the mail could not be posted
+        void Post(sharpen::Mail mail, Callback cb);
+
+        // close the connection
+        // in-flight mails of every group are failed
+        // the connection is reopened by the next mail
+        void Close() noexcept;
+
+        bool Available() const noexcept;
+
+        bool SupportPipeline() const noexcept;
+
+        inline sharpen::ActorId GetId() const noexcept {
+            assert(this->poster_);
+            return this->poster_->GetId();
+        }
+
+        inline std::uint32_t GetMagic() const noexcept {
+            return this->magic_;
+        }
+
+        // the number of batch mails have been posted
+        inline std::size_t GetBatchCount() const noexcept {
+            return this->batchCount_.load(std::memory_order::memory_order_relaxed);
+        }
+    };
+}   // namespace sharpen
+
+#endif
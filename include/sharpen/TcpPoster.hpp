@@ -9,6 +9,8 @@
 #include "IWorkerGroup.hpp"
 #include "Noncopyable.hpp"
 #include "RemotePosterOpenError.hpp"   // IWYU pragma: export
+#include "SpinLock.hpp"
+#include <mutex>
 
 namespace sharpen {
     class TcpPoster
@@ -37,6 +39,18 @@ namespace sharpen {
 
         void AbortConn(sharpen::INetStreamChannel *conn) noexcept;
 
+        // return 0 if fail to write the whole mail
+        static std::size_t WriteMail(sharpen::INetStreamChannel &channel,
+                                     const sharpen::Mail &mail) noexcept;
+
+        static sharpen::ByteBuffer AcquireReceiveBuffer();
+
+        static void ReleaseReceiveBuffer(sharpen::ByteBuffer buffer) noexcept;
+
+        // read into the direct buffer of parser if possible
+        // otherwise read into buffer and parse it
+        std::size_t DoRead(sharpen::INetStreamChannel &channel, sharpen::ByteBuffer &buffer);
+
         sharpen::Mail DoReceive(sharpen::NetStreamChannelPtr channel) noexcept;
 
         void Receive(sharpen::NetStreamChannelPtr channel,
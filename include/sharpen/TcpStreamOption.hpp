@@ -11,6 +11,7 @@ namespace sharpen {
         using Self = sharpen::TcpStreamOption;
     
         bool reuseAddr_;
+        bool reusePort_;
     public:
     
         TcpStreamOption() noexcept;
@@ -51,6 +52,20 @@ namespace sharpen {
         }
 
         void EnableReuseAddressInNix() noexcept;
+
+        // SO_REUSEPORT
+        // TcpHost creates a listener for each event loop if it is enabled
+        bool IsEnableReusePort() const noexcept;
+
+        void SetReusePort(bool reuse) noexcept;
+
+        void EnableReusePort() noexcept {
+            this->SetReusePort(true);
+        }
+
+        void DisableReusePort() noexcept {
+            this->SetReusePort(false);
+        }
     };
 }
 
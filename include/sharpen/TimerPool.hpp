@@ -4,6 +4,7 @@
 
 #include "IEventLoopGroup.hpp"
 #include "ITimerPool.hpp"
+#include "SpinLock.hpp"
 #include <mutex>
 #include <vector>
 
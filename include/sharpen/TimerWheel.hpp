@@ -0,0 +1,121 @@
+#pragma once
+#ifndef _SHARPEN_TIMERWHEEL_HPP
+#define _SHARPEN_TIMERWHEEL_HPP
+
+#include "SystemMacro.hpp"   // IWYU pragma: keep
+
+#ifdef SHARPEN_IS_LINUX
+
+#include "Future.hpp"
+#include "IChannel.hpp"
+#include "Noncopyable.hpp"
+#include "Nonmovable.hpp"
+#include "SpinLock.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#define SHARPEN_HAS_TIMERWHEEL
+
+namespace sharpen {
+    // intrusive node of timer wheel
+    // owned by the timer
+    struct TimerWheelNode {
+        sharpen::TimerWheelNode *prev_;
+        sharpen::TimerWheelNode *next_;
+        // expire tick in milliseconds of monotonic clock
+        std::uint64_t expire_;
+        sharpen::Future<bool> *future_;
+        // 0 is the near wheel
+        std::size_t level_;
+    };
+
+    // hierarchical timing wheel of event loop
+    // all timers share a monotonic timer fd
+    // arm and cancel are O(1)
+    // the timer fd is re-armed only if the new timer expires earlier than it
+    class TimerWheel
+        : public sharpen::IChannel
+        , public sharpen::Noncopyable
+        , public sharpen::Nonmovable {
+    private:
+        using Self = sharpen::TimerWheel;
+        using Node = sharpen::TimerWheelNode;
+        using Mybase = sharpen::IChannel;
+
+        // 1 tick = 1 millisecond
+        // the near wheel covers 256ms
+        // level n covers 256 * 64^(n + 1) ms
+        static constexpr std::size_t nearBits_{8};
+        static constexpr std::size_t nearSize_{static_cast<std::size_t>(1) << nearBits_};
+        static constexpr std::uint64_t nearMask_{nearSize_ - 1};
+        static constexpr std::size_t levelBits_{6};
+        static constexpr std::size_t levelSize_{static_cast<std::size_t>(1) << levelBits_};
+        static constexpr std::uint64_t levelMask_{levelSize_ - 1};
+        static constexpr std::size_t levelCount_{3};
+        static constexpr std::uint64_t maxDelta_{static_cast<std::uint64_t>(1)
+                                                 << (nearBits_ + levelBits_ * levelCount_)};
+        static constexpr std::uint64_t unarmed_{static_cast<std::uint64_t>(-1)};
+        static constexpr std::size_t reservedExpiredSize_{32};
+
+        sharpen::SpinLock lock_;
+        // the last processed tick
+        std::uint64_t currentTick_;
+        // deadline of timer fd
+        std::uint64_t armedTick_;
+        std::size_t count_;
+        std::size_t nearCount_;
+        // slots are circular lists with sentinel heads
+        Node near_[nearSize_];
+        Node levels_[levelCount_][levelSize_];
+        // loop thread only
+        std::vector<sharpen::Future<bool> *> expired_;
+
+        static void InitSlot(Node &head) noexcept;
+
+        static bool IsEmptySlot(const Node &head) noexcept;
+
+        static void LinkBefore(Node &head, Node &node) noexcept;
+
+        void Link(Node &node) noexcept;
+
+        void Unlink(Node &node) noexcept;
+
+        void Cascade(std::size_t level, std::size_t index) noexcept;
+
+        void ExpireSlot(Node &head);
+
+        void Advance(std::uint64_t now);
+
+        std::uint64_t ComputeNextTick() const noexcept;
+
+        void SetTimerFd(std::uint64_t tick);
+
+        // lock should not be held
+        // armedTick_ should be set before calling it
+        void ArmTimerFd(std::uint64_t tick);
+
+        static std::uint64_t GetTick(bool roundUp) noexcept;
+
+    public:
+        TimerWheel();
+
+        virtual ~TimerWheel() noexcept = default;
+
+        virtual void OnEvent(sharpen::IoEvent *event) override;
+
+        // any thread
+        // node will be moved if it has been added
+        // return the future which has been replaced
+        sharpen::Future<bool> *Add(Node &node, std::uint64_t waitMs, sharpen::Future<bool> &future);
+
+        // any thread
+        // return nullptr if the node has expired or has not been added
+        sharpen::Future<bool> *Remove(Node &node) noexcept;
+
+        std::size_t GetCount() noexcept;
+    };
+}   // namespace sharpen
+
+#endif
+#endif
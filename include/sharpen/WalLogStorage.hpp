@@ -3,12 +3,23 @@
 #define _SHARPEN_WALLOGSTORAGE_HPP
 
 #include "AsyncRwLock.hpp"
+#include "AwaitableFuture.hpp"
 #include "IFileChannel.hpp"
 #include "ILogStorage.hpp"
+#include "ITimer.hpp"
 #include "LogEntries.hpp"
+#include <chrono>
+#include <deque>
 #include <map>
+#include <memory>
+#include <vector>
 
 namespace sharpen {
+    // writers stage their records and one of them commits the whole group
+    // with a single write and a single fdatasync()
+    // records are applied to the logs after their group is committed
+    // the file is compacted by a background fiber
+    // when it is limitFactor_ times larger than the content
     class WalLogStorage
         : public sharpen::ILogStorage
         , public sharpen::Noncopyable {
@@ -16,20 +27,78 @@ namespace sharpen {
         using Self = sharpen::WalLogStorage;
         using Logs = std::map<std::uint64_t, sharpen::ByteBuffer>;
 
+        struct StagedRecord {
+            std::uint8_t tag_;
+            std::uint64_t index_;
+            sharpen::ByteBuffer log_;
+        };
+
+        // references to records are never invalidated by push_back()
+        using StagedRecords = std::deque<StagedRecord>;
+
+        // the latest staged record of an index
+        struct StagedEntry {
+            std::uint64_t group_;
+            const StagedRecord *record_;
+        };
+
+        using StagedView = std::map<std::uint64_t, StagedEntry>;
+
         constexpr static std::uint8_t writeTag_{0};
 
         constexpr static std::uint8_t removeTag_{1};
 
         constexpr static std::size_t limitFactor_{3};
 
+        // tag, index and size of entry
+        constexpr static std::size_t reservedRecordSize_{1 + 2 * 10};
+
+        // 1MB
+        constexpr static std::size_t defaultMaxBatchSize_{1024 * 1024};
+
+        // 1MB
+        constexpr static std::size_t compactBatchSize_{1024 * 1024};
+
+        // entries of a gathered write
+        constexpr static std::size_t compactBatchCount_{256};
+
         std::string name_;
         std::string tempName_;
         sharpen::FileChannelPtr channel_;
         sharpen::IEventLoopGroup *loopGroup_;
         std::unique_ptr<sharpen::AsyncRwLock> lock_;
+        // committed records
         Logs logs_;
         std::uint64_t offset_;
         std::size_t contentSize_;
+        // group commit
+        // records which have not been written
+        // ByteBuffer grows linearly after 1MB
+        std::vector<char> pending_;
+        StagedRecords records_;
+        // staged records which have not been applied to logs_
+        StagedView staged_;
+        // the id of the group being staged
+        // the group before it is being committed
+        std::uint64_t group_;
+        // completed with false if the waiter should commit next group
+        std::vector<sharpen::Future<bool> *> waiters_;
+        // waiters of the group being committed
+        std::vector<sharpen::Future<bool> *> committingWaiters_;
+        bool committing_;
+        std::size_t maxBatchSize_;
+        std::chrono::milliseconds maxDelay_;
+        sharpen::TimerPtr timer_;
+        std::uint64_t syncCount_;
+        // compaction
+        bool compacting_;
+        // the compacted file is waiting for switching
+        bool compacted_;
+        // records after it are written during compaction
+        std::uint64_t compactOffset_;
+        sharpen::FileChannelPtr tempChannel_;
+        std::uint64_t tempOffset_;
+        std::unique_ptr<sharpen::AwaitableFuture<void>> compaction_;
 
         bool Insert(std::uint64_t index, sharpen::ByteBuffer log);
 
@@ -39,7 +108,57 @@ namespace sharpen {
 
         std::size_t ComputeContentSize() const noexcept;
 
-        void RebuildFile();
+        void StartCompaction();
+
+        void Compact() noexcept;
+
+        // write headers and entries of a batch by one vectored write
+        // headers[marks[i - 1], marks[i]) is the header of entries[i]
+        static std::size_t WriteCompactBatch(
+            sharpen::IFileChannel &channel,
+            std::uint64_t offset,
+            const std::vector<char> &headers,
+            const std::vector<std::size_t> &marks,
+            const std::vector<const sharpen::ByteBuffer *> &entries,
+            std::vector<sharpen::ByteSlice> &slices);
+
+        // replay the tail and replace the file
+        // no records should be being written
+        void SwitchFile(sharpen::FileChannelPtr channel, std::uint64_t offset);
+
+        void TrySwitchFile() noexcept;
+
+        void AbortCompaction() noexcept;
+
+        void WaitForCompaction() noexcept;
+
+        // the latest staged or committed log of the index
+        // group is set to 0 if the log has been committed
+        const sharpen::ByteBuffer *Find(std::uint64_t index, std::uint64_t &group) const noexcept;
+
+        void StageRecord(std::uint8_t tag, std::uint64_t index, sharpen::ByteBuffer log);
+
+        // stage remove records of logs in [beginIndex, endIndex)
+        // return false if there are no logs
+        bool StageRemove(std::uint64_t beginIndex, std::uint64_t endIndex);
+
+        // apply records to logs_ if the group is committed
+        // otherwise discard them
+        void ApplyGroup(StagedRecords &records, std::uint64_t group, bool committed);
+
+        // return true if the caller becomes the leader
+        bool Enqueue(sharpen::Future<bool> &future);
+
+        // write pending records and complete waiters
+        void CommitGroup();
+
+        void WaitForCommit(sharpen::AwaitableFuture<bool> &future, bool leader);
+
+        // the records of caller may belong to the group being committed
+        // and the group being staged
+        void WaitForGroups(sharpen::AwaitableFuture<bool> *committing,
+                           sharpen::AwaitableFuture<bool> *future,
+                           bool leader);
 
         virtual sharpen::Optional<sharpen::ByteBuffer> NviLookup(
             std::uint64_t index) const override;
@@ -61,13 +180,28 @@ namespace sharpen {
 
         Self &operator=(Self &&other) noexcept;
 
-        virtual ~WalLogStorage() noexcept = default;
+        virtual ~WalLogStorage() noexcept;
 
         inline const Self &Const() const noexcept {
             return *this;
         }
 
         virtual std::uint64_t GetLastIndex() const override;
+
+        // a group is committed without waiting if it has maxBatchSize bytes at least
+        // otherwise the leader waits maxDelay for more writers
+        void SetGroupCommit(std::size_t maxBatchSize, std::chrono::milliseconds maxDelay) noexcept;
+
+        inline std::size_t GetMaxBatchSize() const noexcept {
+            return this->maxBatchSize_;
+        }
+
+        inline std::chrono::milliseconds GetMaxDelay() const noexcept {
+            return this->maxDelay_;
+        }
+
+        // the number of fdatasync() calls
+        std::uint64_t GetSyncCount() const;
     };
 }   // namespace sharpen
 
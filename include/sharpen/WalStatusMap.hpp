@@ -3,12 +3,16 @@
 #define _SHARPEN_WALSTATUSMAP_HPP
 
 #include "AsyncRwLock.hpp"
+#include "AwaitableFuture.hpp"
 #include "IFileChannel.hpp"
 #include "IStatusMap.hpp"
 #include <map>
+#include <memory>
 #include <string>
 
 namespace sharpen {
+    // the file is compacted by a background fiber
+    // when it is limitFactor_ times larger than the content
     class WalStatusMap
         : public sharpen::IStatusMap
         , public sharpen::Noncopyable {
@@ -22,6 +26,9 @@ namespace sharpen {
 
         constexpr static std::size_t limitFactor_{3};
 
+        // 1MB
+        constexpr static std::size_t compactBatchSize_{1024 * 1024};
+
         std::string name_;
         std::string tempName_;
         sharpen::FileChannelPtr channel_;
@@ -30,6 +37,11 @@ namespace sharpen {
         std::unique_ptr<sharpen::AsyncRwLock> lock_;
         std::uint64_t offset_;
         std::size_t contentSize_;
+        // compaction
+        bool compacting_;
+        // records after it are written during compaction
+        std::uint64_t compactOffset_;
+        std::unique_ptr<sharpen::AwaitableFuture<void>> compaction_;
 
         bool Insert(sharpen::ByteBuffer key, sharpen::ByteBuffer value);
 
@@ -39,7 +51,16 @@ namespace sharpen {
 
         std::size_t ComputeContentSize() const noexcept;
 
-        void RebuildFile();
+        void StartCompaction();
+
+        void Compact() noexcept;
+
+        // replay the tail and replace the file
+        void SwitchFile(sharpen::FileChannelPtr channel, std::uint64_t offset);
+
+        void WaitForCompaction() noexcept;
+
+        void CheckCompaction();
 
         virtual sharpen::Optional<sharpen::ByteBuffer> NviLookup(
             const sharpen::ByteBuffer &key) const override;
@@ -57,7 +78,7 @@ namespace sharpen {
 
         Self &operator=(Self &&other) noexcept;
 
-        virtual ~WalStatusMap() noexcept = default;
+        virtual ~WalStatusMap() noexcept;
 
         inline const Self &Const() const noexcept {
             return *this;
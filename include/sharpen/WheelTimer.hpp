@@ -0,0 +1,40 @@
+#pragma once
+#ifndef _SHARPEN_WHEELTIMER_HPP
+#define _SHARPEN_WHEELTIMER_HPP
+
+#include "TimerWheel.hpp"
+
+#ifdef SHARPEN_HAS_TIMERWHEEL
+
+#include "ITimer.hpp"
+#include "Noncopyable.hpp"
+#include "Nonmovable.hpp"
+#include <memory>
+
+namespace sharpen {
+    // use timer wheel of event loop
+    // doesn't own a file descriptor
+    class WheelTimer
+        : public sharpen::ITimer
+        , public sharpen::Noncopyable
+        , public sharpen::Nonmovable {
+    private:
+        using Mybase = sharpen::ITimer;
+        using WheelPtr = std::shared_ptr<sharpen::TimerWheel>;
+
+        WheelPtr wheel_;
+        sharpen::TimerWheelNode node_;
+
+    public:
+        explicit WheelTimer(WheelPtr wheel);
+
+        virtual ~WheelTimer() noexcept;
+
+        virtual void WaitAsync(sharpen::Future<bool> &future, std::uint64_t waitMs) override;
+
+        virtual void Cancel() override;
+    };
+}   // namespace sharpen
+
+#endif
+#endif
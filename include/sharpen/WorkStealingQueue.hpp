@@ -0,0 +1,127 @@
+#pragma once
+#ifndef _SHARPEN_WORKSTEALINGQUEUE_HPP
+#define _SHARPEN_WORKSTEALINGQUEUE_HPP
+
+#include "Noncopyable.hpp"
+#include "Nonmovable.hpp"
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace sharpen {
+    // bounded Chase-Lev deque
+    // the owner thread pushes and pops at the bottom
+    // other threads steal from the top
+    // the owner may also take from the top to consume items in FIFO order
+    // the queue stores raw pointers and never owns them
+    template<typename _T>
+    class WorkStealingQueue
+        : public sharpen::Noncopyable
+        , public sharpen::Nonmovable {
+    private:
+        using Self = sharpen::WorkStealingQueue<_T>;
+        using Slot = std::atomic<_T *>;
+
+        static constexpr std::size_t cacheLineSize_{64};
+
+        std::atomic<std::int64_t> top_;
+        // keep top_ and bottom_ in different cache lines
+        char pad_[cacheLineSize_ - sizeof(std::atomic<std::int64_t>)];
+        std::atomic<std::int64_t> bottom_;
+        std::unique_ptr<Slot[]> slots_;
+        std::int64_t mask_;
+
+    public:
+        // capacity must be a power of two
+        explicit WorkStealingQueue(std::size_t capacity)
+            : top_(0)
+            , pad_()
+            , bottom_(0)
+            , slots_(new Slot[capacity])
+            , mask_(static_cast<std::int64_t>(capacity) - 1) {
+            assert(capacity != 0 && (capacity & (capacity - 1)) == 0);
+            for (std::size_t i = 0; i != capacity; ++i) {
+                this->slots_[i].store(nullptr, std::memory_order_relaxed);
+            }
+        }
+
+        ~WorkStealingQueue() noexcept = default;
+
+        // owner only
+        // return false if the queue is full
+        inline bool Push(_T *item) noexcept {
+            std::int64_t bottom{this->bottom_.load(std::memory_order_relaxed)};
+            std::int64_t top{this->top_.load(std::memory_order_acquire)};
+            if (bottom - top > this->mask_) {
+                return false;
+            }
+            this->slots_[bottom & this->mask_].store(item, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            this->bottom_.store(bottom + 1, std::memory_order_relaxed);
+            return true;
+        }
+
+        // owner only
+        inline _T *Pop() noexcept {
+            std::int64_t bottom{this->bottom_.load(std::memory_order_relaxed) - 1};
+            this->bottom_.store(bottom, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            std::int64_t top{this->top_.load(std::memory_order_relaxed)};
+            if (top > bottom) {
+                // empty
+                this->bottom_.store(bottom + 1, std::memory_order_relaxed);
+                return nullptr;
+            }
+            _T *item{this->slots_[bottom & this->mask_].load(std::memory_order_relaxed)};
+            if (top == bottom) {
+                // the last item
+                // race with thieves
+                if (!this->top_.compare_exchange_strong(
+                        top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                    item = nullptr;
+                }
+                this->bottom_.store(bottom + 1, std::memory_order_relaxed);
+            }
+            return item;
+        }
+
+        // any thread
+        // return nullptr if the queue is empty or we lost the race
+        inline _T *Steal() noexcept {
+            std::int64_t top{this->top_.load(std::memory_order_acquire)};
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            std::int64_t bottom{this->bottom_.load(std::memory_order_acquire)};
+            if (top >= bottom) {
+                return nullptr;
+            }
+            _T *item{this->slots_[top & this->mask_].load(std::memory_order_relaxed)};
+            if (!this->top_.compare_exchange_strong(
+                    top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                return nullptr;
+            }
+            return item;
+        }
+
+        // approximate size
+        inline std::size_t GetSize() const noexcept {
+            std::int64_t bottom{this->bottom_.load(std::memory_order_relaxed)};
+            std::int64_t top{this->top_.load(std::memory_order_relaxed)};
+            if (bottom <= top) {
+                return 0;
+            }
+            return static_cast<std::size_t>(bottom - top);
+        }
+
+        inline bool Empty() const noexcept {
+            return !this->GetSize();
+        }
+
+        inline std::size_t GetCapacity() const noexcept {
+            return static_cast<std::size_t>(this->mask_ + 1);
+        }
+    };
+}   // namespace sharpen
+
+#endif
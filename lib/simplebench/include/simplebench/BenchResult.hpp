@@ -0,0 +1,128 @@
+#pragma once
+#ifndef _SIMPLEBENCH_BENCHRESULT_HPP
+#define _SIMPLEBENCH_BENCHRESULT_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace simplebench {
+    class Stopwatch {
+    private:
+        using Self = simplebench::Stopwatch;
+        using Clock = std::chrono::steady_clock;
+
+        Clock::time_point begin_;
+
+    public:
+        Stopwatch() noexcept
+            : begin_(Clock::now()) {
+        }
+
+        ~Stopwatch() noexcept = default;
+
+        inline const Self &Const() const noexcept {
+            return *this;
+        }
+
+        inline void Restart() noexcept {
+            this->begin_ = Clock::now();
+        }
+
+        inline double GetSeconds() const noexcept {
+            std::chrono::duration<double> duration{Clock::now() - this->begin_};
+            return duration.count();
+        }
+    };
+
+    // the outcome of one measured run
+    class BenchResult {
+    private:
+        using Self = simplebench::BenchResult;
+
+        bool status_;
+        std::string reason_;
+        std::size_t operations_;
+        double seconds_;
+        std::vector<std::pair<std::string, double>> metrics_;
+
+    public:
+        BenchResult(std::size_t operations, double seconds) noexcept
+            : status_(true)
+            , reason_()
+            , operations_(operations)
+            , seconds_(seconds)
+            , metrics_() {
+        }
+
+        explicit BenchResult(std::string reason) noexcept
+            : status_(false)
+            , reason_(std::move(reason))
+            , operations_(0)
+            , seconds_(0)
+            , metrics_() {
+        }
+
+        BenchResult(const Self &other) = default;
+
+        BenchResult(Self &&other) noexcept = default;
+
+        Self &operator=(const Self &other) = default;
+
+        Self &operator=(Self &&other) noexcept = default;
+
+        ~BenchResult() noexcept = default;
+
+        inline const Self &Const() const noexcept {
+            return *this;
+        }
+
+        inline bool Success() const noexcept {
+            return this->status_;
+        }
+
+        inline bool Fail() const noexcept {
+            return !this->status_;
+        }
+
+        inline const std::string &Reason() const noexcept {
+            return this->reason_;
+        }
+
+        inline std::size_t GetOperations() const noexcept {
+            return this->operations_;
+        }
+
+        inline double GetSeconds() const noexcept {
+            return this->seconds_;
+        }
+
+        inline double GetOpsPerSecond() const noexcept {
+            if (this->seconds_ <= 0) {
+                return 0;
+            }
+            return static_cast<double>(this->operations_) / this->seconds_;
+        }
+
+        inline double GetNanosecondsPerOp() const noexcept {
+            if (!this->operations_) {
+                return 0;
+            }
+            return this->seconds_ * 1e9 / static_cast<double>(this->operations_);
+        }
+
+        // an extra named value, e.g. "fsyncs_per_sec"
+        inline Self &AddMetric(std::string name, double value) {
+            this->metrics_.emplace_back(std::move(name), value);
+            return *this;
+        }
+
+        inline const std::vector<std::pair<std::string, double>> &Metrics() const noexcept {
+            return this->metrics_;
+        }
+    };
+}   // namespace simplebench
+
+#endif
@@ -0,0 +1,299 @@
+#pragma once
+#ifndef _SIMPLEBENCH_BENCHRUNNER_HPP
+#define _SIMPLEBENCH_BENCHRUNNER_HPP
+
+#include "IBench.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace simplebench {
+
+    // return the value of "--name=value" or nullptr
+    inline const char *GetOption(int argc, char const *argv[], const char *name) noexcept {
+        std::size_t length{std::strlen(name)};
+        for (int i = 1; i < argc; ++i) {
+            const char *arg{argv[i]};
+            if (arg[0] == '-' && arg[1] == '-' && !std::strncmp(arg + 2, name, length)) {
+                if (arg[length + 2] == '=') {
+                    return arg + length + 3;
+                }
+                if (arg[length + 2] == '\0') {
+                    return "";
+                }
+            }
+        }
+        return nullptr;
+    }
+
+    inline std::size_t GetOption(int argc,
+                                 char const *argv[],
+                                 const char *name,
+                                 std::size_t defaultValue) noexcept {
+        const char *value{simplebench::GetOption(argc, argv, name)};
+        if (!value || !*value) {
+            return defaultValue;
+        }
+        return static_cast<std::size_t>(std::strtoull(value, nullptr, 10));
+    }
+
+    // runs every benchmark once to warm up and then repeat times
+    // progress goes to stderr, the report is written as json
+    class BenchRunner {
+    private:
+        using Self = simplebench::BenchRunner;
+
+        struct Stats {
+            double min_;
+            double median_;
+            double max_;
+        };
+
+        struct Report {
+            std::string name_;
+            simplebench::BenchResult first_;
+            std::vector<simplebench::BenchResult> runs_;
+        };
+
+        std::string suite_;
+        std::vector<std::unique_ptr<simplebench::IBench>> benches_;
+        std::vector<std::pair<std::string, std::string>> context_;
+        std::size_t repeat_;
+        std::string filter_;
+        std::string output_;
+
+        template<typename _Fn>
+        static Stats ComputeStats(const std::vector<simplebench::BenchResult> &runs, _Fn fn) {
+            std::vector<double> values;
+            values.reserve(runs.size());
+            for (auto begin = runs.begin(), end = runs.end(); begin != end; ++begin) {
+                values.emplace_back(fn(*begin));
+            }
+            assert(!values.empty());
+            std::sort(values.begin(), values.end());
+            Stats stats;
+            stats.min_ = values.front();
+            stats.max_ = values.back();
+            stats.median_ = values[values.size() / 2];
+            if (values.size() % 2 == 0) {
+                stats.median_ = (values[values.size() / 2 - 1] + stats.median_) / 2;
+            }
+            return stats;
+        }
+
+        static void WriteString(FILE *fp, const std::string &str) {
+            std::fputc('"', fp);
+            for (auto begin = str.begin(), end = str.end(); begin != end; ++begin) {
+                char c{*begin};
+                if (c == '"' || c == '\\') {
+                    std::fputc('\\', fp);
+                    std::fputc(c, fp);
+                } else if (static_cast<unsigned char>(c) < 0x20) {
+                    std::fprintf(fp, "\\u%04x", static_cast<unsigned>(c));
+                } else {
+                    std::fputc(c, fp);
+                }
+            }
+            std::fputc('"', fp);
+        }
+
+        static void WriteStats(FILE *fp, const Stats &stats) {
+            std::fprintf(fp,
+                         "{\"min\": %.6g, \"median\": %.6g, \"max\": %.6g}",
+                         stats.min_,
+                         stats.median_,
+                         stats.max_);
+        }
+
+        void WriteReports(FILE *fp, const std::vector<Report> &reports) const {
+            std::fputs("{\n  \"suite\": ", fp);
+            Self::WriteString(fp, this->suite_);
+            std::fprintf(fp, ",\n  \"repeat\": %zu,\n  \"context\": {", this->repeat_);
+            for (std::size_t i = 0; i != this->context_.size(); ++i) {
+                std::fputs(i ? ", " : "", fp);
+                Self::WriteString(fp, this->context_[i].first);
+                std::fputs(": ", fp);
+                Self::WriteString(fp, this->context_[i].second);
+            }
+            std::fputs("},\n  \"benchmarks\": [", fp);
+            for (std::size_t i = 0; i != reports.size(); ++i) {
+                const Report &report{reports[i]};
+                std::fputs(i ? ",\n    {" : "\n    {", fp);
+                std::fputs("\"name\": ", fp);
+                Self::WriteString(fp, report.name_);
+                if (report.runs_.empty()) {
+                    std::fputs(", \"status\": \"failed\", \"reason\": ", fp);
+                    Self::WriteString(fp, report.first_.Reason());
+                    std::fputc('}', fp);
+                    continue;
+                }
+                std::fprintf(fp, ", \"status\": \"passed\", \"runs\": %zu", report.runs_.size());
+                std::fputs(",\n      \"operations\": ", fp);
+                Self::WriteStats(fp,
+                                 Self::ComputeStats(report.runs_,
+                                                    [](const simplebench::BenchResult &r) {
+                                                        return static_cast<double>(
+                                                            r.GetOperations());
+                                                    }));
+                std::fputs(",\n      \"seconds\": ", fp);
+                Self::WriteStats(
+                    fp, Self::ComputeStats(report.runs_, [](const simplebench::BenchResult &r) {
+                        return r.GetSeconds();
+                    }));
+                std::fputs(",\n      \"ops_per_sec\": ", fp);
+                Self::WriteStats(
+                    fp, Self::ComputeStats(report.runs_, [](const simplebench::BenchResult &r) {
+                        return r.GetOpsPerSecond();
+                    }));
+                std::fputs(",\n      \"ns_per_op\": ", fp);
+                Self::WriteStats(
+                    fp, Self::ComputeStats(report.runs_, [](const simplebench::BenchResult &r) {
+                        return r.GetNanosecondsPerOp();
+                    }));
+                std::fputs(",\n      \"metrics\": {", fp);
+                const auto &metrics{report.runs_.front().Metrics()};
+                for (std::size_t j = 0; j != metrics.size(); ++j) {
+                    std::fputs(j ? ",\n        " : "\n        ", fp);
+                    Self::WriteString(fp, metrics[j].first);
+                    std::fputs(": ", fp);
+                    Self::WriteStats(
+                        fp, Self::ComputeStats(report.runs_, [j](const simplebench::BenchResult &r) {
+                            return j < r.Metrics().size() ? r.Metrics()[j].second : 0;
+                        }));
+                }
+                std::fputs(metrics.empty() ? "}}" : "\n      }}", fp);
+            }
+            std::fputs("\n  ]\n}\n", fp);
+        }
+
+    public:
+        explicit BenchRunner(std::string suite)
+            : suite_(std::move(suite))
+            , benches_()
+            , context_()
+            , repeat_(3)
+            , filter_()
+            , output_() {
+            this->AddContext("hardware_concurrency",
+                             std::to_string(std::thread::hardware_concurrency()));
+        }
+
+        // --repeat=N --filter=substring --out=file.json
+        BenchRunner(std::string suite, int argc, char const *argv[])
+            : BenchRunner(std::move(suite)) {
+            this->repeat_ = (std::max)(
+                simplebench::GetOption(argc, argv, "repeat", this->repeat_), std::size_t{1});
+            const char *filter{simplebench::GetOption(argc, argv, "filter")};
+            if (filter) {
+                this->filter_ = filter;
+            }
+            const char *output{simplebench::GetOption(argc, argv, "out")};
+            if (output) {
+                this->output_ = output;
+            }
+        }
+
+        BenchRunner(const Self &other) = delete;
+
+        Self &operator=(const Self &other) = delete;
+
+        ~BenchRunner() noexcept = default;
+
+        inline const Self &Const() const noexcept {
+            return *this;
+        }
+
+        inline void AddContext(std::string key, std::string value) {
+            this->context_.emplace_back(std::move(key), std::move(value));
+        }
+
+        template<typename _Bench,
+                 typename... _Args,
+                 typename _Check =
+                     decltype(_Bench{std::declval<_Args>()...},
+                              std::declval<simplebench::IBench *&>() = std::declval<_Bench *>())>
+        inline void Register(_Args &&...args) {
+            simplebench::IBench *bench{new (std::nothrow) _Bench{std::forward<_Args>(args)...}};
+            if (!bench) {
+                // bad alloc
+                std::terminate();
+            }
+            std::unique_ptr<simplebench::IBench> benchPtr{bench};
+            try {
+                this->benches_.emplace_back(std::move(benchPtr));
+            } catch (const std::bad_alloc &fault) {
+                (void)fault;
+                std::terminate();
+            }
+        }
+
+        // return 0 if all benchmarks succeed
+        inline int Run(FILE *progress, FILE *output) {
+            std::vector<Report> reports;
+            int code{0};
+            for (std::size_t i = 0; i != this->benches_.size(); ++i) {
+                simplebench::IBench *bench{this->benches_[i].get()};
+                if (!this->filter_.empty() && bench->Name().find(this->filter_) == std::string::npos) {
+                    continue;
+                }
+                std::fprintf(progress,
+                             "[%zu/%zu]Running %s...",
+                             i + 1,
+                             this->benches_.size(),
+                             bench->Name().c_str());
+                std::fflush(progress);
+                Report report{bench->Name(), bench->Run(), {}};
+                if (report.first_.Success()) {
+                    for (std::size_t j = 0; j != this->repeat_; ++j) {
+                        simplebench::BenchResult result{bench->Run()};
+                        if (result.Fail()) {
+                            report.first_ = std::move(result);
+                            report.runs_.clear();
+                            break;
+                        }
+                        report.runs_.emplace_back(std::move(result));
+                    }
+                }
+                if (report.runs_.empty()) {
+                    std::fprintf(progress, "Failed - %s\n", report.first_.Reason().c_str());
+                    code = -1;
+                } else {
+                    Stats stats{Self::ComputeStats(report.runs_,
+                                                   [](const simplebench::BenchResult &r) {
+                                                       return r.GetOpsPerSecond();
+                                                   })};
+                    std::fprintf(progress, "%.6g ops/s\n", stats.median_);
+                }
+                reports.emplace_back(std::move(report));
+            }
+            this->WriteReports(output, reports);
+            std::fflush(output);
+            return code;
+        }
+
+        inline int Run() {
+            if (this->output_.empty()) {
+                return this->Run(stderr, stdout);
+            }
+            FILE *fp{std::fopen(this->output_.c_str(), "w")};
+            if (!fp) {
+                std::fprintf(stderr, "cannot open %s\n", this->output_.c_str());
+                return -1;
+            }
+            int code{this->Run(stderr, fp)};
+            std::fclose(fp);
+            return code;
+        }
+    };
+}   // namespace simplebench
+
+#endif
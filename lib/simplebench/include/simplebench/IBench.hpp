@@ -0,0 +1,74 @@
+#pragma once
+#ifndef _SIMPLEBENCH_IBENCH_HPP
+#define _SIMPLEBENCH_IBENCH_HPP
+
+#include <simpletest/ITest.hpp>
+
+#include "BenchResult.hpp"
+
+namespace simplebench {
+
+    class IBench {
+    private:
+        using Self = simplebench::IBench;
+
+    protected:
+        inline static simplebench::BenchResult Done(std::size_t operations,
+                                                    double seconds) noexcept {
+            return simplebench::BenchResult{operations, seconds};
+        }
+
+        inline static simplebench::BenchResult Fail(std::string reason) noexcept {
+            return simplebench::BenchResult{std::move(reason)};
+        }
+
+        std::string name_;
+
+    public:
+        IBench(std::string name) noexcept
+            : name_(std::move(name)) {
+        }
+
+        IBench(const Self &other) noexcept = delete;
+
+        IBench(Self &&other) noexcept = delete;
+
+        Self &operator=(const Self &other) noexcept = delete;
+
+        Self &operator=(Self &&other) noexcept = delete;
+
+        virtual ~IBench() noexcept = default;
+
+        inline const Self &Const() const noexcept {
+            return *this;
+        }
+
+        // one measured run
+        // the runner calls it once more before measuring to warm up
+        virtual simplebench::BenchResult Run() noexcept = 0;
+
+        inline const std::string &Name() const noexcept {
+            return this->name_;
+        }
+    };
+
+    template<typename _T>
+    class ITypenamedBench : public simplebench::IBench {
+    private:
+        using Self = simplebench::ITypenamedBench<_T>;
+        using Base = simplebench::IBench;
+
+    public:
+        ITypenamedBench() noexcept
+            : Base(simpletest::GetReadableTypeName<_T>()) {
+        }
+
+        virtual ~ITypenamedBench() noexcept = default;
+
+        inline const Self &Const() const noexcept {
+            return *this;
+        }
+    };
+}   // namespace simplebench
+
+#endif
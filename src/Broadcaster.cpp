@@ -9,7 +9,9 @@ sharpen::Broadcaster::Broadcaster(std::unique_ptr<sharpen::IRemoteActor> *actor,
     , index_(0)
     , pipelineLength_(pipeline)
     , sharedMails_()
-    , actors_() {
+    , actors_()
+    , stallLimit_(0)
+    , stalls_() {
     this->lock_.reset(new (std::nothrow) Lock{});
     if (!this->lock_) {
         throw std::bad_alloc{};
@@ -32,6 +34,36 @@ void sharpen::Broadcaster::Cancel() noexcept {
     }
 }
 
+bool sharpen::Broadcaster::CheckPipeline(const sharpen::ActorId &id,
+                                         sharpen::IRemoteActor &actor) noexcept {
+    if (actor.GetPipelineCount() < this->pipelineLength_) {
+        auto ite = this->stalls_.find(id);
+        if (ite != this->stalls_.end()) {
+            this->stalls_.erase(ite);
+        }
+        return true;
+    }
+    std::size_t stalls{0};
+    auto ite = this->stalls_.find(id);
+    if (ite != this->stalls_.end()) {
+        stalls = ite->second;
+    }
+    if (stalls >= this->stallLimit_) {
+        // the connection may be broken
+        actor.Cancel();
+        if (ite != this->stalls_.end()) {
+            this->stalls_.erase(ite);
+        }
+        return true;
+    }
+    try {
+        this->stalls_[id] = stalls + 1;
+    } catch (const std::exception &ignore) {
+        (void)ignore;
+    }
+    return false;
+}
+
 void sharpen::Broadcaster::Close() noexcept {
     for (auto begin = this->actors_.begin(), end = this->actors_.end(); begin != end; ++begin) {
         std::unique_ptr<sharpen::IRemoteActor> &actor{begin->second};
@@ -78,15 +110,38 @@ void sharpen::Broadcaster::Broadcast(const sharpen::IMailProvider &provider) {
         assert(this->pipelineLength_ != 0);
         assert(this->lock_);
         std::unique_lock<Lock> lock{*this->lock_};
-        this->Cancel();
         for (auto begin = this->actors_.begin(), end = this->actors_.end(); begin != end; ++begin) {
             std::unique_ptr<sharpen::IRemoteActor> &actor{begin->second};
+            // don't provide mail if we skip the actor
+            // so that the provider doesn't forward its state
+            if (!this->CheckPipeline(begin->first, *actor)) {
+                continue;
+            }
             sharpen::Mail mail{provider.Provide(actor->GetId())};
             actor->Post(std::move(mail));
         }
     }
 }
 
+bool sharpen::Broadcaster::Post(const sharpen::ActorId &id, sharpen::Mail mail) {
+    assert(this->lock_);
+    std::unique_lock<Lock> lock{*this->lock_};
+    auto ite = this->actors_.find(id);
+    if (ite == this->actors_.end()) {
+        return false;
+    }
+    ite->second->Post(std::move(mail));
+    return true;
+}
+
+bool sharpen::Broadcaster::Writable(const sharpen::ActorId &id) const noexcept {
+    const sharpen::IRemoteActor *actor{this->FindActor(id)};
+    if (!actor) {
+        return false;
+    }
+    return actor->GetPipelineCount() < this->pipelineLength_;
+}
+
 bool sharpen::Broadcaster::Completed() const noexcept {
     for (auto begin = this->actors_.begin(), end = this->actors_.end(); begin != end; ++begin) {
         const std::unique_ptr<sharpen::IRemoteActor> &actor{begin->second};
@@ -97,6 +152,20 @@ bool sharpen::Broadcaster::Completed() const noexcept {
     return true;
 }
 
+bool sharpen::Broadcaster::Saturated() const noexcept {
+    for (auto begin = this->actors_.begin(), end = this->actors_.end(); begin != end; ++begin) {
+        const std::unique_ptr<sharpen::IRemoteActor> &actor{begin->second};
+        if (actor->GetPipelineCount() >= this->pipelineLength_) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void sharpen::Broadcaster::SetStallLimit(std::size_t limit) noexcept {
+    this->stallLimit_ = limit;
+}
+
 const sharpen::IRemoteActor &sharpen::Broadcaster::GetActor(const sharpen::ActorId &actorId) const {
     auto actor{this->FindActor(actorId)};
     if (!actor) {
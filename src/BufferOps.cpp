@@ -1,6 +1,7 @@
 #include <sharpen/BufferOps.hpp>
 
 #include <sharpen/IntOps.hpp>
+#include <algorithm>
 #include <cassert>
 #include <utility>
 
@@ -182,42 +183,404 @@ std::uint32_t sharpen::Crc32Table[256] = {
 
     0xC30C8EA1, 0x5A05DF1B, 0x2D02EF8D};
 
-std::uint16_t sharpen::Crc16(const char *data, std::size_t size) noexcept {
-    sharpen::UintUnion<16> crc;
-    crc.value_ = 0xFFFF;
-    for (const std::uint8_t *begin = reinterpret_cast<const std::uint8_t *>(data),
-                            *end = begin + size;
-         begin != end;
-         ++begin) {
-        std::uint8_t index{static_cast<std::uint8_t>(crc.union_.height_ ^ *begin)};
-        crc.union_.height_ = crc.union_.low_ ^ Crc16TableHeight[index];
-        crc.union_.low_ = Crc16TableLow[index];
+namespace sharpen {
+    // tables of slicing-by-8
+    // tables_[0] is the classic byte-at-a-time table
+    template<typename _T>
+    class CrcTables {
+    private:
+        using Self = sharpen::CrcTables<_T>;
+
+    public:
+        _T tables_[8][256];
+
+        explicit CrcTables(_T poly) noexcept {
+            for (std::uint32_t i = 0; i != 256; ++i) {
+                _T crc{static_cast<_T>(i)};
+                for (std::size_t j = 0; j != 8; ++j) {
+                    crc = static_cast<_T>((crc & 1) ? (crc >> 1) ^ poly : crc >> 1);
+                }
+                this->tables_[0][i] = crc;
+            }
+            for (std::size_t i = 1; i != 8; ++i) {
+                for (std::size_t j = 0; j != 256; ++j) {
+                    _T crc{this->tables_[i - 1][j]};
+                    this->tables_[i][j] =
+                        static_cast<_T>((crc >> 8) ^ this->tables_[0][crc & 0xFF]);
+                }
+            }
+        }
+    };
+
+    // works with any byte order and alignment
+    // compilers turn it into a single load
+    inline static std::uint32_t LoadLittleEndian32(const std::uint8_t *data) noexcept {
+        return static_cast<std::uint32_t>(data[0]) | (static_cast<std::uint32_t>(data[1]) << 8) |
+               (static_cast<std::uint32_t>(data[2]) << 16) |
+               (static_cast<std::uint32_t>(data[3]) << 24);
+    }
+
+    // reflected crc of width 16 or 32 by slicing-by-8
+    template<typename _T>
+    inline static _T SliceBy8Crc(const sharpen::CrcTables<_T> &crcTables,
+                                 _T crc,
+                                 const std::uint8_t *data,
+                                 std::size_t size) noexcept {
+        const auto &tables = crcTables.tables_;
+        while (size >= 8) {
+            std::uint32_t one{sharpen::LoadLittleEndian32(data) ^ crc};
+            std::uint32_t two{sharpen::LoadLittleEndian32(data + 4)};
+            crc = static_cast<_T>(tables[7][one & 0xFF] ^ tables[6][(one >> 8) & 0xFF] ^
+                                  tables[5][(one >> 16) & 0xFF] ^ tables[4][one >> 24] ^
+                                  tables[3][two & 0xFF] ^ tables[2][(two >> 8) & 0xFF] ^
+                                  tables[1][(two >> 16) & 0xFF] ^ tables[0][two >> 24]);
+            data += 8;
+            size -= 8;
+        }
+        for (const std::uint8_t *end = data + size; data != end; ++data) {
+            crc = static_cast<_T>(tables[0][(crc ^ *data) & 0xFF] ^ (crc >> 8));
+        }
+        return crc;
+    }
+
+    // CRC16-MODBUS
+    constexpr static std::uint16_t crc16Poly{0xA001};
+
+    // CRC32
+    constexpr static std::uint32_t crc32Poly{0xEDB88320};
+
+    // CRC32C (Castagnoli)
+    constexpr static std::uint32_t crc32cPoly{0x82F63B78};
+
+    // largest n such that 255n(n+1)/2 + (n+1)(65521-1) <= 2^32-1
+    constexpr static std::size_t adler32Nmax{5552};
+
+    constexpr static std::uint32_t adler32Base{65521};
+
+    static std::uint32_t ScalarAdler32(std::uint32_t adler,
+                                       const std::uint8_t *data,
+                                       std::size_t size) noexcept {
+        std::uint32_t low{adler & 0xFFFF};
+        std::uint32_t height{adler >> 16};
+        // defer modulo until the sums might overflow
+        while (size) {
+            std::size_t count{(std::min)(size, adler32Nmax)};
+            size -= count;
+            for (const std::uint8_t *end = data + count; data != end; ++data) {
+                low += *data;
+                height += low;
+            }
+            low %= adler32Base;
+            height %= adler32Base;
+        }
+        return low | (height << 16);
+    }
+}   // namespace sharpen
+
+#if (defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)) &&         \
+    (defined(__GNUC__) || defined(_MSC_VER))
+#define SHARPEN_HAS_X86_CHECKSUM
+#endif
+
+#ifdef SHARPEN_HAS_X86_CHECKSUM
+#ifdef _MSC_VER
+#include <intrin.h>
+#define SHARPEN_TARGET(x)
+#else
+#include <cpuid.h>
+#define SHARPEN_TARGET(x) __attribute__((target(x)))
+#endif
+#include <nmmintrin.h>
+#include <tmmintrin.h>
+
+namespace sharpen {
+    // get ecx of cpuid leaf 1
+    static std::uint32_t GetCpuFeatures() noexcept {
+#ifdef _MSC_VER
+        int info[4]{0, 0, 0, 0};
+        __cpuid(info, 1);
+        return static_cast<std::uint32_t>(info[2]);
+#else
+        unsigned int eax{0};
+        unsigned int ebx{0};
+        unsigned int ecx{0};
+        unsigned int edx{0};
+        if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+            return 0;
+        }
+        return ecx;
+#endif
+    }
+
+    constexpr static std::uint32_t cpuSsse3{1u << 9};
+
+    constexpr static std::uint32_t cpuSse42{1u << 20};
+
+    // the crc32 instruction has a latency of 3 cycles
+    // but a throughput of 1 cycle
+    // so compute 3 independent streams and shift them together
+    constexpr static std::size_t crc32cLongBlock{8192};
+
+    constexpr static std::size_t crc32cShortBlock{256};
+
+    // multiply a 32x32 gf(2) matrix by a vector
+    static std::uint32_t Gf2MatrixTimes(const std::uint32_t *mat, std::uint32_t vec) noexcept {
+        std::uint32_t sum{0};
+        while (vec) {
+            if (vec & 1) {
+                sum ^= *mat;
+            }
+            vec >>= 1;
+            mat += 1;
+        }
+        return sum;
+    }
+
+    static void Gf2MatrixSquare(std::uint32_t *square, const std::uint32_t *mat) noexcept {
+        for (std::size_t i = 0; i != 32; ++i) {
+            square[i] = sharpen::Gf2MatrixTimes(mat, mat[i]);
+        }
+    }
+
+    // tables that append size zero bytes to a crc32c
+    class Crc32cShiftTables {
+    private:
+        using Self = sharpen::Crc32cShiftTables;
+
+    public:
+        std::uint32_t tables_[4][256];
+
+        explicit Crc32cShiftTables(std::size_t size) noexcept {
+            std::uint32_t even[32];
+            std::uint32_t odd[32];
+            // the operator for one zero bit
+            odd[0] = crc32cPoly;
+            std::uint32_t row{1};
+            for (std::size_t i = 1; i != 32; ++i) {
+                odd[i] = row;
+                row <<= 1;
+            }
+            // 2 zero bits
+            sharpen::Gf2MatrixSquare(even, odd);
+            // 4 zero bits
+            sharpen::Gf2MatrixSquare(odd, even);
+            // 8 zero bits per iteration
+            // size must be a power of 2
+            const std::uint32_t *op{nullptr};
+            while (true) {
+                sharpen::Gf2MatrixSquare(even, odd);
+                size >>= 1;
+                if (!size) {
+                    op = even;
+                    break;
+                }
+                sharpen::Gf2MatrixSquare(odd, even);
+                size >>= 1;
+                if (!size) {
+                    op = odd;
+                    break;
+                }
+            }
+            for (std::uint32_t i = 0; i != 256; ++i) {
+                this->tables_[0][i] = sharpen::Gf2MatrixTimes(op, i);
+                this->tables_[1][i] = sharpen::Gf2MatrixTimes(op, i << 8);
+                this->tables_[2][i] = sharpen::Gf2MatrixTimes(op, i << 16);
+                this->tables_[3][i] = sharpen::Gf2MatrixTimes(op, i << 24);
+            }
+        }
+
+        inline std::uint32_t Shift(std::uint32_t crc) const noexcept {
+            return this->tables_[0][crc & 0xFF] ^ this->tables_[1][(crc >> 8) & 0xFF] ^
+                   this->tables_[2][(crc >> 16) & 0xFF] ^ this->tables_[3][crc >> 24];
+        }
+    };
+
+#if defined(__x86_64__) || defined(_M_X64)
+    using Crc32cWord = std::uint64_t;
+
+    SHARPEN_TARGET("sse4.2")
+    inline static std::uint32_t Crc32cStep(std::uint32_t crc, const std::uint8_t *data) noexcept {
+        std::uint64_t word;
+        std::memcpy(&word, data, sizeof(word));
+        return static_cast<std::uint32_t>(_mm_crc32_u64(crc, word));
+    }
+#else
+    using Crc32cWord = std::uint32_t;
+
+    SHARPEN_TARGET("sse4.2")
+    inline static std::uint32_t Crc32cStep(std::uint32_t crc, const std::uint8_t *data) noexcept {
+        std::uint32_t word;
+        std::memcpy(&word, data, sizeof(word));
+        return _mm_crc32_u32(crc, word);
+    }
+#endif
+
+    SHARPEN_TARGET("sse4.2")
+    static std::uint32_t Crc32cInterleave(std::uint32_t crc,
+                                          const std::uint8_t *&data,
+                                          std::size_t &size,
+                                          std::size_t block,
+                                          const sharpen::Crc32cShiftTables &shift) noexcept {
+        while (size >= block * 3) {
+            std::uint32_t crc1{0};
+            std::uint32_t crc2{0};
+            for (const std::uint8_t *end = data + block; data != end;
+                 data += sizeof(Crc32cWord)) {
+                crc = sharpen::Crc32cStep(crc, data);
+                crc1 = sharpen::Crc32cStep(crc1, data + block);
+                crc2 = sharpen::Crc32cStep(crc2, data + block * 2);
+            }
+            crc = shift.Shift(crc) ^ crc1;
+            crc = shift.Shift(crc) ^ crc2;
+            data += block * 2;
+            size -= block * 3;
+        }
+        return crc;
     }
-    std::swap(crc.union_.low_, crc.union_.height_);
-    return crc.value_;
+
+    SHARPEN_TARGET("sse4.2")
+    static std::uint32_t HardwareCrc32c(std::uint32_t crc,
+                                        const std::uint8_t *data,
+                                        std::size_t size) noexcept {
+        static const sharpen::Crc32cShiftTables longShift{crc32cLongBlock};
+        static const sharpen::Crc32cShiftTables shortShift{crc32cShortBlock};
+        // align data
+        while (size && (reinterpret_cast<std::uintptr_t>(data) & (sizeof(Crc32cWord) - 1))) {
+            crc = _mm_crc32_u8(crc, *data);
+            data += 1;
+            size -= 1;
+        }
+        crc = sharpen::Crc32cInterleave(crc, data, size, crc32cLongBlock, longShift);
+        crc = sharpen::Crc32cInterleave(crc, data, size, crc32cShortBlock, shortShift);
+        while (size >= sizeof(Crc32cWord)) {
+            crc = sharpen::Crc32cStep(crc, data);
+            data += sizeof(Crc32cWord);
+            size -= sizeof(Crc32cWord);
+        }
+        for (const std::uint8_t *end = data + size; data != end; ++data) {
+            crc = _mm_crc32_u8(crc, *data);
+        }
+        return crc;
+    }
+
+    SHARPEN_TARGET("ssse3")
+    static std::uint32_t Ssse3Adler32(std::uint32_t adler,
+                                      const std::uint8_t *data,
+                                      std::size_t size) noexcept {
+        constexpr std::size_t blockSize{32};
+        std::uint32_t low{adler & 0xFFFF};
+        std::uint32_t height{adler >> 16};
+        std::size_t blocks{size / blockSize};
+        size -= blocks * blockSize;
+        const __m128i tap1{
+            _mm_setr_epi8(32, 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17)};
+        const __m128i tap2{_mm_setr_epi8(16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1)};
+        const __m128i zero{_mm_setzero_si128()};
+        const __m128i ones{_mm_set1_epi16(1)};
+        while (blocks) {
+            std::size_t count{(std::min)(blocks, adler32Nmax / blockSize)};
+            blocks -= count;
+            // sum of low before each block
+            __m128i prevLows{_mm_set_epi32(0, 0, 0, static_cast<int>(low * count))};
+            __m128i heights{_mm_set_epi32(0, 0, 0, static_cast<int>(height))};
+            __m128i lows{_mm_setzero_si128()};
+            for (std::size_t i = 0; i != count; ++i) {
+                const __m128i bytes1{_mm_loadu_si128(reinterpret_cast<const __m128i *>(data))};
+                const __m128i bytes2{
+                    _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 16))};
+                prevLows = _mm_add_epi32(prevLows, lows);
+                lows = _mm_add_epi32(lows, _mm_sad_epu8(bytes1, zero));
+                heights = _mm_add_epi32(heights,
+                                        _mm_madd_epi16(_mm_maddubs_epi16(bytes1, tap1), ones));
+                lows = _mm_add_epi32(lows, _mm_sad_epu8(bytes2, zero));
+                heights = _mm_add_epi32(heights,
+                                        _mm_madd_epi16(_mm_maddubs_epi16(bytes2, tap2), ones));
+                data += blockSize;
+            }
+            heights = _mm_add_epi32(heights, _mm_slli_epi32(prevLows, 5));
+            // horizontal sums
+            lows = _mm_add_epi32(lows, _mm_shuffle_epi32(lows, _MM_SHUFFLE(2, 3, 0, 1)));
+            lows = _mm_add_epi32(lows, _mm_shuffle_epi32(lows, _MM_SHUFFLE(1, 0, 3, 2)));
+            low += static_cast<std::uint32_t>(_mm_cvtsi128_si32(lows));
+            heights = _mm_add_epi32(heights, _mm_shuffle_epi32(heights, _MM_SHUFFLE(2, 3, 0, 1)));
+            heights = _mm_add_epi32(heights, _mm_shuffle_epi32(heights, _MM_SHUFFLE(1, 0, 3, 2)));
+            height = static_cast<std::uint32_t>(_mm_cvtsi128_si32(heights));
+            low %= adler32Base;
+            height %= adler32Base;
+        }
+        return sharpen::ScalarAdler32(low | (height << 16), data, size);
+    }
+}   // namespace sharpen
+#endif
+
+namespace sharpen {
+    using ChecksumKernel = std::uint32_t (*)(std::uint32_t, const std::uint8_t *, std::size_t);
+
+    static const sharpen::CrcTables<std::uint16_t> &GetCrc16Tables() noexcept {
+        static const sharpen::CrcTables<std::uint16_t> tables{crc16Poly};
+        return tables;
+    }
+
+    static const sharpen::CrcTables<std::uint32_t> &GetCrc32Tables() noexcept {
+        static const sharpen::CrcTables<std::uint32_t> tables{crc32Poly};
+        return tables;
+    }
+
+    static std::uint32_t SliceBy8Crc32c(std::uint32_t crc,
+                                        const std::uint8_t *data,
+                                        std::size_t size) noexcept {
+        static const sharpen::CrcTables<std::uint32_t> tables{crc32cPoly};
+        return sharpen::SliceBy8Crc(tables, crc, data, size);
+    }
+
+    // select kernels by cpuid once
+    static sharpen::ChecksumKernel SelectCrc32cKernel() noexcept {
+#ifdef SHARPEN_HAS_X86_CHECKSUM
+        if (sharpen::GetCpuFeatures() & cpuSse42) {
+            return &sharpen::HardwareCrc32c;
+        }
+#endif
+        return &sharpen::SliceBy8Crc32c;
+    }
+
+    static sharpen::ChecksumKernel SelectAdler32Kernel() noexcept {
+#ifdef SHARPEN_HAS_X86_CHECKSUM
+        if (sharpen::GetCpuFeatures() & cpuSsse3) {
+            return &sharpen::Ssse3Adler32;
+        }
+#endif
+        return &sharpen::ScalarAdler32;
+    }
+}   // namespace sharpen
+
+std::uint16_t sharpen::Crc16(const char *data, std::size_t size) noexcept {
+    return sharpen::SliceBy8Crc(sharpen::GetCrc16Tables(),
+                                static_cast<std::uint16_t>(0xFFFF),
+                                reinterpret_cast<const std::uint8_t *>(data),
+                                size);
 }
 
 std::uint32_t sharpen::Crc32(const char *data, std::size_t size) noexcept {
-    std::uint32_t crc = 0xFFFFFFFF;
-    for (const std::uint8_t *begin = reinterpret_cast<const std::uint8_t *>(data),
-                            *end = begin + size;
-         begin != end;
-         ++begin) {
-        crc = sharpen::Crc32Table[(crc ^ *begin) & 0xFF] ^ (crc >> 8);
-    }
+    std::uint32_t crc{sharpen::SliceBy8Crc(sharpen::GetCrc32Tables(),
+                                           static_cast<std::uint32_t>(0xFFFFFFFF),
+                                           reinterpret_cast<const std::uint8_t *>(data),
+                                           size)};
+    return crc ^ 0xFFFFFFFF;
+}
+
+std::uint32_t sharpen::Crc32c(const char *data, std::size_t size) noexcept {
+    return sharpen::Crc32c(0, data, size);
+}
+
+std::uint32_t sharpen::Crc32c(std::uint32_t crc, const char *data, std::size_t size) noexcept {
+    static const sharpen::ChecksumKernel kernel{sharpen::SelectCrc32cKernel()};
+    crc = kernel(crc ^ 0xFFFFFFFF, reinterpret_cast<const std::uint8_t *>(data), size);
     return crc ^ 0xFFFFFFFF;
 }
 
 std::uint32_t sharpen::Adler32(const char *data, std::size_t size) noexcept {
-    sharpen::UintUnion<32> adler32{};
-    adler32.union_.low_ = 1;
-    for (const char *end = data + size; data != end; ++data) {
-        adler32.union_.low_ += *data;
-        adler32.union_.low_ %= 65521;
-        adler32.union_.height_ += adler32.union_.low_;
-        adler32.union_.height_ %= 65521;
-    }
-    return adler32.value_;
+    static const sharpen::ChecksumKernel kernel{sharpen::SelectAdler32Kernel()};
+    return kernel(1, reinterpret_cast<const std::uint8_t *>(data), size);
 }
 
 std::size_t sharpen::ComputeBase64EncodeSize(std::size_t size) noexcept {
@@ -140,6 +140,8 @@ sharpen::Dentry sharpen::Directory::InternalGetNextEntry() const {
         }
         this->handle_ = dir;
     }
+    // readdir() does not reset errno
+    errno = 0;
     dirent *dentry{::readdir(reinterpret_cast<DIR *>(this->handle_))};
     if (dentry != nullptr) {
         if (dentry->d_type == DT_DIR) {
@@ -0,0 +1,421 @@
+#include <sharpen/DnsResolver.hpp>
+
+#include <sharpen/INetStreamChannel.hpp>
+#include <sharpen/TimerRef.hpp>
+#include <algorithm>
+#include <cctype>
+#include <functional>
+#include <mutex>
+#include <new>
+#include <random>
+#include <stdexcept>
+#include <system_error>
+
+#ifdef SHARPEN_IS_WIN
+#include <ws2tcpip.h>
+#else
+#include <arpa/inet.h>
+#endif
+
+static constexpr std::uint16_t dnsRdFlag{0x0100};
+static constexpr std::uint16_t dnsQrFlag{0x8000};
+static constexpr std::uint16_t dnsTcFlag{0x0200};
+static constexpr std::uint16_t dnsClassIn{1};
+static constexpr std::uint16_t dnsRcodeServerFailure{2};
+static constexpr std::uint16_t dnsRcodeNameError{3};
+static constexpr std::size_t dnsHeaderSize{12};
+static constexpr std::size_t dnsRecordHeaderSize{10};
+static constexpr std::size_t dnsMaxNameLength{255};
+static constexpr std::size_t dnsMaxLabelLength{63};
+
+static inline std::uint16_t ReadUint16(const char *p) noexcept {
+    const unsigned char *bytes{reinterpret_cast<const unsigned char *>(p)};
+    return static_cast<std::uint16_t>((bytes[0] << 8) | bytes[1]);
+}
+
+static inline std::uint32_t ReadUint32(const char *p) noexcept {
+    const unsigned char *bytes{reinterpret_cast<const unsigned char *>(p)};
+    return (static_cast<std::uint32_t>(bytes[0]) << 24) |
+           (static_cast<std::uint32_t>(bytes[1]) << 16) |
+           (static_cast<std::uint32_t>(bytes[2]) << 8) | static_cast<std::uint32_t>(bytes[3]);
+}
+
+static inline void WriteUint16(char *p, std::uint16_t val) noexcept {
+    p[0] = static_cast<char>(val >> 8);
+    p[1] = static_cast<char>(val & 0xff);
+}
+
+// return the offset after the name
+// or 0 if the name is malformed
+static std::size_t SkipName(const char *buf, std::size_t size, std::size_t offset) noexcept {
+    while (offset < size) {
+        std::uint8_t length{static_cast<std::uint8_t>(buf[offset])};
+        if (!length) {
+            return offset + 1;
+        }
+        // compression pointer
+        if ((length & 0xc0) == 0xc0) {
+            return offset + 2 <= size ? offset + 2 : 0;
+        }
+        if (length & 0xc0) {
+            return 0;
+        }
+        offset += length + 1;
+    }
+    return 0;
+}
+
+// decompress the name at offset
+// return false if the name is malformed
+static bool ReadName(const char *buf, std::size_t size, std::size_t offset, std::string &name) {
+    name.clear();
+    // bound the number of pointers to avoid loops
+    std::size_t jumps{0};
+    while (offset < size) {
+        std::uint8_t length{static_cast<std::uint8_t>(buf[offset])};
+        if (!length) {
+            return true;
+        }
+        if ((length & 0xc0) == 0xc0) {
+            if (offset + 2 > size || ++jumps > dnsMaxNameLength) {
+                return false;
+            }
+            offset = ReadUint16(buf + offset) & 0x3fff;
+            continue;
+        }
+        if ((length & 0xc0) || offset + length + 1 > size) {
+            return false;
+        }
+        if (!name.empty()) {
+            name.push_back('.');
+        }
+        name.append(buf + offset + 1, length);
+        if (name.size() > dnsMaxNameLength) {
+            return false;
+        }
+        offset += length + 1;
+    }
+    return false;
+}
+
+static std::uint16_t MakeQueryIdSeed() {
+    std::random_device device;
+    return static_cast<std::uint16_t>(device());
+}
+
+sharpen::DnsResolver::DnsResolver(sharpen::IEventLoopGroup &loopGroup,
+                                  const sharpen::IpEndPoint &nameserver)
+    : loopGroup_(&loopGroup)
+    , timerPool_(loopGroup)
+    , nameserver_(nameserver)
+    , timeout_(1000)
+    , retryCount_(2)
+    , negativeTtl_(30)
+    , maxTtl_(3600)
+    , nextId_(MakeQueryIdSeed())
+    , shards_() {
+}
+
+std::string sharpen::DnsResolver::MakeKey(const char *name, std::uint16_t type) {
+    std::string key{name};
+    // "example.com." and "example.com" are the same name
+    if (!key.empty() && key.back() == '.') {
+        key.pop_back();
+    }
+    for (auto begin = key.begin(), end = key.end(); begin != end; ++begin) {
+        *begin = static_cast<char>(std::tolower(static_cast<unsigned char>(*begin)));
+    }
+    key.push_back('/');
+    key.append(std::to_string(type));
+    return key;
+}
+
+sharpen::DnsResolver::CacheShard &sharpen::DnsResolver::GetShard(const std::string &key) noexcept {
+    std::size_t hash{std::hash<std::string>{}(key)};
+    return this->shards_[hash % shardCount_];
+}
+
+bool sharpen::DnsResolver::LookupCache(const std::string &key, CacheEntry &entry) {
+    CacheShard &shard{this->GetShard(key)};
+    Clock::time_point now{Clock::now()};
+    std::unique_lock<sharpen::SpinLock> lock{shard.lock_};
+    auto ite = shard.entries_.find(key);
+    if (ite == shard.entries_.end()) {
+        return false;
+    }
+    if (ite->second.deadline_ <= now) {
+        shard.entries_.erase(ite);
+        return false;
+    }
+    entry = ite->second;
+    return true;
+}
+
+void sharpen::DnsResolver::StoreCache(const std::string &key, CacheEntry entry) {
+    CacheShard &shard{this->GetShard(key)};
+    Clock::time_point now{Clock::now()};
+    std::unique_lock<sharpen::SpinLock> lock{shard.lock_};
+    if (shard.entries_.size() >= maxShardEntries_) {
+        for (auto begin = shard.entries_.begin(); begin != shard.entries_.end();) {
+            if (begin->second.deadline_ <= now) {
+                begin = shard.entries_.erase(begin);
+            } else {
+                ++begin;
+            }
+        }
+        if (shard.entries_.size() >= maxShardEntries_) {
+            shard.entries_.erase(shard.entries_.begin());
+        }
+    }
+    shard.entries_[key] = std::move(entry);
+}
+
+void sharpen::DnsResolver::ClearCache() noexcept {
+    for (std::size_t i = 0; i != shardCount_; ++i) {
+        std::unique_lock<sharpen::SpinLock> lock{this->shards_[i].lock_};
+        this->shards_[i].entries_.clear();
+    }
+}
+
+std::size_t sharpen::DnsResolver::GetCacheSize() noexcept {
+    std::size_t size{0};
+    for (std::size_t i = 0; i != shardCount_; ++i) {
+        std::unique_lock<sharpen::SpinLock> lock{this->shards_[i].lock_};
+        size += this->shards_[i].entries_.size();
+    }
+    return size;
+}
+
+std::size_t sharpen::DnsResolver::BuildQuery(const char *name,
+                                             std::uint16_t id,
+                                             std::uint16_t type,
+                                             char *buf,
+                                             std::size_t size) {
+    std::size_t nameLength{std::strlen(name)};
+    if (nameLength && name[nameLength - 1] == '.') {
+        nameLength -= 1;
+    }
+    if (!nameLength || nameLength > dnsMaxNameLength - 2) {
+        throw std::invalid_argument("invalid domain name");
+    }
+    // header + labels + root + qtype + qclass
+    std::size_t querySize{dnsHeaderSize + nameLength + 2 + 4};
+    assert(querySize <= size);
+    (void)size;
+    std::memset(buf, 0, dnsHeaderSize);
+    WriteUint16(buf, id);
+    WriteUint16(buf + 2, dnsRdFlag);
+    // qdcount
+    WriteUint16(buf + 4, 1);
+    char *label{buf + dnsHeaderSize};
+    char *p{label + 1};
+    for (std::size_t i = 0; i != nameLength; ++i) {
+        if (name[i] == '.') {
+            std::size_t labelLength{static_cast<std::size_t>(p - label - 1)};
+            if (!labelLength || labelLength > dnsMaxLabelLength) {
+                throw std::invalid_argument("invalid domain name");
+            }
+            *label = static_cast<char>(labelLength);
+            label = p;
+            p += 1;
+            continue;
+        }
+        *p++ = name[i];
+    }
+    std::size_t labelLength{static_cast<std::size_t>(p - label - 1)};
+    if (!labelLength || labelLength > dnsMaxLabelLength) {
+        throw std::invalid_argument("invalid domain name");
+    }
+    *label = static_cast<char>(labelLength);
+    *p++ = 0;
+    WriteUint16(p, type);
+    WriteUint16(p + 2, dnsClassIn);
+    return querySize;
+}
+
+bool sharpen::DnsResolver::ParseReply(const char *buf,
+                                      std::size_t size,
+                                      std::uint16_t id,
+                                      std::uint16_t type,
+                                      CacheEntry &entry) const {
+    if (size < dnsHeaderSize || ReadUint16(buf) != id) {
+        return false;
+    }
+    std::uint16_t flags{ReadUint16(buf + 2)};
+    if (!(flags & dnsQrFlag)) {
+        return false;
+    }
+    std::uint16_t rcode{static_cast<std::uint16_t>(flags & 0xf)};
+    std::size_t questionCount{ReadUint16(buf + 4)};
+    std::size_t answerCount{ReadUint16(buf + 6)};
+    std::size_t authorityCount{ReadUint16(buf + 8)};
+    std::size_t offset{dnsHeaderSize};
+    for (std::size_t i = 0; i != questionCount; ++i) {
+        offset = SkipName(buf, size, offset);
+        if (!offset || offset + 4 > size) {
+            return false;
+        }
+        offset += 4;
+    }
+    entry.error_ = 0;
+    entry.records_.clear();
+    entry.canonname_.clear();
+    std::uint32_t ttl{UINT32_MAX};
+    for (std::size_t i = 0; i != answerCount; ++i) {
+        offset = SkipName(buf, size, offset);
+        if (!offset || offset + dnsRecordHeaderSize > size) {
+            // a truncated reply keeps the records parsed so far
+            break;
+        }
+        std::uint16_t recordType{ReadUint16(buf + offset)};
+        std::uint16_t recordClass{ReadUint16(buf + offset + 2)};
+        std::uint32_t recordTtl{ReadUint32(buf + offset + 4)};
+        std::size_t length{ReadUint16(buf + offset + 8)};
+        offset += dnsRecordHeaderSize;
+        if (offset + length > size) {
+            break;
+        }
+        if (recordClass == dnsClassIn) {
+            if (recordType == type &&
+                ((type == typeA_ && length == 4) || (type == typeAaaa_ && length == 16))) {
+                Record record;
+                record.af_ = type == typeA_ ? sharpen::AddressFamily::Ip
+                                            : sharpen::AddressFamily::Ipv6;
+                std::memcpy(record.addr_, buf + offset, length);
+                entry.records_.push_back(record);
+                ttl = (std::min)(ttl, recordTtl);
+            } else if (recordType == typeCname_) {
+                // the last alias in the chain is the canonical name
+                if (!ReadName(buf, size, offset, entry.canonname_)) {
+                    entry.canonname_.clear();
+                }
+                ttl = (std::min)(ttl, recordTtl);
+            }
+        }
+        offset += length;
+    }
+    if (rcode == 0 && !entry.records_.empty()) {
+        entry.deadline_ = Clock::now() + (std::min)(std::chrono::seconds{ttl}, this->maxTtl_);
+        return true;
+    }
+    entry.records_.clear();
+    if (rcode == dnsRcodeNameError) {
+        entry.error_ = sharpen::ErrorNetDbHostNotFound;
+    } else if (rcode == 0) {
+        entry.error_ = sharpen::ErrorNetdbNoData;
+    } else if (rcode == dnsRcodeServerFailure) {
+        entry.error_ = sharpen::ErrorNetDbTryAgain;
+        entry.deadline_ = Clock::now();
+        return true;
+    } else {
+        entry.error_ = sharpen::ErrorNetdbNoRecovery;
+        entry.deadline_ = Clock::now();
+        return true;
+    }
+    // negative ttl is min(soa ttl, soa minimum), see rfc 2308
+    std::chrono::seconds negativeTtl{this->negativeTtl_};
+    if (!(flags & dnsTcFlag) && offset <= size) {
+        for (std::size_t i = 0; i != authorityCount; ++i) {
+            offset = SkipName(buf, size, offset);
+            if (!offset || offset + dnsRecordHeaderSize > size) {
+                break;
+            }
+            std::uint16_t recordType{ReadUint16(buf + offset)};
+            std::uint32_t recordTtl{ReadUint32(buf + offset + 4)};
+            std::size_t length{ReadUint16(buf + offset + 8)};
+            offset += dnsRecordHeaderSize;
+            if (offset + length > size) {
+                break;
+            }
+            if (recordType == typeSoa_ && length >= 20) {
+                std::uint32_t minimum{ReadUint32(buf + offset + length - 4)};
+                negativeTtl = std::chrono::seconds{(std::min)(recordTtl, minimum)};
+                break;
+            }
+            offset += length;
+        }
+    }
+    entry.deadline_ = Clock::now() + (std::min)(negativeTtl, this->maxTtl_);
+    return true;
+}
+
+sharpen::DnsResolver::CacheEntry sharpen::DnsResolver::Query(const char *name,
+                                                             std::uint16_t type) {
+    char query[maxMessageSize_];
+    char reply[maxMessageSize_];
+    CacheEntry entry;
+    sharpen::UniquedTimerRef timer{this->timerPool_};
+    for (std::size_t i = 0; i <= this->retryCount_; ++i) {
+        std::uint16_t id{this->nextId_.fetch_add(1, std::memory_order_relaxed)};
+        std::size_t size{Self::BuildQuery(name, id, type, query, sizeof(query))};
+        try {
+            // a fresh socket per attempt
+            // late replies of previous attempts are never read
+            sharpen::NetStreamChannelPtr channel{
+                sharpen::OpenUdpChannel(sharpen::AddressFamily::Ip)};
+            channel->Register(*this->loopGroup_);
+            channel->ConnectAsync(this->nameserver_);
+            channel->WriteAsync(query, size);
+            sharpen::Optional<std::size_t> result{
+                channel->ReadWithTimeout(timer.Timer(), this->timeout_, reply, sizeof(reply))};
+            if (result.Exist() && this->ParseReply(reply, result.Get(), id, type, entry)) {
+                return entry;
+            }
+        } catch (const std::system_error &error) {
+            // e.g. icmp port unreachable
+            // try again
+            (void)error;
+        }
+    }
+    entry.error_ = sharpen::ErrorNetDbTryAgain;
+    entry.deadline_ = Clock::now();
+    return entry;
+}
+
+sharpen::DnsResolver::CacheEntry sharpen::DnsResolver::Lookup(const char *name,
+                                                              std::uint16_t type) {
+    std::string key{Self::MakeKey(name, type)};
+    CacheEntry entry;
+    if (this->LookupCache(key, entry)) {
+        return entry;
+    }
+    entry = this->Query(name, type);
+    if (entry.deadline_ > Clock::now()) {
+        this->StoreCache(key, entry);
+    }
+    return entry;
+}
+
+sharpen::DnsResolveResult sharpen::DnsResolver::ConvertRecordToResolveResult(
+    const Record &record, const std::string &canonname) {
+    sharpen::DnsResolveResult r;
+    r.SetAddressFamily(record.af_);
+    if (!canonname.empty()) {
+        r.Canonname() = sharpen::ByteBuffer{canonname.data(), canonname.size()};
+    }
+    if (record.af_ == sharpen::AddressFamily::Ip) {
+        std::uint32_t addr{0};
+        std::memcpy(&addr, record.addr_, sizeof(addr));
+        r.EndPointPtr().reset(new (std::nothrow) sharpen::IpEndPoint{addr, 0});
+    } else {
+        in6_addr addr;
+        std::memcpy(&addr, record.addr_, sizeof(addr));
+        r.EndPointPtr().reset(new (std::nothrow) sharpen::Ipv6EndPoint{addr, 0});
+    }
+    if (!r.EndPointPtr()) {
+        throw std::bad_alloc{};
+    }
+    return r;
+}
+
+bool sharpen::DnsResolver::TryParseLiteral(const char *name, Record &record) noexcept {
+    if (::inet_pton(AF_INET, name, record.addr_) == 1) {
+        record.af_ = sharpen::AddressFamily::Ip;
+        return true;
+    }
+    if (::inet_pton(AF_INET6, name, record.addr_) == 1) {
+        record.af_ = sharpen::AddressFamily::Ipv6;
+        return true;
+    }
+    return false;
+}
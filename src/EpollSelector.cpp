@@ -3,38 +3,136 @@
 #ifdef SHARPEN_HAS_EPOLL
 
 #include <fcntl.h>
+#include <sys/resource.h>
 #include <cassert>
 #include <limits>
 #include <mutex>
 #include <new>
 
 sharpen::EpollSelector::EpollSelector()
+    : EpollSelector(sharpen::NetIoMethod::Readiness) {
+}
+
+sharpen::EpollSelector::EpollSelector(sharpen::NetIoMethod netIoMethod)
+#if (defined SHARPEN_HAS_IOURING) && (defined SHARPEN_IOURING_SQPOLL)
+    : EpollSelector(SHARPEN_IOURING_DEPTH, true, netIoMethod)
+#elif (defined SHARPEN_HAS_IOURING)
+    : EpollSelector(SHARPEN_IOURING_DEPTH, false, netIoMethod)
+#else
+    : EpollSelector(0, false, netIoMethod)
+#endif
+{
+}
+
+sharpen::EpollSelector::EpollSelector(std::uint32_t ringDepth, bool sqPoll)
+    : EpollSelector(ringDepth, sqPoll, sharpen::NetIoMethod::Readiness) {
+}
+
+sharpen::EpollSelector::EpollSelector(std::uint32_t ringDepth,
+                                      bool sqPoll,
+                                      sharpen::NetIoMethod netIoMethod)
     : epoll_()
     , eventfd_(0, O_CLOEXEC | O_NONBLOCK)
-    , map_()
+    , pages_(nullptr)
+    , pageCount_((Self::GetMaxHandles() + Self::pageSize_ - 1) >> Self::pageBits_)
+    , handleBound_(0)
     , eventBuf_(Self::minEventBufLength_)
+    , idleRounds_(0)
     , lock_()
 #ifdef SHARPEN_HAS_IOURING
     , ring_(nullptr)
     , cqes_(Self::minCqesLength_)
 #endif
-{
+    , netIoMethod_(sharpen::NetIoMethod::Readiness) {
+    this->pages_.reset(new (std::nothrow) std::atomic<Event *>[this->pageCount_]);
+    if (!this->pages_) {
+        throw std::bad_alloc{};
+    }
+    for (std::size_t i = 0; i != this->pageCount_; ++i) {
+        this->pages_[i].store(nullptr, std::memory_order_relaxed);
+    }
     // register event fd
     this->RegisterInternalEventFd(this->eventfd_.GetHandle(), 1);
 #ifdef SHARPEN_HAS_IOURING
     if (sharpen::TestIoUring()) {
-        this->ring_.reset(new (std::nothrow) sharpen::IoUringQueue());
+        this->ring_.reset(new (std::nothrow) sharpen::IoUringQueue(false, ringDepth, sqPoll));
         if (!this->ring_) {
             throw std::bad_alloc{};
         }
         this->RegisterInternalEventFd(this->ring_->EventFd().GetHandle(), 2);
+        this->netIoMethod_ = netIoMethod;
     }
+#else
+    (void)ringDepth;
+    (void)sqPoll;
+    (void)netIoMethod;
 #endif
 }
 
+sharpen::EpollSelector::~EpollSelector() noexcept {
+    for (std::size_t i = 0; i != this->pageCount_; ++i) {
+        delete[] this->pages_[i].load(std::memory_order_relaxed);
+    }
+}
+
+std::size_t sharpen::EpollSelector::GetMaxHandles() noexcept {
+    struct rlimit limit;
+    if (::getrlimit(RLIMIT_NOFILE, &limit) != 0 || limit.rlim_max == RLIM_INFINITY ||
+        limit.rlim_max > Self::maxHandles_) {
+        return Self::maxHandles_;
+    }
+    if (limit.rlim_max < Self::pageSize_) {
+        return Self::pageSize_;
+    }
+    return static_cast<std::size_t>(limit.rlim_max);
+}
+
+static std::uint64_t MakeEventData(sharpen::FileHandle handle, std::uint32_t generation) noexcept {
+    std::uint64_t data{generation};
+    data <<= 32;
+    data |= static_cast<std::uint32_t>(handle);
+    return data;
+}
+
+sharpen::EpollSelector::Event *sharpen::EpollSelector::FindEvent(
+    sharpen::FileHandle handle) const noexcept {
+    std::size_t index{static_cast<std::size_t>(handle) >> Self::pageBits_};
+    if (index >= this->pageCount_) {
+        return nullptr;
+    }
+    Event *page{this->pages_[index].load(std::memory_order_acquire)};
+    if (!page) {
+        return nullptr;
+    }
+    return page + (static_cast<std::size_t>(handle) & (Self::pageSize_ - 1));
+}
+
+sharpen::EpollSelector::Event &sharpen::EpollSelector::GetEvent(sharpen::FileHandle handle) {
+    assert(handle >= 0);
+    std::size_t index{static_cast<std::size_t>(handle) >> Self::pageBits_};
+    if (index >= this->pageCount_) {
+        sharpen::ThrowSystemError(EMFILE);
+    }
+    Event *page{this->pages_[index].load(std::memory_order_relaxed)};
+    if (!page) {
+        page = new (std::nothrow) Event[Self::pageSize_];
+        if (!page) {
+            throw std::bad_alloc{};
+        }
+        this->pages_[index].store(page, std::memory_order_release);
+    }
+    std::size_t bound{static_cast<std::size_t>(handle) + 1};
+    if (bound > this->handleBound_.load(std::memory_order_relaxed)) {
+        this->handleBound_.store(bound, std::memory_order_relaxed);
+    }
+    return page[static_cast<std::size_t>(handle) & (Self::pageSize_ - 1)];
+}
+
 void sharpen::EpollSelector::RegisterInternalEventFd(int fd, char internalVal) {
-    Event &event = (this->map_[fd] = std::move(Event()));
-    event.epollEvent_.data.ptr = &event;
+    Event &event{this->GetEvent(fd)};
+    std::uint32_t generation{event.generation_.load(std::memory_order_relaxed) + 1};
+    event.generation_.store(generation, std::memory_order_release);
+    event.epollEvent_.data.u64 = MakeEventData(fd, generation);
     event.epollEvent_.events = EPOLLIN | EPOLLET;
     event.internalEventfd_ = internalVal;
     this->epoll_.Add(fd, &(event.epollEvent_));
@@ -44,16 +142,32 @@ bool sharpen::EpollSelector::CheckChannel(sharpen::ChannelPtr channel) noexcept
     return channel && channel->GetHandle() != -1;
 }
 
-
 void sharpen::EpollSelector::Select(EventVector &events) {
     assert(events.size() <= (std::numeric_limits<std::uint32_t>::max)());
-    std::uint32_t count = this->epoll_.Wait(this->eventBuf_.data(), this->eventBuf_.size(), -1);
+    std::int32_t timeout{-1};
 #ifdef SHARPEN_HAS_IOURING
     bool ringNotify{false};
+    if (this->ring_) {
+        // submit requests of this round before we block
+        this->ring_->Flush();
+        if (this->ring_->HasCompletions()) {
+            ringNotify = true;
+            timeout = 0;
+        } else if (this->ring_->GetUnflushedCount()) {
+            // flush again in next round instead of blocking
+            timeout = 0;
+        }
+    }
 #endif
+    std::uint32_t count =
+        this->epoll_.Wait(this->eventBuf_.data(), this->eventBuf_.size(), timeout);
     for (std::size_t i = 0; i != count; ++i) {
         auto &e = this->eventBuf_[i];
-        auto *event = reinterpret_cast<Self::Event *>(e.data.ptr);
+        Self::Event *event{this->FindEvent(static_cast<sharpen::FileHandle>(e.data.u64))};
+        // the handle has been registered again
+        if (!event || event->generation_.load(std::memory_order_acquire) != (e.data.u64 >> 32)) {
+            continue;
+        }
         if (!event->internalEventfd_) {
             std::uint32_t eventMask = e.events;
             std::uint32_t eventType = 0;
@@ -78,16 +192,31 @@ void sharpen::EpollSelector::Select(EventVector &events) {
         }
 #endif
     }
-    if (count == this->eventBuf_.size() && count != Self::maxEventBufLength_) {
-        this->eventBuf_.resize(count * 2);
-    }
+    this->ResizeEventBuf(count);
 #ifdef SHARPEN_HAS_IOURING
     if (this->ring_ && ringNotify) {
         std::size_t size = this->ring_->GetCompletionStatus(this->cqes_.data(), this->cqes_.size());
         for (std::size_t i = 0; i != size; ++i) {
             sharpen::IoUringStruct *st =
                 reinterpret_cast<sharpen::IoUringStruct *>(this->cqes_[i].user_data);
-            assert(st != nullptr);
+            // internal requests (such as cancellation) have no user data
+            if (!st) {
+                continue;
+            }
+            if (st->multishot_) {
+                if (st->orphan_) {
+                    this->ring_->DropMultishotResult(*st, this->cqes_[i]);
+                    if (!(this->cqes_[i].flags & IORING_CQE_F_MORE)) {
+                        this->ring_->FreeStruct(st);
+                    }
+                    continue;
+                }
+                st->results_.push_back(this->cqes_[i]);
+                if (st->results_.size() == 1) {
+                    events.push_back(&(st->event_));
+                }
+                continue;
+            }
             if (this->cqes_[i].res < 0) {
                 st->event_.AddEvent(sharpen::IoEvent::EventTypeEnum::Error);
                 st->event_.SetErrorCode(-this->cqes_[i].res);
@@ -97,13 +226,35 @@ void sharpen::EpollSelector::Select(EventVector &events) {
             }
             events.push_back(&(st->event_));
         }
-        if (size == this->cqes_.size() && size != Self::maxEventBufLength_) {
+        if (size == this->cqes_.size() && size != Self::maxCqesLength_) {
             this->cqes_.resize(size * 2);
         }
     }
 #endif
 }
 
+void sharpen::EpollSelector::ResizeEventBuf(std::size_t count) {
+    std::size_t size{this->eventBuf_.size()};
+    if (count == size) {
+        this->idleRounds_ = 0;
+        // no more events than handles
+        if (size < this->handleBound_.load(std::memory_order_relaxed)) {
+            this->eventBuf_.resize(size * 2);
+        }
+        return;
+    }
+    if (size == Self::minEventBufLength_ || count * 4 >= size) {
+        this->idleRounds_ = 0;
+        return;
+    }
+    this->idleRounds_ += 1;
+    if (this->idleRounds_ == Self::shrinkRounds_) {
+        this->idleRounds_ = 0;
+        EventBuf buf(size / 2);
+        std::swap(buf, this->eventBuf_);
+    }
+}
+
 void sharpen::EpollSelector::Notify() {
     this->eventfd_.Write(1);
 }
@@ -113,18 +264,20 @@ void sharpen::EpollSelector::Resister(WeakChannelPtr channel) {
     if (!ch) {
         return;
     }
+    sharpen::FileHandle handle{ch->GetHandle()};
     epoll_event *eventStruct{nullptr};
     {
         std::unique_lock<sharpen::SpinLock> lock{this->lock_};
-        auto ite = this->map_.emplace(ch->GetHandle(), Self::Event{}).first;
-        Self::Event &event = ite->second;
+        Self::Event &event{this->GetEvent(handle)};
+        std::uint32_t generation{event.generation_.load(std::memory_order_relaxed) + 1};
+        event.generation_.store(generation, std::memory_order_release);
         event.ioEvent_.SetChannel(ch);
-        event.epollEvent_.data.ptr = &event;
+        event.epollEvent_.data.u64 = MakeEventData(handle, generation);
         event.epollEvent_.events = EPOLLIN | EPOLLOUT | EPOLLET | EPOLLHUP | EPOLLERR | EPOLLRDHUP;
-        event.internalEventfd_ = false;
+        event.internalEventfd_ = 0;
         eventStruct = &(event.epollEvent_);
     }
-    this->epoll_.Add(ch->GetHandle(), eventStruct);
+    this->epoll_.Add(handle, eventStruct);
 }
 
 #ifdef SHARPEN_HAS_IOURING
@@ -12,24 +12,43 @@ std::once_flag sharpen::EventEngine::flag_;
 
 thread_local sharpen::EventEngine::SwitchCallback sharpen::EventEngine::switchCb_;
 
+thread_local sharpen::EventLoop *sharpen::EventEngine::cachedLoop_{nullptr};
+
+thread_local std::size_t sharpen::EventEngine::cachedIndex_{0};
+
+sharpen::EventEngine::LoopQueue::LoopQueue(std::size_t capacity)
+    : fibers_(capacity)
+    , idle_(false) {
+}
+
 sharpen::EventEngine::EventEngine()
     : EventEngine(std::thread::hardware_concurrency()) {
 }
 
 sharpen::EventEngine::EventEngine(std::size_t workerCount)
+    : EventEngine(workerCount, sharpen::NetIoMethod::Readiness) {
+}
+
+sharpen::EventEngine::EventEngine(std::size_t workerCount, sharpen::NetIoMethod netIoMethod)
     : workers_()
     , pos_(0)
-    , mainLoop_(nullptr) {
+    , mainLoop_(nullptr)
+    , loops_()
+    , queues_()
+    , idleCount_(0) {
     assert(workerCount != 0);
-    this->mainLoop_.reset(new (std::nothrow) sharpen::EventLoop(sharpen::MakeDefaultSelector()));
+    this->mainLoop_.reset(
+        new (std::nothrow) sharpen::EventLoop(sharpen::MakeDefaultSelector(netIoMethod)));
     if (!this->mainLoop_) {
         throw std::bad_alloc{};
     }
     this->loops_.push_back(this->mainLoop_.get());
     for (std::size_t i = 0, count = workerCount - 1; i != count; ++i) {
         // one selector per thread
+        // threads are started after loops and queues are built
         std::unique_ptr<sharpen::EventLoopThread> thread(
-            new (std::nothrow) sharpen::EventLoopThread(sharpen::MakeDefaultSelector()));
+            new (std::nothrow)
+                sharpen::EventLoopThread(sharpen::MakeDefaultSelector(netIoMethod), false));
         if (!thread) {
             throw std::bad_alloc{};
         }
@@ -37,11 +56,35 @@ sharpen::EventEngine::EventEngine(std::size_t workerCount)
         this->loops_.push_back(thread->GetLoop());
         this->workers_.push_back(std::move(thread));
     }
+    for (std::size_t i = 0, count = this->loops_.size(); i != count; ++i) {
+        std::unique_ptr<LoopQueue> queue{new (std::nothrow)
+                                             LoopQueue(Self::fiberQueueCapacity_)};
+        if (!queue) {
+            throw std::bad_alloc{};
+        }
+        this->queues_.emplace_back(std::move(queue));
+    }
     this->mainLoop_->SetLoopGroup(this);
+    for (auto begin = this->workers_.begin(), end = this->workers_.end(); begin != end; ++begin) {
+        (*begin)->Start();
+    }
 }
 
 sharpen::EventEngine::~EventEngine() noexcept {
     this->Stop();
+    // join worker threads before releasing queued fibers
+    this->workers_.clear();
+    this->ReleaseQueuedFibers();
+}
+
+void sharpen::EventEngine::ReleaseQueuedFibers() noexcept {
+    for (auto begin = this->queues_.begin(), end = this->queues_.end(); begin != end; ++begin) {
+        sharpen::Fiber *fiber{(*begin)->fibers_.Steal()};
+        while (fiber) {
+            sharpen::Fiber::Unpin(fiber);
+            fiber = (*begin)->fibers_.Steal();
+        }
+    }
 }
 
 sharpen::EventLoop &sharpen::EventEngine::RoundRobinLoop() noexcept {
@@ -64,37 +107,139 @@ void sharpen::EventEngine::CallSwitchCallback() {
     }
 }
 
-void sharpen::EventEngine::NviScheduleSoon(sharpen::FiberPtr &&fiber) {
+std::size_t sharpen::EventEngine::GetLocalIndex() const noexcept {
+    sharpen::EventLoop *loop{sharpen::EventLoop::GetLocalLoop()};
+    if (!loop || loop->GetLoopGroup() != this) {
+        return this->loops_.size();
+    }
+    if (Self::cachedLoop_ != loop) {
+        for (std::size_t i = 0, count = this->loops_.size(); i != count; ++i) {
+            if (this->loops_[i] == loop) {
+                Self::cachedLoop_ = loop;
+                Self::cachedIndex_ = i;
+                return i;
+            }
+        }
+        return this->loops_.size();
+    }
+    return Self::cachedIndex_;
+}
+
+void sharpen::EventEngine::WakeIdleLoop(std::size_t index) noexcept {
+    if (!this->idleCount_.load(std::memory_order_relaxed)) {
+        return;
+    }
+    std::size_t count{this->loops_.size()};
+    for (std::size_t i = 1; i != count; ++i) {
+        std::size_t pos{(index + i) % count};
+        LoopQueue &queue{*this->queues_[pos]};
+        if (queue.idle_.load(std::memory_order_relaxed) && queue.idle_.exchange(false)) {
+            this->idleCount_ -= 1;
+            this->loops_[pos]->GetSelectorPtr()->Notify();
+            return;
+        }
+    }
+}
+
+void sharpen::EventEngine::InjectFiber(sharpen::FiberPtr &&fiber) {
     using FnPtr = void (*)(sharpen::FiberPtr);
     auto &&fn =
         std::bind(static_cast<FnPtr>(&sharpen::EventEngine::ProcessFiber), std::move(fiber));
-    // find a waiting loop
-#ifndef SHARPEN_NOT_SELECTED_SCHEDULE
-    sharpen::EventLoop *selectedLoop{nullptr};
-    std::size_t leastCount{0};
-#endif
-    for (auto begin = this->loops_.begin(), end = this->loops_.end(); begin != end; begin++) {
-        sharpen::EventLoop *loop = *begin;
-        std::size_t works{loop->GetWorkCount()};
-        if (!works) {
-            loop->RunInLoopSoon(std::move(fn));
-            return;
+    // prefer an idle loop
+    if (this->idleCount_.load(std::memory_order_relaxed)) {
+        std::size_t pos{this->pos_++};
+        std::size_t count{this->loops_.size()};
+        for (std::size_t i = 0; i != count; ++i) {
+            LoopQueue &queue{*this->queues_[(pos + i) % count]};
+            if (queue.idle_.load(std::memory_order_relaxed) && queue.idle_.exchange(false)) {
+                this->idleCount_ -= 1;
+                this->loops_[(pos + i) % count]->RunInLoopSoon(std::move(fn));
+                return;
+            }
         }
-#ifndef SHARPEN_NOT_SELECTED_SCHEDULE
-        else if (!selectedLoop || leastCount > works) {
-            leastCount = works;
-            selectedLoop = loop;
+    }
+    this->RoundRobinLoop().RunInLoopSoon(std::move(fn));
+}
+
+void sharpen::EventEngine::NviScheduleSoon(sharpen::FiberPtr &&fiber) {
+    std::size_t index{this->GetLocalIndex()};
+    if (index == this->loops_.size()) {
+        // current thread is not a loop of this engine
+        this->InjectFiber(std::move(fiber));
+        return;
+    }
+    // local first
+    sharpen::Fiber *raw{sharpen::Fiber::Pin(std::move(fiber))};
+    if (this->queues_[index]->fibers_.Push(raw)) {
+        this->WakeIdleLoop(index);
+        return;
+    }
+    // the run queue is full
+    using FnPtr = void (*)(sharpen::FiberPtr);
+    this->loops_[index]->RunInLoopSoon(std::bind(
+        static_cast<FnPtr>(&sharpen::EventEngine::ProcessFiber), sharpen::Fiber::Unpin(raw)));
+}
+
+bool sharpen::EventEngine::RunLocalFibers(std::size_t index) {
+    FiberQueue &fibers{this->queues_[index]->fibers_};
+    for (std::size_t i = 0; i != Self::fiberBatchSize_; ++i) {
+        // take fibers in FIFO order
+        // a yielding fiber must not starve older fibers
+        sharpen::Fiber *fiber{fibers.Steal()};
+        if (!fiber) {
+            return false;
         }
-#endif
+        Self::ProcessFiber(sharpen::Fiber::Unpin(fiber));
     }
-#ifndef SHARPEN_NOT_SELECTED_SCHEDULE
-    assert(selectedLoop);
-    selectedLoop->RunInLoopSoon(std::move(fn));
-#else
-    // could not found a waiting loop
-    // round robin schedule
-    this->RoundRobinLoop()->RunInLoopSoon(std::move(fn));
-#endif
+    return !fibers.Empty();
+}
+
+bool sharpen::EventEngine::StealFibers(std::size_t index) {
+    std::size_t count{this->loops_.size()};
+    for (std::size_t i = 1; i != count; ++i) {
+        FiberQueue &victim{this->queues_[(index + i) % count]->fibers_};
+        sharpen::Fiber *fiber{victim.Steal()};
+        if (!fiber) {
+            continue;
+        }
+        std::size_t stolen{0};
+        while (fiber) {
+            Self::ProcessFiber(sharpen::Fiber::Unpin(fiber));
+            stolen += 1;
+            if (stolen == Self::fiberBatchSize_) {
+                break;
+            }
+            fiber = victim.Steal();
+        }
+        return true;
+    }
+    return false;
+}
+
+bool sharpen::EventEngine::ExecuteLoopWork(sharpen::EventLoop &loop) {
+    std::size_t index{this->GetLocalIndex()};
+    assert(index != this->loops_.size());
+    assert(this->loops_[index] == &loop);
+    (void)loop;
+    LoopQueue &queue{*this->queues_[index]};
+    if (queue.idle_.load(std::memory_order_relaxed) && queue.idle_.exchange(false)) {
+        this->idleCount_ -= 1;
+    }
+    if (this->RunLocalFibers(index)) {
+        return true;
+    }
+    // local run queue is empty
+    if (this->StealFibers(index)) {
+        return true;
+    }
+    // the fibers we executed may push fibers to local run queue
+    if (!queue.fibers_.Empty()) {
+        return true;
+    }
+    if (!queue.idle_.exchange(true)) {
+        this->idleCount_ += 1;
+    }
+    return false;
 }
 
 void sharpen::EventEngine::NviSchedule(sharpen::FiberPtr &&fiber) {
@@ -128,8 +273,14 @@ void sharpen::EventEngine::ProcessFiber(sharpen::FiberPtr fiber) {
 }
 
 sharpen::EventEngine &sharpen::EventEngine::SetupEngine(std::size_t workerCount) {
-    std::call_once(sharpen::EventEngine::flag_, [workerCount]() {
-        sharpen::EventEngine *engine = new (std::nothrow) sharpen::EventEngine(workerCount);
+    return sharpen::EventEngine::SetupEngine(workerCount, sharpen::NetIoMethod::Readiness);
+}
+
+sharpen::EventEngine &sharpen::EventEngine::SetupEngine(std::size_t workerCount,
+                                                        sharpen::NetIoMethod netIoMethod) {
+    std::call_once(sharpen::EventEngine::flag_, [workerCount, netIoMethod]() {
+        sharpen::EventEngine *engine =
+            new (std::nothrow) sharpen::EventEngine(workerCount, netIoMethod);
         if (!engine) {
             throw std::bad_alloc{};
         }
@@ -156,6 +307,11 @@ sharpen::EventEngine &sharpen::EventEngine::SetupSingleThreadEngine() {
     return sharpen::EventEngine::SetupEngine(1);
 }
 
+sharpen::EventEngine &sharpen::EventEngine::SetupSingleThreadEngine(
+    sharpen::NetIoMethod netIoMethod) {
+    return sharpen::EventEngine::SetupEngine(1, netIoMethod);
+}
+
 bool sharpen::EventEngine::IsProcesser() const {
     return sharpen::EventLoop::IsInLoop();
 }
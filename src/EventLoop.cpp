@@ -1,5 +1,7 @@
 #include <sharpen/EventLoop.hpp>
 
+#include <sharpen/IEventLoopGroup.hpp>
+#include <sharpen/TimerWheel.hpp>
 #include <cassert>
 #include <thread>
 
@@ -9,16 +11,16 @@ thread_local sharpen::FiberPtr sharpen::EventLoop::localFiber_{nullptr};
 
 sharpen::EventLoop::EventLoop(SelectorPtr selector)
     : selector_(selector)
-    , tasks_()
-    , pendingTasks_()
+    , tasks_(reservedTaskSize_)
     , exectingTask_(false)
     , lock_()
     , running_(false)
     , works_(0)
-    , loopGroup_(nullptr) {
+    , loopGroup_(nullptr)
+    , timerWheel_(nullptr)
+    , receiveBuffers_() {
     assert(selector != nullptr);
-    this->pendingTasks_.reserve(reservedTaskSize_);
-    this->tasks_.reserve(reservedTaskSize_);
+    this->receiveBuffers_.reserve(maxReceiveBuffers_);
 }
 
 sharpen::EventLoop::~EventLoop() noexcept {
@@ -53,29 +55,23 @@ void sharpen::EventLoop::RunInLoop(Task task) {
 
 void sharpen::EventLoop::RunInLoopSoon(Task task) {
     this->works_ += 1;
-    bool execting(true);
-    {
-        std::unique_lock<Lock> lock(this->lock_);
-        this->pendingTasks_.push_back(std::move(task));
-        std::swap(execting, this->exectingTask_);
-    }
-    if (!execting) {
+    this->tasks_.Push(std::move(task));
+    // only the first producer notifies the loop
+    if (!this->exectingTask_.exchange(true, std::memory_order_acq_rel)) {
         this->selector_->Notify();
     }
 }
 
 void sharpen::EventLoop::ExecuteTask() {
-    {
-        std::unique_lock<Lock> lock(this->lock_);
-        this->exectingTask_ = false;
-        if (!this->pendingTasks_.empty()) {
-            this->tasks_.swap(this->pendingTasks_);
-        }
-    }
-    for (auto begin = this->tasks_.begin(), end = this->tasks_.end(); begin != end; ++begin) {
+    // producers that push after this point notify again
+    this->exectingTask_.exchange(false, std::memory_order_acq_rel);
+    Task task;
+    std::size_t count{0};
+    while (count != maxTasksPerLoop_ && this->tasks_.TryPop(task)) {
+        count += 1;
         try {
-            if (*begin) {
-                (*begin)();
+            if (task) {
+                task();
             }
         } catch (const std::bad_alloc &fault) {
             (void)fault;
@@ -88,9 +84,13 @@ void sharpen::EventLoop::ExecuteTask() {
             assert(ignore.what() == nullptr && "an exception occured in event loop");
             (void)ignore;
         }
+        task.Reset();
+    }
+    this->works_ -= count;
+    // don't block in next select
+    if (count == maxTasksPerLoop_ && !this->exectingTask_.exchange(true, std::memory_order_acq_rel)) {
+        this->selector_->Notify();
     }
-    this->works_ -= this->tasks_.size();
-    this->tasks_.clear();
 }
 
 void sharpen::EventLoop::Run() {
@@ -116,6 +116,11 @@ void sharpen::EventLoop::Run() {
         events.clear();
         // execute tasks
         this->ExecuteTask();
+        // execute work of loop group
+        if (this->loopGroup_ && this->loopGroup_->ExecuteLoopWork(*this)) {
+            // don't block in next select
+            this->selector_->Notify();
+        }
     }
     sharpen::EventLoop::localLoop_ = nullptr;
     sharpen::EventLoop::localFiber_.reset();
@@ -157,4 +162,48 @@ sharpen::IEventLoopGroup *sharpen::EventLoop::GetCurrentLoopGroup() noexcept {
 
 sharpen::IEventLoopGroup *sharpen::GetLocalLoopGroupPtr() noexcept {
     return sharpen::EventLoop::GetCurrentLoopGroup();
-}
\ No newline at end of file
+}
+
+std::shared_ptr<sharpen::TimerWheel> sharpen::EventLoop::GetTimerWheel() {
+#ifdef SHARPEN_HAS_TIMERWHEEL
+    {
+        std::unique_lock<Lock> lock{this->lock_};
+        if (this->timerWheel_) {
+            return this->timerWheel_;
+        }
+    }
+    std::shared_ptr<sharpen::TimerWheel> wheel{std::make_shared<sharpen::TimerWheel>()};
+    wheel->Register(*this);
+    {
+        std::unique_lock<Lock> lock{this->lock_};
+        // another thread created the wheel
+        // drop ours
+        if (this->timerWheel_) {
+            return this->timerWheel_;
+        }
+        this->timerWheel_ = wheel;
+    }
+    return wheel;
+#else
+    return nullptr;
+#endif
+}
+
+sharpen::ByteBuffer sharpen::EventLoop::AcquireReceiveBuffer() {
+    assert(sharpen::EventLoop::GetLocalLoop() == this);
+    if (this->receiveBuffers_.empty()) {
+        return sharpen::ByteBuffer{receiveBufferSize};
+    }
+    sharpen::ByteBuffer buffer{std::move(this->receiveBuffers_.back())};
+    this->receiveBuffers_.pop_back();
+    return buffer;
+}
+
+void sharpen::EventLoop::ReleaseReceiveBuffer(sharpen::ByteBuffer buffer) noexcept {
+    assert(sharpen::EventLoop::GetLocalLoop() == this);
+    // capacity has been reserved
+    if (buffer.GetSize() == receiveBufferSize &&
+        this->receiveBuffers_.size() != maxReceiveBuffers_) {
+        this->receiveBuffers_.emplace_back(std::move(buffer));
+    }
+}
@@ -1,10 +1,22 @@
 #include <sharpen/EventLoopThread.hpp>
 
 #include <cassert>
+#include <utility>
 
 sharpen::EventLoopThread::EventLoopThread(sharpen::SelectorPtr selector)
+    : EventLoopThread(std::move(selector), true) {
+}
+
+sharpen::EventLoopThread::EventLoopThread(sharpen::SelectorPtr selector, bool start)
     : loop_(selector)
     , thread_() {
+    if (start) {
+        this->Start();
+    }
+}
+
+void sharpen::EventLoopThread::Start() {
+    assert(!this->thread_.joinable());
     this->thread_ = std::thread{&sharpen::EventLoopThread::Entry, this};
 }
 
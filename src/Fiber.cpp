@@ -32,7 +32,8 @@ sharpen::Fiber::Fiber() noexcept
     , inited_(false)
     , scheduler_(nullptr)
     , localStorage_()
-    , id_(sharpen::Fiber::AllocId()) {
+    , id_(sharpen::Fiber::AllocId())
+    , pinned_(nullptr) {
 }
 
 sharpen::Fiber::~Fiber() noexcept {
@@ -108,7 +109,8 @@ void sharpen::Fiber::FiberEntry(transfer_t from) noexcept {
 }
 
 void sharpen::Fiber::InitFiber() {
-    sharpen::MemoryStack stack = sharpen::MemoryStack::AllocStack(this->stack_.GetSize());
+    sharpen::MemoryStack stack = sharpen::MemoryStack::AllocStack(this->stack_.GetSize(),
+                                                                  this->stack_.GetAllocMethod());
     this->handle_ = ::make_fcontext(stack.Top(), stack.GetSize(), &sharpen::Fiber::FiberEntry);
     this->handle_ = ::jump_fcontext(this->handle_, nullptr).fctx;
     this->stack_ = std::move(stack);
@@ -138,4 +140,19 @@ sharpen::IFiberScheduler *sharpen::Fiber::GetCurrentFiberSceduler() noexcept {
 
 sharpen::IFiberScheduler *sharpen::GetLocalSchedulerPtr() noexcept {
     return sharpen::Fiber::GetCurrentFiberSceduler();
-}
\ No newline at end of file
+}
+
+sharpen::Fiber *sharpen::Fiber::Pin(sharpen::FiberPtr fiber) noexcept {
+    assert(fiber != nullptr);
+    sharpen::Fiber *raw{fiber.get()};
+    assert(!raw->pinned_);
+    raw->pinned_ = std::move(fiber);
+    return raw;
+}
+
+sharpen::FiberPtr sharpen::Fiber::Unpin(sharpen::Fiber *fiber) noexcept {
+    assert(fiber != nullptr);
+    assert(fiber->pinned_);
+    sharpen::FiberPtr ptr{std::move(fiber->pinned_)};
+    return ptr;
+}
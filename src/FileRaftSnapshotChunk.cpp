@@ -0,0 +1,66 @@
+#include <sharpen/FileRaftSnapshotChunk.hpp>
+
+#include <sharpen/IntOps.hpp>
+#include <sharpen/SystemError.hpp>
+#include <cassert>
+
+sharpen::FileRaftSnapshotChunk::FileRaftSnapshotChunk(sharpen::FileChannelPtr channel,
+                                                       std::size_t chunkSize)
+    : channel_(std::move(channel))
+    , offset_(0)
+    , size_(0)
+    , chunkSize_(chunkSize) {
+    assert(this->channel_);
+    assert(this->chunkSize_ != 0);
+    this->size_ = this->channel_->GetFileSize();
+}
+
+sharpen::FileRaftSnapshotChunk::FileRaftSnapshotChunk(Self &&other) noexcept
+    : channel_(std::move(other.channel_))
+    , offset_(other.offset_)
+    , size_(other.size_)
+    , chunkSize_(other.chunkSize_) {
+    other.offset_ = 0;
+    other.size_ = 0;
+}
+
+sharpen::FileRaftSnapshotChunk &sharpen::FileRaftSnapshotChunk::operator=(Self &&other) noexcept {
+    if (this != std::addressof(other)) {
+        this->channel_ = std::move(other.channel_);
+        this->offset_ = other.offset_;
+        this->size_ = other.size_;
+        this->chunkSize_ = other.chunkSize_;
+        other.offset_ = 0;
+        other.size_ = 0;
+    }
+    return *this;
+}
+
+void sharpen::FileRaftSnapshotChunk::Forward() {
+    assert(this->Forwardable());
+    this->offset_ += this->chunkSize_;
+}
+
+sharpen::ByteBuffer sharpen::FileRaftSnapshotChunk::GenerateChunkData() const {
+    assert(this->channel_);
+    assert(this->offset_ <= this->size_);
+    std::uint64_t size{(std::min)(this->size_ - this->offset_,
+                                  static_cast<std::uint64_t>(this->chunkSize_))};
+    sharpen::ByteBuffer buf{sharpen::IntCast<std::size_t>(size)};
+    if (!buf.Empty()) {
+        std::size_t sz{this->channel_->ReadFixedAsync(buf, this->offset_)};
+        if (sz != buf.GetSize()) {
+            // the snapshot was truncated
+            sharpen::ThrowSystemError(sharpen::ErrorIo);
+        }
+    }
+    return buf;
+}
+
+bool sharpen::FileRaftSnapshotChunk::Forwardable() const {
+    return this->offset_ + this->chunkSize_ < this->size_;
+}
+
+std::uint64_t sharpen::FileRaftSnapshotChunk::GetOffset() const noexcept {
+    return this->offset_;
+}
\ No newline at end of file
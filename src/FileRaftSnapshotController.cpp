@@ -0,0 +1,303 @@
+#include <sharpen/FileRaftSnapshotController.hpp>
+
+#include <sharpen/BufferOps.hpp>
+#include <sharpen/CorruptedDataError.hpp>
+#include <sharpen/FileOps.hpp>
+#include <sharpen/FileRaftSnapshotChunk.hpp>
+#include <sharpen/IntOps.hpp>
+#include <sharpen/SystemError.hpp>
+#include <cassert>
+#include <stdexcept>
+
+sharpen::FileRaftSnapshotController::FileRaftSnapshotController(std::string name)
+    : Self{sharpen::GetLocalLoopGroup(), std::move(name)} {
+}
+
+sharpen::FileRaftSnapshotController::FileRaftSnapshotController(
+    sharpen::IEventLoopGroup &loopGroup, std::string name)
+    : Self{loopGroup, std::move(name), Self::defaultChunkSize_} {
+}
+
+sharpen::FileRaftSnapshotController::FileRaftSnapshotController(
+    sharpen::IEventLoopGroup &loopGroup, std::string name, std::size_t chunkSize)
+    : name_(std::move(name))
+    , metaName_()
+    , tempName_()
+    , loopGroup_(&loopGroup)
+    , chunkSize_(chunkSize)
+    , metadata_(sharpen::EmptyOpt)
+    , installer_(nullptr)
+    , expectedOffset_(0)
+    , allocatedSize_(0)
+    , checksum_(0) {
+    assert(!this->name_.empty());
+    assert(this->chunkSize_ != 0);
+    if (!this->chunkSize_) {
+        this->chunkSize_ = Self::defaultChunkSize_;
+    }
+    this->metaName_ = this->name_ + ".meta";
+    this->tempName_ = this->name_ + ".tmp";
+    this->Load();
+}
+
+sharpen::FileRaftSnapshotController::FileRaftSnapshotController(Self &&other) noexcept
+    : name_(std::move(other.name_))
+    , metaName_(std::move(other.metaName_))
+    , tempName_(std::move(other.tempName_))
+    , loopGroup_(other.loopGroup_)
+    , chunkSize_(other.chunkSize_)
+    , metadata_(std::move(other.metadata_))
+    , installer_(std::move(other.installer_))
+    , expectedOffset_(other.expectedOffset_)
+    , allocatedSize_(other.allocatedSize_)
+    , checksum_(other.checksum_) {
+    other.loopGroup_ = nullptr;
+    other.chunkSize_ = Self::defaultChunkSize_;
+    other.expectedOffset_ = 0;
+    other.allocatedSize_ = 0;
+    other.checksum_ = 0;
+}
+
+sharpen::FileRaftSnapshotController &sharpen::FileRaftSnapshotController::operator=(
+    Self &&other) noexcept {
+    if (this != std::addressof(other)) {
+        this->name_ = std::move(other.name_);
+        this->metaName_ = std::move(other.metaName_);
+        this->tempName_ = std::move(other.tempName_);
+        this->loopGroup_ = other.loopGroup_;
+        this->chunkSize_ = other.chunkSize_;
+        this->metadata_ = std::move(other.metadata_);
+        this->installer_ = std::move(other.installer_);
+        this->expectedOffset_ = other.expectedOffset_;
+        this->allocatedSize_ = other.allocatedSize_;
+        this->checksum_ = other.checksum_;
+        other.loopGroup_ = nullptr;
+        other.chunkSize_ = Self::defaultChunkSize_;
+        other.expectedOffset_ = 0;
+        other.allocatedSize_ = 0;
+        other.checksum_ = 0;
+    }
+    return *this;
+}
+
+sharpen::FileRaftSnapshotController::~FileRaftSnapshotController() noexcept {
+    if (this->installer_) {
+        this->installer_->Close();
+    }
+}
+
+void sharpen::FileRaftSnapshotController::Load() {
+    // chunks of an unfinished transfer are discarded
+    if (sharpen::ExistFile(this->tempName_.c_str())) {
+        sharpen::RemoveFile(this->tempName_.c_str());
+    }
+    std::string metaTempName{this->metaName_ + ".tmp"};
+    if (!sharpen::ExistFile(this->name_.c_str())) {
+        if (sharpen::ExistFile(metaTempName.c_str())) {
+            sharpen::RemoveFile(metaTempName.c_str());
+        }
+        return;
+    }
+    // the process may crash after the snapshot is replaced
+    // but before its metadata is replaced
+    std::uint32_t checksum{this->ComputeChecksum(this->name_.c_str())};
+    if (sharpen::ExistFile(metaTempName.c_str())) {
+        sharpen::RaftSnapshotMetadata metadata{this->LoadMetadata(metaTempName.c_str())};
+        if (metadata.GetChecksum() == checksum) {
+            sharpen::RenameFile(metaTempName.c_str(), this->metaName_.c_str());
+            this->metadata_.Construct(std::move(metadata));
+            return;
+        }
+        sharpen::RemoveFile(metaTempName.c_str());
+    }
+    if (sharpen::ExistFile(this->metaName_.c_str())) {
+        sharpen::RaftSnapshotMetadata metadata{this->LoadMetadata(this->metaName_.c_str())};
+        if (metadata.GetChecksum() == checksum) {
+            this->metadata_.Construct(std::move(metadata));
+            return;
+        }
+        // the snapshot does not match its metadata
+        sharpen::RemoveFile(this->metaName_.c_str());
+    }
+    sharpen::RemoveFile(this->name_.c_str());
+}
+
+sharpen::RaftSnapshotMetadata sharpen::FileRaftSnapshotController::LoadMetadata(
+    const char *name) const {
+    sharpen::FileChannelPtr channel{sharpen::OpenFileChannel(
+        name, sharpen::FileAccessMethod::Read, sharpen::FileOpenMethod::Open)};
+    channel->Register(*this->loopGroup_);
+    std::uint64_t size{channel->GetFileSize()};
+    sharpen::ByteBuffer buf{sharpen::IntCast<std::size_t>(size)};
+    std::size_t sz{channel->ReadFixedAsync(buf, 0)};
+    if (sz != buf.GetSize()) {
+        sharpen::ThrowSystemError(sharpen::ErrorIo);
+    }
+    sharpen::RaftSnapshotMetadata metadata;
+    metadata.LoadFrom(buf.Data(), buf.GetSize());
+    return metadata;
+}
+
+void sharpen::FileRaftSnapshotController::SaveMetadata(
+    const sharpen::RaftSnapshotMetadata &metadata, const char *snapshotName) {
+    assert(snapshotName != nullptr);
+    // the metadata is written before the snapshot is replaced
+    // so that Load() is able to pair them after a crash
+    std::string tempName{this->metaName_ + ".tmp"};
+    sharpen::ByteBuffer buf;
+    metadata.StoreTo(buf);
+    sharpen::FileChannelPtr channel{sharpen::OpenFileChannel(
+        tempName.c_str(), sharpen::FileAccessMethod::Write, sharpen::FileOpenMethod::CreateOrOpen)};
+    channel->Register(*this->loopGroup_);
+    channel->Truncate();
+    std::size_t sz{channel->WriteFixedAsync(buf.Data(), buf.GetSize(), 0)};
+    if (sz != buf.GetSize()) {
+        sharpen::ThrowSystemError(sharpen::ErrorIo);
+    }
+    channel->FlushAsync();
+    channel->Close();
+    sharpen::RenameFile(snapshotName, this->name_.c_str());
+    sharpen::RenameFile(tempName.c_str(), this->metaName_.c_str());
+}
+
+std::uint32_t sharpen::FileRaftSnapshotController::ComputeChecksum(const char *name) const {
+    sharpen::FileChannelPtr channel{sharpen::OpenFileChannel(
+        name, sharpen::FileAccessMethod::Read, sharpen::FileOpenMethod::Open)};
+    channel->Register(*this->loopGroup_);
+    std::uint64_t size{channel->GetFileSize()};
+    sharpen::ByteBuffer buf{this->chunkSize_};
+    std::uint32_t checksum{0};
+    std::uint64_t offset{0};
+    while (offset != size) {
+        std::size_t sz{channel->ReadAsync(buf, offset)};
+        if (!sz) {
+            sharpen::ThrowSystemError(sharpen::ErrorIo);
+        }
+        checksum = sharpen::Crc32c(checksum, buf.Data(), sz);
+        offset += sz;
+    }
+    return checksum;
+}
+
+void sharpen::FileRaftSnapshotController::Commit(const char *snapshotName,
+                                                 sharpen::RaftSnapshotMetadata metadata) {
+    assert(snapshotName != nullptr);
+    metadata.SetChecksum(this->ComputeChecksum(snapshotName));
+    {
+        // the file must be durable before it replaces the snapshot
+        sharpen::FileChannelPtr channel{sharpen::OpenFileChannel(
+            snapshotName, sharpen::FileAccessMethod::Write, sharpen::FileOpenMethod::Open)};
+        channel->Register(*this->loopGroup_);
+        channel->FlushAsync();
+        channel->Close();
+    }
+    // the followers which are reading old snapshot keep its file
+    this->SaveMetadata(metadata, snapshotName);
+    this->metadata_.Construct(std::move(metadata));
+}
+
+sharpen::RaftSnapshot sharpen::FileRaftSnapshotController::GetSnapshot() const {
+    if (!this->metadata_.Exist()) {
+        throw std::logic_error{"snapshot does not exist"};
+    }
+    sharpen::FileChannelPtr channel{sharpen::OpenFileChannel(
+        this->name_.c_str(), sharpen::FileAccessMethod::Read, sharpen::FileOpenMethod::Open)};
+    channel->Register(*this->loopGroup_);
+    std::unique_ptr<sharpen::IRaftSnapshotChunk> chunk{
+        new (std::nothrow) sharpen::FileRaftSnapshotChunk{std::move(channel), this->chunkSize_}};
+    if (!chunk) {
+        throw std::bad_alloc{};
+    }
+    return sharpen::RaftSnapshot{std::move(chunk), this->metadata_.Get()};
+}
+
+sharpen::Optional<sharpen::RaftSnapshotMetadata>
+sharpen::FileRaftSnapshotController::GetLastMetadata() const {
+    return this->metadata_;
+}
+
+std::uint64_t sharpen::FileRaftSnapshotController::GetExpectedOffset() const noexcept {
+    return this->expectedOffset_;
+}
+
+sharpen::FileChannelPtr sharpen::FileRaftSnapshotController::OpenTemp() {
+    sharpen::FileChannelPtr channel{sharpen::OpenFileChannel(this->tempName_.c_str(),
+                                                             sharpen::FileAccessMethod::All,
+                                                             sharpen::FileOpenMethod::CreateNew)};
+    channel->Register(*this->loopGroup_);
+    return channel;
+}
+
+void sharpen::FileRaftSnapshotController::NviWrite(std::uint64_t offset,
+                                                   sharpen::ByteSlice snapshotChunk) {
+    assert(offset == this->expectedOffset_);
+    if (offset != this->expectedOffset_) {
+        throw std::invalid_argument{"snapshot chunk is not continuous"};
+    }
+    if (!this->installer_) {
+        this->installer_ = this->OpenTemp();
+        this->allocatedSize_ = 0;
+        this->checksum_ = 0;
+    }
+    std::uint64_t end{offset + snapshotChunk.GetSize()};
+    if (end > this->allocatedSize_) {
+        // preallocate extents so that chunks are written without extending metadata
+        std::size_t size{Self::allocationSize_};
+        if (size < snapshotChunk.GetSize()) {
+            size = snapshotChunk.GetSize();
+        }
+        try {
+            this->installer_->AllocateAsync(this->allocatedSize_, size);
+        } catch (const std::system_error &error) {
+            sharpen::ErrorCode code{sharpen::GetErrorCode(error)};
+            if (sharpen::IsFatalError(code)) {
+                std::terminate();
+            }
+            // preallocation is not supported by the file system
+            (void)error;
+        }
+        this->allocatedSize_ += size;
+    }
+    std::size_t sz{
+        this->installer_->WriteFixedAsync(snapshotChunk.Data(), snapshotChunk.GetSize(), offset)};
+    if (sz != snapshotChunk.GetSize()) {
+        sharpen::ThrowSystemError(sharpen::ErrorIo);
+    }
+    this->checksum_ = sharpen::Crc32c(this->checksum_, snapshotChunk.Data(), sz);
+    this->expectedOffset_ = end;
+}
+
+void sharpen::FileRaftSnapshotController::NviInstall(sharpen::RaftSnapshotMetadata metadata) {
+    if (!this->installer_) {
+        // empty snapshot
+        this->installer_ = this->OpenTemp();
+        this->checksum_ = 0;
+    }
+    if (this->checksum_ != metadata.GetChecksum()) {
+        this->NviReset();
+        throw sharpen::CorruptedDataError{"corrupted raft snapshot"};
+    }
+    // release preallocated extents
+    this->installer_->Truncate(this->expectedOffset_);
+    this->installer_->FlushAsync();
+    this->installer_->Close();
+    this->installer_.reset();
+    this->SaveMetadata(metadata, this->tempName_.c_str());
+    this->metadata_.Construct(std::move(metadata));
+    this->expectedOffset_ = 0;
+    this->allocatedSize_ = 0;
+    this->checksum_ = 0;
+}
+
+void sharpen::FileRaftSnapshotController::NviReset() {
+    if (this->installer_) {
+        this->installer_->Close();
+        this->installer_.reset();
+    }
+    if (sharpen::ExistFile(this->tempName_.c_str())) {
+        sharpen::RemoveFile(this->tempName_.c_str());
+    }
+    this->expectedOffset_ = 0;
+    this->allocatedSize_ = 0;
+    this->checksum_ = 0;
+}
\ No newline at end of file
@@ -58,6 +58,31 @@ sharpen::GenericMailParser::ParseStatus sharpen::GenericMailParser::GetStatus()
     return ParseStatus::Header;
 }
 
+void sharpen::GenericMailParser::PrepareContent() {
+    assert(this->parsedSize_ == sizeof(sharpen::GenericMailHeader));
+    const sharpen::GenericMailHeader *header{&this->header_.As<sharpen::GenericMailHeader>()};
+    std::uint32_t contentSize{header->GetContentSize()};
+    if (contentSize > this->maxContentSize_) {
+        throw sharpen::MailParseError{"content too long"};
+    }
+    // allocate content once header is completed
+    // so that the content could be read into it directly
+    this->content_.ExtendTo(contentSize);
+    if (!contentSize) {
+        this->CompleteMail();
+    }
+}
+
+void sharpen::GenericMailParser::CompleteMail() {
+    assert(this->parsedSize_ == sizeof(sharpen::GenericMailHeader) + this->content_.GetSize());
+    sharpen::ByteBuffer headerBuf{sizeof(sharpen::GenericMailHeader)};
+    sharpen::ByteBuffer contentBuf;
+    std::swap(headerBuf, this->header_);
+    std::swap(contentBuf, this->content_);
+    this->completedMails_.emplace_back(std::move(headerBuf), std::move(contentBuf));
+    this->parsedSize_ = 0;
+}
+
 void sharpen::GenericMailParser::NviParse(sharpen::ByteSlice slice) {
     for (auto begin = slice.Begin(), end = slice.End(); begin != end;) {
         switch (this->GetStatus()) {
@@ -69,31 +94,24 @@ void sharpen::GenericMailParser::NviParse(sharpen::ByteSlice slice) {
             std::memcpy(this->header_.Data() + offset, begin.GetPointer(), remainSize);
             this->parsedSize_ += remainSize;
             begin += remainSize;
+            if (this->parsedSize_ == sizeof(sharpen::GenericMailHeader)) {
+                this->PrepareContent();
+            }
         } break;
         case ParseStatus::Content: {
             assert(this->header_.GetSize() == sizeof(sharpen::GenericMailHeader));
             assert(this->parsedSize_ >= this->header_.GetSize());
-            const sharpen::GenericMailHeader *header{
-                &this->header_.As<sharpen::GenericMailHeader>()};
-            std::uint32_t contentSize{header->GetContentSize()};
-            if (contentSize > this->maxContentSize_) {
+            std::size_t offset{this->parsedSize_ - sizeof(sharpen::GenericMailHeader)};
+            if (offset >= this->content_.GetSize()) {
+                // PrepareContent() failed
                 throw sharpen::MailParseError{"content too long"};
             }
-            if (this->content_.Empty()) {
-                this->content_.ExtendTo(contentSize);
-            }
-            std::size_t offset{this->parsedSize_ - sizeof(sharpen::GenericMailHeader)};
-            std::size_t remainSize{contentSize - offset};
+            std::size_t remainSize{this->content_.GetSize() - offset};
             remainSize = (std::min)(remainSize, static_cast<std::size_t>(end - begin));
             std::memcpy(this->content_.Data() + offset, begin.GetPointer(), remainSize);
             this->parsedSize_ += remainSize;
-            if (this->parsedSize_ == sizeof(sharpen::GenericMailHeader) + contentSize) {
-                sharpen::ByteBuffer headerBuf{sizeof(sharpen::GenericMailHeader)};
-                sharpen::ByteBuffer contentBuf;
-                std::swap(headerBuf, this->header_);
-                std::swap(contentBuf, this->content_);
-                this->completedMails_.emplace_back(std::move(headerBuf), std::move(contentBuf));
-                this->parsedSize_ = 0;
+            if (this->parsedSize_ == sizeof(sharpen::GenericMailHeader) + this->content_.GetSize()) {
+                this->CompleteMail();
             }
             begin += remainSize;
         } break;
@@ -101,8 +119,34 @@ void sharpen::GenericMailParser::NviParse(sharpen::ByteSlice slice) {
     }
 }
 
+char *sharpen::GenericMailParser::NviGetDirectBuffer(std::size_t &size) noexcept {
+    if (this->GetStatus() != ParseStatus::Content) {
+        size = 0;
+        return nullptr;
+    }
+    std::size_t offset{this->parsedSize_ - sizeof(sharpen::GenericMailHeader)};
+    if (offset >= this->content_.GetSize()) {
+        size = 0;
+        return nullptr;
+    }
+    size = this->content_.GetSize() - offset;
+    return this->content_.Data() + offset;
+}
+
+void sharpen::GenericMailParser::NviCommitDirectBuffer(std::size_t size) {
+    std::size_t remainSize{0};
+    this->NviGetDirectBuffer(remainSize);
+    if (size > remainSize) {
+        throw sharpen::MailParseError{"direct buffer overflow"};
+    }
+    this->parsedSize_ += size;
+    if (this->parsedSize_ == sizeof(sharpen::GenericMailHeader) + this->content_.GetSize()) {
+        this->CompleteMail();
+    }
+}
+
 sharpen::Mail sharpen::GenericMailParser::NviPopCompletedMail() noexcept {
-    sharpen::Mail mail{this->completedMails_.front()};
+    sharpen::Mail mail{std::move(this->completedMails_.front())};
     this->completedMails_.pop_front();
     return mail;
 }
@@ -1,6 +1,7 @@
 #include <sharpen/IAsyncRandomWritable.hpp>
 
 #include <sharpen/AwaitableFuture.hpp>
+#include <vector>
 
 std::size_t sharpen::IAsyncRandomWritable::WriteAsync(const char *buf,
                                                       std::size_t bufSize,
@@ -21,4 +22,59 @@ std::size_t sharpen::IAsyncRandomWritable::WriteAsync(const sharpen::ByteBuffer
 std::size_t sharpen::IAsyncRandomWritable::WriteAsync(const sharpen::ByteBuffer &buf,
                                                       std::uint64_t offset) {
     return this->WriteAsync(buf, 0, offset);
+}
+
+void sharpen::IAsyncRandomWritable::WriteVectorAsync(const sharpen::ByteSlice *slices,
+                                                     std::size_t count,
+                                                     std::uint64_t offset,
+                                                     sharpen::Future<std::size_t> &future) {
+    for (std::size_t i = 0; i != count; ++i) {
+        if (!slices[i].Empty()) {
+            this->WriteAsync(slices[i].Data(), slices[i].GetSize(), offset, future);
+            return;
+        }
+    }
+    future.Complete(static_cast<std::size_t>(0));
+}
+
+std::size_t sharpen::IAsyncRandomWritable::WriteVectorAsync(const sharpen::ByteSlice *slices,
+                                                            std::size_t count,
+                                                            std::uint64_t offset) {
+    sharpen::AwaitableFuture<std::size_t> future;
+    this->WriteVectorAsync(slices, count, offset, future);
+    return future.Await();
+}
+
+std::size_t sharpen::IAsyncRandomWritable::WriteVectorFixedAsync(const sharpen::ByteSlice *slices,
+                                                                 std::size_t count,
+                                                                 std::uint64_t offset) {
+    std::size_t total{0};
+    for (std::size_t i = 0; i != count; ++i) {
+        total += slices[i].GetSize();
+    }
+    if (!total) {
+        return 0;
+    }
+    std::size_t off{this->WriteVectorAsync(slices, count, offset)};
+    if (off == total || !off) {
+        return off;
+    }
+    // partial write
+    std::vector<sharpen::ByteSlice> rest{slices, slices + count};
+    std::size_t pos{0};
+    std::size_t written{off};
+    while (off != total) {
+        // skip written bytes
+        while (written >= rest[pos].GetSize()) {
+            written -= rest[pos].GetSize();
+            pos += 1;
+        }
+        rest[pos] = sharpen::ByteSlice{rest[pos].Data() + written, rest[pos].GetSize() - written};
+        written = this->WriteVectorAsync(rest.data() + pos, rest.size() - pos, offset + off);
+        if (!written) {
+            break;
+        }
+        off += written;
+    }
+    return off;
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #include <sharpen/IAsyncWritable.hpp>
 
 #include <sharpen/AwaitableFuture.hpp>
+#include <vector>
 
 std::size_t sharpen::IAsyncWritable::WriteAsync(const char *buf, std::size_t bufSize) {
     sharpen::AwaitableFuture<std::size_t> future;
@@ -17,4 +18,56 @@ std::size_t sharpen::IAsyncWritable::WriteAsync(const sharpen::ByteBuffer &buf,
 
 std::size_t sharpen::IAsyncWritable::WriteAsync(const sharpen::ByteBuffer &buf) {
     return this->WriteAsync(buf, 0);
+}
+
+void sharpen::IAsyncWritable::WriteVectorAsync(const sharpen::ByteSlice *slices,
+                                               std::size_t count,
+                                               sharpen::Future<std::size_t> &future) {
+    for (std::size_t i = 0; i != count; ++i) {
+        if (!slices[i].Empty()) {
+            this->WriteAsync(slices[i].Data(), slices[i].GetSize(), future);
+            return;
+        }
+    }
+    future.Complete(static_cast<std::size_t>(0));
+}
+
+std::size_t sharpen::IAsyncWritable::WriteVectorAsync(const sharpen::ByteSlice *slices,
+                                                      std::size_t count) {
+    sharpen::AwaitableFuture<std::size_t> future;
+    this->WriteVectorAsync(slices, count, future);
+    return future.Await();
+}
+
+std::size_t sharpen::IAsyncWritable::WriteVectorFixedAsync(const sharpen::ByteSlice *slices,
+                                                           std::size_t count) {
+    std::size_t total{0};
+    for (std::size_t i = 0; i != count; ++i) {
+        total += slices[i].GetSize();
+    }
+    if (!total) {
+        return 0;
+    }
+    std::size_t off{this->WriteVectorAsync(slices, count)};
+    if (off == total || !off) {
+        return off;
+    }
+    // partial write
+    std::vector<sharpen::ByteSlice> rest{slices, slices + count};
+    std::size_t pos{0};
+    std::size_t written{off};
+    while (off != total) {
+        // skip written bytes
+        while (written >= rest[pos].GetSize()) {
+            written -= rest[pos].GetSize();
+            pos += 1;
+        }
+        rest[pos] = sharpen::ByteSlice{rest[pos].Data() + written, rest[pos].GetSize() - written};
+        written = this->WriteVectorAsync(rest.data() + pos, rest.size() - pos);
+        if (!written) {
+            break;
+        }
+        off += written;
+    }
+    return off;
 }
\ No newline at end of file
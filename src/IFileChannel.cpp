@@ -192,6 +192,12 @@ void sharpen::IFileChannel::FlushAsync() {
     return future.Await();
 }
 
+void sharpen::IFileChannel::FlushDataAsync() {
+    sharpen::AwaitableFuture<void> future;
+    this->FlushDataAsync(future);
+    return future.Await();
+}
+
 std::size_t sharpen::IFileChannel::AllocateAsync(std::uint64_t offset, std::size_t size) {
     sharpen::AwaitableFuture<std::size_t> future;
     this->AllocateAsync(future,offset,size);
@@ -55,6 +55,44 @@ sharpen::NetStreamChannelPtr sharpen::OpenTcpChannel(sharpen::AddressFamily af)
     return channel;
 }
 
+sharpen::NetStreamChannelPtr sharpen::OpenUdpChannel(sharpen::AddressFamily af) {
+    sharpen::NetStreamChannelPtr channel;
+    int afValue;
+    if (af == sharpen::AddressFamily::Ip) {
+        afValue = AF_INET;
+    } else {
+        afValue = AF_INET6;
+    }
+#ifdef SHARPEN_HAS_WINSOCKET
+    SOCKET s = ::socket(afValue, SOCK_DGRAM, IPPROTO_UDP);
+    if (s == INVALID_SOCKET) {
+        sharpen::ThrowLastError();
+    }
+    try {
+        channel = std::make_shared<sharpen::WinNetStreamChannel>(
+            reinterpret_cast<sharpen::FileHandle>(s), afValue);
+    } catch (const std::exception &rethrow) {
+        ::closesocket(s);
+        throw;
+        (void)rethrow;
+    }
+#else
+    sharpen::FileHandle s =
+        ::socket(afValue, SOCK_DGRAM | SOCK_CLOEXEC | SOCK_NONBLOCK, IPPROTO_UDP);
+    if (s == -1) {
+        sharpen::ThrowLastError();
+    }
+    try {
+        channel = std::make_shared<sharpen::PosixNetStreamChannel>(s);
+    } catch (const std::exception &rethrow) {
+        sharpen::CloseFileHandle(s);
+        throw;
+        (void)rethrow;
+    }
+#endif
+    return channel;
+}
+
 void sharpen::StartupNetSupport() {
 #ifdef SHARPEN_HAS_WINSOCKET
     WORD version = MAKEWORD(2, 2);
@@ -204,6 +242,19 @@ void sharpen::INetStreamChannel::ReuseAddressInNix() {
 #endif
 }
 
+void sharpen::INetStreamChannel::SetReusePort(bool val) {
+#if defined(SHARPEN_IS_NIX) && defined(SO_REUSEPORT)
+    int opt = val ? 1 : 0;
+    int r = ::setsockopt(this->handle_, SOL_SOCKET, SO_REUSEPORT, &opt, sizeof(opt));
+    if (r == -1) {
+        sharpen::ThrowLastError();
+    }
+#else
+    (void)val;
+    sharpen::ThrowSystemError(sharpen::ErrorOperationNotSupport);
+#endif
+}
+
 int sharpen::INetStreamChannel::GetErrorCode() const noexcept {
     int err{0};
 #ifdef SHARPEN_IS_WIN
@@ -2,9 +2,15 @@
 
 #ifdef SHARPEN_IS_NIX
 
+#include <algorithm>
 #include <cassert>
+#include <climits>
 #include <mutex>
 
+#ifndef IOV_MAX
+#define IOV_MAX 1024
+#endif
+
 sharpen::IPosixIoOperator::IPosixIoOperator()
     : bufs_()
     , pendingBufs_()
@@ -94,6 +100,79 @@ void sharpen::IPosixIoOperator::AddPendingTask(char *buf,
     this->pendingCbs_.push_back(std::move(cb));
 }
 
+void sharpen::IPosixIoOperator::CompleteVectorTask(std::shared_ptr<VectorTask> task,
+                                                   ssize_t size) {
+    if (!task->cb_) {
+        // already completed
+        return;
+    }
+    Callback cb;
+    if (size <= 0) {
+        std::swap(cb, task->cb_);
+        if (task->size_) {
+            cb(static_cast<ssize_t>(task->size_));
+            return;
+        }
+        cb(size);
+        return;
+    }
+    task->size_ += static_cast<std::size_t>(size);
+    task->remaining_ -= 1;
+    if (!task->remaining_) {
+        std::swap(cb, task->cb_);
+        cb(static_cast<ssize_t>(task->size_));
+    }
+}
+
+void sharpen::IPosixIoOperator::AddPendingTasks(const iovec *bufs,
+                                                std::size_t count,
+                                                sharpen::IPosixIoOperator::Callback cb) {
+    assert(count);
+    assert(cb);
+    if (count == 1) {
+        this->AddPendingTask(
+            reinterpret_cast<char *>(bufs[0].iov_base), bufs[0].iov_len, std::move(cb));
+        return;
+    }
+    std::shared_ptr<VectorTask> task{std::make_shared<VectorTask>()};
+    task->remaining_ = count;
+    task->size_ = 0;
+    task->cb_ = std::move(cb);
+    using FnPtr = void (*)(std::shared_ptr<VectorTask>, ssize_t);
+    Callback callback{
+        std::bind(static_cast<FnPtr>(&sharpen::IPosixIoOperator::CompleteVectorTask),
+                  std::move(task),
+                  std::placeholders::_1)};
+    Callbacks cbs{count, callback};
+    // don't throw after pushing some buffers
+    this->pendingBufs_.reserve(this->pendingBufs_.size() + count);
+    this->pendingCbs_.reserve(this->pendingCbs_.size() + count);
+    for (std::size_t i = 0; i != count; ++i) {
+        this->pendingBufs_.push_back(bufs[i]);
+        this->pendingCbs_.push_back(std::move(cbs[i]));
+    }
+}
+
+void sharpen::IPosixIoOperator::ConvertSlices(const sharpen::ByteSlice *slices,
+                                              std::size_t count,
+                                              std::vector<iovec> &bufs) {
+    std::size_t total{0};
+    bufs.reserve((std::min)(count, static_cast<std::size_t>(IOV_MAX)));
+    for (std::size_t i = 0; i != count && bufs.size() != IOV_MAX && total != sharpen::MaxIoSize;
+         ++i) {
+        std::size_t size{slices[i].GetSize()};
+        if (!size) {
+            continue;
+        }
+        size = (std::min)(size, sharpen::MaxIoSize - total);
+        iovec buf;
+        buf.iov_base = const_cast<char *>(slices[i].Data());
+        buf.iov_len = size;
+        bufs.push_back(buf);
+        total += size;
+    }
+}
+
 std::size_t sharpen::IPosixIoOperator::GetRemainingSize() const {
     assert(this->bufs_.size() == this->cbs_.size());
     assert(this->bufs_.size() >= this->mark_);
@@ -107,6 +186,10 @@ void sharpen::IPosixIoOperator::Execute(sharpen::FileHandle handle,
     this->NviExecute(handle, executed, blocking);
 }
 
+bool sharpen::IPosixIoOperator::HasPendingTask() const {
+    return this->GetRemainingSize() != 0 || !this->pendingBufs_.empty();
+}
+
 bool sharpen::IPosixIoOperator::IsBlockingError(sharpen::ErrorCode err) {
 #ifdef EAGAIN
     return err == EAGAIN;
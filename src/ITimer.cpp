@@ -1,6 +1,8 @@
 #include <sharpen/IEventLoopGroup.hpp>
 #include <sharpen/ITimer.hpp>
+#include <sharpen/EventLoop.hpp>
 #include <sharpen/LinuxTimer.hpp>
+#include <sharpen/WheelTimer.hpp>
 #include <sharpen/WinTimer.hpp>
 
 sharpen::TimerPtr sharpen::MakeTimer() {
@@ -12,6 +14,9 @@ sharpen::TimerPtr sharpen::MakeTimer(sharpen::EventLoop &loop) {
     (void)loop;
     sharpen::TimerPtr timer = std::make_shared<sharpen::WinTimer>();
     return timer;
+#elif (defined SHARPEN_HAS_TIMERWHEEL)
+    sharpen::TimerPtr timer = std::make_shared<sharpen::WheelTimer>(loop.GetTimerWheel());
+    return timer;
 #elif (defined SHARPEN_HAS_TIMERFD)
     std::shared_ptr<sharpen::LinuxTimer> timer = std::make_shared<sharpen::LinuxTimer>();
     timer->Register(loop);
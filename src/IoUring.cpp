@@ -22,7 +22,9 @@ sharpen::IoUring::IoUring(std::uint32_t entries,
     , cring_()
     , cringSize_(0)
     , cringNumber_(0)
-    , requestNumber_(0) {
+    , requestNumber_(0)
+    , setupFlags_(flags)
+    , features_(0) {
     struct io_uring_params p;
     std::memset(&p, 0, sizeof(p));
     p.flags = flags;
@@ -108,6 +110,7 @@ sharpen::IoUring::IoUring(std::uint32_t entries,
     this->sqes_ = reinterpret_cast<struct io_uring_sqe *>(sring);
     this->sringNumber_ = p.sq_entries;
     this->cringNumber_ = p.cq_entries;
+    this->features_ = p.features;
 }
 
 sharpen::IoUring::~IoUring() noexcept {
@@ -125,10 +128,10 @@ sharpen::IoUring::~IoUring() noexcept {
     }
 }
 
-void sharpen::IoUring::Enter(unsigned int to_submit,
-                             unsigned int min_complete,
-                             unsigned int flags,
-                             sigset_t *sig) {
+int sharpen::IoUring::Enter(unsigned int to_submit,
+                            unsigned int min_complete,
+                            unsigned int flags,
+                            sigset_t *sig) {
     int r;
     do {
         r = sharpen::IoUringEnter(this->ringFd_, to_submit, min_complete, flags, sig);
@@ -136,13 +139,14 @@ void sharpen::IoUring::Enter(unsigned int to_submit,
     if (r == -1) {
         sharpen::ThrowLastError();
     }
+    return r;
 }
 
-void sharpen::IoUring::Enter(unsigned int to_submit,
-                             unsigned int min_complete,
-                             unsigned int flags,
-                             void *arg,
-                             size_t argsz) {
+int sharpen::IoUring::Enter(unsigned int to_submit,
+                            unsigned int min_complete,
+                            unsigned int flags,
+                            void *arg,
+                            size_t argsz) {
     int r;
     do {
         r = sharpen::IoUringEnterEx(this->ringFd_, to_submit, min_complete, flags, arg, argsz);
@@ -150,6 +154,7 @@ void sharpen::IoUring::Enter(unsigned int to_submit,
     if (r == -1) {
         sharpen::ThrowLastError();
     }
+    return r;
 }
 
 void sharpen::IoUring::SubmitToSring(const struct io_uring_sqe *sqe) {
@@ -179,7 +184,32 @@ bool sharpen::IoUring::GetFromCring(struct io_uring_cqe *cqe) {
 }
 
 bool sharpen::IoUring::Requestable() const {
-    return this->requestNumber_ < this->sringNumber_;
+    // old kernels drop cqes when cring overflows
+    if (!(this->features_ & IORING_FEAT_NODROP) && this->requestNumber_ >= this->cringNumber_) {
+        return false;
+    }
+    // requests such as socket reads may stay in kernel for a long time
+    // so we only limit the number of sqes which have not been consumed
+    unsigned int head{Self::Load(this->sring_.head_)};
+    unsigned int tail{*this->sring_.tail_};
+    return tail - head < this->sringNumber_;
+}
+
+bool sharpen::IoUring::NeedWakeup() const noexcept {
+    if (!this->IsSqPoll()) {
+        return false;
+    }
+    // the tail must be visible to sq thread before we check the flags
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    return Self::Load(this->sring_.flags_) & IORING_SQ_NEED_WAKEUP;
+}
+
+bool sharpen::IoUring::HasCompletions() const noexcept {
+    return Self::Load(this->cring_.head_) != Self::Load(this->cring_.tail_);
+}
+
+bool sharpen::IoUring::CqOverflow() const noexcept {
+    return Self::Load(this->sring_.flags_) & IORING_SQ_CQ_OVERFLOW;
 }
 
 void sharpen::IoUring::RegisterEventFd(const sharpen::EventFd &eventFd) {
@@ -195,4 +225,59 @@ void sharpen::IoUring::UnregisterEventFd() {
     }
 }
 
-#endif
\ No newline at end of file
+void sharpen::IoUring::RegisterFiles(const int *fds, unsigned int count) {
+    if (sharpen::IoUringRegister(
+            this->ringFd_, IORING_REGISTER_FILES, const_cast<int *>(fds), count) == -1) {
+        sharpen::ThrowLastError();
+    }
+}
+
+void sharpen::IoUring::UpdateFiles(unsigned int offset, const int *fds, unsigned int count) {
+    struct io_uring_files_update update;
+    std::memset(&update, 0, sizeof(update));
+    update.offset = offset;
+    update.fds = reinterpret_cast<std::uint64_t>(fds);
+    if (sharpen::IoUringRegister(this->ringFd_, IORING_REGISTER_FILES_UPDATE, &update, count) ==
+        -1) {
+        sharpen::ThrowLastError();
+    }
+}
+
+void sharpen::IoUring::RegisterBuffers(const struct iovec *bufs, unsigned int count) {
+    if (sharpen::IoUringRegister(this->ringFd_,
+                                 IORING_REGISTER_BUFFERS,
+                                 const_cast<struct iovec *>(bufs),
+                                 count) == -1) {
+        sharpen::ThrowLastError();
+    }
+}
+
+void sharpen::IoUring::UnregisterBuffers() {
+    if (sharpen::IoUringRegister(this->ringFd_, IORING_UNREGISTER_BUFFERS, nullptr, 0) == -1) {
+        sharpen::ThrowLastError();
+    }
+}
+
+void sharpen::IoUring::RegisterBufRing(struct io_uring_buf_ring *ring,
+                                       unsigned int entries,
+                                       std::uint16_t group) {
+    struct io_uring_buf_reg reg;
+    std::memset(&reg, 0, sizeof(reg));
+    reg.ring_addr = reinterpret_cast<std::uint64_t>(ring);
+    reg.ring_entries = entries;
+    reg.bgid = group;
+    if (sharpen::IoUringRegister(this->ringFd_, IORING_REGISTER_PBUF_RING, &reg, 1) == -1) {
+        sharpen::ThrowLastError();
+    }
+}
+
+void sharpen::IoUring::UnregisterBufRing(std::uint16_t group) {
+    struct io_uring_buf_reg reg;
+    std::memset(&reg, 0, sizeof(reg));
+    reg.bgid = group;
+    if (sharpen::IoUringRegister(this->ringFd_, IORING_UNREGISTER_PBUF_RING, &reg, 1) == -1) {
+        sharpen::ThrowLastError();
+    }
+}
+
+#endif
@@ -3,49 +3,152 @@
 #ifdef SHARPEN_HAS_IOURING
 
 #include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <sharpen/AlignedAlloc.hpp>
+#include <sharpen/IoUringStruct.hpp>
 #include <sharpen/IteratorOps.hpp>
+#include <atomic>
+#include <cassert>
+#include <cerrno>
 #include <cstring>
+#include <mutex>
+#include <new>
 
 sharpen::IoUringQueue::IoUringQueue()
     : IoUringQueue(false) {
 }
 
 sharpen::IoUringQueue::IoUringQueue(bool blockEventFd)
+    : IoUringQueue(blockEventFd, Self::defaultQueueLength_, false) {
+}
+
+sharpen::IoUringQueue::IoUringQueue(bool blockEventFd, std::uint32_t queueLength, bool sqPoll)
     : eventFd_(0, O_CLOEXEC | (blockEventFd ? 0 : O_NONBLOCK))
-    , ring_(Self::queueLength_, 0, 0, 0, 0)
+    , ring_(queueLength, Self::GetSetupFlags(sqPoll), 0, Self::sqThreadIdle_, 0)
     , compQueue_()
-    , subQueue_() {
+    , subQueue_()
+    , unflushed_(0)
+    , structs_()
+    , fixedStatus_(FixedStatus::Uninitialized)
+    , fixedLock_()
+    , fixedFiles_()
+    , fixedBuffers_(nullptr)
+    , freeBuffers_()
+    , recvStatus_(FixedStatus::Uninitialized)
+    , recvLock_()
+    , recvRing_(nullptr)
+    , recvBuffers_(nullptr)
+    , recvTail_(0)
+    , releasedBuffers_()
+    , providingBuffers_()
+    , multishotRecv_(true) {
     this->compQueue_.reserve(reservedCqSize_);
+    // FreeStruct() never allocates memory
+    this->structs_.reserve(maxCachedStructs_);
     this->ring_.RegisterEventFd(this->eventFd_);
 }
 
 sharpen::IoUringQueue::~IoUringQueue() noexcept {
+    for (auto begin = this->structs_.begin(), end = this->structs_.end(); begin != end;
+         ++begin) {
+        delete *begin;
+    }
+    if (this->fixedBuffers_) {
+        try {
+            this->ring_.UnregisterBuffers();
+        } catch (const std::system_error &ignore) {
+            (void)ignore;
+        }
+        sharpen::AlignedFree(this->fixedBuffers_);
+    }
+    if (this->recvRing_) {
+        try {
+            this->ring_.UnregisterBufRing(recvBufferGroup_);
+        } catch (const std::system_error &ignore) {
+            (void)ignore;
+        }
+        sharpen::AlignedFree(this->recvRing_);
+    }
+    sharpen::AlignedFree(this->recvBuffers_);
     this->ring_.UnregisterEventFd();
 }
 
-void sharpen::IoUringQueue::Submit() {
-    if (this->subQueue_.empty()) {
-        return;
+bool sharpen::IoUringQueue::TestSqPoll() noexcept {
+    try {
+        sharpen::IoUring ring{1, IORING_SETUP_SQPOLL, 0, Self::sqThreadIdle_, 0};
+        static_cast<void>(ring);
+        return true;
+    } catch (const std::system_error &ignore) {
+        (void)ignore;
+        return false;
+    }
+}
+
+std::uint32_t sharpen::IoUringQueue::GetSetupFlags(bool sqPoll) noexcept {
+    if (!sqPoll) {
+        return 0;
     }
+    // sq polling requires privilege on old kernels
+    // loops are constructed by different threads
+    static const bool supported{Self::TestSqPoll()};
+    if (supported) {
+        return IORING_SETUP_SQPOLL;
+    }
+    return 0;
+}
+
+void sharpen::IoUringQueue::Submit() {
     auto ite = this->subQueue_.begin();
-    std::size_t moved{0};
-    while (this->ring_.Requestable()) {
+    while (ite != this->subQueue_.end() && this->ring_.Requestable()) {
         this->ring_.SubmitToSring(&*ite);
         ++ite;
-        ++moved;
+        ++this->unflushed_;
     }
     this->subQueue_.erase(this->subQueue_.begin(), ite);
-    this->ring_.Enter(moved, 0, 0);
 }
 
 void sharpen::IoUringQueue::SubmitIoRequest(const Sqe &sqe) {
-    if (this->ring_.Requestable()) {
+    if (this->subQueue_.empty() && this->ring_.Requestable()) {
         this->ring_.SubmitToSring(&sqe);
-        this->ring_.Enter(1, 0, 0);
+        ++this->unflushed_;
         return;
     }
     this->subQueue_.emplace_back(sqe);
-    return;
+}
+
+void sharpen::IoUringQueue::Flush() {
+    this->ProvideRecvBuffers();
+    // move pending sqes to sring
+    this->Submit();
+    while (this->unflushed_) {
+        if (this->ring_.IsSqPoll()) {
+            // sq thread consumes sring by itself
+            this->unflushed_ = 0;
+            if (this->ring_.NeedWakeup()) {
+                this->ring_.Enter(0, 0, IORING_ENTER_SQ_WAKEUP);
+            }
+            return;
+        }
+        int r{0};
+        try {
+            r = this->ring_.Enter(static_cast<unsigned int>(this->unflushed_), 0, 0);
+        } catch (const std::system_error &error) {
+            // kernel is busy
+            // retry in next flush
+            if (error.code().value() == EAGAIN || error.code().value() == EBUSY) {
+                return;
+            }
+            throw;
+        }
+        assert(r >= 0 && static_cast<std::size_t>(r) <= this->unflushed_);
+        this->unflushed_ -= static_cast<std::size_t>(r);
+        if (!r || this->subQueue_.empty()) {
+            return;
+        }
+        // sring has been drained by kernel
+        this->Submit();
+    }
 }
 
 std::size_t sharpen::IoUringQueue::GetCompletionStatus(Cqe *cqes, std::size_t size) {
@@ -78,10 +181,326 @@ std::size_t sharpen::IoUringQueue::GetCompletionStatus(Cqe *cqes, std::size_t si
             this->compQueue_.pop_back();
         }
     }
+    // cring is empty now
+    // move overflowed cqes to cring
+    if (this->ring_.CqOverflow()) {
+        this->ring_.FlushOverflow();
+    }
     this->Submit();
     return cqeNum;
 }
 
+sharpen::IoUringStruct *sharpen::IoUringQueue::AllocStruct() noexcept {
+    if (this->structs_.empty()) {
+        return new (std::nothrow) sharpen::IoUringStruct();
+    }
+    sharpen::IoUringStruct *st{this->structs_.back()};
+    this->structs_.pop_back();
+    return st;
+}
+
+void sharpen::IoUringQueue::FreeStruct(sharpen::IoUringStruct *st) noexcept {
+    if (!st) {
+        return;
+    }
+    if (this->structs_.size() == maxCachedStructs_) {
+        delete st;
+        return;
+    }
+    // release the channel
+    st->channel_.reset();
+    st->event_ = sharpen::IoEvent{};
+    st->data_ = nullptr;
+    st->vecs_.clear();
+    st->multishot_ = false;
+    st->results_.clear();
+    st->orphan_ = false;
+    this->structs_.push_back(st);
+}
+
+bool sharpen::IoUringQueue::InitFixedResources() noexcept {
+    if (this->fixedStatus_ != FixedStatus::Uninitialized) {
+        return this->fixedStatus_ == FixedStatus::Enabled;
+    }
+    this->fixedStatus_ = FixedStatus::Unsupported;
+    char *buffers{nullptr};
+    try {
+        this->fixedFiles_.assign(fixedFileCount_, -1);
+        this->ring_.RegisterFiles(this->fixedFiles_.data(),
+                                  static_cast<unsigned int>(this->fixedFiles_.size()));
+        buffers = reinterpret_cast<char *>(
+            sharpen::AlignedAlloc(fixedBufferCount_ * fixedBufferSize_, 4096));
+        if (!buffers) {
+            return false;
+        }
+        std::vector<struct iovec> vecs(fixedBufferCount_);
+        for (std::size_t i = 0; i != fixedBufferCount_; ++i) {
+            vecs[i].iov_base = buffers + i * fixedBufferSize_;
+            vecs[i].iov_len = fixedBufferSize_;
+        }
+        // may fail because of RLIMIT_MEMLOCK
+        this->ring_.RegisterBuffers(vecs.data(), static_cast<unsigned int>(vecs.size()));
+        this->freeBuffers_.reserve(fixedBufferCount_);
+        for (std::size_t i = 0; i != fixedBufferCount_; ++i) {
+            this->freeBuffers_.push_back(static_cast<int>(i));
+        }
+    } catch (const std::exception &ignore) {
+        (void)ignore;
+        sharpen::AlignedFree(buffers);
+        return false;
+    }
+    this->fixedBuffers_ = buffers;
+    this->fixedStatus_ = FixedStatus::Enabled;
+    return true;
+}
+
+int sharpen::IoUringQueue::RegisterFile(sharpen::FileHandle handle) noexcept {
+    std::unique_lock<sharpen::SpinLock> lock{this->fixedLock_};
+    if (!this->InitFixedResources()) {
+        return -1;
+    }
+    for (std::size_t i = 0; i != this->fixedFiles_.size(); ++i) {
+        if (this->fixedFiles_[i] == -1) {
+            try {
+                this->ring_.UpdateFiles(static_cast<unsigned int>(i), &handle, 1);
+            } catch (const std::system_error &ignore) {
+                (void)ignore;
+                return -1;
+            }
+            this->fixedFiles_[i] = handle;
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+void sharpen::IoUringQueue::UnregisterFile(int index) noexcept {
+    assert(index >= 0);
+    std::unique_lock<sharpen::SpinLock> lock{this->fixedLock_};
+    assert(static_cast<std::size_t>(index) < this->fixedFiles_.size());
+    int fd{-1};
+    try {
+        // requests in flight still hold the file
+        this->ring_.UpdateFiles(static_cast<unsigned int>(index), &fd, 1);
+    } catch (const std::system_error &ignore) {
+        (void)ignore;
+    }
+    this->fixedFiles_[index] = -1;
+}
+
+char *sharpen::IoUringQueue::AllocFixedBuffer(std::size_t size, int &index) noexcept {
+    if (!this->fixedBuffers_ || size > fixedBufferSize_ || this->freeBuffers_.empty()) {
+        return nullptr;
+    }
+    index = this->freeBuffers_.back();
+    this->freeBuffers_.pop_back();
+    return this->GetFixedBuffer(index);
+}
+
+void sharpen::IoUringQueue::FreeFixedBuffer(int index) noexcept {
+    assert(index >= 0 && static_cast<std::size_t>(index) < fixedBufferCount_);
+    // never allocates memory
+    this->freeBuffers_.push_back(index);
+}
+
+char *sharpen::IoUringQueue::GetFixedBuffer(int index) const noexcept {
+    assert(this->fixedBuffers_);
+    assert(index >= 0 && static_cast<std::size_t>(index) < fixedBufferCount_);
+    return this->fixedBuffers_ + static_cast<std::size_t>(index) * fixedBufferSize_;
+}
+
+sharpen::IoUringQueue::RecvBufferMode sharpen::IoUringQueue::TestRecvBufferMode() noexcept {
+    // some kernels accept buffer rings but never select buffers from them
+    // probe them with a recv on a socket pair
+    int status{3};
+    struct io_uring_buf_ring *bufRing{reinterpret_cast<struct io_uring_buf_ring *>(
+        sharpen::AlignedAlloc(sizeof(struct io_uring_buf), 4096))};
+    char buf[1]{0};
+    int fds[2];
+    if (bufRing && ::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds) == 0) {
+        try {
+            sharpen::IoUring ring{2, 0, 0, 0, 0};
+            std::memset(bufRing, 0, sizeof(struct io_uring_buf));
+            // fail with EINVAL before linux 5.19
+            ring.RegisterBufRing(bufRing, 1, recvBufferGroup_);
+            status = 2;
+            bufRing->bufs[0].addr = reinterpret_cast<std::uint64_t>(buf);
+            bufRing->bufs[0].len = sizeof(buf);
+            bufRing->bufs[0].bid = 0;
+            std::atomic_store_explicit(
+                reinterpret_cast<std::atomic<std::uint16_t> *>(&bufRing->tail),
+                static_cast<std::uint16_t>(1),
+                std::memory_order_release);
+            if (::write(fds[1], buf, sizeof(buf)) == 1) {
+                Sqe sqe;
+                std::memset(&sqe, 0, sizeof(sqe));
+                sqe.opcode = IORING_OP_RECV;
+                sqe.fd = fds[0];
+                sqe.flags = IOSQE_BUFFER_SELECT;
+                sqe.buf_group = recvBufferGroup_;
+                ring.SubmitToSring(&sqe);
+                ring.Enter(1, 1, IORING_ENTER_GETEVENTS);
+                Cqe cqe;
+                if (ring.GetFromCring(&cqe) && cqe.res == 1 && (cqe.flags & IORING_CQE_F_BUFFER)) {
+                    status = 1;
+                }
+            }
+        } catch (const std::exception &ignore) {
+            (void)ignore;
+        }
+        ::close(fds[0]);
+        ::close(fds[1]);
+    }
+    sharpen::AlignedFree(bufRing);
+    if (status == 1) {
+        return RecvBufferMode::Ring;
+    } else if (status == 2) {
+        return RecvBufferMode::Provide;
+    }
+    return RecvBufferMode::Unsupported;
+}
+
+sharpen::IoUringQueue::RecvBufferMode sharpen::IoUringQueue::GetRecvBufferMode() noexcept {
+    // queues are constructed by different threads
+    static const RecvBufferMode mode{Self::TestRecvBufferMode()};
+    return mode;
+}
+
+bool sharpen::IoUringQueue::InitRecvBuffers() noexcept {
+    if (this->recvStatus_ != FixedStatus::Uninitialized) {
+        return this->recvStatus_ == FixedStatus::Enabled;
+    }
+    this->recvStatus_ = FixedStatus::Unsupported;
+    RecvBufferMode mode{Self::GetRecvBufferMode()};
+    if (mode == RecvBufferMode::Unsupported) {
+        return false;
+    }
+    char *buffers{
+        reinterpret_cast<char *>(sharpen::AlignedAlloc(recvBufferCount_ * recvBufferSize_, 4096))};
+    if (!buffers) {
+        return false;
+    }
+    if (mode == RecvBufferMode::Provide) {
+        try {
+            // ReleaseRecvBuffer() never allocates memory
+            this->releasedBuffers_.reserve(recvBufferCount_);
+            this->providingBuffers_.reserve(recvBufferCount_);
+        } catch (const std::bad_alloc &ignore) {
+            (void)ignore;
+            sharpen::AlignedFree(buffers);
+            return false;
+        }
+        this->recvBuffers_ = buffers;
+        for (std::size_t i = 0; i != recvBufferCount_; ++i) {
+            this->providingBuffers_.push_back(static_cast<std::uint16_t>(i));
+        }
+        try {
+            this->ProvideRecvBuffers();
+        } catch (const std::bad_alloc &ignore) {
+            // retry in next flush
+            (void)ignore;
+        }
+        this->recvStatus_ = FixedStatus::Enabled;
+        return true;
+    }
+    void *ring{sharpen::AlignedAlloc(recvBufferCount_ * sizeof(struct io_uring_buf), 4096)};
+    if (!ring) {
+        sharpen::AlignedFree(buffers);
+        return false;
+    }
+    std::memset(ring, 0, recvBufferCount_ * sizeof(struct io_uring_buf));
+    try {
+        this->ring_.RegisterBufRing(reinterpret_cast<struct io_uring_buf_ring *>(ring),
+                                    static_cast<unsigned int>(recvBufferCount_),
+                                    recvBufferGroup_);
+    } catch (const std::system_error &ignore) {
+        (void)ignore;
+        sharpen::AlignedFree(ring);
+        sharpen::AlignedFree(buffers);
+        return false;
+    }
+    this->recvRing_ = reinterpret_cast<struct io_uring_buf_ring *>(ring);
+    this->recvBuffers_ = buffers;
+    {
+        std::unique_lock<sharpen::SpinLock> lock{this->recvLock_};
+        for (std::size_t i = 0; i != recvBufferCount_; ++i) {
+            this->PushRecvBuffer(static_cast<std::uint16_t>(i));
+        }
+    }
+    this->recvStatus_ = FixedStatus::Enabled;
+    return true;
+}
+
+void sharpen::IoUringQueue::PushRecvBuffer(std::uint16_t bid) noexcept {
+    assert(this->recvRing_);
+    std::size_t mask{recvBufferCount_ - 1};
+    struct io_uring_buf *buf{&this->recvRing_->bufs[this->recvTail_ & mask]};
+    buf->addr = reinterpret_cast<std::uint64_t>(this->GetRecvBuffer(bid));
+    buf->len = static_cast<std::uint32_t>(recvBufferSize_);
+    buf->bid = bid;
+    this->recvTail_ += 1;
+    // publish the buffer to kernel
+    std::atomic_store_explicit(reinterpret_cast<std::atomic<std::uint16_t> *>(
+                                   &this->recvRing_->tail),
+                               this->recvTail_,
+                               std::memory_order_release);
+}
+
+void sharpen::IoUringQueue::ProvideRecvBuffers() {
+    if (!this->recvBuffers_ || this->recvRing_) {
+        return;
+    }
+    if (this->providingBuffers_.empty()) {
+        std::unique_lock<sharpen::SpinLock> lock{this->recvLock_};
+        std::swap(this->releasedBuffers_, this->providingBuffers_);
+    }
+    while (!this->providingBuffers_.empty()) {
+        std::uint16_t bid{this->providingBuffers_.back()};
+        Sqe sqe;
+        std::memset(&sqe, 0, sizeof(sqe));
+        sqe.opcode = IORING_OP_PROVIDE_BUFFERS;
+        // the number of buffers
+        sqe.fd = 1;
+        sqe.addr = reinterpret_cast<std::uint64_t>(this->GetRecvBuffer(bid));
+        sqe.len = static_cast<std::uint32_t>(recvBufferSize_);
+        sqe.off = bid;
+        sqe.buf_group = recvBufferGroup_;
+        this->SubmitIoRequest(sqe);
+        this->providingBuffers_.pop_back();
+    }
+}
+
+bool sharpen::IoUringQueue::SupportMultishot() noexcept {
+    return this->InitRecvBuffers();
+}
+
+char *sharpen::IoUringQueue::GetRecvBuffer(std::uint16_t bid) const noexcept {
+    assert(this->recvBuffers_);
+    assert(bid < recvBufferCount_);
+    return this->recvBuffers_ + static_cast<std::size_t>(bid) * recvBufferSize_;
+}
+
+void sharpen::IoUringQueue::ReleaseRecvBuffer(std::uint16_t bid) noexcept {
+    std::unique_lock<sharpen::SpinLock> lock{this->recvLock_};
+    if (!this->recvRing_) {
+        this->releasedBuffers_.push_back(bid);
+        return;
+    }
+    this->PushRecvBuffer(bid);
+}
+
+void sharpen::IoUringQueue::DropMultishotResult(const sharpen::IoUringStruct &st,
+                                               const Cqe &cqe) noexcept {
+    if (cqe.flags & IORING_CQE_F_BUFFER) {
+        this->ReleaseRecvBuffer(static_cast<std::uint16_t>(cqe.flags >> IORING_CQE_BUFFER_SHIFT));
+        return;
+    }
+    // an accepted connection
+    if (!st.event_.IsReadEvent() && cqe.res >= 0) {
+        ::close(cqe.res);
+    }
+}
+
 bool sharpen::TestIoUring() noexcept {
     static int status{0};
     if (!status) {
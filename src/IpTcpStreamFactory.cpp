@@ -12,11 +12,19 @@ sharpen::IpTcpStreamFactory::IpTcpStreamFactory(sharpen::IEventLoopGroup &loopGr
 
 sharpen::NetStreamChannelPtr sharpen::IpTcpStreamFactory::NviProduce(sharpen::TcpStreamOption opt) {
     assert(this->loopGroup_);
+    return this->NviProduce(std::move(opt), this->loopGroup_->RoundRobinLoop());
+}
+
+sharpen::NetStreamChannelPtr sharpen::IpTcpStreamFactory::NviProduce(sharpen::TcpStreamOption opt,
+                                                                     sharpen::EventLoop &loop) {
     sharpen::NetStreamChannelPtr channel{sharpen::OpenTcpChannel(sharpen::AddressFamily::Ip)};
     if (opt.IsEnableReuseAddress()) {
         channel->SetReuseAddress(true);
     }
+    if (opt.IsEnableReusePort()) {
+        channel->SetReusePort(true);
+    }
     channel->Bind(this->localEndpoint_);
-    channel->Register(*this->loopGroup_);
+    channel->Register(loop);
     return channel;
 }
\ No newline at end of file
@@ -20,10 +20,8 @@ sharpen::LinuxSignalFdChannel::LinuxSignalFdChannel(sharpen::FileHandle handle)
 void sharpen::LinuxSignalFdChannel::DoSafeClose(sharpen::ErrorCode err,
                                                 sharpen::ChannelPtr keepalive) noexcept {
     (void)keepalive;
-    for (auto begin = this->tasks_.begin(), end = this->tasks_.end(); begin != end; ++begin) {
-        errno = err;
-        begin->cb(-1);
-    }
+    // the destructor must not complete these tasks again
+    this->DoCancel(err);
 }
 
 void sharpen::LinuxSignalFdChannel::SafeClose(sharpen::FileHandle handle) noexcept {
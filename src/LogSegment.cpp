@@ -0,0 +1,261 @@
+#include <sharpen/LogSegment.hpp>
+
+#include <sharpen/BufferOps.hpp>
+#include <sharpen/ByteOrder.hpp>
+#include <sharpen/CorruptedDataError.hpp>
+#include <sharpen/FileOps.hpp>
+#include <sharpen/IntOps.hpp>
+#include <sharpen/SystemError.hpp>
+#include <cassert>
+#include <cstring>
+#include <new>
+
+namespace sharpen {
+    template<typename _T>
+    inline static _T LoadRecordField(const char *data) noexcept {
+        _T val{0};
+        std::memcpy(&val, data, sizeof(val));
+#ifndef SHARPEN_IS_LIL_ENDIAN
+        sharpen::ConvertEndian(val);
+#endif
+        return val;
+    }
+
+    template<typename _T>
+    inline static void StoreRecordField(char *data, _T val) noexcept {
+#ifndef SHARPEN_IS_LIL_ENDIAN
+        sharpen::ConvertEndian(val);
+#endif
+        std::memcpy(data, &val, sizeof(val));
+    }
+}   // namespace sharpen
+
+sharpen::LogSegment::LogSegment(std::string name,
+                                sharpen::FileChannelPtr channel,
+                                std::uint64_t beginIndex,
+                                std::size_t capacity)
+    : name_(std::move(name))
+    , channel_(std::move(channel))
+    , memory_(nullptr)
+    , capacity_(capacity)
+    , size_(0)
+    , beginIndex_(beginIndex)
+    , count_(0)
+    , sparse_() {
+    assert(this->channel_);
+    assert(this->capacity_);
+    std::uint64_t fileSize{this->channel_->GetFileSize()};
+    if (fileSize > this->capacity_) {
+        this->capacity_ = sharpen::IntCast<std::size_t>(fileSize);
+    }
+    // map the whole capacity
+    // only the written part will be touched
+    sharpen::FileMemory *memory{
+        new (std::nothrow) sharpen::FileMemory{this->channel_->MapMemory(this->capacity_, 0)}};
+    if (!memory) {
+        throw std::bad_alloc{};
+    }
+    this->memory_.reset(memory);
+}
+
+const char *sharpen::LogSegment::Data() const noexcept {
+    return reinterpret_cast<const char *>(this->memory_->Get());
+}
+
+std::size_t sharpen::LogSegment::ComputeRecordSize(std::size_t entrySize) noexcept {
+    return headerSize_ + entrySize;
+}
+
+void sharpen::LogSegment::WriteRecord(char *buf,
+                                      std::uint8_t tag,
+                                      std::uint64_t index,
+                                      sharpen::ByteSlice entry) noexcept {
+    std::uint32_t bodySize{
+        static_cast<std::uint32_t>(headerSize_ - 2 * sizeof(std::uint32_t) + entry.GetSize())};
+    sharpen::StoreRecordField(buf + sizeof(std::uint32_t), bodySize);
+    buf[2 * sizeof(std::uint32_t)] = static_cast<char>(tag);
+    sharpen::StoreRecordField(buf + 2 * sizeof(std::uint32_t) + sizeof(tag), index);
+    if (!entry.Empty()) {
+        std::memcpy(buf + headerSize_, entry.Data(), entry.GetSize());
+    }
+    std::uint32_t crc{
+        sharpen::Crc32(buf + sizeof(std::uint32_t), sizeof(std::uint32_t) + bodySize)};
+    sharpen::StoreRecordField(buf, crc);
+}
+
+std::size_t sharpen::LogSegment::CheckRecord(std::uint64_t offset,
+                                             std::uint64_t limit,
+                                             bool verify) const noexcept {
+    assert(offset <= limit);
+    if (limit - offset < headerSize_) {
+        return 0;
+    }
+    const char *record{this->Data() + offset};
+    std::uint32_t bodySize{
+        sharpen::LoadRecordField<std::uint32_t>(record + sizeof(std::uint32_t))};
+    if (bodySize < headerSize_ - 2 * sizeof(std::uint32_t)) {
+        return 0;
+    }
+    std::uint64_t recordSize{2 * sizeof(std::uint32_t) + static_cast<std::uint64_t>(bodySize)};
+    if (recordSize > limit - offset) {
+        return 0;
+    }
+    std::uint8_t tag{static_cast<std::uint8_t>(record[2 * sizeof(std::uint32_t)])};
+    if (tag != entryTag_ && tag != dropTag_) {
+        return 0;
+    }
+    if (verify) {
+        std::uint32_t crc{sharpen::LoadRecordField<std::uint32_t>(record)};
+        if (crc != sharpen::Crc32(record + sizeof(std::uint32_t),
+                                  sizeof(std::uint32_t) + bodySize)) {
+            return 0;
+        }
+    }
+    return sharpen::IntCast<std::size_t>(recordSize);
+}
+
+void sharpen::LogSegment::IndexEntry(std::uint64_t offset) {
+    if (this->count_ % sparseInterval_ == 0) {
+        this->sparse_.emplace_back(offset);
+    }
+    this->count_ += 1;
+}
+
+std::uint64_t sharpen::LogSegment::GetOffset(std::uint64_t index) const noexcept {
+    assert(index >= this->beginIndex_ && index < this->GetEndIndex());
+    std::uint64_t pos{index - this->beginIndex_};
+    std::uint64_t offset{this->sparse_[sharpen::IntCast<std::size_t>(pos / sparseInterval_)]};
+    while (true) {
+        const char *record{this->Data() + offset};
+        std::uint32_t bodySize{
+            sharpen::LoadRecordField<std::uint32_t>(record + sizeof(std::uint32_t))};
+        std::uint8_t tag{static_cast<std::uint8_t>(record[2 * sizeof(std::uint32_t)])};
+        if (tag == entryTag_) {
+            std::uint64_t current{sharpen::LoadRecordField<std::uint64_t>(
+                record + 2 * sizeof(std::uint32_t) + sizeof(tag))};
+            if (current == index) {
+                return offset;
+            }
+        }
+        offset += 2 * sizeof(std::uint32_t) + bodySize;
+    }
+}
+
+bool sharpen::LogSegment::Load(bool verify, std::uint64_t &dropIndex) {
+    assert(this->channel_);
+    std::uint64_t fileSize{this->channel_->GetFileSize()};
+    std::uint64_t offset{0};
+    while (offset != fileSize) {
+        std::size_t recordSize{this->CheckRecord(offset, fileSize, verify)};
+        if (!recordSize) {
+            break;
+        }
+        const char *record{this->Data() + offset};
+        std::uint8_t tag{static_cast<std::uint8_t>(record[2 * sizeof(std::uint32_t)])};
+        std::uint64_t index{sharpen::LoadRecordField<std::uint64_t>(
+            record + 2 * sizeof(std::uint32_t) + sizeof(tag))};
+        if (tag == entryTag_) {
+            if (index != this->GetEndIndex()) {
+                break;
+            }
+            this->IndexEntry(offset);
+        } else if (index > dropIndex) {
+            dropIndex = index;
+        }
+        offset += recordSize;
+    }
+    this->size_ = offset;
+    if (offset != fileSize) {
+        this->channel_->Truncate(offset);
+        return false;
+    }
+    return true;
+}
+
+void sharpen::LogSegment::Append(const char *buf, std::size_t size) {
+    assert(this->channel_);
+    assert(this->Writable(size));
+    std::size_t sz{this->channel_->WriteFixedAsync(buf, size, this->size_)};
+    if (sz != size) {
+        this->channel_->Truncate(this->size_);
+        sharpen::ThrowSystemError(sharpen::ErrorIo);
+    }
+    std::uint64_t offset{0};
+    while (offset != size) {
+        const char *record{buf + offset};
+        std::uint32_t bodySize{
+            sharpen::LoadRecordField<std::uint32_t>(record + sizeof(std::uint32_t))};
+        std::uint8_t tag{static_cast<std::uint8_t>(record[2 * sizeof(std::uint32_t)])};
+        if (tag == entryTag_) {
+            assert(sharpen::LoadRecordField<std::uint64_t>(record + 2 * sizeof(std::uint32_t) +
+                                                           sizeof(tag)) == this->GetEndIndex());
+            this->IndexEntry(this->size_ + offset);
+        }
+        offset += 2 * sizeof(std::uint32_t) + bodySize;
+    }
+    this->size_ += size;
+}
+
+void sharpen::LogSegment::Flush() {
+    assert(this->channel_);
+    this->channel_->FlushAsync();
+}
+
+sharpen::Optional<sharpen::ByteBuffer> sharpen::LogSegment::Lookup(std::uint64_t index) const {
+    if (index < this->beginIndex_ || index >= this->GetEndIndex()) {
+        return sharpen::EmptyOpt;
+    }
+    std::uint64_t offset{this->GetOffset(index)};
+    std::size_t recordSize{this->CheckRecord(offset, this->size_, true)};
+    if (!recordSize) {
+        throw sharpen::CorruptedDataError("corrupted log entry");
+    }
+    return sharpen::ByteBuffer{this->Data() + offset + headerSize_, recordSize - headerSize_};
+}
+
+void sharpen::LogSegment::TruncateFrom(std::uint64_t index) {
+    assert(this->channel_);
+    if (index >= this->GetEndIndex()) {
+        return;
+    }
+    std::uint64_t offset{0};
+    if (index > this->beginIndex_) {
+        offset = this->GetOffset(index);
+    }
+    this->channel_->Truncate(offset);
+    this->size_ = offset;
+    this->count_ = index > this->beginIndex_ ? index - this->beginIndex_ : 0;
+    this->sparse_.resize(
+        sharpen::IntCast<std::size_t>((this->count_ + sparseInterval_ - 1) / sparseInterval_));
+}
+
+void sharpen::LogSegment::Unseal(sharpen::IEventLoopGroup &loopGroup) {
+    if (this->channel_) {
+        return;
+    }
+    sharpen::FileChannelPtr channel{sharpen::OpenFileChannel(
+        this->name_.c_str(), sharpen::FileAccessMethod::All, sharpen::FileOpenMethod::Open)};
+    channel->Register(loopGroup);
+    channel->EnableRegisteredIo();
+    this->channel_ = std::move(channel);
+}
+
+void sharpen::LogSegment::Seal() noexcept {
+    if (this->channel_) {
+        this->channel_->Close();
+        this->channel_.reset();
+    }
+}
+
+void sharpen::LogSegment::Remove() noexcept {
+    this->memory_.reset();
+    this->Seal();
+    this->count_ = 0;
+    this->size_ = 0;
+    this->sparse_.clear();
+    try {
+        sharpen::RemoveFile(this->name_.c_str());
+    } catch (const std::exception &ignore) {
+        (void)ignore;
+    }
+}
@@ -1,22 +1,33 @@
 #include <sharpen/MemoryStack.hpp>
 
+#include <sharpen/MemoryStackPool.hpp>
 #include <stdexcept>
 
 sharpen::MemoryStack::MemoryStack() noexcept
     : mem_(nullptr)
-    , size_(0) {
+    , size_(0)
+    , method_(sharpen::StackAllocMethod::Heap) {
 }
 
 sharpen::MemoryStack::MemoryStack(void *mem, std::size_t size) noexcept
+    : MemoryStack(mem, size, sharpen::StackAllocMethod::Heap) {
+}
+
+sharpen::MemoryStack::MemoryStack(void *mem,
+                                  std::size_t size,
+                                  sharpen::StackAllocMethod method) noexcept
     : mem_(mem)
-    , size_(size) {
+    , size_(size)
+    , method_(method) {
 }
 
 sharpen::MemoryStack::MemoryStack(sharpen::MemoryStack &&other) noexcept
     : mem_(nullptr)
-    , size_(0) {
+    , size_(0)
+    , method_(sharpen::StackAllocMethod::Heap) {
     std::swap(other.mem_, this->mem_);
     std::swap(other.size_, this->size_);
+    std::swap(other.method_, this->method_);
 }
 
 sharpen::MemoryStack::~MemoryStack() noexcept {
@@ -28,13 +39,18 @@ sharpen::MemoryStack &sharpen::MemoryStack::operator=(sharpen::MemoryStack &&oth
         this->Release();
         std::swap(other.mem_, this->mem_);
         std::swap(other.size_, this->size_);
+        std::swap(other.method_, this->method_);
     }
     return *this;
 }
 
 void sharpen::MemoryStack::Release() noexcept {
     if (this->mem_) {
-        this->Free(this->mem_);
+        if (this->method_ == sharpen::StackAllocMethod::Pooled) {
+            sharpen::MemoryStackPool::FreeToLocalPool(this->mem_, this->size_);
+        } else {
+            this->Free(this->mem_);
+        }
         this->mem_ = nullptr;
         this->size_ = 0;
     }
@@ -50,9 +66,23 @@ void *sharpen::MemoryStack::Top() const noexcept {
 }
 
 sharpen::MemoryStack sharpen::MemoryStack::AllocStack(std::size_t size) {
+    return Self::AllocStack(size, sharpen::StackAllocMethod::Heap);
+}
+
+sharpen::MemoryStack sharpen::MemoryStack::AllocStack(std::size_t size,
+                                                      sharpen::StackAllocMethod method) {
     if (size == 0) {
         return std::move(sharpen::MemoryStack());
     }
+    if (method == sharpen::StackAllocMethod::Pooled) {
+        size = sharpen::MemoryStackPool::RoundStackSize(size);
+        void *mem = sharpen::MemoryStackPool::AllocFromLocalPool(size);
+        if (!mem) {
+            throw std::bad_alloc();
+        }
+        sharpen::MemoryStack stack(mem, size, method);
+        return stack;
+    }
     void *mem = Self::Alloc(size);
     if (!mem) {
         throw std::bad_alloc();
@@ -71,6 +101,7 @@ void sharpen::MemoryStack::Extend(std::size_t newSize) {
         this->Release();
         this->size_ = newSize;
         this->mem_ = mem;
+        this->method_ = sharpen::StackAllocMethod::Heap;
     }
 }
 
@@ -83,5 +114,6 @@ void sharpen::MemoryStack::ExtendNoSave(std::size_t newSize) {
         this->Release();
         this->size_ = newSize;
         this->mem_ = mem;
+        this->method_ = sharpen::StackAllocMethod::Heap;
     }
-}
\ No newline at end of file
+}
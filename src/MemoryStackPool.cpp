@@ -0,0 +1,181 @@
+#include <sharpen/MemoryStackPool.hpp>
+
+#include <sharpen/SystemMacro.hpp>
+#include <cassert>
+
+#ifdef SHARPEN_IS_WIN
+#include <Windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+thread_local sharpen::MemoryStackPool::PoolState sharpen::MemoryStackPool::state_{
+    sharpen::MemoryStackPool::PoolState::Uninitialized};
+
+sharpen::MemoryStackPool::MemoryStackPool()
+    : freeLists_() {
+    // reserve free lists
+    // Free() never allocates memory
+    for (std::size_t i = 0; i != classCount_; ++i) {
+        this->freeLists_[i].reserve(Self::GetMaxCachedStacks(i));
+    }
+    state_ = PoolState::Alive;
+}
+
+sharpen::MemoryStackPool::~MemoryStackPool() noexcept {
+    this->Clear();
+    state_ = PoolState::Destroyed;
+}
+
+std::size_t sharpen::MemoryStackPool::GetClassSize(std::size_t index) noexcept {
+    assert(index < classCount_);
+    return (minClassPages_ * pageSize_) << index;
+}
+
+std::size_t sharpen::MemoryStackPool::GetMaxCachedStacks(std::size_t index) noexcept {
+    std::size_t count{maxCachedBytes_ / Self::GetClassSize(index)};
+    if (count < minCachedStacks_) {
+        count = minCachedStacks_;
+    }
+    return count;
+}
+
+std::size_t sharpen::MemoryStackPool::GetClassIndex(std::size_t size) noexcept {
+    for (std::size_t i = 0; i != classCount_; ++i) {
+        if (size == Self::GetClassSize(i)) {
+            return i;
+        }
+    }
+    return classCount_;
+}
+
+std::size_t sharpen::MemoryStackPool::RoundStackSize(std::size_t size) noexcept {
+    for (std::size_t i = 0; i != classCount_; ++i) {
+        std::size_t classSize{Self::GetClassSize(i)};
+        if (size <= classSize) {
+            return classSize;
+        }
+    }
+    // too large to be cached
+    // round up to page size
+    std::size_t over{size % pageSize_};
+    if (over) {
+        size += pageSize_ - over;
+    }
+    return size;
+}
+
+void *sharpen::MemoryStackPool::MapStack(std::size_t size) noexcept {
+    assert(size % pageSize_ == 0);
+    std::size_t mapSize{size + pageSize_};
+#ifdef SHARPEN_IS_WIN
+    void *mem{::VirtualAlloc(nullptr, mapSize, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE)};
+    if (!mem) {
+        return nullptr;
+    }
+    DWORD oldProtect{0};
+    if (!::VirtualProtect(mem, pageSize_, PAGE_NOACCESS, &oldProtect)) {
+        ::VirtualFree(mem, 0, MEM_RELEASE);
+        return nullptr;
+    }
+#else
+    // MAP_NORESERVE
+    // pages are committed when the fiber touches them
+    void *mem{::mmap(nullptr,
+                     mapSize,
+                     PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE,
+                     -1,
+                     0)};
+    if (mem == MAP_FAILED) {
+        return nullptr;
+    }
+    // guard page
+    if (::mprotect(mem, pageSize_, PROT_NONE) == -1) {
+        ::munmap(mem, mapSize);
+        return nullptr;
+    }
+#endif
+    std::uintptr_t p{reinterpret_cast<std::uintptr_t>(mem)};
+    p += pageSize_;
+    return reinterpret_cast<void *>(p);
+}
+
+void sharpen::MemoryStackPool::UnmapStack(void *mem, std::size_t size) noexcept {
+    assert(mem != nullptr);
+    std::uintptr_t p{reinterpret_cast<std::uintptr_t>(mem)};
+    p -= pageSize_;
+#ifdef SHARPEN_IS_WIN
+    (void)size;
+    ::VirtualFree(reinterpret_cast<void *>(p), 0, MEM_RELEASE);
+#else
+    ::munmap(reinterpret_cast<void *>(p), size + pageSize_);
+#endif
+}
+
+void *sharpen::MemoryStackPool::Alloc(std::size_t size) noexcept {
+    assert(Self::RoundStackSize(size) == size);
+    std::size_t index{Self::GetClassIndex(size)};
+    if (index != classCount_ && !this->freeLists_[index].empty()) {
+        void *mem{this->freeLists_[index].back()};
+        this->freeLists_[index].pop_back();
+        return mem;
+    }
+    return Self::MapStack(size);
+}
+
+void sharpen::MemoryStackPool::Free(void *mem, std::size_t size) noexcept {
+    if (!mem) {
+        return;
+    }
+    std::size_t index{Self::GetClassIndex(size)};
+    if (index != classCount_ && this->freeLists_[index].size() < Self::GetMaxCachedStacks(index)) {
+        this->freeLists_[index].push_back(mem);
+        return;
+    }
+    Self::UnmapStack(mem, size);
+}
+
+void sharpen::MemoryStackPool::Clear() noexcept {
+    for (std::size_t i = 0; i != classCount_; ++i) {
+        std::size_t size{Self::GetClassSize(i)};
+        for (auto begin = this->freeLists_[i].begin(), end = this->freeLists_[i].end();
+             begin != end;
+             ++begin) {
+            Self::UnmapStack(*begin, size);
+        }
+        this->freeLists_[i].clear();
+    }
+}
+
+std::size_t sharpen::MemoryStackPool::GetCachedCount() const noexcept {
+    std::size_t count{0};
+    for (std::size_t i = 0; i != classCount_; ++i) {
+        count += this->freeLists_[i].size();
+    }
+    return count;
+}
+
+sharpen::MemoryStackPool &sharpen::MemoryStackPool::GetLocalPool() {
+    thread_local Self pool;
+    return pool;
+}
+
+void *sharpen::MemoryStackPool::AllocFromLocalPool(std::size_t size) {
+    if (state_ == PoolState::Destroyed) {
+        return Self::MapStack(size);
+    }
+    return Self::GetLocalPool().Alloc(size);
+}
+
+void sharpen::MemoryStackPool::FreeToLocalPool(void *mem, std::size_t size) noexcept {
+    // the pool of current thread has not been created
+    // or has been destroyed when the thread exits
+    if (state_ != PoolState::Alive) {
+        if (mem) {
+            Self::UnmapStack(mem, size);
+        }
+        return;
+    }
+    Self::GetLocalPool().Free(mem, size);
+}
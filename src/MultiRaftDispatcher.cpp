@@ -0,0 +1,235 @@
+#include <sharpen/MultiRaftDispatcher.hpp>
+
+#include <sharpen/MultiRaftMailBuilder.hpp>
+#include <sharpen/MultiRaftMailExtractor.hpp>
+#include <sharpen/SingleWorkerGroup.hpp>
+#include <cassert>
+#include <new>
+
+sharpen::MultiRaftDispatcher::MultiRaftDispatcher(std::uint32_t magic)
+    : Self{sharpen::GetLocalScheduler(),
+           magic,
+           sharpen::GetLocalScheduler().GetParallelCount()} {
+}
+
+sharpen::MultiRaftDispatcher::MultiRaftDispatcher(sharpen::IFiberScheduler &scheduler,
+                                                  std::uint32_t magic,
+                                                  std::size_t shardCount)
+    : magic_(magic)
+    , groups_()
+    , shards_() {
+    if (!shardCount) {
+        shardCount = 1;
+    }
+    this->shards_.reserve(shardCount);
+    for (std::size_t i = 0; i != shardCount; ++i) {
+        sharpen::IWorkerGroup *shard{new (std::nothrow) sharpen::SingleWorkerGroup{scheduler}};
+        if (!shard) {
+            throw std::bad_alloc{};
+        }
+        this->shards_.emplace_back(shard);
+    }
+}
+
+void sharpen::MultiRaftDispatcher::Register(std::uint32_t raftNumber,
+                                            std::shared_ptr<sharpen::IConsensus> raft) {
+    assert(raft);
+    this->groups_[raftNumber] = std::move(raft);
+}
+
+void sharpen::MultiRaftDispatcher::Remove(std::uint32_t raftNumber) noexcept {
+    this->groups_.erase(raftNumber);
+}
+
+sharpen::IConsensus *sharpen::MultiRaftDispatcher::Lookup(
+    std::uint32_t raftNumber) const noexcept {
+    auto ite = this->groups_.find(raftNumber);
+    if (ite != this->groups_.end()) {
+        return ite->second.get();
+    }
+    return nullptr;
+}
+
+sharpen::Mail sharpen::MultiRaftDispatcher::DoGenerateResponse(sharpen::Mail request) {
+    sharpen::Optional<std::uint32_t> raftNumber{
+        sharpen::MultiRaftMailExtractor::LookupRaftNumber(this->magic_, request)};
+    if (!raftNumber.Exist()) {
+        return sharpen::Mail{};
+    }
+    sharpen::IConsensus *raft{this->Lookup(raftNumber.Get())};
+    if (!raft) {
+        return sharpen::Mail{};
+    }
+    return raft->GenerateResponse(std::move(request));
+}
+
+sharpen::Mail sharpen::MultiRaftDispatcher::GenerateResponse(sharpen::Mail request) {
+    if (request.Empty()) {
+        return sharpen::Mail{};
+    }
+    if (!sharpen::MultiRaftMailExtractor::IsBatchMail(
+            this->magic_, sharpen::RaftMailType::BatchRequest, request)) {
+        return this->DoGenerateResponse(std::move(request));
+    }
+    sharpen::Optional<std::vector<sharpen::Mail>> requests{
+        sharpen::MultiRaftMailExtractor::ExtractBatch(
+            this->magic_, sharpen::RaftMailType::BatchRequest, request)};
+    if (!requests.Exist()) {
+        return sharpen::Mail{};
+    }
+    std::vector<sharpen::Mail> &mails{requests.Get()};
+    // answer in place, unknown groups get empty responses
+    for (auto begin = mails.begin(), end = mails.end(); begin != end; ++begin) {
+        *begin = this->DoGenerateResponse(std::move(*begin));
+    }
+    std::vector<const sharpen::Mail *> responses;
+    responses.reserve(mails.size());
+    for (auto begin = mails.begin(), end = mails.end(); begin != end; ++begin) {
+        responses.emplace_back(&*begin);
+    }
+    std::uint32_t sequence{sharpen::MultiRaftMailExtractor::LookupBatchSequence(
+                               this->magic_, sharpen::RaftMailType::BatchRequest, request)
+                               .Get()};
+    return sharpen::MultiRaftMailBuilder::BuildBatch(this->magic_,
+                                                     sharpen::RaftMailType::BatchResponse,
+                                                     sequence,
+                                                     responses.data(),
+                                                     responses.size());
+}
+
+sharpen::IWorkerGroup &sharpen::MultiRaftDispatcher::GetShard(std::uint32_t raftNumber) noexcept {
+    assert(!this->shards_.empty());
+    return *this->shards_[raftNumber % this->shards_.size()];
+}
+
+sharpen::Mail sharpen::MultiRaftDispatcher::DoRespond(std::uint32_t raftNumber,
+                                                      sharpen::Mail request) {
+    sharpen::IConsensus *raft{this->Lookup(raftNumber)};
+    if (!raft) {
+        return sharpen::Mail{};
+    }
+    return raft->GenerateResponse(std::move(request));
+}
+
+void sharpen::MultiRaftDispatcher::DoDispatch(std::uint32_t raftNumber,
+                                              sharpen::Mail request,
+                                              Callback cb) noexcept {
+    sharpen::Mail response;
+    try {
+        response = this->DoRespond(raftNumber, std::move(request));
+    } catch (const std::exception &error) {
+        assert(!error.what() && "fail to generate response");
+        (void)error;
+    }
+    if (response.Empty()) {
+        try {
+            response = sharpen::MultiRaftMailBuilder::BuildPlaceholder(this->magic_, raftNumber);
+        } catch (const std::bad_alloc &fault) {
+            (void)fault;
+            std::terminate();
+        }
+    }
+    cb(std::move(response));
+}
+
+void sharpen::MultiRaftDispatcher::CompleteBatch(BatchState &state, std::size_t count) noexcept {
+    if (state.remain_.fetch_sub(count, std::memory_order::memory_order_acq_rel) != count) {
+        return;
+    }
+    // every request of the batch has been answered
+    std::vector<const sharpen::Mail *> responses;
+    sharpen::Mail response;
+    try {
+        responses.reserve(state.mails_.size());
+        for (auto begin = state.mails_.begin(), end = state.mails_.end(); begin != end; ++begin) {
+            responses.emplace_back(&*begin);
+        }
+        response = sharpen::MultiRaftMailBuilder::BuildBatch(this->magic_,
+                                                             sharpen::RaftMailType::BatchResponse,
+                                                             state.sequence_,
+                                                             responses.data(),
+                                                             responses.size());
+    } catch (const std::bad_alloc &fault) {
+        (void)fault;
+        std::terminate();
+    }
+    state.cb_(std::move(response));
+}
+
+void sharpen::MultiRaftDispatcher::DoDispatchBatch(std::shared_ptr<BatchState> state,
+                                                   std::size_t index,
+                                                   std::uint32_t raftNumber) noexcept {
+    assert(state);
+    sharpen::Mail &mail{state->mails_[index]};
+    try {
+        mail = this->DoRespond(raftNumber, std::move(mail));
+    } catch (const std::exception &error) {
+        assert(!error.what() && "fail to generate response");
+        (void)error;
+        mail = sharpen::Mail{};
+    }
+    this->CompleteBatch(*state, 1);
+}
+
+bool sharpen::MultiRaftDispatcher::DispatchBatch(sharpen::Mail request, Callback cb) {
+    sharpen::Optional<std::vector<sharpen::Mail>> requests{
+        sharpen::MultiRaftMailExtractor::ExtractBatch(
+            this->magic_, sharpen::RaftMailType::BatchRequest, request)};
+    if (!requests.Exist()) {
+        return false;
+    }
+    std::shared_ptr<BatchState> state{std::make_shared<BatchState>()};
+    state->sequence_ = sharpen::MultiRaftMailExtractor::LookupBatchSequence(
+                           this->magic_, sharpen::RaftMailType::BatchRequest, request)
+                           .Get();
+    state->mails_ = std::move(requests.Get());
+    state->cb_ = std::move(cb);
+    std::size_t count{state->mails_.size()};
+    // hold the batch until every request has been submitted
+    state->remain_.store(count + 1, std::memory_order::memory_order_relaxed);
+    std::size_t index{0};
+    try {
+        for (; index != count; ++index) {
+            sharpen::Mail &mail{state->mails_[index]};
+            sharpen::Optional<std::uint32_t> raftNumber{
+                sharpen::MultiRaftMailExtractor::LookupRaftNumber(this->magic_, mail)};
+            if (!raftNumber.Exist()) {
+                // answered by an empty mail
+                mail = sharpen::Mail{};
+                state->remain_.fetch_sub(1, std::memory_order::memory_order_relaxed);
+                continue;
+            }
+            this->GetShard(raftNumber.Get())
+                .Submit(&Self::DoDispatchBatch, this, state, index, raftNumber.Get());
+        }
+    } catch (const std::exception &error) {
+        // requests that have not been submitted are answered by empty mails
+        (void)error;
+        for (std::size_t i = index; i != count; ++i) {
+            state->mails_[i] = sharpen::Mail{};
+        }
+        this->CompleteBatch(*state, count - index + 1);
+        return true;
+    }
+    this->CompleteBatch(*state, 1);
+    return true;
+}
+
+bool sharpen::MultiRaftDispatcher::GenerateResponseAsync(sharpen::Mail request, Callback cb) {
+    assert(cb);
+    if (request.Empty()) {
+        return false;
+    }
+    if (sharpen::MultiRaftMailExtractor::IsBatchMail(
+            this->magic_, sharpen::RaftMailType::BatchRequest, request)) {
+        return this->DispatchBatch(std::move(request), std::move(cb));
+    }
+    sharpen::Optional<std::uint32_t> raftNumber{
+        sharpen::MultiRaftMailExtractor::LookupRaftNumber(this->magic_, request)};
+    if (!raftNumber.Exist()) {
+        return false;
+    }
+    this->GetShard(raftNumber.Get())
+        .Submit(&Self::DoDispatch, this, raftNumber.Get(), std::move(request), std::move(cb));
+    return true;
+}
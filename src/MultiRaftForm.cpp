@@ -3,6 +3,9 @@
 #include <sharpen/ByteOrder.hpp>
 #include <cstring>
 
+// member functions take the address of the magic
+constexpr sharpen::ByteSlice sharpen::MultiRaftForm::multiRaftMagic;
+
 sharpen::MultiRaftForm::MultiRaftForm() noexcept
     : Self{sharpen::RaftMailType::Unknown} {
 }
@@ -2,6 +2,8 @@
 
 #include <sharpen/BufferWriter.hpp>
 #include <sharpen/GenericMail.hpp>
+#include <sharpen/IntOps.hpp>
+#include <cstring>
 
 sharpen::MultiRaftMailBuilder::MultiRaftMailBuilder(std::uint32_t magic,
                                                     std::uint32_t raftNumber) noexcept
@@ -115,4 +117,92 @@ sharpen::Mail sharpen::MultiRaftMailBuilder::BuildSnapshotResponse(
     sharpen::BufferWriter writer{content};
     writer.Write(response);
     return this->BuildMail(sharpen::RaftMailType::InstallSnapshotResponse, std::move(content));
-}
\ No newline at end of file
+}
+
+sharpen::Mail sharpen::MultiRaftMailBuilder::BuildLearnLogsRequest(
+    const sharpen::RaftLearnLogsRequest &request) const {
+    std::uint32_t size{sharpen::IntCast<std::uint32_t>(request.ComputeSize())};
+    sharpen::ByteBuffer content{size};
+    sharpen::BufferWriter writer{content};
+    writer.Write(request);
+    return this->BuildMail(sharpen::RaftMailType::LearnLogsRequest, std::move(content));
+}
+
+sharpen::Mail sharpen::MultiRaftMailBuilder::BuildLearnLogsResponse(
+    const sharpen::RaftLearnLogsResponse &response) const {
+    std::uint32_t size{sharpen::IntCast<std::uint32_t>(response.ComputeSize())};
+    sharpen::ByteBuffer content{size};
+    sharpen::BufferWriter writer{content};
+    writer.Write(response);
+    return this->BuildMail(sharpen::RaftMailType::LearnLogsResponse, std::move(content));
+}
+
+sharpen::Mail sharpen::MultiRaftMailBuilder::BuildLearnSnapshotRequest(
+    const sharpen::RaftLearnSnapshotRequest &request) const {
+    std::uint32_t size{sharpen::IntCast<std::uint32_t>(request.ComputeSize())};
+    sharpen::ByteBuffer content{size};
+    sharpen::BufferWriter writer{content};
+    writer.Write(request);
+    return this->BuildMail(sharpen::RaftMailType::LearnSnapshotRequest, std::move(content));
+}
+
+sharpen::Mail sharpen::MultiRaftMailBuilder::BuildLearnSnapshotResponse(
+    const sharpen::RaftLearnSnapshotResponse &response) const {
+    std::uint32_t size{sharpen::IntCast<std::uint32_t>(response.ComputeSize())};
+    sharpen::ByteBuffer content{size};
+    sharpen::BufferWriter writer{content};
+    writer.Write(response);
+    return this->BuildMail(sharpen::RaftMailType::LearnSnapshotResponse, std::move(content));
+}
+
+sharpen::Mail sharpen::MultiRaftMailBuilder::BuildBatch(std::uint32_t magic,
+                                                        sharpen::RaftMailType type,
+                                                        std::uint32_t sequence,
+                                                        const sharpen::Mail *const *mails,
+                                                        std::size_t size) {
+    assert(type == sharpen::RaftMailType::BatchRequest ||
+           type == sharpen::RaftMailType::BatchResponse);
+    std::size_t contentSize{0};
+    for (std::size_t i = 0; i != size; ++i) {
+        assert(mails[i] != nullptr);
+        if (mails[i]->Empty()) {
+            contentSize += sizeof(sharpen::GenericMailHeader);
+        } else {
+            assert(mails[i]->Header().GetSize() == sizeof(sharpen::GenericMailHeader));
+            contentSize += mails[i]->Header().GetSize() + mails[i]->Content().GetSize();
+        }
+    }
+    sharpen::ByteBuffer content{contentSize};
+    std::size_t offset{0};
+    for (std::size_t i = 0; i != size; ++i) {
+        const sharpen::Mail &mail{*mails[i]};
+        if (mail.Empty()) {
+            sharpen::GenericMailHeader header{magic};
+            std::memcpy(content.Data() + offset, &header, sizeof(header));
+            offset += sizeof(header);
+            continue;
+        }
+        std::memcpy(content.Data() + offset, mail.Header().Data(), mail.Header().GetSize());
+        offset += mail.Header().GetSize();
+        if (!mail.Content().Empty()) {
+            std::memcpy(content.Data() + offset, mail.Content().Data(), mail.Content().GetSize());
+            offset += mail.Content().GetSize();
+        }
+    }
+    assert(offset == contentSize);
+    sharpen::MultiRaftForm form{type, sequence};
+    form.SetChecksum(content.GetSlice());
+    sharpen::GenericMail batch{magic};
+    batch.Form<sharpen::MultiRaftForm>() = form;
+    batch.SetContent(std::move(content));
+    return batch.ReleaseMail();
+}
+
+sharpen::Mail sharpen::MultiRaftMailBuilder::BuildPlaceholder(std::uint32_t magic,
+                                                              std::uint32_t raftNumber) {
+    sharpen::MultiRaftForm form{sharpen::RaftMailType::Unknown, raftNumber};
+    form.SetChecksum(sharpen::ByteSlice{});
+    sharpen::GenericMail mail{magic};
+    mail.Form<sharpen::MultiRaftForm>() = form;
+    return mail.ReleaseMail();
+}
@@ -22,7 +22,7 @@ bool sharpen::MultiRaftMailExtractor::NviIsRaftMail(const sharpen::Mail &mail) c
         if (header.GetMagic() == this->magic_) {
             const sharpen::MultiRaftForm &form{header.Form<sharpen::MultiRaftForm>()};
             return form.CheckMagic() && form.GetType() != sharpen::RaftMailType::Unknown &&
-                   form.GetRaftNumber() == this->raftNumber_;
+                   !Self::IsBatchType(form.GetType()) && form.GetRaftNumber() == this->raftNumber_;
         }
     }
     return false;
@@ -175,4 +175,164 @@ sharpen::MultiRaftMailExtractor::NviExtractSnapshotResponse(
         return sharpen::EmptyOpt;
     }
     return response;
-}
\ No newline at end of file
+}
+
+sharpen::Optional<sharpen::RaftLearnLogsRequest>
+sharpen::MultiRaftMailExtractor::NviExtractLearnLogsRequest(
+    const sharpen::Mail &mail) const noexcept {
+    if (!this->CheckMail(sharpen::RaftMailType::LearnLogsRequest, mail)) {
+        return sharpen::EmptyOpt;
+    }
+    sharpen::RaftLearnLogsRequest request;
+    try {
+        request.Unserialize().LoadFrom(mail.Content());
+    } catch (const sharpen::CorruptedDataError &error) {
+        (void)error;
+        return sharpen::EmptyOpt;
+    }
+    return request;
+}
+
+sharpen::Optional<sharpen::RaftLearnLogsResponse>
+sharpen::MultiRaftMailExtractor::NviExtractLearnLogsResponse(
+    const sharpen::Mail &mail) const noexcept {
+    if (!this->CheckMail(sharpen::RaftMailType::LearnLogsResponse, mail)) {
+        return sharpen::EmptyOpt;
+    }
+    sharpen::RaftLearnLogsResponse response;
+    try {
+        response.Unserialize().LoadFrom(mail.Content());
+    } catch (const sharpen::CorruptedDataError &error) {
+        (void)error;
+        return sharpen::EmptyOpt;
+    }
+    return response;
+}
+
+sharpen::Optional<sharpen::RaftLearnSnapshotRequest>
+sharpen::MultiRaftMailExtractor::NviExtractLearnSnapshotRequest(
+    const sharpen::Mail &mail) const noexcept {
+    if (!this->CheckMail(sharpen::RaftMailType::LearnSnapshotRequest, mail)) {
+        return sharpen::EmptyOpt;
+    }
+    sharpen::RaftLearnSnapshotRequest request;
+    try {
+        request.Unserialize().LoadFrom(mail.Content());
+    } catch (const sharpen::CorruptedDataError &error) {
+        (void)error;
+        return sharpen::EmptyOpt;
+    }
+    return request;
+}
+
+sharpen::Optional<sharpen::RaftLearnSnapshotResponse>
+sharpen::MultiRaftMailExtractor::NviExtractLearnSnapshotResponse(
+    const sharpen::Mail &mail) const noexcept {
+    if (!this->CheckMail(sharpen::RaftMailType::LearnSnapshotResponse, mail)) {
+        return sharpen::EmptyOpt;
+    }
+    sharpen::RaftLearnSnapshotResponse response;
+    try {
+        response.Unserialize().LoadFrom(mail.Content());
+    } catch (const sharpen::CorruptedDataError &error) {
+        (void)error;
+        return sharpen::EmptyOpt;
+    }
+    return response;
+}
+
+sharpen::Optional<std::uint32_t> sharpen::MultiRaftMailExtractor::LookupRaftNumber(
+    std::uint32_t magic, const sharpen::Mail &mail) noexcept {
+    if (mail.Header().GetSize() == sizeof(sharpen::GenericMailHeader)) {
+        const sharpen::GenericMailHeader &header{mail.Header().As<sharpen::GenericMailHeader>()};
+        if (header.GetMagic() == magic) {
+            const sharpen::MultiRaftForm &form{header.Form<sharpen::MultiRaftForm>()};
+            if (form.CheckMagic() && form.GetType() != sharpen::RaftMailType::Unknown &&
+                !Self::IsBatchType(form.GetType())) {
+                return form.GetRaftNumber();
+            }
+        }
+    }
+    return sharpen::EmptyOpt;
+}
+
+sharpen::Optional<std::uint32_t> sharpen::MultiRaftMailExtractor::LookupPlaceholder(
+    std::uint32_t magic, const sharpen::Mail &mail) noexcept {
+    if (mail.Header().GetSize() == sizeof(sharpen::GenericMailHeader) && mail.Content().Empty()) {
+        const sharpen::GenericMailHeader &header{mail.Header().As<sharpen::GenericMailHeader>()};
+        if (header.GetMagic() == magic) {
+            const sharpen::MultiRaftForm &form{header.Form<sharpen::MultiRaftForm>()};
+            if (form.CheckMagic() && form.GetType() == sharpen::RaftMailType::Unknown) {
+                return form.GetRaftNumber();
+            }
+        }
+    }
+    return sharpen::EmptyOpt;
+}
+
+bool sharpen::MultiRaftMailExtractor::IsBatchMail(std::uint32_t magic,
+                                                  sharpen::RaftMailType type,
+                                                  const sharpen::Mail &mail) noexcept {
+    assert(Self::IsBatchType(type));
+    if (mail.Header().GetSize() == sizeof(sharpen::GenericMailHeader)) {
+        const sharpen::GenericMailHeader &header{mail.Header().As<sharpen::GenericMailHeader>()};
+        if (header.GetMagic() == magic) {
+            const sharpen::MultiRaftForm &form{header.Form<sharpen::MultiRaftForm>()};
+            return form.CheckMagic() && form.GetType() == type;
+        }
+    }
+    return false;
+}
+
+sharpen::Optional<std::uint32_t> sharpen::MultiRaftMailExtractor::LookupBatchSequence(
+    std::uint32_t magic, sharpen::RaftMailType type, const sharpen::Mail &mail) noexcept {
+    if (!Self::IsBatchMail(magic, type, mail)) {
+        return sharpen::EmptyOpt;
+    }
+    const sharpen::GenericMailHeader &header{mail.Header().As<sharpen::GenericMailHeader>()};
+    return header.Form<sharpen::MultiRaftForm>().GetRaftNumber();
+}
+
+sharpen::Optional<std::vector<sharpen::Mail>> sharpen::MultiRaftMailExtractor::ExtractBatch(
+    std::uint32_t magic, sharpen::RaftMailType type, const sharpen::Mail &mail) {
+    if (!Self::IsBatchMail(magic, type, mail)) {
+        return sharpen::EmptyOpt;
+    }
+    const sharpen::GenericMailHeader &batchHeader{
+        mail.Header().As<sharpen::GenericMailHeader>()};
+    const sharpen::MultiRaftForm &batchForm{batchHeader.Form<sharpen::MultiRaftForm>()};
+    const sharpen::ByteBuffer &content{mail.Content()};
+    if (!batchForm.CheckContent(content.GetSlice())) {
+        return sharpen::EmptyOpt;
+    }
+    std::vector<sharpen::Mail> mails;
+    std::size_t offset{0};
+    while (offset != content.GetSize()) {
+        if (content.GetSize() - offset < sizeof(sharpen::GenericMailHeader)) {
+            return sharpen::EmptyOpt;
+        }
+        // copy the header out of the content, it may be unaligned
+        sharpen::ByteBuffer mailHeader{content.Data() + offset,
+                                       sizeof(sharpen::GenericMailHeader)};
+        offset += mailHeader.GetSize();
+        const sharpen::GenericMailHeader &header{mailHeader.As<sharpen::GenericMailHeader>()};
+        std::size_t size{header.GetContentSize()};
+        if (content.GetSize() - offset < size) {
+            return sharpen::EmptyOpt;
+        }
+        const sharpen::MultiRaftForm &form{header.Form<sharpen::MultiRaftForm>()};
+        if (header.GetMagic() != magic || !form.CheckMagic()) {
+            // placeholder of empty mail
+            mails.emplace_back();
+            offset += size;
+            continue;
+        }
+        sharpen::ByteBuffer mailContent;
+        if (size) {
+            mailContent = sharpen::ByteBuffer{content.Data() + offset, size};
+        }
+        offset += size;
+        mails.emplace_back(std::move(mailHeader), std::move(mailContent));
+    }
+    return mails;
+}
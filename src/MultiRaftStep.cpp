@@ -0,0 +1,139 @@
+#include <sharpen/MultiRaftStep.hpp>
+
+#include <sharpen/EventLoop.hpp>
+#include <sharpen/GenericMailParserFactory.hpp>
+#include <cassert>
+#include <limits>
+#include <mutex>
+#include <new>
+
+sharpen::MultiRaftStep::ChannelState::ChannelState(sharpen::INetStreamChannel &channel,
+                                                   std::size_t windowSize)
+    : channel_(&channel)
+    , writeLock_()
+    , window_(windowSize)
+    , broken_(false) {
+}
+
+sharpen::MultiRaftStep::MultiRaftStep(
+    std::shared_ptr<sharpen::MultiRaftDispatcher> dispatcher) noexcept
+    : Self{std::move(dispatcher), Self::defaultWindowSize_} {
+}
+
+sharpen::MultiRaftStep::MultiRaftStep(std::shared_ptr<sharpen::MultiRaftDispatcher> dispatcher,
+                                      std::size_t windowSize) noexcept
+    : factory_(nullptr)
+    , dispatcher_(std::move(dispatcher))
+    , windowSize_(windowSize) {
+    assert(this->dispatcher_);
+    assert(this->windowSize_ != 0);
+    this->factory_.reset(new (std::nothrow) sharpen::GenericMailParserFactory{
+        this->dispatcher_->GetMagic(), (std::numeric_limits<std::uint32_t>::max)()});
+    if (!this->factory_) {
+        std::terminate();
+    }
+}
+
+std::size_t sharpen::MultiRaftStep::DoRead(sharpen::INetStreamChannel &channel,
+                                           sharpen::IMailParser &parser,
+                                           sharpen::ByteBuffer &buffer) noexcept {
+    try {
+        std::size_t directSize{0};
+        char *direct{parser.GetDirectBuffer(directSize)};
+        // read large content into the mail directly
+        if (direct && directSize >= buffer.GetSize()) {
+            std::size_t size{channel.ReadAsync(direct, directSize)};
+            parser.CommitDirectBuffer(size);
+            return size;
+        }
+        std::size_t size{channel.ReadAsync(buffer)};
+        parser.Parse(buffer.GetSlice(0, size));
+        return size;
+    } catch (const std::exception &error) {
+        // the connection was aborted or the mail is corrupted
+        (void)error;
+        return 0;
+    }
+}
+
+void sharpen::MultiRaftStep::WriteResponse(ChannelState *state, sharpen::Mail response) noexcept {
+    assert(state != nullptr);
+    if (!state->broken_.load(std::memory_order::memory_order_acquire)) {
+        // write header and content by one syscall
+        sharpen::ByteSlice slices[2]{response.Header().GetSlice(), response.Content().GetSlice()};
+        std::size_t count{response.Content().Empty() ? 1u : 2u};
+        std::size_t size{0};
+        {
+            std::unique_lock<sharpen::AsyncMutex> lock{state->writeLock_};
+            try {
+                size = state->channel_->WriteVectorFixedAsync(slices, count);
+            } catch (const std::exception &error) {
+                (void)error;
+                size = 0;
+            }
+        }
+        if (size != response.Header().GetSize() + response.Content().GetSize() &&
+            !state->broken_.exchange(true)) {
+            // stop reading requests
+            state->channel_->Close();
+        }
+    }
+    state->window_.Unlock();
+}
+
+bool sharpen::MultiRaftStep::Dispatch(ChannelState &state, sharpen::IMailParser &parser) noexcept {
+    while (parser.Completed()) {
+        sharpen::Mail request{parser.PopCompletedMail()};
+        state.window_.LockAsync();
+        if (state.broken_.load(std::memory_order::memory_order_acquire)) {
+            state.window_.Unlock();
+            return false;
+        }
+        bool dispatched{false};
+        try {
+            dispatched = this->dispatcher_->GenerateResponseAsync(
+                std::move(request), std::bind(&Self::WriteResponse, &state, std::placeholders::_1));
+        } catch (const std::exception &error) {
+            (void)error;
+            dispatched = false;
+        }
+        if (!dispatched) {
+            // a response could not be correlated with this request
+            state.window_.Unlock();
+            return false;
+        }
+    }
+    return true;
+}
+
+sharpen::HostPipelineResult sharpen::MultiRaftStep::Consume(
+    sharpen::INetStreamChannel &channel, const std::atomic_bool &active) noexcept {
+    std::unique_ptr<sharpen::IMailParser> parser{this->factory_->Produce()};
+    channel.SetKeepAlive(true);
+    ChannelState state{channel, this->windowSize_};
+    sharpen::ByteBuffer buffer;
+    sharpen::EventLoop *loop{sharpen::EventLoop::GetLocalLoop()};
+    if (loop) {
+        buffer = loop->AcquireReceiveBuffer();
+    } else {
+        buffer = sharpen::ByteBuffer{sharpen::EventLoop::receiveBufferSize};
+    }
+    std::size_t size{Self::DoRead(channel, *parser, buffer)};
+    while (size != 0 && active) {
+        if (!this->Dispatch(state, *parser)) {
+            break;
+        }
+        size = Self::DoRead(channel, *parser, buffer);
+    }
+    // wait for in-flight requests
+    // their callbacks refer to the state
+    for (std::size_t i = 0; i != this->windowSize_; ++i) {
+        state.window_.LockAsync();
+    }
+    // the fiber may be resumed by another loop
+    loop = sharpen::EventLoop::GetLocalLoop();
+    if (loop) {
+        loop->ReleaseReceiveBuffer(std::move(buffer));
+    }
+    return sharpen::HostPipelineResult::Broken;
+}
\ No newline at end of file
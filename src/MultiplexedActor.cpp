@@ -0,0 +1,140 @@
+#include <sharpen/MultiplexedActor.hpp>
+
+#include <sharpen/AwaitableFuture.hpp>
+#include <mutex>
+
+sharpen::MultiplexedActor::MultiplexedActor(sharpen::IMailReceiver &receiver,
+                                            std::shared_ptr<sharpen::TcpMultiplexer> multiplexer)
+    : postCount_(0)
+    , state_(std::make_shared<State>())
+    , multiplexer_(std::move(multiplexer)) {
+    assert(this->multiplexer_);
+    this->state_->receiver_ = &receiver;
+    this->state_->id_ = this->multiplexer_->GetId();
+    this->state_->ackCount_ = 0;
+    this->state_->generation_ = 0;
+    this->state_->receiving_ = 0;
+    this->state_->detached_ = nullptr;
+}
+
+sharpen::MultiplexedActor::~MultiplexedActor() noexcept {
+    // late callbacks find the receiver detached
+    // wait for the callbacks which are calling the receiver
+    sharpen::AwaitableFuture<void> future;
+    bool receiving{false};
+    {
+        std::unique_lock<sharpen::SpinLock> lock{this->state_->lock_};
+        this->state_->receiver_ = nullptr;
+        if (this->state_->receiving_) {
+            this->state_->detached_ = &future;
+            receiving = true;
+        }
+    }
+    if (receiving) {
+        future.Await();
+    }
+}
+
+void sharpen::MultiplexedActor::DoReceive(const std::shared_ptr<State> &state,
+                                          std::size_t generation,
+                                          sharpen::Mail response) noexcept {
+    assert(state);
+    sharpen::IMailReceiver *receiver{nullptr};
+    {
+        std::unique_lock<sharpen::SpinLock> lock{state->lock_};
+        // the actor has been destroyed
+        if (!state->receiver_) {
+            return;
+        }
+        receiver = state->receiver_;
+        state->receiving_ += 1;
+    }
+    // the responses of detached mails are still useful to receiver
+    if (!response.Empty()) {
+        receiver->Receive(std::move(response), state->id_);
+    }
+    sharpen::Future<void> *detached{nullptr};
+    {
+        std::unique_lock<sharpen::SpinLock> lock{state->lock_};
+        // Cancel() has acked the mails of older generations
+        if (generation == state->generation_) {
+            state->ackCount_.fetch_add(1, std::memory_order::memory_order_acq_rel);
+        }
+        state->receiving_ -= 1;
+        if (!state->receiving_) {
+            std::swap(detached, state->detached_);
+        }
+    }
+    if (detached) {
+        detached->Complete();
+    }
+}
+
+void sharpen::MultiplexedActor::NviPost(sharpen::Mail mail) {
+    std::size_t generation{0};
+    {
+        // Cancel() must see the post and the generation together
+        std::unique_lock<sharpen::SpinLock> lock{this->state_->lock_};
+        generation = this->state_->generation_;
+        this->postCount_.fetch_add(1, std::memory_order::memory_order_acq_rel);
+    }
+    try {
+        std::function<void(sharpen::Mail)> cb{
+            std::bind(&Self::DoReceive, this->state_, generation, std::placeholders::_1)};
+        this->multiplexer_->Post(std::move(mail), std::move(cb));
+    } catch (const std::exception &) {
+        std::unique_lock<sharpen::SpinLock> lock{this->state_->lock_};
+        this->postCount_.fetch_sub(1, std::memory_order::memory_order_acq_rel);
+        // the mail has been acked by Cancel()
+        if (generation != this->state_->generation_) {
+            this->state_->ackCount_.fetch_sub(1, std::memory_order::memory_order_acq_rel);
+        }
+        throw;
+    }
+}
+
+void sharpen::MultiplexedActor::NviPostShared(const sharpen::Mail &mail) {
+    // the multiplexer may hold the mail after Cancel()
+    // but the owner reuses the shared mail once the pipeline is drained
+    this->NviPost(mail);
+}
+
+sharpen::RemoteActorStatus sharpen::MultiplexedActor::GetStatus() const noexcept {
+    if (this->GetPipelineCount()) {
+        return sharpen::RemoteActorStatus::InProgress;
+    }
+    if (this->multiplexer_->Available()) {
+        return sharpen::RemoteActorStatus::Opened;
+    }
+    return sharpen::RemoteActorStatus::Closed;
+}
+
+std::size_t sharpen::MultiplexedActor::GetPipelineCount() const noexcept {
+    std::size_t ackCount{this->state_->ackCount_.load(std::memory_order::memory_order_acquire)};
+    std::size_t postCount{this->postCount_.load(std::memory_order::memory_order_acquire)};
+    assert(postCount >= ackCount);
+    return postCount - ackCount;
+}
+
+void sharpen::MultiplexedActor::Cancel() noexcept {
+    std::unique_lock<sharpen::SpinLock> lock{this->state_->lock_};
+    std::size_t postCount{this->postCount_.load(std::memory_order::memory_order_acquire)};
+    // if pipeline is not empty
+    if (postCount != this->state_->ackCount_.load(std::memory_order::memory_order_acquire)) {
+        // late responses of in-flight mails are not acked
+        this->state_->generation_ += 1;
+        this->state_->ackCount_.store(postCount, std::memory_order::memory_order_release);
+    }
+}
+
+void sharpen::MultiplexedActor::Close() noexcept {
+    this->Cancel();
+}
+
+void sharpen::MultiplexedActor::Drain() noexcept {
+    this->Cancel();
+}
+
+bool sharpen::MultiplexedActor::SupportPipeline() const noexcept {
+    return this->multiplexer_->SupportPipeline();
+}
@@ -0,0 +1,56 @@
+#include <sharpen/MultiplexedActorBuilder.hpp>
+
+#include <sharpen/MultiplexedActor.hpp>
+#include <new>
+
+sharpen::MultiplexedActorBuilder::MultiplexedActorBuilder(
+    std::shared_ptr<sharpen::TcpMultiplexer> multiplexer) noexcept
+    : multiplexer_(std::move(multiplexer))
+    , receiver_(nullptr) {
+}
+
+sharpen::MultiplexedActorBuilder::MultiplexedActorBuilder(Self &&other) noexcept
+    : multiplexer_(std::move(other.multiplexer_))
+    , receiver_(other.receiver_) {
+    other.receiver_ = nullptr;
+}
+
+sharpen::MultiplexedActorBuilder &sharpen::MultiplexedActorBuilder::operator=(
+    Self &&other) noexcept {
+    if (this != std::addressof(other)) {
+        this->multiplexer_ = std::move(other.multiplexer_);
+        this->receiver_ = other.receiver_;
+        other.receiver_ = nullptr;
+    }
+    return *this;
+}
+
+void sharpen::MultiplexedActorBuilder::PrepareReceiver(sharpen::IMailReceiver &receiver) noexcept {
+    this->receiver_ = &receiver;
+}
+
+void sharpen::MultiplexedActorBuilder::EnsureConfiguration() const {
+    if (!this->multiplexer_) {
+        throw std::logic_error{"multiplexer could not be null"};
+    }
+    if (!this->receiver_) {
+        throw std::logic_error{"receiver could not be null"};
+    }
+}
+
+std::unique_ptr<sharpen::IRemoteActor> sharpen::MultiplexedActorBuilder::NviBuild() const {
+    this->EnsureConfiguration();
+    std::unique_ptr<sharpen::IRemoteActor> actor{
+        new (std::nothrow) sharpen::MultiplexedActor{*this->receiver_, this->multiplexer_}};
+    if (!actor) {
+        throw std::bad_alloc{};
+    }
+    return actor;
+}
+
+std::shared_ptr<sharpen::IRemoteActor> sharpen::MultiplexedActorBuilder::NviBuildShared() const {
+    this->EnsureConfiguration();
+    std::shared_ptr<sharpen::IRemoteActor> actor{
+        std::make_shared<sharpen::MultiplexedActor>(*this->receiver_, this->multiplexer_)};
+    return actor;
+}
@@ -10,6 +10,7 @@
 #include <cassert>
 
 #include <sharpen/EventLoop.hpp>
+#include <sharpen/IPosixIoOperator.hpp>
 #include <sharpen/SystemError.hpp>
 
 
@@ -30,12 +31,18 @@ sharpen::PosixFileChannel::PosixFileChannel(sharpen::FileHandle handle, bool syn
     : MyBase()
 #ifdef SHARPEN_HAS_IOURING
     , queue_(nullptr)
+    , fixedFile_(-1)
 #endif
     , syncWrite_(syncWrite) {
     assert(handle != -1);
     this->handle_ = handle;
 }
 
+sharpen::PosixFileChannel::~PosixFileChannel() noexcept {
+    // closer may use this pointer
+    this->Close();
+}
+
 void sharpen::PosixFileChannel::NormalWrite(const char *buf,
                                             std::size_t bufSize,
                                             std::uint64_t offset,
@@ -83,7 +90,7 @@ void sharpen::PosixFileChannel::NormalDeallocate(std::uint64_t offset,
 
 sharpen::IoUringStruct *sharpen::PosixFileChannel::InitStruct(
     void *buf, std::size_t bufSize, sharpen::Future<std::size_t> *future) {
-    sharpen::IoUringStruct *st = new (std::nothrow) sharpen::IoUringStruct();
+    sharpen::IoUringStruct *st{this->queue_->AllocStruct()};
     if (!st) {
         return nullptr;
     }
@@ -92,14 +99,15 @@ sharpen::IoUringStruct *sharpen::PosixFileChannel::InitStruct(
     st->length_ = 0;
     st->vec_.iov_base = buf;
     st->vec_.iov_len = bufSize;
-    st->event_.SetChannel(this->shared_from_this());
+    st->event_.SetChannel(st->channel_);
     st->event_.SetEvent(sharpen::IoEvent::EventTypeEnum::None);
     st->event_.SetData(st);
+    st->bufIndex_ = -1;
     return st;
 }
 
 sharpen::IoUringStruct *sharpen::PosixFileChannel::InitStruct(sharpen::Future<void> *future) {
-    sharpen::IoUringStruct *st = new (std::nothrow) sharpen::IoUringStruct();
+    sharpen::IoUringStruct *st{this->queue_->AllocStruct()};
     if (!st) {
         return nullptr;
     }
@@ -108,12 +116,30 @@ sharpen::IoUringStruct *sharpen::PosixFileChannel::InitStruct(sharpen::Future<vo
     st->length_ = 0;
     st->vec_.iov_base = nullptr;
     st->vec_.iov_len = 0;
-    st->event_.SetChannel(this->shared_from_this());
+    st->event_.SetChannel(st->channel_);
     st->event_.SetEvent(sharpen::IoEvent::EventTypeEnum::None);
     st->event_.SetData(st);
+    st->bufIndex_ = -1;
     return st;
 }
 
+void sharpen::PosixFileChannel::SetFileOfSqe(struct io_uring_sqe &sqe) const noexcept {
+    if (this->fixedFile_ != -1) {
+        sqe.fd = this->fixedFile_;
+        sqe.flags |= IOSQE_FIXED_FILE;
+        return;
+    }
+    sqe.fd = this->handle_;
+}
+
+void sharpen::PosixFileChannel::CloseRegistered(sharpen::FileHandle handle) noexcept {
+    if (this->fixedFile_ != -1) {
+        this->queue_->UnregisterFile(this->fixedFile_);
+        this->fixedFile_ = -1;
+    }
+    sharpen::CloseFileHandle(handle);
+}
+
 #endif
 
 void sharpen::PosixFileChannel::DoWrite(const char *buf,
@@ -129,19 +155,72 @@ void sharpen::PosixFileChannel::DoWrite(const char *buf,
     }
     struct io_uring_sqe sqe;
     std::memset(&sqe, 0, sizeof(sqe));
-    sqe.opcode = IORING_OP_WRITEV;
     st->event_.AddEvent(sharpen::IoEvent::EventTypeEnum::Write);
     sqe.user_data = reinterpret_cast<std::uint64_t>(st);
-    sqe.addr = reinterpret_cast<std::uint64_t>(&st->vec_);
-    sqe.len = 1;
     sqe.off = offset;
-    sqe.fd = this->handle_;
+    char *fixedBuf{nullptr};
+    if (this->fixedFile_ != -1) {
+        fixedBuf = this->queue_->AllocFixedBuffer(bufSize, st->bufIndex_);
+    }
+    if (fixedBuf) {
+        std::memcpy(fixedBuf, buf, bufSize);
+        sqe.opcode = IORING_OP_WRITE_FIXED;
+        sqe.addr = reinterpret_cast<std::uint64_t>(fixedBuf);
+        sqe.len = static_cast<std::uint32_t>(bufSize);
+        sqe.buf_index = static_cast<std::uint16_t>(st->bufIndex_);
+    } else {
+        sqe.opcode = IORING_OP_WRITEV;
+        sqe.addr = reinterpret_cast<std::uint64_t>(&st->vec_);
+        sqe.len = 1;
+    }
+    this->SetFileOfSqe(sqe);
     this->queue_->SubmitIoRequest(sqe);
 #else
     this->NormalWrite(buf, bufSize, offset, future);
 #endif
 }
 
+void sharpen::PosixFileChannel::NormalWriteVector(const std::vector<iovec> &bufs,
+                                                  std::uint64_t offset,
+                                                  sharpen::Future<std::size_t> *future) {
+    ssize_t r;
+    do {
+        r = ::pwritev64(this->handle_, bufs.data(), static_cast<int>(bufs.size()), offset);
+    } while (r == -1 && sharpen::GetLastError() == EINTR);
+    if (r == -1) {
+        future->Fail(sharpen::MakeLastErrorPtr());
+        return;
+    }
+    future->Complete(static_cast<std::size_t>(r));
+}
+
+void sharpen::PosixFileChannel::DoWriteVector(std::vector<iovec> &bufs,
+                                              std::uint64_t offset,
+                                              sharpen::Future<std::size_t> *future) {
+#if (defined SHARPEN_HAS_IOURING) && !(defined SHARPEN_FORCE_NORMAL_FILE_IO)
+    assert(this->queue_);
+    auto *st = this->InitStruct(nullptr, 0, future);
+    if (!st) {
+        future->Fail(std::make_exception_ptr(std::bad_alloc()));
+        return;
+    }
+    // the buffers should be valid until the cqe arrives
+    std::swap(st->vecs_, bufs);
+    struct io_uring_sqe sqe;
+    std::memset(&sqe, 0, sizeof(sqe));
+    st->event_.AddEvent(sharpen::IoEvent::EventTypeEnum::Write);
+    sqe.user_data = reinterpret_cast<std::uint64_t>(st);
+    sqe.off = offset;
+    sqe.opcode = IORING_OP_WRITEV;
+    sqe.addr = reinterpret_cast<std::uint64_t>(st->vecs_.data());
+    sqe.len = static_cast<std::uint32_t>(st->vecs_.size());
+    this->SetFileOfSqe(sqe);
+    this->queue_->SubmitIoRequest(sqe);
+#else
+    this->NormalWriteVector(bufs, offset, future);
+#endif
+}
+
 void sharpen::PosixFileChannel::NormalRead(char *buf,
                                            std::size_t bufSize,
                                            std::uint64_t offset,
@@ -170,13 +249,25 @@ void sharpen::PosixFileChannel::DoRead(char *buf,
     }
     struct io_uring_sqe sqe;
     std::memset(&sqe, 0, sizeof(sqe));
-    sqe.opcode = IORING_OP_READV;
     st->event_.AddEvent(sharpen::IoEvent::EventTypeEnum::Read);
     sqe.user_data = reinterpret_cast<std::uint64_t>(st);
-    sqe.addr = reinterpret_cast<std::uint64_t>(&st->vec_);
-    sqe.len = 1;
     sqe.off = offset;
-    sqe.fd = this->handle_;
+    char *fixedBuf{nullptr};
+    if (this->fixedFile_ != -1) {
+        fixedBuf = this->queue_->AllocFixedBuffer(bufSize, st->bufIndex_);
+    }
+    if (fixedBuf) {
+        // copy to user buffer when completed
+        sqe.opcode = IORING_OP_READ_FIXED;
+        sqe.addr = reinterpret_cast<std::uint64_t>(fixedBuf);
+        sqe.len = static_cast<std::uint32_t>(bufSize);
+        sqe.buf_index = static_cast<std::uint16_t>(st->bufIndex_);
+    } else {
+        sqe.opcode = IORING_OP_READV;
+        sqe.addr = reinterpret_cast<std::uint64_t>(&st->vec_);
+        sqe.len = 1;
+    }
+    this->SetFileOfSqe(sqe);
     this->queue_->SubmitIoRequest(sqe);
 #else
     this->NormalRead(buf, bufSize, offset, future);
@@ -205,8 +296,7 @@ void sharpen::PosixFileChannel::DoAllocate(std::uint64_t offset,
     // len should be flags of fallocate
     sqe.len = FALLOC_FL_KEEP_SIZE;
     sqe.off = offset;
-    sqe.fd = this->handle_;
-    
+    this->SetFileOfSqe(sqe);
     this->queue_->SubmitIoRequest(sqe);
 #else
     this->NormalAllocate(offset, size, future);
@@ -234,7 +324,7 @@ void sharpen::PosixFileChannel::DoDeallocate(std::uint64_t offset,
     // len should be flags of fallocate
     sqe.len = FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE;
     sqe.off = offset;
-    sqe.fd = this->handle_;
+    this->SetFileOfSqe(sqe);
     this->queue_->SubmitIoRequest(sqe);
 #else
     this->NormalDeallocate(offset, size, future);
@@ -262,6 +352,24 @@ void sharpen::PosixFileChannel::WriteAsync(const sharpen::ByteBuffer &buf,
     this->WriteAsync(buf.Data() + bufferOffset, buf.GetSize() - bufferOffset, offset, future);
 }
 
+void sharpen::PosixFileChannel::WriteVectorAsync(const sharpen::ByteSlice *slices,
+                                                 std::size_t count,
+                                                 std::uint64_t offset,
+                                                 sharpen::Future<std::size_t> &future) {
+    assert(slices != nullptr || (slices == nullptr && count == 0));
+    if (!this->IsRegistered()) {
+        throw std::logic_error("should register to a loop first");
+    }
+    std::vector<iovec> bufs;
+    sharpen::IPosixIoOperator::ConvertSlices(slices, count, bufs);
+    if (bufs.empty()) {
+        future.Complete(static_cast<std::size_t>(0));
+        return;
+    }
+    this->loop_->RunInLoopSoon(
+        std::bind(&Self::DoWriteVector, this, std::move(bufs), offset, &future));
+}
+
 void sharpen::PosixFileChannel::ReadAsync(char *buf,
                                           std::size_t bufSize,
                                           std::uint64_t offset,
@@ -286,28 +394,39 @@ void sharpen::PosixFileChannel::ReadAsync(sharpen::ByteBuffer &buf,
 void sharpen::PosixFileChannel::OnEvent(sharpen::IoEvent *event) {
 #ifdef SHARPEN_HAS_IOURING
     assert(this->queue_);
-    std::unique_ptr<sharpen::IoUringStruct> st{
-        reinterpret_cast<sharpen::IoUringStruct *>(event->GetData())};
+    sharpen::IoUringStruct *st{reinterpret_cast<sharpen::IoUringStruct *>(event->GetData())};
+    if (st->bufIndex_ != -1) {
+        if (event->IsReadEvent() && !event->IsErrorEvent()) {
+            std::memcpy(st->vec_.iov_base, this->queue_->GetFixedBuffer(st->bufIndex_), st->length_);
+        }
+        this->queue_->FreeFixedBuffer(st->bufIndex_);
+    }
+    void *data{st->data_};
+    std::size_t length{st->length_};
+    std::size_t size{st->vec_.iov_len};
+    // event points to the struct
+    // which will be reused by next request
+    sharpen::IoEvent ev{std::move(*event)};
+    event = &ev;
+    this->queue_->FreeStruct(st);
     if (event->IsReadEvent() || event->IsWriteEvent()) {
-        sharpen::Future<std::size_t> *future =
-            reinterpret_cast<sharpen::Future<std::size_t> *>(st->data_);
+        sharpen::Future<std::size_t> *future = reinterpret_cast<sharpen::Future<std::size_t> *>(data);
         if (event->IsErrorEvent()) {
             future->Fail(sharpen::MakeSystemErrorPtr(event->GetErrorCode()));
             return;
         }
-        future->Complete(st->length_);
+        future->Complete(length);
         return;
     } else if (event->IsAllocateEvent() || event->IsDeallocateEvent()) {
-        sharpen::Future<std::size_t> *future =
-            reinterpret_cast<sharpen::Future<std::size_t> *>(st->data_);
+        sharpen::Future<std::size_t> *future = reinterpret_cast<sharpen::Future<std::size_t> *>(data);
         if (event->IsErrorEvent()) {
             future->Fail(sharpen::MakeSystemErrorPtr(event->GetErrorCode()));
             return;
         }
-        future->Complete(st->vec_.iov_len);
+        future->Complete(size);
         return;
     }
-    sharpen::Future<void> *future = reinterpret_cast<sharpen::Future<void> *>(st->data_);
+    sharpen::Future<void> *future = reinterpret_cast<sharpen::Future<void> *>(data);
     if (event->IsErrorEvent()) {
         future->Fail(sharpen::MakeSystemErrorPtr(event->GetErrorCode()));
         return;
@@ -368,15 +487,16 @@ void sharpen::PosixFileChannel::Flush() {
     }
 }
 
-void sharpen::PosixFileChannel::NormalFlush(sharpen::Future<void> *future) {
-    if (::fsync(this->handle_) == -1) {
+void sharpen::PosixFileChannel::NormalFlush(sharpen::Future<void> *future, bool dataOnly) {
+    int r{dataOnly ? ::fdatasync(this->handle_) : ::fsync(this->handle_)};
+    if (r == -1) {
         future->Fail(sharpen::MakeLastErrorPtr());
         return;
     }
     future->Complete();
 }
 
-void sharpen::PosixFileChannel::DoFlush(sharpen::Future<void> *future) {
+void sharpen::PosixFileChannel::DoFlush(sharpen::Future<void> *future, bool dataOnly) {
     assert(future != nullptr);
 #if (defined SHARPEN_HAS_IOURING) && !(defined SHARPEN_FORCE_NORMAL_FILE_IO)
     assert(this->queue_);
@@ -388,12 +508,15 @@ void sharpen::PosixFileChannel::DoFlush(sharpen::Future<void> *future) {
     struct io_uring_sqe sqe;
     std::memset(&sqe, 0, sizeof(sqe));
     sqe.opcode = IORING_OP_FSYNC;
+    if (dataOnly) {
+        sqe.fsync_flags = IORING_FSYNC_DATASYNC;
+    }
     st->event_.AddEvent(sharpen::IoEvent::EventTypeEnum::Flush);
     sqe.user_data = reinterpret_cast<std::uint64_t>(st);
-    sqe.fd = this->handle_;
+    this->SetFileOfSqe(sqe);
     this->queue_->SubmitIoRequest(sqe);
 #else
-    this->NormalFlush(future);
+    this->NormalFlush(future, dataOnly);
 #endif
 }
 
@@ -407,7 +530,18 @@ void sharpen::PosixFileChannel::FlushAsync(sharpen::Future<void> &future) {
     if (!this->IsRegistered()) {
         throw std::logic_error("should register to a loop first");
     }
-    this->loop_->RunInLoopSoon(std::bind(&Self::DoFlush, this, &future));
+    this->loop_->RunInLoopSoon(std::bind(&Self::DoFlush, this, &future, false));
+}
+
+void sharpen::PosixFileChannel::FlushDataAsync(sharpen::Future<void> &future) {
+    if (this->syncWrite_) {
+        future.Complete();
+        return;
+    }
+    if (!this->IsRegistered()) {
+        throw std::logic_error("should register to a loop first");
+    }
+    this->loop_->RunInLoopSoon(std::bind(&Self::DoFlush, this, &future, true));
 }
 
 void sharpen::PosixFileChannel::AllocateAsync(sharpen::Future<std::size_t> &future,
@@ -442,4 +576,26 @@ std::size_t sharpen::PosixFileChannel::GetPath(char *path, std::size_t size) con
     return r;
 }
 
+bool sharpen::PosixFileChannel::EnableRegisteredIo() {
+#if (defined SHARPEN_HAS_IOURING) && !(defined SHARPEN_FORCE_NORMAL_FILE_IO)
+    if (!this->queue_) {
+        return false;
+    }
+    if (this->fixedFile_ != -1) {
+        return true;
+    }
+    int index{this->queue_->RegisterFile(this->handle_)};
+    if (index == -1) {
+        return false;
+    }
+    this->fixedFile_ = index;
+    // release the slot of file table when closing
+    this->closer_ =
+        std::bind(&sharpen::PosixFileChannel::CloseRegistered, this, std::placeholders::_1);
+    return true;
+#else
+    return false;
+#endif
+}
+
 #endif
\ No newline at end of file
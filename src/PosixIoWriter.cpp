@@ -2,6 +2,14 @@
 
 #ifdef SHARPEN_IS_NIX
 
+void sharpen::PosixIoWriter::CompletePartialTask(Callback cb, std::size_t written, ssize_t size) {
+    if (size > 0) {
+        cb(static_cast<ssize_t>(written) + size);
+        return;
+    }
+    cb(static_cast<ssize_t>(written));
+}
+
 void sharpen::PosixIoWriter::NviExecute(sharpen::FileHandle handle,
                                         bool &executed,
                                         bool &blocking) {
@@ -47,10 +55,18 @@ void sharpen::PosixIoWriter::NviExecute(sharpen::FileHandle handle,
     }
     std::size_t lastBufSize = bufs[completed].iov_len;
     if (lastBufSize != lastSize) {
-        std::uintptr_t p = reinterpret_cast<std::uintptr_t>(bufs[completed].iov_len);
+        std::uintptr_t p = reinterpret_cast<std::uintptr_t>(bufs[completed].iov_base);
         p += lastSize;
         bufs[completed].iov_base = reinterpret_cast<void *>(p);
         bufs[completed].iov_len -= lastSize;
+        if (lastSize) {
+            // the callback should report the written bytes of whole buffer
+            using FnPtr = void (*)(Callback, std::size_t, ssize_t);
+            cbs[completed] = std::bind(static_cast<FnPtr>(&Self::CompletePartialTask),
+                                       std::move(cbs[completed]),
+                                       lastSize,
+                                       std::placeholders::_1);
+        }
     } else {
         cbs[completed](lastSize);
         completed += 1;
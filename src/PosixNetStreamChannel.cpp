@@ -2,12 +2,21 @@
 
 #ifdef SHARPEN_HAS_POSIXSOCKET
 
+#include <sharpen/EpollSelector.hpp>
 #include <sharpen/EventLoop.hpp>
 #include <sharpen/SystemError.hpp>
+#include <fcntl.h>
+#include <poll.h>
 #include <sys/mman.h>
 #include <unistd.h>
 #include <algorithm>
 #include <cassert>
+#include <cstring>
+#include <limits>
+
+#ifdef SHARPEN_IS_LINUX
+#include <sys/sendfile.h>
+#endif
 
 sharpen::PosixNetStreamChannel::PosixNetStreamChannel(sharpen::FileHandle handle)
     : Mybase()
@@ -20,7 +29,29 @@ sharpen::PosixNetStreamChannel::PosixNetStreamChannel(sharpen::FileHandle handle
     , acceptCb_()
     , connectCb_()
     , pollReadCbs_()
-    , pollWriteCbs_() {
+    , pollWriteCbs_()
+#ifdef SHARPEN_IS_LINUX
+    , sendFiles_()
+#endif
+#ifdef SHARPEN_HAS_IOURING
+    , queue_(nullptr)
+    , uringReads_()
+    , uringWrites_()
+    , uringReading_(false)
+    , uringWriting_(false)
+    , uringRequests_()
+    , recvRequest_(nullptr)
+    , acceptRequest_(nullptr)
+    , recvCanceled_(false)
+    , acceptCanceled_(false)
+    , uringChunks_()
+    , recvEnd_(false)
+    , recvError_(0)
+    , recvNoBuffer_(false)
+    , uringAccepts_()
+    , acceptedHandles_()
+#endif
+{
     this->handle_ = handle;
     // reset closer before ~IChannel() to be invoked
     // because SafeClose use this pointer
@@ -29,6 +60,10 @@ sharpen::PosixNetStreamChannel::PosixNetStreamChannel(sharpen::FileHandle handle
 }
 
 sharpen::PosixNetStreamChannel::~PosixNetStreamChannel() noexcept {
+#ifdef SHARPEN_HAS_IOURING
+    // may be invoked by other threads
+    this->ReleaseUringResources();
+#endif
     this->DoCancel(sharpen::ErrorConnectionAborted);
     // reset closer
     {
@@ -75,8 +110,20 @@ void sharpen::PosixNetStreamChannel::DoRead() {
 void sharpen::PosixNetStreamChannel::DoWrite() {
     bool blocking;
     bool executed;
-    this->writer_.Execute(this->handle_, executed, blocking);
-    this->writeable_ = !executed || !blocking;
+    bool pending{false};
+    do {
+        this->writer_.Execute(this->handle_, executed, blocking);
+        this->writeable_ = !executed || !blocking;
+#ifdef SHARPEN_IS_LINUX
+        // writes before sendfile first
+        if (this->writeable_ && !this->writer_.HasPendingTask() && !this->sendFiles_.empty()) {
+            this->writeable_ = this->DoSendFile();
+        }
+        pending = this->writer_.HasPendingTask() || !this->sendFiles_.empty();
+#else
+        pending = this->writer_.HasPendingTask();
+#endif
+    } while (this->writeable_ && pending);
     if (!this->writeable_ && this->peerClosed_) {
         this->DoCancel(sharpen::ErrorConnectionReset);
     }
@@ -172,6 +219,11 @@ void sharpen::PosixNetStreamChannel::HandleWrite() {
 }
 
 void sharpen::PosixNetStreamChannel::TryRead(char *buf, std::size_t bufSize, Callback cb) {
+#ifdef SHARPEN_HAS_IOURING
+    if (this->queue_) {
+        return this->UringRead(buf, bufSize, std::move(cb));
+    }
+#endif
     this->reader_.AddPendingTask(buf, bufSize, std::move(cb));
     if (this->readable_ || this->peerClosed_) {
         this->DoRead();
@@ -179,13 +231,134 @@ void sharpen::PosixNetStreamChannel::TryRead(char *buf, std::size_t bufSize, Cal
 }
 
 void sharpen::PosixNetStreamChannel::TryWrite(const char *buf, std::size_t bufSize, Callback cb) {
+#ifdef SHARPEN_HAS_IOURING
+    if (this->queue_) {
+        return this->UringWrite(buf, bufSize, std::move(cb));
+    }
+#endif
+#ifdef SHARPEN_IS_LINUX
+    if (!this->sendFiles_.empty()) {
+        iovec io;
+        io.iov_base = const_cast<char *>(buf);
+        io.iov_len = bufSize;
+        this->DeferWrite(std::vector<iovec>{io}, std::move(cb));
+        return;
+    }
+#endif
     this->writer_.AddPendingTask(const_cast<char *>(buf), bufSize, std::move(cb));
     if (this->writeable_ || this->peerClosed_) {
         this->DoWrite();
     }
 }
 
+void sharpen::PosixNetStreamChannel::TryWriteVector(std::vector<iovec> &bufs, Callback cb) {
+#ifdef SHARPEN_HAS_IOURING
+    if (this->queue_) {
+        return this->UringWriteVector(bufs, std::move(cb));
+    }
+#endif
+#ifdef SHARPEN_IS_LINUX
+    if (!this->sendFiles_.empty()) {
+        this->DeferWrite(std::move(bufs), std::move(cb));
+        return;
+    }
+#endif
+    this->writer_.AddPendingTasks(bufs.data(), bufs.size(), std::move(cb));
+    if (this->writeable_ || this->peerClosed_) {
+        this->DoWrite();
+    }
+}
+
+#ifdef SHARPEN_IS_LINUX
+ssize_t sharpen::PosixNetStreamChannel::SendFile(SendFileTask &task) noexcept {
+    assert(task.size_ > task.written_);
+    std::size_t size{task.size_ - task.written_};
+    ssize_t bytes{-1};
+    if (!task.splice_) {
+        off64_t offset{static_cast<off64_t>(task.offset_ + task.written_)};
+        do {
+            bytes = ::sendfile64(this->handle_, task.file_, &offset, size);
+        } while (bytes == -1 && sharpen::GetLastError() == EINTR);
+        sharpen::ErrorCode err{sharpen::GetLastError()};
+        if (bytes != -1 || (err != EINVAL && err != ENOSYS)) {
+            if (bytes > 0) {
+                task.written_ += static_cast<std::size_t>(bytes);
+            }
+            return bytes;
+        }
+        // pipes don't support sendfile()
+        task.splice_ = true;
+    }
+    do {
+        bytes = ::splice(task.file_, nullptr, this->handle_, nullptr, size, SPLICE_F_MOVE);
+    } while (bytes == -1 && sharpen::GetLastError() == EINTR);
+    if (bytes > 0) {
+        task.written_ += static_cast<std::size_t>(bytes);
+    }
+    return bytes;
+}
+
+void sharpen::PosixNetStreamChannel::CompleteSendFile(SendFileTask &task, ssize_t size) {
+    Callback cb;
+    std::swap(cb, task.cb_);
+    if (task.written_) {
+        size = static_cast<ssize_t>(task.written_);
+    }
+    cb(size);
+}
+
+bool sharpen::PosixNetStreamChannel::DoSendFile() {
+    assert(!this->sendFiles_.empty());
+    SendFileTask &task{this->sendFiles_.front()};
+    if (task.file_ == -1) {
+        // previous sendfiles have been completed
+        this->writer_.AddPendingTasks(task.bufs_.data(), task.bufs_.size(), std::move(task.cb_));
+        this->sendFiles_.pop_front();
+        return true;
+    }
+    ssize_t size{this->SendFile(task)};
+    sharpen::ErrorCode err{sharpen::GetLastError()};
+    if (size == -1 && sharpen::IPosixIoOperator::IsBlockingError(err)) {
+        return false;
+    }
+    if (size > 0 && task.written_ != task.size_) {
+        return true;
+    }
+    SendFileTask completed{std::move(task)};
+    this->sendFiles_.pop_front();
+    errno = err;
+    Self::CompleteSendFile(completed, size);
+    return true;
+}
+
+void sharpen::PosixNetStreamChannel::TrySendFile(sharpen::FileHandle handle,
+                                                 std::uint64_t offset,
+                                                 std::size_t size,
+                                                 Callback cb) {
+    SendFileTask task{handle, offset, size, 0, false, std::vector<iovec>{}, std::move(cb)};
+#ifdef SHARPEN_HAS_IOURING
+    if (this->queue_) {
+        return this->UringSendFile(std::make_shared<SendFileTask>(std::move(task)));
+    }
+#endif
+    this->sendFiles_.push_back(std::move(task));
+    if (this->writeable_ || this->peerClosed_) {
+        this->DoWrite();
+    }
+}
+
+void sharpen::PosixNetStreamChannel::DeferWrite(std::vector<iovec> bufs, Callback cb) {
+    assert(!bufs.empty());
+    this->sendFiles_.push_back(SendFileTask{-1, 0, 0, 0, false, std::move(bufs), std::move(cb)});
+}
+#endif
+
 void sharpen::PosixNetStreamChannel::TryPollRead(Callback cb) {
+#ifdef SHARPEN_HAS_IOURING
+    if (this->queue_) {
+        return this->UringPoll(POLLIN, std::move(cb));
+    }
+#endif
     this->pollReadCbs_.push_back(std::move(cb));
     if (this->readable_ || this->peerClosed_) {
         this->DoPollRead();
@@ -193,6 +366,11 @@ void sharpen::PosixNetStreamChannel::TryPollRead(Callback cb) {
 }
 
 void sharpen::PosixNetStreamChannel::TryPollWrite(Callback cb) {
+#ifdef SHARPEN_HAS_IOURING
+    if (this->queue_) {
+        return this->UringPoll(POLLOUT, std::move(cb));
+    }
+#endif
     this->pollWriteCbs_.push_back(std::move(cb));
     if (this->writeable_ || this->peerClosed_) {
         this->DoPollWrite();
@@ -200,6 +378,11 @@ void sharpen::PosixNetStreamChannel::TryPollWrite(Callback cb) {
 }
 
 void sharpen::PosixNetStreamChannel::TryAccept(AcceptCallback cb) {
+#ifdef SHARPEN_HAS_IOURING
+    if (this->queue_) {
+        return this->UringAccept(std::move(cb));
+    }
+#endif
     if (this->readable_) {
         sharpen::FileHandle handle = this->DoAccept();
         if (handle == -1) {
@@ -219,6 +402,11 @@ void sharpen::PosixNetStreamChannel::TryAccept(AcceptCallback cb) {
 
 void sharpen::PosixNetStreamChannel::TryConnect(const sharpen::IEndPoint &endPoint,
                                                 ConnectCallback cb) {
+#ifdef SHARPEN_HAS_IOURING
+    if (this->queue_) {
+        return this->UringConnect(endPoint, std::move(cb));
+    }
+#endif
     this->status_ = sharpen::PosixNetStreamChannel::IoStatus::Connect;
     int r = ::connect(this->handle_, endPoint.GetAddrPtr(), endPoint.GetAddrLen());
     if (r == -1) {
@@ -231,6 +419,9 @@ void sharpen::PosixNetStreamChannel::TryConnect(const sharpen::IEndPoint &endPoi
         this->connectCb_ = std::move(cb);
         return;
     }
+    // connected immediately (e.g. udp)
+    // the callback reads errno
+    errno = 0;
     this->status_ = sharpen::PosixNetStreamChannel::IoStatus::Io;
     cb();
 }
@@ -259,23 +450,44 @@ void sharpen::PosixNetStreamChannel::RequestWrite(const char *buf,
         std::bind(&sharpen::PosixNetStreamChannel::TryWrite, this, buf, bufSize, std::move(cb)));
 }
 
+void sharpen::PosixNetStreamChannel::RequestWriteVector(std::vector<iovec> bufs,
+                                                        sharpen::Future<std::size_t> *future) {
+    using FnPtr = void (*)(sharpen::EventLoop *, sharpen::Future<std::size_t> *, ssize_t);
+    Callback cb = std::bind(static_cast<FnPtr>(&sharpen::PosixNetStreamChannel::CompleteIoCallback),
+                            this->loop_,
+                            future,
+                            std::placeholders::_1);
+    this->loop_->RunInLoop(std::bind(
+        &sharpen::PosixNetStreamChannel::TryWriteVector, this, std::move(bufs), std::move(cb)));
+}
+
 void sharpen::PosixNetStreamChannel::RequestSendFile(sharpen::FileHandle handle,
                                                      std::uint64_t offset,
                                                      std::size_t size,
                                                      sharpen::Future<std::size_t> *future) {
+#ifdef SHARPEN_IS_LINUX
+    // the data never comes to user space
+    using FnPtr = void (*)(sharpen::EventLoop *, sharpen::Future<std::size_t> *, ssize_t);
+    Callback cb = std::bind(static_cast<FnPtr>(&sharpen::PosixNetStreamChannel::CompleteIoCallback),
+                            this->loop_,
+                            future,
+                            std::placeholders::_1);
+    this->loop_->RunInLoop(std::bind(
+        &sharpen::PosixNetStreamChannel::TrySendFile, this, handle, offset, size, std::move(cb)));
+#else
     std::size_t memSize = size;
     std::size_t over = offset % 4096;
     if (over) {
         offset -= over;
     }
     memSize += over;
-    over = memSize % 4096;
-    if (over) {
-        memSize += (4096 - over);
+    std::size_t tail = memSize % 4096;
+    if (tail) {
+        memSize += (4096 - tail);
     }
-    void *mem = ::mmap64(nullptr, memSize, PROT_READ, MAP_SHARED, handle, offset);
-    if (mem == nullptr) {
-        future->Fail(std::make_exception_ptr(std::bad_alloc()));
+    void *mem = ::mmap(nullptr, memSize, PROT_READ, MAP_SHARED, handle, offset);
+    if (mem == MAP_FAILED) {
+        future->Fail(sharpen::MakeLastErrorPtr());
         return;
     }
     std::uintptr_t p = reinterpret_cast<std::uintptr_t>(mem);
@@ -294,6 +506,7 @@ void sharpen::PosixNetStreamChannel::RequestSendFile(sharpen::FileHandle handle,
                                      reinterpret_cast<const char *>(p),
                                      size,
                                      std::move(cb)));
+#endif
 }
 
 void sharpen::PosixNetStreamChannel::RequestConnect(const sharpen::IEndPoint &endPoint,
@@ -392,6 +605,7 @@ void sharpen::PosixNetStreamChannel::CompletePollCallback(sharpen::EventLoop *lo
     loop->RunInLoopSoon(std::bind(&sharpen::Future<void>::CompleteForBind, future));
 }
 
+#ifndef SHARPEN_IS_LINUX
 void sharpen::PosixNetStreamChannel::CompleteSendFileCallback(sharpen::EventLoop *loop,
                                                               sharpen::Future<std::size_t> *future,
                                                               void *mem,
@@ -407,14 +621,16 @@ void sharpen::PosixNetStreamChannel::CompleteSendFileCallback(sharpen::EventLoop
             loop->RunInLoopSoon(std::bind(&sharpen::Future<std::size_t>::CompleteForBind,
                                           future,
                                           static_cast<std::size_t>(0)));
+            return;
         }
-        loop->RunInLoopSoon(
-            std::bind(&sharpen::Future<std::size_t>::Fail, future, sharpen::MakeLastErrorPtr()));
+        loop->RunInLoopSoon(std::bind(
+            &sharpen::Future<std::size_t>::Fail, future, sharpen::MakeSystemErrorPtr(code)));
         return;
     }
     loop->RunInLoopSoon(std::bind(
         &sharpen::Future<std::size_t>::CompleteForBind, future, static_cast<std::size_t>(size)));
 }
+#endif
 
 void sharpen::PosixNetStreamChannel::CompleteAcceptCallback(
     sharpen::EventLoop *loop,
@@ -458,6 +674,22 @@ void sharpen::PosixNetStreamChannel::WriteAsync(const sharpen::ByteBuffer &buf,
     this->WriteAsync(buf.Data() + bufferOffset, buf.GetSize() - bufferOffset, future);
 }
 
+void sharpen::PosixNetStreamChannel::WriteVectorAsync(const sharpen::ByteSlice *slices,
+                                                      std::size_t count,
+                                                      sharpen::Future<std::size_t> &future) {
+    assert(slices != nullptr || (slices == nullptr && count == 0));
+    if (!this->IsRegistered()) {
+        throw std::logic_error("should register to a loop first");
+    }
+    std::vector<iovec> bufs;
+    sharpen::IPosixIoOperator::ConvertSlices(slices, count, bufs);
+    if (this->handle_ == -1 || bufs.empty()) {
+        future.Complete(static_cast<std::size_t>(0));
+        return;
+    }
+    this->RequestWriteVector(std::move(bufs), &future);
+}
+
 void sharpen::PosixNetStreamChannel::ReadAsync(char *buf,
                                                std::size_t bufSize,
                                                sharpen::Future<std::size_t> &future) {
@@ -485,6 +717,12 @@ void sharpen::PosixNetStreamChannel::ReadAsync(sharpen::ByteBuffer &buf,
 }
 
 void sharpen::PosixNetStreamChannel::OnEvent(sharpen::IoEvent *event) {
+#ifdef SHARPEN_HAS_IOURING
+    if (this->queue_) {
+        this->HandleUringEvent(event);
+        return;
+    }
+#endif
     if (event->IsReadEvent()) {
         this->HandleRead();
     }
@@ -507,7 +745,7 @@ void sharpen::PosixNetStreamChannel::SendFileAsync(sharpen::FileChannelPtr file,
     if(size > MaxIoSize) {
         size = MaxIoSize;
     }
-    if (this->handle_ == -1) {
+    if (this->handle_ == -1 || !size) {
         future.Complete(static_cast<std::size_t>(0));
         return;
     }
@@ -557,15 +795,40 @@ void sharpen::PosixNetStreamChannel::PollWriteAsync(sharpen::Future<void> &futur
     this->RequestPollWrite(&future);
 }
 
+void sharpen::PosixNetStreamChannel::Register(sharpen::EventLoop &loop) {
+#ifdef SHARPEN_HAS_IOURING
+    sharpen::EpollSelector *selector = static_cast<sharpen::EpollSelector *>(loop.GetSelectorPtr());
+    if (selector->GetNetIoMethod() == sharpen::NetIoMethod::Completion) {
+        // don't register to epoll
+        this->loop_ = &loop;
+        this->queue_ = selector->GetIoUring();
+        assert(this->queue_);
+        return;
+    }
+#endif
+    Mybase::Register(loop);
+}
+
 void sharpen::PosixNetStreamChannel::Listen(std::uint16_t queueLength) {
     this->status_ = sharpen::PosixNetStreamChannel::IoStatus::Accept;
     Mybase::Listen(queueLength);
 }
 
 void sharpen::PosixNetStreamChannel::DoCancel(sharpen::ErrorCode err) noexcept {
+#ifdef SHARPEN_HAS_IOURING
+    this->CancelUringRequests(err);
+#endif
     // cancel all io
     this->reader_.CancelAllIo(err);
     this->writer_.CancelAllIo(err);
+#ifdef SHARPEN_IS_LINUX
+    SendFileTasks sendFiles;
+    std::swap(sendFiles, this->sendFiles_);
+    for (auto begin = sendFiles.begin(), end = sendFiles.end(); begin != end; ++begin) {
+        errno = err;
+        Self::CompleteSendFile(*begin, -1);
+    }
+#endif
     errno = err;
     for (auto begin = this->pollReadCbs_.begin(); begin != this->pollReadCbs_.end(); ++begin) {
         (*begin)(-1);
@@ -600,4 +863,636 @@ void sharpen::PosixNetStreamChannel::Cancel() noexcept {
                                          this->shared_from_this()));
 }
 
-#endif
\ No newline at end of file
+#ifdef SHARPEN_HAS_IOURING
+sharpen::PosixNetStreamChannel::UringRequest *sharpen::PosixNetStreamChannel::MakeUringRequest(
+    Callback cb, std::uint32_t eventType) {
+    UringRequest *request{new (std::nothrow) UringRequest()};
+    if (!request) {
+        errno = ENOMEM;
+        cb(-1);
+        return nullptr;
+    }
+    request->channel_ = this->shared_from_this();
+    request->data_ = nullptr;
+    request->length_ = 0;
+    request->vec_.iov_base = nullptr;
+    request->vec_.iov_len = 0;
+    request->event_.SetChannel(this->shared_from_this());
+    request->event_.SetEvent(eventType);
+    request->event_.SetData(static_cast<sharpen::IoUringStruct *>(request));
+    request->cb_ = std::move(cb);
+    return request;
+}
+
+bool sharpen::PosixNetStreamChannel::SubmitUringRequest(UringRequest *request,
+                                                        struct io_uring_sqe &sqe) noexcept {
+    assert(this->queue_);
+    sqe.user_data = reinterpret_cast<std::uint64_t>(static_cast<sharpen::IoUringStruct *>(request));
+    try {
+        this->uringRequests_.push_back(request);
+        try {
+            this->queue_->SubmitIoRequest(sqe);
+        } catch (const std::bad_alloc &) {
+            this->uringRequests_.pop_back();
+            throw;
+        }
+    } catch (const std::bad_alloc &fault) {
+        (void)fault;
+        std::unique_ptr<UringRequest> guard{request};
+        Callback cb{std::move(request->cb_)};
+        errno = ENOMEM;
+        cb(-1);
+        return false;
+    }
+    return true;
+}
+
+void sharpen::PosixNetStreamChannel::SubmitUringRead() {
+    if (this->queue_->SupportMultishotRecv()) {
+        this->DeliverUringChunks();
+        if (this->uringReads_.empty() || this->uringReading_ || this->recvRequest_) {
+            return;
+        }
+        if (!this->recvNoBuffer_) {
+            this->ArmUringRecv();
+            return;
+        }
+        // provided buffers were exhausted by other channels
+        // receive into the buffer of caller once
+        this->recvNoBuffer_ = false;
+    }
+    while (!this->uringReading_ && !this->uringReads_.empty()) {
+        UringTask task{std::move(this->uringReads_.front())};
+        this->uringReads_.pop_front();
+        UringRequest *request{
+            this->MakeUringRequest(std::move(task.cb_), sharpen::IoEvent::EventTypeEnum::Read)};
+        if (!request) {
+            continue;
+        }
+        struct io_uring_sqe sqe;
+        std::memset(&sqe, 0, sizeof(sqe));
+        sqe.opcode = IORING_OP_RECV;
+        sqe.fd = this->handle_;
+        sqe.addr = reinterpret_cast<std::uint64_t>(task.buf_);
+        sqe.len = static_cast<std::uint32_t>((std::min)(
+            task.bufSize_, static_cast<std::size_t>((std::numeric_limits<std::int32_t>::max)())));
+        this->uringReading_ = this->SubmitUringRequest(request, sqe);
+    }
+}
+
+void sharpen::PosixNetStreamChannel::SubmitUringWrite() {
+    while (!this->uringWriting_ && !this->uringWrites_.empty()) {
+        UringTask task{std::move(this->uringWrites_.front())};
+        this->uringWrites_.pop_front();
+        if (task.file_) {
+            this->uringWriting_ = !this->SubmitUringSendFile(std::move(task.file_));
+            continue;
+        }
+        UringRequest *request{
+            this->MakeUringRequest(std::move(task.cb_), sharpen::IoEvent::EventTypeEnum::Write)};
+        if (!request) {
+            continue;
+        }
+        struct io_uring_sqe sqe;
+        std::memset(&sqe, 0, sizeof(sqe));
+        sqe.fd = this->handle_;
+        sqe.msg_flags = MSG_NOSIGNAL;
+        if (!task.vecs_.empty()) {
+            // the buffers should be valid until the cqe arrives
+            std::swap(request->vecs_, task.vecs_);
+            std::memset(&request->msg_, 0, sizeof(request->msg_));
+            request->msg_.msg_iov = request->vecs_.data();
+            request->msg_.msg_iovlen = request->vecs_.size();
+            sqe.opcode = IORING_OP_SENDMSG;
+            sqe.addr = reinterpret_cast<std::uint64_t>(&request->msg_);
+            sqe.len = 1;
+        } else {
+            sqe.opcode = IORING_OP_SEND;
+            sqe.addr = reinterpret_cast<std::uint64_t>(task.buf_);
+            sqe.len = static_cast<std::uint32_t>((std::min)(
+                task.bufSize_,
+                static_cast<std::size_t>((std::numeric_limits<std::int32_t>::max)())));
+        }
+        this->uringWriting_ = this->SubmitUringRequest(request, sqe);
+    }
+}
+
+void sharpen::PosixNetStreamChannel::UringRead(char *buf, std::size_t bufSize, Callback cb) {
+    this->uringReads_.push_back(
+        UringTask{buf, bufSize, std::move(cb), std::vector<iovec>{}, nullptr});
+    this->SubmitUringRead();
+}
+
+void sharpen::PosixNetStreamChannel::UringWrite(const char *buf,
+                                                std::size_t bufSize,
+                                                Callback cb) {
+    this->uringWrites_.push_back(
+        UringTask{
+            const_cast<char *>(buf), bufSize, std::move(cb), std::vector<iovec>{}, nullptr});
+    this->SubmitUringWrite();
+}
+
+void sharpen::PosixNetStreamChannel::UringWriteVector(std::vector<iovec> &bufs, Callback cb) {
+    UringTask task{nullptr, 0, std::move(cb), std::vector<iovec>{}, nullptr};
+    std::swap(task.vecs_, bufs);
+    this->uringWrites_.push_back(std::move(task));
+    this->SubmitUringWrite();
+}
+
+void sharpen::PosixNetStreamChannel::UringSendFile(std::shared_ptr<SendFileTask> task) {
+    this->uringWrites_.push_back(
+        UringTask{nullptr, 0, Callback{}, std::vector<iovec>{}, std::move(task)});
+    this->SubmitUringWrite();
+}
+
+bool sharpen::PosixNetStreamChannel::SubmitUringSendFile(std::shared_ptr<SendFileTask> task) {
+    ssize_t size{0};
+    do {
+        size = this->SendFile(*task);
+    } while (size > 0 && task->written_ != task->size_);
+    if (size != -1 || !sharpen::IPosixIoOperator::IsBlockingError(sharpen::GetLastError())) {
+        Self::CompleteSendFile(*task, size);
+        return true;
+    }
+    // io_uring splices through a pipe only
+    // so poll the socket and call sendfile() again
+    using FnPtr = void (Self::*)(std::shared_ptr<SendFileTask>, ssize_t);
+    Callback cb{std::bind(static_cast<FnPtr>(&Self::ContinueUringSendFile),
+                          this,
+                          std::move(task),
+                          std::placeholders::_1)};
+    UringRequest *request{
+        this->MakeUringRequest(std::move(cb), sharpen::IoEvent::EventTypeEnum::Write)};
+    if (!request) {
+        return true;
+    }
+    struct io_uring_sqe sqe;
+    std::memset(&sqe, 0, sizeof(sqe));
+    sqe.opcode = IORING_OP_POLL_ADD;
+    sqe.fd = this->handle_;
+    sqe.poll32_events = POLLOUT;
+    return !this->SubmitUringRequest(request, sqe);
+}
+
+void sharpen::PosixNetStreamChannel::ContinueUringSendFile(std::shared_ptr<SendFileTask> task,
+                                                           ssize_t size) {
+    if (size == -1) {
+        Self::CompleteSendFile(*task, size);
+        return;
+    }
+    // the channel is writable
+    // resume the task before other writes
+    this->uringWrites_.push_front(
+        UringTask{nullptr, 0, Callback{}, std::vector<iovec>{}, std::move(task)});
+}
+
+void sharpen::PosixNetStreamChannel::UringAccept(AcceptCallback cb) {
+    if (this->queue_->SupportMultishot()) {
+        if (!this->acceptedHandles_.empty()) {
+            sharpen::FileHandle handle{this->acceptedHandles_.front()};
+            this->acceptedHandles_.pop_front();
+            cb(handle);
+            return;
+        }
+        this->uringAccepts_.push_back(std::move(cb));
+        if (!this->acceptRequest_) {
+            this->ArmUringAccept();
+        }
+        return;
+    }
+    Callback callback{std::bind(
+        &sharpen::PosixNetStreamChannel::InvokeAcceptCallback, std::move(cb), std::placeholders::_1)};
+    UringRequest *request{
+        this->MakeUringRequest(std::move(callback), sharpen::IoEvent::EventTypeEnum::Accept)};
+    if (!request) {
+        return;
+    }
+    struct io_uring_sqe sqe;
+    std::memset(&sqe, 0, sizeof(sqe));
+    sqe.opcode = IORING_OP_ACCEPT;
+    sqe.fd = this->handle_;
+    sqe.accept_flags = SOCK_NONBLOCK | SOCK_CLOEXEC;
+    this->SubmitUringRequest(request, sqe);
+}
+
+void sharpen::PosixNetStreamChannel::UringConnect(const sharpen::IEndPoint &endPoint,
+                                                  ConnectCallback cb) {
+    // the address must be valid until the sqe is consumed
+    std::unique_ptr<struct sockaddr_storage> addr{new (std::nothrow) struct sockaddr_storage};
+    if (!addr) {
+        errno = ENOMEM;
+        cb();
+        return;
+    }
+    std::memcpy(addr.get(), endPoint.GetAddrPtr(), endPoint.GetAddrLen());
+    Callback callback{std::bind(&sharpen::PosixNetStreamChannel::InvokeConnectCallback,
+                                std::move(cb),
+                                std::placeholders::_1)};
+    UringRequest *request{
+        this->MakeUringRequest(std::move(callback), sharpen::IoEvent::EventTypeEnum::Connect)};
+    if (!request) {
+        return;
+    }
+    request->addr_ = std::move(addr);
+    struct io_uring_sqe sqe;
+    std::memset(&sqe, 0, sizeof(sqe));
+    sqe.opcode = IORING_OP_CONNECT;
+    sqe.fd = this->handle_;
+    sqe.addr = reinterpret_cast<std::uint64_t>(request->addr_.get());
+    sqe.off = endPoint.GetAddrLen();
+    this->SubmitUringRequest(request, sqe);
+}
+
+void sharpen::PosixNetStreamChannel::UringPoll(std::uint32_t events, Callback cb) {
+    UringRequest *request{
+        this->MakeUringRequest(std::move(cb), sharpen::IoEvent::EventTypeEnum::Poll)};
+    if (!request) {
+        return;
+    }
+    struct io_uring_sqe sqe;
+    std::memset(&sqe, 0, sizeof(sqe));
+    sqe.opcode = IORING_OP_POLL_ADD;
+    sqe.fd = this->handle_;
+    sqe.poll32_events = events;
+    this->SubmitUringRequest(request, sqe);
+}
+
+sharpen::IoUringStruct *sharpen::PosixNetStreamChannel::MakeMultishotRequest(
+    std::uint32_t eventType) {
+    sharpen::IoUringStruct *request{this->queue_->AllocStruct()};
+    if (!request) {
+        return nullptr;
+    }
+    request->event_.SetChannel(this->shared_from_this());
+    request->event_.SetEvent(eventType);
+    request->event_.SetData(request);
+    request->multishot_ = true;
+    return request;
+}
+
+void sharpen::PosixNetStreamChannel::ArmUringRecv() {
+    sharpen::IoUringStruct *request{
+        this->MakeMultishotRequest(sharpen::IoEvent::EventTypeEnum::Read)};
+    if (!request) {
+        errno = ENOMEM;
+        this->AbortUringReads(-1);
+        return;
+    }
+    // the kernel picks a provided buffer for each completion
+    struct io_uring_sqe sqe;
+    std::memset(&sqe, 0, sizeof(sqe));
+    sqe.opcode = IORING_OP_RECV;
+    sqe.fd = this->handle_;
+    sqe.ioprio = IORING_RECV_MULTISHOT;
+    sqe.flags = IOSQE_BUFFER_SELECT;
+    sqe.buf_group = this->queue_->GetRecvBufferGroup();
+    sqe.user_data = reinterpret_cast<std::uint64_t>(request);
+    try {
+        this->queue_->SubmitIoRequest(sqe);
+    } catch (const std::bad_alloc &fault) {
+        (void)fault;
+        this->queue_->FreeStruct(request);
+        errno = ENOMEM;
+        this->AbortUringReads(-1);
+        return;
+    }
+    this->recvRequest_ = request;
+}
+
+void sharpen::PosixNetStreamChannel::ArmUringAccept() {
+    sharpen::IoUringStruct *request{
+        this->MakeMultishotRequest(sharpen::IoEvent::EventTypeEnum::Accept)};
+    if (!request) {
+        errno = ENOMEM;
+        this->AbortUringAccepts(-1);
+        return;
+    }
+    struct io_uring_sqe sqe;
+    std::memset(&sqe, 0, sizeof(sqe));
+    sqe.opcode = IORING_OP_ACCEPT;
+    sqe.fd = this->handle_;
+    sqe.ioprio = IORING_ACCEPT_MULTISHOT;
+    sqe.accept_flags = SOCK_NONBLOCK | SOCK_CLOEXEC;
+    sqe.user_data = reinterpret_cast<std::uint64_t>(request);
+    try {
+        this->queue_->SubmitIoRequest(sqe);
+    } catch (const std::bad_alloc &fault) {
+        (void)fault;
+        this->queue_->FreeStruct(request);
+        errno = ENOMEM;
+        this->AbortUringAccepts(-1);
+        return;
+    }
+    this->acceptRequest_ = request;
+}
+
+void sharpen::PosixNetStreamChannel::DeliverUringChunks() {
+    while (!this->uringReads_.empty() && !this->uringChunks_.empty()) {
+        UringTask task{std::move(this->uringReads_.front())};
+        this->uringReads_.pop_front();
+        std::size_t size{0};
+        while (size != task.bufSize_ && !this->uringChunks_.empty()) {
+            UringChunk &chunk{this->uringChunks_.front()};
+            std::size_t sz{(std::min)(task.bufSize_ - size, chunk.size_ - chunk.offset_)};
+            std::memcpy(
+                task.buf_ + size, this->queue_->GetRecvBuffer(chunk.bid_) + chunk.offset_, sz);
+            size += sz;
+            chunk.offset_ += sz;
+            if (chunk.offset_ == chunk.size_) {
+                this->queue_->ReleaseRecvBuffer(chunk.bid_);
+                this->uringChunks_.pop_front();
+            }
+        }
+        task.cb_(static_cast<ssize_t>(size));
+    }
+    if (!this->recvEnd_ || !this->uringChunks_.empty()) {
+        return;
+    }
+    // the stream has been drained
+    while (!this->uringReads_.empty()) {
+        UringTask task{std::move(this->uringReads_.front())};
+        this->uringReads_.pop_front();
+        if (this->recvError_) {
+            errno = this->recvError_;
+            task.cb_(-1);
+            continue;
+        }
+        task.cb_(0);
+    }
+}
+
+void sharpen::PosixNetStreamChannel::AbortUringReads(ssize_t size) {
+    (void)size;
+    sharpen::ErrorCode err{sharpen::GetLastError()};
+    UringTasks tasks;
+    std::swap(tasks, this->uringReads_);
+    for (auto begin = tasks.begin(), end = tasks.end(); begin != end; ++begin) {
+        errno = err;
+        begin->cb_(-1);
+    }
+}
+
+void sharpen::PosixNetStreamChannel::AbortUringAccepts(ssize_t size) {
+    (void)size;
+    sharpen::ErrorCode err{sharpen::GetLastError()};
+    AcceptCallbacks cbs;
+    std::swap(cbs, this->uringAccepts_);
+    for (auto begin = cbs.begin(), end = cbs.end(); begin != end; ++begin) {
+        errno = err;
+        (*begin)(-1);
+    }
+}
+
+void sharpen::PosixNetStreamChannel::HandleUringRecv(sharpen::IoUringStruct *request) {
+    bool finished{false};
+    for (auto begin = request->results_.begin(), end = request->results_.end(); begin != end;
+         ++begin) {
+        if (begin->flags & IORING_CQE_F_BUFFER) {
+            std::uint16_t bid{static_cast<std::uint16_t>(begin->flags >> IORING_CQE_BUFFER_SHIFT)};
+            if (begin->res > 0) {
+                this->uringChunks_.push_back(
+                    UringChunk{bid, static_cast<std::size_t>(begin->res), 0});
+            } else {
+                this->queue_->ReleaseRecvBuffer(bid);
+            }
+        }
+        if (!begin->res) {
+            this->recvEnd_ = true;
+        } else if (begin->res < 0) {
+            sharpen::ErrorCode err{-begin->res};
+            if (err == ENOBUFS) {
+                this->recvNoBuffer_ = true;
+            } else if (err == EINVAL) {
+                // multishot recv requires linux 6.0
+                this->queue_->DisableMultishotRecv();
+            } else if (err != ECANCELED) {
+                this->recvEnd_ = true;
+                this->recvError_ = err;
+            }
+        }
+        if (!(begin->flags & IORING_CQE_F_MORE)) {
+            finished = true;
+        }
+    }
+    request->results_.clear();
+    if (finished) {
+        this->queue_->FreeStruct(request);
+        this->recvRequest_ = nullptr;
+        this->recvCanceled_ = false;
+    } else if (!this->recvCanceled_ && this->uringChunks_.size() >= maxUringChunks_) {
+        // stop receiving until the data is read
+        this->recvCanceled_ = Self::CancelUringRequest(this->queue_, request);
+    }
+    this->SubmitUringRead();
+}
+
+void sharpen::PosixNetStreamChannel::HandleUringAccept(sharpen::IoUringStruct *request) {
+    bool finished{false};
+    for (auto begin = request->results_.begin(), end = request->results_.end(); begin != end;
+         ++begin) {
+        if (begin->res >= 0) {
+            sharpen::FileHandle handle{begin->res};
+            if (this->uringAccepts_.empty()) {
+                this->acceptedHandles_.push_back(handle);
+            } else {
+                AcceptCallback cb{std::move(this->uringAccepts_.front())};
+                this->uringAccepts_.pop_front();
+                cb(handle);
+            }
+        } else if (-begin->res != ECANCELED && !this->uringAccepts_.empty()) {
+            AcceptCallback cb{std::move(this->uringAccepts_.front())};
+            this->uringAccepts_.pop_front();
+            errno = -begin->res;
+            cb(-1);
+        }
+        if (!(begin->flags & IORING_CQE_F_MORE)) {
+            finished = true;
+        }
+    }
+    request->results_.clear();
+    if (finished) {
+        this->queue_->FreeStruct(request);
+        this->acceptRequest_ = nullptr;
+        this->acceptCanceled_ = false;
+    } else if (!this->acceptCanceled_ && this->acceptedHandles_.size() >= maxAcceptedHandles_) {
+        // leave connections in the backlog
+        this->acceptCanceled_ = Self::CancelUringRequest(this->queue_, request);
+    }
+    if (!this->uringAccepts_.empty() && !this->acceptRequest_) {
+        this->ArmUringAccept();
+    }
+}
+
+void sharpen::PosixNetStreamChannel::HandleUringEvent(sharpen::IoEvent *event) {
+    sharpen::IoUringStruct *st{reinterpret_cast<sharpen::IoUringStruct *>(event->GetData())};
+    if (st->multishot_) {
+        if (st == this->recvRequest_) {
+            this->HandleUringRecv(st);
+        } else {
+            assert(st == this->acceptRequest_);
+            this->HandleUringAccept(st);
+        }
+        return;
+    }
+    std::unique_ptr<UringRequest> request{static_cast<UringRequest *>(st)};
+    auto ite = std::find(this->uringRequests_.begin(), this->uringRequests_.end(), request.get());
+    assert(ite != this->uringRequests_.end());
+    this->uringRequests_.erase(ite);
+    ssize_t size{static_cast<ssize_t>(request->length_)};
+    if (event->IsErrorEvent()) {
+        size = -1;
+        errno = event->GetErrorCode();
+    }
+    Callback cb{std::move(request->cb_)};
+    cb(size);
+    if (event->IsReadEvent()) {
+        this->uringReading_ = false;
+        this->SubmitUringRead();
+    } else if (event->IsWriteEvent()) {
+        this->uringWriting_ = false;
+        this->SubmitUringWrite();
+    }
+}
+
+void sharpen::PosixNetStreamChannel::CancelUringRequests(sharpen::ErrorCode err) noexcept {
+    if (!this->queue_) {
+        return;
+    }
+    // tasks which have not been submitted
+    UringTasks tasks;
+    std::swap(tasks, this->uringReads_);
+    for (auto begin = tasks.begin(), end = tasks.end(); begin != end; ++begin) {
+        errno = err;
+        begin->cb_(-1);
+    }
+    tasks.clear();
+    std::swap(tasks, this->uringWrites_);
+    for (auto begin = tasks.begin(), end = tasks.end(); begin != end; ++begin) {
+        errno = err;
+        if (begin->file_) {
+            Self::CompleteSendFile(*begin->file_, -1);
+            continue;
+        }
+        begin->cb_(-1);
+    }
+    AcceptCallbacks cbs;
+    std::swap(cbs, this->uringAccepts_);
+    for (auto begin = cbs.begin(), end = cbs.end(); begin != end; ++begin) {
+        errno = err;
+        (*begin)(-1);
+    }
+    // submitted requests complete with ECANCELED
+    if (this->recvRequest_ && !this->recvCanceled_) {
+        this->recvCanceled_ = Self::CancelUringRequest(this->queue_, this->recvRequest_);
+    }
+    if (this->acceptRequest_ && !this->acceptCanceled_) {
+        this->acceptCanceled_ = Self::CancelUringRequest(this->queue_, this->acceptRequest_);
+    }
+    for (auto begin = this->uringRequests_.begin(), end = this->uringRequests_.end();
+         begin != end;
+         ++begin) {
+        if (!Self::CancelUringRequest(this->queue_, *begin)) {
+            // requests left will be canceled by next cancellation
+            break;
+        }
+    }
+}
+
+bool sharpen::PosixNetStreamChannel::CancelUringRequest(sharpen::IoUringQueue *queue,
+                                                        sharpen::IoUringStruct *request) noexcept {
+    assert(queue);
+    struct io_uring_sqe sqe;
+    std::memset(&sqe, 0, sizeof(sqe));
+    sqe.opcode = IORING_OP_ASYNC_CANCEL;
+    sqe.fd = -1;
+    sqe.addr = reinterpret_cast<std::uint64_t>(request);
+    // no user data
+    // the cqe of cancellation will be ignored by selector
+    sqe.user_data = 0;
+    try {
+        queue->SubmitIoRequest(sqe);
+    } catch (const std::bad_alloc &fault) {
+        (void)fault;
+        return false;
+    }
+    return true;
+}
+
+void sharpen::PosixNetStreamChannel::ReleaseUringOrphan(sharpen::IoUringQueue *queue,
+                                                        sharpen::IoUringStruct *request) noexcept {
+    // the results are dropped by loop because the channel has been released
+    bool finished{false};
+    for (auto begin = request->results_.begin(), end = request->results_.end(); begin != end;
+         ++begin) {
+        queue->DropMultishotResult(*request, *begin);
+        if (!(begin->flags & IORING_CQE_F_MORE)) {
+            finished = true;
+        }
+    }
+    request->results_.clear();
+    if (finished) {
+        queue->FreeStruct(request);
+        return;
+    }
+    // the selector releases the request when it finishes
+    request->orphan_ = true;
+    Self::CancelUringRequest(queue, request);
+}
+
+void sharpen::PosixNetStreamChannel::ReleaseUringResources() noexcept {
+    if (!this->queue_) {
+        return;
+    }
+    sharpen::IoUringStruct *requests[2]{this->recvRequest_, this->acceptRequest_};
+    this->recvRequest_ = nullptr;
+    this->acceptRequest_ = nullptr;
+    bool inLoop{sharpen::EventLoop::GetLocalLoop() == this->loop_};
+    for (sharpen::IoUringStruct *request : requests) {
+        if (!request) {
+            continue;
+        }
+        if (inLoop) {
+            Self::ReleaseUringOrphan(this->queue_, request);
+            continue;
+        }
+        try {
+            this->loop_->RunInLoopSoon(std::bind(&Self::ReleaseUringOrphan, this->queue_, request));
+        } catch (const std::bad_alloc &fault) {
+            (void)fault;
+        }
+    }
+    if (inLoop && (requests[0] || requests[1])) {
+        // the socket is held by requests until they are canceled
+        // cancel them now so that the address could be bound again
+        try {
+            this->queue_->Flush();
+        } catch (const std::exception &ignore) {
+            (void)ignore;
+        }
+    }
+    for (auto begin = this->uringChunks_.begin(), end = this->uringChunks_.end(); begin != end;
+         ++begin) {
+        this->queue_->ReleaseRecvBuffer(begin->bid_);
+    }
+    this->uringChunks_.clear();
+    for (auto begin = this->acceptedHandles_.begin(), end = this->acceptedHandles_.end();
+         begin != end;
+         ++begin) {
+        sharpen::CloseFileHandle(*begin);
+    }
+    this->acceptedHandles_.clear();
+}
+
+void sharpen::PosixNetStreamChannel::InvokeAcceptCallback(AcceptCallback cb, ssize_t size) {
+    cb(static_cast<sharpen::FileHandle>(size));
+}
+
+void sharpen::PosixNetStreamChannel::InvokeConnectCallback(ConnectCallback cb, ssize_t size) {
+    if (size != -1) {
+        errno = 0;
+    }
+    cb();
+}
+#endif
+
+#endif
@@ -2,6 +2,7 @@
 
 #include <sharpen/BufferReader.hpp>
 #include <sharpen/BufferWriter.hpp>
+#include <sharpen/CorruptedDataError.hpp>
 #include <sharpen/LogEntries.hpp>
 #include <sharpen/SingleWorkerGroup.hpp>
 #include <sharpen/SystemError.hpp>
@@ -42,12 +43,20 @@ sharpen::RaftConsensus::RaftConsensus(
     , waiter_(nullptr)
     , advancedCount_(0)
     , reachAdvancedCount_(0)
+    , pendingReads_()
+    , confirmingReads_()
+    , applyingReads_()
+    , readLeaseDeadline_()
     , mailBuilder_(nullptr)
     , mailExtractor_(nullptr)
     , peers_(nullptr)
     , peersBroadcaster_(nullptr)
     , heartbeatProvider_(nullptr)
     , learners_()
+    , learnSource_(sharpen::EmptyOpt)
+    , learnSnapshotIndex_(sharpen::ILogStorage::noneIndex)
+    , learnPending_(false)
+    , learnWaits_(0)
     , changeable_(false)
     , newPeersVotes_()
     , peersConfig_()
@@ -121,6 +130,7 @@ void sharpen::RaftConsensus::DoNotifyWaiterWhenClose() noexcept {
     if (waiter != nullptr) {
         this->NotifyWaiter(waiter);
     }
+    this->FailReads();
 }
 
 sharpen::RaftConsensus::~RaftConsensus() noexcept {
@@ -381,6 +391,11 @@ void sharpen::RaftConsensus::EnsureHearbeatProvider() {
             throw std::bad_alloc{};
         }
         this->heartbeatProvider_.reset(provider);
+        if (this->option_.IsEnablePipelinedReplication()) {
+            std::size_t window{this->option_.GetBatchSize()};
+            window *= this->option_.GetPipelineLength();
+            this->heartbeatProvider_->SetInflightWindow(window);
+        }
         // set commit index
         this->LoadCommitIndex();
     }
@@ -424,6 +439,10 @@ void sharpen::RaftConsensus::EnsureBroadcaster() {
         assert(this->peers_ != nullptr);
         this->peersBroadcaster_ =
             this->peers_->CreateBroadcaster(this->option_.GetPipelineLength());
+        // snapshot chunks keep the pipelines full between rounds
+        if (this->option_.IsEnablePipelinedReplication() || this->snapshotController_) {
+            this->peersBroadcaster_->SetStallLimit(Self::pipelineStallLimit_);
+        }
     }
 }
 
@@ -652,6 +671,50 @@ sharpen::Mail sharpen::RaftConsensus::OnHeartbeatRequest(
     return mail;
 }
 
+bool sharpen::RaftConsensus::InstallSnapshotChunk(const sharpen::RaftSnapshotMetadata &metadata,
+                                                  std::uint64_t offset,
+                                                  const sharpen::ByteBuffer &data,
+                                                  bool last) {
+    sharpen::IRaftSnapshotInstaller &installer{this->GetSnapshotInstaller()};
+    sharpen::Optional<sharpen::RaftSnapshotMetadata> metadataOpt{installer.GetLastMetadata()};
+    if (metadataOpt.Exist() &&
+        metadataOpt.Get().GetLastIndex() >= metadata.GetLastIndex()) {
+        // the snapshot has been installed
+        return true;
+    }
+    // the leader starts a new transfer
+    if (offset == 0 && installer.GetExpectedOffset() != 0) {
+        installer.Reset();
+    }
+    std::uint64_t expectedOffset{installer.GetExpectedOffset()};
+    if (offset < expectedOffset) {
+        // the chunk is resent by the leader
+        return true;
+    }
+    if (offset != expectedOffset) {
+        // some chunks have been lost
+        // the leader resends them from expected offset
+        return false;
+    }
+    // write snapshot chunk
+    installer.Write(offset, data);
+    if (last) {
+        // if this chunk is last one
+        // install snapshot(could be asynchronous)
+        try {
+            installer.Install(metadata);
+        } catch (const sharpen::CorruptedDataError &error) {
+            // the leader sends the snapshot again
+            (void)error;
+            installer.Reset();
+            return false;
+        }
+        // set commit index to last index of snapshot
+        this->SetCommitIndex(metadata.GetLastIndex());
+    }
+    return true;
+}
+
 sharpen::Mail sharpen::RaftConsensus::OnSnapshotRequest(
     const sharpen::RaftSnapshotRequest &request) {
     assert(this->mailBuilder_ != nullptr);
@@ -676,26 +739,20 @@ sharpen::Mail sharpen::RaftConsensus::OnSnapshotRequest(
         }
         // if enable snapshot
         // request.term is up-to-date
-        // check offset
         if (this->snapshotController_ && this->GetTerm() == request.GetTerm() &&
-            this->role_ != sharpen::RaftRole::Leader &&
-            this->GetSnapshotInstaller().GetExpectedOffset() == request.GetOffset()) {
-            // write snapshot chunk
-            this->GetSnapshotInstaller().Write(request.GetOffset(), request.Data());
-            if (request.IsLast()) {
-                // if this chunk is last one
-                // install snapshot(could be asynchronous)
-                this->GetSnapshotInstaller().Install(request.Metadata());
-                // set commit index to last index of snapshot
-                this->SetCommitIndex(request.Metadata().GetLastIndex());
-            }
-            response.SetStatus(true);
-            // flush leader id if we need
-            if (leaderRecord.GetEpoch() < request.GetTerm()) {
-                this->leaderRecord_.Flush(request.GetTerm(), request.LeaderActorId());
+            this->role_ != sharpen::RaftRole::Leader) {
+            bool accepted{this->InstallSnapshotChunk(
+                request.Metadata(), request.GetOffset(), request.Data(), request.IsLast())};
+            response.SetStatus(accepted);
+            response.SetOffset(this->GetSnapshotInstaller().GetExpectedOffset());
+            if (accepted) {
+                // flush leader id if we need
+                if (leaderRecord.GetEpoch() < request.GetTerm()) {
+                    this->leaderRecord_.Flush(request.GetTerm(), request.LeaderActorId());
+                }
+                this->OnStatusChanged({sharpen::ConsensusResultEnum::SnapshotReceived,
+                                       sharpen::ConsensusResultEnum::LeaseRequested});
             }
-            this->OnStatusChanged({sharpen::ConsensusResultEnum::SnapshotReceived,
-                                   sharpen::ConsensusResultEnum::LeaseRequested});
         }
     }
     sharpen::Mail mail{this->mailBuilder_->BuildSnapshotResponse(response)};
@@ -746,6 +803,10 @@ void sharpen::RaftConsensus::StepDown() {
             if (this->leaderCount_) {
                 this->leaderCount_->StepDown();
             }
+            // ignore the acks of in-flight round
+            this->leaseStatus_.NextRound();
+            this->readLeaseDeadline_ = std::chrono::steady_clock::time_point{};
+            this->FailReads();
             this->OnStatusChanged({sharpen::ConsensusResultEnum::StatusChanged});
         }
     }
@@ -827,11 +888,11 @@ void sharpen::RaftConsensus::OnHeartbeatResponse(const sharpen::RaftHeartbeatRes
         this->StepDown();
         // if term <= current term
         // lease should be confirmed
-    } else if (this->option_.IsEnableLeaseAwareness() &&
-               response.GetLeaseRound() == this->leaseStatus_.GetRound()) {
+    } else if (response.GetLeaseRound() == this->leaseStatus_.GetRound()) {
         this->leaseStatus_.OnAck();
         if (this->leaseStatus_.GetAckCount() == this->peers_->GetMajority()) {
-            leaseConfirmed = true;
+            this->OnReadRoundConfirmed();
+            leaseConfirmed = this->option_.IsEnableLeaseAwareness();
         }
     }
     if (response.GetStatus() && response.GetTerm() == this->GetTerm()) {
@@ -880,16 +941,322 @@ void sharpen::RaftConsensus::OnSnapshotResponse(const sharpen::RaftSnapshotRespo
         assert(!response.GetStatus());
         this->SetTerm(response.GetTerm());
         this->StepDown();
-    } else if (this->option_.IsEnableLeaseAwareness() &&
-               response.GetLeaseRound() == this->leaseStatus_.GetRound()) {
+        return;
+    }
+    if (response.GetLeaseRound() == this->leaseStatus_.GetRound()) {
         this->leaseStatus_.OnAck();
         if (this->leaseStatus_.GetAckCount() == this->peers_->GetMajority()) {
-            this->OnStatusChanged({sharpen::ConsensusResultEnum::LeaseConfirmed});
+            this->OnReadRoundConfirmed();
+            if (this->option_.IsEnableLeaseAwareness()) {
+                this->OnStatusChanged({sharpen::ConsensusResultEnum::LeaseConfirmed});
+            }
         }
     }
-    // nothing we can do
-    (void)response;
-    (void)actorId;
+    if (this->role_ != sharpen::RaftRole::Leader || response.GetTerm() != this->GetTerm()) {
+        return;
+    }
+    if (!response.GetStatus()) {
+        // resend the chunks from the offset expected by follower
+        this->heartbeatProvider_->BackwardSnapshot(actorId, response.GetOffset());
+    }
+    this->StreamSnapshot(actorId);
+}
+
+void sharpen::RaftConsensus::StreamSnapshot(const sharpen::ActorId &actorId) {
+    if (!this->peersBroadcaster_) {
+        return;
+    }
+    // fill the pipeline of the actor
+    // instead of sending one chunk per round
+    while (this->heartbeatProvider_->IsTransferringSnapshot(actorId) &&
+           this->peersBroadcaster_->Writable(actorId)) {
+        sharpen::Mail mail{this->heartbeatProvider_->ProvideSnapshotChunk(actorId)};
+        if (!this->peersBroadcaster_->Post(actorId, std::move(mail))) {
+            break;
+        }
+    }
+}
+
+void sharpen::RaftConsensus::NextLearnSource() {
+    assert(this->peers_ != nullptr);
+    std::set<sharpen::ActorId> actors{this->peers_->GenerateActorsSet()};
+    sharpen::ConsensusWriter leaderRecord{this->leaderRecord_.GetRecord()};
+    // begin with the peer after current source
+    auto ite = actors.begin();
+    if (this->learnSource_.Exist()) {
+        ite = actors.upper_bound(this->learnSource_.Get());
+    }
+    this->learnSource_.Reset();
+    this->learnPending_ = false;
+    this->learnWaits_ = 0;
+    // the snapshot is learned from the beginning
+    this->learnSnapshotIndex_ = sharpen::ILogStorage::noneIndex;
+    for (std::size_t i = 0; i != actors.size(); ++i, ++ite) {
+        if (ite == actors.end()) {
+            ite = actors.begin();
+        }
+        // skip the leader, it refuses to serve learners
+        if (leaderRecord.GetEpoch() != sharpen::ConsensusWriter::noneEpoch &&
+            leaderRecord.WriterId() == *ite) {
+            continue;
+        }
+        this->learnSource_.Construct(*ite);
+        return;
+    }
+}
+
+void sharpen::RaftConsensus::RaiseLearning() {
+    assert(this->peersBroadcaster_ != nullptr);
+    if (!this->learnSource_.Exist()) {
+        this->NextLearnSource();
+    } else if (this->learnPending_) {
+        // the source is still answering
+        this->learnWaits_ += 1;
+        if (this->learnWaits_ < learnTimeoutRounds_) {
+            return;
+        }
+        // the request was lost
+        this->NextLearnSource();
+    }
+    if (!this->learnSource_.Exist() ||
+        !this->peersBroadcaster_->Writable(this->learnSource_.Get())) {
+        return;
+    }
+    sharpen::ActorId source{this->learnSource_.Get()};
+    if (this->learnSnapshotIndex_ != sharpen::ILogStorage::noneIndex) {
+        this->RequestLearnSnapshot(source);
+    } else {
+        this->RequestLearnLogs(source);
+    }
+}
+
+void sharpen::RaftConsensus::RequestLearnLogs(const sharpen::ActorId &actorId) {
+    assert(this->mailBuilder_ != nullptr);
+    assert(this->peersBroadcaster_ != nullptr);
+    sharpen::RaftLearnLogsRequest request;
+    request.SetTerm(this->GetTerm());
+    // the logs after commit index may be replaced
+    request.SetBeginIndex(this->GetCommitIndex() + 1);
+    request.SetBatchSize(this->option_.GetBatchSize());
+    sharpen::Mail mail{this->mailBuilder_->BuildLearnLogsRequest(request)};
+    if (this->peersBroadcaster_->Post(actorId, std::move(mail)) && this->learnSource_.Exist() &&
+        this->learnSource_.Get() == actorId) {
+        this->learnPending_ = true;
+        this->learnWaits_ = 0;
+    }
+}
+
+void sharpen::RaftConsensus::RequestLearnSnapshot(const sharpen::ActorId &actorId) {
+    assert(this->mailBuilder_ != nullptr);
+    assert(this->peersBroadcaster_ != nullptr);
+    sharpen::RaftLearnSnapshotRequest request;
+    request.SetTerm(this->GetTerm());
+    request.SetLastIndex(this->learnSnapshotIndex_);
+    request.SetOffset(this->GetSnapshotInstaller().GetExpectedOffset());
+    sharpen::Mail mail{this->mailBuilder_->BuildLearnSnapshotRequest(request)};
+    if (this->peersBroadcaster_->Post(actorId, std::move(mail)) && this->learnSource_.Exist() &&
+        this->learnSource_.Get() == actorId) {
+        this->learnPending_ = true;
+        this->learnWaits_ = 0;
+    }
+}
+
+sharpen::Mail sharpen::RaftConsensus::OnLearnLogsRequest(
+    const sharpen::RaftLearnLogsRequest &request) {
+    assert(this->mailBuilder_ != nullptr);
+    assert(this->logs_ != nullptr);
+    sharpen::RaftLearnLogsResponse response;
+    response.SetTerm(this->GetTerm());
+    response.SetBeginIndex(request.GetBeginIndex());
+    // the leader keeps its bandwidth for new entries
+    if (this->role_ == sharpen::RaftRole::Follower &&
+        request.GetBeginIndex() != sharpen::ILogStorage::noneIndex) {
+        response.SetStatus(true);
+        std::uint64_t commitIndex{this->GetCommitIndex()};
+        response.SetCommitIndex(commitIndex);
+        if (this->snapshotController_) {
+            sharpen::Optional<sharpen::RaftSnapshotMetadata> metadataOpt{
+                this->GetSnapshotInstaller().GetLastMetadata()};
+            if (metadataOpt.Exist()) {
+                response.SetSnapshotIndex(metadataOpt.Get().GetLastIndex());
+            }
+        }
+        // only committed entries are served
+        // so that the logs of learner never conflict with the leader
+        std::uint64_t index{request.GetBeginIndex()};
+        for (std::uint64_t i = 0; i != request.GetBatchSize() && index <= commitIndex;
+             ++i, ++index) {
+            sharpen::Optional<sharpen::ByteBuffer> entry{this->logs_->Lookup(index)};
+            if (!entry.Exist()) {
+                // the entry has been compacted
+                break;
+            }
+            response.Entries().Push(std::move(entry.Get()));
+        }
+    }
+    sharpen::Mail mail{this->mailBuilder_->BuildLearnLogsResponse(response)};
+    return mail;
+}
+
+void sharpen::RaftConsensus::OnLearnLogsResponse(const sharpen::RaftLearnLogsResponse &response,
+                                                 const sharpen::ActorId &actorId) {
+    assert(this->logs_ != nullptr);
+    assert(this->logAccesser_ != nullptr);
+    if (this->role_ != sharpen::RaftRole::Learner) {
+        return;
+    }
+    bool fromSource{this->learnSource_.Exist() && this->learnSource_.Get() == actorId};
+    if (fromSource) {
+        this->learnPending_ = false;
+    }
+    if (response.GetTerm() > this->GetTerm()) {
+        this->SetTerm(response.GetTerm());
+    }
+    if (!response.GetStatus()) {
+        // the peer refuses to serve learners
+        if (fromSource) {
+            this->NextLearnSource();
+        }
+        return;
+    }
+    std::uint64_t commitIndex{this->GetCommitIndex()};
+    if (response.GetBeginIndex() != commitIndex + 1) {
+        // the response of an outdated request
+        return;
+    }
+    if (response.Entries().Empty()) {
+        // the logs have been compacted into snapshot
+        if (fromSource && this->snapshotController_ &&
+            response.GetSnapshotIndex() >= commitIndex + 1) {
+            sharpen::IRaftSnapshotInstaller &installer{this->GetSnapshotInstaller()};
+            if (installer.GetExpectedOffset() != 0) {
+                installer.Reset();
+            }
+            this->learnSnapshotIndex_ = response.GetSnapshotIndex();
+            this->RequestLearnSnapshot(actorId);
+        }
+        return;
+    }
+    for (std::size_t i = 0; i != response.Entries().GetSize(); ++i) {
+        if (!this->logAccesser_->IsRaftEntry(response.Entries().Get(i))) {
+            return;
+        }
+    }
+    // the entries after commit index have not been committed
+    // replace them with the committed entries
+    if (this->logs_->GetLastIndex() > commitIndex) {
+        sharpen::AwaitableFuture<void> future;
+        this->logWorker_->InvokeUrgent(
+            future, &sharpen::ILogStorage::TruncateFrom, this->logs_.get(), commitIndex + 1);
+        future.Await();
+    }
+    {
+        sharpen::LogEntries entries{response.Entries()};
+        sharpen::AwaitableFuture<void> future;
+        this->logWorker_->InvokeUrgent(future,
+                                       &sharpen::ILogStorage::WriteBatch,
+                                       this->logs_.get(),
+                                       commitIndex + 1,
+                                       std::move(entries));
+        future.Await();
+    }
+    std::uint64_t lastIndex{commitIndex + response.Entries().GetSize()};
+    this->SetCommitIndex(lastIndex);
+    this->OnStatusChanged({sharpen::ConsensusResultEnum::LogsCommit});
+    // keep pulling until we catch up with the peer
+    // the late response of a previous source is not chained
+    if (fromSource && response.GetCommitIndex() > lastIndex) {
+        this->RequestLearnLogs(actorId);
+    }
+}
+
+sharpen::Mail sharpen::RaftConsensus::OnLearnSnapshotRequest(
+    const sharpen::RaftLearnSnapshotRequest &request) {
+    assert(this->mailBuilder_ != nullptr);
+    sharpen::RaftLearnSnapshotResponse response;
+    response.SetTerm(this->GetTerm());
+    if (this->role_ == sharpen::RaftRole::Follower && this->snapshotController_ &&
+        this->GetSnapshotInstaller().GetLastMetadata().Exist()) {
+        sharpen::RaftSnapshot snapshot{this->GetSnapshotProvider().GetSnapshot()};
+        std::unique_ptr<sharpen::IRaftSnapshotChunk> chunk{snapshot.ReleaseChainedChunks()};
+        // forward to the offset expected by learner
+        // restart from the beginning if the snapshot has changed
+        if (request.GetLastIndex() == snapshot.Metadata().GetLastIndex()) {
+            while (chunk->GetOffset() < request.GetOffset() && chunk->Forwardable()) {
+                chunk->Forward();
+            }
+            if (chunk->GetOffset() != request.GetOffset()) {
+                chunk = this->GetSnapshotProvider().GetSnapshot().ReleaseChainedChunks();
+            }
+        }
+        response.SetStatus(true);
+        response.SetOffset(chunk->GetOffset());
+        response.SetLast(!chunk->Forwardable());
+        response.Data() = chunk->GenerateChunkData();
+        response.Metadata() = std::move(snapshot.Metadata());
+    }
+    sharpen::Mail mail{this->mailBuilder_->BuildLearnSnapshotResponse(response)};
+    return mail;
+}
+
+void sharpen::RaftConsensus::OnLearnSnapshotResponse(
+    const sharpen::RaftLearnSnapshotResponse &response, const sharpen::ActorId &actorId) {
+    if (this->role_ != sharpen::RaftRole::Learner || !this->snapshotController_) {
+        return;
+    }
+    bool fromSource{this->learnSource_.Exist() && this->learnSource_.Get() == actorId};
+    if (fromSource) {
+        this->learnPending_ = false;
+    }
+    if (response.GetTerm() > this->GetTerm()) {
+        this->SetTerm(response.GetTerm());
+    }
+    if (!response.GetStatus()) {
+        // the peer refuses to serve learners
+        this->learnSnapshotIndex_ = sharpen::ILogStorage::noneIndex;
+        if (fromSource) {
+            this->NextLearnSource();
+        }
+        return;
+    }
+    const sharpen::RaftSnapshotMetadata &metadata{response.Metadata()};
+    if (metadata.GetLastIndex() <= this->GetCommitIndex()) {
+        // we have learned it
+        this->learnSnapshotIndex_ = sharpen::ILogStorage::noneIndex;
+        return;
+    }
+    sharpen::IRaftSnapshotInstaller &installer{this->GetSnapshotInstaller()};
+    if (metadata.GetLastIndex() != this->learnSnapshotIndex_) {
+        // the snapshot of peer has changed
+        if (response.GetOffset() != 0) {
+            return;
+        }
+        if (installer.GetExpectedOffset() != 0) {
+            installer.Reset();
+        }
+        this->learnSnapshotIndex_ = metadata.GetLastIndex();
+    }
+    if (response.GetOffset() != installer.GetExpectedOffset()) {
+        // the response of an outdated request
+        return;
+    }
+    if (!this->InstallSnapshotChunk(
+            metadata, response.GetOffset(), response.Data(), response.IsLast())) {
+        // the snapshot is corrupted
+        // learn it again in next round
+        return;
+    }
+    if (response.IsLast()) {
+        this->learnSnapshotIndex_ = sharpen::ILogStorage::noneIndex;
+        this->OnStatusChanged({sharpen::ConsensusResultEnum::SnapshotReceived});
+        if (fromSource) {
+            this->RequestLearnLogs(actorId);
+        }
+        return;
+    }
+    if (fromSource) {
+        this->RequestLearnSnapshot(actorId);
+    }
 }
 
 sharpen::Mail sharpen::RaftConsensus::DoGenerateResponse(sharpen::Mail request) {
@@ -928,6 +1295,20 @@ sharpen::Mail sharpen::RaftConsensus::DoGenerateResponse(sharpen::Mail request)
             response = this->OnSnapshotRequest(requestOpt.Get());
         }
     } break;
+    case sharpen::RaftMailType::LearnLogsRequest: {
+        sharpen::Optional<sharpen::RaftLearnLogsRequest> requestOpt{
+            this->mailExtractor_->ExtractLearnLogsRequest(request)};
+        if (requestOpt.Exist()) {
+            response = this->OnLearnLogsRequest(requestOpt.Get());
+        }
+    } break;
+    case sharpen::RaftMailType::LearnSnapshotRequest: {
+        sharpen::Optional<sharpen::RaftLearnSnapshotRequest> requestOpt{
+            this->mailExtractor_->ExtractLearnSnapshotRequest(request)};
+        if (requestOpt.Exist()) {
+            response = this->OnLearnSnapshotRequest(requestOpt.Get());
+        }
+    } break;
     default:
         // do nothing
         break;
@@ -967,6 +1348,20 @@ void sharpen::RaftConsensus::DoReceive(sharpen::Mail mail, sharpen::ActorId acto
             this->OnSnapshotResponse(responseOpt.Get(), actorId);
         }
     } break;
+    case sharpen::RaftMailType::LearnLogsResponse: {
+        sharpen::Optional<sharpen::RaftLearnLogsResponse> responseOpt{
+            this->mailExtractor_->ExtractLearnLogsResponse(mail)};
+        if (responseOpt.Exist()) {
+            this->OnLearnLogsResponse(responseOpt.Get(), actorId);
+        }
+    } break;
+    case sharpen::RaftMailType::LearnSnapshotResponse: {
+        sharpen::Optional<sharpen::RaftLearnSnapshotResponse> responseOpt{
+            this->mailExtractor_->ExtractLearnSnapshotResponse(mail)};
+        if (responseOpt.Exist()) {
+            this->OnLearnSnapshotResponse(responseOpt.Get(), actorId);
+        }
+    } break;
     default:
         // do nothing
         break;
@@ -1061,21 +1456,29 @@ void sharpen::RaftConsensus::DoAdvance() {
     case sharpen::RaftRole::Leader: {
         this->DoSyncHeartbeatProvider();
         this->heartbeatProvider_->PrepareTerm(this->GetTerm());
-        if (this->option_.IsEnableLeaseAwareness()) {
-            this->leaseStatus_.NextRound();
-            this->heartbeatProvider_->PrepareRound(this->leaseStatus_.GetRound());
-        }
+        // rounds are also used to confirm reads
+        this->leaseStatus_.NextRound();
+        this->heartbeatProvider_->PrepareRound(this->leaseStatus_.GetRound());
+        // pending reads ride on this round
+        this->confirmingReads_.insert(this->confirmingReads_.end(),
+                                      this->pendingReads_.begin(),
+                                      this->pendingReads_.end());
+        this->pendingReads_.clear();
         this->newPeersVotes_.clear();
         if (!this->heartbeatProvider_->Empty()) {
             sharpen::Optional<std::uint64_t> syncIndex{
                 this->heartbeatProvider_->GetSynchronizedIndex()};
-            if (syncIndex.Exist()) {
+            // shared mail cancels the followers with full pipeline
+            bool shareable{!this->option_.IsEnablePipelinedReplication() ||
+                           !this->peersBroadcaster_->Saturated()};
+            if (syncIndex.Exist() && shareable) {
                 sharpen::Mail mail{this->heartbeatProvider_->ProvideSynchronizedMail()};
                 this->peersBroadcaster_->Broadcast(std::move(mail));
             } else {
                 this->peersBroadcaster_->Broadcast(*this->heartbeatProvider_);
             }
         } else if (this->option_.IsEnableSingle()) {
+            this->OnReadRoundConfirmed();
             std::uint64_t commitIndex{this->GetCommitIndex()};
             std::uint64_t lastIndex{this->GetLastIndex()};
             if (commitIndex != lastIndex) {
@@ -1111,9 +1514,13 @@ void sharpen::RaftConsensus::DoAdvance() {
         }
         break;
     }
-    case sharpen::RaftRole::Learner:
-        // do nothing
+    case sharpen::RaftRole::Learner: {
+        // pull logs from followers
+        if (!this->peers_->Empty()) {
+            this->RaiseLearning();
+        }
         break;
+    }
     default:
         // unkown role
         // do nothing
@@ -1343,7 +1750,9 @@ std::uint64_t sharpen::RaftConsensus::GetEpoch() const noexcept {
 void sharpen::RaftConsensus::DoStoreLastAppliedIndex(std::uint64_t index) {
     assert(this->statusMap_ != nullptr);
     this->EnsureHearbeatProvider();
-    if (this->GetCommitIndex() > index) {
+    // the entry of commit index could be applied
+    if (this->GetCommitIndex() >= index) {
+        std::uint64_t appliedIndex{index};
 #ifdef SHARPEN_IS_BIG_ENDIAN
         sharpen::ConvertEndian(index);
 #endif
@@ -1351,7 +1760,8 @@ void sharpen::RaftConsensus::DoStoreLastAppliedIndex(std::uint64_t index) {
         val.As<std::uint64_t>() = index;
         sharpen::ByteBuffer key{lastAppliedKey};
         this->statusMap_->Write(std::move(key), std::move(val));
-        this->appliedIndex_ = index;
+        this->appliedIndex_ = appliedIndex;
+        this->CompleteAppliedReads();
     }
 }
 
@@ -1364,4 +1774,86 @@ void sharpen::RaftConsensus::NviStoreLastAppliedIndex(std::uint64_t index) {
 
 std::uint64_t sharpen::RaftConsensus::NviGetLastAppliedIndex() const noexcept {
     return this->appliedIndex_;
-}
\ No newline at end of file
+}
+
+void sharpen::RaftConsensus::OnReadRoundConfirmed() {
+    if (this->role_ != sharpen::RaftRole::Leader) {
+        return;
+    }
+    if (this->option_.IsEnableReadLease()) {
+        this->readLeaseDeadline_ =
+            this->leaseStatus_.GetRoundBegin() + this->option_.GetReadLease();
+    }
+    for (auto begin = this->confirmingReads_.begin(), end = this->confirmingReads_.end();
+         begin != end;
+         ++begin) {
+        this->applyingReads_.emplace(begin->first, begin->second);
+    }
+    this->confirmingReads_.clear();
+    this->CompleteAppliedReads();
+    // the reads that arrived during the round need another one
+    if (!this->pendingReads_.empty()) {
+        this->DoAdvance();
+    }
+}
+
+void sharpen::RaftConsensus::CompleteAppliedReads() noexcept {
+    std::uint64_t appliedIndex{this->appliedIndex_};
+    auto begin = this->applyingReads_.begin();
+    auto end = this->applyingReads_.upper_bound(appliedIndex);
+    for (auto ite = begin; ite != end; ++ite) {
+        ite->second->Complete(ite->first);
+    }
+    this->applyingReads_.erase(begin, end);
+}
+
+void sharpen::RaftConsensus::FailReads() noexcept {
+    for (auto begin = this->pendingReads_.begin(), end = this->pendingReads_.end(); begin != end;
+         ++begin) {
+        begin->second->Complete(sharpen::EmptyOpt);
+    }
+    this->pendingReads_.clear();
+    for (auto begin = this->confirmingReads_.begin(), end = this->confirmingReads_.end();
+         begin != end;
+         ++begin) {
+        begin->second->Complete(sharpen::EmptyOpt);
+    }
+    this->confirmingReads_.clear();
+    for (auto begin = this->applyingReads_.begin(), end = this->applyingReads_.end(); begin != end;
+         ++begin) {
+        begin->second->Complete(sharpen::EmptyOpt);
+    }
+    this->applyingReads_.clear();
+}
+
+void sharpen::RaftConsensus::DoReadIndex(ReadFuture *future) {
+    assert(future != nullptr);
+    if (this->role_ != sharpen::RaftRole::Leader) {
+        future->Complete(sharpen::EmptyOpt);
+        return;
+    }
+    // the commit index of a new leader may be stale
+    // until an entry of its term was committed
+    std::uint64_t readIndex{this->GetCommitIndex()};
+    sharpen::Optional<std::uint64_t> term{this->LookupTerm(readIndex)};
+    if (!term.Exist() || term.Get() != this->GetTerm()) {
+        readIndex = (std::max)(readIndex, this->GetLastIndex());
+    }
+    if (this->option_.IsEnableReadLease() &&
+        std::chrono::steady_clock::now() < this->readLeaseDeadline_) {
+        this->applyingReads_.emplace(readIndex, future);
+        this->CompleteAppliedReads();
+        return;
+    }
+    this->pendingReads_.emplace_back(readIndex, future);
+    // batch the reads on the round in flight
+    if (this->confirmingReads_.empty()) {
+        this->DoAdvance();
+    }
+}
+
+void sharpen::RaftConsensus::NviReadIndex(ReadFuture &future) {
+    assert(this->worker_ != nullptr);
+    this->EnsureConfig();
+    this->worker_->Submit(&Self::DoReadIndex, this, &future);
+}
@@ -38,6 +38,7 @@ sharpen::RaftHeartbeatMailProvider::RaftHeartbeatMailProvider(
     , snapshotProvider_(snapshotProvider)
     , batchSize_(batchSize)
     , entiresSize_(entiresSize)
+    , inflightWindow_(0)
     , states_()
     , term_(sharpen::ConsensusWriter::noneEpoch)
     , round_(0)
@@ -61,6 +62,7 @@ sharpen::RaftHeartbeatMailProvider::RaftHeartbeatMailProvider(Self &&other) noex
     , snapshotProvider_(other.snapshotProvider_)
     , batchSize_(other.batchSize_)
     , entiresSize_(other.entiresSize_)
+    , inflightWindow_(other.inflightWindow_)
     , states_(std::move(other.states_))
     , term_(other.term_)
     , round_(other.round_)
@@ -70,6 +72,7 @@ sharpen::RaftHeartbeatMailProvider::RaftHeartbeatMailProvider(Self &&other) noex
     other.snapshotProvider_ = nullptr;
     other.batchSize_ = Self::defaultBatchSize_;
     other.entiresSize_ = Self::defaultEntiresSize_;
+    other.inflightWindow_ = 0;
     other.term_ = sharpen::ConsensusWriter::noneEpoch;
     other.round_ = 0;
     other.commitIndex_ = 0;
@@ -84,6 +87,7 @@ sharpen::RaftHeartbeatMailProvider &sharpen::RaftHeartbeatMailProvider::operator
         this->snapshotProvider_ = other.snapshotProvider_;
         this->batchSize_ = other.batchSize_;
         this->entiresSize_ = other.entiresSize_;
+        this->inflightWindow_ = other.inflightWindow_;
         this->states_ = std::move(other.states_);
         this->term_ = other.term_;
         this->round_ = other.round_;
@@ -93,6 +97,7 @@ sharpen::RaftHeartbeatMailProvider &sharpen::RaftHeartbeatMailProvider::operator
         other.snapshotProvider_ = nullptr;
         other.batchSize_ = Self::defaultBatchSize_;
         other.entiresSize_ = Self::defaultEntiresSize_;
+        other.inflightWindow_ = 0;
         other.term_ = sharpen::ConsensusWriter::noneEpoch;
         other.round_ = 0;
         other.commitIndex_ = 0;
@@ -162,6 +167,15 @@ sharpen::RaftHeartbeatMailProvider::GetSynchronizedIndex() const noexcept {
             }
             ++begin;
         }
+        // the actors need snapshot
+        std::uint64_t preIndex{index};
+        if (preIndex != sharpen::ILogStorage::noneIndex) {
+            preIndex -= 1;
+        }
+        if (preIndex != sharpen::ILogStorage::noneIndex && !this->LookupTerm(preIndex).Exist() &&
+            !this->states_.begin()->second.LookupSnapshotTerm(preIndex).Exist()) {
+            return sharpen::EmptyOpt;
+        }
         return index;
     }
     return this->GetCommitIndex();
@@ -205,12 +219,18 @@ void sharpen::RaftHeartbeatMailProvider::SetCommitIndex(std::uint64_t index) noe
                 begin->second.ForwardMatchPoint(index);
             }
         }
-        this->ReComputeCommitIndex();
+        // there are no states to recompute commit index
+        // if we are not leader
+        this->commitIndex_ = index;
     }
 }
 
+void sharpen::RaftHeartbeatMailProvider::SetInflightWindow(std::size_t window) noexcept {
+    this->inflightWindow_ = window;
+}
+
 sharpen::Mail sharpen::RaftHeartbeatMailProvider::ProvideSnapshotRequest(
-    sharpen::RaftReplicatedState *state) const {
+    sharpen::RaftReplicatedState *state, std::uint64_t round) const {
     assert(this->snapshotProvider_ != nullptr);
     if (!this->snapshotProvider_) {
         // snapshot already disable
@@ -232,8 +252,12 @@ sharpen::Mail sharpen::RaftHeartbeatMailProvider::ProvideSnapshotRequest(
     request.SetLast(!snapshot->Forwardable());
     request.Metadata() = metadata;
     request.Data() = snapshot->GenerateChunkData();
-    request.SetLeaseRound(this->round_);
-    return this->builder_->BuildSnapshotRequest(request);
+    request.SetLeaseRound(round);
+    sharpen::Mail mail{this->builder_->BuildSnapshotRequest(request)};
+    // chunks are pipelined
+    // the follower reports its offset if a chunk is lost
+    state->Forward();
+    return mail;
 }
 
 void sharpen::RaftHeartbeatMailProvider::Register(const sharpen::ActorId &actorId) {
@@ -266,7 +290,7 @@ sharpen::Mail sharpen::RaftHeartbeatMailProvider::Provide(const sharpen::ActorId
         return sharpen::Mail{};
     }
     if (state->LookupSnapshot()) {
-        return this->ProvideSnapshotRequest(state);
+        return this->ProvideSnapshotRequest(state, this->round_);
     }
     // get next index
     std::uint64_t nextIndex{state->GetNextIndex()};
@@ -278,9 +302,27 @@ sharpen::Mail sharpen::RaftHeartbeatMailProvider::Provide(const sharpen::ActorId
         preIndex -= 1;
     }
     // compute logs size
-    std::uint64_t size{lastIndex - preIndex};
+    std::uint64_t size{0};
+    if (lastIndex > preIndex) {
+        size = lastIndex - preIndex;
+    }
     // limit logs <= batchSize
     size = (std::min)(static_cast<std::uint64_t>(this->batchSize_), size);
+    if (this->inflightWindow_) {
+        // limit logs <= window - inflight
+        // if the window is full
+        // we still send a heartbeat without entries
+        std::uint64_t window{static_cast<std::uint64_t>(this->inflightWindow_)};
+        std::uint64_t inflight{0};
+        if (preIndex > state->GetMatchIndex()) {
+            inflight = preIndex - state->GetMatchIndex();
+        }
+        if (inflight >= window) {
+            size = 0;
+        } else {
+            size = (std::min)(window - inflight, size);
+        }
+    }
     lastIndex = preIndex + size;
     sharpen::RaftHeartbeatRequest request;
     // get commit index
@@ -292,14 +334,23 @@ sharpen::Mail sharpen::RaftHeartbeatMailProvider::Provide(const sharpen::ActorId
     request.SetPreLogIndex(preIndex);
     request.SetPreLogTerm(sharpen::ConsensusWriter::noneEpoch);
     sharpen::Optional<std::uint64_t> term{this->LookupTerm(preIndex)};
-    if (!term.Exist() && preIndex != sharpen::ILogStorage::noneIndex) {
+    if (!term.Exist()) {
+        // the follower has installed the snapshot
+        term = state->LookupSnapshotTerm(preIndex);
+    }
+    bool compacted{!term.Exist() && preIndex != sharpen::ILogStorage::noneIndex};
+    if (!compacted && !size && preIndex < this->GetCommitIndex()) {
+        // the committed entries after pre index have been compacted into snapshot
+        compacted = !this->logs_->Lookup(preIndex + 1).Exist();
+    }
+    if (compacted) {
         assert(this->snapshotProvider_ != nullptr);
         if (!this->snapshotProvider_) {
             return sharpen::Mail{};
         }
         sharpen::RaftSnapshot snapshot{this->snapshotProvider_->GetSnapshot()};
         state->SetSnapshot(std::move(snapshot));
-        return this->ProvideSnapshotRequest(state);
+        return this->ProvideSnapshotRequest(state, this->round_);
     }
     if (term.Exist()) {
         request.SetPreLogTerm(term.Get());
@@ -321,7 +372,7 @@ sharpen::Mail sharpen::RaftHeartbeatMailProvider::Provide(const sharpen::ActorId
                 }
                 sharpen::RaftSnapshot snapshot{this->snapshotProvider_->GetSnapshot()};
                 state->SetSnapshot(std::move(snapshot));
-                return this->ProvideSnapshotRequest(state);
+                return this->ProvideSnapshotRequest(state, this->round_);
             }
             if (log.Get().GetSize() + entiresSize > this->entiresSize_) {
                 break;
@@ -346,8 +397,20 @@ void sharpen::RaftHeartbeatMailProvider::PrepareRound(std::uint64_t round) noexc
 
 sharpen::Mail sharpen::RaftHeartbeatMailProvider::ProvideSynchronizedMail() const {
     assert(!this->states_.empty());
-    sharpen::ActorId actorId{this->states_.begin()->first};
-    return this->Provide(actorId);
+    auto begin = this->states_.begin();
+    std::uint64_t nextIndex{begin->second.GetNextIndex()};
+    sharpen::Mail mail{this->Provide(begin->first)};
+    sharpen::RaftReplicatedState &state{begin->second};
+    if (!state.LookupSnapshot() && state.GetNextIndex() > nextIndex) {
+        // the mail will be sent to all actors
+        // forward them by the same step
+        std::uint64_t step{state.GetNextIndex() - nextIndex};
+        for (++begin; begin != this->states_.end(); ++begin) {
+            assert(begin->second.GetNextIndex() == nextIndex);
+            begin->second.Forward(step);
+        }
+    }
+    return mail;
 }
 
 void sharpen::RaftHeartbeatMailProvider::ForwardState(const sharpen::ActorId &actorId,
@@ -367,4 +430,46 @@ void sharpen::RaftHeartbeatMailProvider::BackwardState(const sharpen::ActorId &a
     if (state) {
         state->BackwardMatchPoint(index);
     }
+}
+
+bool sharpen::RaftHeartbeatMailProvider::IsTransferringSnapshot(
+    const sharpen::ActorId &actorId) const noexcept {
+    const sharpen::RaftReplicatedState *state{this->LookupState(actorId)};
+    return state && state->LookupSnapshot();
+}
+
+sharpen::Mail sharpen::RaftHeartbeatMailProvider::ProvideSnapshotChunk(
+    const sharpen::ActorId &actorId) const {
+    sharpen::RaftReplicatedState *state{this->LookupMutableState(actorId)};
+    if (!state || !state->LookupSnapshot()) {
+        return sharpen::Mail{};
+    }
+    // the chunks between rounds are not used to confirm lease
+    // because an actor may acknowledge many of them in one round
+    return this->ProvideSnapshotRequest(state, Self::noneRound_);
+}
+
+void sharpen::RaftHeartbeatMailProvider::BackwardSnapshot(const sharpen::ActorId &actorId,
+                                                          std::uint64_t offset) {
+    sharpen::RaftReplicatedState *state{this->LookupMutableState(actorId)};
+    assert(state != nullptr);
+    if (!state || !this->snapshotProvider_) {
+        return;
+    }
+    sharpen::IRaftSnapshotChunk *chunk{state->LookupSnapshot()};
+    // the chunk of offset has not been sent
+    // or the transfer has been completed
+    if (!chunk || chunk->GetOffset() <= offset) {
+        return;
+    }
+    sharpen::Optional<sharpen::RaftSnapshotMetadata> metadata{state->LookupSnapshotMetadata()};
+    assert(metadata.Exist());
+    sharpen::RaftSnapshot snapshot{this->snapshotProvider_->GetSnapshot()};
+    // a newer snapshot is sent from the beginning
+    bool resumable{snapshot.Metadata().GetLastIndex() == metadata.Get().GetLastIndex()};
+    state->SetSnapshot(std::move(snapshot));
+    chunk = state->LookupSnapshot();
+    while (resumable && chunk->GetOffset() < offset && chunk->Forwardable()) {
+        chunk->Forward();
+    }
 }
\ No newline at end of file
@@ -0,0 +1,76 @@
+#include <sharpen/RaftLearnLogsRequest.hpp>
+
+#include <sharpen/ConsensusWriter.hpp>
+#include <sharpen/Varint.hpp>
+
+sharpen::RaftLearnLogsRequest::RaftLearnLogsRequest() noexcept
+    : term_(sharpen::ConsensusWriter::noneEpoch)
+    , beginIndex_(0)
+    , batchSize_(0) {
+}
+
+sharpen::RaftLearnLogsRequest::RaftLearnLogsRequest(Self &&other) noexcept
+    : term_(other.term_)
+    , beginIndex_(other.beginIndex_)
+    , batchSize_(other.batchSize_) {
+    other.term_ = sharpen::ConsensusWriter::noneEpoch;
+    other.beginIndex_ = 0;
+    other.batchSize_ = 0;
+}
+
+sharpen::RaftLearnLogsRequest &sharpen::RaftLearnLogsRequest::operator=(Self &&other) noexcept {
+    if (this != std::addressof(other)) {
+        this->term_ = other.term_;
+        this->beginIndex_ = other.beginIndex_;
+        this->batchSize_ = other.batchSize_;
+        other.term_ = sharpen::ConsensusWriter::noneEpoch;
+        other.beginIndex_ = 0;
+        other.batchSize_ = 0;
+    }
+    return *this;
+}
+
+std::size_t sharpen::RaftLearnLogsRequest::ComputeSize() const noexcept {
+    std::size_t size{0};
+    sharpen::Varuint64 builder{this->term_};
+    size += builder.ComputeSize();
+    builder.Set(this->beginIndex_);
+    size += builder.ComputeSize();
+    builder.Set(this->batchSize_);
+    size += builder.ComputeSize();
+    return size;
+}
+
+std::size_t sharpen::RaftLearnLogsRequest::LoadFrom(const char *data, std::size_t size) {
+    if (size < 3) {
+        throw sharpen::CorruptedDataError{"corrupted learn logs request"};
+    }
+    std::size_t offset{0};
+    sharpen::Varuint64 builder{0};
+    offset += sharpen::BinarySerializator::LoadFrom(builder, data + offset, size - offset);
+    std::uint64_t term{builder.Get()};
+    if (size < 2 + offset) {
+        throw sharpen::CorruptedDataError{"corrupted learn logs request"};
+    }
+    offset += sharpen::BinarySerializator::LoadFrom(builder, data + offset, size - offset);
+    std::uint64_t beginIndex{builder.Get()};
+    if (size < 1 + offset) {
+        throw sharpen::CorruptedDataError{"corrupted learn logs request"};
+    }
+    offset += sharpen::BinarySerializator::LoadFrom(builder, data + offset, size - offset);
+    this->term_ = term;
+    this->beginIndex_ = beginIndex;
+    this->batchSize_ = builder.Get();
+    return offset;
+}
+
+std::size_t sharpen::RaftLearnLogsRequest::UnsafeStoreTo(char *data) const noexcept {
+    std::size_t offset{0};
+    sharpen::Varuint64 builder{this->term_};
+    offset += sharpen::BinarySerializator::UnsafeStoreTo(builder, data + offset);
+    builder.Set(this->beginIndex_);
+    offset += sharpen::BinarySerializator::UnsafeStoreTo(builder, data + offset);
+    builder.Set(this->batchSize_);
+    offset += sharpen::BinarySerializator::UnsafeStoreTo(builder, data + offset);
+    return offset;
+}
\ No newline at end of file
@@ -0,0 +1,119 @@
+#include <sharpen/RaftLearnLogsResponse.hpp>
+
+#include <sharpen/ConsensusWriter.hpp>
+#include <sharpen/Varint.hpp>
+
+sharpen::RaftLearnLogsResponse::RaftLearnLogsResponse() noexcept
+    : status_(false)
+    , term_(sharpen::ConsensusWriter::noneEpoch)
+    , beginIndex_(0)
+    , commitIndex_(0)
+    , snapshotIndex_(0)
+    , entries_() {
+}
+
+sharpen::RaftLearnLogsResponse::RaftLearnLogsResponse(Self &&other) noexcept
+    : status_(other.status_)
+    , term_(other.term_)
+    , beginIndex_(other.beginIndex_)
+    , commitIndex_(other.commitIndex_)
+    , snapshotIndex_(other.snapshotIndex_)
+    , entries_(std::move(other.entries_)) {
+    other.status_ = false;
+    other.term_ = sharpen::ConsensusWriter::noneEpoch;
+    other.beginIndex_ = 0;
+    other.commitIndex_ = 0;
+    other.snapshotIndex_ = 0;
+}
+
+sharpen::RaftLearnLogsResponse &sharpen::RaftLearnLogsResponse::operator=(Self &&other) noexcept {
+    if (this != std::addressof(other)) {
+        this->status_ = other.status_;
+        this->term_ = other.term_;
+        this->beginIndex_ = other.beginIndex_;
+        this->commitIndex_ = other.commitIndex_;
+        this->snapshotIndex_ = other.snapshotIndex_;
+        this->entries_ = std::move(other.entries_);
+        other.status_ = false;
+        other.term_ = sharpen::ConsensusWriter::noneEpoch;
+        other.beginIndex_ = 0;
+        other.commitIndex_ = 0;
+        other.snapshotIndex_ = 0;
+    }
+    return *this;
+}
+
+std::size_t sharpen::RaftLearnLogsResponse::ComputeSize() const noexcept {
+    std::size_t size{sizeof(std::uint8_t)};
+    sharpen::Varuint64 builder{this->term_};
+    size += builder.ComputeSize();
+    builder.Set(this->beginIndex_);
+    size += builder.ComputeSize();
+    builder.Set(this->commitIndex_);
+    size += builder.ComputeSize();
+    builder.Set(this->snapshotIndex_);
+    size += builder.ComputeSize();
+    size += sharpen::BinarySerializator::ComputeSize(this->entries_);
+    return size;
+}
+
+std::size_t sharpen::RaftLearnLogsResponse::LoadFrom(const char *data, std::size_t size) {
+    if (size < 6) {
+        throw sharpen::CorruptedDataError{"corrupted learn logs response"};
+    }
+    std::size_t offset{0};
+    std::uint8_t status{0};
+    offset += sharpen::BinarySerializator::LoadFrom(status, data + offset, size - offset);
+    if (size < 5 + offset) {
+        throw sharpen::CorruptedDataError{"corrupted learn logs response"};
+    }
+    sharpen::Varuint64 builder{0};
+    offset += sharpen::BinarySerializator::LoadFrom(builder, data + offset, size - offset);
+    std::uint64_t term{builder.Get()};
+    if (size < 4 + offset) {
+        throw sharpen::CorruptedDataError{"corrupted learn logs response"};
+    }
+    offset += sharpen::BinarySerializator::LoadFrom(builder, data + offset, size - offset);
+    std::uint64_t beginIndex{builder.Get()};
+    if (size < 3 + offset) {
+        throw sharpen::CorruptedDataError{"corrupted learn logs response"};
+    }
+    offset += sharpen::BinarySerializator::LoadFrom(builder, data + offset, size - offset);
+    std::uint64_t commitIndex{builder.Get()};
+    if (size < 2 + offset) {
+        throw sharpen::CorruptedDataError{"corrupted learn logs response"};
+    }
+    offset += sharpen::BinarySerializator::LoadFrom(builder, data + offset, size - offset);
+    std::uint64_t snapshotIndex{builder.Get()};
+    if (size < 1 + offset) {
+        throw sharpen::CorruptedDataError{"corrupted learn logs response"};
+    }
+    sharpen::LogEntries entries;
+    offset += sharpen::BinarySerializator::LoadFrom(entries, data + offset, size - offset);
+    this->status_ = status;
+    this->term_ = term;
+    this->beginIndex_ = beginIndex;
+    this->commitIndex_ = commitIndex;
+    this->snapshotIndex_ = snapshotIndex;
+    this->entries_ = std::move(entries);
+    return offset;
+}
+
+std::size_t sharpen::RaftLearnLogsResponse::UnsafeStoreTo(char *data) const noexcept {
+    std::size_t offset{0};
+    std::uint8_t status{0};
+    if (this->status_) {
+        status = 1;
+    }
+    offset += sharpen::BinarySerializator::UnsafeStoreTo(status, data + offset);
+    sharpen::Varuint64 builder{this->term_};
+    offset += sharpen::BinarySerializator::UnsafeStoreTo(builder, data + offset);
+    builder.Set(this->beginIndex_);
+    offset += sharpen::BinarySerializator::UnsafeStoreTo(builder, data + offset);
+    builder.Set(this->commitIndex_);
+    offset += sharpen::BinarySerializator::UnsafeStoreTo(builder, data + offset);
+    builder.Set(this->snapshotIndex_);
+    offset += sharpen::BinarySerializator::UnsafeStoreTo(builder, data + offset);
+    offset += sharpen::BinarySerializator::UnsafeStoreTo(this->entries_, data + offset);
+    return offset;
+}
\ No newline at end of file
@@ -0,0 +1,77 @@
+#include <sharpen/RaftLearnSnapshotRequest.hpp>
+
+#include <sharpen/ConsensusWriter.hpp>
+#include <sharpen/Varint.hpp>
+
+sharpen::RaftLearnSnapshotRequest::RaftLearnSnapshotRequest() noexcept
+    : term_(sharpen::ConsensusWriter::noneEpoch)
+    , lastIndex_(0)
+    , offset_(0) {
+}
+
+sharpen::RaftLearnSnapshotRequest::RaftLearnSnapshotRequest(Self &&other) noexcept
+    : term_(other.term_)
+    , lastIndex_(other.lastIndex_)
+    , offset_(other.offset_) {
+    other.term_ = sharpen::ConsensusWriter::noneEpoch;
+    other.lastIndex_ = 0;
+    other.offset_ = 0;
+}
+
+sharpen::RaftLearnSnapshotRequest &sharpen::RaftLearnSnapshotRequest::operator=(
+    Self &&other) noexcept {
+    if (this != std::addressof(other)) {
+        this->term_ = other.term_;
+        this->lastIndex_ = other.lastIndex_;
+        this->offset_ = other.offset_;
+        other.term_ = sharpen::ConsensusWriter::noneEpoch;
+        other.lastIndex_ = 0;
+        other.offset_ = 0;
+    }
+    return *this;
+}
+
+std::size_t sharpen::RaftLearnSnapshotRequest::ComputeSize() const noexcept {
+    std::size_t size{0};
+    sharpen::Varuint64 builder{this->term_};
+    size += builder.ComputeSize();
+    builder.Set(this->lastIndex_);
+    size += builder.ComputeSize();
+    builder.Set(this->offset_);
+    size += builder.ComputeSize();
+    return size;
+}
+
+std::size_t sharpen::RaftLearnSnapshotRequest::LoadFrom(const char *data, std::size_t size) {
+    if (size < 3) {
+        throw sharpen::CorruptedDataError{"corrupted learn snapshot request"};
+    }
+    std::size_t offset{0};
+    sharpen::Varuint64 builder{0};
+    offset += sharpen::BinarySerializator::LoadFrom(builder, data + offset, size - offset);
+    std::uint64_t term{builder.Get()};
+    if (size < 2 + offset) {
+        throw sharpen::CorruptedDataError{"corrupted learn snapshot request"};
+    }
+    offset += sharpen::BinarySerializator::LoadFrom(builder, data + offset, size - offset);
+    std::uint64_t lastIndex{builder.Get()};
+    if (size < 1 + offset) {
+        throw sharpen::CorruptedDataError{"corrupted learn snapshot request"};
+    }
+    offset += sharpen::BinarySerializator::LoadFrom(builder, data + offset, size - offset);
+    this->term_ = term;
+    this->lastIndex_ = lastIndex;
+    this->offset_ = builder.Get();
+    return offset;
+}
+
+std::size_t sharpen::RaftLearnSnapshotRequest::UnsafeStoreTo(char *data) const noexcept {
+    std::size_t offset{0};
+    sharpen::Varuint64 builder{this->term_};
+    offset += sharpen::BinarySerializator::UnsafeStoreTo(builder, data + offset);
+    builder.Set(this->lastIndex_);
+    offset += sharpen::BinarySerializator::UnsafeStoreTo(builder, data + offset);
+    builder.Set(this->offset_);
+    offset += sharpen::BinarySerializator::UnsafeStoreTo(builder, data + offset);
+    return offset;
+}
\ No newline at end of file
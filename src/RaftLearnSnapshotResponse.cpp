@@ -0,0 +1,118 @@
+#include <sharpen/RaftLearnSnapshotResponse.hpp>
+
+#include <sharpen/ConsensusWriter.hpp>
+#include <sharpen/Varint.hpp>
+
+sharpen::RaftLearnSnapshotResponse::RaftLearnSnapshotResponse() noexcept
+    : status_(false)
+    , term_(sharpen::ConsensusWriter::noneEpoch)
+    , offset_(0)
+    , last_(false)
+    , metadata_()
+    , data_() {
+}
+
+sharpen::RaftLearnSnapshotResponse::RaftLearnSnapshotResponse(Self &&other) noexcept
+    : status_(other.status_)
+    , term_(other.term_)
+    , offset_(other.offset_)
+    , last_(other.last_)
+    , metadata_(std::move(other.metadata_))
+    , data_(std::move(other.data_)) {
+    other.status_ = false;
+    other.term_ = sharpen::ConsensusWriter::noneEpoch;
+    other.offset_ = 0;
+    other.last_ = false;
+}
+
+sharpen::RaftLearnSnapshotResponse &sharpen::RaftLearnSnapshotResponse::operator=(
+    Self &&other) noexcept {
+    if (this != std::addressof(other)) {
+        this->status_ = other.status_;
+        this->term_ = other.term_;
+        this->offset_ = other.offset_;
+        this->last_ = other.last_;
+        this->metadata_ = std::move(other.metadata_);
+        this->data_ = std::move(other.data_);
+        other.status_ = false;
+        other.term_ = sharpen::ConsensusWriter::noneEpoch;
+        other.offset_ = 0;
+        other.last_ = false;
+    }
+    return *this;
+}
+
+std::size_t sharpen::RaftLearnSnapshotResponse::ComputeSize() const noexcept {
+    std::size_t size{sizeof(std::uint8_t)};
+    sharpen::Varuint64 builder{this->term_};
+    size += builder.ComputeSize();
+    builder.Set(this->offset_);
+    size += builder.ComputeSize();
+    size += sizeof(std::uint8_t);
+    size += this->metadata_.ComputeSize();
+    size += sharpen::BinarySerializator::ComputeSize(this->data_);
+    return size;
+}
+
+std::size_t sharpen::RaftLearnSnapshotResponse::LoadFrom(const char *data, std::size_t size) {
+    if (size < 9) {
+        throw sharpen::CorruptedDataError{"corrupted learn snapshot response"};
+    }
+    std::size_t offset{0};
+    std::uint8_t status{0};
+    offset += sharpen::BinarySerializator::LoadFrom(status, data + offset, size - offset);
+    if (size < 8 + offset) {
+        throw sharpen::CorruptedDataError{"corrupted learn snapshot response"};
+    }
+    sharpen::Varuint64 builder{0};
+    offset += sharpen::BinarySerializator::LoadFrom(builder, data + offset, size - offset);
+    std::uint64_t term{builder.Get()};
+    if (size < 7 + offset) {
+        throw sharpen::CorruptedDataError{"corrupted learn snapshot response"};
+    }
+    offset += sharpen::BinarySerializator::LoadFrom(builder, data + offset, size - offset);
+    std::uint64_t off{builder.Get()};
+    if (size < 6 + offset) {
+        throw sharpen::CorruptedDataError{"corrupted learn snapshot response"};
+    }
+    std::uint8_t last{0};
+    offset += sharpen::BinarySerializator::LoadFrom(last, data + offset, size - offset);
+    if (size < 5 + offset) {
+        throw sharpen::CorruptedDataError{"corrupted learn snapshot response"};
+    }
+    sharpen::RaftSnapshotMetadata metadata;
+    offset += sharpen::BinarySerializator::LoadFrom(metadata, data + offset, size - offset);
+    if (size < 1 + offset) {
+        throw sharpen::CorruptedDataError{"corrupted learn snapshot response"};
+    }
+    sharpen::ByteBuffer chunkData;
+    offset += sharpen::BinarySerializator::LoadFrom(chunkData, data + offset, size - offset);
+    this->status_ = status;
+    this->term_ = term;
+    this->offset_ = off;
+    this->last_ = last;
+    this->metadata_ = std::move(metadata);
+    this->data_ = std::move(chunkData);
+    return offset;
+}
+
+std::size_t sharpen::RaftLearnSnapshotResponse::UnsafeStoreTo(char *data) const noexcept {
+    std::size_t offset{0};
+    std::uint8_t status{0};
+    if (this->status_) {
+        status = 1;
+    }
+    offset += sharpen::BinarySerializator::UnsafeStoreTo(status, data + offset);
+    sharpen::Varuint64 builder{this->term_};
+    offset += sharpen::BinarySerializator::UnsafeStoreTo(builder, data + offset);
+    builder.Set(this->offset_);
+    offset += sharpen::BinarySerializator::UnsafeStoreTo(builder, data + offset);
+    std::uint8_t last{0};
+    if (this->last_) {
+        last = 1;
+    }
+    offset += sharpen::BinarySerializator::UnsafeStoreTo(last, data + offset);
+    offset += sharpen::BinarySerializator::UnsafeStoreTo(this->metadata_, data + offset);
+    offset += sharpen::BinarySerializator::UnsafeStoreTo(this->data_, data + offset);
+    return offset;
+}
\ No newline at end of file
@@ -2,24 +2,29 @@
 
 sharpen::RaftLeaseStatus::RaftLeaseStatus() noexcept
     : leaseRound_(0)
-    , ackCount_(0) {
+    , ackCount_(0)
+    , roundBegin_() {
 }
 
 sharpen::RaftLeaseStatus::RaftLeaseStatus(const Self &other) noexcept
     : leaseRound_(other.leaseRound_)
-    , ackCount_(other.ackCount_) {
+    , ackCount_(other.ackCount_)
+    , roundBegin_(other.roundBegin_) {
 }
 
 sharpen::RaftLeaseStatus::RaftLeaseStatus(Self &&other) noexcept
     : leaseRound_(other.leaseRound_)
-    , ackCount_(other.ackCount_) {
+    , ackCount_(other.ackCount_)
+    , roundBegin_(other.roundBegin_) {
     other.leaseRound_ = 0;
     other.ackCount_ = 0;
+    other.roundBegin_ = std::chrono::steady_clock::time_point{};
 }
 
 void sharpen::RaftLeaseStatus::NextRound() noexcept {
     this->ackCount_ = 0;
     this->leaseRound_ += 1;
+    this->roundBegin_ = std::chrono::steady_clock::now();
 }
 
 std::uint64_t sharpen::RaftLeaseStatus::GetRound() const noexcept {
@@ -32,4 +37,8 @@ void sharpen::RaftLeaseStatus::OnAck() noexcept {
 
 std::size_t sharpen::RaftLeaseStatus::GetAckCount() const noexcept {
     return this->ackCount_;
+}
+
+std::chrono::steady_clock::time_point sharpen::RaftLeaseStatus::GetRoundBegin() const noexcept {
+    return this->roundBegin_;
 }
\ No newline at end of file
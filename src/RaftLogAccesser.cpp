@@ -6,22 +6,37 @@
 
 
 sharpen::RaftLogAccesser::RaftLogAccesser(std::uint32_t magic) noexcept
-    : magic_(magic) {
+    : Self{magic, sharpen::RaftLogChecksum::Crc32} {
+}
+
+sharpen::RaftLogAccesser::RaftLogAccesser(std::uint32_t magic,
+                                          sharpen::RaftLogChecksum checksum) noexcept
+    : magic_(magic)
+    , checksum_(checksum) {
 }
 
 sharpen::RaftLogAccesser::RaftLogAccesser(Self &&other) noexcept
-    : magic_(other.magic_) {
+    : magic_(other.magic_)
+    , checksum_(other.checksum_) {
     other.magic_ = 0;
 }
 
 sharpen::RaftLogAccesser &sharpen::RaftLogAccesser::operator=(Self &&other) noexcept {
     if (this != std::addressof(other)) {
         this->magic_ = other.magic_;
+        this->checksum_ = other.checksum_;
         other.magic_ = 0;
     }
     return *this;
 }
 
+std::uint32_t sharpen::RaftLogAccesser::ComputeChecksum(sharpen::ByteSlice bytes) const noexcept {
+    if (this->checksum_ == sharpen::RaftLogChecksum::Crc32c) {
+        return bytes.Crc32c();
+    }
+    return bytes.Crc32();
+}
+
 std::uint64_t sharpen::RaftLogAccesser::NviGetTerm(sharpen::ByteSlice logEntry) const noexcept {
     const sharpen::RaftLogHeader *header{
         reinterpret_cast<const sharpen::RaftLogHeader *>(logEntry.Data())};
@@ -35,7 +50,8 @@ bool sharpen::RaftLogAccesser::NviIsRaftEntry(sharpen::ByteSlice logEntry) const
             reinterpret_cast<const sharpen::RaftLogHeader *>(logEntry.Data())};
         if (header->GetMagic() == this->magic_) {
             if (logEntry.GetSize() != sizeof(*header)) {
-                std::uint32_t checksum{logEntry.Sub(sizeof(sharpen::RaftLogHeader)).Crc32()};
+                std::uint32_t checksum{
+                    this->ComputeChecksum(logEntry.Sub(sizeof(sharpen::RaftLogHeader)))};
                 return checksum == header->GetChecksum();
             } else {
                 return true;
@@ -48,7 +64,7 @@ bool sharpen::RaftLogAccesser::NviIsRaftEntry(sharpen::ByteSlice logEntry) const
 
 sharpen::ByteBuffer sharpen::RaftLogAccesser::NviCreateEntry(sharpen::ByteSlice bytes,
                                                              std::uint64_t term) const {
-    sharpen::RaftLogHeader header{this->magic_, bytes.Crc32(), term};
+    sharpen::RaftLogHeader header{this->magic_, this->ComputeChecksum(bytes), term};
     sharpen::ByteBuffer buf{sizeof(header) + bytes.GetSize()};
     sharpen::BufferWriter writer{buf};
     writer.Write(header);
@@ -109,4 +109,40 @@ sharpen::Mail sharpen::RaftMailBuilder::BuildSnapshotResponse(
     sharpen::BufferWriter writer{content};
     writer.Write(response);
     return this->BuildMail(sharpen::RaftMailType::InstallSnapshotResponse, std::move(content));
+}
+
+sharpen::Mail sharpen::RaftMailBuilder::BuildLearnLogsRequest(
+    const sharpen::RaftLearnLogsRequest &request) const {
+    std::uint32_t size{sharpen::IntCast<std::uint32_t>(request.ComputeSize())};
+    sharpen::ByteBuffer content{size};
+    sharpen::BufferWriter writer{content};
+    writer.Write(request);
+    return this->BuildMail(sharpen::RaftMailType::LearnLogsRequest, std::move(content));
+}
+
+sharpen::Mail sharpen::RaftMailBuilder::BuildLearnLogsResponse(
+    const sharpen::RaftLearnLogsResponse &response) const {
+    std::uint32_t size{sharpen::IntCast<std::uint32_t>(response.ComputeSize())};
+    sharpen::ByteBuffer content{size};
+    sharpen::BufferWriter writer{content};
+    writer.Write(response);
+    return this->BuildMail(sharpen::RaftMailType::LearnLogsResponse, std::move(content));
+}
+
+sharpen::Mail sharpen::RaftMailBuilder::BuildLearnSnapshotRequest(
+    const sharpen::RaftLearnSnapshotRequest &request) const {
+    std::uint32_t size{sharpen::IntCast<std::uint32_t>(request.ComputeSize())};
+    sharpen::ByteBuffer content{size};
+    sharpen::BufferWriter writer{content};
+    writer.Write(request);
+    return this->BuildMail(sharpen::RaftMailType::LearnSnapshotRequest, std::move(content));
+}
+
+sharpen::Mail sharpen::RaftMailBuilder::BuildLearnSnapshotResponse(
+    const sharpen::RaftLearnSnapshotResponse &response) const {
+    std::uint32_t size{sharpen::IntCast<std::uint32_t>(response.ComputeSize())};
+    sharpen::ByteBuffer content{size};
+    sharpen::BufferWriter writer{content};
+    writer.Write(response);
+    return this->BuildMail(sharpen::RaftMailType::LearnSnapshotResponse, std::move(content));
 }
\ No newline at end of file
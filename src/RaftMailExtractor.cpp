@@ -170,4 +170,66 @@ sharpen::RaftMailExtractor::NviExtractSnapshotResponse(const sharpen::Mail &mail
         return sharpen::EmptyOpt;
     }
     return response;
+}
+
+sharpen::Optional<sharpen::RaftLearnLogsRequest>
+sharpen::RaftMailExtractor::NviExtractLearnLogsRequest(const sharpen::Mail &mail) const noexcept {
+    if (!this->CheckMail(sharpen::RaftMailType::LearnLogsRequest, mail)) {
+        return sharpen::EmptyOpt;
+    }
+    sharpen::RaftLearnLogsRequest request;
+    try {
+        request.Unserialize().LoadFrom(mail.Content());
+    } catch (const sharpen::CorruptedDataError &error) {
+        (void)error;
+        return sharpen::EmptyOpt;
+    }
+    return request;
+}
+
+sharpen::Optional<sharpen::RaftLearnLogsResponse>
+sharpen::RaftMailExtractor::NviExtractLearnLogsResponse(const sharpen::Mail &mail) const noexcept {
+    if (!this->CheckMail(sharpen::RaftMailType::LearnLogsResponse, mail)) {
+        return sharpen::EmptyOpt;
+    }
+    sharpen::RaftLearnLogsResponse response;
+    try {
+        response.Unserialize().LoadFrom(mail.Content());
+    } catch (const sharpen::CorruptedDataError &error) {
+        (void)error;
+        return sharpen::EmptyOpt;
+    }
+    return response;
+}
+
+sharpen::Optional<sharpen::RaftLearnSnapshotRequest>
+sharpen::RaftMailExtractor::NviExtractLearnSnapshotRequest(
+    const sharpen::Mail &mail) const noexcept {
+    if (!this->CheckMail(sharpen::RaftMailType::LearnSnapshotRequest, mail)) {
+        return sharpen::EmptyOpt;
+    }
+    sharpen::RaftLearnSnapshotRequest request;
+    try {
+        request.Unserialize().LoadFrom(mail.Content());
+    } catch (const sharpen::CorruptedDataError &error) {
+        (void)error;
+        return sharpen::EmptyOpt;
+    }
+    return request;
+}
+
+sharpen::Optional<sharpen::RaftLearnSnapshotResponse>
+sharpen::RaftMailExtractor::NviExtractLearnSnapshotResponse(
+    const sharpen::Mail &mail) const noexcept {
+    if (!this->CheckMail(sharpen::RaftMailType::LearnSnapshotResponse, mail)) {
+        return sharpen::EmptyOpt;
+    }
+    sharpen::RaftLearnSnapshotResponse response;
+    try {
+        response.Unserialize().LoadFrom(mail.Content());
+    } catch (const sharpen::CorruptedDataError &error) {
+        (void)error;
+        return sharpen::EmptyOpt;
+    }
+    return response;
 }
\ No newline at end of file
@@ -8,7 +8,9 @@ sharpen::RaftOption::RaftOption() noexcept
     , batchSize_(Self::minBatchSize_)
     , pipelineLength_(Self::minPipelineLength_)
     , enableSingle_(false)
-    , enableLeaseAwareness_(false) {
+    , enableLeaseAwareness_(false)
+    , enablePipelinedReplication_(false)
+    , readLease_(0) {
 }
 
 sharpen::RaftOption::RaftOption(Self &&other) noexcept
@@ -17,13 +19,17 @@ sharpen::RaftOption::RaftOption(Self &&other) noexcept
     , batchSize_(other.batchSize_)
     , pipelineLength_(other.pipelineLength_)
     , enableSingle_(other.enableSingle_)
-    , enableLeaseAwareness_(other.enableLeaseAwareness_) {
+    , enableLeaseAwareness_(other.enableLeaseAwareness_)
+    , enablePipelinedReplication_(other.enablePipelinedReplication_)
+    , readLease_(other.readLease_) {
     other.isLearner_ = false;
     other.enablePrevote_ = false;
     other.batchSize_ = Self::minBatchSize_;
     other.pipelineLength_ = Self::minPipelineLength_;
     other.enableSingle_ = false;
     other.enableLeaseAwareness_ = false;
+    other.enablePipelinedReplication_ = false;
+    other.readLease_ = std::chrono::milliseconds{0};
 }
 
 sharpen::RaftOption &sharpen::RaftOption::operator=(Self &&other) noexcept {
@@ -34,12 +40,16 @@ sharpen::RaftOption &sharpen::RaftOption::operator=(Self &&other) noexcept {
         this->pipelineLength_ = other.pipelineLength_;
         this->enableSingle_ = other.enableSingle_;
         this->enableLeaseAwareness_ = other.enableLeaseAwareness_;
+        this->enablePipelinedReplication_ = other.enablePipelinedReplication_;
+        this->readLease_ = other.readLease_;
         other.isLearner_ = false;
         other.enablePrevote_ = false;
         other.batchSize_ = Self::minBatchSize_;
         other.pipelineLength_ = Self::minPipelineLength_;
         other.enableSingle_ = false;
         other.enableLeaseAwareness_ = false;
+        other.enablePipelinedReplication_ = false;
+        other.readLease_ = std::chrono::milliseconds{0};
     }
     return *this;
 }
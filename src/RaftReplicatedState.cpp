@@ -11,7 +11,8 @@ sharpen::RaftReplicatedState::RaftReplicatedState() noexcept
 sharpen::RaftReplicatedState::RaftReplicatedState(std::uint64_t matchIndex) noexcept
     : matchIndex_(matchIndex)
     , nextIndex_(matchIndex + 1)
-    , snapshot_(nullptr) {
+    , snapshot_(nullptr)
+    , snapshotMetadata_() {
 }
 
 sharpen::RaftReplicatedState::RaftReplicatedState(Self &&other) noexcept
@@ -41,9 +42,10 @@ void sharpen::RaftReplicatedState::Forward(std::uint64_t step) noexcept {
         if (this->snapshot_->Forwardable()) {
             this->snapshot_->Forward();
         } else {
+            // the last chunk has been sent
+            // match index is forwarded by the heartbeats after installation
             this->snapshot_.reset(nullptr);
-            this->matchIndex_ = this->snapshotMetadata_.GetLastIndex();
-            this->nextIndex_ = this->matchIndex_ + 1;
+            this->nextIndex_ = this->snapshotMetadata_.GetLastIndex() + 1;
         }
     } else {
         this->nextIndex_ += step;
@@ -93,4 +95,13 @@ sharpen::RaftReplicatedState::LookupSnapshotMetadata() const noexcept {
         return this->snapshotMetadata_;
     }
     return sharpen::EmptyOpt;
+}
+
+sharpen::Optional<std::uint64_t> sharpen::RaftReplicatedState::LookupSnapshotTerm(
+    std::uint64_t index) const noexcept {
+    if (index != sharpen::ILogStorage::noneIndex &&
+        this->snapshotMetadata_.GetLastIndex() == index) {
+        return this->snapshotMetadata_.GetLastTerm();
+    }
+    return sharpen::EmptyOpt;
 }
\ No newline at end of file
@@ -1,23 +1,29 @@
 #include <sharpen/RaftSnapshotMetadata.hpp>
 
+#include <limits>
+
 sharpen::RaftSnapshotMetadata::RaftSnapshotMetadata() noexcept
     : lastIndex_(0)
     , lastTerm_(0)
+    , checksum_(0)
     , peers_() {
 }
 
 sharpen::RaftSnapshotMetadata::RaftSnapshotMetadata(const Self &other) noexcept
     : lastIndex_(other.lastIndex_)
     , lastTerm_(other.lastTerm_)
+    , checksum_(other.checksum_)
     , peers_(other.peers_) {
 }
 
 sharpen::RaftSnapshotMetadata::RaftSnapshotMetadata(Self &&other) noexcept
     : lastIndex_(other.lastIndex_)
     , lastTerm_(other.lastTerm_)
+    , checksum_(other.checksum_)
     , peers_(std::move(other.peers_)) {
     other.lastIndex_ = 0;
     other.lastTerm_ = 0;
+    other.checksum_ = 0;
 }
 
 sharpen::RaftSnapshotMetadata &sharpen::RaftSnapshotMetadata::operator=(
@@ -25,7 +31,8 @@ sharpen::RaftSnapshotMetadata &sharpen::RaftSnapshotMetadata::operator=(
     if (this != std::addressof(other)) {
         this->lastIndex_ = other.lastIndex_;
         this->lastTerm_ = other.lastTerm_;
-        this->peers_ = std::move(other.peers_);
+        this->checksum_ = other.checksum_;
+        this->peers_ = other.peers_;
     }
     return *this;
 }
@@ -34,8 +41,11 @@ sharpen::RaftSnapshotMetadata &sharpen::RaftSnapshotMetadata::operator=(Self &&o
     if (this != std::addressof(other)) {
         this->lastIndex_ = other.lastIndex_;
         this->lastTerm_ = other.lastTerm_;
+        this->checksum_ = other.checksum_;
+        this->peers_ = std::move(other.peers_);
         other.lastIndex_ = 0;
         other.lastTerm_ = 0;
+        other.checksum_ = 0;
     }
     return *this;
 }
@@ -52,23 +62,33 @@ std::size_t sharpen::RaftSnapshotMetadata::ComputeSize() const noexcept {
     std::size_t size{builder.ComputeSize()};
     builder.Set(this->lastTerm_);
     size += builder.ComputeSize();
+    builder.Set(this->checksum_);
+    size += builder.ComputeSize();
     size += sharpen::BinarySerializator::ComputeSize(this->peers_);
     return size;
 }
 
 std::size_t sharpen::RaftSnapshotMetadata::LoadFrom(const char *data, std::size_t size) {
     std::size_t offset{0};
-    if (size < 3) {
+    if (size < 4) {
         throw sharpen::CorruptedDataError{"corrupted raft snapshot metadata"};
     }
     sharpen::Varuint64 builder{0};
     offset += builder.LoadFrom(data, size);
     std::uint64_t lastIndex{builder.Get()};
-    if (size < 2 + offset) {
+    if (size < 3 + offset) {
         throw sharpen::CorruptedDataError{"corrupted raft snapshot metadata"};
     }
     offset += builder.LoadFrom(data + offset, size - offset);
     std::uint64_t lastTerm{builder.Get()};
+    if (size < 2 + offset) {
+        throw sharpen::CorruptedDataError{"corrupted raft snapshot metadata"};
+    }
+    offset += builder.LoadFrom(data + offset, size - offset);
+    if (builder.Get() > (std::numeric_limits<std::uint32_t>::max)()) {
+        throw sharpen::CorruptedDataError{"corrupted raft snapshot metadata"};
+    }
+    std::uint32_t checksum{static_cast<std::uint32_t>(builder.Get())};
     sharpen::ConsensusPeersConfiguration peers;
     if (size < 1 + offset) {
         throw sharpen::CorruptedDataError{"corrupted raft snapshot metadata"};
@@ -76,6 +96,7 @@ std::size_t sharpen::RaftSnapshotMetadata::LoadFrom(const char *data, std::size_
     offset += sharpen::BinarySerializator::LoadFrom(peers,data + offset,size - offset);
     this->lastIndex_ = lastIndex;
     this->lastTerm_ = lastTerm;
+    this->checksum_ = checksum;
     this->peers_ = std::move(peers);
     return offset;
 }
@@ -86,6 +107,8 @@ std::size_t sharpen::RaftSnapshotMetadata::UnsafeStoreTo(char *data) const noexc
     offset += builder.UnsafeStoreTo(data);
     builder.Set(this->lastTerm_);
     offset += builder.UnsafeStoreTo(data + offset);
+    builder.Set(this->checksum_);
+    offset += builder.UnsafeStoreTo(data + offset);
     offset += sharpen::BinarySerializator::UnsafeStoreTo(this->peers_,data + offset);
     return offset;
 }
\ No newline at end of file
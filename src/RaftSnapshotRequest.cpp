@@ -86,7 +86,7 @@ std::size_t sharpen::RaftSnapshotRequest::LoadFrom(const char *data, std::size_t
         throw sharpen::CorruptedDataError{"corrupted raft snapshot request"};
     }
     sharpen::RaftSnapshotMetadata metadata;
-    offset += sharpen::BinarySerializator::LoadFrom(metadata, data, size);
+    offset += sharpen::BinarySerializator::LoadFrom(metadata, data + offset, size - offset);
     if (size < 2 + offset) {
         throw sharpen::CorruptedDataError{"corrupted raft snapshot request"};
     }
@@ -99,7 +99,7 @@ std::size_t sharpen::RaftSnapshotRequest::LoadFrom(const char *data, std::size_t
     this->term_ = term;
     this->offset_ = off;
     this->last_ = last;
-    this->metadata_ = metadata;
+    this->metadata_ = std::move(metadata);
     this->data_ = std::move(chunkdata);
     this->leaseRound_ = builder.Get();
     return offset;
@@ -117,9 +117,9 @@ std::size_t sharpen::RaftSnapshotRequest::UnsafeStoreTo(char *data) const noexce
         last = 1;
     }
     offset += sharpen::BinarySerializator::UnsafeStoreTo(last, data + offset);
-    offset += sharpen::BinarySerializator::UnsafeStoreTo(this->metadata_, data);
+    offset += sharpen::BinarySerializator::UnsafeStoreTo(this->metadata_, data + offset);
     offset += sharpen::BinarySerializator::UnsafeStoreTo(this->data_, data + offset);
     builder.Set(this->leaseRound_);
-    offset += sharpen::BinarySerializator::UnsafeStoreTo(this->leaseRound_,data + offset);
+    offset += sharpen::BinarySerializator::UnsafeStoreTo(builder,data + offset);
     return offset;
 }
\ No newline at end of file
@@ -7,25 +7,29 @@ sharpen::RaftSnapshotResponse::RaftSnapshotResponse() noexcept
     : status_(false)
     , term_(sharpen::ConsensusWriter::noneEpoch)
     , peersEpoch_(0)
-    , leaseRound_(0) {
+    , leaseRound_(0)
+    , offset_(0) {
 }
 
 sharpen::RaftSnapshotResponse::RaftSnapshotResponse(bool status, std::uint64_t term) noexcept
     : status_(status)
     , term_(term)
     , peersEpoch_(0)
-    , leaseRound_(0) {
+    , leaseRound_(0)
+    , offset_(0) {
 }
 
 sharpen::RaftSnapshotResponse::RaftSnapshotResponse(Self &&other) noexcept
     : status_(other.status_)
     , term_(other.term_)
     , peersEpoch_(other.peersEpoch_)
-    , leaseRound_(other.leaseRound_) {
+    , leaseRound_(other.leaseRound_)
+    , offset_(other.offset_) {
     other.status_ = false;
     other.term_ = sharpen::ConsensusWriter::noneEpoch;
     other.peersEpoch_ = 0;
     other.leaseRound_ = 0;
+    other.offset_ = 0;
 }
 
 sharpen::RaftSnapshotResponse &sharpen::RaftSnapshotResponse::operator=(
@@ -35,6 +39,7 @@ sharpen::RaftSnapshotResponse &sharpen::RaftSnapshotResponse::operator=(
         this->term_ = other.term_;
         this->peersEpoch_ = other.peersEpoch_;
         this->leaseRound_ = other.leaseRound_;
+        this->offset_ = other.offset_;
     }
     return *this;
 }
@@ -45,10 +50,12 @@ sharpen::RaftSnapshotResponse &sharpen::RaftSnapshotResponse::operator=(Self &&o
         this->term_ = other.term_;
         this->peersEpoch_ = other.peersEpoch_;
         this->leaseRound_ = other.leaseRound_;
+        this->offset_ = other.offset_;
         other.status_ = false;
         other.term_ = sharpen::ConsensusWriter::noneEpoch;
         other.peersEpoch_ = 0;
         other.leaseRound_ = 0;
+        other.offset_ = 0;
     }
     return *this;
 }
@@ -61,11 +68,13 @@ std::size_t sharpen::RaftSnapshotResponse::ComputeSize() const noexcept {
     size += sharpen::BinarySerializator::ComputeSize(builder);
     builder.Set(this->leaseRound_);
     size += sharpen::BinarySerializator::ComputeSize(builder);
+    builder.Set(this->offset_);
+    size += sharpen::BinarySerializator::ComputeSize(builder);
     return size;
 }
 
 std::size_t sharpen::RaftSnapshotResponse::LoadFrom(const char *data, std::size_t size) {
-    if (size < 4) {
+    if (size < 5) {
         throw sharpen::CorruptedDataError{"corrupted raft snapshot response"};
     }
     std::size_t offset{0};
@@ -76,16 +85,21 @@ std::size_t sharpen::RaftSnapshotResponse::LoadFrom(const char *data, std::size_
     sharpen::Varuint64 builder{0};
     offset += sharpen::BinarySerializator::LoadFrom(builder,data + offset,size - offset);
     this->term_ = builder.Get();
-    if (size < 2 + offset) {
+    if (size < 3 + offset) {
         throw sharpen::CorruptedDataError{"corrupted raft snapshot response"};
     }
     offset += sharpen::BinarySerializator::LoadFrom(builder,data + offset,size - offset);
     this->peersEpoch_ = builder.Get();
-    if (size < 1 + offset) {
+    if (size < 2 + offset) {
         throw sharpen::CorruptedDataError{"corrupted raft snapshot response"};
     }
     offset += sharpen::BinarySerializator::LoadFrom(builder,data + offset,size - offset);
     this->leaseRound_ = builder.Get();
+    if (size < 1 + offset) {
+        throw sharpen::CorruptedDataError{"corrupted raft snapshot response"};
+    }
+    offset += sharpen::BinarySerializator::LoadFrom(builder,data + offset,size - offset);
+    this->offset_ = builder.Get();
     return offset;
 }
 
@@ -100,5 +114,7 @@ std::size_t sharpen::RaftSnapshotResponse::UnsafeStoreTo(char *data) const noexc
     offset += sharpen::BinarySerializator::UnsafeStoreTo(builder,data + offset);
     builder.Set(this->leaseRound_);
     offset += sharpen::BinarySerializator::UnsafeStoreTo(builder,data + offset);
+    builder.Set(this->offset_);
+    offset += sharpen::BinarySerializator::UnsafeStoreTo(builder,data + offset);
     return offset;
 }
\ No newline at end of file
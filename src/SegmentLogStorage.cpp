@@ -0,0 +1,371 @@
+#include <sharpen/SegmentLogStorage.hpp>
+
+#include <sharpen/Directory.hpp>
+#include <sharpen/EventLoop.hpp>
+#include <sharpen/FileOps.hpp>
+#include <algorithm>
+#include <cassert>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+#include <new>
+#include <vector>
+
+sharpen::SegmentLogStorage::SegmentLogStorage(std::string name)
+    : Self{sharpen::GetLocalLoopGroup(), std::move(name)} {
+}
+
+sharpen::SegmentLogStorage::SegmentLogStorage(sharpen::IEventLoopGroup &loopGroup,
+                                              std::string name)
+    : Self{loopGroup, std::move(name), defaultSegmentSize_} {
+}
+
+sharpen::SegmentLogStorage::SegmentLogStorage(sharpen::IEventLoopGroup &loopGroup,
+                                              std::string name,
+                                              std::size_t segmentSize)
+    : name_(std::move(name))
+    , loopGroup_(&loopGroup)
+    , lock_(nullptr)
+    , segmentSize_(segmentSize)
+    , segments_()
+    , lastIndex_(noneIndex)
+    , dropIndex_(noneIndex) {
+    assert(!this->name_.empty());
+    assert(this->segmentSize_);
+    sharpen::AsyncRwLock *lock{new (std::nothrow) sharpen::AsyncRwLock{}};
+    if (!lock) {
+        throw std::bad_alloc{};
+    }
+    this->lock_.reset(lock);
+    this->Load();
+}
+
+std::string sharpen::SegmentLogStorage::GetSegmentName(std::uint64_t beginIndex) const {
+    char buf[32] = {0};
+    std::snprintf(buf, sizeof(buf), "%020" PRIu64 ".seg", beginIndex);
+    std::string name{this->name_};
+    name.push_back('/');
+    name.append(buf);
+    return name;
+}
+
+void sharpen::SegmentLogStorage::Load() {
+    // 20 digits and ".seg"
+    constexpr std::size_t nameSize{24};
+    sharpen::MakeDirectory(this->name_.c_str());
+    std::vector<std::uint64_t> indexes;
+    {
+        sharpen::Directory dir{this->name_};
+        sharpen::Dentry entry{dir.GetNextEntry()};
+        while (entry.Valid()) {
+            const std::string &name{entry.Name()};
+            if (entry.GetType() == sharpen::FileEntryType::File && name.size() == nameSize &&
+                !std::strcmp(name.c_str() + nameSize - 4, ".seg")) {
+                indexes.emplace_back(std::strtoull(name.c_str(), nullptr, 10));
+            }
+            entry = dir.GetNextEntry();
+        }
+    }
+    std::sort(indexes.begin(), indexes.end());
+    bool intact{true};
+    for (std::size_t i = 0; i != indexes.size(); ++i) {
+        std::string name{this->GetSegmentName(indexes[i])};
+        if (!intact) {
+            // the log must be continuous
+            // remove segments after the broken one
+            sharpen::RemoveFile(name.c_str());
+            continue;
+        }
+        bool last{i + 1 == indexes.size()};
+        sharpen::FileChannelPtr channel{sharpen::OpenFileChannel(
+            name.c_str(), sharpen::FileAccessMethod::All, sharpen::FileOpenMethod::Open)};
+        channel->Register(*this->loopGroup_);
+        sharpen::LogSegment *segment{new (std::nothrow) sharpen::LogSegment{
+            std::move(name), std::move(channel), indexes[i], this->segmentSize_}};
+        if (!segment) {
+            throw std::bad_alloc{};
+        }
+        SegmentPtr segmentPtr{segment};
+        // only the tail of last segment may be torn
+        intact = segment->Load(last, this->dropIndex_);
+        if (segment->Empty()) {
+            segment->Remove();
+            continue;
+        }
+        segment->Seal();
+        this->segments_.emplace(indexes[i], std::move(segmentPtr));
+    }
+    if (!this->segments_.empty()) {
+        this->GetActiveSegment().Unseal(*this->loopGroup_);
+    }
+    this->ComputeLastIndex();
+}
+
+sharpen::LogSegment &sharpen::SegmentLogStorage::GetActiveSegment() noexcept {
+    assert(!this->segments_.empty());
+    return *this->segments_.rbegin()->second;
+}
+
+void sharpen::SegmentLogStorage::RollSegment(std::uint64_t beginIndex, std::size_t recordSize) {
+    if (!this->segments_.empty()) {
+        auto ite = std::prev(this->segments_.end());
+        if (ite->second->Empty()) {
+            this->RemoveSegment(ite);
+        } else {
+            ite->second->Flush();
+            ite->second->Seal();
+        }
+    }
+    std::string name{this->GetSegmentName(beginIndex)};
+    sharpen::FileChannelPtr channel{sharpen::OpenFileChannel(
+        name.c_str(), sharpen::FileAccessMethod::All, sharpen::FileOpenMethod::CreateOrOpen)};
+    channel->Truncate();
+    channel->Register(*this->loopGroup_);
+    channel->EnableRegisteredIo();
+    std::size_t capacity{(std::max)(this->segmentSize_, recordSize)};
+    sharpen::LogSegment *segment{new (std::nothrow) sharpen::LogSegment{
+        std::move(name), std::move(channel), beginIndex, capacity}};
+    if (!segment) {
+        throw std::bad_alloc{};
+    }
+    this->segments_[beginIndex].reset(segment);
+}
+
+void sharpen::SegmentLogStorage::RemoveSegment(Segments::iterator ite) noexcept {
+    ite->second->Remove();
+    this->segments_.erase(ite);
+}
+
+void sharpen::SegmentLogStorage::ComputeLastIndex() noexcept {
+    this->lastIndex_ = noneIndex;
+    for (auto begin = this->segments_.rbegin(), end = this->segments_.rend(); begin != end;
+         ++begin) {
+        if (!begin->second->Empty()) {
+            this->lastIndex_ = begin->second->GetEndIndex() - 1;
+            return;
+        }
+    }
+}
+
+sharpen::Optional<sharpen::ByteBuffer> sharpen::SegmentLogStorage::DoLookup(
+    std::uint64_t index) const {
+    if (index < this->dropIndex_ || index > this->lastIndex_) {
+        return sharpen::EmptyOpt;
+    }
+    auto ite = this->segments_.upper_bound(index);
+    if (ite == this->segments_.begin()) {
+        return sharpen::EmptyOpt;
+    }
+    --ite;
+    return ite->second->Lookup(index);
+}
+
+std::size_t sharpen::SegmentLogStorage::SkipExisted(std::uint64_t beginIndex,
+                                                    const sharpen::ByteSlice *entries,
+                                                    std::size_t count) {
+    for (std::size_t i = 0; i != count; ++i) {
+        std::uint64_t index{beginIndex + i};
+        if (index > this->lastIndex_) {
+            return i;
+        }
+        // has been compacted
+        if (index < this->dropIndex_) {
+            continue;
+        }
+        sharpen::Optional<sharpen::ByteBuffer> entry{this->DoLookup(index)};
+        if (entry.Exist() && entry.Get().GetSize() == entries[i].GetSize() &&
+            !std::memcmp(entry.Get().Data(), entries[i].Data(), entries[i].GetSize())) {
+            continue;
+        }
+        // conflict
+        // remove the entry and all that follow it
+        this->DoTruncateFrom(index);
+        return i;
+    }
+    return count;
+}
+
+void sharpen::SegmentLogStorage::Append(std::uint64_t beginIndex,
+                                        const sharpen::ByteSlice *entries,
+                                        std::size_t count) {
+    assert(count != 0);
+    bool roll{this->segments_.empty() ||
+              this->GetActiveSegment().GetEndIndex() != beginIndex};
+    sharpen::ByteBuffer buf;
+    std::size_t length{0};
+    try {
+        for (std::size_t i = 0; i != count; ++i) {
+            std::size_t recordSize{sharpen::LogSegment::ComputeRecordSize(entries[i].GetSize())};
+            if (!roll && !this->GetActiveSegment().Writable(length + recordSize)) {
+                roll = true;
+            }
+            if (roll || length + recordSize > maxPendingSize_) {
+                if (length) {
+                    this->GetActiveSegment().Append(buf.Data(), length);
+                    length = 0;
+                }
+                if (roll) {
+                    this->RollSegment(beginIndex + i, recordSize);
+                    roll = false;
+                }
+            }
+            if (buf.GetSize() < length + recordSize) {
+                buf.ExtendTo(length + recordSize);
+            }
+            sharpen::LogSegment::WriteRecord(buf.Data() + length,
+                                             sharpen::LogSegment::entryTag_,
+                                             beginIndex + i,
+                                             entries[i]);
+            length += recordSize;
+        }
+        if (length) {
+            this->GetActiveSegment().Append(buf.Data(), length);
+        }
+        this->GetActiveSegment().Flush();
+    } catch (const std::exception &) {
+        this->ComputeLastIndex();
+        throw;
+    }
+    this->lastIndex_ = beginIndex + count - 1;
+}
+
+void sharpen::SegmentLogStorage::DoTruncateFrom(std::uint64_t index) {
+    if (index > this->lastIndex_) {
+        return;
+    }
+    while (!this->segments_.empty()) {
+        auto ite = std::prev(this->segments_.end());
+        if (ite->first < index) {
+            break;
+        }
+        this->RemoveSegment(ite);
+    }
+    if (!this->segments_.empty()) {
+        sharpen::LogSegment &segment{this->GetActiveSegment()};
+        segment.Unseal(*this->loopGroup_);
+        segment.TruncateFrom(index);
+        segment.Flush();
+        // drop records may be truncated
+        if (this->dropIndex_ > this->segments_.begin()->first) {
+            this->WriteDropRecord();
+        }
+    }
+    this->ComputeLastIndex();
+}
+
+void sharpen::SegmentLogStorage::WriteDropRecord() {
+    assert(!this->segments_.empty());
+    char buf[sharpen::LogSegment::headerSize_];
+    sharpen::LogSegment::WriteRecord(
+        buf, sharpen::LogSegment::dropTag_, this->dropIndex_, sharpen::ByteSlice{});
+    if (!this->GetActiveSegment().Writable(sizeof(buf))) {
+        this->RollSegment(this->GetActiveSegment().GetEndIndex(), sizeof(buf));
+    }
+    this->GetActiveSegment().Append(buf, sizeof(buf));
+    this->GetActiveSegment().Flush();
+}
+
+sharpen::Optional<sharpen::ByteBuffer> sharpen::SegmentLogStorage::NviLookup(
+    std::uint64_t index) const {
+    this->lock_->LockRead();
+    std::unique_lock<sharpen::AsyncRwLock> lock{*this->lock_, std::adopt_lock};
+    return this->DoLookup(index);
+}
+
+void sharpen::SegmentLogStorage::NviWrite(std::uint64_t index, sharpen::ByteSlice log) {
+    this->lock_->LockWrite();
+    std::unique_lock<sharpen::AsyncRwLock> lock{*this->lock_, std::adopt_lock};
+    if (this->SkipExisted(index, &log, 1)) {
+        return;
+    }
+    this->Append(index, &log, 1);
+}
+
+void sharpen::SegmentLogStorage::NviWriteBatch(std::uint64_t beginIndex,
+                                               sharpen::LogEntries entries) {
+    std::vector<sharpen::ByteSlice> slices;
+    slices.reserve(entries.GetSize());
+    for (std::size_t i = 0; i != entries.GetSize(); ++i) {
+        slices.emplace_back(entries.Get(i).GetSlice());
+    }
+    this->lock_->LockWrite();
+    std::unique_lock<sharpen::AsyncRwLock> lock{*this->lock_, std::adopt_lock};
+    std::size_t skip{this->SkipExisted(beginIndex, slices.data(), slices.size())};
+    if (skip != slices.size()) {
+        this->Append(beginIndex + skip, slices.data() + skip, slices.size() - skip);
+    }
+}
+
+void sharpen::SegmentLogStorage::NviDropUntil(std::uint64_t endIndex) noexcept {
+    this->lock_->LockWrite();
+    std::unique_lock<sharpen::AsyncRwLock> lock{*this->lock_, std::adopt_lock};
+    if (endIndex <= this->dropIndex_) {
+        return;
+    }
+    // keep the active segment
+    while (this->segments_.size() > 1) {
+        auto ite = this->segments_.begin();
+        if (ite->second->GetEndIndex() > endIndex) {
+            break;
+        }
+        this->RemoveSegment(ite);
+    }
+    this->dropIndex_ = endIndex;
+    if (!this->segments_.empty() && this->segments_.begin()->first < endIndex) {
+        try {
+            this->WriteDropRecord();
+        } catch (const std::exception &ignore) {
+            // dropped entries may come back after restarting
+            (void)ignore;
+        }
+    }
+}
+
+void sharpen::SegmentLogStorage::NviTruncateFrom(std::uint64_t index) {
+    this->lock_->LockWrite();
+    std::unique_lock<sharpen::AsyncRwLock> lock{*this->lock_, std::adopt_lock};
+    this->DoTruncateFrom(index);
+}
+
+std::uint64_t sharpen::SegmentLogStorage::GetLastIndex() const {
+    this->lock_->LockRead();
+    std::unique_lock<sharpen::AsyncRwLock> lock{*this->lock_, std::adopt_lock};
+    return this->lastIndex_;
+}
+
+std::size_t sharpen::SegmentLogStorage::GetSegmentCount() const {
+    this->lock_->LockRead();
+    std::unique_lock<sharpen::AsyncRwLock> lock{*this->lock_, std::adopt_lock};
+    return this->segments_.size();
+}
+
+sharpen::SegmentLogStorage::SegmentLogStorage(Self &&other) noexcept
+    : name_(std::move(other.name_))
+    , loopGroup_(other.loopGroup_)
+    , lock_(std::move(other.lock_))
+    , segmentSize_(other.segmentSize_)
+    , segments_(std::move(other.segments_))
+    , lastIndex_(other.lastIndex_)
+    , dropIndex_(other.dropIndex_) {
+    other.loopGroup_ = nullptr;
+    other.lastIndex_ = noneIndex;
+    other.dropIndex_ = noneIndex;
+}
+
+sharpen::SegmentLogStorage &sharpen::SegmentLogStorage::operator=(Self &&other) noexcept {
+    if (this != std::addressof(other)) {
+        this->name_ = std::move(other.name_);
+        this->loopGroup_ = other.loopGroup_;
+        this->lock_ = std::move(other.lock_);
+        this->segmentSize_ = other.segmentSize_;
+        this->segments_ = std::move(other.segments_);
+        this->lastIndex_ = other.lastIndex_;
+        this->dropIndex_ = other.dropIndex_;
+        other.loopGroup_ = nullptr;
+        other.lastIndex_ = noneIndex;
+        other.dropIndex_ = noneIndex;
+    }
+    return *this;
+}
@@ -6,13 +6,19 @@
 #include <sharpen/SelectorOps.hpp>
 
 sharpen::SelectorPtr sharpen::MakeDefaultSelector() {
+    return sharpen::MakeDefaultSelector(sharpen::NetIoMethod::Readiness);
+}
+
+sharpen::SelectorPtr sharpen::MakeDefaultSelector(sharpen::NetIoMethod netIoMethod) {
 #ifdef SHARPEN_HAS_IOCP
     // use iocp
+    (void)netIoMethod;
     return std::make_shared<sharpen::IocpSelector>();
 #elif (defined(SHARPEN_HAS_EPOLL))
     // use epoll
-    return std::make_shared<sharpen::EpollSelector>();
+    return std::make_shared<sharpen::EpollSelector>(netIoMethod);
 #else
+    (void)netIoMethod;
     throw std::logic_error("no surported system");
 #endif
 }
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include <sharpen/SingleWorkerGroup.hpp>
 #include <sharpen/SystemError.hpp>
 #include <sharpen/YieldOps.hpp>
+#include <mutex>
 #include <new>
 
 void sharpen::TcpActor::DoReceive(sharpen::Mail response) noexcept {
@@ -13,16 +14,41 @@ void sharpen::TcpActor::DoReceive(sharpen::Mail response) noexcept {
     this->ackCount_.fetch_add(1, std::memory_order::memory_order_acq_rel);
 }
 
-void sharpen::TcpActor::DoPostShared(const sharpen::Mail *mail) noexcept {
+void sharpen::TcpActor::DoPipelineReceive(std::size_t generation,
+                                          sharpen::Mail response) noexcept {
+    // the responses of detached mails are still useful to receiver
+    if (!response.Empty()) {
+        this->receiver_->Receive(std::move(response), this->GetId());
+    }
+    std::unique_lock<sharpen::SpinLock> lock{this->lock_};
+    // Cancel() has acked the mails of older generations
+    if (generation == this->generation_) {
+        this->ackCount_.fetch_add(1, std::memory_order::memory_order_acq_rel);
+    }
+}
+
+void sharpen::TcpActor::DoPostFailed(std::size_t generation) noexcept {
+    if (!this->pipeline_) {
+        this->ackCount_.fetch_add(1, std::memory_order::memory_order_acq_rel);
+        return;
+    }
+    this->DoPipelineReceive(generation, sharpen::Mail{});
+    this->sentCount_.fetch_add(1, std::memory_order::memory_order_acq_rel);
+}
+
+void sharpen::TcpActor::DoPostShared(const sharpen::Mail *mail, std::size_t generation) noexcept {
     assert(mail);
-    this->postCount_.fetch_add(1, std::memory_order::memory_order_acq_rel);
+    // pipelined posts are counted when they are submitted
+    if (!this->pipeline_) {
+        this->postCount_.fetch_add(1, std::memory_order::memory_order_acq_rel);
+    }
     if (!this->poster_->Available()) {
         try {
             std::unique_ptr<sharpen::IMailParser> parser{this->parserFactory_->Produce()};
             this->poster_->Open(std::move(parser));
         } catch (const sharpen::RemotePosterOpenError &ignore) {
             (void)ignore;
-            this->ackCount_.fetch_add(1, std::memory_order::memory_order_acq_rel);
+            this->DoPostFailed(generation);
             return;
         } catch (const std::system_error &error) {
             sharpen::ErrorCode errorCode{sharpen::GetErrorCode(error)};
@@ -31,24 +57,28 @@ void sharpen::TcpActor::DoPostShared(const sharpen::Mail *mail) noexcept {
             }
             assert(!error.what() && "fail to post mail");
             (void)error;
-            this->ackCount_.fetch_add(1, std::memory_order::memory_order_acq_rel);
+            this->DoPostFailed(generation);
             return;
         } catch (const std::exception &ignore) {
             assert(!ignore.what() && "fail to post mail");
             (void)ignore;
-            this->ackCount_.fetch_add(1, std::memory_order::memory_order_acq_rel);
+            this->DoPostFailed(generation);
             return;
         }
     }
-    if (this->pipelineCb_) {
-        return this->poster_->Post(*mail, this->pipelineCb_);
+    if (this->pipeline_) {
+        this->poster_->Post(
+            *mail, std::bind(&Self::DoPipelineReceive, this, generation, std::placeholders::_1));
+        // Cancel() waits for the mail to be written
+        this->sentCount_.fetch_add(1, std::memory_order::memory_order_acq_rel);
+        return;
     }
     sharpen::Mail response{this->poster_->Post(*mail)};
     this->DoReceive(std::move(response));
 }
 
-void sharpen::TcpActor::DoPost(sharpen::Mail mail) noexcept {
-    this->DoPostShared(&mail);
+void sharpen::TcpActor::DoPost(sharpen::Mail mail, std::size_t generation) noexcept {
+    this->DoPostShared(&mail, generation);
 }
 
 sharpen::RemoteActorStatus sharpen::TcpActor::GetStatus() const noexcept {
@@ -95,10 +125,33 @@ void sharpen::TcpActor::Drain() noexcept {
 }
 
 bool sharpen::TcpActor::SupportPipeline() const noexcept {
-    return this->pipelineCb_ != nullptr;
+    return this->pipeline_;
+}
+
+void sharpen::TcpActor::CancelPipeline() noexcept {
+    std::size_t postCount{0};
+    {
+        std::unique_lock<sharpen::SpinLock> lock{this->lock_};
+        postCount = this->postCount_.load(std::memory_order::memory_order_acquire);
+        if (postCount == this->ackCount_.load(std::memory_order::memory_order_acquire)) {
+            return;
+        }
+        // keep the connection, closing it drops the responses on the way
+        // a broken connection is closed when reading or writing fails
+        this->generation_ += 1;
+        this->ackCount_.store(postCount, std::memory_order::memory_order_release);
+    }
+    // the post worker may still use the shared mails
+    while (this->sentCount_.load(std::memory_order::memory_order_acquire) < postCount) {
+        sharpen::YieldCycleForBusyLoop();
+    }
 }
 
 void sharpen::TcpActor::Cancel() noexcept {
+    if (this->pipeline_) {
+        this->CancelPipeline();
+        return;
+    }
     std::size_t ackCount{this->ackCount_.load(std::memory_order::memory_order_acquire)};
     std::size_t postCount{this->postCount_.load(std::memory_order::memory_order_acquire)};
     // if pipeline is not empty
@@ -137,12 +190,50 @@ void sharpen::TcpActor::Close() noexcept {
     }
 }
 
+std::size_t sharpen::TcpActor::CountPipelinedPost() noexcept {
+    // Cancel() must see the post and the generation together
+    std::unique_lock<sharpen::SpinLock> lock{this->lock_};
+    // count mails in the queue of worker
+    // so that the pipeline count limits the queue length
+    this->postCount_.fetch_add(1, std::memory_order::memory_order_acq_rel);
+    return this->generation_;
+}
+
+void sharpen::TcpActor::UncountPipelinedPost(std::size_t generation) noexcept {
+    std::unique_lock<sharpen::SpinLock> lock{this->lock_};
+    this->postCount_.fetch_sub(1, std::memory_order::memory_order_acq_rel);
+    // the mail has been acked by Cancel()
+    if (generation != this->generation_) {
+        this->ackCount_.fetch_sub(1, std::memory_order::memory_order_acq_rel);
+    }
+}
+
 void sharpen::TcpActor::NviPost(sharpen::Mail mail) {
-    this->postWorker_->Submit(&Self::DoPost, this, std::move(mail));
+    if (!this->pipeline_) {
+        this->postWorker_->Submit(&Self::DoPost, this, std::move(mail), 0);
+        return;
+    }
+    std::size_t generation{this->CountPipelinedPost()};
+    try {
+        this->postWorker_->Submit(&Self::DoPost, this, std::move(mail), generation);
+    } catch (const std::exception &) {
+        this->UncountPipelinedPost(generation);
+        throw;
+    }
 }
 
 void sharpen::TcpActor::NviPostShared(const sharpen::Mail &mail) {
-    this->postWorker_->Submit(&Self::DoPostShared, this, &mail);
+    if (!this->pipeline_) {
+        this->postWorker_->Submit(&Self::DoPostShared, this, &mail, 0);
+        return;
+    }
+    std::size_t generation{this->CountPipelinedPost()};
+    try {
+        this->postWorker_->Submit(&Self::DoPostShared, this, &mail, generation);
+    } catch (const std::exception &) {
+        this->UncountPipelinedPost(generation);
+        throw;
+    }
 }
 
 sharpen::TcpActor::TcpActor(sharpen::IFiberScheduler &scheduler,
@@ -161,9 +252,12 @@ sharpen::TcpActor::TcpActor(sharpen::IFiberScheduler &scheduler,
     , postCount_(0)
     , ackCount_(0)
     , parserFactory_(std::move(factory))
-    , pipelineCb_()
+    , pipeline_(false)
     , poster_(std::move(poster))
-    , postWorker_(nullptr) {
+    , postWorker_(nullptr)
+    , lock_()
+    , generation_(0)
+    , sentCount_(0) {
     assert(this->parserFactory_);
     assert(this->poster_);
     sharpen::IWorkerGroup *worker{new (std::nothrow) sharpen::SingleWorkerGroup{scheduler}};
@@ -171,9 +265,7 @@ sharpen::TcpActor::TcpActor(sharpen::IFiberScheduler &scheduler,
         throw std::bad_alloc{};
     }
     this->postWorker_.reset(worker);
-    if (enablePipeline && this->poster_->SupportPipeline()) {
-        this->pipelineCb_ = std::bind(&Self::DoReceive, this, std::placeholders::_1);
-    }
+    this->pipeline_ = enablePipeline && this->poster_->SupportPipeline();
 }
 
 sharpen::TcpActor::~TcpActor() noexcept {
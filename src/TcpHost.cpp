@@ -1,6 +1,8 @@
 #include <sharpen/TcpHost.hpp>
 
+#include <sharpen/AwaitableFuture.hpp>
 #include <sharpen/YieldOps.hpp>
+#include <exception>
 
 
 #ifndef _NDEBUG
@@ -12,16 +14,43 @@ sharpen::TcpHost::TcpHost(sharpen::ITcpSteamFactory &factory)
 }
 
 sharpen::TcpHost::TcpHost(sharpen::IFiberScheduler &scheduler, sharpen::ITcpSteamFactory &factory)
+    : Self{scheduler, factory, Self::GetDefaultOption()} {
+}
+
+sharpen::TcpHost::TcpHost(sharpen::ITcpSteamFactory &factory,
+                          const sharpen::TcpStreamOption &option)
+    : Self{sharpen::GetLocalScheduler(), factory, option} {
+}
+
+sharpen::TcpHost::TcpHost(sharpen::IFiberScheduler &scheduler,
+                          sharpen::ITcpSteamFactory &factory,
+                          const sharpen::TcpStreamOption &option)
     : scheduler_(&scheduler)
     , loopGroup_(&factory.GetLoopGroup())
     , token_(false)
     , pipeline_(nullptr)
-    , acceptor_(nullptr) {
+    , acceptors_() {
+    if (!option.IsEnableReusePort()) {
+        sharpen::NetStreamChannelPtr channel{factory.Produce(option)};
+        channel->Listen(65535);
+        this->acceptors_.emplace_back(std::move(channel));
+        return;
+    }
+    // the kernel balances connections between acceptors
+    std::size_t count{this->loopGroup_->GetLoopCount()};
+    this->acceptors_.reserve(count);
+    for (std::size_t i = 0; i != count; ++i) {
+        sharpen::NetStreamChannelPtr channel{
+            factory.Produce(option, this->loopGroup_->GetLoop(i))};
+        channel->Listen(65535);
+        this->acceptors_.emplace_back(std::move(channel));
+    }
+}
+
+sharpen::TcpStreamOption sharpen::TcpHost::GetDefaultOption() noexcept {
     sharpen::TcpStreamOption opt;
     opt.EnableReuseAddressInNix();
-    sharpen::NetStreamChannelPtr channel{factory.Produce(opt)};
-    channel->Listen(65535);
-    this->acceptor_ = std::move(channel);
+    return opt;
 }
 
 sharpen::TcpHost::~TcpHost() noexcept {
@@ -41,17 +70,18 @@ void sharpen::TcpHost::ConsumeChannel(sharpen::NetStreamChannelPtr channel,
 void sharpen::TcpHost::Stop() noexcept {
     this->pipeline_->Stop();
     this->token_ = false;
-    this->acceptor_->Close();
+    for (auto begin = this->acceptors_.begin(), end = this->acceptors_.end(); begin != end;
+         ++begin) {
+        (*begin)->Close();
+    }
 }
 
-void sharpen::TcpHost::Run() {
-    this->token_ = true;
-    assert(this->pipeline_);
-    std::atomic_size_t counter{0};
+void sharpen::TcpHost::Accept(sharpen::INetStreamChannel *acceptor, std::atomic_size_t *counter) {
+    assert(acceptor->IsRegistered());
     while (this->token_) {
         sharpen::NetStreamChannelPtr channel{nullptr};
         try {
-            channel = this->acceptor_->AcceptAsync();
+            channel = acceptor->AcceptAsync();
         } catch (const std::system_error &error) {
             sharpen::ErrorCode code{sharpen::GetErrorCode(error)};
             if (sharpen::IsFatalError(code)) {
@@ -64,14 +94,69 @@ void sharpen::TcpHost::Run() {
             continue;
         }
         if (this->token_ && channel) {
-            channel->Register(*this->loopGroup_);
-            counter.fetch_add(1);
+            if (this->acceptors_.size() != 1) {
+                // keep the channel on the accepting loop
+                channel->Register(*acceptor->GetLoop());
+            } else {
+                channel->Register(*this->loopGroup_);
+            }
+            counter->fetch_add(1);
             // launch
-            this->scheduler_->Launch(&Self::ConsumeChannel, this, std::move(channel), &counter);
+            this->scheduler_->Launch(&Self::ConsumeChannel, this, std::move(channel), counter);
+        }
+    }
+}
+
+void sharpen::TcpHost::DoAccept(sharpen::INetStreamChannel *acceptor,
+                                std::atomic_size_t *counter,
+                                sharpen::Future<void> *future) noexcept {
+    assert(future);
+    try {
+        this->Accept(acceptor, counter);
+        future->Complete();
+    } catch (const std::exception &) {
+        future->Fail(std::current_exception());
+    }
+}
+
+void sharpen::TcpHost::Run() {
+    this->token_ = true;
+    assert(this->pipeline_);
+    assert(!this->acceptors_.empty());
+    std::atomic_size_t counter{0};
+    std::size_t count{this->acceptors_.size()};
+    std::vector<sharpen::AwaitableFuture<void>> futures{count - 1};
+    // launch an accept fiber for each acceptor except the first one
+    for (std::size_t i = 1; i != count; ++i) {
+        this->scheduler_->Launch(
+            &Self::DoAccept, this, this->acceptors_[i].get(), &counter, &futures[i - 1]);
+    }
+    std::exception_ptr error{nullptr};
+    try {
+        this->Accept(this->acceptors_.front().get(), &counter);
+    } catch (const std::exception &) {
+        error = std::current_exception();
+        // stop other acceptors
+        this->token_ = false;
+        for (auto begin = this->acceptors_.begin(), end = this->acceptors_.end(); begin != end;
+             ++begin) {
+            (*begin)->Close();
+        }
+    }
+    for (auto begin = futures.begin(), end = futures.end(); begin != end; ++begin) {
+        try {
+            begin->Await();
+        } catch (const std::exception &) {
+            if (!error) {
+                error = std::current_exception();
+            }
         }
     }
     // FIXME:busy loop
     while (counter.load() != 0) {
         sharpen::YieldCycleForBusyLoop();
     }
+    if (error) {
+        std::rethrow_exception(error);
+    }
 }
\ No newline at end of file
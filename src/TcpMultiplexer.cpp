@@ -0,0 +1,343 @@
+#include <sharpen/TcpMultiplexer.hpp>
+
+#include <sharpen/MultiRaftMailBuilder.hpp>
+#include <sharpen/MultiRaftMailExtractor.hpp>
+#include <sharpen/RemotePosterOpenError.hpp>
+#include <sharpen/SingleWorkerGroup.hpp>
+#include <sharpen/SystemError.hpp>
+#include <mutex>
+#include <new>
+
+sharpen::TcpMultiplexer::BatchCallback::BatchCallback(std::uint32_t magic,
+                                                      std::vector<Callback> cbs) noexcept
+    : magic_(magic)
+    , cbs_(std::move(cbs)) {
+}
+
+void sharpen::TcpMultiplexer::BatchCallback::Fail() noexcept {
+    for (auto begin = this->cbs_.begin(), end = this->cbs_.end(); begin != end; ++begin) {
+        (*begin)(sharpen::Mail{});
+    }
+}
+
+void sharpen::TcpMultiplexer::BatchCallback::operator()(sharpen::Mail response) noexcept {
+    if (response.Empty()) {
+        return this->Fail();
+    }
+    sharpen::Optional<std::vector<sharpen::Mail>> mails{
+        sharpen::MultiRaftMailExtractor::ExtractBatch(
+            this->magic_, sharpen::RaftMailType::BatchResponse, response)};
+    if (!mails.Exist() || mails.Get().size() != this->cbs_.size()) {
+        return this->Fail();
+    }
+    for (std::size_t i = 0; i != this->cbs_.size(); ++i) {
+        this->cbs_[i](std::move(mails.Get()[i]));
+    }
+}
+
+sharpen::TcpMultiplexer::TcpMultiplexer(sharpen::IFiberScheduler &scheduler,
+                                        std::uint32_t magic,
+                                        std::shared_ptr<sharpen::IMailParserFactory> parserFactory,
+                                        std::unique_ptr<sharpen::IRemotePoster> poster)
+    : magic_(magic)
+    , parserFactory_(std::move(parserFactory))
+    , poster_(std::move(poster))
+    , postWorker_(nullptr)
+    , lock_()
+    , pending_()
+    , flushing_(false)
+    , batchCount_(0)
+    , waiterLock_()
+    , epoch_(0)
+    , sequence_(0)
+    , groupWaiters_()
+    , batchWaiters_() {
+    assert(this->parserFactory_);
+    assert(this->poster_);
+    sharpen::IWorkerGroup *worker{new (std::nothrow) sharpen::SingleWorkerGroup{scheduler}};
+    if (!worker) {
+        throw std::bad_alloc{};
+    }
+    this->postWorker_.reset(worker);
+}
+
+sharpen::TcpMultiplexer::~TcpMultiplexer() noexcept {
+    this->poster_->Close();
+    // pending callbacks refer to the waiters
+    this->postWorker_.reset();
+    this->poster_.reset();
+}
+
+std::size_t sharpen::TcpMultiplexer::GetMailSize(const PendingMail &pending) noexcept {
+    return pending.mail_.Header().GetSize() + pending.mail_.Content().GetSize();
+}
+
+bool sharpen::TcpMultiplexer::EnsureOpened() noexcept {
+    if (this->poster_->Available()) {
+        return true;
+    }
+    try {
+        std::unique_ptr<sharpen::IMailParser> parser{this->parserFactory_->Produce()};
+        this->poster_->Open(std::move(parser));
+        std::unique_lock<sharpen::SpinLock> lock{this->waiterLock_};
+        this->epoch_ += 1;
+    } catch (const sharpen::RemotePosterOpenError &ignore) {
+        (void)ignore;
+        return false;
+    } catch (const std::system_error &error) {
+        sharpen::ErrorCode errorCode{sharpen::GetErrorCode(error)};
+        if (sharpen::IsFatalError(errorCode)) {
+            std::terminate();
+        }
+        assert(!error.what() && "fail to post mail");
+        (void)error;
+        return false;
+    } catch (const std::exception &ignore) {
+        assert(!ignore.what() && "fail to post mail");
+        (void)ignore;
+        return false;
+    }
+    return true;
+}
+
+bool sharpen::TcpMultiplexer::TakeWaiter(std::size_t epoch,
+                                         const sharpen::Mail &response,
+                                         Callback &cb) noexcept {
+    std::unique_lock<sharpen::SpinLock> lock{this->waiterLock_};
+    sharpen::Optional<std::uint32_t> sequence{sharpen::MultiRaftMailExtractor::LookupBatchSequence(
+        this->magic_, sharpen::RaftMailType::BatchResponse, response)};
+    if (sequence.Exist()) {
+        auto ite = this->batchWaiters_.find(sequence.Get());
+        if (ite == this->batchWaiters_.end() || ite->second.epoch_ != epoch) {
+            return false;
+        }
+        cb = std::move(ite->second.cb_);
+        this->batchWaiters_.erase(ite);
+        return true;
+    }
+    sharpen::Optional<std::uint32_t> raftNumber{
+        sharpen::MultiRaftMailExtractor::LookupRaftNumber(this->magic_, response)};
+    if (!raftNumber.Exist()) {
+        raftNumber = sharpen::MultiRaftMailExtractor::LookupPlaceholder(this->magic_, response);
+    }
+    if (!raftNumber.Exist()) {
+        return false;
+    }
+    auto ite = this->groupWaiters_.find(raftNumber.Get());
+    if (ite == this->groupWaiters_.end()) {
+        return false;
+    }
+    // waiters of older connections are failed by their own callbacks
+    std::deque<Waiter> &waiters{ite->second};
+    for (auto begin = waiters.begin(), end = waiters.end(); begin != end; ++begin) {
+        if (begin->epoch_ == epoch) {
+            cb = std::move(begin->cb_);
+            waiters.erase(begin);
+            return true;
+        }
+    }
+    return false;
+}
+
+void sharpen::TcpMultiplexer::FailWaiters(std::size_t epoch) noexcept {
+    std::vector<Callback> cbs;
+    bool current{false};
+    {
+        std::unique_lock<sharpen::SpinLock> lock{this->waiterLock_};
+        current = epoch == this->epoch_;
+        for (auto begin = this->groupWaiters_.begin(), end = this->groupWaiters_.end();
+             begin != end;
+             ++begin) {
+            std::deque<Waiter> &waiters{begin->second};
+            for (auto ite = waiters.begin(); ite != waiters.end();) {
+                if (ite->epoch_ == epoch) {
+                    cbs.emplace_back(std::move(ite->cb_));
+                    ite = waiters.erase(ite);
+                } else {
+                    ++ite;
+                }
+            }
+        }
+        for (auto ite = this->batchWaiters_.begin(); ite != this->batchWaiters_.end();) {
+            if (ite->second.epoch_ == epoch) {
+                cbs.emplace_back(std::move(ite->second.cb_));
+                ite = this->batchWaiters_.erase(ite);
+            } else {
+                ++ite;
+            }
+        }
+    }
+    // the stream may be corrupted by a partial write
+    if (current) {
+        this->poster_->Close();
+    }
+    for (auto begin = cbs.begin(), end = cbs.end(); begin != end; ++begin) {
+        (*begin)(sharpen::Mail{});
+    }
+}
+
+void sharpen::TcpMultiplexer::OnResponse(std::size_t epoch, sharpen::Mail response) noexcept {
+    // the connection was aborted
+    if (response.Empty()) {
+        return this->FailWaiters(epoch);
+    }
+    Callback cb;
+    if (!this->TakeWaiter(epoch, response, cb)) {
+        // the peer does not speak our protocol
+        return this->FailWaiters(epoch);
+    }
+    if (sharpen::MultiRaftMailExtractor::LookupPlaceholder(this->magic_, response).Exist()) {
+        return cb(sharpen::Mail{});
+    }
+    cb(std::move(response));
+}
+
+void sharpen::TcpMultiplexer::DoPost(const sharpen::Mail &mail, std::size_t epoch) noexcept {
+    if (this->poster_->SupportPipeline()) {
+        return this->poster_->Post(
+            mail, std::bind(&Self::OnResponse, this, epoch, std::placeholders::_1));
+    }
+    sharpen::Mail response{this->poster_->Post(mail)};
+    this->OnResponse(epoch, std::move(response));
+}
+
+void sharpen::TcpMultiplexer::DoPostSingle(PendingMail &mail) noexcept {
+    sharpen::Optional<std::uint32_t> raftNumber{
+        sharpen::MultiRaftMailExtractor::LookupRaftNumber(this->magic_, mail.mail_)};
+    if (!raftNumber.Exist()) {
+        // the response could not be correlated
+        return mail.cb_(sharpen::Mail{});
+    }
+    std::size_t epoch{0};
+    try {
+        std::unique_lock<sharpen::SpinLock> lock{this->waiterLock_};
+        epoch = this->epoch_;
+        this->groupWaiters_[raftNumber.Get()].emplace_back(Waiter{epoch, std::move(mail.cb_)});
+    } catch (const std::bad_alloc &fault) {
+        (void)fault;
+        std::terminate();
+    }
+    this->DoPost(mail.mail_, epoch);
+}
+
+void sharpen::TcpMultiplexer::DoPostRange(std::vector<PendingMail> &mails,
+                                          std::size_t begin,
+                                          std::size_t end) noexcept {
+    assert(begin < end);
+    if (end - begin == 1) {
+        return this->DoPostSingle(mails[begin]);
+    }
+    std::vector<const sharpen::Mail *> batch;
+    std::vector<Callback> cbs;
+    std::size_t epoch{0};
+    std::uint32_t sequence{0};
+    sharpen::Mail request;
+    try {
+        batch.reserve(end - begin);
+        cbs.reserve(end - begin);
+        for (std::size_t i = begin; i != end; ++i) {
+            batch.emplace_back(&mails[i].mail_);
+            cbs.emplace_back(std::move(mails[i].cb_));
+        }
+        {
+            std::unique_lock<sharpen::SpinLock> lock{this->waiterLock_};
+            epoch = this->epoch_;
+            sequence = this->sequence_++;
+        }
+        request = sharpen::MultiRaftMailBuilder::BuildBatch(this->magic_,
+                                                            sharpen::RaftMailType::BatchRequest,
+                                                            sequence,
+                                                            batch.data(),
+                                                            batch.size());
+        std::unique_lock<sharpen::SpinLock> lock{this->waiterLock_};
+        this->batchWaiters_.emplace(sequence,
+                                    Waiter{epoch, BatchCallback{this->magic_, std::move(cbs)}});
+    } catch (const std::bad_alloc &fault) {
+        (void)fault;
+        std::terminate();
+    }
+    this->batchCount_.fetch_add(1, std::memory_order::memory_order_relaxed);
+    this->DoPost(request, epoch);
+}
+
+void sharpen::TcpMultiplexer::DoFlush() noexcept {
+    std::vector<PendingMail> mails;
+    {
+        std::unique_lock<sharpen::SpinLock> lock{this->lock_};
+        std::swap(mails, this->pending_);
+        this->flushing_ = false;
+    }
+    if (mails.empty()) {
+        return;
+    }
+    if (!this->EnsureOpened()) {
+        for (auto begin = mails.begin(), end = mails.end(); begin != end; ++begin) {
+            begin->cb_(sharpen::Mail{});
+        }
+        return;
+    }
+    std::size_t begin{0};
+    while (begin != mails.size()) {
+        std::size_t end{begin + 1};
+        std::size_t size{Self::GetMailSize(mails[begin])};
+        while (end != mails.size()) {
+            std::size_t next{Self::GetMailSize(mails[end])};
+            if (size + next > maxBatchSize_) {
+                break;
+            }
+            size += next;
+            end += 1;
+        }
+        this->DoPostRange(mails, begin, end);
+        begin = end;
+    }
+}
+
+void sharpen::TcpMultiplexer::Enqueue(PendingMail pending) {
+    std::size_t index{0};
+    {
+        std::unique_lock<sharpen::SpinLock> lock{this->lock_};
+        this->pending_.emplace_back(std::move(pending));
+        // a submitted flush will take this mail
+        if (this->flushing_) {
+            return;
+        }
+        this->flushing_ = true;
+        index = this->pending_.size() - 1;
+    }
+    try {
+        this->postWorker_->Submit(&Self::DoFlush, this);
+    } catch (const std::exception &) {
+        // the flush has not been submitted
+        // fail the mails queued by other threads since then
+        std::vector<PendingMail> mails;
+        {
+            std::unique_lock<sharpen::SpinLock> lock{this->lock_};
+            std::swap(mails, this->pending_);
+            this->flushing_ = false;
+        }
+        for (std::size_t i = 0; i != mails.size(); ++i) {
+            if (i != index) {
+                mails[i].cb_(sharpen::Mail{});
+            }
+        }
+        throw;
+    }
+}
+
+void sharpen::TcpMultiplexer::Post(sharpen::Mail mail, Callback cb) {
+    assert(cb);
+    this->Enqueue(PendingMail{std::move(mail), std::move(cb)});
+}
+
+void sharpen::TcpMultiplexer::Close() noexcept {
+    this->poster_->Close();
+}
+
+bool sharpen::TcpMultiplexer::Available() const noexcept {
+    return this->poster_->Available();
+}
+
+bool sharpen::TcpMultiplexer::SupportPipeline() const noexcept {
+    return this->poster_->SupportPipeline();
+}
@@ -1,5 +1,6 @@
 #include <sharpen/TcpPoster.hpp>
 
+#include <sharpen/EventLoop.hpp>
 #include <sharpen/SystemError.hpp>
 #include <cassert>
 #include <new>
@@ -102,27 +103,66 @@ void sharpen::TcpPoster::AbortConn(sharpen::INetStreamChannel *conn) noexcept {
     }
 }
 
+sharpen::ByteBuffer sharpen::TcpPoster::AcquireReceiveBuffer() {
+    sharpen::EventLoop *loop{sharpen::EventLoop::GetLocalLoop()};
+    if (loop) {
+        return loop->AcquireReceiveBuffer();
+    }
+    return sharpen::ByteBuffer{sharpen::EventLoop::receiveBufferSize};
+}
+
+void sharpen::TcpPoster::ReleaseReceiveBuffer(sharpen::ByteBuffer buffer) noexcept {
+    // the fiber may be resumed by another loop
+    sharpen::EventLoop *loop{sharpen::EventLoop::GetLocalLoop()};
+    if (loop) {
+        loop->ReleaseReceiveBuffer(std::move(buffer));
+    }
+}
+
+std::size_t sharpen::TcpPoster::DoRead(sharpen::INetStreamChannel &channel,
+                                       sharpen::ByteBuffer &buffer) {
+    std::size_t directSize{0};
+    char *direct{this->parser_->GetDirectBuffer(directSize)};
+    // read large content into the mail directly
+    // the rest of mail is never smaller than the read size
+    // so that the next mail would not be read
+    if (direct && directSize >= buffer.GetSize()) {
+        std::size_t size{channel.ReadAsync(direct, directSize)};
+        this->parser_->CommitDirectBuffer(size);
+        return size;
+    }
+    std::size_t size{channel.ReadAsync(buffer)};
+    this->parser_->Parse(buffer.GetSlice(0, size));
+    return size;
+}
+
 sharpen::Mail sharpen::TcpPoster::DoReceive(sharpen::NetStreamChannelPtr channel) noexcept {
-    std::size_t size{0};
-    sharpen::ByteBuffer buffer{4096};
+    sharpen::ByteBuffer buffer;
+    try {
+        buffer = Self::AcquireReceiveBuffer();
+    } catch (const std::bad_alloc &fault) {
+        // connection was aborted
+        this->AbortConn(channel.get());
+        (void)fault;
+        return sharpen::Mail{};
+    }
     sharpen::Mail response;
     while (!this->parser_->Completed()) {
-        size = channel->ReadAsync(buffer);
-        if (!size) {
-            // connection was aborted
-            this->AbortConn(channel.get());
-            return sharpen::Mail{};
-        }
-        sharpen::ByteSlice slice{buffer.Data(), size};
+        std::size_t size{0};
         try {
-            this->parser_->Parse(slice);
-        } catch (const sharpen::MailParseError &error) {
+            size = this->DoRead(*channel, buffer);
+        } catch (const std::exception &error) {
+            (void)error;
+            size = 0;
+        }
+        if (!size) {
             // connection was aborted
+            Self::ReleaseReceiveBuffer(std::move(buffer));
             this->AbortConn(channel.get());
-            (void)error;
             return sharpen::Mail{};
         }
     }
+    Self::ReleaseReceiveBuffer(std::move(buffer));
     response = this->parser_->PopCompletedMail();
     return response;
 }
@@ -133,58 +173,48 @@ void sharpen::TcpPoster::Receive(sharpen::NetStreamChannelPtr channel,
     cb(std::move(response));
 }
 
-void sharpen::TcpPoster::NviPost(const sharpen::Mail &mail,
-                                 std::function<void(sharpen::Mail)> cb) noexcept {
-    sharpen::NetStreamChannelPtr channel{nullptr};
-    {
-        assert(this->lock_);
-        std::unique_lock<sharpen::SpinLock> lock{*this->lock_};
-        channel = this->channel_;
-    }
-    if (!channel) {
-        cb(sharpen::Mail{});
-        return;
-    }
-    // post mail
+std::size_t sharpen::TcpPoster::WriteMail(sharpen::INetStreamChannel &channel,
+                                          const sharpen::Mail &mail) noexcept {
+    // write header and content by one syscall
+    sharpen::ByteSlice slices[2]{mail.Header().GetSlice(), mail.Content().GetSlice()};
+    std::size_t count{mail.Content().Empty() ? 1u : 2u};
     std::size_t size{0};
 #ifdef SHARPEN_IS_WIN
     try {
-        size = channel->WriteFixedAsync(mail.Header());
+        size = channel.WriteVectorFixedAsync(slices, count);
     } catch (const std::system_error &error) {
         (void)error;
 #ifndef _NDEBUG
         if (sharpen::GetErrorCode(error) != sharpen::ErrorNotConnected) {
-            assert("failed to write mail header to channel" && false);
+            assert("failed to write mail to channel" && false);
         }
 #endif
     }
 #else
-    size = channel->WriteFixedAsync(mail.Header());
+    size = channel.WriteVectorFixedAsync(slices, count);
 #endif
-    if (!size) {
+    if (size != mail.Header().GetSize() + mail.Content().GetSize()) {
+        return 0;
+    }
+    return size;
+}
+
+void sharpen::TcpPoster::NviPost(const sharpen::Mail &mail,
+                                 std::function<void(sharpen::Mail)> cb) noexcept {
+    sharpen::NetStreamChannelPtr channel{nullptr};
+    {
+        assert(this->lock_);
+        std::unique_lock<sharpen::SpinLock> lock{*this->lock_};
+        channel = this->channel_;
+    }
+    if (!channel) {
         cb(sharpen::Mail{});
         return;
     }
-    if (!mail.Content().Empty()) {
-        size = 0;
-#ifdef SHARPEN_IS_WIN
-        try {
-            size = channel->WriteFixedAsync(mail.Content());
-        } catch (const std::system_error &error) {
-            (void)error;
-#ifndef _NDEBUG
-            if (sharpen::GetErrorCode(error) != sharpen::ErrorNotConnected) {
-                assert("failed to write mail content to channel" && false);
-            }
-#endif
-        }
-#else
-        size = channel->WriteFixedAsync(mail.Content());
-#endif
-        if (!size) {
-            cb(sharpen::Mail{});
-            return;
-        }
+    // post mail
+    if (!Self::WriteMail(*channel, mail)) {
+        cb(sharpen::Mail{});
+        return;
     }
     // receive mail
     if (!this->pipelineWorker_) {
@@ -207,46 +237,10 @@ sharpen::Mail sharpen::TcpPoster::NviPost(const sharpen::Mail &mail) noexcept {
         return sharpen::Mail{};
     }
     // post mail
-    std::size_t size{0};
-#ifdef SHARPEN_IS_WIN
-    try {
-        size = channel->WriteFixedAsync(mail.Header());
-    } catch (const std::system_error &error) {
-        (void)error;
-#ifndef _NDEBUG
-        if (sharpen::GetErrorCode(error) != sharpen::ErrorNotConnected) {
-            assert("failed to write mail header to channel" && false);
-        }
-#endif
-    }
-#else
-    size = channel->WriteFixedAsync(mail.Header());
-#endif
-    if (!size) {
+    if (!Self::WriteMail(*channel, mail)) {
         AbortConn(channel.get());
         return sharpen::Mail{};
     }
-    if (!mail.Content().Empty()) {
-        size = 0;
-#ifdef SHARPEN_IS_WIN
-        try {
-            size = channel->WriteFixedAsync(mail.Content());
-        } catch (const std::system_error &error) {
-            (void)error;
-#ifndef _NDEBUG
-            if (sharpen::GetErrorCode(error) != sharpen::ErrorNotConnected) {
-                assert("failed to write mail content to channel" && false);
-            }
-#endif
-        }
-#else
-        size = channel->WriteFixedAsync(mail.Content());
-#endif
-        if (!size) {
-            AbortConn(channel.get());
-            return sharpen::Mail{};
-        }
-    }
     // receive mail
     sharpen::Mail response{this->DoReceive(std::move(channel))};
     return response;
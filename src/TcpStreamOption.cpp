@@ -3,18 +3,23 @@
 #include <sharpen/SystemMacro.hpp>
 
 sharpen::TcpStreamOption::TcpStreamOption() noexcept
-    : reuseAddr_(false) {
+    : reuseAddr_(false)
+    , reusePort_(false) {
 }
 
 sharpen::TcpStreamOption::TcpStreamOption(Self &&other) noexcept
-    : reuseAddr_(other.reuseAddr_) {
+    : reuseAddr_(other.reuseAddr_)
+    , reusePort_(other.reusePort_) {
     other.reuseAddr_ = false;
+    other.reusePort_ = false;
 }
 
 sharpen::TcpStreamOption &sharpen::TcpStreamOption::operator=(Self &&other) noexcept {
     if (this != std::addressof(other)) {
         this->reuseAddr_ = other.reuseAddr_;
+        this->reusePort_ = other.reusePort_;
         other.reuseAddr_ = false;
+        other.reusePort_ = false;
     }
     return *this;
 }
@@ -31,4 +36,12 @@ void sharpen::TcpStreamOption::EnableReuseAddressInNix() noexcept {
 #ifdef SHARPEN_IS_NIX
     this->EnableReuseAddress();
 #endif
+}
+
+bool sharpen::TcpStreamOption::IsEnableReusePort() const noexcept {
+    return this->reusePort_;
+}
+
+void sharpen::TcpStreamOption::SetReusePort(bool reuse) noexcept {
+    this->reusePort_ = reuse;
 }
\ No newline at end of file
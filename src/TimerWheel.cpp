@@ -0,0 +1,313 @@
+#include <sharpen/TimerWheel.hpp>
+#ifdef SHARPEN_HAS_TIMERWHEEL
+
+#include <sharpen/EventLoop.hpp>
+#include <sharpen/SystemError.hpp>
+#include <sys/timerfd.h>
+#include <time.h>
+#include <cassert>
+#include <cstring>
+#include <mutex>
+
+sharpen::TimerWheel::TimerWheel()
+    : Mybase()
+    , lock_()
+    , currentTick_(0)
+    , armedTick_(unarmed_)
+    , count_(0)
+    , nearCount_(0)
+    , near_()
+    , levels_()
+    , expired_() {
+    this->handle_ = ::timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (this->handle_ == -1) {
+        sharpen::ThrowLastError();
+    }
+    for (std::size_t i = 0; i != nearSize_; ++i) {
+        Self::InitSlot(this->near_[i]);
+    }
+    for (std::size_t i = 0; i != levelCount_; ++i) {
+        for (std::size_t j = 0; j != levelSize_; ++j) {
+            Self::InitSlot(this->levels_[i][j]);
+        }
+    }
+    this->expired_.reserve(reservedExpiredSize_);
+    this->currentTick_ = Self::GetTick(false);
+}
+
+void sharpen::TimerWheel::InitSlot(Node &head) noexcept {
+    head.prev_ = &head;
+    head.next_ = &head;
+    head.expire_ = 0;
+    head.future_ = nullptr;
+    head.level_ = 0;
+}
+
+bool sharpen::TimerWheel::IsEmptySlot(const Node &head) noexcept {
+    return head.next_ == &head;
+}
+
+void sharpen::TimerWheel::LinkBefore(Node &head, Node &node) noexcept {
+    node.next_ = &head;
+    node.prev_ = head.prev_;
+    head.prev_->next_ = &node;
+    head.prev_ = &node;
+}
+
+void sharpen::TimerWheel::Link(Node &node) noexcept {
+    std::uint64_t expire{node.expire_};
+    if (expire < this->currentTick_) {
+        expire = this->currentTick_;
+    }
+    std::uint64_t delta{expire - this->currentTick_};
+    if (delta < nearSize_) {
+        node.level_ = 0;
+        this->nearCount_ += 1;
+        Self::LinkBefore(this->near_[expire & nearMask_], node);
+        return;
+    }
+    // too far
+    // the node will be re-linked when it is cascaded
+    if (delta >= maxDelta_) {
+        delta = maxDelta_ - 1;
+        expire = this->currentTick_ + delta;
+    }
+    std::size_t level{0};
+    std::size_t shift{nearBits_};
+    while (delta >= (static_cast<std::uint64_t>(1) << (shift + levelBits_))) {
+        level += 1;
+        shift += levelBits_;
+    }
+    assert(level < levelCount_);
+    node.level_ = level + 1;
+    Self::LinkBefore(this->levels_[level][(expire >> shift) & levelMask_], node);
+}
+
+void sharpen::TimerWheel::Unlink(Node &node) noexcept {
+    assert(node.next_ != nullptr);
+    node.prev_->next_ = node.next_;
+    node.next_->prev_ = node.prev_;
+    node.prev_ = nullptr;
+    node.next_ = nullptr;
+    if (!node.level_) {
+        this->nearCount_ -= 1;
+    }
+}
+
+void sharpen::TimerWheel::Cascade(std::size_t level, std::size_t index) noexcept {
+    Node &head{this->levels_[level][index]};
+    if (Self::IsEmptySlot(head)) {
+        return;
+    }
+    Node *node{head.next_};
+    head.prev_->next_ = nullptr;
+    Self::InitSlot(head);
+    while (node) {
+        Node *next{node->next_};
+        this->Link(*node);
+        node = next;
+    }
+}
+
+void sharpen::TimerWheel::ExpireSlot(Node &head) {
+    while (!Self::IsEmptySlot(head)) {
+        Node *node{head.next_};
+        this->Unlink(*node);
+        this->count_ -= 1;
+        sharpen::Future<bool> *future{node->future_};
+        node->future_ = nullptr;
+        if (future) {
+            this->expired_.emplace_back(future);
+        }
+    }
+}
+
+void sharpen::TimerWheel::Advance(std::uint64_t now) {
+    while (this->currentTick_ < now) {
+        if (!this->count_) {
+            this->currentTick_ = now;
+            return;
+        }
+        if (!this->nearCount_) {
+            // skip to next cascade
+            std::uint64_t next{(this->currentTick_ | nearMask_) + 1};
+            if (next > now) {
+                this->currentTick_ = now;
+                return;
+            }
+            this->currentTick_ = next;
+        } else {
+            this->currentTick_ += 1;
+        }
+        if (!(this->currentTick_ & nearMask_)) {
+            std::size_t shift{nearBits_};
+            for (std::size_t level = 0; level != levelCount_; ++level) {
+                std::size_t index{
+                    static_cast<std::size_t>((this->currentTick_ >> shift) & levelMask_)};
+                this->Cascade(level, index);
+                if (index) {
+                    break;
+                }
+                shift += levelBits_;
+            }
+        }
+        this->ExpireSlot(this->near_[this->currentTick_ & nearMask_]);
+    }
+}
+
+std::uint64_t sharpen::TimerWheel::ComputeNextTick() const noexcept {
+    if (!this->count_) {
+        return unarmed_;
+    }
+    std::uint64_t next{unarmed_};
+    if (this->nearCount_) {
+        for (std::uint64_t i = 1; i <= nearSize_; ++i) {
+            std::uint64_t tick{this->currentTick_ + i};
+            if (!Self::IsEmptySlot(this->near_[tick & nearMask_])) {
+                next = tick;
+                break;
+            }
+        }
+    }
+    // wake up at the cascade of the first non-empty slot
+    std::size_t shift{nearBits_};
+    for (std::size_t level = 0; level != levelCount_; ++level) {
+        std::uint64_t base{this->currentTick_ >> shift};
+        for (std::uint64_t i = 1; i <= levelSize_; ++i) {
+            if (!Self::IsEmptySlot(this->levels_[level][(base + i) & levelMask_])) {
+                std::uint64_t tick{(base + i) << shift};
+                if (tick < next) {
+                    next = tick;
+                }
+                break;
+            }
+        }
+        shift += levelBits_;
+    }
+    return next;
+}
+
+void sharpen::TimerWheel::SetTimerFd(std::uint64_t tick) {
+    assert(tick != unarmed_);
+    ::itimerspec time;
+    std::memset(&(time.it_interval), 0, sizeof(time.it_interval));
+    std::memset(&(time.it_value), 0, sizeof(time.it_value));
+    time.it_value.tv_sec = tick / 1000;
+    time.it_value.tv_nsec = (tick % 1000) * 1000 * 1000;
+    int r = ::timerfd_settime(this->handle_, TFD_TIMER_ABSTIME, &time, nullptr);
+    if (r == -1) {
+        sharpen::ThrowLastError();
+    }
+}
+
+void sharpen::TimerWheel::ArmTimerFd(std::uint64_t tick) {
+    // the deadline may be changed by other threads
+    // while the timer fd is being set without lock
+    while (true) {
+        this->SetTimerFd(tick);
+        std::unique_lock<sharpen::SpinLock> lock{this->lock_};
+        if (this->armedTick_ == tick || this->armedTick_ == unarmed_) {
+            return;
+        }
+        tick = this->armedTick_;
+    }
+}
+
+std::uint64_t sharpen::TimerWheel::GetTick(bool roundUp) noexcept {
+    ::timespec time;
+    ::clock_gettime(CLOCK_MONOTONIC, &time);
+    std::uint64_t tick{static_cast<std::uint64_t>(time.tv_sec) * 1000 +
+                       static_cast<std::uint64_t>(time.tv_nsec) / (1000 * 1000)};
+    if (roundUp && time.tv_nsec % (1000 * 1000)) {
+        tick += 1;
+    }
+    return tick;
+}
+
+void sharpen::TimerWheel::OnEvent(sharpen::IoEvent *event) {
+    if (!event->IsReadEvent()) {
+        return;
+    }
+    std::uint64_t next{unarmed_};
+    {
+        std::unique_lock<sharpen::SpinLock> lock{this->lock_};
+        this->Advance(Self::GetTick(false));
+        next = this->ComputeNextTick();
+        this->armedTick_ = next;
+    }
+    if (next != unarmed_) {
+        this->ArmTimerFd(next);
+    }
+    // complete futures without lock
+    // callbacks may add timers
+    for (auto begin = this->expired_.begin(), end = this->expired_.end(); begin != end; ++begin) {
+        (*begin)->Complete(true);
+    }
+    this->expired_.clear();
+}
+
+sharpen::Future<bool> *sharpen::TimerWheel::Add(Node &node,
+                                                std::uint64_t waitMs,
+                                                sharpen::Future<bool> &future) {
+    assert(this->handle_ != -1);
+    // the timer should not expire earlier than waitMs
+    std::uint64_t expire{Self::GetTick(true) + waitMs};
+    sharpen::Future<bool> *old{nullptr};
+    {
+        std::unique_lock<sharpen::SpinLock> lock{this->lock_};
+        if (node.next_) {
+            old = node.future_;
+            this->Unlink(node);
+            this->count_ -= 1;
+        }
+        if (!this->count_) {
+            // nothing to advance
+            std::uint64_t now{Self::GetTick(false)};
+            if (now > this->currentTick_) {
+                this->currentTick_ = now;
+            }
+        }
+        node.expire_ = expire;
+        node.future_ = &future;
+        this->Link(node);
+        this->count_ += 1;
+        if (expire >= this->armedTick_) {
+            return old;
+        }
+        this->armedTick_ = expire;
+    }
+    // set the timer fd without lock
+    try {
+        this->ArmTimerFd(expire);
+    } catch (const std::exception &) {
+        std::unique_lock<sharpen::SpinLock> lock{this->lock_};
+        if (node.next_ && node.future_ == &future) {
+            this->Unlink(node);
+            this->count_ -= 1;
+            node.future_ = nullptr;
+        }
+        // the next timer re-arms the timer fd
+        this->armedTick_ = unarmed_;
+        throw;
+    }
+    return old;
+}
+
+sharpen::Future<bool> *sharpen::TimerWheel::Remove(Node &node) noexcept {
+    std::unique_lock<sharpen::SpinLock> lock{this->lock_};
+    if (!node.next_) {
+        return nullptr;
+    }
+    this->Unlink(node);
+    this->count_ -= 1;
+    sharpen::Future<bool> *future{node.future_};
+    node.future_ = nullptr;
+    return future;
+}
+
+std::size_t sharpen::TimerWheel::GetCount() noexcept {
+    std::unique_lock<sharpen::SpinLock> lock{this->lock_};
+    return this->count_;
+}
+
+#endif
@@ -1,4 +1,6 @@
+#include <sharpen/AsyncOps.hpp>
 #include <sharpen/BinarySerializable.hpp>
+#include <sharpen/BinarySerializator.hpp>
 #include <sharpen/BufferReader.hpp>
 #include <sharpen/BufferWriter.hpp>
 #include <sharpen/ByteBuffer.hpp>
@@ -9,7 +11,11 @@
 #include <sharpen/LogEntries.hpp>
 #include <sharpen/Varint.hpp>
 #include <sharpen/WalLogStorage.hpp>
+#include <cassert>
 #include <cstdint>
+#include <exception>
+#include <limits>
+#include <utility>
 
 sharpen::WalLogStorage::WalLogStorage(std::string name)
     : Self{sharpen::GetLocalLoopGroup(), std::move(name)} {
@@ -23,7 +29,24 @@ sharpen::WalLogStorage::WalLogStorage(sharpen::IEventLoopGroup &loopGroup, std::
     , lock_(nullptr)
     , logs_()
     , offset_(0)
-    , contentSize_(0) {
+    , contentSize_(0)
+    , pending_()
+    , records_()
+    , staged_()
+    , group_(1)
+    , waiters_()
+    , committingWaiters_()
+    , committing_(false)
+    , maxBatchSize_(defaultMaxBatchSize_)
+    , maxDelay_(0)
+    , timer_(nullptr)
+    , syncCount_(0)
+    , compacting_(false)
+    , compacted_(false)
+    , compactOffset_(0)
+    , tempChannel_(nullptr)
+    , tempOffset_(0)
+    , compaction_(nullptr) {
     assert(!this->name_.empty());
     sharpen::AsyncRwLock *lock{new (std::nothrow) sharpen::AsyncRwLock{}};
     if (!lock) {
@@ -39,6 +62,7 @@ sharpen::WalLogStorage::WalLogStorage(sharpen::IEventLoopGroup &loopGroup, std::
                                                              sharpen::FileOpenMethod::CreateOrOpen,
                                                              sharpen::FileIoMethod::Normal)};
     channel->Register(*this->loopGroup_);
+    channel->EnableRegisteredIo();
     this->channel_ = std::move(channel);
     this->Load();
     this->contentSize_ = this->ComputeContentSize();
@@ -101,9 +125,8 @@ void sharpen::WalLogStorage::Load() {
                     return;
                 }
                 index = builder.Get();
-                bool result{this->Insert(index, std::move(log))};
-                assert(result);
-                (void)result;
+                // the compacted part may already contain records of the tail
+                this->Insert(index, std::move(log));
             } break;
             case Self::removeTag_: {
                 sharpen::Varuint64 builder{0};
@@ -116,9 +139,8 @@ void sharpen::WalLogStorage::Load() {
                     return;
                 }
                 index = builder.Get();
-                bool result{this->Erase(index)};
-                assert(result);
-                (void)result;
+                // the log may be written by a group which failed to commit
+                this->Erase(index);
             } break;
             default:
                 this->channel_->Truncate(offset);
@@ -139,44 +161,204 @@ std::size_t sharpen::WalLogStorage::ComputeContentSize() const noexcept {
     return size;
 }
 
-void sharpen::WalLogStorage::RebuildFile() {
+void sharpen::WalLogStorage::StartCompaction() {
+    assert(!this->compacting_);
+    this->WaitForCompaction();
+    sharpen::AwaitableFuture<void> *future{new (std::nothrow) sharpen::AwaitableFuture<void>{}};
+    if (!future) {
+        throw std::bad_alloc{};
+    }
+    this->compaction_.reset(future);
+    this->compactOffset_ = this->offset_;
+    this->compacting_ = true;
+    sharpen::Launch(&Self::Compact, this);
+}
+
+void sharpen::WalLogStorage::Compact() noexcept {
     assert(this->loopGroup_);
-    assert(!this->name_.empty());
     assert(!this->tempName_.empty());
-    sharpen::FileChannelPtr channel{sharpen::OpenFileChannel(this->tempName_.c_str(),
-                                                             sharpen::FileAccessMethod::Write,
-                                                             sharpen::FileOpenMethod::CreateNew)};
+    sharpen::FileChannelPtr channel{nullptr};
     std::uint64_t offset{0};
-    channel->Register(*this->loopGroup_);
-    if (!this->logs_.empty()) {
-        sharpen::ByteBuffer buf{4096};
-        for (auto begin = this->logs_.begin(), end = this->logs_.end(); begin != end; ++begin) {
-            sharpen::BufferWriter writer{buf};
-            std::uint8_t tag{writeTag_};
-            writer.Write(tag);
-            sharpen::Varuint64 builder{begin->first};
-            writer.Write(builder);
-            writer.Write(begin->second);
-            std::size_t sz{channel->WriteFixedAsync(buf.Data(), writer.GetLength(), offset)};
-            assert(sz == writer.GetLength());
-            if (sz != writer.GetLength()) {
-                sharpen::ThrowSystemError(sharpen::ErrorIo);
+    bool failed{false};
+    try {
+        channel = sharpen::OpenFileChannel(this->tempName_.c_str(),
+                                           sharpen::FileAccessMethod::Write,
+                                           sharpen::FileOpenMethod::CreateOrOpen);
+        channel->Truncate();
+        channel->Register(*this->loopGroup_);
+        channel->EnableRegisteredIo();
+        // write records in large batches
+        // entries are referenced by slices instead of being copied
+        std::vector<char> headers;
+        std::vector<std::size_t> marks;
+        std::vector<const sharpen::ByteBuffer *> entries;
+        std::vector<sharpen::ByteSlice> slices;
+        headers.reserve(compactBatchCount_ * reservedRecordSize_);
+        marks.reserve(compactBatchCount_);
+        entries.reserve(compactBatchCount_);
+        slices.reserve(2 * compactBatchCount_);
+        // walk logs_ in chunks under the read lock
+        // changes after compactOffset_ are fixed up by replaying the tail
+        std::uint64_t nextIndex{0};
+        bool done{false};
+        while (!done) {
+            this->lock_->LockRead();
+            std::unique_lock<sharpen::AsyncRwLock> lock{*this->lock_, std::adopt_lock};
+            auto begin = this->logs_.lower_bound(nextIndex);
+            auto end = this->logs_.end();
+            std::size_t batchSize{0};
+            for (; begin != end; ++begin) {
+                std::uint8_t tag{writeTag_};
+                sharpen::Varuint64 builder{begin->first};
+                sharpen::Varuint64 sizeBuilder{begin->second.GetSize()};
+                std::size_t headerSize{sizeof(tag) + builder.ComputeSize() +
+                                       sizeBuilder.ComputeSize()};
+                std::size_t recordSize{headerSize + begin->second.GetSize()};
+                if (!entries.empty() && (batchSize + recordSize > compactBatchSize_ ||
+                                         entries.size() == compactBatchCount_)) {
+                    break;
+                }
+                std::size_t size{headers.size()};
+                headers.resize(size + headerSize);
+                char *header{headers.data() + size};
+                header += sharpen::BinarySerializator::UnsafeStoreTo(tag, header);
+                header += sharpen::BinarySerializator::UnsafeStoreTo(builder, header);
+                sharpen::BinarySerializator::UnsafeStoreTo(sizeBuilder, header);
+                marks.emplace_back(headers.size());
+                entries.emplace_back(&begin->second);
+                batchSize += recordSize;
+                nextIndex = begin->first + 1;
             }
-            offset += sz;
+            done = begin == end;
+            if (!entries.empty()) {
+                // entries are valid until the lock is released
+                offset +=
+                    Self::WriteCompactBatch(*channel, offset, headers, marks, entries, slices);
+                headers.clear();
+                marks.clear();
+                entries.clear();
+            }
+        }
+        channel->FlushAsync();
+    } catch (const std::exception &ignore) {
+        (void)ignore;
+        failed = true;
+    }
+    sharpen::AwaitableFuture<void> *future{this->compaction_.get()};
+    {
+        this->lock_->LockWrite();
+        std::unique_lock<sharpen::AsyncRwLock> lock{*this->lock_, std::adopt_lock};
+        if (failed) {
+            if (channel) {
+                channel->Close();
+            }
+            this->AbortCompaction();
+        } else {
+            this->tempChannel_ = std::move(channel);
+            this->tempOffset_ = offset;
+            this->compacted_ = true;
+            // otherwise the leader of group commit switches the file
+            // when no records are being written
+            if (!this->committing_) {
+                this->TrySwitchFile();
+            }
+        }
+    }
+    future->Complete();
+}
+
+std::size_t sharpen::WalLogStorage::WriteCompactBatch(
+    sharpen::IFileChannel &channel,
+    std::uint64_t offset,
+    const std::vector<char> &headers,
+    const std::vector<std::size_t> &marks,
+    const std::vector<const sharpen::ByteBuffer *> &entries,
+    std::vector<sharpen::ByteSlice> &slices) {
+    assert(marks.size() == entries.size());
+    slices.clear();
+    std::size_t size{0};
+    std::size_t begin{0};
+    for (std::size_t i = 0, count = entries.size(); i != count; ++i) {
+        slices.emplace_back(headers.data() + begin, marks[i] - begin);
+        size += marks[i] - begin;
+        begin = marks[i];
+        if (!entries[i]->Empty()) {
+            slices.emplace_back(entries[i]->GetSlice());
+            size += entries[i]->GetSize();
+        }
+    }
+    std::size_t sz{channel.WriteVectorFixedAsync(slices.data(), slices.size(), offset)};
+    if (sz != size) {
+        sharpen::ThrowSystemError(sharpen::ErrorIo);
+    }
+    return sz;
+}
+
+void sharpen::WalLogStorage::SwitchFile(sharpen::FileChannelPtr channel, std::uint64_t offset) {
+    assert(channel);
+    assert(this->offset_ >= this->compactOffset_);
+    // replay records written during compaction
+    std::uint64_t tail{this->offset_ - this->compactOffset_};
+    if (tail) {
+        sharpen::ByteBuffer buf{sharpen::IntCast<std::size_t>(tail)};
+        std::size_t sz{this->channel_->ReadAsync(buf, this->compactOffset_)};
+        if (sz != buf.GetSize()) {
+            sharpen::ThrowSystemError(sharpen::ErrorIo);
+        }
+        sz = channel->WriteFixedAsync(buf, offset);
+        if (sz != buf.GetSize()) {
+            sharpen::ThrowSystemError(sharpen::ErrorIo);
         }
+        offset += sz;
+        channel->FlushAsync();
     }
-    channel->FlushAsync();
     channel->Close();
     this->channel_->Close();
     sharpen::RenameFile(this->tempName_.c_str(), this->name_.c_str());
     this->offset_ = offset;
     this->channel_ = sharpen::OpenFileChannel(this->name_.c_str(),
-                                              sharpen::FileAccessMethod::Write,
+                                              sharpen::FileAccessMethod::All,
                                               sharpen::FileOpenMethod::CreateOrOpen);
     this->channel_->Register(*this->loopGroup_);
+    this->channel_->EnableRegisteredIo();
     this->contentSize_ = this->ComputeContentSize();
 }
 
+void sharpen::WalLogStorage::TrySwitchFile() noexcept {
+    if (!this->compacted_) {
+        return;
+    }
+    try {
+        this->SwitchFile(std::move(this->tempChannel_), this->tempOffset_);
+        this->compacted_ = false;
+        this->compacting_ = false;
+    } catch (const std::exception &ignore) {
+        (void)ignore;
+        this->AbortCompaction();
+    }
+}
+
+void sharpen::WalLogStorage::AbortCompaction() noexcept {
+    if (this->tempChannel_) {
+        this->tempChannel_->Close();
+        this->tempChannel_.reset();
+    }
+    try {
+        sharpen::RemoveFile(this->tempName_.c_str());
+    } catch (const std::exception &ignore) {
+        (void)ignore;
+    }
+    this->compacted_ = false;
+    this->compacting_ = false;
+}
+
+void sharpen::WalLogStorage::WaitForCompaction() noexcept {
+    if (this->compaction_) {
+        this->compaction_->Await();
+        this->compaction_.reset();
+    }
+}
+
 sharpen::Optional<sharpen::ByteBuffer> sharpen::WalLogStorage::NviLookup(
     std::uint64_t index) const {
     {
@@ -190,181 +372,357 @@ sharpen::Optional<sharpen::ByteBuffer> sharpen::WalLogStorage::NviLookup(
     }
 }
 
-void sharpen::WalLogStorage::NviWrite(std::uint64_t index, sharpen::ByteSlice log) {
+const sharpen::ByteBuffer *sharpen::WalLogStorage::Find(std::uint64_t index,
+                                                        std::uint64_t &group) const noexcept {
+    auto staged = this->staged_.find(index);
+    if (staged != this->staged_.end()) {
+        group = staged->second.group_;
+        if (staged->second.record_->tag_ == removeTag_) {
+            return nullptr;
+        }
+        return &staged->second.record_->log_;
+    }
+    group = 0;
+    auto ite = this->logs_.find(index);
+    if (ite != this->logs_.end()) {
+        return &ite->second;
+    }
+    return nullptr;
+}
+
+void sharpen::WalLogStorage::StageRecord(std::uint8_t tag,
+                                         std::uint64_t index,
+                                         sharpen::ByteBuffer log) {
+    sharpen::Varuint64 builder{index};
+    std::size_t size{sizeof(tag) + builder.ComputeSize()};
+    if (tag == writeTag_) {
+        size += log.ComputeSize();
+    }
+    std::size_t offset{this->pending_.size()};
+    this->pending_.resize(offset + size);
+    try {
+        this->records_.emplace_back(StagedRecord{tag, index, std::move(log)});
+        try {
+            StagedEntry entry{this->group_, &this->records_.back()};
+            this->staged_[index] = entry;
+        } catch (const std::bad_alloc &) {
+            this->records_.pop_back();
+            throw;
+        }
+    } catch (const std::bad_alloc &) {
+        this->pending_.resize(offset);
+        throw;
+    }
+    char *buf{this->pending_.data() + offset};
+    buf += sharpen::BinarySerializator::UnsafeStoreTo(tag, buf);
+    buf += sharpen::BinarySerializator::UnsafeStoreTo(builder, buf);
+    if (tag == writeTag_) {
+        sharpen::BinarySerializator::UnsafeStoreTo(this->records_.back().log_, buf);
+    }
+}
+
+bool sharpen::WalLogStorage::StageRemove(std::uint64_t beginIndex, std::uint64_t endIndex) {
+    std::vector<std::uint64_t> indexes;
+    for (auto begin = this->logs_.lower_bound(beginIndex), end = this->logs_.lower_bound(endIndex);
+         begin != end;
+         ++begin) {
+        auto staged = this->staged_.find(begin->first);
+        if (staged == this->staged_.end() || staged->second.record_->tag_ != removeTag_) {
+            indexes.emplace_back(begin->first);
+        }
+    }
+    // logs which have not been committed
+    for (auto begin = this->staged_.lower_bound(beginIndex),
+              end = this->staged_.lower_bound(endIndex);
+         begin != end;
+         ++begin) {
+        if (begin->second.record_->tag_ == writeTag_ && !this->logs_.count(begin->first)) {
+            indexes.emplace_back(begin->first);
+        }
+    }
+    for (auto begin = indexes.begin(), end = indexes.end(); begin != end; ++begin) {
+        this->StageRecord(removeTag_, *begin, sharpen::ByteBuffer{});
+    }
+    return !indexes.empty();
+}
+
+void sharpen::WalLogStorage::ApplyGroup(StagedRecords &records,
+                                        std::uint64_t group,
+                                        bool committed) {
+    for (auto begin = records.begin(), end = records.end(); begin != end; ++begin) {
+        // the record may be replaced by the next group
+        auto staged = this->staged_.find(begin->index_);
+        if (staged != this->staged_.end() && staged->second.group_ == group) {
+            this->staged_.erase(staged);
+        }
+        if (!committed) {
+            continue;
+        }
+        if (begin->tag_ == writeTag_) {
+            this->Insert(begin->index_, std::move(begin->log_));
+        } else {
+            this->Erase(begin->index_);
+        }
+    }
+    records.clear();
+}
+
+bool sharpen::WalLogStorage::Enqueue(sharpen::Future<bool> &future) {
+    if (this->committing_) {
+        this->waiters_.emplace_back(&future);
+        return false;
+    }
+    this->committing_ = true;
+    return true;
+}
+
+void sharpen::WalLogStorage::CommitGroup() {
+    bool wait{false};
+    if (this->maxDelay_.count()) {
+        this->lock_->LockRead();
+        std::unique_lock<sharpen::AsyncRwLock> lock{*this->lock_, std::adopt_lock};
+        wait = this->pending_.size() < this->maxBatchSize_;
+    }
+    if (wait) {
+        // wait for more writers
+        if (!this->timer_) {
+            this->timer_ = sharpen::MakeTimer(*this->loopGroup_);
+        }
+        this->timer_->Await(this->maxDelay_);
+    }
+    std::vector<char> buf;
+    StagedRecords records;
+    std::uint64_t group{0};
+    std::vector<sharpen::Future<bool> *> waiters;
+    std::uint64_t offset{0};
+    std::exception_ptr error;
     {
         this->lock_->LockWrite();
         std::unique_lock<sharpen::AsyncRwLock> lock{*this->lock_, std::adopt_lock};
-        sharpen::ByteBuffer buf{log};
-        bool result{this->Insert(index, std::move(buf))};
-        if (result) {
-            std::size_t contentSize{this->contentSize_};
-            if (contentSize && this->offset_ >= contentSize * limitFactor_) {
-                this->RebuildFile();
-                return;
+        // no records are being written
+        this->TrySwitchFile();
+        // logs_ contains the records before offset_
+        // so records after offset_ are the tail
+        std::size_t contentSize{this->contentSize_};
+        if (!this->compacting_ && contentSize &&
+            this->offset_ + this->pending_.size() >= contentSize * limitFactor_) {
+            try {
+                this->StartCompaction();
+            } catch (const std::exception &ignore) {
+                (void)ignore;
             }
-            sharpen::Varuint64 builder{index};
-            std::size_t pairSize{builder.ComputeSize() + log.ComputeSize() + sizeof(std::uint8_t)};
-            std::uint8_t tag{writeTag_};
-            buf = sharpen::ByteBuffer{pairSize};
-            sharpen::BufferWriter writer{buf};
-            writer.Write(tag);
-            writer.Write(builder);
-            writer.Write(log);
-            std::size_t sz{this->channel_->WriteFixedAsync(buf, this->offset_)};
-            assert(sz == buf.GetSize());
-            if (sz != buf.GetSize()) {
-                this->channel_->Truncate(this->offset_);
+        }
+        assert(this->committingWaiters_.empty());
+        std::swap(buf, this->pending_);
+        std::swap(records, this->records_);
+        std::swap(this->committingWaiters_, this->waiters_);
+        group = this->group_;
+        this->group_ += 1;
+        offset = this->offset_;
+        // only the leader changes offset_
+        this->offset_ += buf.size();
+    }
+    if (!buf.empty()) {
+        try {
+            std::size_t sz{this->channel_->WriteFixedAsync(buf.data(), buf.size(), offset)};
+            assert(sz == buf.size());
+            if (sz != buf.size()) {
                 sharpen::ThrowSystemError(sharpen::ErrorIo);
             }
-            this->channel_->FlushAsync();
-            this->offset_ += sz;
+            this->channel_->FlushDataAsync();
+        } catch (const std::exception &ignore) {
+            (void)ignore;
+            error = std::current_exception();
+        }
+    }
+    sharpen::Future<bool> *next{nullptr};
+    {
+        this->lock_->LockWrite();
+        std::unique_lock<sharpen::AsyncRwLock> lock{*this->lock_, std::adopt_lock};
+        if (error) {
+            this->offset_ = offset;
+            if (this->compactOffset_ > offset) {
+                this->compactOffset_ = offset;
+            }
+            try {
+                this->channel_->Truncate(offset);
+            } catch (const std::exception &ignore) {
+                (void)ignore;
+            }
+        } else if (!buf.empty()) {
+            this->syncCount_ += 1;
+        }
+        this->ApplyGroup(records, group, !error);
+        std::swap(waiters, this->committingWaiters_);
+        this->TrySwitchFile();
+        // hand over to a waiter of next group
+        if (this->waiters_.empty()) {
+            this->committing_ = false;
+        } else {
+            next = this->waiters_.front();
+            this->waiters_.erase(this->waiters_.begin());
         }
     }
+    if (next) {
+        next->Complete(false);
+    }
+    for (auto begin = waiters.begin(), end = waiters.end(); begin != end; ++begin) {
+        if (error) {
+            (*begin)->Fail(error);
+        } else {
+            (*begin)->Complete(true);
+        }
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
 }
 
-void sharpen::WalLogStorage::NviWriteBatch(std::uint64_t beginIndex, sharpen::LogEntries entries) {
+void sharpen::WalLogStorage::WaitForCommit(sharpen::AwaitableFuture<bool> &future, bool leader) {
+    if (!leader && future.Await()) {
+        return;
+    }
+    this->CommitGroup();
+}
+
+void sharpen::WalLogStorage::WaitForGroups(sharpen::AwaitableFuture<bool> *committing,
+                                           sharpen::AwaitableFuture<bool> *future,
+                                           bool leader) {
+    std::exception_ptr error;
+    if (committing) {
+        try {
+            committing->Await();
+        } catch (const std::exception &ignore) {
+            (void)ignore;
+            // the future is still referenced by waiters_
+            error = std::current_exception();
+        }
+    }
+    if (future) {
+        this->WaitForCommit(*future, leader);
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+void sharpen::WalLogStorage::NviWrite(std::uint64_t index, sharpen::ByteSlice log) {
+    sharpen::AwaitableFuture<bool> committing;
+    sharpen::AwaitableFuture<bool> future;
+    bool waitCommitting{false};
+    bool leader{false};
     {
-        {
-            this->lock_->LockWrite();
-            std::unique_lock<sharpen::AsyncRwLock> lock{*this->lock_, std::adopt_lock};
-            sharpen::ByteBuffer buf{4096};
-            for (std::size_t i = 0; i != entries.GetSize(); ++i) {
-                sharpen::BufferWriter writer{buf};
-                std::uint64_t index{i + beginIndex};
-                sharpen::ByteBuffer entry{std::move(entries.Get(i))};
-                if (this->Insert(index,std::move(entry))) {
-                    std::uint8_t tag{writeTag_};
-                    writer.Write(tag);
-                    sharpen::Varuint64 builder{index};
-                    writer.Write(builder);
-                    writer.Write(this->logs_.at(index));
-                }
-                std::size_t size{writer.GetLength()};
-                std::size_t sz{this->channel_->WriteFixedAsync(buf.Data(),size, this->offset_)};
-                assert(sz == size);
-                if (sz != size) {
-                    this->channel_->Truncate(this->offset_);
-                    sharpen::ThrowSystemError(sharpen::ErrorIo);
-                }
-                this->channel_->FlushAsync();
-                this->offset_ += sz;
+        this->lock_->LockWrite();
+        std::unique_lock<sharpen::AsyncRwLock> lock{*this->lock_, std::adopt_lock};
+        sharpen::ByteBuffer buf{log};
+        std::uint64_t group{0};
+        const sharpen::ByteBuffer *current{this->Find(index, group)};
+        if (current && *current == buf) {
+            if (!group) {
+                return;
             }
+            // wait for the group which contains the log
+            if (group != this->group_) {
+                this->committingWaiters_.emplace_back(&committing);
+                waitCommitting = true;
+            } else {
+                leader = this->Enqueue(future);
+            }
+        } else {
+            this->StageRecord(writeTag_, index, std::move(buf));
+            leader = this->Enqueue(future);
         }
     }
+    if (waitCommitting) {
+        this->WaitForGroups(&committing, nullptr, false);
+        return;
+    }
+    this->WaitForCommit(future, leader);
 }
 
-void sharpen::WalLogStorage::NviDropUntil(std::uint64_t endIndex) noexcept {
+void sharpen::WalLogStorage::NviWriteBatch(std::uint64_t beginIndex, sharpen::LogEntries entries) {
+    sharpen::AwaitableFuture<bool> committing;
+    sharpen::AwaitableFuture<bool> future;
+    bool waitCommitting{false};
+    bool waitStaged{false};
+    bool leader{false};
     {
         this->lock_->LockWrite();
         std::unique_lock<sharpen::AsyncRwLock> lock{*this->lock_, std::adopt_lock};
         std::size_t size{0};
-        for (auto begin = this->logs_.begin(), end = this->logs_.end();
-             begin != end && begin->first < endIndex;
-             ++begin) {
-            sharpen::Varuint64 builder{begin->first};
-            size += builder.ComputeSize();
-            size += begin->second.GetSize();
+        for (std::size_t i = 0; i != entries.GetSize(); ++i) {
+            size += entries.Get(i).GetSize() + reservedRecordSize_;
         }
-        if (!size) {
-            return;
-        }
-        std::size_t contentSize{this->contentSize_};
-        contentSize -= size;
-        if (this->offset_ >= contentSize * limitFactor_) {
-            for (auto begin = this->logs_.begin(), end = this->logs_.end();
-                 begin != end && begin->first < endIndex;) {
-                begin = this->logs_.erase(begin);
+        this->pending_.reserve(this->pending_.size() + size);
+        for (std::size_t i = 0; i != entries.GetSize(); ++i) {
+            std::uint64_t index{i + beginIndex};
+            std::uint64_t group{0};
+            const sharpen::ByteBuffer *current{this->Find(index, group)};
+            if (!current || *current != entries.Get(i)) {
+                this->StageRecord(writeTag_, index, std::move(entries.Get(i)));
+                group = this->group_;
+            }
+            if (!group) {
+                continue;
+            }
+            if (group != this->group_) {
+                waitCommitting = true;
+            } else {
+                waitStaged = true;
             }
-            this->RebuildFile();
-            return;
-        }
-        for (auto begin = this->logs_.begin(), end = this->logs_.end();
-             begin != end && begin->first < endIndex;
-             ++begin) {
-            size += sizeof(std::uint8_t);
-            size -= begin->second.GetSize();
         }
-        sharpen::ByteBuffer buf{size};
-        sharpen::BufferWriter writer{buf};
-        for (auto begin = this->logs_.begin(), end = this->logs_.end();
-             begin != end && begin->first < endIndex;
-             ++begin) {
-            std::uint8_t tag{removeTag_};
-            writer.Write(tag);
-            sharpen::Varuint64 builder{begin->first};
-            writer.Write(builder);
+        // StageRecord() may throw
+        // so futures are registered after all records are staged
+        if (waitCommitting) {
+            this->committingWaiters_.emplace_back(&committing);
         }
-        std::size_t sz{this->channel_->WriteFixedAsync(buf, this->offset_)};
-        assert(sz == buf.GetSize());
-        if (sz != buf.GetSize()) {
-            this->channel_->Truncate(this->offset_);
-            return;
+        if (waitStaged) {
+            try {
+                leader = this->Enqueue(future);
+            } catch (const std::exception &) {
+                if (waitCommitting) {
+                    this->committingWaiters_.pop_back();
+                }
+                throw;
+            }
         }
-        this->channel_->FlushAsync();
-        this->contentSize_ = contentSize;
-        this->offset_ += sz;
-        for (auto begin = this->logs_.begin(), end = this->logs_.end();
-             begin != end && begin->first < endIndex;) {
-            begin = this->logs_.erase(begin);
+    }
+    this->WaitForGroups(
+        waitCommitting ? &committing : nullptr, waitStaged ? &future : nullptr, leader);
+}
+
+void sharpen::WalLogStorage::NviDropUntil(std::uint64_t endIndex) noexcept {
+    sharpen::AwaitableFuture<bool> future;
+    bool leader{false};
+    try {
+        {
+            this->lock_->LockWrite();
+            std::unique_lock<sharpen::AsyncRwLock> lock{*this->lock_, std::adopt_lock};
+            if (!this->StageRemove(0, endIndex)) {
+                return;
+            }
+            leader = this->Enqueue(future);
         }
+        this->WaitForCommit(future, leader);
+    } catch (const std::exception &ignore) {
+        // the logs are kept in memory and file
+        // they will be dropped by next call
+        (void)ignore;
     }
 }
 
 void sharpen::WalLogStorage::NviTruncateFrom(std::uint64_t index) {
+    sharpen::AwaitableFuture<bool> future;
+    bool leader{false};
     {
         this->lock_->LockWrite();
         std::unique_lock<sharpen::AsyncRwLock> lock{*this->lock_, std::adopt_lock};
-        std::size_t size{0};
-        for (auto begin = this->logs_.lower_bound(6), end = this->logs_.end();
-             begin != end && begin->first >= index;
-             ++begin) {
-            sharpen::Varuint64 builder{begin->first};
-            size += builder.ComputeSize();
-            size += begin->second.GetSize();
-        }
-        if (!size) {
+        if (!this->StageRemove(index, (std::numeric_limits<std::uint64_t>::max)())) {
             return;
         }
-        std::size_t contentSize{this->contentSize_};
-        contentSize -= size;
-        if (this->offset_ >= contentSize * limitFactor_) {
-            for (auto begin = this->logs_.lower_bound(6), end = this->logs_.end();
-                 begin != end && begin->first >= index;) {
-                begin = this->logs_.erase(begin);
-            }
-            this->RebuildFile();
-            return;
-        }
-        for (auto begin = this->logs_.lower_bound(6), end = this->logs_.end();
-             begin != end && begin->first >= index;
-             ++begin) {
-            size += sizeof(std::uint8_t);
-            size -= begin->second.GetSize();
-        }
-        sharpen::ByteBuffer buf{size};
-        sharpen::BufferWriter writer{buf};
-        for (auto begin = this->logs_.lower_bound(6), end = this->logs_.end();
-             begin != end && begin->first >= index;
-             ++begin) {
-            std::uint8_t tag{removeTag_};
-            writer.Write(tag);
-            sharpen::Varuint64 builder{begin->first};
-            writer.Write(builder);
-        }
-        std::size_t sz{this->channel_->WriteFixedAsync(buf, this->offset_)};
-        assert(sz == buf.GetSize());
-        if (sz != buf.GetSize()) {
-            this->channel_->Truncate(this->offset_);
-            sharpen::ThrowSystemError(sharpen::ErrorIo);
-        }
-        this->channel_->FlushAsync();
-        this->contentSize_ = contentSize;
-        this->offset_ += sz;
-        for (auto begin = this->logs_.lower_bound(6), end = this->logs_.end();
-             begin != end && begin->first >= index;) {
-            begin = this->logs_.erase(begin);
-        }
+        leader = this->Enqueue(future);
     }
+    this->WaitForCommit(future, leader);
 }
 
 std::uint64_t sharpen::WalLogStorage::GetLastIndex() const {
@@ -379,22 +737,52 @@ std::uint64_t sharpen::WalLogStorage::GetLastIndex() const {
     }
 }
 
+void sharpen::WalLogStorage::SetGroupCommit(std::size_t maxBatchSize,
+                                            std::chrono::milliseconds maxDelay) noexcept {
+    this->maxBatchSize_ = maxBatchSize;
+    this->maxDelay_ = maxDelay;
+}
+
+std::uint64_t sharpen::WalLogStorage::GetSyncCount() const {
+    this->lock_->LockRead();
+    std::unique_lock<sharpen::AsyncRwLock> lock{*this->lock_, std::adopt_lock};
+    return this->syncCount_;
+}
+
 sharpen::WalLogStorage::WalLogStorage(Self &&other) noexcept
-    : name_(std::move(other.name_))
-    , tempName_(std::move(other.tempName_))
-    , channel_(std::move(other.channel_))
-    , loopGroup_(other.loopGroup_)
-    , lock_(std::move(other.lock_))
-    , logs_(std::move(other.logs_))
-    , offset_(other.offset_)
-    , contentSize_(other.contentSize_) {
-    other.loopGroup_ = nullptr;
-    other.offset_ = 0;
-    other.contentSize_ = 0;
+    : name_()
+    , tempName_()
+    , channel_(nullptr)
+    , loopGroup_(nullptr)
+    , lock_(nullptr)
+    , logs_()
+    , offset_(0)
+    , contentSize_(0)
+    , pending_()
+    , records_()
+    , staged_()
+    , group_(1)
+    , waiters_()
+    , committingWaiters_()
+    , committing_(false)
+    , maxBatchSize_(defaultMaxBatchSize_)
+    , maxDelay_(0)
+    , timer_(nullptr)
+    , syncCount_(0)
+    , compacting_(false)
+    , compacted_(false)
+    , compactOffset_(0)
+    , tempChannel_(nullptr)
+    , tempOffset_(0)
+    , compaction_(nullptr) {
+    // the compaction fiber refers to other
+    *this = std::move(other);
 }
 
 sharpen::WalLogStorage &sharpen::WalLogStorage::operator=(Self &&other) noexcept {
     if (this != std::addressof(other)) {
+        this->WaitForCompaction();
+        other.WaitForCompaction();
         this->name_ = std::move(other.name_);
         this->tempName_ = std::move(other.tempName_);
         this->channel_ = std::move(other.channel_);
@@ -403,9 +791,36 @@ sharpen::WalLogStorage &sharpen::WalLogStorage::operator=(Self &&other) noexcept
         this->logs_ = std::move(other.logs_);
         this->offset_ = other.offset_;
         this->contentSize_ = other.contentSize_;
+        this->pending_ = std::move(other.pending_);
+        this->records_ = std::move(other.records_);
+        this->staged_ = std::move(other.staged_);
+        this->group_ = other.group_;
+        this->waiters_ = std::move(other.waiters_);
+        this->committingWaiters_ = std::move(other.committingWaiters_);
+        this->committing_ = other.committing_;
+        this->maxBatchSize_ = other.maxBatchSize_;
+        this->maxDelay_ = other.maxDelay_;
+        this->timer_ = std::move(other.timer_);
+        this->syncCount_ = other.syncCount_;
+        this->compacting_ = other.compacting_;
+        this->compacted_ = other.compacted_;
+        this->compactOffset_ = other.compactOffset_;
+        this->tempChannel_ = std::move(other.tempChannel_);
+        this->tempOffset_ = other.tempOffset_;
         other.loopGroup_ = nullptr;
         other.offset_ = 0;
         other.contentSize_ = 0;
+        other.committing_ = false;
+        other.syncCount_ = 0;
+        other.compacting_ = false;
+        other.compacted_ = false;
+        other.compactOffset_ = 0;
+        other.tempOffset_ = 0;
     }
     return *this;
-}
\ No newline at end of file
+}
+
+sharpen::WalLogStorage::~WalLogStorage() noexcept {
+    this->WaitForCompaction();
+    this->TrySwitchFile();
+}
@@ -1,10 +1,14 @@
 #include <sharpen/WalStatusMap.hpp>
 
+#include <sharpen/AsyncOps.hpp>
+#include <sharpen/BinarySerializator.hpp>
 #include <sharpen/BufferReader.hpp>
 #include <sharpen/BufferWriter.hpp>
 #include <sharpen/FileOps.hpp>
 #include <sharpen/IEventLoopGroup.hpp>
 #include <sharpen/IntOps.hpp>
+#include <sharpen/SystemError.hpp>
+#include <exception>
 
 sharpen::WalStatusMap::WalStatusMap(std::string name)
     : WalStatusMap(sharpen::GetLocalLoopGroup(), std::move(name)) {
@@ -18,7 +22,10 @@ sharpen::WalStatusMap::WalStatusMap(sharpen::IEventLoopGroup &loopGroup, std::st
     , map_()
     , lock_(nullptr)
     , offset_(0)
-    , contentSize_(0) {
+    , contentSize_(0)
+    , compacting_(false)
+    , compactOffset_(0)
+    , compaction_(nullptr) {
     assert(!this->name_.empty());
     this->tempName_.resize(this->name_.size() + 4);
     std::memcpy(const_cast<char *>(this->tempName_.data()), this->name_.data(), this->name_.size());
@@ -99,9 +106,8 @@ void sharpen::WalStatusMap::Load() {
                     (void)error;
                     return;
                 }
-                bool result{this->Insert(std::move(key), std::move(value))};
-                assert(result);
-                (void)result;
+                // the compacted part may already contain records of the tail
+                this->Insert(std::move(key), std::move(value));
             } break;
             case removeTag_: {
                 sharpen::ByteBuffer key;
@@ -113,9 +119,7 @@ void sharpen::WalStatusMap::Load() {
                     (void)error;
                     return;
                 }
-                bool result{this->Erase(key)};
-                assert(result);
-                (void)result;
+                this->Erase(key);
             } break;
             default:
                 this->channel_->Truncate(offset);
@@ -126,54 +130,158 @@ void sharpen::WalStatusMap::Load() {
     this->offset_ = size;
 }
 
-void sharpen::WalStatusMap::RebuildFile() {
+void sharpen::WalStatusMap::StartCompaction() {
+    assert(!this->compacting_);
+    this->WaitForCompaction();
+    sharpen::AwaitableFuture<void> *future{new (std::nothrow) sharpen::AwaitableFuture<void>{}};
+    if (!future) {
+        throw std::bad_alloc{};
+    }
+    this->compaction_.reset(future);
+    this->compactOffset_ = this->offset_;
+    this->compacting_ = true;
+    sharpen::Launch(&Self::Compact, this);
+}
+
+void sharpen::WalStatusMap::Compact() noexcept {
     assert(this->loopGroup_);
-    assert(!this->name_.empty());
     assert(!this->tempName_.empty());
-    sharpen::FileChannelPtr channel{sharpen::OpenFileChannel(this->tempName_.c_str(),
-                                                             sharpen::FileAccessMethod::Write,
-                                                             sharpen::FileOpenMethod::CreateNew)};
+    sharpen::FileChannelPtr channel{nullptr};
     std::uint64_t offset{0};
-    channel->Register(*this->loopGroup_);
-    if (!this->map_.empty()) {
-        sharpen::ByteBuffer buf{4096};
-        for (auto begin = this->map_.begin(), end = this->map_.end(); begin != end; ++begin) {
-            sharpen::BufferWriter writer{buf};
-            std::uint8_t tag{writeTag_};
-            writer.Write(tag);
-            writer.Write(begin->first);
-            writer.Write(begin->second);
-            std::size_t sz{channel->WriteFixedAsync(buf.Data(), writer.GetLength(), offset)};
-            assert(sz == writer.GetLength());
-            if (sz != writer.GetLength()) {
+    std::exception_ptr error;
+    try {
+        channel = sharpen::OpenFileChannel(this->tempName_.c_str(),
+                                           sharpen::FileAccessMethod::Write,
+                                           sharpen::FileOpenMethod::CreateOrOpen);
+        channel->Truncate();
+        channel->Register(*this->loopGroup_);
+        // walk map_ in chunks under the read lock
+        // each chunk is serialized into buf and written after the lock is released
+        // changes after compactOffset_ are fixed up by replaying the tail
+        sharpen::ByteBuffer buf{compactBatchSize_};
+        sharpen::ByteBuffer lastKey;
+        bool started{false};
+        while (true) {
+            std::size_t size{0};
+            {
+                this->lock_->LockRead();
+                std::unique_lock<sharpen::AsyncRwLock> lock{*this->lock_, std::adopt_lock};
+                auto begin = started ? this->map_.upper_bound(lastKey) : this->map_.begin();
+                auto last = this->map_.end();
+                for (auto end = this->map_.end(); begin != end; ++begin) {
+                    std::uint8_t tag{writeTag_};
+                    std::size_t recordSize{sizeof(tag) + begin->first.ComputeSize() +
+                                           begin->second.ComputeSize()};
+                    if (size && size + recordSize > buf.GetSize()) {
+                        break;
+                    }
+                    if (recordSize > buf.GetSize()) {
+                        buf.ExtendTo(recordSize);
+                    }
+                    char *record{buf.Data() + size};
+                    record += sharpen::BinarySerializator::UnsafeStoreTo(tag, record);
+                    record += sharpen::BinarySerializator::UnsafeStoreTo(begin->first, record);
+                    sharpen::BinarySerializator::UnsafeStoreTo(begin->second, record);
+                    size += recordSize;
+                    last = begin;
+                }
+                if (last != this->map_.end()) {
+                    lastKey = last->first;
+                    started = true;
+                }
+            }
+            if (!size) {
+                break;
+            }
+            std::size_t sz{channel->WriteFixedAsync(buf.Data(), size, offset)};
+            if (sz != size) {
                 sharpen::ThrowSystemError(sharpen::ErrorIo);
             }
             offset += sz;
         }
+        channel->FlushAsync();
+    } catch (const std::exception &ignore) {
+        (void)ignore;
+        error = std::current_exception();
+    }
+    sharpen::AwaitableFuture<void> *future{this->compaction_.get()};
+    {
+        this->lock_->LockWrite();
+        std::unique_lock<sharpen::AsyncRwLock> lock{*this->lock_, std::adopt_lock};
+        if (!error) {
+            try {
+                this->SwitchFile(std::move(channel), offset);
+            } catch (const std::exception &ignore) {
+                (void)ignore;
+                error = std::current_exception();
+            }
+        }
+        if (error) {
+            if (channel) {
+                channel->Close();
+            }
+            try {
+                sharpen::RemoveFile(this->tempName_.c_str());
+            } catch (const std::exception &ignore) {
+                (void)ignore;
+            }
+        }
+        this->compacting_ = false;
+    }
+    future->Complete();
+}
+
+void sharpen::WalStatusMap::SwitchFile(sharpen::FileChannelPtr channel, std::uint64_t offset) {
+    assert(channel);
+    assert(this->offset_ >= this->compactOffset_);
+    // replay records written during compaction
+    std::uint64_t tail{this->offset_ - this->compactOffset_};
+    if (tail) {
+        sharpen::ByteBuffer buf{sharpen::IntCast<std::size_t>(tail)};
+        std::size_t sz{this->channel_->ReadAsync(buf, this->compactOffset_)};
+        if (sz != buf.GetSize()) {
+            sharpen::ThrowSystemError(sharpen::ErrorIo);
+        }
+        sz = channel->WriteFixedAsync(buf, offset);
+        if (sz != buf.GetSize()) {
+            sharpen::ThrowSystemError(sharpen::ErrorIo);
+        }
+        offset += sz;
+        channel->FlushAsync();
     }
-    channel->FlushAsync();
     channel->Close();
     this->channel_->Close();
     sharpen::RenameFile(this->tempName_.c_str(), this->name_.c_str());
     this->offset_ = offset;
     this->channel_ = sharpen::OpenFileChannel(this->name_.c_str(),
-                                              sharpen::FileAccessMethod::Write,
-                                              sharpen::FileOpenMethod::CreateOrOpen);
+                                              sharpen::FileAccessMethod::All,
+                                              sharpen::FileOpenMethod::CreateOrOpen,
+                                              sharpen::FileIoMethod::Sync);
     this->channel_->Register(*this->loopGroup_);
     this->contentSize_ = this->ComputeContentSize();
 }
 
+void sharpen::WalStatusMap::WaitForCompaction() noexcept {
+    if (this->compaction_) {
+        this->compaction_->Await();
+        this->compaction_.reset();
+    }
+}
+
+void sharpen::WalStatusMap::CheckCompaction() {
+    std::size_t contentSize{this->contentSize_};
+    // an empty map is compacted after its next write
+    if (!this->compacting_ && contentSize && this->offset_ >= contentSize * limitFactor_) {
+        this->StartCompaction();
+    }
+}
+
 void sharpen::WalStatusMap::NviWrite(sharpen::ByteBuffer key, sharpen::ByteBuffer value) {
     {
         this->lock_->LockWrite();
         std::unique_lock<sharpen::AsyncRwLock> lock{*this->lock_, std::adopt_lock};
         bool result{this->Insert(key, value)};
         if (result) {
-            std::size_t contentSize{this->contentSize_};
-            if (contentSize && this->offset_ >= contentSize * limitFactor_) {
-                this->RebuildFile();
-                return;
-            }
             std::size_t pairSize{key.ComputeSize() + value.ComputeSize() + sizeof(std::uint8_t)};
             std::uint8_t tag{writeTag_};
             sharpen::ByteBuffer buf{pairSize};
@@ -189,6 +297,7 @@ void sharpen::WalStatusMap::NviWrite(sharpen::ByteBuffer key, sharpen::ByteBuffe
             }
             this->channel_->FlushAsync();
             this->offset_ += sz;
+            this->CheckCompaction();
         }
     }
 }
@@ -199,11 +308,6 @@ void sharpen::WalStatusMap::NviRemove(const sharpen::ByteBuffer &key) {
         std::unique_lock<sharpen::AsyncRwLock> lock{*this->lock_, std::adopt_lock};
         bool result{this->Erase(key)};
         if (result) {
-            std::size_t contentSize{this->contentSize_};
-            if (this->offset_ >= contentSize * limitFactor_) {
-                this->RebuildFile();
-                return;
-            }
             std::size_t pairSize{key.ComputeSize() + sizeof(std::uint8_t)};
             std::uint8_t tag{removeTag_};
             sharpen::ByteBuffer buf{pairSize};
@@ -218,6 +322,7 @@ void sharpen::WalStatusMap::NviRemove(const sharpen::ByteBuffer &key) {
             }
             this->channel_->FlushAsync();
             this->offset_ += sz;
+            this->CheckCompaction();
         }
     }
 }
@@ -236,23 +341,28 @@ sharpen::Optional<sharpen::ByteBuffer> sharpen::WalStatusMap::NviLookup(
 }
 
 sharpen::WalStatusMap::WalStatusMap(Self &&other) noexcept
-    : name_(std::move(other.name_))
-    , tempName_(std::move(other.tempName_))
-    , channel_(std::move(other.channel_))
-    , loopGroup_(other.loopGroup_)
-    , map_(std::move(other.map_))
-    , lock_(std::move(other.lock_))
-    , offset_(other.offset_)
-    , contentSize_(other.contentSize_) {
-    other.loopGroup_ = nullptr;
-    other.offset_ = 0;
-    other.contentSize_ = 0;
+    : name_()
+    , tempName_()
+    , channel_(nullptr)
+    , loopGroup_(nullptr)
+    , map_()
+    , lock_(nullptr)
+    , offset_(0)
+    , contentSize_(0)
+    , compacting_(false)
+    , compactOffset_(0)
+    , compaction_(nullptr) {
+    // the compaction fiber refers to other
+    *this = std::move(other);
 }
 
 sharpen::WalStatusMap &sharpen::WalStatusMap::operator=(Self &&other) noexcept {
     if (this != std::addressof(other)) {
+        this->WaitForCompaction();
+        other.WaitForCompaction();
         this->name_ = std::move(other.name_);
         this->tempName_ = std::move(other.tempName_);
+        this->channel_ = std::move(other.channel_);
         this->loopGroup_ = other.loopGroup_;
         this->map_ = std::move(other.map_);
         this->lock_ = std::move(other.lock_);
@@ -263,4 +373,8 @@ sharpen::WalStatusMap &sharpen::WalStatusMap::operator=(Self &&other) noexcept {
         other.contentSize_ = 0;
     }
     return *this;
-}
\ No newline at end of file
+}
+
+sharpen::WalStatusMap::~WalStatusMap() noexcept {
+    this->WaitForCompaction();
+}
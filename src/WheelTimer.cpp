@@ -0,0 +1,41 @@
+#include <sharpen/WheelTimer.hpp>
+#ifdef SHARPEN_HAS_TIMERWHEEL
+
+#include <cassert>
+
+sharpen::WheelTimer::WheelTimer(WheelPtr wheel)
+    : Mybase()
+    , wheel_(std::move(wheel))
+    , node_() {
+    assert(this->wheel_);
+    this->node_.prev_ = nullptr;
+    this->node_.next_ = nullptr;
+    this->node_.expire_ = 0;
+    this->node_.future_ = nullptr;
+    this->node_.level_ = 0;
+}
+
+sharpen::WheelTimer::~WheelTimer() noexcept {
+    this->wheel_->Remove(this->node_);
+}
+
+void sharpen::WheelTimer::WaitAsync(sharpen::Future<bool> &future, std::uint64_t waitMs) {
+    if (waitMs == 0) {
+        future.Complete(true);
+        return;
+    }
+    sharpen::Future<bool> *old{this->wheel_->Add(this->node_, waitMs, future)};
+    // the previous wait is replaced
+    if (old && old != &future) {
+        old->Complete(false);
+    }
+}
+
+void sharpen::WheelTimer::Cancel() {
+    sharpen::Future<bool> *future{this->wheel_->Remove(this->node_)};
+    if (future) {
+        future->Complete(false);
+    }
+}
+
+#endif
@@ -7,6 +7,7 @@
 #include <sharpen/BufferWriter.hpp>
 #include <sharpen/DebugTools.hpp>
 #include <sharpen/EventEngine.hpp>
+#include <sharpen/GenericMailParser.hpp>
 #include <sharpen/GenericMailParserFactory.hpp>
 #include <sharpen/IMailReceiver.hpp>
 #include <sharpen/IpTcpActorBuilder.hpp>
@@ -248,6 +249,65 @@ public:
     }
 };
 
+class DirectParseTest : public simpletest::ITypenamedTest<DirectParseTest> {
+private:
+    using Self = DirectParseTest;
+
+public:
+    DirectParseTest() noexcept = default;
+
+    ~DirectParseTest() noexcept = default;
+
+    inline const Self &Const() const noexcept {
+        return *this;
+    }
+
+    inline virtual simpletest::TestResult Run() noexcept {
+        sharpen::GenericMailParser parser{magicNumber};
+        sharpen::GenericMail mail{magicNumber};
+        sharpen::ByteBuffer content{64 * 1024};
+        for (std::size_t i = 0; i != content.GetSize(); ++i) {
+            content[i] = static_cast<char>(i);
+        }
+        mail.SetContent(content);
+        sharpen::Mail large{mail.ReleaseMail()};
+        sharpen::GenericMail empty{magicNumber};
+        sharpen::Mail small{empty.ReleaseMail()};
+        std::size_t size{0};
+        if (parser.GetDirectBuffer(size) != nullptr || size != 0) {
+            return this->Fail("direct buffer should not be ready before header");
+        }
+        parser.Parse(large.Header());
+        char *direct{parser.GetDirectBuffer(size)};
+        if (!direct || size != content.GetSize()) {
+            return this->Fail("direct buffer should cover the whole content");
+        }
+        std::memcpy(direct, content.Data(), 1024);
+        parser.CommitDirectBuffer(1024);
+        direct = parser.GetDirectBuffer(size);
+        if (!direct || size != content.GetSize() - 1024) {
+            return this->Fail("direct buffer should cover the rest of content");
+        }
+        std::memcpy(direct, content.Data() + 1024, size);
+        parser.CommitDirectBuffer(size);
+        // a mail without content is completed by its header
+        parser.Parse(small.Header());
+        if (!parser.Completed()) {
+            return this->Fail("parser should be completed");
+        }
+        sharpen::Mail result{parser.PopCompletedMail()};
+        if (result.Content() != content) {
+            return this->Fail("content should be equal");
+        }
+        if (!parser.Completed()) {
+            return this->Fail("empty mail should be completed");
+        }
+        result = parser.PopCompletedMail();
+        return this->Assert(result.Content().Empty() && !parser.Completed(),
+                            "empty mail should be parsed");
+    }
+};
+
 int Entry() {
     sharpen::StartupNetSupport();
     simpletest::TestRunner runner{simpletest::DisplayMode::Blocked};
@@ -255,6 +315,7 @@ int Entry() {
     runner.Register<PipelineTest>();
     runner.Register<CancelTest>();
     runner.Register<PipelineCancelTest>();
+    runner.Register<DirectParseTest>();
     int code{runner.Run()};
     sharpen::CleanupNetSupport();
     return code;
@@ -1,5 +1,6 @@
 #include <cassert>
 #include <cstdio>
+#include <vector>
 
 #include <sharpen/BufferOps.hpp>
 
@@ -67,10 +68,110 @@ public:
     }
 };
 
+class Crc32cTest : public simpletest::ITypenamedTest<Crc32cTest> {
+private:
+    using Self = Crc32cTest;
+
+public:
+    Crc32cTest() noexcept = default;
+
+    ~Crc32cTest() noexcept = default;
+
+    inline const Self &Const() const noexcept {
+        return *this;
+    }
+
+    inline virtual simpletest::TestResult Run() noexcept {
+        char buf[] = "123456789";
+        std::uint32_t checksum = sharpen::Crc32c(buf, sizeof(buf) - 1);
+        return this->Assert(checksum == 0xE3069283,
+                            "Crc32c(\"123456789\") should == 0xE3069283,but it not");
+    }
+};
+
+// bit-at-a-time reflected crc
+static std::uint32_t ReferenceCrc(std::uint32_t poly,
+                                  std::uint32_t crc,
+                                  const char *data,
+                                  std::size_t size) noexcept {
+    for (std::size_t i = 0; i != size; ++i) {
+        crc ^= static_cast<std::uint8_t>(data[i]);
+        for (std::size_t j = 0; j != 8; ++j) {
+            crc = (crc & 1) ? (crc >> 1) ^ poly : crc >> 1;
+        }
+    }
+    return crc;
+}
+
+static std::uint32_t ReferenceAdler32(const char *data, std::size_t size) noexcept {
+    std::uint32_t low{1};
+    std::uint32_t height{0};
+    for (std::size_t i = 0; i != size; ++i) {
+        low = (low + static_cast<std::uint8_t>(data[i])) % 65521;
+        height = (height + low) % 65521;
+    }
+    return low | (height << 16);
+}
+
+class LongChecksumTest : public simpletest::ITypenamedTest<LongChecksumTest> {
+private:
+    using Self = LongChecksumTest;
+
+public:
+    LongChecksumTest() noexcept = default;
+
+    ~LongChecksumTest() noexcept = default;
+
+    inline const Self &Const() const noexcept {
+        return *this;
+    }
+
+    inline virtual simpletest::TestResult Run() noexcept {
+        // large enough to use every kernel path
+        std::vector<char> buf(3 * 8192 * 2 + 3 * 256 + 123);
+        std::uint32_t seed{2333};
+        for (auto begin = buf.begin(), end = buf.end(); begin != end; ++begin) {
+            seed = seed * 1103515245 + 12345;
+            *begin = static_cast<char>(seed >> 16);
+        }
+        const std::size_t offsets[] = {0, 1, 3, 7};
+        const std::size_t sizes[] = {0, 1, 7, 8, 9, 255, 769, 5553, 24576, 24576 + 777};
+        for (std::size_t offset : offsets) {
+            for (std::size_t size : sizes) {
+                const char *data{buf.data() + offset};
+                if (sharpen::Crc16(data, size) !=
+                    ReferenceCrc(0xA001, 0xFFFF, data, size)) {
+                    return this->Fail("Crc16 should equal to reference");
+                }
+                if (sharpen::Crc32(data, size) !=
+                    (ReferenceCrc(0xEDB88320, 0xFFFFFFFF, data, size) ^ 0xFFFFFFFF)) {
+                    return this->Fail("Crc32 should equal to reference");
+                }
+                if (sharpen::Crc32c(data, size) !=
+                    (ReferenceCrc(0x82F63B78, 0xFFFFFFFF, data, size) ^ 0xFFFFFFFF)) {
+                    return this->Fail("Crc32c should equal to reference");
+                }
+                if (sharpen::Adler32(data, size) != ReferenceAdler32(data, size)) {
+                    return this->Fail("Adler32 should equal to reference");
+                }
+                std::size_t half{size / 2};
+                std::uint32_t crc{sharpen::Crc32c(data, half)};
+                if (sharpen::Crc32c(crc, data + half, size - half) !=
+                    sharpen::Crc32c(data, size)) {
+                    return this->Fail("rolling Crc32c should equal to Crc32c");
+                }
+            }
+        }
+        return this->Success();
+    }
+};
+
 int main(int argc, char const *argv[]) {
     simpletest::TestRunner runner;
     runner.Register<Crc16Test>();
     runner.Register<Adler32Test>();
     runner.Register<Crc32Tester>();
+    runner.Register<Crc32cTest>();
+    runner.Register<LongChecksumTest>();
     return runner.Run();
 }
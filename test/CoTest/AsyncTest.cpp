@@ -6,12 +6,18 @@
 #include <sharpen/EventEngine.hpp>
 #include <sharpen/FiberLocal.hpp>
 #include <sharpen/FixedWorkerGroup.hpp>
+#include <sharpen/MemoryStackPool.hpp>
+#include <sharpen/MpscQueue.hpp>
 #include <sharpen/SingleWorkerGroup.hpp>
 #include <sharpen/TimerOps.hpp>
+#include <sharpen/WorkStealingQueue.hpp>
 #include <sharpen/YieldOps.hpp>
 #include <simpletest/TestRunner.hpp>
+#include <atomic>
 #include <cassert>
 #include <cstdio>
+#include <thread>
+#include <vector>
 
 
 class AsyncTest : public simpletest::ITypenamedTest<AsyncTest> {
@@ -226,6 +232,218 @@ public:
     }
 };
 
+class StackPoolTest : public simpletest::ITypenamedTest<StackPoolTest> {
+private:
+    using Self = StackPoolTest;
+
+public:
+    StackPoolTest() noexcept = default;
+
+    ~StackPoolTest() noexcept = default;
+
+    inline const Self &Const() const noexcept {
+        return *this;
+    }
+
+    inline virtual simpletest::TestResult Run() noexcept {
+        void *mem{nullptr};
+        {
+            sharpen::MemoryStack stack{
+                sharpen::MemoryStack::AllocStack(60 * 1024, sharpen::StackAllocMethod::Pooled)};
+            if (stack.GetSize() != 64 * 1024) {
+                return this->Fail("stack size should be rounded to 64kb");
+            }
+            // touch the whole stack
+            std::memset(stack.Bottom(), 0, stack.GetSize());
+            mem = stack.Bottom();
+        }
+        sharpen::MemoryStack stack{
+            sharpen::MemoryStack::AllocStack(64 * 1024, sharpen::StackAllocMethod::Pooled)};
+        return this->Assert(stack.Bottom() == mem, "stack should be reused by the pool");
+    }
+};
+
+class PooledFiberTest : public simpletest::ITypenamedTest<PooledFiberTest> {
+private:
+    using Self = PooledFiberTest;
+
+public:
+    PooledFiberTest() noexcept = default;
+
+    ~PooledFiberTest() noexcept = default;
+
+    inline const Self &Const() const noexcept {
+        return *this;
+    }
+
+    inline virtual simpletest::TestResult Run() noexcept {
+        constexpr std::size_t count{1024};
+        std::vector<sharpen::AwaitableFuture<std::size_t>> futures;
+        futures.resize(count);
+        for (std::size_t i = 0; i != count; ++i) {
+            sharpen::AwaitableFuture<std::size_t> *future{&futures[i]};
+            sharpen::LaunchWithStack(
+                sharpen::StackAllocMethod::Pooled, 16 * 1024, [future, i]() {
+                    char buf[4 * 1024];
+                    std::memset(buf, static_cast<int>(i), sizeof(buf));
+                    future->Complete(static_cast<unsigned char>(buf[i % sizeof(buf)]) ==
+                                             (i & 0xff)
+                                         ? i
+                                         : 0);
+                });
+        }
+        bool status{true};
+        for (std::size_t i = 0; i != count; ++i) {
+            if (futures[i].Await() != i) {
+                status = false;
+            }
+        }
+        return this->Assert(status, "pooled fiber return wrong answer");
+    }
+};
+
+class WorkStealingQueueTest : public simpletest::ITypenamedTest<WorkStealingQueueTest> {
+private:
+    using Self = WorkStealingQueueTest;
+
+public:
+    WorkStealingQueueTest() noexcept = default;
+
+    ~WorkStealingQueueTest() noexcept = default;
+
+    inline const Self &Const() const noexcept {
+        return *this;
+    }
+
+    inline virtual simpletest::TestResult Run() noexcept {
+        int items[4] = {0, 1, 2, 3};
+        sharpen::WorkStealingQueue<int> queue{4};
+        for (std::size_t i = 0; i != 4; ++i) {
+            if (!queue.Push(items + i)) {
+                return this->Fail("queue should not be full");
+            }
+        }
+        if (queue.Push(items)) {
+            return this->Fail("queue should be full");
+        }
+        // owner pops the newest item
+        // thieves steal the oldest item
+        if (queue.Pop() != items + 3 || queue.Steal() != items) {
+            return this->Fail("wrong order");
+        }
+        if (queue.Pop() != items + 2 || queue.Pop() != items + 1) {
+            return this->Fail("wrong order");
+        }
+        return this->Assert(queue.Pop() == nullptr && queue.Steal() == nullptr,
+                            "queue should be empty");
+    }
+};
+
+class MpscQueueTest : public simpletest::ITypenamedTest<MpscQueueTest> {
+private:
+    using Self = MpscQueueTest;
+
+public:
+    MpscQueueTest() noexcept = default;
+
+    ~MpscQueueTest() noexcept = default;
+
+    inline const Self &Const() const noexcept {
+        return *this;
+    }
+
+    inline virtual simpletest::TestResult Run() noexcept {
+        constexpr std::size_t producers{4};
+        constexpr std::size_t count{64 * 1024};
+        // smaller than the number of items in flight
+        sharpen::MpscQueue<std::size_t> queue{16};
+        std::vector<std::thread> threads;
+        for (std::size_t i = 0; i != producers; ++i) {
+            threads.emplace_back([&queue, i]() {
+                for (std::size_t j = 0; j != count; ++j) {
+                    queue.Push(i * count + j);
+                }
+            });
+        }
+        // items of a producer keep their order
+        std::vector<std::size_t> nexts(producers, 0);
+        bool status{true};
+        std::size_t received{0};
+        while (received != producers * count) {
+            std::size_t item{0};
+            if (!queue.TryPop(item)) {
+                std::this_thread::yield();
+                continue;
+            }
+            std::size_t producer{item / count};
+            if (nexts[producer] != item % count) {
+                status = false;
+            }
+            nexts[producer] += 1;
+            received += 1;
+        }
+        for (auto begin = threads.begin(), end = threads.end(); begin != end; ++begin) {
+            begin->join();
+        }
+        return this->Assert(status, "items of a producer should keep their order");
+    }
+};
+
+class FutureCallbackTest : public simpletest::ITypenamedTest<FutureCallbackTest> {
+private:
+    using Self = FutureCallbackTest;
+
+public:
+    FutureCallbackTest() noexcept = default;
+
+    ~FutureCallbackTest() noexcept = default;
+
+    inline const Self &Const() const noexcept {
+        return *this;
+    }
+
+    inline virtual simpletest::TestResult Run() noexcept {
+        std::size_t count{0};
+        sharpen::Future<std::int32_t> before;
+        before.SetCallback([&count](sharpen::Future<std::int32_t> &future) {
+            count += static_cast<std::size_t>(future.Get());
+        });
+        before.Complete(1);
+        sharpen::Future<std::int32_t> after;
+        after.Complete(2);
+        after.SetCallback([&count](sharpen::Future<std::int32_t> &future) {
+            count += static_cast<std::size_t>(future.Get());
+        });
+        // larger than the inline slot
+        char padding[2 * sharpen::FutureCallbackSize] = {4};
+        sharpen::Future<void> large;
+        large.SetCallback([&count, padding](sharpen::Future<void> &) {
+            count += static_cast<std::size_t>(padding[0]);
+        });
+        large.Complete();
+        if (count != 7) {
+            return this->Fail("callback should be called once");
+        }
+        // complete on another fiber while the callback and the awaiter are registered
+        constexpr std::size_t round{16 * 1024};
+        std::atomic_size_t callbacks{0};
+        for (std::size_t i = 0; i != round; ++i) {
+            sharpen::AwaitableFuture<std::size_t> future;
+            sharpen::Launch([&future, i]() { future.Complete(i); });
+            future.SetCallback([&callbacks](sharpen::Future<std::size_t> &) {
+                callbacks.fetch_add(1, std::memory_order_relaxed);
+            });
+            if (future.Await() != i) {
+                return this->Fail("Await() return wrong answer");
+            }
+            while (callbacks.load(std::memory_order_relaxed) != i + 1) {
+                sharpen::YieldCycle();
+            }
+        }
+        return this->Success();
+    }
+};
+
 static int Test() {
     constexpr std::size_t workerGroupJobs{256 * 1024};
     simpletest::TestRunner runner;
@@ -243,6 +461,11 @@ static int Test() {
         workerGroupJobs);
     runner.Register<FiberLocalTest>();
     runner.Register<AsyncBlockingQueueTest>();
+    runner.Register<StackPoolTest>();
+    runner.Register<PooledFiberTest>();
+    runner.Register<WorkStealingQueueTest>();
+    runner.Register<FutureCallbackTest>();
+    runner.Register<MpscQueueTest>();
     return runner.Run();
 }
 
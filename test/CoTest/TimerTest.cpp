@@ -1,5 +1,6 @@
 #include <cassert>
 #include <cstdio>
+#include <vector>
 
 #include <sharpen/AsyncLeaseLock.hpp>
 #include <sharpen/AsyncOps.hpp>
@@ -150,10 +151,57 @@ public:
     }
 };
 
+class MultipleTimersTest : public simpletest::ITypenamedTest<MultipleTimersTest> {
+private:
+    using Self = MultipleTimersTest;
+
+    // cross the cascades of timer wheel
+    static constexpr std::size_t count_{4};
+    static constexpr std::uint64_t waitMs_[count_]{5, 120, 300, 1100};
+
+public:
+    MultipleTimersTest() noexcept = default;
+
+    ~MultipleTimersTest() noexcept = default;
+
+    inline const Self &Const() const noexcept {
+        return *this;
+    }
+
+    inline virtual simpletest::TestResult Run() noexcept {
+        std::vector<sharpen::TimerPtr> timers;
+        std::vector<sharpen::AwaitableFuture<bool>> futures(count_);
+        auto begin{std::chrono::steady_clock::now()};
+        // arm in reverse order
+        for (std::size_t i = count_; i != 0; --i) {
+            timers.emplace_back(sharpen::MakeTimer(sharpen::GetLocalLoopGroup()));
+            timers.back()->WaitAsync(futures[i - 1], std::chrono::milliseconds(waitMs_[i - 1]));
+        }
+        sharpen::AwaitableFuture<bool> canceled;
+        sharpen::TimerPtr timer{sharpen::MakeTimer(sharpen::GetLocalLoopGroup())};
+        timer->WaitAsync(canceled, std::chrono::seconds(60));
+        for (std::size_t i = 0; i != count_; ++i) {
+            if (!futures[i].Await()) {
+                return this->Fail("timer should expire,but it not");
+            }
+            auto time{std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - begin)};
+            if (static_cast<std::uint64_t>(time.count()) < waitMs_[i]) {
+                return this->Fail("timer expired too early");
+            }
+        }
+        timer->Cancel();
+        return this->Assert(!canceled.Await(), "canceled timer should not expire,but it not");
+    }
+};
+
+constexpr std::uint64_t MultipleTimersTest::waitMs_[MultipleTimersTest::count_];
+
 static int Test() {
     simpletest::TestRunner runner;
     runner.Register<CancelTest>();
     runner.Register<AwaitForTest>();
+    runner.Register<MultipleTimersTest>();
     runner.Register<AwaitForCompletedTest>();
     runner.Register<LeaseLockTest>();
     runner.Register<LeaseLockTimeoutTest>();
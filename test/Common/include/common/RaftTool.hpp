@@ -2,7 +2,10 @@
 #ifndef _RAFTTOOL_HPP
 #define _RAFTTOOL_HPP
 
+#include <sharpen/ByteBuffer.hpp>
+#include <sharpen/FileRaftSnapshotController.hpp>
 #include <sharpen/IConsensus.hpp>
+#include <sharpen/IHostPipeline.hpp>
 #include <sharpen/ILogStorage.hpp>
 #include <sharpen/IMailReceiver.hpp>
 #include <sharpen/IRaftLogAccesser.hpp>
@@ -12,6 +15,8 @@
 #include <sharpen/Quorum.hpp>
 #include <sharpen/RaftLeaderCounter.hpp>
 #include <sharpen/RaftOption.hpp>
+#include <sharpen/TcpHost.hpp>
+#include <sharpen/TcpMultiplexer.hpp>
 #include <memory>
 #include <string>
 #include <vector>
@@ -46,4 +51,51 @@ extern std::shared_ptr<sharpen::IConsensus> CreateRaft(
     sharpen::RaftOption option,
     bool pipeline);
 
+extern std::string FormatGroupName(const char *name,
+                                   const char *extName,
+                                   std::uint64_t port,
+                                   std::uint32_t raftNumber);
+
+extern void RemoveGroupStorage(std::uint16_t port, std::uint32_t raftNumber);
+
+extern std::vector<std::shared_ptr<sharpen::TcpMultiplexer>> CreateMultiplexers(
+    std::uint16_t port, std::uint16_t begin, std::uint16_t end, std::uint32_t magic, bool pipeline);
+
+extern std::unique_ptr<sharpen::IQuorum> ConfigMultiplexedPeers(
+    sharpen::IQuorum *quorum,
+    const std::vector<std::shared_ptr<sharpen::TcpMultiplexer>> *multiplexers,
+    sharpen::IMailReceiver *receiver);
+
+extern std::shared_ptr<sharpen::IConsensus> CreateGroupRaft(std::uint16_t port,
+                                                            std::uint32_t magic,
+                                                            std::uint32_t raftNumber,
+                                                            sharpen::RaftOption option);
+
+// snapshots committed by CommitSnapshot()
+constexpr std::size_t snapshotChunkSize{64 * 1024};
+
+constexpr std::uint64_t snapshotIndex{16};
+
+constexpr std::uint64_t snapshotTerm{1};
+
+extern std::string GetSnapshotName(const char *name, std::uint16_t port);
+
+extern void RemoveSnapshot(const char *name, std::uint16_t port);
+
+// pseudo-random data of snapshots
+extern sharpen::ByteBuffer GenerateData(std::size_t size);
+
+extern std::unique_ptr<sharpen::FileRaftSnapshotController> CreateSnapshotController(
+    const char *name, std::uint16_t port);
+
+extern void CommitSnapshot(sharpen::FileRaftSnapshotController &ctrl,
+                           const sharpen::ByteBuffer &data);
+
+extern std::unique_ptr<sharpen::IHostPipeline> ConfigRaftPipeline(
+    std::shared_ptr<sharpen::IConsensus> raft, std::uint32_t magic);
+
+extern std::unique_ptr<sharpen::TcpHost> CreateRaftHost(std::uint16_t port,
+                                                        std::shared_ptr<sharpen::IConsensus> raft,
+                                                        std::uint32_t magic);
+
 #endif
\ No newline at end of file
@@ -1,15 +1,22 @@
 #include <common/RaftTool.hpp>
 
+#include <common/RaftStep.hpp>
+#include <sharpen/EventEngine.hpp>
 #include <sharpen/FileOps.hpp>
 #include <sharpen/GenericMailParserFactory.hpp>
 #include <sharpen/IpTcpActorBuilder.hpp>
+#include <sharpen/IpTcpStreamFactory.hpp>
 #include <sharpen/MultiRaftMailBuilder.hpp>
 #include <sharpen/MultiRaftMailExtractor.hpp>
+#include <sharpen/MultiplexedActorBuilder.hpp>
 #include <sharpen/Quorum.hpp>
 #include <sharpen/RaftConsensus.hpp>
 #include <sharpen/RaftLogAccesser.hpp>
 #include <sharpen/RaftMailBuilder.hpp>
 #include <sharpen/RaftMailExtractor.hpp>
+#include <sharpen/SimpleHostPipeline.hpp>
+#include <sharpen/SingleWorkerGroup.hpp>
+#include <sharpen/TcpPoster.hpp>
 #include <sharpen/WalLogStorage.hpp>
 #include <sharpen/WalStatusMap.hpp>
 #include <limits>
@@ -64,8 +71,8 @@ void RemoveLogStorage(std::uint16_t port) {
 }
 
 std::unique_ptr<sharpen::IRaftLogAccesser> CreateLogAccesser(std::uint32_t magic) {
-    std::unique_ptr<sharpen::IRaftLogAccesser> accesser{new (std::nothrow)
-                                                            sharpen::RaftLogAccesser{magic}};
+    std::unique_ptr<sharpen::IRaftLogAccesser> accesser{
+        new (std::nothrow) sharpen::RaftLogAccesser{magic, sharpen::RaftLogChecksum::Crc32c}};
     if (!accesser) {
         std::terminate();
     }
@@ -136,4 +143,205 @@ std::shared_ptr<sharpen::IConsensus> CreateRaft(
     raft->PrepareMailBuilder(std::move(builder));
     raft->PrepareMailExtractor(std::move(extractor));
     return raft;
+}
+
+std::string FormatGroupName(const char *name,
+                            const char *extName,
+                            std::uint64_t port,
+                            std::uint32_t raftNumber) {
+    std::stringstream builder;
+    builder << name << "." << port << "." << raftNumber << "." << extName;
+    return builder.str();
+}
+
+void RemoveGroupStorage(std::uint16_t port, std::uint32_t raftNumber) {
+    std::string walName{FormatGroupName("./raftlog", "wal", port, raftNumber)};
+    sharpen::RemoveFile(walName.c_str());
+    walName = FormatGroupName("./raftstatus", "wal", port, raftNumber);
+    sharpen::RemoveFile(walName.c_str());
+}
+
+std::vector<std::shared_ptr<sharpen::TcpMultiplexer>> CreateMultiplexers(std::uint16_t port,
+                                                                         std::uint16_t begin,
+                                                                         std::uint16_t end,
+                                                                         std::uint32_t magic,
+                                                                         bool pipeline) {
+    std::vector<std::shared_ptr<sharpen::TcpMultiplexer>> multiplexers;
+    auto ports{GetPeers(begin, end)};
+    std::shared_ptr<sharpen::ITcpSteamFactory> streamFactory{
+        std::make_shared<sharpen::IpTcpStreamFactory>(sharpen::IpEndPoint{0, 0})};
+    std::shared_ptr<sharpen::IMailParserFactory> parserFactory{
+        std::make_shared<sharpen::GenericMailParserFactory>(
+            magic, (std::numeric_limits<std::uint32_t>::max)())};
+    for (auto begin = ports.begin(), end = ports.end(); begin != end; ++begin) {
+        if (begin->GetPort() == port) {
+            continue;
+        }
+        std::unique_ptr<sharpen::IEndPoint> remote{new (std::nothrow)
+                                                       sharpen::IpEndPoint{*begin}};
+        if (!remote) {
+            std::terminate();
+        }
+        std::unique_ptr<sharpen::IWorkerGroup> worker{nullptr};
+        if (pipeline) {
+            worker.reset(new (std::nothrow)
+                             sharpen::SingleWorkerGroup{sharpen::GetLocalScheduler()});
+            if (!worker) {
+                std::terminate();
+            }
+        }
+        std::unique_ptr<sharpen::IRemotePoster> poster{new (std::nothrow) sharpen::TcpPoster{
+            std::move(remote), streamFactory, std::move(worker)}};
+        if (!poster) {
+            std::terminate();
+        }
+        multiplexers.emplace_back(std::make_shared<sharpen::TcpMultiplexer>(
+            sharpen::GetLocalScheduler(), magic, parserFactory, std::move(poster)));
+    }
+    return multiplexers;
+}
+
+std::unique_ptr<sharpen::IQuorum> ConfigMultiplexedPeers(
+    sharpen::IQuorum *quorum,
+    const std::vector<std::shared_ptr<sharpen::TcpMultiplexer>> *multiplexers,
+    sharpen::IMailReceiver *receiver) {
+    (void)quorum;
+    assert(multiplexers != nullptr);
+    assert(receiver != nullptr);
+    std::unique_ptr<sharpen::IQuorum> peers{new (std::nothrow) sharpen::Quorum{}};
+    if (!peers) {
+        std::terminate();
+    }
+    for (auto begin = multiplexers->begin(), end = multiplexers->end(); begin != end; ++begin) {
+        std::unique_ptr<sharpen::MultiplexedActorBuilder> builder{
+            new (std::nothrow) sharpen::MultiplexedActorBuilder{*begin}};
+        if (!builder) {
+            std::terminate();
+        }
+        builder->PrepareReceiver(*receiver);
+        peers->Register((*begin)->GetId(), std::move(builder));
+    }
+    return peers;
+}
+
+std::shared_ptr<sharpen::IConsensus> CreateGroupRaft(std::uint16_t port,
+                                                     std::uint32_t magic,
+                                                     std::uint32_t raftNumber,
+                                                     sharpen::RaftOption option) {
+    sharpen::IpEndPoint endPoint;
+    endPoint.SetAddrByString("127.0.0.1");
+    endPoint.SetPort(port);
+    std::unique_ptr<sharpen::IStatusMap> status{new (std::nothrow) sharpen::WalStatusMap{
+        FormatGroupName("./raftstatus", "wal", port, raftNumber)}};
+    if (!status) {
+        std::terminate();
+    }
+    std::unique_ptr<sharpen::ILogStorage> logs{new (std::nothrow) sharpen::WalLogStorage{
+        FormatGroupName("./raftlog", "wal", port, raftNumber)}};
+    if (!logs) {
+        std::terminate();
+    }
+    std::shared_ptr<sharpen::RaftConsensus> raft{
+        std::make_shared<sharpen::RaftConsensus>(endPoint.GetActorId(),
+                                                 std::move(status),
+                                                 std::move(logs),
+                                                 CreateLogAccesser(magic),
+                                                 nullptr,
+                                                 nullptr,
+                                                 option)};
+    std::unique_ptr<sharpen::IRaftMailBuilder> builder{
+        new (std::nothrow) sharpen::MultiRaftMailBuilder{magic, raftNumber}};
+    if (!builder) {
+        std::terminate();
+    }
+    std::unique_ptr<sharpen::IRaftMailExtractor> extractor{
+        new (std::nothrow) sharpen::MultiRaftMailExtractor{magic, raftNumber}};
+    if (!extractor) {
+        std::terminate();
+    }
+    raft->PrepareMailBuilder(std::move(builder));
+    raft->PrepareMailExtractor(std::move(extractor));
+    return raft;
+}
+
+std::string GetSnapshotName(const char *name, std::uint16_t port) {
+    return FormatName(name, "snap", port);
+}
+
+void RemoveSnapshot(const char *name, std::uint16_t port) {
+    std::string snapshotName{GetSnapshotName(name, port)};
+    const char *extNames[] = {"", ".meta", ".tmp", ".meta.tmp"};
+    for (const char *extName : extNames) {
+        std::string fileName{snapshotName + extName};
+        if (sharpen::ExistFile(fileName.c_str())) {
+            sharpen::RemoveFile(fileName.c_str());
+        }
+    }
+}
+
+sharpen::ByteBuffer GenerateData(std::size_t size) {
+    sharpen::ByteBuffer buf{size};
+    std::uint32_t seed{2333};
+    for (std::size_t i = 0; i != size; ++i) {
+        seed = seed * 1103515245 + 12345;
+        buf[i] = static_cast<char>(seed >> 16);
+    }
+    return buf;
+}
+
+std::unique_ptr<sharpen::FileRaftSnapshotController> CreateSnapshotController(const char *name,
+                                                                              std::uint16_t port) {
+    std::unique_ptr<sharpen::FileRaftSnapshotController> ctrl{
+        new (std::nothrow) sharpen::FileRaftSnapshotController{
+            sharpen::GetLocalLoopGroup(), GetSnapshotName(name, port), snapshotChunkSize}};
+    if (!ctrl) {
+        throw std::bad_alloc{};
+    }
+    return ctrl;
+}
+
+void CommitSnapshot(sharpen::FileRaftSnapshotController &ctrl, const sharpen::ByteBuffer &data) {
+    std::string name{ctrl.GetName() + ".new"};
+    {
+        sharpen::FileChannelPtr channel{sharpen::OpenFileChannel(
+            name.c_str(), sharpen::FileAccessMethod::Write, sharpen::FileOpenMethod::CreateNew)};
+        channel->Register(sharpen::GetLocalLoopGroup());
+        channel->WriteFixedAsync(data.Data(), data.GetSize(), 0);
+        channel->FlushAsync();
+        channel->Close();
+    }
+    sharpen::RaftSnapshotMetadata metadata;
+    metadata.SetLastIndex(snapshotIndex);
+    metadata.SetLastTerm(snapshotTerm);
+    ctrl.Commit(name.c_str(), std::move(metadata));
+}
+
+std::unique_ptr<sharpen::IHostPipeline> ConfigRaftPipeline(
+    std::shared_ptr<sharpen::IConsensus> raft, std::uint32_t magic) {
+    std::unique_ptr<sharpen::IHostPipeline> pipe{new (std::nothrow) sharpen::SimpleHostPipeline{}};
+    if (!pipe) {
+        throw std::bad_alloc{};
+    }
+    std::unique_ptr<RaftStep> step{new (std::nothrow) RaftStep{magic, std::move(raft)}};
+    if (!step) {
+        throw std::bad_alloc{};
+    }
+    step->DisableLogging();
+    pipe->Register(std::move(step));
+    return pipe;
+}
+
+std::unique_ptr<sharpen::TcpHost> CreateRaftHost(std::uint16_t port,
+                                                 std::shared_ptr<sharpen::IConsensus> raft,
+                                                 std::uint32_t magic) {
+    sharpen::IpEndPoint endPoint;
+    endPoint.SetAddrByString("127.0.0.1");
+    endPoint.SetPort(port);
+    sharpen::IpTcpStreamFactory streamFactory{endPoint};
+    std::unique_ptr<sharpen::TcpHost> host{new (std::nothrow) sharpen::TcpHost{streamFactory}};
+    if (!host) {
+        throw std::bad_alloc{};
+    }
+    host->ConfiguratePipeline(&ConfigRaftPipeline, std::move(raft), magic);
+    return host;
 }
\ No newline at end of file
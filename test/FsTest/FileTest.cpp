@@ -1,8 +1,10 @@
 #include <cassert>
 #include <cstdio>
 #include <cstring>
+#include <vector>
 
 #include <sharpen/AlignedAlloc.hpp>
+#include <sharpen/AwaitableFuture.hpp>
 #include <sharpen/EventEngine.hpp>
 #include <sharpen/FileOps.hpp>
 #include <sharpen/IFileChannel.hpp>
@@ -298,6 +300,140 @@ public:
     }
 };
 
+class BatchWriteTest : public simpletest::ITypenamedTest<BatchWriteTest> {
+private:
+    using Self = BatchWriteTest;
+
+    // more than the depth of ring
+    static constexpr std::size_t count_{256};
+
+public:
+    BatchWriteTest() noexcept = default;
+
+    ~BatchWriteTest() noexcept = default;
+
+    inline const Self &Const() const noexcept {
+        return *this;
+    }
+
+    inline virtual simpletest::TestResult Run() noexcept {
+        sharpen::FileChannelPtr channel = sharpen::OpenFileChannel(
+            "./batch.log", sharpen::FileAccessMethod::All, sharpen::FileOpenMethod::CreateNew);
+        channel->Register(sharpen::GetLocalLoopGroup());
+        std::vector<std::uint64_t> values(count_);
+        std::vector<sharpen::AwaitableFuture<std::size_t>> futures(count_);
+        for (std::size_t i = 0; i != count_; ++i) {
+            values[i] = i;
+            channel->WriteAsync(reinterpret_cast<const char *>(&values[i]),
+                                sizeof(values[i]),
+                                i * sizeof(values[i]),
+                                futures[i]);
+        }
+        std::size_t size{0};
+        for (std::size_t i = 0; i != count_; ++i) {
+            size += futures[i].Await();
+        }
+        std::vector<std::uint64_t> buf(count_);
+        channel->ReadAsync(
+            reinterpret_cast<char *>(buf.data()), buf.size() * sizeof(std::uint64_t), 0);
+        channel->Close();
+        sharpen::RemoveFile("./batch.log");
+        if (size != count_ * sizeof(std::uint64_t)) {
+            return this->Fail("size should be count * 8,but it not");
+        }
+        return this->Assert(buf == values, "buf should == values,but it not");
+    }
+};
+
+class RegisteredIoTest : public simpletest::ITypenamedTest<RegisteredIoTest> {
+private:
+    using Self = RegisteredIoTest;
+
+    // larger than registered buffers
+    static constexpr std::size_t largeSize_{128 * 1024};
+
+public:
+    RegisteredIoTest() noexcept = default;
+
+    ~RegisteredIoTest() noexcept = default;
+
+    inline const Self &Const() const noexcept {
+        return *this;
+    }
+
+    inline virtual simpletest::TestResult Run() noexcept {
+        sharpen::FileChannelPtr channel = sharpen::OpenFileChannel(
+            "./registered.log", sharpen::FileAccessMethod::All, sharpen::FileOpenMethod::CreateNew);
+        channel->Register(sharpen::GetLocalLoopGroup());
+        // fallback to normal io if it is not supported
+        channel->EnableRegisteredIo();
+        const char small[] = "hello world";
+        std::vector<char> large(largeSize_);
+        for (std::size_t i = 0; i != large.size(); ++i) {
+            large[i] = static_cast<char>(i % 251);
+        }
+        std::size_t size{channel->WriteAsync(small, sizeof(small), 0)};
+        size += channel->WriteAsync(large.data(), large.size(), sizeof(small));
+        char smallBuf[sizeof(small)] = {0};
+        std::vector<char> largeBuf(largeSize_);
+        channel->ReadAsync(smallBuf, sizeof(smallBuf), 0);
+        channel->ReadAsync(largeBuf.data(), largeBuf.size(), sizeof(small));
+        channel->Close();
+        sharpen::RemoveFile("./registered.log");
+        if (size != sizeof(small) + largeSize_) {
+            return this->Fail("size should be sizeof(small) + largeSize,but it not");
+        }
+        if (std::memcmp(small, smallBuf, sizeof(small))) {
+            return this->Fail("smallBuf should == small,but it not");
+        }
+        return this->Assert(large == largeBuf, "largeBuf should == large,but it not");
+    }
+};
+
+class WriteVectorTest : public simpletest::ITypenamedTest<WriteVectorTest> {
+private:
+    using Self = WriteVectorTest;
+
+public:
+    WriteVectorTest() noexcept = default;
+
+    ~WriteVectorTest() noexcept = default;
+
+    inline const Self &Const() const noexcept {
+        return *this;
+    }
+
+    inline virtual simpletest::TestResult Run() noexcept {
+        sharpen::FileChannelPtr channel = sharpen::OpenFileChannel(
+            "./vector.log", sharpen::FileAccessMethod::All, sharpen::FileOpenMethod::CreateNew);
+        channel->Register(sharpen::GetLocalLoopGroup());
+        const char header[] = "header";
+        std::vector<char> content(64 * 1024);
+        for (std::size_t i = 0; i != content.size(); ++i) {
+            content[i] = static_cast<char>(i % 251);
+        }
+        const char tail[] = "tail";
+        // empty slices should be skipped
+        sharpen::ByteSlice slices[4]{sharpen::ByteSlice{header, sizeof(header)},
+                                     sharpen::ByteSlice{},
+                                     sharpen::ByteSlice{content.data(), content.size()},
+                                     sharpen::ByteSlice{tail, sizeof(tail)}};
+        std::size_t size{channel->WriteVectorFixedAsync(slices, 4, 0)};
+        std::vector<char> expected;
+        expected.insert(expected.end(), header, header + sizeof(header));
+        expected.insert(expected.end(), content.begin(), content.end());
+        expected.insert(expected.end(), tail, tail + sizeof(tail));
+        std::vector<char> buf(expected.size());
+        channel->ReadAsync(buf.data(), buf.size(), 0);
+        channel->Close();
+        sharpen::RemoveFile("./vector.log");
+        if (size != expected.size()) {
+            return this->Fail("size should == expected.size(),but it not");
+        }
+        return this->Assert(buf == expected, "buf should == expected,but it not");
+    }
+};
+
 static int Test() {
     simpletest::TestRunner runner;
     runner.Register<WriteTest>();
@@ -310,6 +446,9 @@ static int Test() {
     runner.Register<MappingTest>();
     runner.Register<ResolvePathTest>();
     runner.Register<DirectOpeartionTest>();
+    runner.Register<BatchWriteTest>();
+    runner.Register<RegisteredIoTest>();
+    runner.Register<WriteVectorTest>();
 #ifndef SHARPEN_ON_WSL
     runner.Register<AllocateTest>();
 #endif
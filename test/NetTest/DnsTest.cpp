@@ -1,8 +1,13 @@
+#include <atomic>
 #include <cassert>
 #include <cstdio>
+#include <cstring>
 #include <iterator>
+#include <string>
+#include <thread>
 
 #include <sharpen/Dns.hpp>
+#include <sharpen/DnsResolver.hpp>
 #include <sharpen/EventEngine.hpp>
 #include <sharpen/INetStreamChannel.hpp>
 #include <sharpen/IpEndPoint.hpp>
@@ -10,6 +15,12 @@
 
 #include <simpletest/TestRunner.hpp>
 
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
 class LookupLocalhostTest : public simpletest::ITypenamedTest<LookupLocalhostTest> {
 private:
     using Self = LookupLocalhostTest;
@@ -42,10 +53,270 @@ public:
     }
 };
 
+// answers "host.test" (A 10.0.0.1, ttl 60) on loopback
+// "missing.test" gets NXDOMAIN and "drop.test" gets nothing
+class StubDnsServer {
+private:
+    using Self = StubDnsServer;
+
+    int fd_;
+    std::uint16_t port_;
+    std::atomic_bool stop_;
+    std::atomic_size_t queryCount_;
+    std::thread worker_;
+
+    static std::string ReadQueryName(const char *buf, std::size_t size, std::size_t &offset) {
+        std::string name;
+        while (offset < size && buf[offset]) {
+            std::size_t length{static_cast<unsigned char>(buf[offset])};
+            if (!name.empty()) {
+                name.push_back('.');
+            }
+            name.append(buf + offset + 1, length);
+            offset += length + 1;
+        }
+        offset += 1;
+        return name;
+    }
+
+    static void Append16(std::string &buf, std::uint16_t val) {
+        buf.push_back(static_cast<char>(val >> 8));
+        buf.push_back(static_cast<char>(val & 0xff));
+    }
+
+    static void Append32(std::string &buf, std::uint32_t val) {
+        Append16(buf, static_cast<std::uint16_t>(val >> 16));
+        Append16(buf, static_cast<std::uint16_t>(val & 0xffff));
+    }
+
+    void Serve() {
+        char buf[512];
+        while (!this->stop_) {
+            sockaddr_in from;
+            socklen_t fromLen{sizeof(from)};
+            ssize_t size{::recvfrom(
+                this->fd_, buf, sizeof(buf), 0, reinterpret_cast<sockaddr *>(&from), &fromLen)};
+            if (size < 12) {
+                continue;
+            }
+            this->queryCount_ += 1;
+            std::size_t offset{12};
+            std::string name{Self::ReadQueryName(buf, static_cast<std::size_t>(size), offset)};
+            std::uint16_t type{static_cast<std::uint16_t>(
+                (static_cast<unsigned char>(buf[offset]) << 8) |
+                static_cast<unsigned char>(buf[offset + 1]))};
+            offset += 4;
+            if (name == "drop.test") {
+                continue;
+            }
+            std::string reply{buf, offset};
+            std::uint16_t rcode{0};
+            std::uint16_t answerCount{0};
+            std::uint16_t authorityCount{0};
+            if (name == "host.test" && type == 1) {
+                answerCount = 1;
+                // pointer to the question name
+                Append16(reply, 0xc00c);
+                Append16(reply, 1);
+                Append16(reply, 1);
+                Append32(reply, 60);
+                Append16(reply, 4);
+                Append32(reply, 0x0a000001);
+            } else {
+                if (name != "host.test") {
+                    rcode = 3;
+                }
+                authorityCount = 1;
+                // soa of the root zone
+                reply.push_back(0);
+                Append16(reply, 6);
+                Append16(reply, 1);
+                Append32(reply, 60);
+                Append16(reply, 22);
+                reply.push_back(0);
+                reply.push_back(0);
+                Append32(reply, 1);
+                Append32(reply, 3600);
+                Append32(reply, 600);
+                Append32(reply, 86400);
+                Append32(reply, 30);
+            }
+            reply[2] = static_cast<char>(0x81);
+            reply[3] = static_cast<char>(0x80 | rcode);
+            reply[6] = 0;
+            reply[7] = static_cast<char>(answerCount);
+            reply[8] = 0;
+            reply[9] = static_cast<char>(authorityCount);
+            ::sendto(this->fd_,
+                     reply.data(),
+                     reply.size(),
+                     0,
+                     reinterpret_cast<sockaddr *>(&from),
+                     fromLen);
+        }
+    }
+
+public:
+    StubDnsServer()
+        : fd_(-1)
+        , port_(0)
+        , stop_(false)
+        , queryCount_(0)
+        , worker_() {
+        this->fd_ = ::socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+        assert(this->fd_ != -1);
+        sockaddr_in addr;
+        std::memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = ::htonl(INADDR_LOOPBACK);
+        addr.sin_port = 0;
+        int r{::bind(this->fd_, reinterpret_cast<sockaddr *>(&addr), sizeof(addr))};
+        assert(r == 0);
+        socklen_t len{sizeof(addr)};
+        r = ::getsockname(this->fd_, reinterpret_cast<sockaddr *>(&addr), &len);
+        assert(r == 0);
+        (void)r;
+        this->port_ = ::ntohs(addr.sin_port);
+        // wake up periodically to check the stop flag
+        timeval timeout;
+        timeout.tv_sec = 0;
+        timeout.tv_usec = 100 * 1000;
+        ::setsockopt(this->fd_, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        this->worker_ = std::thread{&Self::Serve, this};
+    }
+
+    ~StubDnsServer() noexcept {
+        this->stop_ = true;
+        this->worker_.join();
+        ::close(this->fd_);
+    }
+
+    inline sharpen::IpEndPoint GetEndPoint() const noexcept {
+        sharpen::IpEndPoint ep;
+        ep.SetAddrByString("127.0.0.1");
+        ep.SetPort(this->port_);
+        return ep;
+    }
+
+    inline std::size_t GetQueryCount() const noexcept {
+        return this->queryCount_;
+    }
+};
+
+class ResolverCacheTest : public simpletest::ITypenamedTest<ResolverCacheTest> {
+private:
+    using Self = ResolverCacheTest;
+
+    StubDnsServer *server_;
+
+public:
+    explicit ResolverCacheTest(StubDnsServer *server) noexcept
+        : server_(server) {
+    }
+
+    ~ResolverCacheTest() noexcept = default;
+
+    inline const Self &Const() const noexcept {
+        return *this;
+    }
+
+    inline virtual simpletest::TestResult Run() noexcept {
+        sharpen::DnsResolver resolver{sharpen::GetLocalLoopGroup(), this->server_->GetEndPoint()};
+        std::size_t count{this->server_->GetQueryCount()};
+        std::vector<sharpen::DnsResolveResult> results;
+        resolver.ResolveName("host.test", sharpen::AddressFamily::Ip, std::back_inserter(results));
+        if (results.size() != 1) {
+            return this->Fail("should resolve one address");
+        }
+        sharpen::IpEndPoint *ep{static_cast<sharpen::IpEndPoint *>(results[0].EndPointPtr().get())};
+        char buf[25] = {0};
+        ep->GetAddrString(buf, sizeof(buf));
+        if (std::strcmp(buf, "10.0.0.1")) {
+            return this->Fail("address should be 10.0.0.1");
+        }
+        if (this->server_->GetQueryCount() != count + 1) {
+            return this->Fail("should send one query");
+        }
+        results.clear();
+        resolver.ResolveName("HOST.test.", sharpen::AddressFamily::Ip, std::back_inserter(results));
+        if (results.size() != 1) {
+            return this->Fail("should resolve one address from cache");
+        }
+        return this->Assert(this->server_->GetQueryCount() == count + 1,
+                            "cache hit should not send queries");
+    }
+};
+
+class ResolverNegativeCacheTest : public simpletest::ITypenamedTest<ResolverNegativeCacheTest> {
+private:
+    using Self = ResolverNegativeCacheTest;
+
+    StubDnsServer *server_;
+
+    static sharpen::ErrorCode Resolve(sharpen::DnsResolver &resolver, const char *name) {
+        std::vector<sharpen::DnsResolveResult> results;
+        try {
+            resolver.ResolveName(name, sharpen::AddressFamily::Ip, std::back_inserter(results));
+        } catch (const std::system_error &error) {
+            return error.code().value();
+        }
+        return 0;
+    }
+
+public:
+    explicit ResolverNegativeCacheTest(StubDnsServer *server) noexcept
+        : server_(server) {
+    }
+
+    ~ResolverNegativeCacheTest() noexcept = default;
+
+    inline const Self &Const() const noexcept {
+        return *this;
+    }
+
+    inline virtual simpletest::TestResult Run() noexcept {
+        sharpen::DnsResolver resolver{sharpen::GetLocalLoopGroup(), this->server_->GetEndPoint()};
+        std::size_t count{this->server_->GetQueryCount()};
+        if (Self::Resolve(resolver, "missing.test") != sharpen::ErrorNetDbHostNotFound) {
+            return this->Fail("missing.test should not be found");
+        }
+        if (Self::Resolve(resolver, "missing.test") != sharpen::ErrorNetDbHostNotFound) {
+            return this->Fail("missing.test should not be found from cache");
+        }
+        if (this->server_->GetQueryCount() != count + 1) {
+            return this->Fail("negative cache hit should not send queries");
+        }
+        if (Self::Resolve(resolver, "host.test") != 0) {
+            return this->Fail("host.test should be resolved");
+        }
+        std::vector<sharpen::DnsResolveResult> results;
+        resolver.ResolveName("host.test", std::back_inserter(results));
+        if (results.size() != 1 || this->server_->GetQueryCount() != count + 3) {
+            return this->Fail("should only query the missing AAAA record");
+        }
+        resolver.SetTimeout(std::chrono::milliseconds{100});
+        resolver.SetRetryCount(1);
+        count = this->server_->GetQueryCount();
+        if (Self::Resolve(resolver, "drop.test") != sharpen::ErrorNetDbTryAgain) {
+            return this->Fail("drop.test should time out");
+        }
+        if (this->server_->GetQueryCount() != count + 2) {
+            return this->Fail("should retry once");
+        }
+        results.clear();
+        resolver.ResolveName("127.0.0.1", std::back_inserter(results));
+        return this->Assert(results.size() == 1 && this->server_->GetQueryCount() == count + 2,
+                            "address literals should not be resolved");
+    }
+};
+
 static int Test() {
     sharpen::StartupNetSupport();
     simpletest::TestRunner runner;
+    StubDnsServer server;
     runner.Register<LookupLocalhostTest>();
+    runner.Register<ResolverCacheTest>(&server);
+    runner.Register<ResolverNegativeCacheTest>(&server);
     int code{runner.Run()};
     sharpen::CleanupNetSupport();
     return code;
@@ -0,0 +1,181 @@
+#include <sharpen/AsyncOps.hpp>
+#include <sharpen/EventEngine.hpp>
+#include <sharpen/IHostPipelineStep.hpp>
+#include <sharpen/INetStreamChannel.hpp>
+#include <sharpen/IpEndPoint.hpp>
+#include <sharpen/IpTcpStreamFactory.hpp>
+#include <sharpen/SimpleHostPipeline.hpp>
+#include <sharpen/TcpHost.hpp>
+#include <simpletest/TestRunner.hpp>
+#include <atomic>
+#include <cstring>
+#include <mutex>
+#include <set>
+#include <vector>
+
+static const std::uint16_t hostPort{10828};
+
+static constexpr std::size_t loopCount{4};
+
+static constexpr std::size_t clientCount{32};
+
+static const char data[] = "hello world";
+
+// the loops which serve the accepted channels
+class LoopRecorder {
+private:
+    using Self = LoopRecorder;
+
+    std::mutex lock_;
+    std::set<const sharpen::EventLoop *> loops_;
+
+public:
+    LoopRecorder() = default;
+
+    ~LoopRecorder() noexcept = default;
+
+    inline void Record(const sharpen::EventLoop *loop) {
+        std::unique_lock<std::mutex> lock{this->lock_};
+        this->loops_.emplace(loop);
+    }
+
+    inline std::size_t GetCount() {
+        std::unique_lock<std::mutex> lock{this->lock_};
+        return this->loops_.size();
+    }
+};
+
+// writes every read back to the client
+class EchoStep : public sharpen::IHostPipelineStep {
+private:
+    using Self = EchoStep;
+
+    LoopRecorder *recorder_;
+
+public:
+    explicit EchoStep(LoopRecorder *recorder) noexcept
+        : recorder_(recorder) {
+    }
+
+    virtual ~EchoStep() noexcept = default;
+
+    virtual sharpen::HostPipelineResult Consume(sharpen::INetStreamChannel &channel,
+                                                const std::atomic_bool &active) noexcept override {
+        (void)active;
+        try {
+            this->recorder_->Record(channel.GetLoop());
+            char buf[sizeof(data)];
+            std::size_t size{channel.ReadAsync(buf, sizeof(buf))};
+            while (size != 0) {
+                channel.WriteAsync(buf, size);
+                size = channel.ReadAsync(buf, sizeof(buf));
+            }
+        } catch (const std::exception &ignore) {
+            (void)ignore;
+        }
+        return sharpen::HostPipelineResult::Broken;
+    }
+};
+
+static std::unique_ptr<sharpen::IHostPipeline> ConfigEchoPipeline(LoopRecorder *recorder) {
+    std::unique_ptr<sharpen::IHostPipeline> pipe{new (std::nothrow) sharpen::SimpleHostPipeline{}};
+    if (!pipe) {
+        throw std::bad_alloc{};
+    }
+    pipe->Register<EchoStep>(recorder);
+    return pipe;
+}
+
+static sharpen::IpEndPoint GetHostEndPoint() {
+    sharpen::IpEndPoint ep{0, 0};
+    ep.SetAddrByString("127.0.0.1");
+    ep.SetPort(hostPort);
+    return ep;
+}
+
+static void Echo(std::atomic_size_t *echoed) {
+    try {
+        sharpen::NetStreamChannelPtr client{sharpen::OpenTcpChannel(sharpen::AddressFamily::Ip)};
+        sharpen::IpEndPoint ep{0, 0};
+        ep.SetAddrByString("127.0.0.1");
+        client->Bind(ep);
+        client->Register(sharpen::GetLocalLoopGroup());
+        client->ConnectAsync(GetHostEndPoint());
+        client->WriteAsync(data, sizeof(data) - 1);
+        char buf[sizeof(data)] = {0};
+        std::size_t size{0};
+        while (size != sizeof(data) - 1) {
+            std::size_t sz{client->ReadAsync(buf + size, sizeof(data) - 1 - size)};
+            if (!sz) {
+                break;
+            }
+            size += sz;
+        }
+        client->Close();
+        if (!std::strcmp(buf, data)) {
+            echoed->fetch_add(1);
+        }
+    } catch (const std::exception &ignore) {
+        (void)ignore;
+    }
+}
+
+class ReusePortHostTest : public simpletest::ITypenamedTest<ReusePortHostTest> {
+private:
+    using Self = ReusePortHostTest;
+
+public:
+    ReusePortHostTest() noexcept = default;
+
+    ~ReusePortHostTest() noexcept = default;
+
+    inline const Self &Const() const noexcept {
+        return *this;
+    }
+
+    inline virtual simpletest::TestResult Run() noexcept {
+        sharpen::IpTcpStreamFactory factory{GetHostEndPoint()};
+        sharpen::TcpStreamOption opt;
+        opt.EnableReuseAddressInNix();
+        opt.EnableReusePort();
+        LoopRecorder recorder;
+        sharpen::TcpHost host{factory, opt};
+        host.ConfiguratePipeline(&ConfigEchoPipeline, &recorder);
+        std::size_t acceptors{host.GetAcceptorCount()};
+        auto hosting{sharpen::Async([&host]() { host.Run(); })};
+        std::atomic_size_t echoed{0};
+        std::vector<sharpen::AwaitableFuturePtr<void>> clients;
+        clients.reserve(clientCount);
+        for (std::size_t i = 0; i != clientCount; ++i) {
+            clients.emplace_back(sharpen::Async(&Echo, &echoed));
+        }
+        for (auto begin = clients.begin(), end = clients.end(); begin != end; ++begin) {
+            (*begin)->Await();
+        }
+        host.Stop();
+        hosting->Await();
+        if (acceptors != loopCount) {
+            return this->Fail("host should have one acceptor per loop");
+        }
+        if (echoed != clientCount) {
+            return this->Fail("every client should be echoed");
+        }
+        // the kernel balances connections between acceptors
+        return this->Assert(recorder.GetCount() > 1,
+                            "channels should be served by the loops of their acceptors");
+    }
+};
+
+static int Test() {
+    sharpen::StartupNetSupport();
+    simpletest::TestRunner runner;
+    runner.Register<ReusePortHostTest>();
+    int code{runner.Run()};
+    sharpen::CleanupNetSupport();
+    return code;
+}
+
+int main() {
+    sharpen::EventEngine &engine{sharpen::EventEngine::SetupEngine(loopCount)};
+    return engine.StartupWithCode(&Test);
+}
\ No newline at end of file
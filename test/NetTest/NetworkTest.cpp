@@ -1,6 +1,7 @@
 #include <sharpen/AsyncOps.hpp>
 #include <sharpen/DebugTools.hpp>
 #include <sharpen/EventEngine.hpp>
+#include <sharpen/FileOps.hpp>
 #include <sharpen/INetStreamChannel.hpp>
 #include <sharpen/IpEndPoint.hpp>
 #include <sharpen/IpTcpStreamFactory.hpp>
@@ -11,11 +12,17 @@
 #include <simpletest/TestRunner.hpp>
 #include <cassert>
 #include <cstdio>
+#include <cstring>
+#include <vector>
 
 
 static const char data[] = "hello world\n";
 
-static const std::uint16_t testPort{10808};
+// the completion run uses its own port and file
+// so that both runs could be executed concurrently
+static std::uint16_t testPort{10808};
+
+static const char *sendFileName{"./sendfile.log"};
 
 class PingpoingTest : public simpletest::ITypenamedTest<PingpoingTest> {
 private:
@@ -59,6 +66,194 @@ public:
     }
 };
 
+class WriteVectorTest : public simpletest::ITypenamedTest<WriteVectorTest> {
+private:
+    using Self = WriteVectorTest;
+
+public:
+    WriteVectorTest() noexcept = default;
+
+    ~WriteVectorTest() noexcept = default;
+
+    inline const Self &Const() const noexcept {
+        return *this;
+    }
+
+    inline virtual simpletest::TestResult Run() noexcept {
+        sharpen::NetStreamChannelPtr server = sharpen::OpenTcpChannel(sharpen::AddressFamily::Ip);
+        sharpen::IpEndPoint serverEndpoint;
+        serverEndpoint.SetAddrByString("127.0.0.1");
+        serverEndpoint.SetPort(testPort);
+        server->ReuseAddressInNix();
+        server->Bind(serverEndpoint);
+        server->Register(sharpen::GetLocalLoopGroup());
+        server->Listen(65535);
+        sharpen::NetStreamChannelPtr client = sharpen::OpenTcpChannel(sharpen::AddressFamily::Ip);
+        sharpen::IpEndPoint clientEndpoint;
+        clientEndpoint.SetAddrByString("127.0.0.1");
+        clientEndpoint.SetPort(0);
+        client->Bind(clientEndpoint);
+        client->Register(sharpen::GetLocalLoopGroup());
+        auto future = sharpen::Async([&serverEndpoint, client]() mutable {
+            client->ConnectAsync(serverEndpoint);
+            // "hello " | "world\n"
+            sharpen::ByteSlice slices[2]{sharpen::ByteSlice{data, 6},
+                                         sharpen::ByteSlice{data + 6, sizeof(data) - 7}};
+            return client->WriteVectorFixedAsync(slices, 2);
+        });
+        char buf[sizeof(data)] = {0};
+        client = server->AcceptAsync();
+        client->Register(sharpen::GetLocalLoopGroup());
+        std::size_t size{0};
+        while (size != sizeof(data) - 1) {
+            std::size_t sz{client->ReadAsync(buf + size, sizeof(data) - 1 - size)};
+            if (!sz) {
+                break;
+            }
+            size += sz;
+        }
+        if (future->Await() != sizeof(data) - 1) {
+            return this->Fail("size should == sizeof(data) - 1,but it not");
+        }
+        return this->Assert(!std::strncmp(buf, data, sizeof(data) - 1),
+                            "buf should == data,but it not");
+    }
+};
+
+class SendFileTest : public simpletest::ITypenamedTest<SendFileTest> {
+private:
+    using Self = SendFileTest;
+
+public:
+    SendFileTest() noexcept = default;
+
+    ~SendFileTest() noexcept = default;
+
+    inline const Self &Const() const noexcept {
+        return *this;
+    }
+
+    inline virtual simpletest::TestResult Run() noexcept {
+        // larger than the buffer of socket
+        std::vector<char> content(4 * 1024 * 1024);
+        for (std::size_t i = 0; i != content.size(); ++i) {
+            content[i] = static_cast<char>(i % 251);
+        }
+        sharpen::FileChannelPtr file = sharpen::OpenFileChannel(
+            sendFileName, sharpen::FileAccessMethod::All, sharpen::FileOpenMethod::CreateNew);
+        file->Register(sharpen::GetLocalLoopGroup());
+        file->WriteAsync(content.data(), content.size(), 0);
+        const std::size_t offset{1};
+        sharpen::NetStreamChannelPtr server = sharpen::OpenTcpChannel(sharpen::AddressFamily::Ip);
+        sharpen::IpEndPoint serverEndpoint;
+        serverEndpoint.SetAddrByString("127.0.0.1");
+        serverEndpoint.SetPort(testPort);
+        server->ReuseAddressInNix();
+        server->Bind(serverEndpoint);
+        server->Register(sharpen::GetLocalLoopGroup());
+        server->Listen(65535);
+        sharpen::NetStreamChannelPtr client = sharpen::OpenTcpChannel(sharpen::AddressFamily::Ip);
+        sharpen::IpEndPoint clientEndpoint;
+        clientEndpoint.SetAddrByString("127.0.0.1");
+        clientEndpoint.SetPort(0);
+        client->Bind(clientEndpoint);
+        client->Register(sharpen::GetLocalLoopGroup());
+        auto future = sharpen::Async([&serverEndpoint, client, file, offset]() mutable {
+            client->ConnectAsync(serverEndpoint);
+            // writes must keep their order with sendfile
+            sharpen::AwaitableFuture<std::size_t> futures[3];
+            client->WriteAsync(data, 6, futures[0]);
+            client->SendFileAsync(file, file->GetFileSize() - offset, offset, futures[1]);
+            client->WriteAsync(data + 6, sizeof(data) - 7, futures[2]);
+            std::size_t size{0};
+            for (std::size_t i = 0; i != 3; ++i) {
+                size += futures[i].Await();
+            }
+            return size;
+        });
+        std::vector<char> expected;
+        expected.insert(expected.end(), data, data + 6);
+        expected.insert(expected.end(), content.begin() + offset, content.end());
+        expected.insert(expected.end(), data + 6, data + sizeof(data) - 1);
+        std::vector<char> buf(expected.size());
+        sharpen::NetStreamChannelPtr conn = server->AcceptAsync();
+        conn->Register(sharpen::GetLocalLoopGroup());
+        std::size_t size{0};
+        while (size != buf.size()) {
+            std::size_t sz{conn->ReadAsync(buf.data() + size, buf.size() - size)};
+            if (!sz) {
+                break;
+            }
+            size += sz;
+        }
+        std::size_t sent{future->Await()};
+        file->Close();
+        sharpen::RemoveFile(sendFileName);
+        if (sent != expected.size()) {
+            return this->Fail("sent should == expected.size(),but it not");
+        }
+        return this->Assert(buf == expected, "buf should == expected,but it not");
+    }
+};
+
+class HandleReuseTest : public simpletest::ITypenamedTest<HandleReuseTest> {
+private:
+    using Self = HandleReuseTest;
+
+public:
+    HandleReuseTest() noexcept = default;
+
+    ~HandleReuseTest() noexcept = default;
+
+    inline const Self &Const() const noexcept {
+        return *this;
+    }
+
+    inline virtual simpletest::TestResult Run() noexcept {
+        sharpen::NetStreamChannelPtr server = sharpen::OpenTcpChannel(sharpen::AddressFamily::Ip);
+        sharpen::IpEndPoint serverEndpoint;
+        serverEndpoint.SetAddrByString("127.0.0.1");
+        serverEndpoint.SetPort(testPort);
+        server->ReuseAddressInNix();
+        server->Bind(serverEndpoint);
+        server->Register(sharpen::GetLocalLoopGroup());
+        server->Listen(65535);
+        sharpen::FileHandle handle{-1};
+        // the same handle is registered again by a new channel
+        for (std::size_t i = 0; i != 4; ++i) {
+            sharpen::NetStreamChannelPtr client =
+                sharpen::OpenTcpChannel(sharpen::AddressFamily::Ip);
+            if (handle != -1 && client->GetHandle() != handle) {
+                return this->Fail("handle should be reused");
+            }
+            handle = client->GetHandle();
+            client->Register(sharpen::GetLocalLoopGroup());
+            auto future = sharpen::Async([&serverEndpoint, client]() mutable {
+                client->ConnectAsync(serverEndpoint);
+                client->WriteAsync(data, sizeof(data) - 1);
+            });
+            char buf[sizeof(data)] = {0};
+            sharpen::NetStreamChannelPtr conn = server->AcceptAsync();
+            conn->Register(sharpen::GetLocalLoopGroup());
+            std::size_t size{0};
+            while (size != sizeof(data) - 1) {
+                std::size_t sz{conn->ReadAsync(buf + size, sizeof(data) - 1 - size)};
+                if (!sz) {
+                    break;
+                }
+                size += sz;
+            }
+            future->Await();
+            if (std::strncmp(buf, data, sizeof(data) - 1)) {
+                return this->Fail("buf should == data,but it not");
+            }
+            conn->Close();
+            client->Close();
+        }
+        return this->Success();
+    }
+};
+
 class CancelTest : public simpletest::ITypenamedTest<CancelTest> {
 private:
     using Self = CancelTest;
@@ -229,20 +424,187 @@ public:
     }
 };
 
+class BacklogTest : public simpletest::ITypenamedTest<BacklogTest> {
+private:
+    using Self = BacklogTest;
+
+    static constexpr std::size_t clientCount_{32};
+
+public:
+    BacklogTest() noexcept = default;
+
+    ~BacklogTest() noexcept = default;
+
+    inline const Self &Const() const noexcept {
+        return *this;
+    }
+
+    inline virtual simpletest::TestResult Run() noexcept {
+        sharpen::NetStreamChannelPtr server = sharpen::OpenTcpChannel(sharpen::AddressFamily::Ip);
+        sharpen::IpEndPoint ep{0, 0};
+        ep.SetAddrByString("127.0.0.1");
+        ep.SetPort(testPort);
+        server->ReuseAddressInNix();
+        server->Bind(ep);
+        server->Register(sharpen::GetLocalLoopGroup());
+        server->Listen(65535);
+        // connections wait in the backlog
+        std::vector<sharpen::NetStreamChannelPtr> clients;
+        for (std::size_t i = 0; i != clientCount_; ++i) {
+            sharpen::NetStreamChannelPtr client =
+                sharpen::OpenTcpChannel(sharpen::AddressFamily::Ip);
+            sharpen::IpEndPoint clientEp{0, 0};
+            clientEp.SetAddrByString("127.0.0.1");
+            client->Bind(clientEp);
+            client->Register(sharpen::GetLocalLoopGroup());
+            client->ConnectAsync(ep);
+            client->WriteAsync(data, sizeof(data) - 1);
+            clients.emplace_back(std::move(client));
+        }
+        for (std::size_t i = 0; i != clientCount_; ++i) {
+            sharpen::NetStreamChannelPtr conn{server->AcceptAsync()};
+            conn->Register(sharpen::GetLocalLoopGroup());
+            char buf[sizeof(data)] = {0};
+            std::size_t size{0};
+            while (size != sizeof(data) - 1) {
+                std::size_t sz{conn->ReadAsync(buf + size, sizeof(data) - 1 - size)};
+                if (!sz) {
+                    break;
+                }
+                size += sz;
+            }
+            if (std::strncmp(buf, data, sizeof(data) - 1)) {
+                return this->Fail("buf should == data,but it not");
+            }
+        }
+        return this->Success();
+    }
+};
+
+class BufferedReadTest : public simpletest::ITypenamedTest<BufferedReadTest> {
+private:
+    using Self = BufferedReadTest;
+
+public:
+    BufferedReadTest() noexcept = default;
+
+    ~BufferedReadTest() noexcept = default;
+
+    inline const Self &Const() const noexcept {
+        return *this;
+    }
+
+    inline virtual simpletest::TestResult Run() noexcept {
+        sharpen::NetStreamChannelPtr server = sharpen::OpenTcpChannel(sharpen::AddressFamily::Ip);
+        sharpen::NetStreamChannelPtr client = sharpen::OpenTcpChannel(sharpen::AddressFamily::Ip);
+        sharpen::IpEndPoint ep{0, 0};
+        ep.SetAddrByString("127.0.0.1");
+        client->Bind(ep);
+        ep.SetPort(testPort);
+        server->ReuseAddressInNix();
+        server->Bind(ep);
+        server->Register(sharpen::GetLocalLoopGroup());
+        client->Register(sharpen::GetLocalLoopGroup());
+        server->Listen(65535);
+        client->ConnectAsync(ep);
+        sharpen::NetStreamChannelPtr conn{server->AcceptAsync()};
+        conn->Register(sharpen::GetLocalLoopGroup());
+        // more than the data a reader could buffer
+        std::vector<char> content(256 * 1024);
+        for (std::size_t i = 0; i != content.size(); ++i) {
+            content[i] = static_cast<char>(i % 251);
+        }
+        client->WriteAsync(content.data(), content.size());
+        std::vector<char> buf(content.size());
+        std::size_t size{conn->ReadAsync(buf.data(), 1)};
+        // data arrives before the next read
+        sharpen::Delay(std::chrono::milliseconds{100});
+        while (size != buf.size()) {
+            std::size_t sz{conn->ReadAsync(buf.data() + size, buf.size() - size)};
+            if (!sz) {
+                break;
+            }
+            size += sz;
+        }
+        return this->Assert(buf == content, "buf should == content,but it not");
+    }
+};
+
+class ReusePortTest : public simpletest::ITypenamedTest<ReusePortTest> {
+private:
+    using Self = ReusePortTest;
+
+public:
+    ReusePortTest() noexcept = default;
+
+    ~ReusePortTest() noexcept = default;
+
+    inline const Self &Const() const noexcept {
+        return *this;
+    }
+
+    inline virtual simpletest::TestResult Run() noexcept {
+        sharpen::IpEndPoint ep{0, 0};
+        ep.SetAddrByString("127.0.0.1");
+        ep.SetPort(testPort);
+        sharpen::IpTcpStreamFactory factory{ep};
+        sharpen::TcpStreamOption opt;
+        opt.EnableReuseAddressInNix();
+        opt.EnableReusePort();
+        sharpen::EventLoop &loop{sharpen::GetLocalLoopGroup().GetLoop(0)};
+        // two listeners on the same port
+        sharpen::NetStreamChannelPtr first{factory.Produce(opt, loop)};
+        first->Listen(65535);
+        sharpen::NetStreamChannelPtr second{factory.Produce(opt, loop)};
+        second->Listen(65535);
+        if (first->GetLoop() != &loop || second->GetLoop() != &loop) {
+            return this->Fail("listeners should be registered to the loop");
+        }
+        // new connections go to the rest listener
+        first->Close();
+        sharpen::NetStreamChannelPtr client = sharpen::OpenTcpChannel(sharpen::AddressFamily::Ip);
+        sharpen::IpEndPoint clientEp{0, 0};
+        clientEp.SetAddrByString("127.0.0.1");
+        client->Bind(clientEp);
+        client->Register(sharpen::GetLocalLoopGroup());
+        client->ConnectAsync(ep);
+        client->WriteAsync(data, sizeof(data) - 1);
+        sharpen::NetStreamChannelPtr conn{second->AcceptAsync()};
+        conn->Register(*second->GetLoop());
+        char buf[sizeof(data)] = {0};
+        conn->ReadAsync(buf, sizeof(buf));
+        return this->Assert(!std::strncmp(buf, data, sizeof(data) - 1),
+                            "buf should == data,but it not");
+    }
+};
+
 static int Test() {
     sharpen::StartupNetSupport();
     simpletest::TestRunner runner;
     runner.Register<PingpoingTest>();
+    runner.Register<WriteVectorTest>();
+    runner.Register<SendFileTest>();
+    runner.Register<HandleReuseTest>();
     runner.Register<CancelTest>();
     runner.Register<TimeoutTest>();
     runner.Register<CloseTest>();
     runner.Register<HalfAcceptTest>();
+    runner.Register<BacklogTest>();
+    runner.Register<BufferedReadTest>();
+    runner.Register<ReusePortTest>();
     int code{runner.Run()};
     sharpen::CleanupNetSupport();
     return code;
 }
 
-int main() {
-    sharpen::EventEngine &engine = sharpen::EventEngine::SetupSingleThreadEngine();
+int main(int argc, char const *argv[]) {
+    sharpen::NetIoMethod method{sharpen::NetIoMethod::Readiness};
+    // run the same tests with io_uring sockets
+    if (argc > 1 && !std::strcmp(argv[1], "completion")) {
+        method = sharpen::NetIoMethod::Completion;
+        testPort = 10818;
+        sendFileName = "./sendfile_completion.log";
+    }
+    sharpen::EventEngine &engine = sharpen::EventEngine::SetupSingleThreadEngine(method);
     return engine.StartupWithCode(&Test);
 }
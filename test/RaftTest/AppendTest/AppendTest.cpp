@@ -44,6 +44,13 @@ static constexpr std::size_t batchSize{20};
 
 static constexpr std::size_t pipelineLength{2};
 
+// longer than the append rounds, the leader never skips a follower
+static constexpr std::size_t replicationPipelineLength{appendTestCount + 2};
+
+static constexpr std::size_t readTestCount{60};
+
+static constexpr std::size_t readLease{100};
+
 static constexpr std::size_t benchmarkCount{1 * 1000};
 
 static constexpr std::size_t benchmarkTime{10};
@@ -75,6 +82,19 @@ static std::shared_ptr<sharpen::IConsensus> CreatePipelineRaft(std::uint16_t por
     return raft;
 }
 
+static std::shared_ptr<sharpen::IConsensus> CreatePipelinedReplicationRaft(std::uint16_t port) {
+    sharpen::RaftOption raftOpt;
+    raftOpt.SetBatchSize(batchSize);
+    raftOpt.SetLearner(false);
+    raftOpt.SetPrevote(false);
+    raftOpt.SetPipelineLength(replicationPipelineLength);
+    raftOpt.EnablePipelinedReplication();
+    auto raft{CreateRaft(port, magicNumber, nullptr, nullptr, raftOpt, true)};
+    raft->ConfiguratePeers(
+        &ConfigPeers, port, beginPort, endPort, &raft->GetReceiver(), magicNumber, true);
+    return raft;
+}
+
 static std::shared_ptr<sharpen::IConsensus> CreateLeaseRaft(std::uint16_t port) {
     sharpen::RaftOption raftOpt;
     raftOpt.SetBatchSize(batchSize);
@@ -100,6 +120,18 @@ static std::shared_ptr<sharpen::IConsensus> CreateLeasePipelineRaft(std::uint16_
     return raft;
 }
 
+static std::shared_ptr<sharpen::IConsensus> CreateReadLeaseRaft(std::uint16_t port) {
+    sharpen::RaftOption raftOpt;
+    raftOpt.SetBatchSize(batchSize);
+    raftOpt.SetLearner(false);
+    raftOpt.SetPrevote(false);
+    raftOpt.SetReadLease(std::chrono::milliseconds{readLease});
+    auto raft{CreateRaft(port, magicNumber, nullptr, nullptr, raftOpt, false)};
+    raft->ConfiguratePeers(
+        &ConfigPeers, port, beginPort, endPort, &raft->GetReceiver(), magicNumber, false);
+    return raft;
+}
+
 static std::unique_ptr<sharpen::IHostPipeline> ConfigPipeline(
     std::shared_ptr<sharpen::IConsensus> raft) {
     std::unique_ptr<sharpen::IHostPipeline> pipe{new (std::nothrow) sharpen::SimpleHostPipeline{}};
@@ -603,6 +635,86 @@ public:
     }
 };
 
+class PipelinedReplicationAppendTest
+    : public simpletest::ITypenamedTest<PipelinedReplicationAppendTest> {
+private:
+    using Self = PipelinedReplicationAppendTest;
+
+public:
+    PipelinedReplicationAppendTest() noexcept = default;
+
+    ~PipelinedReplicationAppendTest() noexcept = default;
+
+    inline const Self &Const() const noexcept {
+        return *this;
+    }
+
+    inline virtual simpletest::TestResult Run() noexcept {
+        PrintDebugInfo();
+        std::vector<std::shared_ptr<sharpen::IConsensus>> rafts;
+        rafts.reserve(3);
+        std::vector<std::unique_ptr<sharpen::IHost>> hosts;
+        hosts.reserve(3);
+        std::vector<sharpen::AwaitableFuturePtr<void>> process;
+        process.reserve(3);
+        for (std::uint16_t i = beginPort; i != endPort + 1; ++i) {
+            auto raft{CreatePipelinedReplicationRaft(i)};
+            rafts.emplace_back(raft);
+            auto host{CreateHost(i, raft)};
+            hosts.emplace_back(std::move(host));
+        }
+        for (auto begin = hosts.begin(), end = hosts.end(); begin != end; ++begin) {
+            sharpen::IHost *host{begin->get()};
+            auto future{sharpen::Async([host]() { host->Run(); })};
+            process.emplace_back(std::move(future));
+        }
+        auto primary{rafts[0].get()};
+        primary->Advance();
+        primary->WaitNextConsensus();
+        bool writable{primary->Writable()};
+        std::size_t count{0};
+        for (std::size_t i = 0; i != appendTestCount && writable; ++i) {
+            sharpen::SyncPrintf("AppendEntires %zu\n", i);
+            sharpen::LogBatch batch;
+            sharpen::ByteBuffer log;
+            log.Printf("Index:%zu", i);
+            batch.Append(std::move(log));
+            primary->Write(batch);
+            primary->Advance();
+            // the pipeline never fills up, so every backup receives the batch
+            // and notifies a consensus after writing it
+            std::uint64_t lastIndex{primary->ImmutableLogs().GetLastIndex()};
+            for (auto begin = rafts.begin() + 1, end = rafts.end(); begin != end; ++begin) {
+                auto backup{begin->get()};
+                while (backup->ImmutableLogs().GetLastIndex() < lastIndex) {
+                    backup->WaitNextConsensus();
+                }
+            }
+            count += 1;
+            writable = primary->Writable();
+        }
+        // close all hosts
+        for (auto begin = rafts.begin(), end = rafts.end(); begin != end; ++begin) {
+            auto raft{begin->get()};
+            raft->ReleasePeers();
+        }
+        for (auto begin = hosts.begin(), end = hosts.end(); begin != end; ++begin) {
+            auto host{begin->get()};
+            host->Stop();
+        }
+        for (auto begin = process.begin(), end = process.end(); begin != end; ++begin) {
+            auto future{begin->get()};
+            future->WaitAsync();
+        }
+        // remove files
+        for (std::uint16_t i = beginPort; i != endPort + 1; ++i) {
+            RemoveLogStorage(i);
+            RemoveStatusMap(i);
+        }
+        return this->Assert(count == appendTestCount, "count should equal with appendTestCount");
+    }
+};
+
 class FaultPipelineAppendTest : public simpletest::ITypenamedTest<FaultPipelineAppendTest> {
 private:
     using Self = FaultPipelineAppendTest;
@@ -908,6 +1020,179 @@ public:
     }
 };
 
+class ReadIndexTest : public simpletest::ITypenamedTest<ReadIndexTest> {
+private:
+    using Self = ReadIndexTest;
+
+public:
+    ReadIndexTest() noexcept = default;
+
+    ~ReadIndexTest() noexcept = default;
+
+    inline const Self &Const() const noexcept {
+        return *this;
+    }
+
+    inline virtual simpletest::TestResult Run() noexcept {
+        PrintDebugInfo();
+        std::vector<std::shared_ptr<sharpen::IConsensus>> rafts;
+        rafts.reserve(3);
+        std::vector<std::unique_ptr<sharpen::IHost>> hosts;
+        hosts.reserve(3);
+        std::vector<sharpen::AwaitableFuturePtr<void>> process;
+        process.reserve(3);
+        for (std::uint16_t i = beginPort; i != endPort + 1; ++i) {
+            auto raft{CreateRaft(i)};
+            rafts.emplace_back(raft);
+            auto host{CreateHost(i, raft)};
+            hosts.emplace_back(std::move(host));
+        }
+        for (auto begin = hosts.begin(), end = hosts.end(); begin != end; ++begin) {
+            sharpen::IHost *host{begin->get()};
+            auto future{sharpen::Async([host]() { host->Run(); })};
+            process.emplace_back(std::move(future));
+        }
+        auto primary{rafts[0].get()};
+        primary->Advance();
+        primary->WaitNextConsensus();
+        bool writable{primary->Writable()};
+        // commit an entry of current term
+        std::uint64_t lastIndex{0};
+        if (writable) {
+            sharpen::LogBatch batch;
+            sharpen::ByteBuffer log;
+            log.Printf("Index:%zu", static_cast<std::size_t>(0));
+            batch.Append(std::move(log));
+            lastIndex = primary->Write(batch).GetLastIndex();
+        }
+        for (std::size_t i = 0; i != appendTestCount && primary->GetCommitIndex() < lastIndex;
+             ++i) {
+            primary->Advance();
+            primary->WaitNextConsensus();
+        }
+        primary->StoreLastAppliedIndex(primary->GetCommitIndex());
+        // concurrent reads share confirmation rounds
+        std::vector<sharpen::AwaitableFuturePtr<sharpen::Optional<std::uint64_t>>> reads;
+        reads.reserve(readTestCount);
+        for (std::size_t i = 0; i != readTestCount && writable; ++i) {
+            reads.emplace_back(sharpen::Async([primary]() { return primary->ReadIndex(); }));
+        }
+        std::size_t count{0};
+        for (auto begin = reads.begin(), end = reads.end(); begin != end; ++begin) {
+            sharpen::Optional<std::uint64_t> index{begin->get()->Await()};
+            if (index.Exist() && index.Get() == lastIndex &&
+                index.Get() <= primary->GetLastAppliedIndex()) {
+                count += 1;
+            }
+        }
+        bool followerRead{rafts[1]->ReadIndex().Exist()};
+        // close all hosts
+        for (auto begin = rafts.begin(), end = rafts.end(); begin != end; ++begin) {
+            auto raft{begin->get()};
+            raft->ReleasePeers();
+        }
+        for (auto begin = hosts.begin(), end = hosts.end(); begin != end; ++begin) {
+            auto host{begin->get()};
+            host->Stop();
+        }
+        for (auto begin = process.begin(), end = process.end(); begin != end; ++begin) {
+            auto future{begin->get()};
+            future->WaitAsync();
+        }
+        // remove files
+        for (std::uint16_t i = beginPort; i != endPort + 1; ++i) {
+            RemoveLogStorage(i);
+            RemoveStatusMap(i);
+        }
+        if (followerRead) {
+            return this->Fail("follower should not serve reads");
+        }
+        return this->Assert(count == readTestCount, "count should equal with readTestCount");
+    }
+};
+
+class LeaseReadTest : public simpletest::ITypenamedTest<LeaseReadTest> {
+private:
+    using Self = LeaseReadTest;
+
+public:
+    LeaseReadTest() noexcept = default;
+
+    ~LeaseReadTest() noexcept = default;
+
+    inline const Self &Const() const noexcept {
+        return *this;
+    }
+
+    inline virtual simpletest::TestResult Run() noexcept {
+        PrintDebugInfo();
+        std::vector<std::shared_ptr<sharpen::IConsensus>> rafts;
+        rafts.reserve(3);
+        std::vector<std::unique_ptr<sharpen::IHost>> hosts;
+        hosts.reserve(3);
+        std::vector<sharpen::AwaitableFuturePtr<void>> process;
+        process.reserve(3);
+        for (std::uint16_t i = beginPort; i != endPort + 1; ++i) {
+            auto raft{CreateReadLeaseRaft(i)};
+            rafts.emplace_back(raft);
+            auto host{CreateHost(i, raft)};
+            hosts.emplace_back(std::move(host));
+        }
+        for (auto begin = hosts.begin(), end = hosts.end(); begin != end; ++begin) {
+            sharpen::IHost *host{begin->get()};
+            auto future{sharpen::Async([host]() { host->Run(); })};
+            process.emplace_back(std::move(future));
+        }
+        auto primary{rafts[0].get()};
+        primary->Advance();
+        primary->WaitNextConsensus();
+        bool writable{primary->Writable()};
+        // commit an entry of current term
+        std::uint64_t lastIndex{0};
+        if (writable) {
+            sharpen::LogBatch batch;
+            sharpen::ByteBuffer log;
+            log.Printf("Index:%zu", static_cast<std::size_t>(0));
+            batch.Append(std::move(log));
+            lastIndex = primary->Write(batch).GetLastIndex();
+        }
+        for (std::size_t i = 0; i != appendTestCount && primary->GetCommitIndex() < lastIndex;
+             ++i) {
+            primary->Advance();
+            primary->WaitNextConsensus();
+        }
+        primary->StoreLastAppliedIndex(primary->GetCommitIndex());
+        std::size_t count{0};
+        for (std::size_t i = 0; i != readTestCount && writable; ++i) {
+            sharpen::SyncPrintf("ReadIndex %zu\n", i);
+            sharpen::Optional<std::uint64_t> index{primary->ReadIndex()};
+            if (!index.Exist() || index.Get() != lastIndex) {
+                break;
+            }
+            count += 1;
+        }
+        // close all hosts
+        for (auto begin = rafts.begin(), end = rafts.end(); begin != end; ++begin) {
+            auto raft{begin->get()};
+            raft->ReleasePeers();
+        }
+        for (auto begin = hosts.begin(), end = hosts.end(); begin != end; ++begin) {
+            auto host{begin->get()};
+            host->Stop();
+        }
+        for (auto begin = process.begin(), end = process.end(); begin != end; ++begin) {
+            auto future{begin->get()};
+            future->WaitAsync();
+        }
+        // remove files
+        for (std::uint16_t i = beginPort; i != endPort + 1; ++i) {
+            RemoveLogStorage(i);
+            RemoveStatusMap(i);
+        }
+        return this->Assert(count == readTestCount, "count should equal with readTestCount");
+    }
+};
+
 class RttBenchmark : public simpletest::ITypenamedTest<RttBenchmark> {
 private:
     using Self = RttBenchmark;
@@ -1243,8 +1528,11 @@ int Entry() {
     runner.Register<PipelineAppendTest>();
     runner.Register<FaultPipelineAppendTest>();
     runner.Register<RecoveryPipelineAppendTest>();
+    runner.Register<PipelinedReplicationAppendTest>();
     runner.Register<BasicLeaseTest>();
     runner.Register<FaultLeaseTest>();
+    runner.Register<ReadIndexTest>();
+    runner.Register<LeaseReadTest>();
     runner.Register<RttBenchmark>();
     runner.Register<PipelineRttBenchmark>();
     runner.Register<BasicAppendBenchmark>();
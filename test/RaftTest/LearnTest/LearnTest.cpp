@@ -0,0 +1,271 @@
+#include <common/RaftTool.hpp>
+#include <sharpen/AsyncOps.hpp>
+#include <sharpen/BufferOps.hpp>
+#include <sharpen/EventEngine.hpp>
+#include <sharpen/FileOps.hpp>
+#include <sharpen/FileRaftSnapshotController.hpp>
+#include <sharpen/IConsensus.hpp>
+#include <sharpen/TcpHost.hpp>
+#include <sharpen/TimerOps.hpp>
+#include <simpletest/TestRunner.hpp>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+static const std::uint32_t magicNumber{0x2333};
+
+static const char *snapshotName{"./raftlearnsnapshot"};
+
+static const std::uint16_t beginPort{11101};
+
+static const std::uint16_t endPort{11103};
+
+// the learner is not a member of voters
+static const std::uint16_t learnerPort{11104};
+
+static constexpr std::size_t snapshotSize{1024 * 1024 + 123};
+
+static constexpr std::size_t logCount{32};
+
+static constexpr std::size_t pipelineLength{4};
+
+static constexpr std::size_t maxRounds{300};
+
+static void RemoveFiles() {
+    for (std::uint16_t i = beginPort; i != learnerPort + 1; ++i) {
+        RemoveSnapshot(snapshotName, i);
+        RemoveLogStorage(i);
+        RemoveStatusMap(i);
+    }
+}
+
+static std::shared_ptr<sharpen::IConsensus> CreateLearnRaft(
+    std::uint16_t port, std::unique_ptr<sharpen::IRaftSnapshotController> ctrl) {
+    sharpen::RaftOption raftOpt;
+    raftOpt.SetLearner(port == learnerPort);
+    raftOpt.SetPrevote(false);
+    raftOpt.SetPipelineLength(pipelineLength);
+    auto raft{CreateRaft(port, magicNumber, std::move(ctrl), nullptr, raftOpt, true)};
+    // voters and learner both use voters as peers
+    raft->ConfiguratePeers(
+        &ConfigPeers, port, beginPort, endPort, &raft->GetReceiver(), magicNumber, true);
+    return raft;
+}
+
+// advances the consensus until all voters commit the index
+static bool WaitVoters(const std::vector<std::shared_ptr<sharpen::IConsensus>> &rafts,
+                       std::uint64_t index) {
+    auto primary{rafts.front().get()};
+    for (std::size_t i = 0; i != maxRounds; ++i) {
+        primary->Advance();
+        sharpen::Delay(std::chrono::milliseconds{10});
+        bool committed{true};
+        for (auto begin = rafts.begin(), end = rafts.end() - 1; begin != end; ++begin) {
+            if ((*begin)->GetCommitIndex() < index) {
+                committed = false;
+            }
+        }
+        if (committed) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// advances the learner until it commits the index
+static bool WaitLearner(sharpen::IConsensus &learner, std::uint64_t index) {
+    for (std::size_t i = 0; i != maxRounds; ++i) {
+        learner.Advance();
+        sharpen::Delay(std::chrono::milliseconds{10});
+        if (learner.GetCommitIndex() >= index) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void CloseAll(std::vector<std::shared_ptr<sharpen::IConsensus>> &rafts,
+                     std::vector<std::unique_ptr<sharpen::IHost>> &hosts,
+                     std::vector<sharpen::AwaitableFuturePtr<void>> &process) {
+    for (auto begin = rafts.begin(), end = rafts.end(); begin != end; ++begin) {
+        auto raft{begin->get()};
+        raft->ReleasePeers();
+    }
+    for (auto begin = hosts.begin(), end = hosts.end(); begin != end; ++begin) {
+        auto host{begin->get()};
+        host->Stop();
+    }
+    for (auto begin = process.begin(), end = process.end(); begin != end; ++begin) {
+        auto future{begin->get()};
+        future->WaitAsync();
+    }
+    hosts.clear();
+}
+
+class LearnLogsTest : public simpletest::ITypenamedTest<LearnLogsTest> {
+private:
+    using Self = LearnLogsTest;
+
+public:
+    LearnLogsTest() noexcept = default;
+
+    ~LearnLogsTest() noexcept = default;
+
+    inline const Self &Const() const noexcept {
+        return *this;
+    }
+
+    inline virtual simpletest::TestResult Run() noexcept {
+        for (std::uint16_t i = beginPort; i != learnerPort + 1; ++i) {
+            RemoveSnapshot(snapshotName, i);
+        }
+        std::vector<std::shared_ptr<sharpen::IConsensus>> rafts;
+        rafts.reserve(4);
+        std::vector<std::unique_ptr<sharpen::IHost>> hosts;
+        hosts.reserve(4);
+        std::vector<sharpen::AwaitableFuturePtr<void>> process;
+        process.reserve(4);
+        for (std::uint16_t i = beginPort; i != learnerPort + 1; ++i) {
+            auto raft{CreateLearnRaft(i, nullptr)};
+            rafts.emplace_back(raft);
+            hosts.emplace_back(CreateRaftHost(i, raft, magicNumber));
+        }
+        for (auto begin = hosts.begin(), end = hosts.end(); begin != end; ++begin) {
+            sharpen::IHost *host{begin->get()};
+            auto future{sharpen::Async([host]() { host->Run(); })};
+            process.emplace_back(std::move(future));
+        }
+        auto primary{rafts.front().get()};
+        auto learner{rafts.back().get()};
+        primary->Advance();
+        primary->WaitNextConsensus();
+        bool writable{primary->Writable()};
+        bool committed{false};
+        if (writable) {
+            sharpen::LogBatch batch;
+            for (std::size_t i = 0; i != logCount; ++i) {
+                sharpen::ByteBuffer log;
+                log.Printf("Index:%zu", i + 1);
+                batch.Append(std::move(log));
+            }
+            primary->Write(batch);
+            committed = WaitVoters(rafts, logCount);
+        }
+        // the learner pulls logs from followers
+        bool learned{committed && WaitLearner(*learner, logCount)};
+        CloseAll(rafts, hosts, process);
+        bool matched{learned};
+        for (std::uint64_t i = 1; matched && i != logCount + 1; ++i) {
+            sharpen::Optional<sharpen::ByteBuffer> expected{primary->ImmutableLogs().Lookup(i)};
+            sharpen::Optional<sharpen::ByteBuffer> log{learner->ImmutableLogs().Lookup(i)};
+            matched = expected.Exist() && log.Exist() && expected.Get() == log.Get();
+        }
+        rafts.clear();
+        RemoveFiles();
+        if (!writable) {
+            return this->Fail("primary should be leader");
+        }
+        if (!committed) {
+            return this->Fail("voters should commit logs");
+        }
+        if (!learned) {
+            return this->Fail("learner should commit logs");
+        }
+        return this->Assert(matched, "logs of learner should equal with leader");
+    }
+};
+
+class LearnSnapshotTest : public simpletest::ITypenamedTest<LearnSnapshotTest> {
+private:
+    using Self = LearnSnapshotTest;
+
+public:
+    LearnSnapshotTest() noexcept = default;
+
+    ~LearnSnapshotTest() noexcept = default;
+
+    inline const Self &Const() const noexcept {
+        return *this;
+    }
+
+    inline virtual simpletest::TestResult Run() noexcept {
+        for (std::uint16_t i = beginPort; i != learnerPort + 1; ++i) {
+            RemoveSnapshot(snapshotName, i);
+        }
+        sharpen::ByteBuffer data{GenerateData(snapshotSize)};
+        std::vector<std::shared_ptr<sharpen::IConsensus>> rafts;
+        rafts.reserve(4);
+        std::vector<std::unique_ptr<sharpen::IHost>> hosts;
+        hosts.reserve(4);
+        std::vector<sharpen::AwaitableFuturePtr<void>> process;
+        process.reserve(4);
+        for (std::uint16_t i = beginPort; i != learnerPort + 1; ++i) {
+            auto ctrl{CreateSnapshotController(snapshotName, i)};
+            // the leader has compacted its logs into snapshot
+            if (i == beginPort) {
+                CommitSnapshot(*ctrl, data);
+            }
+            auto raft{CreateLearnRaft(i, std::move(ctrl))};
+            rafts.emplace_back(raft);
+            hosts.emplace_back(CreateRaftHost(i, raft, magicNumber));
+        }
+        for (auto begin = hosts.begin(), end = hosts.end(); begin != end; ++begin) {
+            sharpen::IHost *host{begin->get()};
+            auto future{sharpen::Async([host]() { host->Run(); })};
+            process.emplace_back(std::move(future));
+        }
+        auto primary{rafts.front().get()};
+        auto learner{rafts.back().get()};
+        primary->Advance();
+        primary->WaitNextConsensus();
+        bool writable{primary->Writable()};
+        // followers install the snapshot of leader
+        bool committed{writable && WaitVoters(rafts, snapshotIndex)};
+        if (committed) {
+            sharpen::LogBatch batch;
+            sharpen::ByteBuffer log;
+            log.Printf("Index:%zu", static_cast<std::size_t>(snapshotIndex + 1));
+            batch.Append(std::move(log));
+            primary->Write(batch);
+            committed = WaitVoters(rafts, snapshotIndex + 1);
+        }
+        // the learner pulls snapshot and logs after it from followers
+        bool learned{committed && WaitLearner(*learner, snapshotIndex + 1)};
+        CloseAll(rafts, hosts, process);
+        rafts.clear();
+        bool matched{false};
+        {
+            auto ctrl{CreateSnapshotController(snapshotName, learnerPort)};
+            sharpen::Optional<sharpen::RaftSnapshotMetadata> metadata{ctrl->GetLastMetadata()};
+            matched = metadata.Exist() && metadata.Get().GetLastIndex() == snapshotIndex &&
+                      metadata.Get().GetChecksum() == sharpen::Crc32c(data.Data(), data.GetSize());
+        }
+        RemoveFiles();
+        if (!writable) {
+            return this->Fail("primary should be leader");
+        }
+        if (!committed) {
+            return this->Fail("voters should commit logs after snapshot");
+        }
+        if (!learned) {
+            return this->Fail("learner should commit logs after snapshot");
+        }
+        return this->Assert(matched, "snapshot of learner should equal with leader");
+    }
+};
+
+int Entry() {
+    sharpen::StartupNetSupport();
+    simpletest::TestRunner runner{simpletest::DisplayMode::Blocked};
+    runner.Register<LearnLogsTest>();
+    runner.Register<LearnSnapshotTest>();
+    int code{runner.Run()};
+    sharpen::CleanupNetSupport();
+    return code;
+}
+
+int main() {
+    sharpen::EventEngine &engine{sharpen::EventEngine::SetupEngine()};
+    return engine.StartupWithCode(&Entry);
+}
\ No newline at end of file
@@ -1,14 +1,21 @@
+#include <sharpen/AsyncOps.hpp>
 #include <sharpen/CowStatusMap.hpp>
 #include <sharpen/DebugTools.hpp>
+#include <sharpen/Directory.hpp>
 #include <sharpen/EventEngine.hpp>
 #include <sharpen/FileOps.hpp>
 #include <sharpen/IStatusMap.hpp>
+#include <sharpen/SegmentLogStorage.hpp>
+#include <sharpen/TimerOps.hpp>
 #include <sharpen/WalLogStorage.hpp>
 #include <simpletest/TestRunner.hpp>
 #include <cinttypes>
+#include <vector>
 
 static const char *walName = "./walLog";
 
+static const char *segmentDirName = "./segmentLog";
+
 class LogStorageTest : public simpletest::ITypenamedTest<LogStorageTest> {
 private:
     using Self = LogStorageTest;
@@ -256,9 +263,342 @@ public:
     }
 };
 
+class WalGroupCommitTest : public simpletest::ITypenamedTest<WalGroupCommitTest> {
+private:
+    using Self = WalGroupCommitTest;
+
+    static constexpr std::size_t count_{64};
+
+public:
+    WalGroupCommitTest() noexcept = default;
+
+    ~WalGroupCommitTest() noexcept = default;
+
+    inline const Self &Const() const noexcept {
+        return *this;
+    }
+
+    inline virtual simpletest::TestResult Run() noexcept {
+        std::unique_ptr<sharpen::WalLogStorage> log{new (std::nothrow)
+                                                        sharpen::WalLogStorage{walName}};
+        if (!log) {
+            return this->Fail("failed to alloc memory");
+        }
+        // let the leader wait for other writers
+        log->SetGroupCommit(1024 * 1024, std::chrono::milliseconds{1});
+        std::vector<sharpen::AwaitableFuture<void>> futures{count_};
+        for (std::size_t i = 0; i != count_; ++i) {
+            sharpen::WalLogStorage *storage{log.get()};
+            sharpen::AwaitableFuture<void> *future{&futures[i]};
+            sharpen::Launch([storage, future, i]() {
+                sharpen::ByteBuffer entry{"entry", 5};
+                storage->Write(i + 1, entry);
+                future->Complete();
+            });
+        }
+        for (std::size_t i = 0; i != count_; ++i) {
+            futures[i].Await();
+        }
+        simpletest::TestResult result{this->Success()};
+        if (log->GetSyncCount() >= count_) {
+            result = this->Fail("writes should share fdatasync()");
+        }
+        if (!result.Fail()) {
+            log.reset(new (std::nothrow) sharpen::WalLogStorage{walName});
+            for (std::size_t i = 0; i != count_; ++i) {
+                if (!log->Lookup(i + 1).Exist()) {
+                    result = this->Fail("lost entry");
+                    break;
+                }
+            }
+        }
+        log.reset();
+        sharpen::RemoveFile(walName);
+        return result;
+    }
+};
+
+class WalStagedWriteTest : public simpletest::ITypenamedTest<WalStagedWriteTest> {
+private:
+    using Self = WalStagedWriteTest;
+
+public:
+    WalStagedWriteTest() noexcept = default;
+
+    ~WalStagedWriteTest() noexcept = default;
+
+    inline const Self &Const() const noexcept {
+        return *this;
+    }
+
+    inline virtual simpletest::TestResult Run() noexcept {
+        std::unique_ptr<sharpen::WalLogStorage> log{new (std::nothrow)
+                                                        sharpen::WalLogStorage{walName}};
+        if (!log) {
+            return this->Fail("failed to alloc memory");
+        }
+        // keep the group staged for a while
+        log->SetGroupCommit(1024 * 1024, std::chrono::milliseconds{200});
+        sharpen::WalLogStorage *storage{log.get()};
+        sharpen::AwaitableFuture<void> first;
+        sharpen::AwaitableFuture<std::uint64_t> second;
+        sharpen::Launch([storage, &first]() {
+            storage->Write(1, sharpen::ByteBuffer{"entry", 5});
+            first.Complete();
+        });
+        // the same entry is staged by the first writer
+        sharpen::Launch([storage, &second]() {
+            storage->Write(1, sharpen::ByteBuffer{"entry", 5});
+            second.Complete(storage->GetSyncCount());
+        });
+        sharpen::Delay(std::chrono::milliseconds{10});
+        bool visible{log->Lookup(1).Exist() || log->GetLastIndex() != 0};
+        first.Await();
+        std::uint64_t syncCount{second.Await()};
+        simpletest::TestResult result{this->Success()};
+        if (visible) {
+            result = this->Fail("staged entry should not be visible");
+        } else if (!syncCount) {
+            result = this->Fail("writer should wait for the group of staged entry");
+        } else if (!log->Lookup(1).Exist()) {
+            result = this->Fail("lost entry");
+        }
+        log.reset();
+        sharpen::RemoveFile(walName);
+        return result;
+    }
+};
+
+class WalCompactionTest : public simpletest::ITypenamedTest<WalCompactionTest> {
+private:
+    using Self = WalCompactionTest;
+
+    static constexpr std::size_t entryCount_{10};
+
+    static constexpr std::size_t roundCount_{500};
+
+    static sharpen::ByteBuffer MakeEntry(std::size_t round) {
+        sharpen::ByteBuffer entry{16};
+        std::snprintf(entry.Data(), entry.GetSize(), "entry %zu", round);
+        return entry;
+    }
+
+public:
+    WalCompactionTest() noexcept = default;
+
+    ~WalCompactionTest() noexcept = default;
+
+    inline const Self &Const() const noexcept {
+        return *this;
+    }
+
+    inline virtual simpletest::TestResult Run() noexcept {
+        std::unique_ptr<sharpen::ILogStorage> log{new (std::nothrow)
+                                                      sharpen::WalLogStorage{walName}};
+        if (!log) {
+            return this->Fail("failed to alloc memory");
+        }
+        // overwrite entries to trigger compaction
+        for (std::size_t i = 0; i != roundCount_; ++i) {
+            log->Write(i % entryCount_ + 1, MakeEntry(i));
+        }
+        log.reset();
+        std::uint64_t size{0};
+        {
+            sharpen::FileChannelPtr channel{sharpen::OpenFileChannel(
+                walName, sharpen::FileAccessMethod::Read, sharpen::FileOpenMethod::Open)};
+            size = channel->GetFileSize();
+        }
+        log.reset(new (std::nothrow) sharpen::WalLogStorage{walName});
+        simpletest::TestResult result{this->Success()};
+        for (std::size_t i = roundCount_ - entryCount_; i != roundCount_; ++i) {
+            sharpen::Optional<sharpen::ByteBuffer> entry{log->Lookup(i % entryCount_ + 1)};
+            if (!entry.Exist() || entry.Get() != MakeEntry(i)) {
+                result = this->Fail("lost entry");
+                break;
+            }
+        }
+        if (!result.Fail() && size >= roundCount_ * 16) {
+            result = this->Fail("file should be compacted");
+        }
+        log.reset();
+        sharpen::RemoveFile(walName);
+        return result;
+    }
+};
+
+class SegmentLogStorageTest : public simpletest::ITypenamedTest<SegmentLogStorageTest> {
+private:
+    using Self = SegmentLogStorageTest;
+
+    // force rolling segments
+    static constexpr std::size_t segmentSize_{64};
+
+public:
+    SegmentLogStorageTest() noexcept = default;
+
+    ~SegmentLogStorageTest() noexcept = default;
+
+    inline const Self &Const() const noexcept {
+        return *this;
+    }
+
+    inline virtual simpletest::TestResult Run() noexcept {
+        std::unique_ptr<sharpen::ILogStorage> log{new (std::nothrow) sharpen::SegmentLogStorage{
+            sharpen::GetLocalLoopGroup(), segmentDirName, segmentSize_}};
+        if (!log) {
+            return this->Fail("failed to alloc memory");
+        }
+        simpletest::TestResult result{this->Success()};
+        do {
+            sharpen::ByteBuffer entire{"entry", 5};
+            log->Write(1, entire);
+            if (log->GetLastIndex() != 1) {
+                result = this->Fail("last index should be 1");
+                break;
+            }
+            sharpen::LogEntries entires;
+            for (std::size_t i = 0; i != 10; ++i) {
+                entires.Push(entire);
+            }
+            log->WriteBatch(2, entires);
+            if (log->GetLastIndex() != 11) {
+                result = this->Fail("last index should be 11");
+                break;
+            }
+            log->DropUntil(5);
+            for (std::size_t i = 1; i != 5; ++i) {
+                if (log->Lookup(i).Exist()) {
+                    result = this->Fail("should not exists");
+                    break;
+                }
+            }
+            log->TruncateFrom(6);
+            for (std::size_t i = 6; i != 12; ++i) {
+                if (log->Lookup(i).Exist()) {
+                    result = this->Fail("should not exists");
+                    break;
+                }
+            }
+            if (log->GetLastIndex() != 5) {
+                result = this->Fail("last index should be 5");
+                break;
+            }
+            if (!log->Lookup(5).Exist() || log->Lookup(5).Get() != entire) {
+                result = this->Fail("entry 5 should exists");
+                break;
+            }
+        } while (0);
+        log.reset();
+        sharpen::Directory dir{segmentDirName};
+        dir.RemoveAll();
+        return result;
+    }
+};
+
+class SegmentLogStorageReopenTest
+    : public simpletest::ITypenamedTest<SegmentLogStorageReopenTest> {
+private:
+    using Self = SegmentLogStorageReopenTest;
+
+    static constexpr std::size_t segmentSize_{1024};
+    static constexpr std::size_t count_{100};
+
+    static sharpen::ByteBuffer MakeEntry(std::size_t index) {
+        sharpen::ByteBuffer entry{32};
+        std::snprintf(entry.Data(), entry.GetSize(), "entry %zu", index);
+        return entry;
+    }
+
+    static sharpen::SegmentLogStorage *OpenLog() {
+        return new (std::nothrow)
+            sharpen::SegmentLogStorage{sharpen::GetLocalLoopGroup(), segmentDirName, segmentSize_};
+    }
+
+    simpletest::TestResult Check(sharpen::SegmentLogStorage &log) {
+        if (log.GetLastIndex() != 89) {
+            return this->Fail("last index should be 89");
+        }
+        if (log.Lookup(49).Exist()) {
+            return this->Fail("entry 49 should be dropped");
+        }
+        for (std::size_t i = 50; i != 90; ++i) {
+            sharpen::Optional<sharpen::ByteBuffer> entry{log.Lookup(i)};
+            if (!entry.Exist() || entry.Get() != MakeEntry(i)) {
+                return this->Fail("lost entry");
+            }
+        }
+        return this->Success();
+    }
+
+public:
+    SegmentLogStorageReopenTest() noexcept = default;
+
+    ~SegmentLogStorageReopenTest() noexcept = default;
+
+    inline const Self &Const() const noexcept {
+        return *this;
+    }
+
+    inline virtual simpletest::TestResult Run() noexcept {
+        std::unique_ptr<sharpen::SegmentLogStorage> log{OpenLog()};
+        if (!log) {
+            return this->Fail("failed to alloc memory");
+        }
+        sharpen::LogEntries entries;
+        for (std::size_t i = 1; i != count_ + 1; ++i) {
+            entries.Push(MakeEntry(i));
+        }
+        log->WriteBatch(1, std::move(entries));
+        std::size_t segmentCount{log->GetSegmentCount()};
+        log->DropUntil(50);
+        log->TruncateFrom(90);
+        simpletest::TestResult result{this->Check(*log)};
+        if (!result.Fail() && log->GetSegmentCount() >= segmentCount) {
+            result = this->Fail("segments should be removed");
+        }
+        if (!result.Fail()) {
+            log.reset(OpenLog());
+            result = this->Check(*log);
+        }
+        if (!result.Fail()) {
+            // tear the tail of last segment
+            log.reset();
+            sharpen::Directory dir{segmentDirName};
+            sharpen::Dentry last;
+            for (sharpen::Dentry dentry{dir.GetNextEntry()}; dentry.Valid();
+                 dentry = dir.GetNextEntry()) {
+                if (dentry.GetType() == sharpen::FileEntryType::File &&
+                    (!last.Valid() || last.Name() < dentry.Name())) {
+                    last = dentry;
+                }
+            }
+            std::string name{segmentDirName};
+            name.push_back('/');
+            name.append(last.Name());
+            sharpen::FileChannelPtr channel{sharpen::OpenFileChannel(
+                name.c_str(), sharpen::FileAccessMethod::All, sharpen::FileOpenMethod::Open)};
+            channel->Register(sharpen::GetLocalLoopGroup());
+            channel->WriteAsync("garbage", 7, channel->GetFileSize());
+            channel->Close();
+            log.reset(OpenLog());
+            result = this->Check(*log);
+        }
+        log.reset();
+        sharpen::Directory dir{segmentDirName};
+        dir.RemoveAll();
+        return result;
+    }
+};
+
 static int Test() {
     simpletest::TestRunner runner{simpletest::DisplayMode::Blocked};
     runner.Register<LogStorageTest>();
+    runner.Register<WalGroupCommitTest>();
+    runner.Register<WalStagedWriteTest>();
+    runner.Register<WalCompactionTest>();
+    runner.Register<SegmentLogStorageTest>();
+    runner.Register<SegmentLogStorageReopenTest>();
     runner.Register<LogStorageBenchmark_1MB>();
     runner.Register<LogStorageBenchmark_32KB>();
     runner.Register<LogStorageBenchmark_1MB_NOTALLOC>();
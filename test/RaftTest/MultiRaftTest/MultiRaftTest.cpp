@@ -0,0 +1,437 @@
+#include <common/RaftTool.hpp>
+#include <sharpen/AsyncOps.hpp>
+#include <sharpen/DebugTools.hpp>
+#include <sharpen/EventEngine.hpp>
+#include <sharpen/GenericMail.hpp>
+#include <sharpen/IConsensus.hpp>
+#include <sharpen/IpTcpStreamFactory.hpp>
+#include <sharpen/MultiRaftDispatcher.hpp>
+#include <sharpen/MultiRaftMailBuilder.hpp>
+#include <sharpen/MultiRaftMailExtractor.hpp>
+#include <sharpen/MultiRaftStep.hpp>
+#include <sharpen/MultiplexedActor.hpp>
+#include <sharpen/SimpleHostPipeline.hpp>
+#include <sharpen/TcpHost.hpp>
+#include <simpletest/TestRunner.hpp>
+#include <memory>
+#include <vector>
+
+static const std::uint32_t magicNumber{0x2333};
+
+static const std::uint16_t beginPort{10901};
+
+static const std::uint16_t endPort{10903};
+
+static constexpr std::uint32_t groupCount{8};
+
+static constexpr std::size_t appendTestCount{30};
+
+static constexpr std::size_t batchSize{20};
+
+static constexpr std::size_t pipelineLength{2};
+
+static constexpr std::size_t shardCount{4};
+
+// all raft groups of one node
+struct MultiRaftNode {
+    std::vector<std::shared_ptr<sharpen::TcpMultiplexer>> multiplexers_;
+    std::vector<std::shared_ptr<sharpen::IConsensus>> groups_;
+    std::shared_ptr<sharpen::MultiRaftDispatcher> dispatcher_;
+    std::unique_ptr<sharpen::IHost> host_;
+};
+
+static std::unique_ptr<sharpen::IHostPipeline> ConfigPipeline(
+    std::shared_ptr<sharpen::MultiRaftDispatcher> dispatcher) {
+    std::unique_ptr<sharpen::IHostPipeline> pipe{new (std::nothrow) sharpen::SimpleHostPipeline{}};
+    pipe->Register<sharpen::MultiRaftStep>(std::move(dispatcher));
+    return pipe;
+}
+
+static std::unique_ptr<MultiRaftNode> CreateNode(std::uint16_t port, bool pipeline) {
+    std::unique_ptr<MultiRaftNode> node{new (std::nothrow) MultiRaftNode{}};
+    if (!node) {
+        throw std::bad_alloc{};
+    }
+    node->multiplexers_ = CreateMultiplexers(port, beginPort, endPort, magicNumber, pipeline);
+    // more shards than loops, so that responses are written out of order
+    node->dispatcher_ = std::make_shared<sharpen::MultiRaftDispatcher>(
+        sharpen::GetLocalScheduler(), magicNumber, shardCount);
+    sharpen::RaftOption raftOpt;
+    raftOpt.SetBatchSize(batchSize);
+    raftOpt.SetLearner(false);
+    raftOpt.SetPrevote(false);
+    if (pipeline) {
+        raftOpt.SetPipelineLength(pipelineLength);
+    }
+    for (std::uint32_t i = 0; i != groupCount; ++i) {
+        auto raft{CreateGroupRaft(port, magicNumber, i, raftOpt)};
+        raft->ConfiguratePeers(&ConfigMultiplexedPeers, &node->multiplexers_, &raft->GetReceiver());
+        node->dispatcher_->Register(i, raft);
+        node->groups_.emplace_back(std::move(raft));
+    }
+    sharpen::IpEndPoint endPoint;
+    endPoint.SetAddrByString("127.0.0.1");
+    endPoint.SetPort(port);
+    sharpen::IpTcpStreamFactory streamFactory{endPoint};
+    std::unique_ptr<sharpen::TcpHost> host{new (std::nothrow) sharpen::TcpHost{streamFactory}};
+    if (!host) {
+        throw std::bad_alloc{};
+    }
+    host->ConfiguratePipeline(&ConfigPipeline, node->dispatcher_);
+    node->host_ = std::move(host);
+    return node;
+}
+
+// drops every response
+class DropReceiver : public sharpen::IMailReceiver {
+private:
+    using Self = DropReceiver;
+
+    virtual void NviReceive(sharpen::Mail mail, const sharpen::ActorId &actorId) override {
+        (void)mail;
+        (void)actorId;
+    }
+
+public:
+    DropReceiver() noexcept = default;
+
+    virtual ~DropReceiver() noexcept = default;
+};
+
+// posts the mails of an unknown group through a shared connection
+// then cancels and destroys the actor while the mails are in flight
+static void CancelInFlight(std::shared_ptr<sharpen::TcpMultiplexer> multiplexer) {
+    DropReceiver receiver;
+    sharpen::MultiRaftMailBuilder builder{magicNumber, groupCount};
+    sharpen::RaftVoteForRequest request;
+    request.SetTerm(1);
+    std::unique_ptr<sharpen::Mail> mail{new (std::nothrow)
+                                            sharpen::Mail{builder.BuildVoteRequest(request)}};
+    if (!mail) {
+        throw std::bad_alloc{};
+    }
+    sharpen::MultiplexedActor actor{receiver, std::move(multiplexer)};
+    actor.PostShared(*mail);
+    actor.Cancel();
+    // the owner reuses the shared mail once the pipeline is drained
+    if (!actor.GetPipelineCount()) {
+        mail.reset();
+    }
+    actor.Post(builder.BuildVoteRequest(request));
+}
+
+static std::size_t RunAppend(bool pipeline, bool cancel, std::size_t &batchCount) {
+    std::vector<std::unique_ptr<MultiRaftNode>> nodes;
+    nodes.reserve(3);
+    std::vector<sharpen::AwaitableFuturePtr<void>> process;
+    process.reserve(3);
+    for (std::uint16_t i = beginPort; i != endPort + 1; ++i) {
+        nodes.emplace_back(CreateNode(i, pipeline));
+    }
+    for (auto begin = nodes.begin(), end = nodes.end(); begin != end; ++begin) {
+        sharpen::IHost *host{(*begin)->host_.get()};
+        auto future{sharpen::Async([host]() { host->Run(); })};
+        process.emplace_back(std::move(future));
+    }
+    // node 0 leads every group
+    std::vector<std::shared_ptr<sharpen::IConsensus>> &primaries{nodes[0]->groups_};
+    for (auto begin = primaries.begin(), end = primaries.end(); begin != end; ++begin) {
+        (*begin)->Advance();
+    }
+    bool writable{true};
+    for (auto begin = primaries.begin(), end = primaries.end(); begin != end; ++begin) {
+        (*begin)->WaitNextConsensus();
+        writable = writable && (*begin)->Writable();
+    }
+    std::size_t count{0};
+    for (std::size_t i = 0; i != appendTestCount && writable; ++i) {
+        sharpen::SyncPrintf("AppendEntires %zu\n", i);
+        // advance all groups together, so that their mails share batches
+        std::vector<sharpen::AwaitableFuturePtr<void>> advances;
+        advances.reserve(primaries.size());
+        for (auto begin = primaries.begin(), end = primaries.end(); begin != end; ++begin) {
+            sharpen::IConsensus *primary{begin->get()};
+            advances.emplace_back(sharpen::Async([primary, i]() {
+                sharpen::LogBatch batch;
+                sharpen::ByteBuffer log;
+                log.Printf("Index:%zu", i);
+                batch.Append(std::move(log));
+                primary->Write(batch);
+                primary->Advance();
+            }));
+        }
+        if (cancel) {
+            std::shared_ptr<sharpen::TcpMultiplexer> multiplexer{
+                nodes[0]->multiplexers_.front()};
+            advances.emplace_back(sharpen::Async(&CancelInFlight, std::move(multiplexer)));
+        }
+        for (auto begin = advances.begin(), end = advances.end(); begin != end; ++begin) {
+            (*begin)->Await();
+        }
+        for (auto begin = nodes.begin() + 1, end = nodes.end(); begin != end; ++begin) {
+            std::vector<std::shared_ptr<sharpen::IConsensus>> &backups{(*begin)->groups_};
+            for (auto ite = backups.begin(), last = backups.end(); ite != last; ++ite) {
+                (*ite)->WaitNextConsensus();
+            }
+        }
+        count += 1;
+        for (auto begin = primaries.begin(), end = primaries.end(); begin != end; ++begin) {
+            writable = writable && (*begin)->Writable();
+        }
+    }
+    batchCount = 0;
+    for (auto begin = nodes[0]->multiplexers_.begin(), end = nodes[0]->multiplexers_.end();
+         begin != end;
+         ++begin) {
+        batchCount += (*begin)->GetBatchCount();
+    }
+    sharpen::SyncPrintf("Batch mails %zu\n", batchCount);
+    // close all hosts
+    for (auto begin = nodes.begin(), end = nodes.end(); begin != end; ++begin) {
+        std::vector<std::shared_ptr<sharpen::IConsensus>> &groups{(*begin)->groups_};
+        for (auto ite = groups.begin(), last = groups.end(); ite != last; ++ite) {
+            (*ite)->ReleasePeers();
+        }
+        // groups leave the shared connections open
+        std::vector<std::shared_ptr<sharpen::TcpMultiplexer>> &multiplexers{
+            (*begin)->multiplexers_};
+        for (auto ite = multiplexers.begin(), last = multiplexers.end(); ite != last; ++ite) {
+            (*ite)->Close();
+        }
+    }
+    for (auto begin = nodes.begin(), end = nodes.end(); begin != end; ++begin) {
+        (*begin)->host_->Stop();
+    }
+    for (auto begin = process.begin(), end = process.end(); begin != end; ++begin) {
+        auto future{begin->get()};
+        future->WaitAsync();
+    }
+    nodes.clear();
+    // remove files
+    for (std::uint16_t i = beginPort; i != endPort + 1; ++i) {
+        for (std::uint32_t j = 0; j != groupCount; ++j) {
+            RemoveGroupStorage(i, j);
+        }
+    }
+    return count;
+}
+
+class BatchMailTest : public simpletest::ITypenamedTest<BatchMailTest> {
+private:
+    using Self = BatchMailTest;
+
+public:
+    BatchMailTest() noexcept = default;
+
+    ~BatchMailTest() noexcept = default;
+
+    inline const Self &Const() const noexcept {
+        return *this;
+    }
+
+    inline virtual simpletest::TestResult Run() noexcept {
+        sharpen::MultiRaftMailBuilder builder{magicNumber, 1};
+        sharpen::MultiRaftMailBuilder otherBuilder{magicNumber, 2};
+        sharpen::RaftVoteForRequest request;
+        request.SetTerm(3);
+        std::vector<sharpen::Mail> mails;
+        mails.emplace_back(builder.BuildVoteRequest(request));
+        mails.emplace_back();
+        mails.emplace_back(otherBuilder.BuildVoteRequest(request));
+        std::vector<const sharpen::Mail *> pointers;
+        for (auto begin = mails.begin(), end = mails.end(); begin != end; ++begin) {
+            pointers.emplace_back(&*begin);
+        }
+        sharpen::Mail batch{sharpen::MultiRaftMailBuilder::BuildBatch(
+            magicNumber, sharpen::RaftMailType::BatchRequest, 7, pointers.data(), pointers.size())};
+        if (sharpen::MultiRaftMailExtractor::LookupRaftNumber(magicNumber, batch).Exist()) {
+            return this->Fail("batch mail should not be routed to a group");
+        }
+        auto sequence{sharpen::MultiRaftMailExtractor::LookupBatchSequence(
+            magicNumber, sharpen::RaftMailType::BatchRequest, batch)};
+        if (!sequence.Exist() || sequence.Get() != 7) {
+            return this->Fail("batch mail should keep its sequence");
+        }
+        if (sharpen::MultiRaftMailExtractor::ExtractBatch(
+                magicNumber, sharpen::RaftMailType::BatchResponse, batch)
+                .Exist()) {
+            return this->Fail("batch request should not be extracted as response");
+        }
+        auto result{sharpen::MultiRaftMailExtractor::ExtractBatch(
+            magicNumber, sharpen::RaftMailType::BatchRequest, batch)};
+        if (!result.Exist() || result.Get().size() != mails.size()) {
+            return this->Fail("fail to extract batch mail");
+        }
+        std::vector<sharpen::Mail> &extracted{result.Get()};
+        if (!extracted[1].Empty()) {
+            return this->Fail("empty mail should be kept");
+        }
+        sharpen::MultiRaftMailExtractor extractor{magicNumber, 2};
+        if (extractor.IsRaftMail(extracted[0]) || !extractor.IsRaftMail(extracted[2])) {
+            return this->Fail("mails should keep their raft numbers");
+        }
+        auto vote{extractor.ExtractVoteRequest(extracted[2])};
+        if (!vote.Exist() || vote.Get().GetTerm() != 3) {
+            return this->Fail("fail to extract mail from batch");
+        }
+        // corrupt the content
+        sharpen::ByteBuffer content{batch.Content()};
+        content[content.GetSize() - 1] ^= 1;
+        batch.Content() = std::move(content);
+        return this->Assert(!sharpen::MultiRaftMailExtractor::ExtractBatch(
+                                 magicNumber, sharpen::RaftMailType::BatchRequest, batch)
+                                 .Exist(),
+                            "corrupted batch should not be extracted");
+    }
+};
+
+class DispatcherTest : public simpletest::ITypenamedTest<DispatcherTest> {
+private:
+    using Self = DispatcherTest;
+
+    static sharpen::Mail GenerateResponse(sharpen::MultiRaftDispatcher &dispatcher,
+                                          sharpen::Mail request) {
+        sharpen::AwaitableFuture<sharpen::Mail> future;
+        bool dispatched{dispatcher.GenerateResponseAsync(
+            std::move(request), [&future](sharpen::Mail response) {
+                future.Complete(std::move(response));
+            })};
+        if (!dispatched) {
+            return sharpen::Mail{};
+        }
+        return future.Await();
+    }
+
+public:
+    DispatcherTest() noexcept = default;
+
+    ~DispatcherTest() noexcept = default;
+
+    inline const Self &Const() const noexcept {
+        return *this;
+    }
+
+    inline virtual simpletest::TestResult Run() noexcept {
+        // no group is registered
+        sharpen::MultiRaftDispatcher dispatcher{magicNumber};
+        if (!dispatcher.GetShardCount()) {
+            return this->Fail("dispatcher should have shards");
+        }
+        sharpen::MultiRaftMailBuilder builder{magicNumber, 5};
+        sharpen::RaftVoteForRequest request;
+        request.SetTerm(1);
+        sharpen::Mail response{GenerateResponse(dispatcher, builder.BuildVoteRequest(request))};
+        auto raftNumber{sharpen::MultiRaftMailExtractor::LookupPlaceholder(magicNumber, response)};
+        if (!raftNumber.Exist() || raftNumber.Get() != 5) {
+            return this->Fail("unknown group should be answered by a placeholder");
+        }
+        std::vector<sharpen::Mail> mails;
+        mails.emplace_back(builder.BuildVoteRequest(request));
+        mails.emplace_back(builder.BuildVoteRequest(request));
+        std::vector<const sharpen::Mail *> pointers;
+        for (auto begin = mails.begin(), end = mails.end(); begin != end; ++begin) {
+            pointers.emplace_back(&*begin);
+        }
+        sharpen::Mail batch{sharpen::MultiRaftMailBuilder::BuildBatch(
+            magicNumber, sharpen::RaftMailType::BatchRequest, 9, pointers.data(), pointers.size())};
+        response = GenerateResponse(dispatcher, std::move(batch));
+        auto sequence{sharpen::MultiRaftMailExtractor::LookupBatchSequence(
+            magicNumber, sharpen::RaftMailType::BatchResponse, response)};
+        if (!sequence.Exist() || sequence.Get() != 9) {
+            return this->Fail("batch response should carry the sequence of its request");
+        }
+        auto responses{sharpen::MultiRaftMailExtractor::ExtractBatch(
+            magicNumber, sharpen::RaftMailType::BatchResponse, response)};
+        if (!responses.Exist() || responses.Get().size() != mails.size()) {
+            return this->Fail("fail to extract batch response");
+        }
+        return this->Assert(GenerateResponse(dispatcher, sharpen::Mail{}).Empty(),
+                            "empty mail should not be dispatched");
+    }
+};
+
+class MultiplexedAppendTest : public simpletest::ITypenamedTest<MultiplexedAppendTest> {
+private:
+    using Self = MultiplexedAppendTest;
+
+public:
+    MultiplexedAppendTest() noexcept = default;
+
+    ~MultiplexedAppendTest() noexcept = default;
+
+    inline const Self &Const() const noexcept {
+        return *this;
+    }
+
+    inline virtual simpletest::TestResult Run() noexcept {
+        std::size_t batchCount{0};
+        std::size_t count{RunAppend(false, false, batchCount)};
+        if (count != appendTestCount) {
+            return this->Fail("count should equal with appendTestCount");
+        }
+        return this->Assert(batchCount > 0, "mails of groups should share batches");
+    }
+};
+
+class MultiplexedPipelineAppendTest
+    : public simpletest::ITypenamedTest<MultiplexedPipelineAppendTest> {
+private:
+    using Self = MultiplexedPipelineAppendTest;
+
+public:
+    MultiplexedPipelineAppendTest() noexcept = default;
+
+    ~MultiplexedPipelineAppendTest() noexcept = default;
+
+    inline const Self &Const() const noexcept {
+        return *this;
+    }
+
+    inline virtual simpletest::TestResult Run() noexcept {
+        std::size_t batchCount{0};
+        std::size_t count{RunAppend(true, false, batchCount)};
+        if (count != appendTestCount) {
+            return this->Fail("count should equal with appendTestCount");
+        }
+        return this->Assert(batchCount > 0, "mails of groups should share batches");
+    }
+};
+
+class MultiplexedCancelTest : public simpletest::ITypenamedTest<MultiplexedCancelTest> {
+private:
+    using Self = MultiplexedCancelTest;
+
+public:
+    MultiplexedCancelTest() noexcept = default;
+
+    ~MultiplexedCancelTest() noexcept = default;
+
+    inline const Self &Const() const noexcept {
+        return *this;
+    }
+
+    inline virtual simpletest::TestResult Run() noexcept {
+        // other groups should not be affected by the canceled actors
+        std::size_t batchCount{0};
+        std::size_t count{RunAppend(true, true, batchCount)};
+        return this->Assert(count == appendTestCount, "count should equal with appendTestCount");
+    }
+};
+
+int Entry() {
+    sharpen::StartupNetSupport();
+    simpletest::TestRunner runner{simpletest::DisplayMode::Blocked};
+    runner.Register<BatchMailTest>();
+    runner.Register<DispatcherTest>();
+    runner.Register<MultiplexedAppendTest>();
+    runner.Register<MultiplexedPipelineAppendTest>();
+    runner.Register<MultiplexedCancelTest>();
+    int code{runner.Run()};
+    sharpen::CleanupNetSupport();
+    return code;
+}
+
+int main() {
+    sharpen::EventEngine &engine{sharpen::EventEngine::SetupEngine()};
+    return engine.StartupWithCode(&Entry);
+}
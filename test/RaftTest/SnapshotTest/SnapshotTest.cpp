@@ -0,0 +1,321 @@
+#include <common/RaftTool.hpp>
+#include <sharpen/AsyncOps.hpp>
+#include <sharpen/BufferOps.hpp>
+#include <sharpen/CorruptedDataError.hpp>
+#include <sharpen/EventEngine.hpp>
+#include <sharpen/FileOps.hpp>
+#include <sharpen/FileRaftSnapshotController.hpp>
+#include <sharpen/IConsensus.hpp>
+#include <sharpen/TcpHost.hpp>
+#include <sharpen/TimerOps.hpp>
+#include <simpletest/TestRunner.hpp>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+static const std::uint32_t magicNumber{0x2333};
+
+static const char *snapshotName{"./raftsnapshot"};
+
+static const std::uint16_t beginPort{11001};
+
+static const std::uint16_t endPort{11003};
+
+static constexpr std::size_t snapshotSize{4 * 1024 * 1024 + 123};
+
+static constexpr std::size_t pipelineLength{4};
+
+static constexpr std::size_t maxRounds{300};
+
+static std::shared_ptr<sharpen::IConsensus> CreateSnapshotRaft(
+    std::uint16_t port, std::unique_ptr<sharpen::IRaftSnapshotController> ctrl) {
+    sharpen::RaftOption raftOpt;
+    raftOpt.SetLearner(false);
+    raftOpt.SetPrevote(false);
+    raftOpt.SetPipelineLength(pipelineLength);
+    auto raft{CreateRaft(port, magicNumber, std::move(ctrl), nullptr, raftOpt, true)};
+    raft->ConfiguratePeers(
+        &ConfigPeers, port, beginPort, endPort, &raft->GetReceiver(), magicNumber, true);
+    return raft;
+}
+
+static void WriteFile(const std::string &name, const sharpen::ByteBuffer &data) {
+    sharpen::FileChannelPtr channel{sharpen::OpenFileChannel(
+        name.c_str(), sharpen::FileAccessMethod::Write, sharpen::FileOpenMethod::CreateOrOpen)};
+    channel->Register(sharpen::GetLocalLoopGroup());
+    channel->Truncate();
+    channel->WriteFixedAsync(data.Data(), data.GetSize(), 0);
+    channel->FlushAsync();
+    channel->Close();
+}
+
+class FileSnapshotTest : public simpletest::ITypenamedTest<FileSnapshotTest> {
+private:
+    using Self = FileSnapshotTest;
+
+public:
+    FileSnapshotTest() noexcept = default;
+
+    ~FileSnapshotTest() noexcept = default;
+
+    inline const Self &Const() const noexcept {
+        return *this;
+    }
+
+    inline virtual simpletest::TestResult Run() noexcept {
+        RemoveSnapshot(snapshotName, beginPort);
+        RemoveSnapshot(snapshotName, endPort);
+        sharpen::ByteBuffer data{GenerateData(snapshotSize)};
+        auto provider{CreateSnapshotController(snapshotName, beginPort)};
+        CommitSnapshot(*provider, data);
+        auto installer{CreateSnapshotController(snapshotName, endPort)};
+        // copy the snapshot chunk by chunk
+        sharpen::RaftSnapshot snapshot{provider->GetSnapshot()};
+        sharpen::RaftSnapshotMetadata metadata{snapshot.Metadata()};
+        std::unique_ptr<sharpen::IRaftSnapshotChunk> chunk{snapshot.ReleaseChainedChunks()};
+        std::size_t count{0};
+        while (true) {
+            sharpen::ByteBuffer chunkData{chunk->GenerateChunkData()};
+            installer->Write(chunk->GetOffset(), chunkData);
+            count += 1;
+            if (!chunk->Forwardable()) {
+                break;
+            }
+            chunk->Forward();
+        }
+        std::size_t expectedCount{(snapshotSize + snapshotChunkSize - 1) / snapshotChunkSize};
+        bool countMatched{count == expectedCount};
+        bool offsetMatched{installer->GetExpectedOffset() == snapshotSize};
+        // a corrupted snapshot is rejected
+        sharpen::RaftSnapshotMetadata corrupted{metadata};
+        corrupted.SetChecksum(metadata.GetChecksum() + 1);
+        bool rejected{false};
+        try {
+            installer->Install(corrupted);
+        } catch (const sharpen::CorruptedDataError &error) {
+            (void)error;
+            rejected = true;
+        }
+        bool reset{installer->GetExpectedOffset() == 0 && !installer->GetLastMetadata().Exist()};
+        // install again
+        chunk = provider->GetSnapshot().ReleaseChainedChunks();
+        while (true) {
+            installer->Write(chunk->GetOffset(), chunk->GenerateChunkData());
+            if (!chunk->Forwardable()) {
+                break;
+            }
+            chunk->Forward();
+        }
+        installer->Install(metadata);
+        installer.reset();
+        // reload metadata
+        installer = CreateSnapshotController(snapshotName, endPort);
+        sharpen::Optional<sharpen::RaftSnapshotMetadata> installed{installer->GetLastMetadata()};
+        bool installedMatched{installed.Exist() &&
+                              installed.Get().GetLastIndex() == snapshotIndex &&
+                              installed.Get().GetLastTerm() == snapshotTerm &&
+                              installed.Get().GetChecksum() == sharpen::Crc32c(data.Data(),
+                                                                                data.GetSize())};
+        installer.reset();
+        provider.reset();
+        RemoveSnapshot(snapshotName, beginPort);
+        RemoveSnapshot(snapshotName, endPort);
+        if (!countMatched) {
+            return this->Fail("chunk count should equal with expected count");
+        }
+        if (!offsetMatched) {
+            return this->Fail("expected offset should equal with snapshot size");
+        }
+        if (!rejected || !reset) {
+            return this->Fail("corrupted snapshot should be rejected");
+        }
+        return this->Assert(installedMatched, "installed metadata should equal with snapshot");
+    }
+};
+
+class SnapshotRecoveryTest : public simpletest::ITypenamedTest<SnapshotRecoveryTest> {
+private:
+    using Self = SnapshotRecoveryTest;
+
+public:
+    SnapshotRecoveryTest() noexcept = default;
+
+    ~SnapshotRecoveryTest() noexcept = default;
+
+    inline const Self &Const() const noexcept {
+        return *this;
+    }
+
+    inline virtual simpletest::TestResult Run() noexcept {
+        RemoveSnapshot(snapshotName, beginPort);
+        std::string name{GetSnapshotName(snapshotName, beginPort)};
+        sharpen::ByteBuffer data{GenerateData(snapshotSize)};
+        sharpen::ByteBuffer newData{GenerateData(snapshotChunkSize)};
+        CommitSnapshot(*CreateSnapshotController(snapshotName, beginPort), data);
+        // crash after the snapshot is replaced
+        // but before its metadata is written
+        WriteFile(name, newData);
+        bool discarded{
+            !CreateSnapshotController(snapshotName, beginPort)->GetLastMetadata().Exist() &&
+            !sharpen::ExistFile(name.c_str())};
+        // crash after the snapshot is replaced
+        // but before its metadata is replaced
+        CommitSnapshot(*CreateSnapshotController(snapshotName, beginPort), data);
+        sharpen::RaftSnapshotMetadata metadata;
+        metadata.SetLastIndex(snapshotIndex + 1);
+        metadata.SetLastTerm(snapshotTerm);
+        metadata.SetChecksum(sharpen::Crc32c(newData.Data(), newData.GetSize()));
+        sharpen::ByteBuffer metadataBuf;
+        metadata.StoreTo(metadataBuf);
+        WriteFile(name, newData);
+        WriteFile(name + ".meta.tmp", metadataBuf);
+        sharpen::Optional<sharpen::RaftSnapshotMetadata> recovered{
+            CreateSnapshotController(snapshotName, beginPort)->GetLastMetadata()};
+        bool rolledForward{recovered.Exist() &&
+                           recovered.Get().GetLastIndex() == snapshotIndex + 1 &&
+                           !sharpen::ExistFile((name + ".meta.tmp").c_str())};
+        RemoveSnapshot(snapshotName, beginPort);
+        if (!discarded) {
+            return this->Fail("snapshot which does not match its metadata should be discarded");
+        }
+        return this->Assert(rolledForward, "metadata of replaced snapshot should be recovered");
+    }
+};
+
+class SnapshotTransferTest : public simpletest::ITypenamedTest<SnapshotTransferTest> {
+private:
+    using Self = SnapshotTransferTest;
+
+public:
+    SnapshotTransferTest() noexcept = default;
+
+    ~SnapshotTransferTest() noexcept = default;
+
+    inline const Self &Const() const noexcept {
+        return *this;
+    }
+
+    inline virtual simpletest::TestResult Run() noexcept {
+        for (std::uint16_t i = beginPort; i != endPort + 1; ++i) {
+            RemoveSnapshot(snapshotName, i);
+        }
+        sharpen::ByteBuffer data{GenerateData(snapshotSize)};
+        std::vector<std::shared_ptr<sharpen::IConsensus>> rafts;
+        rafts.reserve(3);
+        std::vector<std::unique_ptr<sharpen::IHost>> hosts;
+        hosts.reserve(3);
+        std::vector<sharpen::AwaitableFuturePtr<void>> process;
+        process.reserve(3);
+        for (std::uint16_t i = beginPort; i != endPort + 1; ++i) {
+            auto ctrl{CreateSnapshotController(snapshotName, i)};
+            // the leader has compacted its logs into snapshot
+            if (i == beginPort) {
+                CommitSnapshot(*ctrl, data);
+            }
+            auto raft{CreateSnapshotRaft(i, std::move(ctrl))};
+            rafts.emplace_back(raft);
+            hosts.emplace_back(CreateRaftHost(i, raft, magicNumber));
+        }
+        for (auto begin = hosts.begin(), end = hosts.end(); begin != end; ++begin) {
+            sharpen::IHost *host{begin->get()};
+            auto future{sharpen::Async([host]() { host->Run(); })};
+            process.emplace_back(std::move(future));
+        }
+        auto primary{rafts[0].get()};
+        primary->Advance();
+        primary->WaitNextConsensus();
+        bool writable{primary->Writable()};
+        // chunks are streamed between rounds
+        std::size_t rounds{0};
+        bool installed{false};
+        while (writable && !installed && rounds != maxRounds) {
+            primary->Advance();
+            sharpen::Delay(std::chrono::milliseconds{10});
+            rounds += 1;
+            installed = true;
+            for (auto begin = rafts.begin() + 1, end = rafts.end(); begin != end; ++begin) {
+                if ((*begin)->GetCommitIndex() < snapshotIndex) {
+                    installed = false;
+                }
+            }
+        }
+        // the logs after snapshot are replicated
+        bool replicated{false};
+        if (installed) {
+            sharpen::LogBatch batch;
+            sharpen::ByteBuffer log;
+            log.Printf("Index:%zu", static_cast<std::size_t>(snapshotIndex + 1));
+            batch.Append(std::move(log));
+            primary->Write(batch);
+            for (std::size_t i = 0; i != maxRounds && !replicated; ++i) {
+                primary->Advance();
+                sharpen::Delay(std::chrono::milliseconds{10});
+                replicated = true;
+                for (auto begin = rafts.begin() + 1, end = rafts.end(); begin != end; ++begin) {
+                    if ((*begin)->GetCommitIndex() < snapshotIndex + 1) {
+                        replicated = false;
+                    }
+                }
+            }
+        }
+        // close all hosts
+        for (auto begin = rafts.begin(), end = rafts.end(); begin != end; ++begin) {
+            auto raft{begin->get()};
+            raft->ReleasePeers();
+        }
+        for (auto begin = hosts.begin(), end = hosts.end(); begin != end; ++begin) {
+            auto host{begin->get()};
+            host->Stop();
+        }
+        for (auto begin = process.begin(), end = process.end(); begin != end; ++begin) {
+            auto future{begin->get()};
+            future->WaitAsync();
+        }
+        rafts.clear();
+        hosts.clear();
+        // check the snapshots of followers
+        bool matched{true};
+        std::uint32_t checksum{sharpen::Crc32c(data.Data(), data.GetSize())};
+        for (std::uint16_t i = beginPort + 1; i != endPort + 1; ++i) {
+            auto ctrl{CreateSnapshotController(snapshotName, i)};
+            sharpen::Optional<sharpen::RaftSnapshotMetadata> metadata{ctrl->GetLastMetadata()};
+            if (!metadata.Exist() || metadata.Get().GetLastIndex() != snapshotIndex ||
+                metadata.Get().GetChecksum() != checksum) {
+                matched = false;
+            }
+        }
+        // remove files
+        for (std::uint16_t i = beginPort; i != endPort + 1; ++i) {
+            RemoveSnapshot(snapshotName, i);
+            RemoveLogStorage(i);
+            RemoveStatusMap(i);
+        }
+        if (!writable) {
+            return this->Fail("primary should be leader");
+        }
+        if (!installed) {
+            return this->Fail("followers should install snapshot");
+        }
+        if (!replicated) {
+            return this->Fail("logs after snapshot should be replicated");
+        }
+        return this->Assert(matched, "snapshots of followers should equal with leader");
+    }
+};
+
+int Entry() {
+    sharpen::StartupNetSupport();
+    simpletest::TestRunner runner{simpletest::DisplayMode::Blocked};
+    runner.Register<FileSnapshotTest>();
+    runner.Register<SnapshotRecoveryTest>();
+    runner.Register<SnapshotTransferTest>();
+    int code{runner.Run()};
+    sharpen::CleanupNetSupport();
+    return code;
+}
+
+int main() {
+    sharpen::EventEngine &engine{sharpen::EventEngine::SetupEngine()};
+    return engine.StartupWithCode(&Entry);
+}
@@ -1,6 +1,7 @@
 #include <sharpen/CowStatusMap.hpp>
 #include <sharpen/EventEngine.hpp>
 #include <sharpen/FileOps.hpp>
+#include <sharpen/IFileChannel.hpp>
 #include <sharpen/IStatusMap.hpp>
 #include <sharpen/WalStatusMap.hpp>
 
@@ -154,12 +155,59 @@ public:
     }
 };
 
+class WalCompactionTest : public simpletest::ITypenamedTest<WalCompactionTest> {
+private:
+    using Self = WalCompactionTest;
+
+    static constexpr std::size_t roundCount_{1000};
+
+public:
+    WalCompactionTest() noexcept = default;
+
+    ~WalCompactionTest() noexcept = default;
+
+    inline const Self &Const() const noexcept {
+        return *this;
+    }
+
+    inline virtual simpletest::TestResult Run() noexcept {
+        std::unique_ptr<sharpen::IStatusMap> map{new (std::nothrow) sharpen::WalStatusMap{walName}};
+        sharpen::ByteBuffer key{"key", 4};
+        sharpen::ByteBuffer value{"val", 4};
+        // overwrite keys to trigger compaction
+        for (std::size_t i = 0; i != roundCount_; ++i) {
+            key[3] = static_cast<char>(i % keyCount);
+            value[3] = static_cast<char>(i);
+            map->Write(key, value);
+        }
+        map.reset(nullptr);
+        std::uint64_t size{0};
+        {
+            sharpen::FileChannelPtr channel{sharpen::OpenFileChannel(
+                walName, sharpen::FileAccessMethod::Read, sharpen::FileOpenMethod::Open)};
+            size = channel->GetFileSize();
+        }
+        map.reset(new (std::nothrow) sharpen::WalStatusMap{walName});
+        for (std::size_t i = roundCount_ - keyCount; i != roundCount_; ++i) {
+            key[3] = static_cast<char>(i % keyCount);
+            value[3] = static_cast<char>(i);
+            auto valOpt = map->Lookup(key);
+            if (!valOpt.Exist() || valOpt.Get() != value) {
+                return this->Fail("Get() return wrong answer,compaction failed");
+            }
+        }
+        // every record is 11 bytes
+        return this->Assert(size < roundCount_ * 11, "file should be compacted");
+    }
+};
+
 static int Test() {
     simpletest::TestRunner runner;
     runner.Register<CowMapTest>();
     runner.Register<CowPersistentTest>();
     runner.Register<WalMapTest>();
     runner.Register<WalPersisentTest>();
+    runner.Register<WalCompactionTest>();
     int code{runner.Run()};
     sharpen::RemoveFile(cowName);
     sharpen::RemoveFile(walName);